@@ -11,6 +11,7 @@
 #include "gfx/threed/vecmath.hpp"
 #include "ui/colorscheme.hpp"
 #include "util/math.hpp"
+#include "util/systeminformation.hpp"
 
 using game::vcr::flak::Position;
 using game::vcr::flak::VisualisationState;
@@ -341,8 +342,10 @@ client::vcr::flak::ThreeDRenderer::ThreeDRenderer(ui::Root& root,
       m_wireframePlanet(makeWireframePlanet(*m_context, COLORQUAD_FROM_RGB(192, 192, 192))),
       m_shipModels(),
       m_fighterModels(),
-      m_planetModels()
+      m_planetModels(),
+      m_frame()
 {
+    m_context->setNumThreads(util::getSystemInformation().numProcessors);
     makeTorpedo(*m_torpedoModel);
 
     static const ColorQuad_t SMOKE_COLORS[] = {
@@ -378,7 +381,19 @@ void
 client::vcr::flak::ThreeDRenderer::draw(gfx::Canvas& can, const gfx::Rectangle& area, bool grid)
 {
     // ex fvRender(fv)
-    can.drawBar(area, m_root.colorScheme().getColor(0), 0, gfx::FillPattern::SOLID, gfx::OPAQUE_ALPHA);
+    // Render into an offscreen RGBAPixmap and copy that to the screen in one go.
+    // SoftwareContext renders in parallel only into a RGBAPixmap.
+    const gfx::Point size = area.getSize();
+    if (m_frame.get() == 0 || m_frame->getSize() != size) {
+        m_frame = gfx::RGBAPixmap::create(size.getX(), size.getY()).asPtr();
+    }
+    afl::base::Ref<gfx::Canvas> frame = m_frame->makeCanvas();
+
+    gfx::Color_t bg[1] = { m_root.colorScheme().getColor(0) };
+    gfx::ColorQuad_t bgQuad[1];
+    can.decodeColors(bg, bgQuad);
+    frame->encodeColors(bgQuad, bg);
+    frame->drawBar(gfx::Rectangle(gfx::Point(), size), bg[0], 0, gfx::FillPattern::SOLID, gfx::OPAQUE_ALPHA);
 
     // Render current state
     const double azimut = m_settings.getCameraAzimuth(), height = m_settings.getCameraHeight() + util::PI/2;
@@ -399,7 +414,7 @@ client::vcr::flak::ThreeDRenderer::draw(gfx::Canvas& can, const gfx::Rectangle&
     mvm.scale(scale);
 
     // Start drawing
-    m_context->start(area, can);
+    m_context->start(gfx::Rectangle(gfx::Point(), size), *frame);
 
     // FIXME: Skybox
     // if (fv._sky) {
@@ -462,4 +477,6 @@ client::vcr::flak::ThreeDRenderer::draw(gfx::Canvas& can, const gfx::Rectangle&
 
     // Draw
     m_context->finish();
+    m_frame->setAlpha(gfx::OPAQUE_ALPHA);
+    can.blit(area.getTopLeft(), *frame, gfx::Rectangle(gfx::Point(), size));
 }
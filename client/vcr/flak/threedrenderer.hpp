@@ -5,12 +5,14 @@
 #ifndef C2NG_CLIENT_VCR_FLAK_THREEDRENDERER_HPP
 #define C2NG_CLIENT_VCR_FLAK_THREEDRENDERER_HPP
 
+#include "afl/base/ptr.hpp"
 #include "afl/base/ref.hpp"
 #include "client/vcr/flak/renderer.hpp"
 #include "game/playerarray.hpp"
 #include "game/vcr/flak/visualisationsettings.hpp"
 #include "game/vcr/flak/visualisationstate.hpp"
-#include "gfx/threed/context.hpp"
+#include "gfx/rgbapixmap.hpp"
+#include "gfx/threed/softwarecontext.hpp"
 #include "ui/root.hpp"
 
 namespace client { namespace vcr { namespace flak {
@@ -32,7 +34,7 @@ namespace client { namespace vcr { namespace flak {
         game::vcr::flak::VisualisationSettings& m_settings;
 
         // 3D Models
-        afl::base::Ref<gfx::threed::Context> m_context;
+        afl::base::Ref<gfx::threed::SoftwareContext> m_context;
         afl::base::Ref<gfx::threed::ParticleRenderer> m_smokeRenderer;
         afl::base::Ref<gfx::threed::TriangleRenderer> m_torpedoModel;
         afl::base::Ref<gfx::threed::LineRenderer> m_gridRenderer;
@@ -43,6 +45,9 @@ namespace client { namespace vcr { namespace flak {
         game::PlayerArray<afl::base::Ptr<gfx::threed::TriangleRenderer> > m_shipModels;
         game::PlayerArray<afl::base::Ptr<gfx::threed::TriangleRenderer> > m_fighterModels;
         game::PlayerArray<afl::base::Ptr<gfx::threed::TriangleRenderer> > m_planetModels;
+
+        // Offscreen frame, allows SoftwareContext to render in parallel
+        afl::base::Ptr<gfx::RGBAPixmap> m_frame;
     };
 
 } } }
@@ -14,7 +14,12 @@ section('Options',
         paragraph_detail(text_option('--nogc'),
                          paragraph_text('Disable garbage collection.',
                                         'For a content-addressable (git) backend, <i>c2file-server</i> will remove unused files on startup.',
-                                        'This option disables the garbage collection procecss.')));
+                                        'This option disables the garbage collection procecss.'),
+        paragraph_detail(text_option('--repack'),
+                         paragraph_text('Repack on startup.',
+                                        'For a content-addressable (git) backend, <i>c2file-server</i> will combine all objects into a single pack file',
+                                        'and remove the individual object files.',
+                                        'This speeds up subsequent startups and reduces the number of files.')));
 
 section('Environment',
         paragraph_default_server_environment());
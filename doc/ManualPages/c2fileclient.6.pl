@@ -29,6 +29,10 @@ section('Commands',
                                         'Point browser at "http://<i>HOST</i><b>:</b><i>PORT</i>/";')),
         paragraph_detail('<b>gc</b> [<b>-n</b>] [<b>-f</b>] <i>PATH</i>',
                          paragraph_text('Garbage-collect the CA filesystem contained in path <i>PATH</i>;')),
+        paragraph_detail('<b>repack</b> <i>PATH</i>',
+                         paragraph_text('Pack all objects reachable in the CA filesystem contained in path <i>PATH</i> into a single pack file,',
+                                        'replacing existing pack files and loose objects.',
+                                        'This reduces the number of files and speeds up startup;')),
         paragraph_detail('<b>snapshot</b> <i>PATH</i> <b>ls</b> [<b>-l</b>]',
                          paragraph_text('List snapshots on CA file system in path <i>PATH</i>;')),
         paragraph_detail('<b>snapshot</b> <i>PATH</i> <b>add</b> <i>NAME</i>...',
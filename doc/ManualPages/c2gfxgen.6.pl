@@ -14,7 +14,11 @@ subsect('Common Options',
         paragraph_detail(text_option('-w', 'WIDTH'),    paragraph_text('Set width of output file;')),
         paragraph_detail(text_option('-h', 'HEIGHT'),   paragraph_text('Set height of output file;')),
         paragraph_detail(text_option('-S', 'SEED'),     paragraph_text('Set seed for random number generator;')),
-        paragraph_detail(text_option('-o', 'FILE.bmp'), paragraph_text('Set output file name (mandatory).')));
+        paragraph_detail(text_option('-o', 'FILE.bmp'), paragraph_text('Set output file name (mandatory);')),
+        paragraph_detail(text_option('-j', 'THREADS'),  paragraph_text('Set number of threads for rendering ("space", "planet", "orbit").',
+                                                                       'The result does not depend on the number of threads;')),
+        paragraph_detail(text_option('--benchmark', 'N'), paragraph_text('Render the image <i>N</i> times and report the time taken, before rendering the output file ("space", "planet", "orbit").',
+                                                                         'The output file is the same as without this option.')));
 
 subsect('Command "space"',
         paragraph_text('This command generates a space view (starfield, nebula).'),
@@ -26,7 +26,16 @@ section('Options',
         paragraph_detail(text_option('--language=', 'CODE'),
                          paragraph_text('Select language to use for game.',
                                         'If <i>c2play-server</i> prepares text to show to the user (e.g. query/istatX.X),',
-                                        'it will use this language.')));
+                                        'it will use this language;')),
+        paragraph_detail(text_option('--benchmark=', 'N'),
+                         paragraph_text('Benchmark mode.',
+                                        'Instead of reading commands from standard input, load the game,',
+                                        'retrieve all ships, planets and global objects <i>N</i> times as a single request, and report the time taken.',
+                                        'Nothing is saved;')),
+        paragraph_detail('<b>--wait</b>',
+                         paragraph_text('Wait for parameters on standard input, one per line, terminated by an empty line.',
+                                        'Options and parameters given there are processed as if given on the command line.',
+                                        'This is used by <link>c2router-server(6)</link> to start processes in advance.')));
 
 section('Author',
         paragraph_default_author());
@@ -32,12 +32,22 @@ section('Options',
                                         'and <link>genhtml(1)</link> to convert it onto a user-friendly report;')),
         paragraph_detail(text_option('--coverage-test-name', 'NAME'),
                          paragraph_text('Set the test name ("TN:" tag) to write into the coverage report;')),
+        paragraph_detail(text_option('--benchmark', 'N'),
+                         paragraph_text('Execute the script <i>N</i> times on the same game data, and report the time taken.',
+                                        'The script output is produced <i>N</i> times, too;')),
         paragraph_default_optimizer(';'),
         paragraph_default_command(';'),
         paragraph_default_log(';'),
         paragraph_detail(text_option('-q'),
                          paragraph_text('Configure log output to show script output only, no status messages.')));
 
+section('Examples');
+
+subsect('Benchmarking',
+        paragraph_text('To measure the speed of script execution on a typical loop over ships, use'),
+        paragraph_indent("c2script -q -G DIR --benchmark 100 -k 'Dim n = 0' 'ForEach Ship Do If Owner=My.Race Then n:=n+Mission'"),
+        paragraph_text('Run the same command with different versions of <i>c2script</i> to compare them.'));
+
 section('Environment',
         paragraph_default_environment());
 
@@ -26,6 +26,10 @@ subsect('Actions',
                          paragraph_text('Run a series of simulations.',
                                         'The length of the series is determined from the simulation settings.',
                                         'With <b>--seed-control</b>, a series will produce every possible result;')),
+        paragraph_detail(text_option('--benchmark', 'N'),
+                         paragraph_text('Run <i>N</i> simulations each with 1, 2, ... threads, up to the number given with <b>--jobs</b>,',
+                                        'and report the time taken, the speedup compared to a single thread,',
+                                        'and the number of simulation jobs allocated (jobs are reused, so this should not grow with <i>N</i>);')),
         paragraph_default_help());
 
 subsect('Options',
@@ -39,6 +43,10 @@ subsect('Options',
                                         "Defaults to PCC2's built-in defaults;")),
         paragraph_detail(text_option('--charset', 'CS', '-C', 'CS'),
                          paragraph_text('Set game character set;')),
+        paragraph_detail(text_option('--add-fleet', 'N'),
+                         paragraph_text('Add two opposing fleets of <i>N</i> carriers each to the simulation setup.',
+                                        'Together with <b>--mode=flak</b> and <b>--benchmark</b>, this measures large fleet battles.',
+                                        'If this option is given, no input file is required;')),
         paragraph_detail(text_option('-q'),
                          paragraph_text('Suppress some status messages;')),
         paragraph_default_log());
@@ -47,6 +55,9 @@ subsect('Simulation Options',
         paragraph_text('These options are only relevant when simulations are run.'),
         paragraph_detail(text_option('--jobs', 'N', '-j', 'IN'),
                          paragraph_text('Set number of threads for simulation;')),
+        paragraph_detail(text_option('--batch', 'N'),
+                         paragraph_text('When using multiple threads, hand out simulations to threads in batches of <i>N</i>.',
+                                        'This reduces synchronisation overhead for short fights;')),
         paragraph_detail(text_option('--mode', 'MODE'),
                          paragraph_text('Set mode (host, phost2, phost3, phost4, flak, nuhost).',
                                         'Setting a mode also sets defaults for <b>--esb</b>, <b>--scotty</b>, <b>--random-sides</b>, and <b>--balance</b>;')),
@@ -10,6 +10,7 @@
 #include "afl/charset/codepagecharset.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/parse.hpp"
+#include "afl/string/string.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
 #include "game/config/userconfiguration.hpp"
 #include "game/exception.hpp"
@@ -21,6 +22,8 @@
 #include "game/turn.hpp"
 #include "game/turnloader.hpp"
 #include "game/v3/rootloader.hpp"
+#include "game/vcr/battle.hpp"
+#include "game/vcr/database.hpp"
 #include "interpreter/callablevalue.hpp"
 #include "interpreter/error.hpp"
 #include "interpreter/exporter/configuration.hpp"
@@ -28,6 +31,7 @@
 #include "util/charsetfactory.hpp"
 #include "util/profiledirectory.hpp"
 #include "util/string.hpp"
+#include "util/systeminformation.hpp"
 #include "version.hpp"
 
 using afl::base::Optional;
@@ -181,6 +185,15 @@ game::interface::ExportApplication::appMain()
 
     session.postprocessTurn(session.getGame()->currentTurn(), game::PlayerSet_t(arg_race), game::PlayerSet_t(arg_race), game::map::Object::ReadOnly);
 
+    // Exporting VCRs computes all battle results; do that in parallel beforehand
+    if (afl::string::strCaseCompare(*parg_array, "VCR") == 0) {
+        if (game::vcr::Database* battles = session.getGame()->currentTurn().getBattles().get()) {
+            battles->prepareResults(root->hostConfiguration(), *session.getShipList(),
+                                    game::vcr::Battle::NeedQuickOutcome | game::vcr::Battle::NeedCompleteResult,
+                                    util::getSystemInformation().numProcessors);
+        }
+    }
+
     // What do we want to export?
     std::auto_ptr<Context> array(findArray(*parg_array, session.world()));
     if (opt_fields) {
@@ -3,6 +3,7 @@
   *  \brief Class game::interface::ScriptApplication
   */
 
+#include <algorithm>
 #include <stdexcept>
 #include <vector>
 #include "game/interface/scriptapplication.hpp"
@@ -20,6 +21,7 @@
 #include "afl/sys/commandlineparser.hpp"
 #include "afl/sys/environment.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
+#include "afl/sys/time.hpp"
 #include "game/exception.hpp"
 #include "game/game.hpp"
 #include "game/interface/consolecommands.hpp"
@@ -69,6 +71,7 @@ struct game::interface::ScriptApplication::Parameters {
     int playerNumber;                                  // -P
     Optional<String_t> coverageFile;                   // --coverage
     String_t coverageTestName;                         // --coverage-test-name
+    Optional<int> benchmarkCount;                      // --benchmark
 
     Parameters()
         : arg_gamedir(),
@@ -82,7 +85,8 @@ struct game::interface::ScriptApplication::Parameters {
           optimisationLevel(1),
           playerNumber(0),
           coverageFile(),
-          coverageTestName()
+          coverageTestName(),
+          benchmarkCount()
         { }
 };
 
@@ -174,6 +178,30 @@ namespace {
     }
 
 
+    /* Execute a compiled script in a new process.
+       Returns true on success, false if the process failed (error has been logged). */
+    bool doExecProcess(game::Session& session, const BCORef_t& bco)
+    {
+        interpreter::ProcessList& processList = session.processList();
+        interpreter::Process& proc = processList.create(session.world(), session.translator().translateString("Console"));
+
+        proc.pushFrame(bco, false);
+        uint32_t pgid = processList.allocateProcessGroup();
+        processList.resumeProcess(proc, pgid);
+        processList.startProcessGroup(pgid);
+        session.runScripts();
+
+        bool ok = true;
+        if (proc.getState() == interpreter::Process::Failed) {
+            // Log exception
+            session.logError(proc.getError());
+            ok = false;
+        }
+        processList.removeTerminatedProcesses();
+        return ok;
+    }
+
+
     /*
      *  Execute Mode
      */
@@ -243,23 +271,24 @@ namespace {
             session.setNewScriptRunner(new CoverageRunner(session, *pCoverage));
         }
 
-        // Execute the process
-        interpreter::ProcessList& processList = session.processList();
-        interpreter::Process& proc = processList.create(session.world(), tx.translateString("Console"));
-
-        proc.pushFrame(bco, false);
-        uint32_t pgid = processList.allocateProcessGroup();
-        processList.resumeProcess(proc, pgid);
-        processList.startProcessGroup(pgid);
-        session.runScripts();
-
+        // Execute the process.
+        // In benchmark mode, execute it repeatedly, on the same game data.
         int returnCode = 0;
-        if (proc.getState() == interpreter::Process::Failed) {
-            // Log exception
-            session.logError(proc.getError());
-            returnCode = 1;
+        const int count = params.benchmarkCount.orElse(1);
+        const uint32_t startTime = afl::sys::Time::getTickCounter();
+        int numRuns = 0;
+        while (numRuns < count && returnCode == 0) {
+            if (!doExecProcess(session, bco)) {
+                returnCode = 1;
+            }
+            ++numRuns;
+        }
+        if (params.benchmarkCount.isValid() && returnCode == 0) {
+            const uint32_t elapsed = std::max(afl::sys::Time::getTickCounter() - startTime, uint32_t(1));
+            session.log().write(LogListener::Info, LOG_NAME,
+                                Format(tx("Executed %d time%!1{s%} in %d ms, %.2f ms per run"),
+                                       numRuns, elapsed, double(elapsed) / numRuns));
         }
-        processList.removeTerminatedProcesses();
         session.setNewScriptRunner(0);
 
         // Save coverage
@@ -392,6 +421,13 @@ game::interface::ScriptApplication::parseParameters(Parameters& params)
                 params.coverageFile = commandLine.getRequiredParameter(p);
             } else if (p == "coverage-test-name") {
                 params.coverageTestName = commandLine.getRequiredParameter(p);
+            } else if (p == "benchmark") {
+                String_t arg = commandLine.getRequiredParameter(p);
+                int value = 0;
+                if (!afl::string::strToInteger(arg, value) || value <= 0) {
+                    errorExit(tx("option '--benchmark' needs a positive number as parameter"));
+                }
+                params.benchmarkCount = value;
             } else if (p == "readonly" || p == "read-only") {
                 params.opt_readonly = true;
             } else if (p == "q") {
@@ -423,6 +459,7 @@ game::interface::ScriptApplication::help()
                                "--charset/-C CS\tSet game character set\n"
                                "--coverage FILE.info\tProduce coverage report\n"
                                "--coverage-test-name NAME\tTest name to write to coverage report\n"
+                               "--benchmark N\tExecute the script N times, report timing\n"
                                "-O LVL\tOptimisation level\n"
                                "-k\tExecute commands, not files\n"
                                "--log CONFIG\tConfigure log output\n"
@@ -3,20 +3,47 @@
   *  \brief Class game::map::MovementPredictor
   */
 
+#include <algorithm>
 #include <cassert>
 #include "game/map/movementpredictor.hpp"
 #include "game/map/anyshiptype.hpp"
 #include "game/map/objectvector.hpp"
+#include "game/map/planet.hpp"
 #include "game/map/ship.hpp"
 #include "game/map/shippredictor.hpp"
 #include "game/map/universe.hpp"
 #include "game/spec/mission.hpp"
 
+using game::Id_t;
+using game::map::Planet;
+using game::map::Point;
+using game::map::Ship;
 using game::spec::Mission;
 
+namespace {
+    /* Union-find: find group of a ship */
+    Id_t findGroup(std::vector<Id_t>& group, Id_t id)
+    {
+        while (group[id] != id) {
+            group[id] = group[group[id]];
+            id = group[id];
+        }
+        return id;
+    }
+
+    /* Union-find: join groups of two ships. Ignores invalid Ids. */
+    void joinGroups(std::vector<Id_t>& group, Id_t a, Id_t b)
+    {
+        if (b > 0 && b < Id_t(group.size())) {
+            group[findGroup(group, a)] = findGroup(group, b);
+        }
+    }
+}
+
 // Default constructor.
 game::map::MovementPredictor::MovementPredictor()
-    : m_info()
+    : m_info(),
+      m_complete(false)
 { }
 
 // Destructor.
@@ -32,10 +59,37 @@ game::map::MovementPredictor::computeMovement(const Universe& univ,
 {
     // ex GMovementPredictor::computeMovement
     // ex shipacc.pas:InitMovementPrediction (loosely based)
-    init(univ);
-    resolveTows(univ);
-    while (moveShips(univ, game, shipList, root)) {
-        // nix
+    m_info.clear();
+    m_complete = true;
+
+    std::vector<Id_t> ships;
+    const AnyShipType& ty(univ.allShips());
+    for (Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
+        ships.push_back(i);
+    }
+    computeShips(univ, game, shipList, root, ships);
+}
+
+// Update movement after a change.
+void
+game::map::MovementPredictor::updateMovement(const Universe& univ,
+                                             const Game& game,
+                                             const game::spec::ShipList& shipList,
+                                             const Root& root,
+                                             const std::vector<Id_t>& changedShips)
+{
+    if (!m_complete) {
+        computeMovement(univ, game, shipList, root);
+    } else {
+        std::vector<Id_t> ships;
+        collectAffectedShipsFromInfo(univ, changedShips, ships);
+        computeShips(univ, game, shipList, root, ships);
+
+        // A full computation stops at the first unresolvable ship, leaving all others unresolved.
+        // Therefore, if this happens, the partial result would differ from a full computation.
+        if (!m_complete) {
+            computeMovement(univ, game, shipList, root);
+        }
     }
 }
 
@@ -44,7 +98,8 @@ afl::base::Optional<game::map::Point>
 game::map::MovementPredictor::getShipPosition(Id_t sid) const
 {
     // ex GMovementPredictor::getShipPosition
-    if (Info* p = m_info.get(sid)) {
+    Info* p = m_info.get(sid);
+    if (p != 0 && p->status != NonExisting) {
         return p->pos;
     } else {
         return afl::base::Nothing;
@@ -56,7 +111,8 @@ bool
 game::map::MovementPredictor::getShipCargo(Id_t sid, Cargo_t& out) const
 {
     // ex GMovementPredictor::getShipCargo
-    if (Info* p = m_info.get(sid)) {
+    Info* p = m_info.get(sid);
+    if (p != 0 && p->status != NonExisting) {
         out = p->cargo;
         return true;
     } else {
@@ -64,19 +120,172 @@ game::map::MovementPredictor::getShipCargo(Id_t sid, Cargo_t& out) const
     }
 }
 
+// Get dependency links of a ship.
+game::map::MovementPredictor::Links
+game::map::MovementPredictor::getShipLinks(const Ship& sh)
+{
+    Links result;
+
+    // Tow
+    if (sh.getMission().orElse(0) == Mission::msn_Tow) {
+        result.towId = sh.getMissionParameter(game::TowParameter).orElse(0);
+    }
+
+    // Intercept
+    // ex GMovementPredictor::isValidIntercept (part)
+    // ex shipacc.pas:Intercepting
+    int msn = sh.getMission().orElse(0);
+    int i = sh.getMissionParameter(game::InterceptParameter).orElse(0);
+    if (msn == Mission::msn_Intercept && i != sh.getId()) {
+        result.interceptId = i;
+    }
+    return result;
+}
+
+// Find changed ships.
+void
+game::map::MovementPredictor::findChangedShips(const Universe& univ, std::vector<Id_t>& changedShips)
+{
+    // Planets
+    std::vector<Point> planetPositions;
+    for (Id_t i = 1, n = univ.planets().size(); i <= n; ++i) {
+        const Planet* pl = univ.planets().get(i);
+        Point pt;
+        if (pl != 0 && pl->isDirty() && pl->getPosition().get(pt)) {
+            planetPositions.push_back(pt);
+        }
+    }
+
+    // Ships
+    for (Id_t i = 1, n = univ.ships().size(); i <= n; ++i) {
+        if (const Ship* sh = univ.ships().get(i)) {
+            Point pt;
+            if (sh->isDirty()
+                || (!planetPositions.empty()
+                    && sh->getPosition().get(pt)
+                    && std::find(planetPositions.begin(), planetPositions.end(), pt) != planetPositions.end()))
+            {
+                changedShips.push_back(i);
+            }
+        }
+    }
+}
+
+// Collect ships affected by a change.
+void
+game::map::MovementPredictor::collectAffectedShips(const Universe& univ,
+                                                   const std::vector<Links>& previousLinks,
+                                                   const std::vector<Id_t>& changedShips,
+                                                   std::vector<Id_t>& affectedShips)
+{
+    // Build groups of dependant ships, using previous and current links
+    const AnyShipType& ty(univ.allShips());
+    const Id_t n = std::max(univ.ships().size(), Id_t(previousLinks.size()) - 1);
+    std::vector<Id_t> group;
+    for (Id_t i = 0; i <= n; ++i) {
+        group.push_back(i);
+    }
+    for (Id_t i = 1; i <= n; ++i) {
+        if (i < Id_t(previousLinks.size())) {
+            joinGroups(group, i, previousLinks[i].towId);
+            joinGroups(group, i, previousLinks[i].interceptId);
+        }
+        const Ship* pShip = univ.ships().get(i);
+        if (pShip != 0 && ty.isValid(*pShip)) {
+            const Links links = getShipLinks(*pShip);
+            joinGroups(group, i, links.towId);
+            joinGroups(group, i, links.interceptId);
+        }
+    }
+
+    // Mark groups containing changed ships
+    std::vector<bool> affected(n+1);
+    for (size_t i = 0, size = changedShips.size(); i < size; ++i) {
+        const Id_t sid = changedShips[i];
+        if (sid > 0 && sid <= n) {
+            affected[findGroup(group, sid)] = true;
+        }
+    }
+
+    // Collect ships
+    for (Id_t i = 1; i <= n; ++i) {
+        if (affected[findGroup(group, i)]) {
+            affectedShips.push_back(i);
+        }
+    }
+}
+
+
+/** Compute movement for a set of ships.
+    The set must contain all ships that depend on each other.
+    \param univ     Universe
+    \param game     Game
+    \param shipList Ship list
+    \param root     Root
+    \param ships    Ship Ids, in increasing order */
+void
+game::map::MovementPredictor::computeShips(const Universe& univ,
+                                           const Game& game,
+                                           const game::spec::ShipList& shipList,
+                                           const Root& root,
+                                           const std::vector<Id_t>& ships)
+{
+    init(univ, ships);
+    resolveTows(univ, ships);
+    while (moveShips(univ, game, shipList, root, ships)) {
+        // nix
+    }
+}
+
+/** Collect ships affected by a change, using the links recorded by the previous computation.
+    Information for affected ships that no longer exist is discarded.
+    \param [in]  univ          Universe
+    \param [in]  changedShips  Ids of changed ships
+    \param [out] ships         Ship Ids, in increasing order */
+void
+game::map::MovementPredictor::collectAffectedShipsFromInfo(const Universe& univ, const std::vector<Id_t>& changedShips, std::vector<Id_t>& ships)
+{
+    // Previous links
+    std::vector<Links> previousLinks(m_info.size()+1);
+    for (Id_t i = 1, n = m_info.size(); i <= n; ++i) {
+        if (const Info* pInfo = m_info.get(i)) {
+            previousLinks[i].towId = pInfo->towId;
+            previousLinks[i].interceptId = pInfo->interceptId;
+        }
+    }
+
+    // Affected ships
+    std::vector<Id_t> affectedShips;
+    collectAffectedShips(univ, previousLinks, changedShips, affectedShips);
+
+    const AnyShipType& ty(univ.allShips());
+    for (size_t index = 0, n = affectedShips.size(); index < n; ++index) {
+        const Id_t i = affectedShips[index];
+        const Ship* pShip = univ.ships().get(i);
+        if (pShip != 0 && ty.isValid(*pShip)) {
+            ships.push_back(i);
+        } else if (Info* pInfo = m_info.get(i)) {
+            *pInfo = Info(i);
+        }
+    }
+}
 
 /** Initialize movement info.
-    Initialize all ship's status and waypoint.
-    \param univ Universe */
+    Initialize ships' status and waypoint.
+    \param univ  Universe
+    \param ships Ship Ids */
 void
-game::map::MovementPredictor::init(const Universe& univ)
+game::map::MovementPredictor::init(const Universe& univ, const std::vector<Id_t>& ships)
 {
     // ex GMovementPredictor::init
-    const AnyShipType& ty(univ.allShips());
-    for (Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
+    for (size_t index = 0, n = ships.size(); index < n; ++index) {
+        const Id_t i = ships[index];
         if (const Ship* pShip = univ.ships().get(i)) {
             if (Info* pInfo = m_info.create(i)) {
                 pInfo->status = Normal;
+                const Links links = getShipLinks(*pShip);
+                pInfo->towId = links.towId;
+                pInfo->interceptId = links.interceptId;
                 if (pShip->isPlayable(Ship::ReadOnly)) {
                     pShip->getWaypoint().get(pInfo->pos);
                 } else {
@@ -94,14 +303,15 @@ game::map::MovementPredictor::init(const Universe& univ)
 
 /** Tow resolution.
     Set all towing/towed ships' status.
-    \param univ Universe */
+    \param univ  Universe
+    \param ships Ship Ids */
 void
-game::map::MovementPredictor::resolveTows(const Universe& univ)
+game::map::MovementPredictor::resolveTows(const Universe& univ, const std::vector<Id_t>& ships)
 {
     // Assume any tow succeeds.
     // Anyway, be careful not to make tow groups with more than two ships.
-    const AnyShipType& ty(univ.allShips());
-    for (Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
+    for (size_t index = 0, n = ships.size(); index < n; ++index) {
+        const Id_t i = ships[index];
         const Ship* pShip = univ.ships().get(i);
         Info* pInfo = m_info.get(i);
         if (pShip != 0 && pInfo != 0 && pShip->getMission().orElse(0) == Mission::msn_Tow) {
@@ -122,7 +332,8 @@ bool
 game::map::MovementPredictor::moveShips(const Universe& univ,
                                         const Game& game,
                                         const game::spec::ShipList& shipList,
-                                        const Root& root)
+                                        const Root& root,
+                                        const std::vector<Id_t>& ships)
 {
     // ex GMovementPredictor::moveShips
     bool moved = false;             // true if we moved a ship
@@ -136,8 +347,8 @@ game::map::MovementPredictor::moveShips(const Universe& univ,
     // - ours, Normal, intercepting, towee not Moved: wait for next iteration.
     //   For a normal, non-cyclic intercept, the next iteration will ultimately move it.
     //   For a cyclic intercept, we need special handling; see below.
-    const AnyShipType& ty(univ.allShips());
-    for (Id_t sid = ty.findNextIndex(0); sid != 0; sid = ty.findNextIndex(sid)) {
+    for (size_t index = 0, n = ships.size(); index < n; ++index) {
+        const Id_t sid = ships[index];
         const Ship* pShip = univ.ships().get(sid);
         Info* pInfo = m_info.get(sid);
         if (pShip != 0 && pInfo != 0) {
@@ -184,6 +395,7 @@ game::map::MovementPredictor::moveShips(const Universe& univ,
                         }
                     } else {
                         // Error
+                        m_complete = false;
                         return false;
                     }
                 }
@@ -217,6 +429,7 @@ game::map::MovementPredictor::moveShips(const Universe& univ,
             Ship* pShip = univ.ships().get(sid);
             if (pInfo == 0 || pShip == 0) {
                 // Error
+                m_complete = false;
                 return false;
             }
             if (pInfo->status != Normal) {
@@ -226,6 +439,7 @@ game::map::MovementPredictor::moveShips(const Universe& univ,
             if (getInterceptTarget(*pShip) == 0) {
                 // This is an error and cannot (should not) happen.
                 // If it happens anyway, stop to avoid infinite loop.
+                m_complete = false;
                 return false;
             }
             pInfo->status = ResolvingLoop;
@@ -295,11 +509,9 @@ game::map::MovementPredictor::Info*
 game::map::MovementPredictor::getInterceptTarget(const Ship& sh) const
 {
     // ex GMovementPredictor::isValidIntercept
-    // ex shipacc.pas:Intercepting
-    int msn = sh.getMission().orElse(0);
-    int i = sh.getMissionParameter(InterceptParameter).orElse(0);
-    if (msn == Mission::msn_Intercept && i != sh.getId()) {
-        return m_info.get(i);
+    Info* p = m_info.get(getShipLinks(sh).interceptId);
+    if (p != 0 && p->status != NonExisting) {
+        return p;
     } else {
         return 0;
     }
@@ -5,6 +5,7 @@
 #ifndef C2NG_GAME_MAP_MOVEMENTPREDICTOR_HPP
 #define C2NG_GAME_MAP_MOVEMENTPREDICTOR_HPP
 
+#include <vector>
 #include "afl/base/optional.hpp"
 #include "game/element.hpp"
 #include "game/game.hpp"
@@ -22,12 +23,28 @@ namespace game { namespace map {
 
     /** Movement prediction for universe-at-once.
         Resolves intercept and tow missions and computes movement for all ships in the proper order.
-        Internally, uses ShipPredictor to resolve the individual ships. */
+        Internally, uses ShipPredictor to resolve the individual ships.
+
+        After an initial computeMovement(), changes to individual ships can be processed using updateMovement().
+        Ships interact only through tow and intercept missions.
+        updateMovement() therefore recomputes only the groups of ships connected to a changed ship through these missions,
+        and produces the same result as a new computeMovement(). */
     class MovementPredictor {
      public:
         /** Shortcut type name. */
         typedef game::spec::Cost Cargo_t;
 
+        /** Dependency links of a ship.
+            Ships depend on each other through tow and intercept missions. */
+        struct Links {
+            Id_t towId;             ///< Tow target, 0 if none.
+            Id_t interceptId;       ///< Intercept target, 0 if none.
+
+            Links()
+                : towId(0), interceptId(0)
+                { }
+        };
+
         /** Default constructor.
             Makes blank object.
             Call computeMovement() to fill it in. */
@@ -47,6 +64,26 @@ namespace game { namespace map {
                              const game::spec::ShipList& shipList,
                              const Root& root);
 
+        /** Update movement after a change.
+            Recomputes the given ships, and all ships connected to them by tow or intercept missions
+            (before or after the change).
+            If computeMovement() has not been called before, or could not resolve all ships, performs a full computation.
+
+            Changes that affect ships indirectly must be reported by listing the affected ships;
+            for example, a change to a planet affects all ships orbiting it.
+            Changes to configuration or specification require a new computeMovement().
+
+            \param univ         Universe to start with
+            \param game         Game (required for shipScores)
+            \param shipList     Ship list
+            \param root         Root (required for hostConfiguration, hostVersion, registrationKey)
+            \param changedShips Ids of changed ships */
+        void updateMovement(const Universe& univ,
+                            const Game& game,
+                            const game::spec::ShipList& shipList,
+                            const Root& root,
+                            const std::vector<Id_t>& changedShips);
+
         /** Get ship position.
             Call after computeMovement().
             \param [in]  sid  Ship Id
@@ -61,6 +98,32 @@ namespace game { namespace map {
             \retval false ship position not known, \c out not set */
         bool getShipCargo(Id_t sid, Cargo_t& out) const;
 
+        /** Get dependency links of a ship.
+            \param sh Ship
+            \return tow and intercept targets */
+        static Links getShipLinks(const Ship& sh);
+
+        /** Find changed ships.
+            A ship's movement changes if the ship is dirty (Object::isDirty()),
+            or if it orbits a dirty planet (starbase missions).
+            Ships that depend on these ships are not included; use collectAffectedShips() to find them.
+            \param [in]  univ          Universe
+            \param [out] changedShips  Ids of changed ships are appended here, in increasing order */
+        static void findChangedShips(const Universe& univ, std::vector<Id_t>& changedShips);
+
+        /** Collect ships affected by a change.
+            Ships depend on each other if one tows or intercepts the other, before or after the change.
+            Produces the Ids of all ships that directly or indirectly depend on a changed ship, including the changed ships.
+            This includes Ids of ships that no longer exist but had links before the change.
+            \param [in]  univ           Universe (current links)
+            \param [in]  previousLinks  Links before the change, indexed by ship Id; may be shorter than the universe
+            \param [in]  changedShips   Ids of changed ships
+            \param [out] affectedShips  Ids of affected ships are appended here, in increasing order */
+        static void collectAffectedShips(const Universe& univ,
+                                         const std::vector<Links>& previousLinks,
+                                         const std::vector<Id_t>& changedShips,
+                                         std::vector<Id_t>& affectedShips);
+
      private:
         enum Status {
             NonExisting,            // ship does not exist
@@ -74,22 +137,34 @@ namespace game { namespace map {
             Status status : 8;
             Point pos;              // if Moved, current position. Otherwise: waypoint.
             Cargo_t cargo;
+            Id_t towId;             // tow target, for dependency tracking
+            Id_t interceptId;       // intercept target, for dependency tracking
 
             Info(int)
                 : status(NonExisting),
                   pos(0, 0),
-                  cargo()
+                  cargo(),
+                  towId(0),
+                  interceptId(0)
                 { }
         };
 
         ObjectVector<Info> m_info;
-
-        void init(const Universe& univ);
-        void resolveTows(const Universe& univ);
+        bool m_complete;            // true if last computation resolved all ships
+
+        void computeShips(const Universe& univ,
+                          const Game& game,
+                          const game::spec::ShipList& shipList,
+                          const Root& root,
+                          const std::vector<Id_t>& ships);
+        void collectAffectedShipsFromInfo(const Universe& univ, const std::vector<Id_t>& changedShips, std::vector<Id_t>& ships);
+        void init(const Universe& univ, const std::vector<Id_t>& ships);
+        void resolveTows(const Universe& univ, const std::vector<Id_t>& ships);
         bool moveShips(const Universe& univ,
                        const Game& game,
                        const game::spec::ShipList& shipList,
-                       const Root& root);
+                       const Root& root,
+                       const std::vector<Id_t>& ships);
 
         Info* getInterceptTarget(const Ship& sh) const;
         static void copyCargo(Info& info, const Ship& sh, Cargo_t::Type infoElement, Element::Type shipElement);
@@ -0,0 +1,176 @@
+/**
+  *  \file game/map/movementpredictorextra.cpp
+  *  \brief Class game::map::MovementPredictorExtra
+  */
+
+#include "game/map/movementpredictorextra.hpp"
+#include "game/game.hpp"
+#include "game/map/minefield.hpp"
+#include "game/map/universe.hpp"
+#include "game/root.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/turn.hpp"
+
+using game::map::MovementPredictorExtra;
+using game::map::Universe;
+
+namespace {
+    // Extra Identifier
+    const game::ExtraIdentifier<game::Session, MovementPredictorExtra> MOVEMENT_ID = {{}};
+
+    /* Shortcut to retrieve the viewpoint-universe from a session */
+    Universe* getUniverse(game::Session& session)
+    {
+        if (game::Game* g = session.getGame().get()) {
+            return &g->viewpointTurn().universe();
+        }
+        return 0;
+    }
+}
+
+game::map::MovementPredictorExtra::MovementPredictorExtra(Session& session)
+    : m_session(session),
+      m_predictor(),
+      m_valid(false),
+      m_changedShips(),
+      conn_connectionChange(session.sig_connectionChange.add(this, &MovementPredictorExtra::onConnectionChange)),
+      conn_viewpointTurnChange(),
+      conn_preUpdate(),
+      conn_configChange()
+{
+    onConnectionChange();
+}
+
+game::map::MovementPredictorExtra::~MovementPredictorExtra()
+{ }
+
+game::map::MovementPredictorExtra&
+game::map::MovementPredictorExtra::create(Session& session)
+{
+    MovementPredictorExtra* p = session.extra().get(MOVEMENT_ID);
+    if (p == 0) {
+        p = session.extra().setNew(MOVEMENT_ID, new MovementPredictorExtra(session));
+    }
+    return *p;
+}
+
+game::map::MovementPredictorExtra*
+game::map::MovementPredictorExtra::get(Session& session)
+{
+    return session.extra().get(MOVEMENT_ID);
+}
+
+const game::map::MovementPredictor*
+game::map::MovementPredictorExtra::getPrediction()
+{
+    const Game* g = m_session.getGame().get();
+    const Root* r = m_session.getRoot().get();
+    const game::spec::ShipList* sl = m_session.getShipList().get();
+    if (g == 0 || r == 0 || sl == 0) {
+        return 0;
+    }
+
+    // Pick up changes not yet announced by Universe::notifyListeners()
+    checkObjects();
+
+    const Universe& univ = g->viewpointTurn().universe();
+    if (!m_valid) {
+        m_predictor.computeMovement(univ, *g, *sl, *r);
+        m_valid = true;
+    } else if (!m_changedShips.empty()) {
+        m_predictor.updateMovement(univ, *g, *sl, *r, m_changedShips);
+    }
+    m_changedShips.clear();
+    return &m_predictor;
+}
+
+/*
+ *  Events
+ */
+
+/** Session: connection change.
+    Hook Game and Root. */
+void
+game::map::MovementPredictorExtra::onConnectionChange()
+{
+    if (Game* g = m_session.getGame().get()) {
+        conn_viewpointTurnChange = g->sig_viewpointTurnChange.add(this, &MovementPredictorExtra::onViewpointTurnChange);
+    } else {
+        conn_viewpointTurnChange.disconnect();
+    }
+
+    if (Root* r = m_session.getRoot().get()) {
+        conn_configChange = r->hostConfiguration().sig_change.add(this, &MovementPredictorExtra::onConfigChange);
+    } else {
+        conn_configChange.disconnect();
+    }
+
+    onViewpointTurnChange();
+}
+
+/** Game: viewpoint turn change.
+    Hook the correct universe; next prediction will be a full computation. */
+void
+game::map::MovementPredictorExtra::onViewpointTurnChange()
+{
+    if (Universe* u = getUniverse(m_session)) {
+        conn_preUpdate = u->sig_preUpdate.add(this, &MovementPredictorExtra::onPreUpdate);
+    } else {
+        conn_preUpdate.disconnect();
+    }
+    m_valid = false;
+    m_changedShips.clear();
+}
+
+/** Universe: before update.
+    Collect dirty bits; they are reset afterwards. */
+void
+game::map::MovementPredictorExtra::onPreUpdate()
+{
+    checkObjects();
+}
+
+/** Root: host configuration changed.
+    Next prediction will be a full computation. */
+void
+game::map::MovementPredictorExtra::onConfigChange()
+{
+    m_valid = false;
+    m_changedShips.clear();
+}
+
+/*
+ *  Actions
+ */
+
+/** Check objects for changes.
+    Records changed ships, and ships orbiting changed planets (starbase missions).
+    A changed minefield can affect every ship laying mines, and requires a full computation. */
+void
+game::map::MovementPredictorExtra::checkObjects()
+{
+    const Universe* u = getUniverse(m_session);
+    if (u == 0 || !m_valid) {
+        return;
+    }
+
+    // Minefields
+    const MinefieldType& mfs = u->minefields();
+    for (Id_t i = 1, n = mfs.size(); i <= n; ++i) {
+        const Minefield* mf = mfs.get(i);
+        if (mf != 0 && mf->isDirty()) {
+            m_valid = false;
+            m_changedShips.clear();
+            return;
+        }
+    }
+
+    // Ships and planets
+    MovementPredictor::findChangedShips(*u, m_changedShips);
+
+    // If changes pile up without anyone looking, a full computation will be cheaper
+    if (m_changedShips.size() > size_t(u->ships().size())) {
+        m_valid = false;
+        m_changedShips.clear();
+    }
+}
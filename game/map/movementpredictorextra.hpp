@@ -0,0 +1,75 @@
+/**
+  *  \file game/map/movementpredictorextra.hpp
+  *  \brief Class game::map::MovementPredictorExtra
+  */
+#ifndef C2NG_GAME_MAP_MOVEMENTPREDICTOREXTRA_HPP
+#define C2NG_GAME_MAP_MOVEMENTPREDICTOREXTRA_HPP
+
+#include <vector>
+#include "afl/base/signalconnection.hpp"
+#include "game/extra.hpp"
+#include "game/map/movementpredictor.hpp"
+#include "game/session.hpp"
+
+namespace game { namespace map {
+
+    /** Shared movement prediction.
+        This is a Session extra that keeps a MovementPredictor for the viewpoint turn's universe.
+        It collects changes to ships and planets (Object::isDirty()),
+        and uses MovementPredictor::updateMovement() to update only the affected ships when the prediction is requested.
+        A change of game, viewpoint turn, host configuration, or minefields causes a full computation.
+
+        Use create() to obtain the instance, and getPrediction() to access the prediction. */
+    class MovementPredictorExtra : public Extra {
+     public:
+        /** Destructor. */
+        ~MovementPredictorExtra();
+
+        /** Create MovementPredictorExtra for a Session.
+            If the Session already has one, returns that, otherwise, creates one.
+            @param session Session
+            @return MovementPredictorExtra */
+        static MovementPredictorExtra& create(Session& session);
+
+        /** Get MovementPredictorExtra for a Session.
+            @param session Session
+            @return MovementPredictorExtra if the session has one, otherwise, null. */
+        static MovementPredictorExtra* get(Session& session);
+
+        /** Get prediction.
+            Processes all changes since the last call.
+            The returned object remains valid until the next call or until the session changes.
+            @return MovementPredictor; null if session has no Game, Root, or ShipList */
+        const MovementPredictor* getPrediction();
+
+     private:
+        /** Constructor.
+            @param session Session
+            @see create() */
+        explicit MovementPredictorExtra(Session& session);
+
+        // Events
+        void onConnectionChange();
+        void onViewpointTurnChange();
+        void onPreUpdate();
+        void onConfigChange();
+
+        // Actions
+        void checkObjects();
+
+        // Data
+        Session& m_session;                     ///< Session link.
+        MovementPredictor m_predictor;          ///< Prediction.
+        bool m_valid;                           ///< false if a full computation is required.
+        std::vector<Id_t> m_changedShips;       ///< Ships changed since last update.
+
+        // Signal connections
+        afl::base::SignalConnection conn_connectionChange;
+        afl::base::SignalConnection conn_viewpointTurnChange;
+        afl::base::SignalConnection conn_preUpdate;
+        afl::base::SignalConnection conn_configChange;
+    };
+
+} }
+
+#endif
@@ -8,6 +8,7 @@
 #include "afl/base/memory.hpp"
 #include "afl/string/format.hpp"
 #include "game/map/configuration.hpp"
+#include "game/map/spatialindex.hpp"
 
 namespace gp = game::parser;
 
@@ -151,7 +152,8 @@ game::map::Planet::Planet(Id_t id)
       m_queuePosition(),
       m_queuePriority(),
       m_unitScores(),
-      m_messages()
+      m_messages(),
+      m_spatialIndex(0)
 {
     // ex GPlanet::MapInfo::MapInfo etc.
     m_autobuildGoals[MineBuilding]         = 1000;
@@ -184,7 +186,8 @@ game::map::Planet::Planet(const Planet& other)
       m_queuePosition(other.m_queuePosition),
       m_queuePriority(other.m_queuePriority),
       m_unitScores(other.m_unitScores),
-      m_messages(other.m_messages)
+      m_messages(other.m_messages),
+      m_spatialIndex(0)
 {
     afl::base::Memory<int>(m_historyTimestamps).copyFrom(other.m_historyTimestamps);
     afl::base::Memory<int>(m_autobuildGoals).copyFrom(other.m_autobuildGoals);
@@ -424,6 +427,16 @@ game::map::Planet::setPosition(Point pt)
     // ex GPlanet::setXY
     m_position = pt;
     markDirty();
+    if (m_spatialIndex != 0) {
+        m_spatialIndex->setPosition(getId(), m_position);
+    }
+}
+
+// Attach spatial index.
+void
+game::map::Planet::setSpatialIndex(SpatialIndex* pIndex)
+{
+    m_spatialIndex = pIndex;
 }
 
 // Set planet name.
@@ -22,6 +22,7 @@
 namespace game { namespace map {
 
     class Configuration;
+    class SpatialIndex;
 
     /** Planet.
         This stores data of a planet and possibly a starbase.
@@ -114,9 +115,17 @@ namespace game { namespace map {
         void addMessageInformation(const game::parser::MessageInformation& info);
 
         /** Set position.
+            If a spatial index is attached, updates it immediately.
             \param pos Position */
         void setPosition(Point pos);
 
+        /** Attach spatial index.
+            setPosition() will update the planet's entry in this index,
+            so that location queries see the new position before the next Universe::notifyListeners().
+            Used by Universe. A copy of the planet is not attached.
+            \param pIndex Spatial index; null to detach */
+        void setSpatialIndex(SpatialIndex* pIndex);
+
         /** Set planet name.
             \param name Name */
         void setName(const String_t& name);
@@ -639,6 +648,8 @@ namespace game { namespace map {
 
         UnitScoreList m_unitScores;
         MessageLink m_messages;
+
+        SpatialIndex* m_spatialIndex;  // Index to update on setPosition()
     };
 
 } }
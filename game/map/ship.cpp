@@ -5,6 +5,7 @@
 
 #include "game/map/ship.hpp"
 #include "afl/string/format.hpp"
+#include "game/map/spatialindex.hpp"
 #include "game/parser/messagevalue.hpp"
 #include "util/math.hpp"
 
@@ -53,7 +54,8 @@ game::map::Ship::Ship(Id_t id)
       m_targetSource(),
       m_xySource(),
       m_unitScores(),
-      m_messages()
+      m_messages(),
+      m_spatialIndex(0)
 {
     m_historyTimestamps[0] = 0;
     m_historyTimestamps[1] = 0;
@@ -536,6 +538,15 @@ game::map::Ship::setPosition(Point pos)
     m_currentData.x = pos.getX();
     m_currentData.y = pos.getY();
     markDirty();
+    if (m_spatialIndex != 0) {
+        m_spatialIndex->setPosition(getId(), getPosition());
+    }
+}
+
+void
+game::map::Ship::setSpatialIndex(SpatialIndex* pIndex)
+{
+    m_spatialIndex = pIndex;
 }
 
 
@@ -20,6 +20,8 @@
 
 namespace game { namespace map {
 
+    class SpatialIndex;
+
     /** Ship.
         Represents all sorts of ship information:
         - current ships, i.e. seen this turn, and possibly played
@@ -190,9 +192,17 @@ namespace game { namespace map {
         void setOwner(int owner);
 
         /** Set position (for testing/host editor, not for consuming history).
+            If a spatial index is attached, updates it immediately.
             \param pos Position. */
         void setPosition(Point pos);
 
+        /** Attach spatial index.
+            setPosition() will update the ship's entry in this index,
+            so that location queries see the new position before the next Universe::notifyListeners().
+            Used by Universe.
+            \param pIndex Spatial index; null to detach */
+        void setSpatialIndex(SpatialIndex* pIndex);
+
 
         /*
          *  Type accessors
@@ -577,6 +587,8 @@ namespace game { namespace map {
         UnitScoreList m_unitScores;
         MessageLink m_messages;
 
+        SpatialIndex* m_spatialIndex;          // Index to update on setPosition()
+
         ShipData::Transfer& getTransporter(Transporter which);
         const ShipData::Transfer& getTransporter(Transporter which) const;
     };
@@ -0,0 +1,130 @@
+/**
+  *  \file game/map/spatialindex.cpp
+  *  \brief Class game::map::SpatialIndex
+  */
+
+#include <algorithm>
+#include <climits>
+#include "game/map/spatialindex.hpp"
+#include "game/map/configuration.hpp"
+
+game::map::SpatialIndex::SpatialIndex()
+    : m_entries(), m_positions()
+{ }
+
+game::map::SpatialIndex::~SpatialIndex()
+{ }
+
+void
+game::map::SpatialIndex::clear()
+{
+    m_entries.clear();
+    m_positions.clear();
+}
+
+void
+game::map::SpatialIndex::setPosition(Id_t id, afl::base::Optional<Point> pos)
+{
+    if (id <= 0) {
+        return;
+    }
+
+    // Remove old entry
+    size_t slot = static_cast<size_t>(id);
+    Point oldPos;
+    if (slot < m_positions.size() && m_positions[slot].get(oldPos)) {
+        std::vector<Entry>::iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), Entry(oldPos.getX(), oldPos.getY(), id));
+        if (it != m_entries.end() && it->id == id) {
+            m_entries.erase(it);
+        }
+        m_positions[slot] = afl::base::Nothing;
+    }
+
+    // Add new entry
+    Point newPos;
+    if (pos.get(newPos)) {
+        if (slot >= m_positions.size()) {
+            m_positions.resize(slot+1);
+        }
+        m_positions[slot] = newPos;
+
+        Entry e(newPos.getX(), newPos.getY(), id);
+        m_entries.insert(std::upper_bound(m_entries.begin(), m_entries.end(), e), e);
+    }
+}
+
+void
+game::map::SpatialIndex::setPositions(const std::vector<afl::base::Optional<Point> >& positions)
+{
+    clear();
+    m_positions = positions;
+    if (!m_positions.empty()) {
+        m_positions[0] = afl::base::Nothing;
+    }
+
+    m_entries.reserve(m_positions.size());
+    for (size_t i = 1, n = m_positions.size(); i < n; ++i) {
+        Point pos;
+        if (m_positions[i].get(pos)) {
+            m_entries.push_back(Entry(pos.getX(), pos.getY(), static_cast<Id_t>(i)));
+        }
+    }
+    std::sort(m_entries.begin(), m_entries.end());
+}
+
+afl::base::Optional<game::map::Point>
+game::map::SpatialIndex::getPosition(Id_t id) const
+{
+    size_t slot = static_cast<size_t>(id);
+    if (id > 0 && slot < m_positions.size()) {
+        return m_positions[slot];
+    } else {
+        return afl::base::Nothing;
+    }
+}
+
+void
+game::map::SpatialIndex::findAt(Point pt, std::vector<Id_t>& result) const
+{
+    // Entries for one point are sorted by Id
+    std::vector<Entry>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), Entry(pt.getX(), pt.getY(), INT_MIN));
+    while (it != m_entries.end() && it->x == pt.getX() && it->y == pt.getY()) {
+        result.push_back(it->id);
+        ++it;
+    }
+}
+
+void
+game::map::SpatialIndex::findInRange(Point pt, int range, const Configuration& mapConfig, std::vector<Id_t>& result) const
+{
+    // Collect candidates from all images.
+    // Configuration::getSquaredDistance() only considers rectangular wrap, so getNumRectangularImages() is the right limit.
+    std::vector<Id_t> tmp;
+    for (int i = 0, n = mapConfig.getNumRectangularImages(); i < n; ++i) {
+        Point alias = mapConfig.getSimplePointAlias(pt, i);
+        addRange(alias.getX() - range, alias.getX() + range, alias.getY() - range, alias.getY() + range, tmp);
+    }
+
+    // Sort and remove duplicates (a small map can place an object in range of multiple images)
+    std::sort(tmp.begin(), tmp.end());
+    tmp.erase(std::unique(tmp.begin(), tmp.end()), tmp.end());
+    result.insert(result.end(), tmp.begin(), tmp.end());
+}
+
+size_t
+game::map::SpatialIndex::getNumObjects() const
+{
+    return m_entries.size();
+}
+
+void
+game::map::SpatialIndex::addRange(int minX, int maxX, int minY, int maxY, std::vector<Id_t>& result) const
+{
+    std::vector<Entry>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), Entry(minX, INT_MIN, INT_MIN));
+    while (it != m_entries.end() && it->x <= maxX) {
+        if (it->y >= minY && it->y <= maxY) {
+            result.push_back(it->id);
+        }
+        ++it;
+    }
+}
@@ -0,0 +1,104 @@
+/**
+  *  \file game/map/spatialindex.hpp
+  *  \brief Class game::map::SpatialIndex
+  */
+#ifndef C2NG_GAME_MAP_SPATIALINDEX_HPP
+#define C2NG_GAME_MAP_SPATIALINDEX_HPP
+
+#include <vector>
+#include "afl/base/optional.hpp"
+#include "game/map/point.hpp"
+#include "game/types.hpp"
+
+namespace game { namespace map {
+
+    class Configuration;
+
+    /** Spatial index for map objects.
+        Maps positions to object Ids, to find objects at or near a location without iterating all objects.
+
+        The index stores one position per object Id.
+        Internally, entries are kept sorted by X, Y, and Id;
+        a query therefore needs a binary search plus iteration over the objects within the query's X range,
+        and reports results in Id order.
+
+        The index is a pure data container and does not know about object visibility.
+        Users must verify the objects they find (the index may know objects that have since become invisible). */
+    class SpatialIndex {
+     public:
+        /** Constructor.
+            Makes an empty index. */
+        SpatialIndex();
+
+        /** Destructor. */
+        ~SpatialIndex();
+
+        /** Clear.
+            \post getPosition(x).isValid() == false for all x */
+        void clear();
+
+        /** Set object position.
+            Adds, moves, or removes the object.
+            \param id  Object Id (>0)
+            \param pos New position; Nothing to remove the object from the index */
+        void setPosition(Id_t id, afl::base::Optional<Point> pos);
+
+        /** Set all object positions.
+            Replaces the index content.
+            Unlike repeated setPosition() calls, this sorts only once, and therefore runs in O(n log n).
+            \param positions Positions, indexed by object Id (element 0 is ignored); Nothing for objects not in the index */
+        void setPositions(const std::vector<afl::base::Optional<Point> >& positions);
+
+        /** Get object position.
+            \param id Object Id
+            \return position as given to setPosition(); Nothing if none */
+        afl::base::Optional<Point> getPosition(Id_t id) const;
+
+        /** Find objects at a location.
+            \param [in]  pt     Location (exact match; no wrap handling)
+            \param [out] result Object Ids are appended here, in increasing order */
+        void findAt(Point pt, std::vector<Id_t>& result) const;
+
+        /** Find objects in a square range around a location.
+            Finds all objects whose coordinates are at most \c range away from \c pt in X and Y direction,
+            considering all images of a wrapped map.
+            This is a superset of all objects whose Configuration::getSquaredDistance() to \c pt is at most range*range.
+
+            \param [in]  pt        Location
+            \param [in]  range     Range (>= 0)
+            \param [in]  mapConfig Map configuration
+            \param [out] result    Object Ids are appended here, in increasing order, without duplicates */
+        void findInRange(Point pt, int range, const Configuration& mapConfig, std::vector<Id_t>& result) const;
+
+        /** Get number of objects in index.
+            \return number of objects */
+        size_t getNumObjects() const;
+
+     private:
+        struct Entry {
+            int x;
+            int y;
+            Id_t id;
+            Entry(int x, int y, Id_t id)
+                : x(x), y(y), id(id)
+                { }
+            bool operator<(const Entry& other) const
+                {
+                    return x != other.x ? x < other.x
+                        : y != other.y ? y < other.y
+                        : id < other.id;
+                }
+        };
+
+        /** Entries, sorted. */
+        std::vector<Entry> m_entries;
+
+        /** Positions, indexed by Id. */
+        std::vector<afl::base::Optional<Point> > m_positions;
+
+        void addRange(int minX, int maxX, int minY, int maxY, std::vector<Id_t>& result) const;
+    };
+
+} }
+
+#endif
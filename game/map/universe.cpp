@@ -3,6 +3,7 @@
   *  \brief Class game::map::Universe
   */
 
+#include <cstdlib>
 #include "game/map/universe.hpp"
 #include "afl/string/format.hpp"
 #include "game/map/anyplanettype.hpp"
@@ -106,6 +107,17 @@ namespace {
         }
     }
 
+    /* Check whether a point is in a PHost gravity well. */
+    bool isInPHostGravityWell(game::map::Point pos, game::map::Point pt, int sqs, bool round, const game::map::Configuration& mapConfig)
+    {
+        if (round) {
+            return mapConfig.getSquaredDistance(pos, pt) <= sqs;
+        } else {
+            game::map::Point p2 = mapConfig.getSimpleNearestAlias(pos, pt);
+            return util::squareInteger(p2.getX() - pt.getX()) <= sqs && util::squareInteger(p2.getY() - pt.getY()) <= sqs;
+        }
+    }
+
     /* Mark all objects from an ObjectType if they are in a range of coordinates (inclusive). */
     int markTypeObjectsInRange(game::map::ObjectType& ty, game::map::Point a, game::map::Point b, const game::map::Configuration& config)
     {
@@ -140,7 +152,12 @@ game::map::Universe::Universe()
       m_allShips(m_ships),
       m_allPlanets(m_planets),
       m_reverter(0),
-      m_availablePlayers()
+      m_availablePlayers(),
+      m_planetIndex(),
+      m_shipIndex(),
+      m_spatialIndexValid(false),
+      m_numIndexedPlanets(0),
+      m_numIndexedShips(0)
 {
     // ex GUniverse::GUniverse
     m_drawings.sig_change.add(this, &Universe::markChanged);
@@ -211,6 +228,9 @@ game::map::Universe::notifyListeners()
     /* Tell everyone we're going to do updates */
     sig_preUpdate.raise();
 
+    /* Track moved objects. Must be done before notifying, which resets the dirty flags. */
+    updateSpatialIndexForChangedObjects();
+
     /* Update individual objects */
     // changed |= updateType(ty_history_ships);
     changed |= m_allShips.notifyObjectListeners();
@@ -276,6 +296,9 @@ game::map::Universe::postprocess(PlayerSet_t playingSet, PlayerSet_t availablePl
         }
     }
 
+    // Locations are final now
+    updateSpatialIndex();
+
     // Internal checks for others
     m_minefields.internalCheck(turnNumber, host, config);
     m_drawings.eraseExpiredDrawings(turnNumber);
@@ -308,6 +331,65 @@ game::map::Universe::postprocess(PlayerSet_t playingSet, PlayerSet_t availablePl
     // FIXME: synthesize scores if a score blanker is used
 }
 
+void
+game::map::Universe::updateSpatialIndex()
+{
+    // Bulk-load: collecting positions first and sorting once is O(n log n), whereas adding objects one-by-one is O(n^2)
+    std::vector<afl::base::Optional<Point> > positions;
+
+    positions.assign(m_planets.size() + 1, afl::base::Nothing);
+    for (Id_t i = 1, n = m_planets.size(); i <= n; ++i) {
+        if (Planet* p = m_planets.get(i)) {
+            positions[i] = p->getPosition();
+            p->setSpatialIndex(&m_planetIndex);
+        }
+    }
+    m_planetIndex.setPositions(positions);
+
+    positions.assign(m_ships.size() + 1, afl::base::Nothing);
+    for (Id_t i = 1, n = m_ships.size(); i <= n; ++i) {
+        if (Ship* s = m_ships.get(i)) {
+            positions[i] = s->getPosition();
+            s->setSpatialIndex(&m_shipIndex);
+        }
+    }
+    m_shipIndex.setPositions(positions);
+
+    m_numIndexedPlanets = m_planets.size();
+    m_numIndexedShips = m_ships.size();
+    m_spatialIndexValid = true;
+}
+
+bool
+game::map::Universe::isSpatialIndexUsable() const
+{
+    // Objects added after building the index make it unusable until rebuilt
+    return m_spatialIndexValid
+        && m_numIndexedPlanets == m_planets.size()
+        && m_numIndexedShips == m_ships.size();
+}
+
+void
+game::map::Universe::updateSpatialIndexForChangedObjects()
+{
+    if (m_spatialIndexValid) {
+        for (Id_t i = 1, n = m_planets.size(); i <= n; ++i) {
+            if (const Planet* p = m_planets.get(i)) {
+                if (p->isDirty()) {
+                    m_planetIndex.setPosition(i, p->getPosition());
+                }
+            }
+        }
+        for (Id_t i = 1, n = m_ships.size(); i <= n; ++i) {
+            if (const Ship* s = m_ships.get(i)) {
+                if (s->isDirty()) {
+                    m_shipIndex.setPosition(i, s->getPosition());
+                }
+            }
+        }
+    }
+}
+
 bool
 game::map::Universe::hasFullData(int playerNr) const
 {
@@ -330,7 +412,20 @@ game::Id_t
 game::map::Universe::findPlanetAt(Point pt) const
 {
     // ex GUniverse::getPlanetAt, global.pas:PlanetAt
-    return const_cast<AnyPlanetType&>(m_allPlanets).findNextObjectAt(pt, 0, false);
+    if (isSpatialIndexUsable()) {
+        std::vector<Id_t> candidates;
+        m_planetIndex.findAt(pt, candidates);
+        for (size_t i = 0, n = candidates.size(); i < n; ++i) {
+            Point pos;
+            const Planet* p = m_allPlanets.getObjectByIndex(candidates[i]);
+            if (p != 0 && p->getPosition().get(pos) && pos == pt) {
+                return candidates[i];
+            }
+        }
+        return 0;
+    } else {
+        return const_cast<AnyPlanetType&>(m_allPlanets).findNextObjectAt(pt, 0, false);
+    }
 }
 
 game::Id_t
@@ -367,20 +462,27 @@ game::map::Universe::findGravityPlanetAt(Point pt,
      case HostVersion::Unknown:
      case HostVersion::PHost: {
         /* PHost gravity wells */
-        int sqs = util::squareInteger(config[config.GravityWellRange]());
-        for (Id_t i = ty.getPreviousIndex(0); i != 0; i = ty.getPreviousIndex(i)) {
-            if (const Planet* p = ty.getObjectByIndex(i)) {
-                Point pos;
-                if (p->getPosition().get(pos)) {
-                    if (config[config.RoundGravityWells]()) {
-                        if (mapConfig.getSquaredDistance(pos, pt) <= sqs) {
-                            return i;
-                        }
-                    } else {
-                        Point p2 = mapConfig.getSimpleNearestAlias(pos, pt);
-                        if (util::squareInteger(p2.getX() - pt.getX()) <= sqs && util::squareInteger(p2.getY() - pt.getY()) <= sqs) {
-                            return i;
-                        }
+        const int range = std::abs(config[config.GravityWellRange]());
+        const int sqs = util::squareInteger(range);
+        const bool round = config[config.RoundGravityWells]();
+        if (isSpatialIndexUsable()) {
+            /* Candidates are sorted by Id; check highest Id first, like the regular loop */
+            std::vector<Id_t> candidates;
+            m_planetIndex.findInRange(pt, range, mapConfig, candidates);
+            for (size_t i = candidates.size(); i > 0; --i) {
+                if (const Planet* p = ty.getObjectByIndex(candidates[i-1])) {
+                    Point pos;
+                    if (p->getPosition().get(pos) && isInPHostGravityWell(pos, pt, sqs, round, mapConfig)) {
+                        return candidates[i-1];
+                    }
+                }
+            }
+        } else {
+            for (Id_t i = ty.getPreviousIndex(0); i != 0; i = ty.getPreviousIndex(i)) {
+                if (const Planet* p = ty.getObjectByIndex(i)) {
+                    Point pos;
+                    if (p->getPosition().get(pos) && isInPHostGravityWell(pos, pt, sqs, round, mapConfig)) {
+                        return i;
                     }
                 }
             }
@@ -393,13 +495,41 @@ game::map::Universe::findGravityPlanetAt(Point pt,
      case HostVersion::NuHost: {     // FIXME: does this go here?
         /* THost gravity wells: round, 3 ly, not wrapped, "cumulative" */
         Id_t pid = 0;
-        for (Id_t i = ty.getNextIndex(0); i != 0; i = ty.getNextIndex(i)) {
-            if (const Planet* p = ty.getObjectByIndex(i)) {
-                Point pos;
-                if (p->getPosition().get(pos)) {
-                    if (mapConfig.getSquaredDistance(pos, pt) <= 9) {
-                        pt = pos;  // (!)
-                        pid = i;
+        if (isSpatialIndexUsable()) {
+            /* Equivalent to the regular loop: find the next-higher Id in range of the (updated) point, until there is none */
+            std::vector<Id_t> candidates;
+            while (1) {
+                candidates.clear();
+                m_planetIndex.findInRange(pt, 3, mapConfig, candidates);
+
+                Id_t found = 0;
+                Point foundPos;
+                for (size_t i = 0, n = candidates.size(); i < n && found == 0; ++i) {
+                    if (candidates[i] > pid) {
+                        if (const Planet* p = ty.getObjectByIndex(candidates[i])) {
+                            Point pos;
+                            if (p->getPosition().get(pos) && mapConfig.getSquaredDistance(pos, pt) <= 9) {
+                                found = candidates[i];
+                                foundPos = pos;
+                            }
+                        }
+                    }
+                }
+                if (found == 0) {
+                    break;
+                }
+                pt = foundPos;  // (!)
+                pid = found;
+            }
+        } else {
+            for (Id_t i = ty.getNextIndex(0); i != 0; i = ty.getNextIndex(i)) {
+                if (const Planet* p = ty.getObjectByIndex(i)) {
+                    Point pos;
+                    if (p->getPosition().get(pos)) {
+                        if (mapConfig.getSquaredDistance(pos, pt) <= 9) {
+                            pt = pos;  // (!)
+                            pid = i;
+                        }
                     }
                 }
             }
@@ -415,7 +545,20 @@ game::map::Universe::findFirstShipAt(Point pt) const
 {
     // ex GUniverse::getAnyShipAt
     // ex shipacc.pas:ShipAt
-    return const_cast<AnyShipType&>(m_allShips).findNextObjectAt(pt, 0, false);
+    if (isSpatialIndexUsable()) {
+        std::vector<Id_t> candidates;
+        m_shipIndex.findAt(pt, candidates);
+        for (size_t i = 0, n = candidates.size(); i < n; ++i) {
+            Point pos;
+            const Ship* p = m_allShips.getObjectByIndex(candidates[i]);
+            if (p != 0 && p->getPosition().get(pos) && pos == pt) {
+                return candidates[i];
+            }
+        }
+        return 0;
+    } else {
+        return const_cast<AnyShipType&>(m_allShips).findNextObjectAt(pt, 0, false);
+    }
 }
 
 String_t
@@ -23,6 +23,7 @@
 #include "game/map/playedbasetype.hpp"
 #include "game/map/playedplanettype.hpp"
 #include "game/map/playedshiptype.hpp"
+#include "game/map/spatialindex.hpp"
 #include "game/map/ufotype.hpp"
 #include "game/reference.hpp"
 
@@ -189,6 +190,17 @@ namespace game { namespace map {
                          const game::spec::ShipList& shipList,
                          afl::string::Translator& tx, afl::sys::LogListener& log);
 
+        /** Rebuild spatial index.
+            The spatial index speeds up location accessors (findPlanetAt(), findGravityPlanetAt(), findFirstShipAt()).
+            It is built by postprocess() and afterwards maintained:
+            Ship::setPosition() and Planet::setPosition() update it immediately;
+            other changes are picked up for all objects that report a change (Object::markDirty())
+            when notifyListeners() is called.
+            If you change object positions in other ways, call this function.
+
+            Until the spatial index has been built, location accessors fall back to iterating all objects. */
+        void updateSpatialIndex();
+
         /** Check for full data.
             \param playerNr Player number to check
             \return true if we have a result file for this player loaded */
@@ -340,6 +352,16 @@ namespace game { namespace map {
 
         // Set of players that have reliable data
         PlayerSet_t m_availablePlayers;     // ex data_set
+
+        // Spatial index
+        SpatialIndex m_planetIndex;
+        SpatialIndex m_shipIndex;
+        bool m_spatialIndexValid;
+        Id_t m_numIndexedPlanets;
+        Id_t m_numIndexedShips;
+
+        bool isSpatialIndexUsable() const;
+        void updateSpatialIndexForChangedObjects();
     };
 
 } }
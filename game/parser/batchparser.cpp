@@ -0,0 +1,61 @@
+/**
+  *  \file game/parser/batchparser.cpp
+  *  \brief Class game::parser::BatchParser
+  */
+
+#include "game/parser/batchparser.hpp"
+#include "game/parser/messageparser.hpp"
+
+/*
+ *  Worker
+ *
+ *  Parses message number /index/. Shared by all threads.
+ */
+
+class game::parser::BatchParser::Worker : public util::WorkQueue::Worker {
+ public:
+    Worker(const BatchParser& parent, const std::vector<String_t>& messages, int turnNr, afl::container::PtrVector<Infos_t>& results)
+        : m_parent(parent), m_messages(messages), m_turnNumber(turnNr), m_results(results)
+        { }
+
+    virtual void process(size_t index)
+        {
+            m_parent.m_parser.parseMessage(m_messages[index], m_parent.m_interface, m_turnNumber,
+                                           *m_results[index], m_parent.m_translator, m_parent.m_log);
+        }
+
+ private:
+    const BatchParser& m_parent;
+    const std::vector<String_t>& m_messages;
+    int m_turnNumber;
+    afl::container::PtrVector<Infos_t>& m_results;
+};
+
+
+/*
+ *  BatchParser
+ */
+
+game::parser::BatchParser::BatchParser(const MessageParser& parser, const DataInterface& iface, afl::string::Translator& tx, afl::sys::LogListener& log, size_t numThreads)
+    : m_parser(parser),
+      m_interface(iface),
+      m_translator(tx),
+      m_log(log),
+      m_queue(numThreads, "game.parser.batch")
+{ }
+
+game::parser::BatchParser::~BatchParser()
+{ }
+
+void
+game::parser::BatchParser::parse(const std::vector<String_t>& messages, int turnNr, afl::container::PtrVector<Infos_t>& results)
+{
+    // Result slots are created up-front so threads never modify the outer container.
+    results.clear();
+    for (size_t i = 0, n = messages.size(); i < n; ++i) {
+        results.pushBackNew(new Infos_t());
+    }
+
+    Worker w(*this, messages, turnNr, results);
+    m_queue.run(messages.size(), w);
+}
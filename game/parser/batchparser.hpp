@@ -0,0 +1,66 @@
+/**
+  *  \file game/parser/batchparser.hpp
+  *  \brief Class game::parser::BatchParser
+  */
+#ifndef C2NG_GAME_PARSER_BATCHPARSER_HPP
+#define C2NG_GAME_PARSER_BATCHPARSER_HPP
+
+#include <vector>
+#include "afl/container/ptrvector.hpp"
+#include "afl/string/string.hpp"
+#include "afl/string/translator.hpp"
+#include "afl/sys/loglistener.hpp"
+#include "game/parser/messageinformation.hpp"
+#include "util/workqueue.hpp"
+
+namespace game { namespace parser {
+
+    class DataInterface;
+    class MessageParser;
+
+    /** Batch message parser.
+        Parses many messages at once, e.g. a complete inbox.
+
+        Messages are distributed to a number of threads.
+        Each message's information is collected separately;
+        the caller applies it afterwards, in message order.
+        Results are therefore identical to calling MessageParser::parseMessage() for each message in turn.
+
+        The MessageParser, DataInterface, Translator and LogListener are accessed by all threads
+        and must not be modified while parse() runs. */
+    class BatchParser {
+     public:
+        /** Information parsed from one message. */
+        typedef afl::container::PtrVector<MessageInformation> Infos_t;
+
+        /** Constructor.
+            \param parser      Message parser (loaded)
+            \param iface       Data interface (for names)
+            \param tx          Translator
+            \param log         Logger
+            \param numThreads  Number of threads to use (0 or 1 to parse all messages in the calling thread) */
+        BatchParser(const MessageParser& parser, const DataInterface& iface, afl::string::Translator& tx, afl::sys::LogListener& log, size_t numThreads);
+
+        /** Destructor. */
+        ~BatchParser();
+
+        /** Parse messages.
+            \param [in]  messages  Message texts
+            \param [in]  turnNr    Turn number
+            \param [out] results   Results, one element per message, in the same order */
+        void parse(const std::vector<String_t>& messages, int turnNr, afl::container::PtrVector<Infos_t>& results);
+
+     private:
+        class Worker;
+        friend class Worker;
+
+        const MessageParser& m_parser;
+        const DataInterface& m_interface;
+        afl::string::Translator& m_translator;
+        afl::sys::LogListener& m_log;
+        util::WorkQueue m_queue;
+    };
+
+} }
+
+#endif
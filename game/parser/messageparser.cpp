@@ -16,6 +16,7 @@
 #include "util/string.hpp"
 
 using afl::string::strTrim;
+using afl::string::strUCase;
 using game::alliance::Offer;
 
 namespace {
@@ -387,7 +388,10 @@ namespace {
 
 // Default constructor.
 game::parser::MessageParser::MessageParser()
-    : m_templates()
+    : m_templates(),
+      m_requiredTexts(),
+      m_templatesByKind(),
+      m_templatesForAnyKind()
 {
     // ex GMessageParser::GMessageParser
 }
@@ -514,27 +518,94 @@ game::parser::MessageParser::load(afl::io::Stream& file, afl::string::Translator
         }
     }
     checkTemplate(currentTemplate, tf, currentTemplateLine, tx, log);
+    buildIndex();
 }
 
 // Parse a message, main entry point.
 void
 game::parser::MessageParser::parseMessage(String_t theMessage, const DataInterface& iface, int turnNr, afl::container::PtrVector<MessageInformation>& info,
-                                          afl::string::Translator& tx, afl::sys::LogListener& log)
+                                          afl::string::Translator& tx, afl::sys::LogListener& log) const
 {
     // ex GMessageParser::parseMessage
     // Split message into lines
     MessageLines_t lines;
     splitMessage(lines, theMessage);
 
-    // Parse all templates and gather information
-    for (afl::container::PtrVector<MessageTemplate>::iterator i = m_templates.begin(); i != m_templates.end(); ++i) {
+    // Upper-case version of message, to check required texts; created when needed
+    String_t upperMessage;
+    bool haveUpperMessage = false;
+
+    // Parse all candidate templates and gather information
+    const Indexes_t& candidates = getTemplatesForKind(getMessageHeaderInformation(lines, MsgHdrKind));
+    for (Indexes_t::const_iterator i = candidates.begin(); i != candidates.end(); ++i) {
+        // Quick rejection
+        const String_t& requiredText = m_requiredTexts[*i];
+        if (!requiredText.empty()) {
+            if (!haveUpperMessage) {
+                // Join lines with a line break, so that no required text (which is a single line) can span two lines
+                for (size_t line = 0; line < lines.size(); ++line) {
+                    upperMessage += strUCase(lines[line]);
+                    upperMessage += '\n';
+                }
+                haveUpperMessage = true;
+            }
+            if (upperMessage.find(requiredText) == String_t::npos) {
+                continue;
+            }
+        }
+
+        // Full match
+        const MessageTemplate& tpl = *m_templates[*i];
         std::vector<String_t> values;
-        if ((*i)->match(lines, iface, values)) {
+        if (tpl.match(lines, iface, values)) {
             // Matches. Produce output.
-            generateOutput(values, **i, iface, turnNr - getMessageHeaderInformation(lines, MsgHdrAge), info, tx, log);
-            if (!(*i)->getContinueFlag()) {
+            generateOutput(values, tpl, iface, turnNr - getMessageHeaderInformation(lines, MsgHdrAge), info, tx, log);
+            if (!tpl.getContinueFlag()) {
                 break;
             }
         }
     }
 }
+
+/* Build index (m_requiredTexts, m_templatesByKind, m_templatesForAnyKind) from m_templates. */
+void
+game::parser::MessageParser::buildIndex()
+{
+    m_requiredTexts.clear();
+    m_templatesByKind.clear();
+    m_templatesForAnyKind.clear();
+
+    // Templates that accept any kind
+    for (size_t i = 0, n = m_templates.size(); i < n; ++i) {
+        m_requiredTexts.push_back(m_templates[i]->getRequiredText());
+        if (m_templates[i]->getRequiredKind() == 0) {
+            m_templatesForAnyKind.push_back(i);
+        }
+    }
+
+    // Templates for specific kinds; these also receive all templates that accept any kind, in file order
+    for (size_t i = 0, n = m_templates.size(); i < n; ++i) {
+        int kind = m_templates[i]->getRequiredKind();
+        if (kind != 0 && m_templatesByKind.find(kind) == m_templatesByKind.end()) {
+            Indexes_t& list = m_templatesByKind[kind];
+            for (size_t j = 0; j < n; ++j) {
+                int thisKind = m_templates[j]->getRequiredKind();
+                if (thisKind == 0 || thisKind == kind) {
+                    list.push_back(j);
+                }
+            }
+        }
+    }
+}
+
+/* Get list of templates to try for a message of the given kind. */
+const game::parser::MessageParser::Indexes_t&
+game::parser::MessageParser::getTemplatesForKind(int kind) const
+{
+    std::map<int, Indexes_t>::const_iterator it = m_templatesByKind.find(kind);
+    if (it != m_templatesByKind.end()) {
+        return it->second;
+    } else {
+        return m_templatesForAnyKind;
+    }
+}
@@ -5,6 +5,8 @@
 #ifndef C2NG_GAME_PARSER_MESSAGEPARSER_HPP
 #define C2NG_GAME_PARSER_MESSAGEPARSER_HPP
 
+#include <map>
+#include <vector>
 #include "afl/container/ptrvector.hpp"
 #include "afl/io/stream.hpp"
 #include "afl/string/string.hpp"
@@ -20,7 +22,12 @@ namespace game { namespace parser {
     /** Message parser.
         Used for extracting data from in-game messages.
         A MessageParser instance stores a set of templates that it applies to each messages given to it.
-        The templates are loaded from a file (msgparse.ini). */
+        The templates are loaded from a file (msgparse.ini).
+
+        To avoid trying every template on every message, templates are indexed by their required message kind
+        (MessageTemplate::getRequiredKind()); a message is only tried against templates that accept its kind.
+        In addition, a template is skipped if the message does not contain its required text (MessageTemplate::getRequiredText()).
+        Templates are still tried in file order, and honor their continue flag. */
     class MessageParser {
      public:
         /** Default constructor.
@@ -43,8 +50,10 @@ namespace game { namespace parser {
             \param [in]  turnNr      Turn number
             \param [out] info        Information will be appended here
             \param [in]  tx          Translator
-            \param [in]  log         Logger */
-        void parseMessage(String_t theMessage, const DataInterface& iface, int turnNr, afl::container::PtrVector<MessageInformation>& info, afl::string::Translator& tx, afl::sys::LogListener& log);
+            \param [in]  log         Logger
+
+            This function does not modify the MessageParser and can be called from multiple threads at once. */
+        void parseMessage(String_t theMessage, const DataInterface& iface, int turnNr, afl::container::PtrVector<MessageInformation>& info, afl::string::Translator& tx, afl::sys::LogListener& log) const;
 
         /** Get number of templates.
             Mainly for testing purposes.
@@ -52,7 +61,21 @@ namespace game { namespace parser {
         size_t getNumTemplates() const;
 
      private:
+        typedef std::vector<size_t> Indexes_t;
+
         afl::container::PtrVector<MessageTemplate> m_templates;
+
+        /** Required text for each template; parallel to m_templates. */
+        std::vector<String_t> m_requiredTexts;
+
+        /** Templates to try for each message kind, in order. */
+        std::map<int, Indexes_t> m_templatesByKind;
+
+        /** Templates to try for messages of a kind not in m_templatesByKind. */
+        Indexes_t m_templatesForAnyKind;
+
+        void buildIndex();
+        const Indexes_t& getTemplatesForKind(int kind) const;
     };
 
 } }
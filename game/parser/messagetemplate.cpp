@@ -291,6 +291,35 @@ game::parser::MessageTemplate::getTemplateName() const
     return m_name;
 }
 
+// Get required message kind.
+int
+game::parser::MessageTemplate::getRequiredKind() const
+{
+    for (std::vector<Instruction>::const_iterator it = m_instructions.begin(); it != m_instructions.end(); ++it) {
+        if (it->opcode == iMatchKind) {
+            return it->index;
+        }
+    }
+    return 0;
+}
+
+// Get required text.
+String_t
+game::parser::MessageTemplate::getRequiredText() const
+{
+    // Use the longest candidate; it is the most selective one.
+    String_t result;
+    for (std::vector<Instruction>::const_iterator it = m_instructions.begin(); it != m_instructions.end(); ++it) {
+        if ((it->opcode & iMask) == iCheck) {
+            const String_t& s = m_strings[it->index];
+            if (s.find('%') == String_t::npos && s.size() > result.size()) {
+                result = s;
+            }
+        }
+    }
+    return strUCase(result);
+}
+
 // Match message against this template.
 bool
 game::parser::MessageTemplate::match(const MessageLines_t& message, const DataInterface& iface, std::vector<String_t>& values) const
@@ -137,6 +137,19 @@ namespace game { namespace parser {
             \return message information type */
         MessageInformation::Type getMessageType() const;
 
+        /** Get required message kind.
+            If this returns nonzero, match() will fail for all messages whose MsgHdrKind differs.
+            \return message kind (character code); 0 if this template accepts any kind */
+        int getRequiredKind() const;
+
+        /** Get required text.
+            If this returns a nonempty string, match() will fail for all messages
+            that do not contain this text in one of their lines, after conversion to upper case.
+            This considers only "Check" instructions that do not contain race name placeholders;
+            it assumes that DataInterface::expandRaceNames() does not modify text without placeholders.
+            \return required text (upper case); empty if none */
+        String_t getRequiredText() const;
+
         /** Match message against this template.
             \param message [in] Message
             \param iface [in] Data interface to produce context information
@@ -240,6 +240,7 @@ game::pcc::TurnLoader::doLoadCurrentTurn(Game& game, int player, game::Root& roo
 
     // Load util from remote
     Parser mp(tx, m_log, game, player, root, game::actions::mustHaveShipList(session), session.world().atomTable());
+    mp.setNumThreads(session.getSystemInformation().numProcessors);
     {
         Ptr<Stream> file = root.gameDirectory().openFileNT(Format("util%d.dat", player), afl::io::FileSystem::OpenRead);
         if (file.get() != 0) {
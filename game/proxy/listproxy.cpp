@@ -6,7 +6,7 @@
 #include "game/proxy/listproxy.hpp"
 #include "afl/data/integervalue.hpp"
 #include "game/game.hpp"
-#include "game/map/movementpredictor.hpp"
+#include "game/map/movementpredictorextra.hpp"
 #include "game/turn.hpp"
 
 using afl::data::IntegerValue;
@@ -21,7 +21,6 @@ using game::map::Universe;
 using game::ref::List;
 using game::spec::Cost;
 using game::spec::CostSummary;
-using game::spec::ShipList;
 
 namespace {
     bool hasRemoteControl(const game::Root& r)
@@ -51,20 +50,15 @@ namespace {
 
     void buildNextCargoSummary(game::Session& session, const List& in, CostSummary& out)
     {
-        game::Root* root = session.getRoot().get();
-        ShipList* list = session.getShipList().get();
         game::Game* g = session.getGame().get();
-        if (root != 0 && list != 0 && g != 0) {
-            // Compute movement
-            const Universe& univ = g->viewpointTurn().universe();
-            game::map::MovementPredictor pred;
-            pred.computeMovement(univ, *g, *list, *root);
-
+        const game::map::MovementPredictor* pred = game::map::MovementPredictorExtra::create(session).getPrediction();
+        if (g != 0 && pred != 0) {
             // Build list
+            const Universe& univ = g->viewpointTurn().universe();
             for (size_t i = 0, n = in.size(); i < n; ++i) {
                 if (const Ship* ship = dynamic_cast<const Ship*>(univ.getObject(in[i]))) {
                     Cost cargo;
-                    if (pred.getShipCargo(ship->getId(), cargo)) {
+                    if (pred->getShipCargo(ship->getId(), cargo)) {
                         out.add(CostSummary::Item(ship->getId(), 1, ship->getName(game::LongName, session.translator(), session.interface()), cargo));
                     }
                 }
@@ -159,20 +153,16 @@ game::proxy::ListProxy::buildNext(util::WaitIndicator& ind, game::map::Point pos
         virtual void handle(game::Session& session)
             {
                 // ex doListNextShips (part)
-                Root* root = session.getRoot().get();
-                ShipList* list = session.getShipList().get();
                 Game* g = session.getGame().get();
-                if (root != 0 && list != 0 && g != 0) {
-                    // Compute movement
+                const game::map::MovementPredictor* pred = game::map::MovementPredictorExtra::create(session).getPrediction();
+                if (g != 0 && pred != 0) {
                     const Universe& univ = g->viewpointTurn().universe();
-                    game::map::MovementPredictor pred;
-                    pred.computeMovement(univ, *g, *list, *root);
 
                     // If looking at a ship, resolve its position
                     bool posOK;
                     Point pos;
                     if (m_fromShip != 0) {
-                        posOK = pred.getShipPosition(m_fromShip).get(pos);
+                        posOK = pred->getShipPosition(m_fromShip).get(pos);
                     } else {
                         posOK = true;
                         pos = m_pos;
@@ -188,7 +178,7 @@ game::proxy::ListProxy::buildNext(util::WaitIndicator& ind, game::map::Point pos
                             Point shPos;
 
                             if (sh != 0
-                                && pred.getShipPosition(id).get(shPos)
+                                && pred->getShipPosition(id).get(shPos)
                                 && g->mapConfiguration().getCanonicalLocation(shPos) == pos
                                 && (m_options.contains(List::IncludeForeignShips) || sh->isPlayable(Object::ReadOnly))
                                 && (!m_options.contains(List::SafeShipsOnly) || sh->isReliablyVisible(0)))
@@ -4,6 +4,7 @@
   */
 
 #include "game/proxy/vcroverviewproxy.hpp"
+#include "util/systeminformation.hpp"
 
 using game::vcr::Overview;
 
@@ -16,7 +17,8 @@ class game::proxy::VcrOverviewProxy::Trampoline {
     Trampoline(VcrDatabaseAdaptor& adaptor)
         : m_overview(*adaptor.getBattles(),
                      adaptor.getRoot()->hostConfiguration(),
-                     *adaptor.getShipList()),
+                     *adaptor.getShipList(),
+                     util::getSystemInformation().numProcessors),
           m_adaptor(adaptor)
         { }
 
@@ -7,6 +7,7 @@
 #include "game/config/integeroption.hpp"
 #include "game/config/userconfiguration.hpp"
 #include "game/game.hpp"
+#include "game/map/movementpredictorextra.hpp"
 #include "game/ref/nullpredicate.hpp"
 #include "game/ref/sortby.hpp"
 #include "game/root.hpp"
@@ -106,8 +107,10 @@ game::ref::createSortPredicate(int config, Session& session, afl::base::Deleter&
         return del.addNew(new SortBy::Name(session));
 
      case ConfigSortByNextPosition:
-        if (pTurn != 0 && pShipList != 0 && pRoot != 0 && pGame != 0) {
-            return del.addNew(new SortBy::NextPosition(pTurn->universe(), *pGame, *pShipList, *pRoot, session.translator()));
+        if (pTurn != 0) {
+            if (const game::map::MovementPredictor* pPredictor = game::map::MovementPredictorExtra::create(session).getPrediction()) {
+                return del.addNew(new SortBy::NextPosition(pTurn->universe(), *pPredictor, session.translator()));
+            }
         }
         break;
 
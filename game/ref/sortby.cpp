@@ -263,11 +263,21 @@ game::ref::SortBy::NextPosition::NextPosition(const game::map::Universe& univ,
                                               afl::string::Translator& tx)
     : m_universe(univ),
       m_translator(tx),
-      m_predictor()
+      m_ownPredictor(),
+      m_predictor(m_ownPredictor)
 {
-    m_predictor.computeMovement(univ, game, shipList, root);
+    m_ownPredictor.computeMovement(univ, game, shipList, root);
 }
 
+game::ref::SortBy::NextPosition::NextPosition(const game::map::Universe& univ,
+                                              const game::map::MovementPredictor& predictor,
+                                              afl::string::Translator& tx)
+    : m_universe(univ),
+      m_translator(tx),
+      m_ownPredictor(),
+      m_predictor(predictor)
+{ }
+
 int
 game::ref::SortBy::NextPosition::compare(const Reference& a, const Reference& b) const
 {
@@ -87,10 +87,11 @@ namespace game { namespace ref {
         };
 
         /** Sort by next-turn position.
-            Computes one turn prediction using game::map::MovementPredictor. */
+            Uses a one turn prediction from game::map::MovementPredictor. */
         class NextPosition : public SortPredicate {
          public:
             /** Constructor.
+                Computes a new prediction.
                 @param univ     Universe (access objects)
                 @param game     Game (ship score definitions)
                 @param shipList Ship list (hull functions etc.)
@@ -102,6 +103,15 @@ namespace game { namespace ref {
                          const Root& root,
                          afl::string::Translator& tx);
 
+            /** Constructor.
+                Uses an existing prediction.
+                @param univ      Universe (access objects)
+                @param predictor Prediction for this universe; must out-live the NextPosition
+                @param tx        Translator (for not-on-map objects) */
+            NextPosition(const game::map::Universe& univ,
+                         const game::map::MovementPredictor& predictor,
+                         afl::string::Translator& tx);
+
             // SortPredicate:
             virtual int compare(const Reference& a, const Reference& b) const;
             virtual String_t getClass(const Reference& a) const;
@@ -109,7 +119,8 @@ namespace game { namespace ref {
          private:
             const game::map::Universe& m_universe;
             afl::string::Translator& m_translator;
-            game::map::MovementPredictor m_predictor;
+            game::map::MovementPredictor m_ownPredictor;
+            const game::map::MovementPredictor& m_predictor;
 
             afl::base::Optional<game::map::Point> getPosition(const Reference& a) const;
         };
@@ -0,0 +1,297 @@
+/**
+  *  \file game/sim/batchrunner.cpp
+  *  \brief Class game::sim::BatchRunner
+  */
+
+#include <deque>
+#include <stdexcept>
+#include "game/sim/batchrunner.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/sys/mutexguard.hpp"
+
+const size_t game::sim::BatchRunner::DEFAULT_BATCH_SIZE;
+
+/*
+ *  Worker
+ *
+ *  A worker owns a queue of jobs.
+ *  The worker itself takes jobs from the front; other workers steal from the back.
+ */
+
+class game::sim::BatchRunner::Worker : public afl::base::Stoppable {
+ public:
+    Worker(BatchRunner& parent, size_t index)
+        : m_parent(parent), m_index(index), m_mutex(), m_queue()
+        { }
+    ~Worker()
+        {
+            // Queue is normally empty here. If it is not, we were aborted by an exception.
+            while (!m_queue.empty()) {
+                delete m_queue.back();
+                m_queue.pop_back();
+            }
+        }
+
+    // Stoppable:
+    void run();
+    void stop()
+        {
+            // Workers are stopped collectively by BatchRunner::~BatchRunner.
+        }
+
+    void pushJobs(const std::vector<Job*>& jobs)
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            m_queue.insert(m_queue.end(), jobs.begin(), jobs.end());
+        }
+
+    Job* popFront()
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            Job* p = 0;
+            if (!m_queue.empty()) {
+                p = m_queue.front();
+                m_queue.pop_front();
+            }
+            return p;
+        }
+
+    Job* popBack()
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            Job* p = 0;
+            if (!m_queue.empty()) {
+                p = m_queue.back();
+                m_queue.pop_back();
+            }
+            return p;
+        }
+
+    size_t getIndex() const
+        { return m_index; }
+
+ private:
+    BatchRunner& m_parent;
+    const size_t m_index;
+    afl::sys::Mutex m_mutex;
+    std::deque<Job*> m_queue;
+};
+
+void
+game::sim::BatchRunner::Worker::run()
+{
+    while (1) {
+        // Wait for control thread to give start signal
+        m_parent.m_startSignal.wait();
+
+        // Termination check?
+        if (m_parent.m_terminateSignal.get()) {
+            break;
+        }
+
+        // Process requests.
+        // An exception must not leave the control thread waiting for us; report it instead.
+        try {
+            m_parent.processJobs(*this);
+        }
+        catch (std::exception& e) {
+            m_parent.setError(e.what());
+        }
+        catch (...) {
+            m_parent.setError("Unknown error");
+        }
+
+        // Signal control thread that we stop
+        m_parent.m_stopSignal.post();
+    }
+}
+
+
+/*
+ *  BatchRunner
+ */
+
+game::sim::BatchRunner::BatchRunner(const Setup& setup,
+                                    const Configuration& opts,
+                                    const game::spec::ShipList& list,
+                                    const game::config::HostConfiguration& config,
+                                    const game::vcr::flak::Configuration& flakConfig,
+                                    afl::sys::LogListener& log,
+                                    util::RandomNumberGenerator& rng,
+                                    size_t numThreads,
+                                    size_t batchSize)
+    : Runner(setup, opts, list, config, flakConfig, log, rng),
+      m_mutex(),
+      m_batchSize(batchSize > 0 ? batchSize : 1),
+      m_limit(),
+      m_pStopper(),
+      m_hasError(false),
+      m_error(),
+      m_workers(),
+      m_threads(),
+      m_startSignal(0),
+      m_stopSignal(0),
+      m_terminateSignal()
+{
+    // Create all workers first; they must not change anymore once threads are running
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_workers.pushBackNew(new Worker(*this, i));
+    }
+    for (size_t i = 0; i < numThreads; ++i) {
+        m_threads.pushBackNew(new afl::sys::Thread("game.sim.batch", *m_workers[i]))->start();
+    }
+}
+
+game::sim::BatchRunner::~BatchRunner()
+{
+    m_terminateSignal.set();
+    startAll();
+    for (size_t i = 0, n = m_threads.size(); i < n; ++i) {
+        m_threads[i]->join();
+    }
+}
+
+void
+game::sim::BatchRunner::run(Limit_t limit, util::StopSignal& stopper)
+{
+    // Save parameters where threads can find them
+    m_limit = limit;
+    m_pStopper = &stopper;
+
+    // Start all threads
+    startAll();
+
+    // Wait for all threads to come to rest
+    for (size_t i = 0, n = m_threads.size(); i < n; ++i) {
+        m_stopSignal.wait();
+    }
+
+    // Clear
+    m_limit = Limit_t();
+    m_pStopper = 0;
+
+    // Report error from a worker thread
+    if (m_hasError) {
+        String_t error = m_error;
+        m_hasError = false;
+        m_error.clear();
+        throw std::runtime_error(error);
+    }
+}
+
+void
+game::sim::BatchRunner::startAll()
+{
+    for (size_t i = 0, n = m_threads.size(); i < n; ++i) {
+        m_startSignal.post();
+    }
+}
+
+void
+game::sim::BatchRunner::setError(const String_t& error)
+{
+    // Keep the first error
+    afl::sys::MutexGuard g(m_mutex);
+    if (!m_hasError) {
+        m_hasError = true;
+        m_error = error;
+    }
+}
+
+void
+game::sim::BatchRunner::processJobs(Worker& w)
+{
+    // Jobs are run and collected outside any lock; results are merged in bulk.
+    ResultList partial;
+    std::vector<Job*> done;
+    try {
+        while (Job* p = nextJob(w)) {
+            done.push_back(p);
+            runJob(p);
+            collectJob(*p, partial);
+            if (done.size() >= m_batchSize) {
+                finishBatch(partial, done);
+            }
+        }
+        finishBatch(partial, done);
+    }
+    catch (...) {
+        // runJob() does not throw; this covers out-of-memory in our own bookkeeping.
+        for (size_t i = 0, n = done.size(); i < n; ++i) {
+            delete done[i];
+        }
+        throw;
+    }
+}
+
+game::sim::Runner::Job*
+game::sim::BatchRunner::nextJob(Worker& w)
+{
+    // Own queue
+    if (Job* p = w.popFront()) {
+        return p;
+    }
+
+    // New batch
+    if (fetchBatch(w)) {
+        if (Job* p = w.popFront()) {
+            return p;
+        }
+    }
+
+    // Steal
+    return stealJob(w);
+}
+
+bool
+game::sim::BatchRunner::fetchBatch(Worker& w)
+{
+    // Create batch under central lock.
+    // Do not hold the central lock and the worker lock at the same time.
+    std::vector<Job*> batch;
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        while (batch.size() < m_batchSize) {
+            Job* p = makeJob(m_limit, *m_pStopper);
+            if (p == 0) {
+                break;
+            }
+            batch.push_back(p);
+        }
+    }
+
+    if (batch.empty()) {
+        return false;
+    } else {
+        w.pushJobs(batch);
+        return true;
+    }
+}
+
+game::sim::Runner::Job*
+game::sim::BatchRunner::stealJob(const Worker& w)
+{
+    // Start with the worker following the thief, to spread steal attempts
+    for (size_t i = 1, n = m_workers.size(); i < n; ++i) {
+        if (Job* p = m_workers[(w.getIndex() + i) % n]->popBack()) {
+            return p;
+        }
+    }
+    return 0;
+}
+
+void
+game::sim::BatchRunner::finishBatch(ResultList& partial, std::vector<Job*>& jobs)
+{
+    if (!jobs.empty()) {
+        afl::sys::MutexGuard g(m_mutex);
+        mergeResults(partial);
+        for (size_t i = 0, n = jobs.size(); i < n; ++i) {
+            // recycleJob() takes ownership
+            Job* p = jobs[i];
+            jobs[i] = 0;
+            recycleJob(p);
+        }
+        jobs.clear();
+    }
+}
@@ -0,0 +1,123 @@
+/**
+  *  \file game/sim/batchrunner.hpp
+  *  \brief Class game::sim::BatchRunner
+  */
+#ifndef C2NG_GAME_SIM_BATCHRUNNER_HPP
+#define C2NG_GAME_SIM_BATCHRUNNER_HPP
+
+#include <vector>
+#include "afl/container/ptrvector.hpp"
+#include "afl/string/string.hpp"
+#include "afl/sys/mutex.hpp"
+#include "afl/sys/semaphore.hpp"
+#include "afl/sys/thread.hpp"
+#include "game/sim/runner.hpp"
+
+namespace game { namespace sim {
+
+    /** Multi-threaded, batching simulation runner.
+        Like ParallelRunner, contains a configurable number of threads that live as long as the BatchRunner lives.
+
+        Unlike ParallelRunner, a worker does not take the central lock for every single simulation.
+        Instead, each worker fetches a batch of jobs at once into a private queue,
+        collects its results in a private ResultList, and merges that into the main ResultList in bulk.
+        When no more jobs can be created, a worker that runs out of work steals jobs from other workers' queues,
+        so that no thread sits idle while another one still has a queue of unstarted jobs.
+
+        This reduces lock contention for short fights with many threads.
+        Results are the same as those of ParallelRunner/SimpleRunner
+        (each job is still identified by its serial number which determines its random number seed);
+        only the order in which they are added to the ResultList differs.
+
+        The same restrictions as for ParallelRunner apply:
+        worker threads work on the original versions of the setup, configuration, ship list, host configuration;
+        the sig_update callback may come from any thread and may not modify those. */
+    class BatchRunner : public Runner {
+     public:
+        /** Default batch size. */
+        static const size_t DEFAULT_BATCH_SIZE = 16;
+
+        /** Constructor.
+            \param [in]     setup   Simulation setup (see Runner)
+            \param [in]     opts    Simulation options (see Runner)
+            \param [in]     list    Ship list (see Runner)
+            \param [in]     config  Host configuration (see Runner)
+            \param [in]     flakConfig FLAK configuration (see Runner)
+            \param [in,out] log     Logger (for errors, see Runner)
+            \param [in,out] rng     Random number generator (see Runner)
+            \param [in]     numThreads Number of threads to start
+            \param [in]     batchSize  Number of jobs to fetch at once (0 means 1) */
+        BatchRunner(const Setup& setup,
+                    const Configuration& opts,
+                    const game::spec::ShipList& list,
+                    const game::config::HostConfiguration& config,
+                    const game::vcr::flak::Configuration& flakConfig,
+                    afl::sys::LogListener& log,
+                    util::RandomNumberGenerator& rng,
+                    size_t numThreads,
+                    size_t batchSize = DEFAULT_BATCH_SIZE);
+
+        /** Destructor.
+            Stops all the threads. */
+        ~BatchRunner();
+
+        // Runner:
+        /** Run simulations.
+            See Runner::run().
+            If a worker thread fails with an exception, the remaining threads finish their work,
+            and this function then throws a std::runtime_error with the first worker's error message. */
+        void run(Limit_t limit, util::StopSignal& stopper);
+
+     private:
+        class Worker;
+        friend class Worker;
+
+        void startAll();
+        void setError(const String_t& error);
+        void processJobs(Worker& w);
+        Job* nextJob(Worker& w);
+        bool fetchBatch(Worker& w);
+        Job* stealJob(const Worker& w);
+        void finishBatch(ResultList& partial, std::vector<Job*>& jobs);
+
+        /** Mutex protecting makeJob(), finishJob(). */
+        afl::sys::Mutex m_mutex;
+
+        /** Batch size. */
+        const size_t m_batchSize;
+
+        /** "limit" parameter from run() for threads to see. */
+        Limit_t m_limit;
+
+        /** "stopper" parameter from run() for threads to see. */
+        util::StopSignal* m_pStopper;
+
+        /** Error flag. Set by threads (under m_mutex) if processJobs() fails. */
+        bool m_hasError;
+
+        /** Error message. Valid if m_hasError is set. */
+        String_t m_error;
+
+        /** Workers.
+            Each one has its own thread and job queue. */
+        afl::container::PtrVector<Worker> m_workers;
+
+        /** List of threads; parallel to m_workers. */
+        afl::container::PtrVector<afl::sys::Thread> m_threads;
+
+        /** Start signal for threads.
+            Set by control code (public run()) to tell threads to consider m_terminateSignal and makeJob(). */
+        afl::sys::Semaphore m_startSignal;
+
+        /** Stop signal.
+            Set by threads to signal completion (no more jobs available, own queue empty). */
+        afl::sys::Semaphore m_stopSignal;
+
+        /** Termination signal.
+            If a thread sees this, it terminates (call join() next). */
+        util::StopSignal m_terminateSignal;
+    };
+
+} }
+
+#endif
@@ -3,6 +3,7 @@
   *  \brief Class game::sim::ConsoleApplication
   */
 
+#include <algorithm>
 #include <cstring>
 #include "game/sim/consoleapplication.hpp"
 #include "afl/base/optional.hpp"
@@ -14,6 +15,7 @@
 #include "afl/sys/standardcommandlineparser.hpp"
 #include "afl/sys/time.hpp"
 #include "game/limits.hpp"
+#include "game/sim/batchrunner.hpp"
 #include "game/sim/configuration.hpp"
 #include "game/sim/loader.hpp"
 #include "game/sim/object.hpp"
@@ -115,6 +117,36 @@ namespace {
         }
     }
 
+    /* Add two opposing fleets of carriers (--add-fleet).
+       Produces large fighter battles for benchmarking, in particular for FLAK (--mode=flak).
+       Uses custom ships with standard weapons so the result does not depend on the ship list's hulls. */
+    void addFleets(game::sim::Setup& setup, size_t numShips, afl::string::Translator& tx)
+    {
+        game::Id_t id = 0;
+        for (int owner = 1; owner <= 2; ++owner) {
+            for (size_t i = 0; i < numShips; ++i) {
+                id = setup.findUnusedShipId(id+1, 0);
+                game::sim::Ship* sh = setup.addShip();
+                sh->setId(id);
+                sh->setDefaultName(tx);
+                sh->setFriendlyCode("???");
+                sh->setDamage(0);
+                sh->setShield(100);
+                sh->setOwner(owner);
+                sh->setHullTypeOnly(0);
+                sh->setCrew(1000);
+                sh->setMass(800);
+                sh->setBeamType(6);
+                sh->setNumBeams(8);
+                sh->setNumLaunchers(0);
+                sh->setNumBays(10);
+                sh->setAmmo(150);
+                sh->setEngineType(9);
+                sh->setAggressiveness(game::sim::Ship::agg_Kill);
+            }
+        }
+    }
+
     void writeScalar(afl::io::TextWriter& out, String_t name, int value)
     {
         out.writeLine(Format("  %s: %d", name, value));
@@ -141,6 +173,9 @@ struct game::sim::ConsoleApplication::Parameters {
     Optional<String_t> gameDirectoryName;                  // -G
     Optional<String_t> rootDirectoryName;                  // -R
     size_t numThreads;                                     // -j
+    Optional<size_t> batchSize;                            // --batch
+    Optional<size_t> benchmarkCount;                       // --benchmark
+    Optional<size_t> fleetSize;                            // --add-fleet
     Optional<String_t> charsetName;                        // -C
     Optional<size_t> runSimCount;                          // --run
     bool runSimSeries;                                     // --run-series
@@ -158,7 +193,7 @@ struct game::sim::ConsoleApplication::Parameters {
 
     Parameters()
         : hadAction(false), saveFileName(), enableReport(false), enableVerify(false), gameDirectoryName(), rootDirectoryName(),
-          numThreads(0), charsetName(), runSimCount(), runSimSeries(false),
+          numThreads(0), batchSize(), benchmarkCount(), fleetSize(), charsetName(), runSimCount(), runSimSeries(false),
           vcrMode(), engineShieldBonus(), scottyBonus(), randomLeftRight(),
           honorAlliances(), onlyOneSimulation(), seedControl(), randomizeFCodesOnEveryFight(),
           balancingMode(), loadFileNames()
@@ -198,7 +233,7 @@ game::sim::ConsoleApplication::appMain()
     parseCommandLine(p);
 
     // Detect unintended use
-    if (p.loadFileNames.empty()) {
+    if (p.loadFileNames.empty() && !p.fleetSize.isValid()) {
         errorExit(tx("no input files specified"));
     }
     if (!p.hadAction) {
@@ -219,29 +254,50 @@ game::sim::ConsoleApplication::appMain()
     // Load
     Setup setup;
     loadSetup(setup, *cs, p.loadFileNames);
+    if (const size_t* fleetSize = p.fleetSize.get()) {
+        addFleets(setup, *fleetSize, tx);
+    }
 
     // Save
     if (const String_t* saveFileName = p.saveFileName.get()) {
         saveSetup(setup, *cs, *saveFileName);
     }
 
-    // Verify
+    // Load root/ship list once for all actions that need it
     Session session;
-    if (p.enableVerify) {
+    const bool runSim = p.runSimSeries || p.runSimCount.isValid();
+    const bool runBench = p.benchmarkCount.isValid();
+    if (p.enableVerify || p.enableReport || runSim || runBench) {
         loadSession(session, p, *cs);
+    }
+
+    // Verify
+    if (p.enableVerify) {
         verifySetup(setup, session);
     }
 
     // Report
     if (p.enableReport) {
-        loadSession(session, p, *cs);
         showSetup(setup, session);
     }
 
+    // Prepare setup once for simulation and benchmark
+    Configuration opts;
+    util::RandomNumberGenerator rng(p.seed.orElse(afl::sys::Time::getTickCounter()));
+    if (runSim || runBench) {
+        buildConfiguration(opts, session, p);
+        game::sim::prepareSimulation(setup, opts, rng);
+    }
+    const uint32_t benchmarkSeed = rng.getSeed();
+
     // Sim
-    if (p.runSimSeries || p.runSimCount.isValid()) {
-        loadSession(session, p, *cs);
-        runSimulation(setup, session, p);
+    if (runSim) {
+        runSimulation(setup, opts, session, p, rng);
+    }
+
+    // Benchmark
+    if (runBench) {
+        runBenchmark(setup, opts, session, p, benchmarkSeed);
     }
 }
 
@@ -279,6 +335,28 @@ game::sim::ConsoleApplication::parseCommandLine(Parameters& p)
                 if (!afl::string::strToInteger(param, p.numThreads)) {
                     errorExit(Format(tx("invalid number of threads, '%s'"), param));
                 }
+            } else if (text == "batch") {
+                String_t param = parser.getRequiredParameter(text);
+                size_t n = 0;
+                if (!afl::string::strToInteger(param, n) || n == 0) {
+                    errorExit(Format(tx("invalid batch size, '%s'"), param));
+                }
+                p.batchSize = n;
+            } else if (text == "benchmark") {
+                String_t param = parser.getRequiredParameter(text);
+                size_t n = 0;
+                if (!afl::string::strToInteger(param, n) || n == 0) {
+                    errorExit(Format(tx("invalid number of simulations, '%s'"), param));
+                }
+                p.benchmarkCount = n;
+                p.hadAction = true;
+            } else if (text == "add-fleet") {
+                String_t param = parser.getRequiredParameter(text);
+                size_t n = 0;
+                if (!afl::string::strToInteger(param, n) || n == 0 || n > size_t(game::MAX_NUMBER) / 2) {
+                    errorExit(Format(tx("invalid number of ships, '%s'"), param));
+                }
+                p.fleetSize = n;
             } else if (text == "C" || text == "charset") {
                 p.charsetName = parser.getRequiredParameter(text);
             } else if (text == "q") {
@@ -360,16 +438,19 @@ game::sim::ConsoleApplication::help()
                                                 "--verify\tVerify simulation against ship list\n"
                                                 "--run N\tRun N simulations\n"
                                                 "--run-series\tRun a series\n"
+                                                "--benchmark N\tRun N simulations with 1..jobs threads, report timing\n"
                                                 "\n"
                                                 "Options:\n"
                                                 "--game/-G DIR\tGame directory\n"
                                                 "--root/-R DIR\tRoot directory\n"
                                                 "--charset/-C CS\tSet game character set\n"
+                                                "--add-fleet N\tAdd two fleets of N carriers each (benchmark)\n"
                                                 "-q\tDo not show progress messages\n"
                                                 "--log CONFIG\tConfigure log output\n"
                                                 "\n"
                                                 "Simulation options:\n"
                                                 "--jobs/-j N\tSet number of threads for simulation\n"
+                                                "--batch N\tUse batch scheduler with N simulations per batch\n"
                                                 "--mode=MODE\tSet mode (host, phost[2-4], flak, nuhost)\n"
                                                 "--esb=N\tSet engine-shield bonus\n"
                                                 "--[no-]scotty\tScotty bonus\n"
@@ -503,10 +584,78 @@ game::sim::ConsoleApplication::showSetup(const Setup& setup, const Session& sess
 }
 
 void
-game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& session, const Parameters& params)
+game::sim::ConsoleApplication::runSimulation(const Setup& setup, const Configuration& opts, const Session& session, const Parameters& params, util::RandomNumberGenerator& rng)
+{
+    // Build runner
+    std::auto_ptr<Runner> runner(makeRunner(setup, opts, session, params, rng, params.numThreads));
+
+    // Run first sim
+    afl::string::Translator& tx = translator();
+    afl::io::TextWriter& out = standardOutput();
+    if (!runner->init()) {
+        out.writeLine(tx("Simulation did not produce any battles."));
+        return;
+    }
+
+    // Run more sims
+    util::StopSignal sig;
+    if (params.runSimSeries) {
+        runner->run(runner->makeSeriesLimit(), sig);
+    } else {
+        size_t n = params.runSimCount.orElse(0);
+        if (n > 1) {
+            runner->run(runner->makeFiniteLimit(n-1), sig);
+        }
+    }
+
+    // Show results
+    out.writeLine(Format(tx("Results after %d simulation%!1{s%}"), runner->resultList().getNumBattles()));
+    out.writeLine();
+    showClassResults(setup, session, runner->resultList());
+    showUnitResults(setup, session, runner->resultList());
+}
+
+void
+game::sim::ConsoleApplication::runBenchmark(const Setup& setup, const Configuration& opts, const Session& session, const Parameters& params, uint32_t seed)
+{
+    afl::string::Translator& tx = translator();
+    afl::io::TextWriter& out = standardOutput();
+
+    // All runs start from the same seed and therefore compute the same battles.
+    const size_t count = params.benchmarkCount.orElse(1);
+    const size_t maxThreads = std::max(params.numThreads, size_t(1));
+    uint32_t baseTime = 0;
+    for (size_t numThreads = 1; numThreads <= maxThreads; ++numThreads) {
+        util::RandomNumberGenerator rng(seed);
+        std::auto_ptr<Runner> runner(makeRunner(setup, opts, session, params, rng, numThreads));
+
+        const uint32_t startTime = afl::sys::Time::getTickCounter();
+        if (!runner->init()) {
+            out.writeLine(tx("Simulation did not produce any battles."));
+            return;
+        }
+        if (count > 1) {
+            util::StopSignal sig;
+            runner->run(runner->makeFiniteLimit(count-1), sig);
+        }
+        const uint32_t elapsed = std::max(afl::sys::Time::getTickCounter() - startTime, uint32_t(1));
+        if (numThreads == 1) {
+            baseTime = elapsed;
+        }
+
+        out.writeLine(Format(tx("%3d thread%!1{s%}: %d simulation%!1{s%} in %d ms, %.1f/s, speedup %.2f, %d job%!1{s%} allocated"),
+                             numThreads,
+                             runner->resultList().getNumBattles(),
+                             elapsed,
+                             1000.0 * double(runner->resultList().getNumBattles()) / elapsed,
+                             double(baseTime) / elapsed,
+                             runner->getNumAllocatedJobs()));
+    }
+}
+
+void
+game::sim::ConsoleApplication::buildConfiguration(Configuration& opts, const Session& session, const Parameters& params)
 {
-    // Build configuration
-    Configuration opts;
     if (const Configuration::VcrMode* vcrMode = params.vcrMode.get()) {
         opts.setMode(*vcrMode, 0, session.root->hostConfiguration());
     }
@@ -534,43 +683,18 @@ game::sim::ConsoleApplication::runSimulation(Setup& setup, const Session& sessio
     if (const Configuration::BalancingMode* balancingMode = params.balancingMode.get()) {
         opts.setBalancingMode(*balancingMode);
     }
+}
 
-    // Build RNG
-    util::RandomNumberGenerator rng(params.seed.orElse(afl::sys::Time::getTickCounter()));
-    game::sim::prepareSimulation(setup, opts, rng);
-
-    // Build runner
-    std::auto_ptr<Runner> runner;
-    if (params.numThreads <= 1) {
-        runner.reset(new SimpleRunner(setup, opts, *session.shipList, session.root->hostConfiguration(), session.root->flakConfiguration(), consoleLogger(), rng));
-    } else {
-        runner.reset(new ParallelRunner(setup, opts, *session.shipList, session.root->hostConfiguration(), session.root->flakConfiguration(), consoleLogger(), rng, params.numThreads));
-    }
-
-    // Run first sim
-    afl::string::Translator& tx = translator();
-    afl::io::TextWriter& out = standardOutput();
-    if (!runner->init()) {
-        out.writeLine(tx("Simulation did not produce any battles."));
-        return;
-    }
-
-    // Run more sims
-    util::StopSignal sig;
-    if (params.runSimSeries) {
-        runner->run(runner->makeSeriesLimit(), sig);
+game::sim::Runner*
+game::sim::ConsoleApplication::makeRunner(const Setup& setup, const Configuration& opts, const Session& session, const Parameters& params, util::RandomNumberGenerator& rng, size_t numThreads)
+{
+    if (numThreads <= 1) {
+        return new SimpleRunner(setup, opts, *session.shipList, session.root->hostConfiguration(), session.root->flakConfiguration(), consoleLogger(), rng);
+    } else if (const size_t* batchSize = params.batchSize.get()) {
+        return new BatchRunner(setup, opts, *session.shipList, session.root->hostConfiguration(), session.root->flakConfiguration(), consoleLogger(), rng, numThreads, *batchSize);
     } else {
-        size_t n = params.runSimCount.orElse(0);
-        if (n > 1) {
-            runner->run(runner->makeFiniteLimit(n-1), sig);
-        }
+        return new ParallelRunner(setup, opts, *session.shipList, session.root->hostConfiguration(), session.root->flakConfiguration(), consoleLogger(), rng, numThreads);
     }
-
-    // Show results
-    out.writeLine(Format(tx("Results after %d simulation%!1{s%}"), runner->resultList().getNumBattles()));
-    out.writeLine();
-    showClassResults(setup, session, runner->resultList());
-    showUnitResults(setup, session, runner->resultList());
 }
 
 void
@@ -7,11 +7,14 @@
 
 #include "afl/charset/charset.hpp"
 #include "util/application.hpp"
+#include "util/randomnumbergenerator.hpp"
 
 namespace game { namespace sim {
 
-    class Setup;
+    class Configuration;
     class ResultList;
+    class Runner;
+    class Setup;
 
     /** Simulator console application.
         Provides a command-line interface to the battle simulator.
@@ -40,7 +43,10 @@ namespace game { namespace sim {
         void loadSession(Session& session, const Parameters& params, afl::charset::Charset& charset);
         void verifySetup(const Setup& setup, const Session& session);
         void showSetup(const Setup& setup, const Session& session);
-        void runSimulation(Setup& setup, const Session& session, const Parameters& params);
+        void runSimulation(const Setup& setup, const Configuration& opts, const Session& session, const Parameters& params, util::RandomNumberGenerator& rng);
+        void runBenchmark(const Setup& setup, const Configuration& opts, const Session& session, const Parameters& params, uint32_t seed);
+        void buildConfiguration(Configuration& opts, const Session& session, const Parameters& params);
+        Runner* makeRunner(const Setup& setup, const Configuration& opts, const Session& session, const Parameters& params, util::RandomNumberGenerator& rng, size_t numThreads);
         void showClassResults(const Setup& setup, const Session& session, const ResultList& resultList);
         void showUnitResults(const Setup& setup, const Session& session, const ResultList& resultList);
     };
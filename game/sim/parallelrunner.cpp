@@ -4,6 +4,7 @@
 
 #include "game/sim/parallelrunner.hpp"
 #include "afl/sys/mutexguard.hpp"
+#include "afl/sys/time.hpp"
 
 game::sim::ParallelRunner::ParallelRunner(const Setup& setup,
                                           const Configuration& opts,
@@ -64,12 +65,18 @@ game::sim::ParallelRunner::startAll()
 }
 
 bool
-game::sim::ParallelRunner::processRequest()
+game::sim::ParallelRunner::processRequest(ResultList& partial, uint32_t& lastMerge, std::auto_ptr<Job>& j)
 {
-    // Fetch job
-    std::auto_ptr<Job> j;
+    // Give back previous job; merge results if due; fetch job.
+    // Pool is LIFO, so we will normally get back the job we just gave back.
     {
         afl::sys::MutexGuard g(m_mutex);
+        if (j.get() != 0) {
+            recycleJob(j.release());
+        }
+        if (checkMerge(lastMerge)) {
+            mergeResults(partial);
+        }
         j.reset(makeJob(m_limit, *m_pStopper));
     }
     if (!j.get()) {
@@ -79,11 +86,8 @@ game::sim::ParallelRunner::processRequest()
     // Do it
     runJob(j.get());
 
-    // Put back
-    {
-        afl::sys::MutexGuard g(m_mutex);
-        finishJob(j.release());
-    }
+    // Put into our own result list; does not need the lock
+    collectJob(*j, partial);
     return true;
 }
 
@@ -107,10 +111,19 @@ game::sim::ParallelRunner::run()
         }
 
         // Process requests
-        while (processRequest()) {
+        ResultList partial;
+        uint32_t lastMerge = afl::sys::Time::getTickCounter();
+        std::auto_ptr<Job> job;
+        while (processRequest(partial, lastMerge, job)) {
             // nix
         }
 
+        // Merge remaining results
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            mergeResults(partial);
+        }
+
         // Signal control thread that we stop
         m_stopSignal.post();
     }
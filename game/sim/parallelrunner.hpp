@@ -5,6 +5,7 @@
 #ifndef C2NG_GAME_SIM_PARALLELRUNNER_HPP
 #define C2NG_GAME_SIM_PARALLELRUNNER_HPP
 
+#include <memory>
 #include "afl/base/stoppable.hpp"
 #include "afl/container/ptrvector.hpp"
 #include "afl/sys/mutex.hpp"
@@ -23,7 +24,10 @@ namespace game { namespace sim {
         The sig_update may therefore not modify any of those.
         The sig_update callback may come from any thread.
 
-        Worker threads are passive when run() is not active. */
+        Worker threads are passive when run() is not active.
+
+        Each worker thread collects its results in a local ResultList and merges them into the main one
+        about once per update interval, and when it runs out of work. */
     class ParallelRunner : public Runner,
                            private afl::base::Stoppable
     {
@@ -55,7 +59,7 @@ namespace game { namespace sim {
 
      private:
         void startAll();
-        bool processRequest();
+        bool processRequest(ResultList& partial, uint32_t& lastMerge, std::auto_ptr<Job>& j);
 
         // Stoppable:
         void run();
@@ -3,11 +3,12 @@
   *  \brief Class game::sim::ResultList
   */
 
+#include <cassert>
 #include "game/sim/resultlist.hpp"
+#include "afl/string/format.hpp"
+#include "game/sim/planet.hpp"
 #include "game/sim/setup.hpp"
 #include "game/sim/ship.hpp"
-#include "game/sim/planet.hpp"
-#include "afl/string/format.hpp"
 
 namespace {
     afl::base::Ptr<game::vcr::Database> pickSample(const game::sim::UnitResult::Item& item, bool max)
@@ -20,7 +21,7 @@ const size_t game::sim::ResultList::UnitInfo::MAX_TYPE;
 
 // Make blank ResultList.
 game::sim::ResultList::ResultList()
-    : m_totalWeight(0), m_cumulativeWeight(0), m_numBattles(0), m_lastClassResultIndex(0), m_unitResults(), m_classResults()
+    : m_totalWeight(0), m_cumulativeWeight(0), m_numBattles(0), m_lastClassResultIndex(0), m_unitResults(), m_classResults(), m_classIndex()
 {
     // ex GSimResultSummary
 }
@@ -37,30 +38,22 @@ game::sim::ResultList::addResult(const Setup& oldState, const Setup& newState, a
     // Check validity of parameters
     assert(oldState.getNumObjects() == newState.getNumObjects());
 
-    // Build m_unitResults on first iteration
-    if (m_unitResults.empty()) {
+    // Build m_unitResults on first iteration.
+    // UnitResult uses this_battle_index to recognize the first result;
+    // a worker-local ResultList (see merge()) can start with any battle.
+    if (m_numBattles == 0) {
+        m_unitResults.clear();
         for (Setup::Slot_t i = 0, n = oldState.getNumObjects(); i < n; ++i) {
             m_unitResults.pushBackNew(new UnitResult());
         }
         m_totalWeight = result.total_battle_weight;
+        result.this_battle_index = 0;
     }
 
     // Adjust weights. This should never be needed if the driver works correctly, but it doesn't hurt.
     if (m_totalWeight < result.total_battle_weight) {
         // The new battle has a higher weight; upgrade existing results
-        for (UnitResults_t::iterator i = m_unitResults.begin(); i != m_unitResults.end(); ++i) {
-            (*i)->changeWeight(m_totalWeight, result.total_battle_weight);
-        }
-        for (ClassResults_t::iterator i = m_classResults.begin(); i != m_classResults.end(); ++i) {
-            (*i)->changeWeight(m_totalWeight, result.total_battle_weight);
-        }
-
-        m_cumulativeWeight = 0;
-        for (ClassResults_t::iterator i = m_classResults.begin(); i != m_classResults.end(); ++i) {
-            m_cumulativeWeight += (*i)->getWeight();
-        }
-
-        m_totalWeight = result.total_battle_weight;
+        changeTotalWeight(result.total_battle_weight);
     }
 
     if (m_totalWeight > result.total_battle_weight) {
@@ -69,43 +62,84 @@ game::sim::ResultList::addResult(const Setup& oldState, const Setup& newState, a
     }
     assert(result.total_battle_weight == m_totalWeight);
 
-    // Add new unit results
-    for (Setup::Slot_t i = 0, n = oldState.getNumObjects(); i < n; ++i) {
+    // Add new unit results.
+    // Setup's object list is the ships followed by the planet, so we need not dynamic_cast each object.
+    const Setup::Slot_t numShips = oldState.getNumShips();
+    assert(newState.getNumShips() == numShips);
+    for (Setup::Slot_t i = 0; i < numShips; ++i) {
         const game::vcr::Statistic* pStat = stats.eat();
-        if (const Ship* oldShip = dynamic_cast<const Ship*>(oldState.getObject(i))) {
-            const Ship* newShip = dynamic_cast<const Ship*>(newState.getObject(i));
-            assert(newShip);
-            m_unitResults[i]->addResult(*oldShip, *newShip, pStat ? *pStat : game::vcr::Statistic(), result);
-        } else if (const Planet* oldPlanet = dynamic_cast<const Planet*>(oldState.getObject(i))) {
-            const Planet* newPlanet = dynamic_cast<const Planet*>(newState.getObject(i));
-            assert(newPlanet);
-            m_unitResults[i]->addResult(*oldPlanet, *newPlanet, pStat ? *pStat : game::vcr::Statistic(), result);
-        } else {
-            assert(0);
-        }
+        const Ship* oldShip = oldState.getShip(i);
+        const Ship* newShip = newState.getShip(i);
+        assert(oldShip);
+        assert(newShip);
+        m_unitResults[i]->addResult(*oldShip, *newShip, pStat ? *pStat : game::vcr::Statistic(), result);
+    }
+    if (const Planet* oldPlanet = oldState.getPlanet()) {
+        const game::vcr::Statistic* pStat = stats.eat();
+        const Planet* newPlanet = newState.getPlanet();
+        assert(newPlanet);
+        m_unitResults[numShips]->addResult(*oldPlanet, *newPlanet, pStat ? *pStat : game::vcr::Statistic(), result);
     }
 
     /* And add it to the class results */
-    ClassResult this_class(newState, result);
-    bool have_this_class = false;
-    for (ClassResults_t::iterator i = m_classResults.begin(); i != m_classResults.end(); ++i) {
-        if ((*i)->isSameClass(this_class)) {
-            (*i)->addSameClassResult(this_class);
-            have_this_class = true;
-            m_lastClassResultIndex = updateClassResultSortOrder(i - m_classResults.begin());
-            break;
-        }
-    }
-    if (!have_this_class) {
-        m_classResults.pushBackNew(new ClassResult(this_class));
-        m_lastClassResultIndex = updateClassResultSortOrder(m_classResults.size() - 1);
-    }
+    m_lastClassResultIndex = addClassResult(ClassResult(newState, result));
 
     /* Finally, adjust our counters */
     m_cumulativeWeight += result.this_battle_weight;
     ++m_numBattles;
 }
 
+// Merge another result list into this object.
+void
+game::sim::ResultList::merge(ResultList& other)
+{
+    if (other.m_numBattles == 0) {
+        return;
+    }
+
+    if (m_numBattles == 0) {
+        // We are empty: take over other's unit results
+        m_unitResults.clear();
+        for (size_t i = 0, n = other.m_unitResults.size(); i < n; ++i) {
+            m_unitResults.pushBackNew(new UnitResult(*other.m_unitResults[i]));
+        }
+        m_totalWeight = other.m_totalWeight;
+    } else {
+        // Normalize weights
+        if (m_totalWeight < other.m_totalWeight) {
+            changeTotalWeight(other.m_totalWeight);
+        }
+        if (other.m_totalWeight < m_totalWeight) {
+            other.changeTotalWeight(m_totalWeight);
+        }
+        assert(other.m_totalWeight == m_totalWeight);
+
+        // Unit results
+        assert(other.m_unitResults.size() == m_unitResults.size());
+        for (size_t i = 0, n = m_unitResults.size(); i < n; ++i) {
+            m_unitResults[i]->merge(*other.m_unitResults[i]);
+        }
+    }
+
+    // Class results, in other's order
+    const ClassResult* otherLast = other.getClassResult(other.m_lastClassResultIndex);
+    for (size_t i = 0, n = other.m_classResults.size(); i < n; ++i) {
+        addClassResult(*other.m_classResults[i]);
+    }
+    if (otherLast != 0) {
+        ClassIndex_t::const_iterator it = m_classIndex.find(otherLast->getClass());
+        if (it != m_classIndex.end()) {
+            m_lastClassResultIndex = it->second;
+        }
+    }
+
+    // Counters
+    m_cumulativeWeight += other.m_cumulativeWeight;
+    m_numBattles += other.m_numBattles;
+
+    other.clear();
+}
+
 // Get cumulative weight.
 int32_t
 game::sim::ResultList::getCumulativeWeight() const
@@ -256,6 +290,72 @@ game::sim::ResultList::getLastClassResultIndex() const
 }
 
 
+/** Compare classes for m_classIndex.
+    Uses the same criteria as ClassResult::isSameClass(). */
+bool
+game::sim::ResultList::ClassOrder::operator()(const PlayerArray<int>& a, const PlayerArray<int>& b) const
+{
+    for (int i = 1; i <= MAX_PLAYERS; ++i) {
+        int aa = a.get(i), bb = b.get(i);
+        if (aa != bb) {
+            return aa < bb;
+        }
+    }
+    return false;
+}
+
+/** Change total weight.
+    Assuming all content was produced with m_totalWeight, adjust it for newWeight. */
+void
+game::sim::ResultList::changeTotalWeight(int32_t newWeight)
+{
+    for (UnitResults_t::iterator i = m_unitResults.begin(); i != m_unitResults.end(); ++i) {
+        (*i)->changeWeight(m_totalWeight, newWeight);
+    }
+    for (ClassResults_t::iterator i = m_classResults.begin(); i != m_classResults.end(); ++i) {
+        (*i)->changeWeight(m_totalWeight, newWeight);
+    }
+
+    m_cumulativeWeight = 0;
+    for (ClassResults_t::iterator i = m_classResults.begin(); i != m_classResults.end(); ++i) {
+        m_cumulativeWeight += (*i)->getWeight();
+    }
+
+    m_totalWeight = newWeight;
+}
+
+/** Add class result.
+    Adds to the existing ClassResult of the same class, or creates a new one, and updates the sort order.
+    \param r ClassResult to add
+    \return new index of the affected ClassResult */
+size_t
+game::sim::ResultList::addClassResult(const ClassResult& r)
+{
+    ClassIndex_t::iterator it = m_classIndex.find(r.getClass());
+    if (it != m_classIndex.end()) {
+        m_classResults[it->second]->addSameClassResult(r);
+        return updateClassResultSortOrder(it->second);
+    } else {
+        size_t index = m_classResults.size();
+        m_classResults.pushBackNew(new ClassResult(r));
+        m_classIndex.insert(std::make_pair(r.getClass(), index));
+        return updateClassResultSortOrder(index);
+    }
+}
+
+/** Reset to empty state. */
+void
+game::sim::ResultList::clear()
+{
+    m_totalWeight = 0;
+    m_cumulativeWeight = 0;
+    m_numBattles = 0;
+    m_lastClassResultIndex = 0;
+    m_unitResults.clear();
+    m_classResults.clear();
+    m_classIndex.clear();
+}
+
 /** Update class result sort order. Assuming value at change_index was
     modified (count increased), sort it into its place. */
 size_t
@@ -265,6 +365,8 @@ game::sim::ResultList::updateClassResultSortOrder(size_t change_index)
         if (m_classResults[change_index-1]->getWeight() < m_classResults[change_index]->getWeight()) {
             /* swap them */
             m_classResults.swapElements(change_index-1, change_index);
+            m_classIndex[m_classResults[change_index]->getClass()] = change_index;
+            m_classIndex[m_classResults[change_index-1]->getClass()] = change_index-1;
             change_index--;
         } else {
             /* finish */
@@ -5,6 +5,7 @@
 #ifndef C2NG_GAME_SIM_RESULTLIST_HPP
 #define C2NG_GAME_SIM_RESULTLIST_HPP
 
+#include <map>
 #include "afl/base/memory.hpp"
 #include "afl/base/types.hpp"
 #include "afl/container/ptrvector.hpp"
@@ -28,7 +29,10 @@ namespace game { namespace sim {
         one particular setup with one particular seed has a 59-vs-41% weight of occuring.
         We do not simulate these 59+41 battles, but instead only simulate two and adjust their weights accordingly.
         For memory efficiency, only the ResultList stores the effective total weight,
-        the UnitResult::Item's do not know the value internally. */
+        the UnitResult::Item's do not know the value internally.
+
+        Multi-threaded runners can collect results in worker-local ResultList objects
+        and merge them into the main one using merge(). */
     class ResultList {
      public:
         /** Formatted version of a ClassResult. */
@@ -93,7 +97,8 @@ namespace game { namespace sim {
 
         /** Incorporate result into this object.
 
-            The first call must have res.this_battle_index=0, subsequent calls must have res.this_battle_index!=0.
+            The first call into an empty ResultList initializes the statistics,
+            independent of the result's this_battle_index.
 
             Both states (oldState, newState) must have the same structure (same number of ships, planets).
 
@@ -103,6 +108,17 @@ namespace game { namespace sim {
             \param result   [in] Result meta-information provided by simulator */
         void addResult(const Setup& oldState, const Setup& newState, afl::base::Memory<const game::vcr::Statistic> stats, Result result);
 
+        /** Merge another result list into this object.
+            The other result list must have been produced from the same setup.
+            Its results are added as if its addResult() calls had been made on this object;
+            weights are normalized as needed.
+            Class results are sorted using the same rules as addResult().
+
+            The other result list is empty afterwards.
+
+            \param other [in,out] Other result list */
+        void merge(ResultList& other);
+
         /** Get cumulative weight.
             This is the sum of all weights of all simulated battles.
             \return cumulative weight */
@@ -164,12 +180,22 @@ namespace game { namespace sim {
         int m_numBattles;                 ///< Total number of battles so far. ex battle_count.
         size_t m_lastClassResultIndex;    ///< Last class result index.
 
+        /** Ordering for class index. */
+        struct ClassOrder {
+            bool operator()(const PlayerArray<int>& a, const PlayerArray<int>& b) const;
+        };
+
         typedef afl::container::PtrVector<UnitResult> UnitResults_t;
         typedef afl::container::PtrVector<ClassResult> ClassResults_t;
+        typedef std::map<PlayerArray<int>, size_t, ClassOrder> ClassIndex_t;
 
         UnitResults_t  m_unitResults;     ///< Per-unit results for each unit. ex unit_results.
         ClassResults_t m_classResults;    ///< Per-class results for each class. ex class_results.
+        ClassIndex_t   m_classIndex;      ///< Index into m_classResults by class.
 
+        void changeTotalWeight(int32_t newWeight);
+        size_t addClassResult(const ClassResult& r);
+        void clear();
         size_t updateClassResultSortOrder(size_t change_index);
         UnitInfo::Item packItem(UnitInfo::Type type, const UnitResult::Item& item) const;
     };
@@ -2336,6 +2336,7 @@ namespace {
                       const ShipList& shipList,
                       const HostConfiguration& config,
                       const game::vcr::flak::Configuration& flakConfig,
+                      const game::vcr::flak::Environment* pFlakEnv,
                       util::RandomNumberGenerator& rng)
     {
         afl::base::Ptr<game::vcr::flak::Database> db(new game::vcr::flak::Database());
@@ -2401,7 +2402,12 @@ namespace {
         }
 
         // Compute speeds, etc.
-        game::vcr::flak::GameEnvironment env(config, shipList.beams(), shipList.launchers());
+        // Use precomputed environment if we have one; otherwise, look up values directly.
+        std::auto_ptr<game::vcr::flak::GameEnvironment> gameEnv;
+        if (pFlakEnv == 0) {
+            gameEnv.reset(new game::vcr::flak::GameEnvironment(config, shipList.beams(), shipList.launchers()));
+        }
+        const game::vcr::flak::Environment& env = (pFlakEnv != 0 ? *pFlakEnv : *gameEnv);
         flakSetup->initAfterSetup(flakConfig, env, rng);
         if (flakSetup->getNumFleets() == 0) {
             return;
@@ -2472,6 +2478,21 @@ game::sim::runSimulation(Setup& setup,
                          const game::config::HostConfiguration& config,
                          const game::vcr::flak::Configuration& flakConfig,
                          util::RandomNumberGenerator& rng)
+{
+    runSimulation(setup, stats, result, opts, list, config, flakConfig, 0, rng);
+}
+
+// Run one simulation, with precomputed FLAK environment.
+void
+game::sim::runSimulation(Setup& setup,
+                         std::vector<game::vcr::Statistic>& stats,
+                         Result& result,
+                         const Configuration& opts,
+                         const game::spec::ShipList& list,
+                         const game::config::HostConfiguration& config,
+                         const game::vcr::flak::Configuration& flakConfig,
+                         const game::vcr::flak::Environment* flakEnv,
+                         util::RandomNumberGenerator& rng)
 {
     // runSimulation(GSimState& state, const GSimOptions& opts, GSimBattleResult& result, ProgressMonitor& monitor)
     if (opts.hasRandomizeFCodesOnEveryFight()) {
@@ -2498,7 +2519,7 @@ game::sim::runSimulation(Setup& setup,
         simulatePHost(setup, opts, result, stats, list, config, rng, game::vcr::classic::PHost4);
         break;
      case Configuration::VcrFLAK:
-        simulateFLAK(setup, opts, result, stats, list, config, flakConfig, rng);
+        simulateFLAK(setup, opts, result, stats, list, config, flakConfig, flakEnv, rng);
         break;
     }
 }
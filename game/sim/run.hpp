@@ -8,6 +8,7 @@
 #include "game/config/hostconfiguration.hpp"
 #include "game/spec/shiplist.hpp"
 #include "game/vcr/flak/configuration.hpp"
+#include "game/vcr/flak/environment.hpp"
 #include "game/vcr/statistic.hpp"
 #include "util/randomnumbergenerator.hpp"
 
@@ -38,6 +39,29 @@ namespace game { namespace sim {
                        const game::vcr::flak::Configuration& flakConfig,
                        util::RandomNumberGenerator& rng);
 
+    /** Run one simulation, with precomputed FLAK environment.
+        Same as above, but FLAK simulations use the given environment instead of looking up configuration values.
+        Use this if you run many simulations with the same configuration.
+
+        \param [in,out]  setup     Simulation state. Will be updated to contain the simulation results.
+        \param [out]     stats     Receives out-of-band statistics not covered by state.
+        \param [in,out]  result    Result descriptor. Caller must initialize; will be updated with new battle weights.
+        \param [in]      opts      Simulator options
+        \param [in]      list      Ship list (requires hulls, beams, engines, torpedo launchers, friendly codes, hull functions)
+        \param [in]      config    Host configuration
+        \param [in]      flakConfig FLAK configuration
+        \param [in]      flakEnv   FLAK environment (e.g. game::vcr::flak::CompiledEnvironment) matching config and list; can be null
+        \param [in,out]  rng       Random number generator; used only of \c opts does not configure a deterministic simulation */
+    void runSimulation(Setup& setup,
+                       std::vector<game::vcr::Statistic>& stats,
+                       Result& result,
+                       const Configuration& opts,
+                       const game::spec::ShipList& list,
+                       const game::config::HostConfiguration& config,
+                       const game::vcr::flak::Configuration& flakConfig,
+                       const game::vcr::flak::Environment* flakEnv,
+                       util::RandomNumberGenerator& rng);
+
     /** Prepare for simulation.
         Call once before calling runSimulation() possibly multiple times.
         This will process random friendly codes for hasRandomizeFCodesOnEveryFight()=off.
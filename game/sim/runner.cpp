@@ -3,10 +3,11 @@
   */
 
 #include "game/sim/runner.hpp"
+#include "afl/sys/time.hpp"
+#include "game/sim/configuration.hpp"
+#include "game/sim/result.hpp"
 #include "game/sim/run.hpp"
 #include "game/sim/setup.hpp"
-#include "game/sim/result.hpp"
-#include "afl/sys/time.hpp"
 
 /*
  *  Job (internal utility class)
@@ -21,6 +22,7 @@ game::sim::Runner::Job::Job(const Setup& setup,
                             const game::spec::ShipList& list,
                             const game::config::HostConfiguration& config,
                             const game::vcr::flak::Configuration& flakConfig,
+                            const game::vcr::flak::Environment* flakEnv,
                             afl::sys::LogListener& log,
                             util::RandomNumberGenerator& rng,
                             size_t serial)
@@ -30,6 +32,7 @@ game::sim::Runner::Job::Job(const Setup& setup,
       m_shipList(list),
       m_config(config),
       m_flakConfiguration(flakConfig),
+      m_flakEnvironment(flakEnv),
       m_log(log),
       m_rng(rng.getSeed() ^ uint32_t(serial)),
       m_result(opts, int(serial)),
@@ -38,11 +41,22 @@ game::sim::Runner::Job::Job(const Setup& setup,
     m_rng();
 }
 
+inline void
+game::sim::Runner::Job::reset(util::RandomNumberGenerator& rng, size_t serial)
+{
+    // Same as constructor, but reuses existing objects
+    m_newState = m_setup;
+    m_rng.setSeed(rng.getSeed() ^ uint32_t(serial));
+    m_rng();
+    m_result = Result(m_options, int(serial));
+    m_stats.clear();
+}
+
 inline void
 game::sim::Runner::Job::run()
 {
     try {
-        runSimulation(m_newState, m_stats, m_result, m_options, m_shipList, m_config, m_flakConfiguration, m_rng);
+        runSimulation(m_newState, m_stats, m_result, m_options, m_shipList, m_config, m_flakConfiguration, m_flakEnvironment, m_rng);
     }
     catch (std::exception& e) {
         // In a correctly working system, this place is never reached.
@@ -86,14 +100,22 @@ game::sim::Runner::Runner(const Setup& setup,
       m_shipList(list),
       m_config(config),
       m_flakConfiguration(flakConfig),
+      m_flakEnvironment(),
       m_log(log),
       m_rng(rng),
       m_count(0),
       m_seriesLength(0),
       m_lastUpdate(0),
       m_updateInterval(500),
-      m_resultList()
-{ }
+      m_resultList(),
+      m_jobPool(),
+      m_numAllocatedJobs(0)
+{
+    // FLAK battles query the environment a lot; precompute it once for all jobs.
+    if (opts.getMode() == Configuration::VcrFLAK) {
+        m_flakEnvironment.reset(new game::vcr::flak::CompiledEnvironment(config, list.beams(), list.launchers()));
+    }
+}
 
 bool
 game::sim::Runner::init()
@@ -101,7 +123,7 @@ game::sim::Runner::init()
     // ex WSimResultWindow::runFirstSimulation (sort-of)
     bool ok;
     if (m_count == 0) {
-        Job j(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log, m_rng, 0);
+        Job j(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_flakEnvironment.get(), m_log, m_rng, 0);
         j.run();
         if (j.writeBack(m_resultList)) {
             m_count = 1;
@@ -123,6 +145,12 @@ game::sim::Runner::resultList() const
     return m_resultList;
 }
 
+size_t
+game::sim::Runner::getNumAllocatedJobs() const
+{
+    return m_numAllocatedJobs;
+}
+
 void
 game::sim::Runner::setUpdateInterval(uint32_t interval)
 {
@@ -155,7 +183,14 @@ game::sim::Runner::Job*
 game::sim::Runner::makeJob(Limit_t& limit, util::StopSignal& stopper)
 {
     if (!stopper.get() && (limit == 0 || m_count < limit)) {
-        return new Job(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_log, m_rng, m_count++);
+        if (!m_jobPool.empty()) {
+            Job* p = m_jobPool.extractLast();
+            p->reset(m_rng, m_count++);
+            return p;
+        } else {
+            ++m_numAllocatedJobs;
+            return new Job(m_setup, m_options, m_shipList, m_config, m_flakConfiguration, m_flakEnvironment.get(), m_log, m_rng, m_count++);
+        }
     } else {
         return 0;
     }
@@ -164,19 +199,57 @@ game::sim::Runner::makeJob(Limit_t& limit, util::StopSignal& stopper)
 void
 game::sim::Runner::finishJob(Job* p)
 {
-    std::auto_ptr<Job> pp(p);
-    pp->writeBack(m_resultList);
+    p->writeBack(m_resultList);
+    recycleJob(p);
+    checkUpdate();
+}
 
+void
+game::sim::Runner::runJob(Job* p)
+{
+    p->run();
+}
+
+void
+game::sim::Runner::collectJob(const Job& job, ResultList& partial)
+{
+    job.writeBack(partial);
+}
+
+void
+game::sim::Runner::recycleJob(Job* p)
+{
+    m_jobPool.pushBackNew(p);
+}
+
+bool
+game::sim::Runner::checkMerge(uint32_t& lastMerge) const
+{
     uint32_t now = afl::sys::Time::getTickCounter();
-    uint32_t elapsed = now - m_lastUpdate;
+    uint32_t elapsed = now - lastMerge;
     if (elapsed >= m_updateInterval) {
-        m_lastUpdate = now;
-        sig_update.raise();
+        lastMerge = now;
+        return true;
+    } else {
+        return false;
     }
 }
 
 void
-game::sim::Runner::runJob(Job* p)
+game::sim::Runner::mergeResults(ResultList& partial)
 {
-    p->run();
+    m_resultList.merge(partial);
+    checkUpdate();
+}
+
+/* Raise sig_update if update interval has elapsed. */
+void
+game::sim::Runner::checkUpdate()
+{
+    uint32_t now = afl::sys::Time::getTickCounter();
+    uint32_t elapsed = now - m_lastUpdate;
+    if (elapsed >= m_updateInterval) {
+        m_lastUpdate = now;
+        sig_update.raise();
+    }
 }
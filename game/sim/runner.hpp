@@ -5,12 +5,15 @@
 #ifndef C2NG_GAME_SIM_RUNNER_HPP
 #define C2NG_GAME_SIM_RUNNER_HPP
 
+#include <memory>
 #include "afl/base/deletable.hpp"
 #include "afl/base/signal.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "game/config/hostconfiguration.hpp"
 #include "game/sim/resultlist.hpp"
 #include "game/sim/setup.hpp"
 #include "game/spec/shiplist.hpp"
+#include "game/vcr/flak/compiledenvironment.hpp"
 #include "game/vcr/flak/configuration.hpp"
 #include "util/randomnumbergenerator.hpp"
 #include "util/stopsignal.hpp"
@@ -71,10 +74,18 @@ namespace game { namespace sim {
             - call makeJob() with the given parameters
             - if it returns non-null, call runJob(), then finishJob().
 
+            Jobs are recycled: finishJob() and recycleJob() keep the Job object for reuse by a later makeJob(),
+            which resets it in place instead of allocating and copying a new one.
+
             If the implementation uses multiple threads,
             it must make sure that makeJob() and finishJob() are run under mutex protection;
             runJob() can run in parallel.
 
+            Alternatively, a multi-threaded implementation can collect results in a worker-local ResultList
+            using collectJob() (without mutex protection),
+            and periodically merge them using mergeResults() (under mutex protection).
+            In this case, it must give back the job using recycleJob() (under mutex protection).
+
             \todo Do we need more restrictions for makeJob(), finishJob()?
             Requiring them to run in the thread that called run() requires implementors to do some kind of queue,
             but would allow callbacks generated from finishJob() to be generated from a fixed thread. */
@@ -84,6 +95,12 @@ namespace game { namespace sim {
             \return handle to result list */
         const ResultList& resultList() const;
 
+        /** Get number of allocated jobs.
+            Jobs are recycled (see run()), so this is bounded by the number of simulations in flight at a time,
+            not by the total number of simulations.
+            \return number of Job objects allocated so far */
+        size_t getNumAllocatedJobs() const;
+
         /** Set update interval.
             You will receive sig_update updates about every so many milliseconds.
             \param interval Interval */
@@ -134,12 +151,42 @@ namespace game { namespace sim {
             \param p Job created by makeJob(). */
         static void runJob(Job* p);
 
+        /** Finish a job into a worker-local result list.
+            Call from your run() instead of finishJob(), see there.
+            Does not need mutex protection.
+            \param job     Job created by makeJob(), you must have called runJob().
+            \param partial Worker-local result list */
+        static void collectJob(const Job& job, ResultList& partial);
+
+        /** Give back a job.
+            Call under mutex protection after collectJob().
+            \param p Job created by makeJob(). Runner takes ownership and will reuse it. */
+        void recycleJob(Job* p);
+
+        /** Check whether a worker should merge its results.
+            Call under mutex protection.
+            Workers should merge their results about once per update interval (setUpdateInterval()).
+            \param [in,out] lastMerge Time of the worker's last merge; updated if this function returns true
+            \return true if worker should merge now */
+        bool checkMerge(uint32_t& lastMerge) const;
+
+        /** Merge worker-local results.
+            Call under mutex protection.
+            Raises sig_update according to the update interval, like finishJob().
+            \param [in,out] partial Worker-local result list; will be empty afterwards */
+        void mergeResults(ResultList& partial);
+
      private:
         const Setup& m_setup;
         const Configuration& m_options;
         const game::spec::ShipList& m_shipList;
         const game::config::HostConfiguration& m_config;
         const game::vcr::flak::Configuration& m_flakConfiguration;
+
+        /** Precomputed FLAK environment.
+            Created in FLAK mode only; shared by all jobs. */
+        std::auto_ptr<game::vcr::flak::CompiledEnvironment> m_flakEnvironment;
+
         afl::sys::LogListener& m_log;
         util::RandomNumberGenerator& m_rng;
 
@@ -164,6 +211,14 @@ namespace game { namespace sim {
 
         /** Result accumulator. */
         ResultList m_resultList;
+
+        /** Finished jobs for reuse. */
+        afl::container::PtrVector<Job> m_jobPool;
+
+        /** Number of Job objects allocated. */
+        size_t m_numAllocatedJobs;
+
+        void checkUpdate();
     };
 
 } }
@@ -182,7 +237,8 @@ class game::sim::Runner::Job {
     friend class Runner;
 
     inline Job(const Setup& setup, const Configuration& opts, const game::spec::ShipList& list, const game::config::HostConfiguration& config,
-               const game::vcr::flak::Configuration& flakConfig, afl::sys::LogListener& log, util::RandomNumberGenerator& rng, size_t serial);
+               const game::vcr::flak::Configuration& flakConfig, const game::vcr::flak::Environment* flakEnv, afl::sys::LogListener& log, util::RandomNumberGenerator& rng, size_t serial);
+    inline void reset(util::RandomNumberGenerator& rng, size_t serial);
     inline void run();
     inline bool writeBack(ResultList& list) const;
     inline size_t getSeriesLength() const;
@@ -193,6 +249,7 @@ class game::sim::Runner::Job {
     const game::spec::ShipList& m_shipList;
     const game::config::HostConfiguration& m_config;
     const game::vcr::flak::Configuration& m_flakConfiguration;
+    const game::vcr::flak::Environment* m_flakEnvironment;
     afl::sys::LogListener& m_log;
     util::RandomNumberGenerator m_rng;
     Result m_result;
@@ -58,16 +58,25 @@ game::sim::Setup&
 game::sim::Setup::operator=(const Setup& other)
 {
     if (&other != this) {
-        // Clear
-        m_ships.clear();
-        m_planet.reset();
-
-        // Copy other
-        m_ships.reserve(other.m_ships.size());
-        for (Slot_t i = 0, n = other.m_ships.size(); i < n; ++i) {
+        // Reuse existing objects where possible.
+        // The simulator resets its working copy for every fight; this avoids reallocating all units.
+        const Slot_t n = other.m_ships.size();
+        while (m_ships.size() > n) {
+            m_ships.popBack();
+        }
+        for (Slot_t i = 0, have = m_ships.size(); i < have; ++i) {
+            *m_ships[i] = *other.m_ships[i];
+        }
+        m_ships.reserve(n);
+        for (Slot_t i = m_ships.size(); i < n; ++i) {
             m_ships.pushBackNew(new Ship(*other.m_ships[i]));
         }
-        if (other.m_planet.get() != 0) {
+
+        if (other.m_planet.get() == 0) {
+            m_planet.reset();
+        } else if (m_planet.get() != 0) {
+            *m_planet = *other.m_planet;
+        } else {
             m_planet.reset(new Planet(*other.m_planet));
         }
         m_structureChanged = true;
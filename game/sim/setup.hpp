@@ -58,6 +58,8 @@ namespace game { namespace sim {
         ~Setup();
 
         /** Assign another setup.
+            Existing Ship and Planet objects are reused where possible, so pointers to them remain valid,
+            but refer to the new content.
             \param other Other setup */
         Setup& operator=(const Setup& other);
 
@@ -118,6 +118,23 @@ game::sim::UnitResult::addResult(const Planet& oldPlanet, const Planet& newPlane
     add(m_minFightersAboard, stat.getMinFightersAboard(), res);
 }
 
+// Merge another unit result.
+void
+game::sim::UnitResult::merge(const UnitResult& other)
+{
+    merge(m_numTorpedoesFired,     other.m_numTorpedoesFired);
+    merge(m_numFightersLost,       other.m_numFightersLost);
+    merge(m_damage,                other.m_damage);
+    merge(m_shield,                other.m_shield);
+    merge(m_crewLeftOrDefenseLost, other.m_crewLeftOrDefenseLost);
+    merge(m_numTorpedoHits,        other.m_numTorpedoHits);
+    merge(m_minFightersAboard,     other.m_minFightersAboard);
+
+    m_numFights    += other.m_numFights;
+    m_numFightsWon += other.m_numFightsWon;
+    m_numCaptures  += other.m_numCaptures;
+}
+
 // Add single result value.
 void
 game::sim::UnitResult::add(Item& it, int32_t value, const Result& w)
@@ -139,6 +156,21 @@ game::sim::UnitResult::add(Item& it, int32_t value, const Result& w)
     it.totalScaled += value * w.this_battle_weight;
 }
 
+// Merge single result value.
+void
+game::sim::UnitResult::merge(Item& it, const Item& other)
+{
+    if (it.min > other.min) {
+        it.min = other.min;
+        it.minSpecimen = other.minSpecimen;
+    }
+    if (it.max < other.max) {
+        it.max = other.max;
+        it.maxSpecimen = other.maxSpecimen;
+    }
+    it.totalScaled += other.totalScaled;
+}
+
 // Change weight proportionally.
 void
 game::sim::UnitResult::changeWeight(Item& it, int32_t oldWeight, int32_t newWeight)
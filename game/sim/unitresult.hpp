@@ -76,6 +76,13 @@ namespace game { namespace sim {
             \param res       [in] Battle result record (needed for this_battle_index, this_battle_weight) */
         void addResult(const Planet& oldPlanet, const Planet& newPlanet, const game::vcr::Statistic& stat, const Result& res);
 
+        /** Merge another unit result.
+            Produces the same result as if the other object's addResult() calls had been made on this object
+            (except for choice of specimen if a value appears in both).
+            Both objects must have at least one result, and use the same total weight.
+            \param other [in] Other unit result */
+        void merge(const UnitResult& other);
+
      private:
         int m_numFightsWon;                  ///< Number of times this ship survived. ex won.
         int m_numFights;                     ///< Number of times this ship fought. ex fought.
@@ -89,6 +96,7 @@ namespace game { namespace sim {
         Item m_minFightersAboard;            ///< Minimum fighters on unit at any one time (ships and planets). ex min_fighters_aboard.
 
         static void add(Item& it, int32_t value, const Result& w);
+        static void merge(Item& it, const Item& other);
         static void changeWeight(Item& it, int32_t oldWeight, int32_t newWeight);
     };
 
@@ -490,6 +490,7 @@ game::v3::DirectoryLoader::doLoadCurrentTurn(Game& game, int player, Root& root,
 
     // Util
     Parser mp(tx, log, game, player, root, game::actions::mustHaveShipList(session), session.world().atomTable());
+    mp.setNumThreads(session.getSystemInformation().numProcessors);
     {
         Ptr<Stream> s = dir.openFileNT(Format("util%d.dat", player), FileSystem::OpenRead);
         if (s.get() != 0) {
@@ -5,13 +5,23 @@
 
 #include "game/v3/parser.hpp"
 #include "afl/charset/utf8charset.hpp"
+#include "afl/string/format.hpp"
+#include "afl/sys/time.hpp"
+#include "game/parser/batchparser.hpp"
 #include "game/parser/datainterface.hpp"
 #include "game/parser/messageparser.hpp"
 #include "game/turn.hpp"
 #include "game/v3/udata/parser.hpp"
 
+using afl::string::Format;
 using afl::string::strTrim;
 using afl::string::strCaseCompare;
+using afl::sys::LogListener;
+using afl::sys::Time;
+
+namespace {
+    const char*const LOG_NAME = "game.v3.parser";
+}
 
 /*
  *  DataInterface implementation for real game
@@ -89,7 +99,8 @@ game::v3::Parser::Parser(afl::string::Translator& tx, afl::sys::LogListener& log
       m_player(player),
       m_root(root),
       m_shipList(shipList),
-      m_atomTable(atomTable)
+      m_atomTable(atomTable),
+      m_numThreads(1)
 { }
 
 // Load util.dat file.
@@ -108,6 +119,13 @@ game::v3::Parser::handleNoUtilData()
     game::v3::udata::Parser(m_game, m_player, m_root.hostConfiguration(), m_root.hostVersion(), m_shipList, m_atomTable, charset, m_translator, m_log).handleNoUtilData();
 }
 
+// Set number of threads for message parsing.
+void
+game::v3::Parser::setNumThreads(size_t numThreads)
+{
+    m_numThreads = numThreads;
+}
+
 // Parse messages.
 void
 game::v3::Parser::parseMessages(afl::io::Stream& in, game::msg::Inbox& inbox, afl::charset::Charset& charset)
@@ -120,6 +138,7 @@ game::v3::Parser::parseMessages(afl::io::Stream& in, game::msg::Inbox& inbox, af
     // a regular client works fine with this restriction.
 
     // Load message definitions
+    const uint32_t startTime = Time::getTickCounter();
     game::parser::MessageParser p;
     p.load(in, m_translator, m_log);
 
@@ -141,15 +160,26 @@ game::v3::Parser::parseMessages(afl::io::Stream& in, game::msg::Inbox& inbox, af
         afl::sys::LogListener& m_log;
     };
 
-    // Parse messages
+    // Fetch message texts
+    const uint32_t loadTime = Time::getTickCounter();
+    const size_t numMessages = inbox.getNumMessages();
+    std::vector<String_t> texts;
+    texts.reserve(numMessages);
+    for (size_t i = 0; i < numMessages; ++i) {
+        texts.push_back(inbox.getMessageText(i, m_translator, m_root.playerList()));
+    }
+
+    // Parse messages. This does not modify the game and can therefore run in parallel.
+    const uint32_t prepareTime = Time::getTickCounter();
     DataInterface gdi(m_player, m_root, m_shipList, m_translator);
-    for (size_t i = 0, n = inbox.getNumMessages(); i < n; ++i) {
-        Consumer c(*this, i);
+    afl::container::PtrVector<game::parser::BatchParser::Infos_t> infos;
+    game::parser::BatchParser(p, gdi, m_translator, m_log, m_numThreads).parse(texts, m_game.currentTurn().getTurnNumber(), infos);
 
-        // Normal parsing
-        String_t text = inbox.getMessageText(i, m_translator, m_root.playerList());
-        afl::container::PtrVector<game::parser::MessageInformation> info;
-        p.parseMessage(text, gdi, m_game.currentTurn().getTurnNumber(), info, m_translator, m_log);
+    // Apply results in message order
+    const uint32_t parseTime = Time::getTickCounter();
+    for (size_t i = 0; i < numMessages; ++i) {
+        Consumer c(*this, i);
+        const game::parser::BatchParser::Infos_t& info = *infos[i];
         c.addMessageInformation(info);
 
         // Determine reference
@@ -165,4 +195,10 @@ game::v3::Parser::parseMessages(afl::io::Stream& in, game::msg::Inbox& inbox, af
         // Prepare binary messages
         inbox.receiveMessageData(i, c, m_game.teamSettings(), false, charset);
     }
+
+    const uint32_t applyTime = Time::getTickCounter();
+    m_log.write(LogListener::Trace, LOG_NAME,
+                Format("Parsed %d messages using %d threads: definitions %d ms, texts %d ms, parse %d ms, apply %d ms",
+                       numMessages, m_numThreads,
+                       loadTime - startTime, prepareTime - loadTime, parseTime - prepareTime, applyTime - parseTime));
 }
@@ -42,8 +42,17 @@ namespace game { namespace v3 {
         /** Handle absence of util.dat file. */
         void handleNoUtilData();
 
+        /** Set number of threads for message parsing.
+            By default, messages are parsed in the calling thread.
+            \param numThreads Number of threads (0 or 1 to use just the calling thread) */
+        void setNumThreads(size_t numThreads);
+
         /** Parse messages.
             This will also scan for binary data transmissions.
+
+            Messages are parsed in parallel (see setNumThreads()),
+            but results are applied to the game in message order, in the calling thread.
+            Timing of the individual phases is logged.
             \param in The msgparse.ini file
             \param inbox Loaded inbox
             \param charset Character set */
@@ -59,6 +68,7 @@ namespace game { namespace v3 {
         Root& m_root;
         game::spec::ShipList& m_shipList;
         util::AtomTable& m_atomTable;
+        size_t m_numThreads;
     };
 
 } }
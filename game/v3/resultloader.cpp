@@ -280,6 +280,7 @@ game::v3::ResultLoader::doLoadCurrentTurn(Game& game, int player, game::Root& ro
 
     // Util
     Parser mp(tx, log, game, player, root, game::actions::mustHaveShipList(session), session.world().atomTable());
+    mp.setNumThreads(session.getSystemInformation().numProcessors);
     {
         Ptr<Stream> file = root.gameDirectory().openFileNT(Format("util%d.dat", player), afl::io::FileSystem::OpenRead);
         if (file.get() != 0) {
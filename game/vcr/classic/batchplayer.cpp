@@ -0,0 +1,124 @@
+/**
+  *  \file game/vcr/classic/batchplayer.cpp
+  *  \brief Class game::vcr::classic::BatchPlayer
+  */
+
+#include <memory>
+#include "game/vcr/classic/batchplayer.hpp"
+#include "game/vcr/classic/algorithm.hpp"
+#include "game/vcr/classic/battle.hpp"
+#include "game/vcr/classic/nullvisualizer.hpp"
+
+namespace {
+    /* Number of battle types (size of enum Type) */
+    const size_t NUM_TYPES = game::vcr::classic::NuHost + 1;
+}
+
+/*
+ *  Worker
+ *
+ *  Each thread has its own worker.
+ *  It owns a visualizer and the algorithms, so these are not shared between threads.
+ */
+
+class game::vcr::classic::BatchPlayer::Worker : public util::WorkQueue::Worker {
+ public:
+    Worker(BatchPlayer& parent)
+        : m_parent(parent), m_visualizer()
+        { }
+
+    virtual void process(size_t index);
+
+ private:
+    BatchPlayer& m_parent;
+    NullVisualizer m_visualizer;
+    std::auto_ptr<Algorithm> m_algorithms[NUM_TYPES];
+
+    Algorithm* getAlgorithm(Type type);
+    void playBattle(Battle& b, Result& result);
+};
+
+void
+game::vcr::classic::BatchPlayer::Worker::process(size_t index)
+{
+    playBattle(*(*m_parent.m_pBattles)[index], (*m_parent.m_pResults)[index]);
+}
+
+game::vcr::classic::Algorithm*
+game::vcr::classic::BatchPlayer::Worker::getAlgorithm(Type type)
+{
+    size_t slot = static_cast<size_t>(type);
+    if (slot >= NUM_TYPES) {
+        return 0;
+    }
+    if (m_algorithms[slot].get() == 0) {
+        m_algorithms[slot].reset(Battle::createAlgorithmForType(type, m_visualizer, m_parent.m_config, m_parent.m_shipList));
+    }
+    return m_algorithms[slot].get();
+}
+
+void
+game::vcr::classic::BatchPlayer::Worker::playBattle(Battle& b, Result& result)
+{
+    // Same sequence as Battle::prepareResult()
+    Algorithm* algo = getAlgorithm(b.getType());
+    Object left(b.left());
+    Object right(b.right());
+    uint16_t seed(b.getSeed());
+    if (algo == 0 || !algo->setCapabilities(b.getCapabilities()) || algo->checkBattle(left, right, seed)) {
+        // Cannot be played; let the battle record that
+        result.result += Invalid;
+        b.prepareResult(m_parent.m_config, m_parent.m_shipList, Battle::NeedQuickOutcome);
+    } else {
+        algo->playBattle(left, right, seed);
+        algo->doneBattle(left, right);
+        result.result = algo->getResult();
+        result.statistic[LeftSide] = algo->getStatistic(LeftSide);
+        result.statistic[RightSide] = algo->getStatistic(RightSide);
+        b.setResult(left, right, result.result);
+    }
+}
+
+
+class game::vcr::classic::BatchPlayer::WorkerFactory : public util::WorkQueue::WorkerFactory {
+ public:
+    WorkerFactory(BatchPlayer& parent)
+        : m_parent(parent)
+        { }
+    virtual Worker* createWorker()
+        { return new Worker(m_parent); }
+ private:
+    BatchPlayer& m_parent;
+};
+
+
+/*
+ *  BatchPlayer
+ */
+
+game::vcr::classic::BatchPlayer::BatchPlayer(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, size_t numThreads)
+    : m_config(config),
+      m_shipList(shipList),
+      m_queue(numThreads, "game.vcr.batch"),
+      m_pBattles(0),
+      m_pResults(0)
+{ }
+
+game::vcr::classic::BatchPlayer::~BatchPlayer()
+{ }
+
+void
+game::vcr::classic::BatchPlayer::play(const std::vector<Battle*>& battles, std::vector<Result>& results)
+{
+    // Prepare parameters
+    results.clear();
+    results.resize(battles.size());
+    m_pBattles = &battles;
+    m_pResults = &results;
+
+    WorkerFactory f(*this);
+    m_queue.run(battles.size(), f);
+
+    m_pBattles = 0;
+    m_pResults = 0;
+}
@@ -0,0 +1,75 @@
+/**
+  *  \file game/vcr/classic/batchplayer.hpp
+  *  \brief Class game::vcr::classic::BatchPlayer
+  */
+#ifndef C2NG_GAME_VCR_CLASSIC_BATCHPLAYER_HPP
+#define C2NG_GAME_VCR_CLASSIC_BATCHPLAYER_HPP
+
+#include <vector>
+#include "game/config/hostconfiguration.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/vcr/classic/types.hpp"
+#include "game/vcr/statistic.hpp"
+#include "util/workqueue.hpp"
+
+namespace game { namespace vcr { namespace classic {
+
+    class Battle;
+
+    /** Batch player for classic combat.
+        Plays many battles at once, to evaluate a complete result file.
+
+        Battles are distributed to a number of threads.
+        Each thread has its own NullVisualizer, and keeps one Algorithm instance per battle type
+        that is re-used for all battles of that type it plays.
+
+        Results are stored in the battles (Battle::setResult()),
+        and reported as a compact array containing battle results and statistics.
+
+        The configuration and ship list are accessed by all threads and must not be modified while play() runs. */
+    class BatchPlayer {
+     public:
+        /** Result of one battle. */
+        struct Result {
+            BattleResult_t result;      ///< Battle result (Algorithm::getResult()). Contains Invalid if the battle cannot be played.
+            Statistic statistic[2];     ///< Statistics for each side (Algorithm::getStatistic(), index is a Side). Default-initialized if battle cannot be played.
+
+            Result()
+                : result()
+                { }
+        };
+
+        /** Constructor.
+            \param config      Host configuration
+            \param shipList    Ship list
+            \param numThreads  Number of threads to use (0 or 1 to play all battles in the calling thread) */
+        BatchPlayer(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, size_t numThreads);
+
+        /** Destructor. */
+        ~BatchPlayer();
+
+        /** Play battles.
+            Plays all battles, and stores their results.
+            A battle that already has a result is played again to obtain its statistics; its result is not modified.
+            Battles must be distinct objects.
+            \param [in]  battles  Battles to play; must not be null
+            \param [out] results  Results, one per battle, in the same order */
+        void play(const std::vector<Battle*>& battles, std::vector<Result>& results);
+
+     private:
+        class Worker;
+        friend class Worker;
+        class WorkerFactory;
+
+        const game::config::HostConfiguration& m_config;
+        const game::spec::ShipList& m_shipList;
+        util::WorkQueue m_queue;
+
+        // Parameters for play()
+        const std::vector<Battle*>* m_pBattles;
+        std::vector<Result>* m_pResults;
+    };
+
+} } }
+
+#endif
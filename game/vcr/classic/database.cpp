@@ -5,6 +5,7 @@
 
 #include "game/vcr/classic/database.hpp"
 #include "game/v3/structures.hpp"
+#include "game/vcr/classic/batchplayer.hpp"
 #include "game/vcr/classic/types.hpp"
 
 namespace gt = game::v3::structures;
@@ -357,3 +358,19 @@ game::vcr::classic::Database::save(afl::io::Stream& out, size_t first, size_t nu
         out.fullWrite(afl::base::fromObject(vcr));
     }
 }
+
+void
+game::vcr::classic::Database::prepareResults(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int /*resultLevel*/, size_t numThreads)
+{
+    // Classic battles have only one result level, so just play everything that has no result yet
+    std::vector<Battle*> battles;
+    for (size_t i = 0, n = m_battles.size(); i < n; ++i) {
+        if (m_battles[i]->getResult().empty()) {
+            battles.push_back(m_battles[i]);
+        }
+    }
+    if (!battles.empty()) {
+        std::vector<BatchPlayer::Result> results;
+        BatchPlayer(config, shipList, numThreads).play(battles, results);
+    }
+}
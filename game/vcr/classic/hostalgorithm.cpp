@@ -104,11 +104,9 @@ namespace {
 	11,	8,	12,	2,	7,	6,	4,	13
     };
 
-    void advance(int16_t& value, int change)
-    {
-        // Warning avoider
-        value = static_cast<int16_t>(value + change);
-    }
+    /* Events produced by HostAlgorithm::moveFighters() */
+    const uint8_t FighterShootsEvent = 1;
+    const uint8_t FighterLandsEvent = 2;
 
     void advance(uint8_t& value, int change)
     {
@@ -760,47 +758,33 @@ game::vcr::classic::HostAlgorithm::fighterStuff()
 {
     // ex VcrPlayerTHost::fighterStuff(), ccvcr.pas:MoveFighters, FighterShootL, FighterShootR, FighterStuff
 
-    // This used to process all movements, then all firings.
-    // However, since all these processes are 100% deterministic, order does not matter and I have fused movement and firing, for a little bit of speed.
+    // This used to be a single loop moving each fighter and immediately processing its events.
+    // Movement does not depend on the events, so it is now computed for a whole side in one go
+    // (moveFighters(), which the compiler can vectorize); events are then processed in the original order.
+    uint8_t leftEvents[VCR_MAX_FTRS];
+    uint8_t rightEvents[VCR_MAX_FTRS];
+    moveFighters(m_status[LeftSide], m_status[RightSide], leftEvents);
+    moveFighters(m_status[RightSide], m_status[LeftSide], rightEvents);
+
     for (int i = 0; i < VCR_MAX_FTRS; ++i) {
         // left side
-        if (m_status[LeftSide].m_fighterStatus[i] == FighterAttacks) {
-            if (m_status[LeftSide].m_fighterX[i] > m_status[RightSide].m_objectX + 10) {
-                m_status[LeftSide].m_fighterStatus[i] = FighterReturns;
-                advance(m_status[LeftSide].m_fighterX[i], -4);
-            } else {
-                advance(m_status[LeftSide].m_fighterX[i], +4);
-                fighterShoot(m_status[LeftSide], m_status[RightSide], i);
-            }
-        } else if (m_status[LeftSide].m_fighterStatus[i] == FighterReturns) {
-            if (m_status[LeftSide].m_fighterX[i] < m_status[LeftSide].m_objectX) {
-                m_status[LeftSide].m_obj.addFighters(+1);
-                visualizer().landFighter(*this, LeftSide, i);
-                m_status[LeftSide].m_fighterStatus[i] = FighterIdle;
-                --m_status[LeftSide].m_numFightersOut;
-            } else {
-                advance(m_status[LeftSide].m_fighterX[i], -4);
-            }
+        if ((leftEvents[i] & FighterShootsEvent) != 0) {
+            fighterShoot(m_status[LeftSide], m_status[RightSide], i);
+        }
+        if ((leftEvents[i] & FighterLandsEvent) != 0) {
+            m_status[LeftSide].m_obj.addFighters(+1);
+            visualizer().landFighter(*this, LeftSide, i);
+            --m_status[LeftSide].m_numFightersOut;
         }
 
         // right side
-        if (m_status[RightSide].m_fighterStatus[i] == FighterAttacks) {
-            if (m_status[RightSide].m_fighterX[i] < m_status[LeftSide].m_objectX - 10) {
-                m_status[RightSide].m_fighterStatus[i] = FighterReturns;
-                advance(m_status[RightSide].m_fighterX[i], +4);
-            } else {
-                advance(m_status[RightSide].m_fighterX[i], -4);
-                fighterShoot(m_status[RightSide], m_status[LeftSide], i);
-            }
-        } else if (m_status[RightSide].m_fighterStatus[i] == FighterReturns) {
-            if (m_status[RightSide].m_fighterX[i] > m_status[RightSide].m_objectX) {
-                m_status[RightSide].m_obj.addFighters(+1);
-                visualizer().landFighter(*this, RightSide, i);
-                m_status[RightSide].m_fighterStatus[i] = FighterIdle;
-                --m_status[RightSide].m_numFightersOut;
-            } else {
-                advance(m_status[RightSide].m_fighterX[i], +4);
-            }
+        if ((rightEvents[i] & FighterShootsEvent) != 0) {
+            fighterShoot(m_status[RightSide], m_status[LeftSide], i);
+        }
+        if ((rightEvents[i] & FighterLandsEvent) != 0) {
+            m_status[RightSide].m_obj.addFighters(+1);
+            visualizer().landFighter(*this, RightSide, i);
+            --m_status[RightSide].m_numFightersOut;
         }
     }
 
@@ -837,6 +821,42 @@ game::vcr::classic::HostAlgorithm::fighterStuff()
     }
 }
 
+/** Move fighters of one side.
+    Left fighters attack in positive X direction, right fighters in negative direction.
+    An attacking fighter that has passed the opponent turns around; a returning fighter that has reached its base lands.
+    This function only updates fighter positions and status; it reports the fighter's further actions in \c events,
+    to be processed by the caller.
+
+    This loop is written without branches or calls so the compiler can vectorize it.
+
+    \param [in,out] st     Fighters' unit
+    \param [in]     opp    Opponent
+    \param [out]    events Events (FighterShootsEvent, FighterLandsEvent) */
+void
+game::vcr::classic::HostAlgorithm::moveFighters(Status& st, const Status& opp, uint8_t (&events)[VCR_MAX_FTRS])
+{
+    // Mirror coordinates for right side so that attacking always means moving in positive direction
+    const int dir = (st.m_side == LeftSide ? +1 : -1);
+    const int turnX = dir*opp.m_objectX + 10;
+    const int homeX = dir*st.m_objectX;
+    const int targetX = opp.m_objectX;
+    for (int i = 0; i < VCR_MAX_FTRS; ++i) {
+        const int status = st.m_fighterStatus[i];
+        const int x = st.m_fighterX[i];
+        const bool attacks = (status == FighterAttacks);
+        const bool returns = (status == FighterReturns);
+        const bool turns = attacks & (dir*x > turnX);
+        const bool lands = returns & (dir*x < homeX);
+        const bool forward = attacks & !turns;
+        const bool backward = turns | (returns & !lands);
+        const int16_t newX = static_cast<int16_t>(x + dir*4*(int(forward) - int(backward)));
+        st.m_fighterX[i] = newX;
+        st.m_fighterStatus[i] = static_cast<uint8_t>(turns ? int(FighterReturns) : lands ? int(FighterIdle) : status);
+        events[i] = static_cast<uint8_t>((forward && std::abs(newX - targetX) < 20 ? FighterShootsEvent : 0)
+                                         | (lands ? FighterLandsEvent : 0));
+    }
+}
+
 /** Recharge beams of one side.
     Beams recharge randomly up to level 100.
     \param st Unit */
@@ -845,10 +865,24 @@ game::vcr::classic::HostAlgorithm::rechargeBeams(Status& st)
 {
     // ex VcrPlayerTHost::rechargeBeams, ccvcr.pas:RechargeBeams
     const int mx = st.m_obj.getNumBeams();
+    const int rate = st.m_obj.getBeamChargeRate();
+
+    // Random numbers are consumed for each beam, no matter whether it is charged.
+    uint8_t charge[VCR_MAX_BEAMS];
+    for (int i = 0; i < mx; ++i) {
+        charge[i] = (getRandom_1_100() > 50);
+    }
+
+    // Charge; vectorizable
+    for (int i = 0; i < mx; ++i) {
+        const int j = st.m_beamStatus[i];
+        charge[i] = static_cast<uint8_t>(charge[i] & (j < 100));
+        st.m_beamStatus[i] = static_cast<uint8_t>(j + (charge[i] ? rate : 0));
+    }
+
+    // Report
     for (int i = 0; i < mx; ++i) {
-        register int j = st.m_beamStatus[i];
-        if (getRandom_1_100() > 50 && j < 100) {
-            st.m_beamStatus[i] = static_cast<int8_t>(j + st.m_obj.getBeamChargeRate());
+        if (charge[i]) {
             visualizer().updateBeam(*this, st.m_side, i);
         }
     }
@@ -112,6 +112,7 @@ namespace game { namespace vcr { namespace classic {
         inline void fighterShoot(Status& st, Status& opp, int i);
         inline void killFighter(Status& st, int i);
         inline void fighterStuff();
+        static void moveFighters(Status& st, const Status& opp, uint8_t (&events)[VCR_MAX_FTRS]);
 
         void rechargeBeams(Status& st);
         void fireBeam(Status& st, Status& opp, int which);
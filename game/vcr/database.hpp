@@ -12,6 +12,10 @@
 #include "afl/io/stream.hpp"
 #include "game/config/hostconfiguration.hpp"
 
+namespace game { namespace spec {
+    class ShipList;
+} }
+
 namespace game { namespace vcr {
 
     class Battle;
@@ -34,6 +38,15 @@ namespace game { namespace vcr {
             \param config Host configuration
             \param cs     Character set */
         virtual void save(afl::io::Stream& out, size_t first, size_t num, const game::config::HostConfiguration& config, afl::charset::Charset& cs) = 0;
+
+        /** Prepare results of all battles.
+            Has the same effect as calling Battle::prepareResult() for each battle,
+            but can be implemented more efficiently, e.g. by playing multiple battles in parallel.
+            \param config      Host configuration
+            \param shipList    Ship list
+            \param resultLevel Requested result level (Battle::NeedQuickOutcome, Battle::NeedCompleteResult, or combination thereof)
+            \param numThreads  Number of threads to use (0 or 1 to use just the calling thread) */
+        virtual void prepareResults(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel, size_t numThreads) = 0;
     };
 
 } }
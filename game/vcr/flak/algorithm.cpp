@@ -15,6 +15,7 @@
 #include <cassert>
 #include <algorithm>
 #include <cmath>
+#include <functional>
 #include "game/vcr/flak/algorithm.hpp"
 #include "afl/base/countof.hpp"
 #include "game/playerset.hpp"
@@ -84,6 +85,12 @@ struct game::vcr::flak::Algorithm::Ship {
         bool    FireOnAttackFighters;
         int     FighterKillOdds;
         int     FighterFiringRange;
+        // Weapon/race information, cached to avoid Environment calls in the main loop
+        int     BeamKillPower;
+        int     BeamDamagePower;
+        int     TorpedoKillPower;
+        int     TorpedoDamagePower;
+        int     PlayerRace;
         Config(const game::vcr::flak::Object& d, const Environment& env);
     };
     const Config config;
@@ -196,6 +203,14 @@ namespace {
      *  Formulas
      */
 
+    /* Grid cell for fighter interception (floor division, also for negative coordinates). */
+    std::pair<int32_t, int32_t> getInterceptCell(const Position& pos)
+    {
+        const int32_t R = FLAK_FIGHTER_INTERCEPT_RANGE;
+        return std::make_pair((pos.x >= 0 ? pos.x : pos.x - (R-1)) / R,
+                              (pos.y >= 0 ? pos.y : pos.y - (R-1)) / R);
+    }
+
     int getExperienceConfiguration(const Environment& env, Environment::ExperienceOption index, int level, int player, int min, int max)
     {
         return std::max(min, std::min(max, env.getExperienceConfiguration(index, level, player)));
@@ -299,7 +314,7 @@ namespace {
     }
 
     /** Check whether /we/ can attack /they/. */
-    bool canStillAttack(const game::vcr::flak::Algorithm::Ship& we, const game::vcr::flak::Algorithm::Ship& they, const Environment& env)
+    bool canStillAttack(const game::vcr::flak::Algorithm::Ship& we, const game::vcr::flak::Algorithm::Ship& they)
     {
         // ex flak.pas:CanStillAttack
         int torpc = we.data.numLaunchers;
@@ -307,10 +322,10 @@ namespace {
 
         if (they.isPlanet()) {
             /* discount death rays against planet */
-            if (torpc && env.getTorpedoDamagePower(we.data.torpedoType) == 0) {
+            if (torpc && we.config.TorpedoDamagePower == 0) {
                 torpc = 0;
             }
-            if (beamc && env.getBeamDamagePower(we.data.beamType) == 0
+            if (beamc && we.config.BeamDamagePower == 0
                 && they.status.numFighters == 0
                 && they.status.numFightersLaunched == 0)
             {
@@ -367,7 +382,12 @@ game::vcr::flak::Algorithm::Ship::Config::Config(const game::vcr::flak::Object&
       BeamFiringRange     (env.getConfiguration(Environment::BeamFiringRange,      d.getOwner())),
       FireOnAttackFighters(env.getConfiguration(Environment::FireOnAttackFighters)),
       FighterKillOdds     (env.getConfiguration(Environment::FighterKillOdds,      d.getOwner())),
-      FighterFiringRange  (env.getConfiguration(Environment::FighterFiringRange,   d.getOwner()))
+      FighterFiringRange  (env.getConfiguration(Environment::FighterFiringRange,   d.getOwner())),
+      BeamKillPower       (env.getBeamKillPower(d.getBeamType())),
+      BeamDamagePower     (env.getBeamDamagePower(d.getBeamType())),
+      TorpedoKillPower    (env.getTorpedoKillPower(d.getTorpedoType())),
+      TorpedoDamagePower  (env.getTorpedoDamagePower(d.getTorpedoType())),
+      PlayerRace          (env.getPlayerRaceNumber(d.getOwner()))
 { }
 
 game::vcr::flak::Algorithm::Ship::Data::Data(size_t shipIndex, const game::vcr::flak::Object& d)
@@ -591,7 +611,9 @@ game::vcr::flak::Algorithm::Algorithm(const Setup& b, const Environment& env)
       m_standoffDistance(env.getConfiguration(Environment::StandoffDistance)),
       m_unusedObjects(), m_objectId(),
       m_seed(b.getSeed()), m_originalSeed(b.getSeed()), m_time(0), m_isTerminated(false),
-      m_fleetGCTorpedoes()
+      m_fleetGCTorpedoes(),
+      m_interceptBuckets(),
+      m_interceptCandidates()
 {
     // ex FlakBattle::FlakBattle
     /* copy fleets */
@@ -674,7 +696,7 @@ game::vcr::flak::Algorithm::init(const Environment& env, Visualizer& vis)
 
     renderAll(vis);
     for (size_t i = 0; i < m_fleets.size(); ++i) {
-        chooseEnemy(*m_fleets[i], env, vis, i);
+        chooseEnemy(*m_fleets[i], vis, i);
     }
 }
 
@@ -696,7 +718,7 @@ game::vcr::flak::Algorithm::playCycle(const Environment& env, Visualizer& vis)
     // choose enemy
     if (m_time != 0 && m_time % FLAK_CHOOSE_ENEMY_TIME == 0) {
         for (size_t i = 0; i < m_fleets.size(); ++i) {
-            chooseEnemy(*m_fleets[i], env, vis, i);
+            chooseEnemy(*m_fleets[i], vis, i);
         }
     }
 
@@ -707,17 +729,17 @@ game::vcr::flak::Algorithm::playCycle(const Environment& env, Visualizer& vis)
 
     // fire torps
     for (size_t i = 0; i < m_fleets.size(); ++i) {
-        fireTorps(*m_fleets[i], env, vis);
+        fireTorps(*m_fleets[i], vis);
     }
 
     // fire beams. We choose a random fleet to fire first to achieve
     // random distribution of hits.
     size_t fleet_off = random(int(m_fleets.size()));
     for (size_t i = fleet_off; i < m_fleets.size(); ++i) {
-        fireBeams(*m_fleets[i], env, vis);
+        fireBeams(*m_fleets[i], vis);
     }
     for (size_t i = 0; i < fleet_off; ++i) {
-        fireBeams(*m_fleets[i], env, vis);
+        fireBeams(*m_fleets[i], vis);
     }
 
     // fighters fire. We choose a random player to fire first to
@@ -772,7 +794,7 @@ game::vcr::flak::Algorithm::playCycle(const Environment& env, Visualizer& vis)
 
     // move units
     for (size_t i = 0; i < m_fleets.size(); ++i) {
-        computeNewPosition(*m_fleets[i], env, vis, i);
+        computeNewPosition(*m_fleets[i], vis, i);
     }
     for (size_t i = 0; i < m_fleets.size(); ++i) {
         Fleet& fleet = *m_fleets[i];
@@ -1135,10 +1157,9 @@ game::vcr::flak::Algorithm::moveObjectTowards(Object& obj, Position toPos)
 /** Compute torpedo launch limit for attacker.
     \param attacker    the ship whose limit we're thinking about. The limit will be updated in-place
     \param enemy       desired enemy
-    \param num_torpers total number of active torpers in attacking fleet
-    \param env         Environment*/
+    \param num_torpers total number of active torpers in attacking fleet */
 void
-game::vcr::flak::Algorithm::computeTorpLimit(Ship& attacker, const Ship& enemy, int num_torpers, const Environment& env) const
+game::vcr::flak::Algorithm::computeTorpLimit(Ship& attacker, const Ship& enemy, int num_torpers) const
 {
     // ex flak.pas:ComputeTorpLimit
     attacker.status.torpedoLimit = attacker.data.numLaunchers;
@@ -1148,8 +1169,8 @@ game::vcr::flak::Algorithm::computeTorpLimit(Ship& attacker, const Ship& enemy,
         return;
     }
 
-    int expl = env.getTorpedoDamagePower(attacker.data.torpedoType);
-    int kill = env.getTorpedoKillPower(attacker.data.torpedoType);
+    int expl = attacker.config.TorpedoDamagePower;
+    int kill = attacker.config.TorpedoKillPower;
     if (!m_alternativeCombat) {
         expl *= 2, kill *= 2;
     }
@@ -1169,7 +1190,7 @@ game::vcr::flak::Algorithm::computeTorpLimit(Ship& attacker, const Ship& enemy,
         double hd = computeHullDamage(expl, kill, enemy.data.mass, enemy, m_alternativeCombat);
         double sd = computeShieldDamage(expl, kill, enemy.data.mass, enemy, m_alternativeCombat);
 
-        int limit = (env.getPlayerRaceNumber(enemy.data.player) == 2) ? 151 : 100;
+        int limit = (enemy.config.PlayerRace == 2) ? 151 : 100;
         double v1 = (limit - enemy.status.damage) / (hd + 0.01);
         if (!enemy.isPlanet()) {
             register double v2 = enemy.status.crew / (cd + 0.01);
@@ -1325,7 +1346,7 @@ game::vcr::flak::Algorithm::doPlayerGC(Player& p)
 
 /* Pick a new enemy for a fleet. Updates the fleet in-place. */
 void
-game::vcr::flak::Algorithm::chooseEnemy(Fleet& fleet, const Environment& env, Visualizer& vis, size_t fleetNr)
+game::vcr::flak::Algorithm::chooseEnemy(Fleet& fleet, Visualizer& vis, size_t fleetNr)
 {
     // ex FlakBattle::chooseEnemy, flak.pas:ChooseEnemy
     if (!fleet.isAlive()) {
@@ -1350,7 +1371,7 @@ game::vcr::flak::Algorithm::chooseEnemy(Fleet& fleet, const Environment& env, Vi
 
         for (size_t n = 0; n < fleet.data.numShips; ++n) {
             const Ship& we = *m_ships[n + fleet.data.firstShipIndex];
-            if (we.isAlive() && (canStillAttack(we, their_ship, env) || canStillAttack(their_ship, we, env))) {
+            if (we.isAlive() && (canStillAttack(we, their_ship) || canStillAttack(their_ship, we))) {
                 attack_rating += we.data.rating;
             }
         }
@@ -1416,7 +1437,7 @@ game::vcr::flak::Algorithm::chooseEnemy(Fleet& fleet, const Environment& env, Vi
             }
         }
         for (size_t i = 0; i < fleet.data.numShips; ++i) {
-            computeTorpLimit(*m_ships[i+fleet.data.firstShipIndex], *best_choice, num_torpers, env);
+            computeTorpLimit(*m_ships[i+fleet.data.firstShipIndex], *best_choice, num_torpers);
         }
     }
 }
@@ -1471,7 +1492,7 @@ game::vcr::flak::Algorithm::launchFighters(const Fleet& fleet, Visualizer& vis)
 
 /** Fire torps from a fleet. */
 void
-game::vcr::flak::Algorithm::fireTorps(const Fleet& fleet, const Environment& env, Visualizer& vis)
+game::vcr::flak::Algorithm::fireTorps(const Fleet& fleet, Visualizer& vis)
 {
     // ex FlakBattle::fireTorps, flak.pas:FireTorps
     if (!fleet.isAlive() || !fleet.status.enemy_ptr || !fleet.status.enemy_ptr->isAlive()) {
@@ -1503,8 +1524,8 @@ game::vcr::flak::Algorithm::fireTorps(const Fleet& fleet, const Environment& env
             p.enemy_ptr        = fleet.status.enemy_ptr;
             p.owner_ptr        = &sh;
             p.strikes          = 0;
-            p.kill             = env.getTorpedoKillPower(sh.data.torpedoType);
-            p.expl             = env.getTorpedoDamagePower(sh.data.torpedoType);
+            p.kill             = sh.config.TorpedoKillPower;
+            p.expl             = sh.config.TorpedoDamagePower;
             p.death_flag       = p.expl;
             p.speed            = FLAK_TORP_MOVEMENT_SPEED;
             if (!m_alternativeCombat) {
@@ -1526,7 +1547,7 @@ game::vcr::flak::Algorithm::fireTorps(const Fleet& fleet, const Environment& env
 
 /* Fire all beams from fleet. */
 void
-game::vcr::flak::Algorithm::fireBeams(const Fleet& fleet, const Environment& env, Visualizer& vis)
+game::vcr::flak::Algorithm::fireBeams(const Fleet& fleet, Visualizer& vis)
 {
     // ex FlakBattle::fireBeams, flak.pas:FireBeams
     if (!fleet.isAlive()) {
@@ -1603,9 +1624,9 @@ game::vcr::flak::Algorithm::fireBeams(const Fleet& fleet, const Environment& env
         {
             for (int bm = 0; bm < ship.data.numBeams; ++bm) {
                 if (ship.status.beamCharge[bm] >= ship.config.BeamHitShipCharge) {
-                    int kill = env.getBeamKillPower(ship.data.beamType);
-                    int damage = env.getBeamDamagePower(ship.data.beamType);
-                    if (env.getPlayerRaceNumber(ship.data.player) == 5) {
+                    int kill = ship.config.BeamKillPower;
+                    int damage = ship.config.BeamDamagePower;
+                    if (ship.config.PlayerRace == 5) {
                         kill *= 3;
                     }
                     if (random(100) < ship.config.BeamHitOdds) {
@@ -1650,7 +1671,7 @@ game::vcr::flak::Algorithm::endCheck() const
     Modifies the fleet in-place.
     This computes the newPosition field, it does not actually move the fleet yet. */
 void
-game::vcr::flak::Algorithm::computeNewPosition(Fleet& fleet, const Environment& env, Visualizer& vis, size_t fleetNr)
+game::vcr::flak::Algorithm::computeNewPosition(Fleet& fleet, Visualizer& vis, size_t fleetNr)
 {
     // ex FlakBattle::computeNewPosition, flak.pas:ComputeNewPosition
     fleet.newPosition = fleet.status.position;
@@ -1661,7 +1682,7 @@ game::vcr::flak::Algorithm::computeNewPosition(Fleet& fleet, const Environment&
 
     /* if our enemy died, pick a new one */
     if (fleet.status.enemy_ptr && !fleet.status.enemy_ptr->isAlive()) {
-        chooseEnemy(fleet, env, vis, fleetNr);
+        chooseEnemy(fleet, vis, fleetNr);
     }
 
     const int sod = m_standoffDistance;
@@ -1770,23 +1791,48 @@ game::vcr::flak::Algorithm::fighterIntercept(Player& a, Player& b, Visualizer& v
         return;
     }
 
+    /* Originally, this compared every fighter of a against every fighter of b, both in reverse order.
+       tryIntercept() rejects pairs out of FLAK_FIGHTER_INTERCEPT_RANGE without side effects,
+       so we only need to look at fighters of b in the neighbouring cells of a grid with that cell size.
+       Candidates are visited in the original order to produce identical results. */
+    m_interceptBuckets.clear();
+    for (size_t ib = 0; ib < b.stuff.size(); ++ib) {
+        const Object* pb = b.stuff[ib];
+        if (pb->kind == oFighter && pb->owner_ptr != 0) {
+            m_interceptBuckets.push_back(InterceptBucket_t(getInterceptCell(pb->position), ib));
+        }
+    }
+    if (m_interceptBuckets.empty()) {
+        return;
+    }
+    std::sort(m_interceptBuckets.begin(), m_interceptBuckets.end());
+
     for (size_t ia = a.stuff.size(); ia > 0; --ia) {
         Object* pa = a.stuff[ia-1];
-        if (pa->kind == oFighter) {
-            for (size_t ib = b.stuff.size(); ib > 0; --ib) {
-                Object* pb = b.stuff[ib-1];
-                if (pb->kind == oFighter) {
-                    /* two fighters. Possible targets? */
-                    if (pa->owner_ptr != 0 && pb->owner_ptr != 0 &&
-                        (pa->enemy_ptr == pb->owner_ptr
-                         || pb->enemy_ptr == pa->owner_ptr))
-                    {
-                        if (tryIntercept(*pa, *pb, vis)) {
-                            return;
-                        }
-                        if (pa->kind != oFighter) {
-                            break;  /* can this happen? I think no. */
-                        }
+        if (pa->kind == oFighter && pa->owner_ptr != 0) {
+            /* Cells (x-1..x+1, y-1..y+1); for each x, the y range is contiguous in the sorted list */
+            const std::pair<int32_t, int32_t> cell = getInterceptCell(pa->position);
+            m_interceptCandidates.clear();
+            for (int32_t x = cell.first-1; x <= cell.first+1; ++x) {
+                std::vector<InterceptBucket_t>::const_iterator it =
+                    std::lower_bound(m_interceptBuckets.begin(), m_interceptBuckets.end(),
+                                     InterceptBucket_t(std::make_pair(x, cell.second-1), 0));
+                while (it != m_interceptBuckets.end() && it->first.first == x && it->first.second <= cell.second+1) {
+                    m_interceptCandidates.push_back(it->second);
+                    ++it;
+                }
+            }
+            std::sort(m_interceptCandidates.begin(), m_interceptCandidates.end(), std::greater<size_t>());
+
+            for (size_t i = 0; i < m_interceptCandidates.size(); ++i) {
+                Object* pb = b.stuff[m_interceptCandidates[i]];
+                /* two fighters. Possible targets? */
+                if (pa->enemy_ptr == pb->owner_ptr || pb->enemy_ptr == pa->owner_ptr) {
+                    if (tryIntercept(*pa, *pb, vis)) {
+                        return;
+                    }
+                    if (pa->kind != oFighter) {
+                        break;  /* can this happen? I think no. */
                     }
                 }
             }
@@ -6,6 +6,7 @@
 #define C2NG_GAME_VCR_FLAK_ALGORITHM_HPP
 
 #include <iosfwd>
+#include <utility>
 #include <vector>
 #include "afl/base/optional.hpp"
 #include "afl/container/ptrvector.hpp"
@@ -189,6 +190,12 @@ namespace game { namespace vcr { namespace flak {
            Used as instance variable to avoid allocations in the inner loop. */
         std::vector<int> m_fleetGCTorpedoes;
 
+        /* Fighter buckets for fighterIntercept: ((cellX, cellY), index into Player::stuff), sorted.
+           Used as instance variables to avoid allocations in the inner loop. */
+        typedef std::pair<std::pair<int32_t, int32_t>, size_t> InterceptBucket_t;
+        std::vector<InterceptBucket_t> m_interceptBuckets;
+        std::vector<size_t> m_interceptCandidates;
+
 
         /* Random number generator */
         int random(int max);
@@ -199,7 +206,7 @@ namespace game { namespace vcr { namespace flak {
         static int32_t moveObjectTowards(Object& obj, Position toPos);
 
         /* Ship operations */
-        void computeTorpLimit(Ship& attacker, const Ship& ship, int num_torpers, const Environment& env) const;
+        void computeTorpLimit(Ship& attacker, const Ship& ship, int num_torpers) const;
         void hitShipWith(Ship& sh, const Ship& firing_ship, int damage, int kill, int death_flag) const;
         void rechargeShip(Ship& ship);
 
@@ -207,12 +214,12 @@ namespace game { namespace vcr { namespace flak {
         void doPlayerGC(Player& p);
 
         /* Combat phases */
-        void chooseEnemy(Fleet& fleet, const Environment& env, Visualizer& vis, size_t fleetNr);
+        void chooseEnemy(Fleet& fleet, Visualizer& vis, size_t fleetNr);
         void launchFighters(const Fleet& fleet, Visualizer& vis);
-        void fireTorps(const Fleet& fleet, const Environment& env, Visualizer& vis);
-        void fireBeams(const Fleet& fleet, const Environment& env, Visualizer& vis);
+        void fireTorps(const Fleet& fleet, Visualizer& vis);
+        void fireBeams(const Fleet& fleet, Visualizer& vis);
         bool endCheck() const;
-        void computeNewPosition(Fleet& fleet, const Environment& env, Visualizer& vis, size_t fleetNr);
+        void computeNewPosition(Fleet& fleet, Visualizer& vis, size_t fleetNr);
         void doFleetGC(Fleet& fleet, const Environment& env, Visualizer& vis, size_t fleetNr);
         void fighterIntercept(Player& a, Player& b, Visualizer& vis);
         bool tryIntercept(Object& pa, Object& pb, Visualizer& vis);
@@ -0,0 +1,124 @@
+/**
+  *  \file game/vcr/flak/compiledenvironment.cpp
+  *  \brief Class game::vcr::flak::CompiledEnvironment
+  */
+
+#include "game/vcr/flak/compiledenvironment.hpp"
+#include "game/spec/beam.hpp"
+#include "game/spec/torpedolauncher.hpp"
+#include "game/vcr/flak/gameenvironment.hpp"
+
+namespace {
+    /* Get highest Id in a ComponentVector */
+    template<typename T>
+    int getMaxId(const game::spec::ComponentVector<T>& vec)
+    {
+        int result = 0;
+        for (const T* p = vec.findNext(0); p != 0; p = vec.findNext(p->getId())) {
+            result = p->getId();
+        }
+        return result;
+    }
+
+    /* Map player number to array index, see class description */
+    inline size_t getPlayerIndex(int player)
+    {
+        return (player > 0 && player <= game::MAX_PLAYERS) ? size_t(player-1) : size_t(game::MAX_PLAYERS-1);
+    }
+}
+
+game::vcr::flak::CompiledEnvironment::CompiledEnvironment(const Environment& env, int numBeamTypes, int numTorpedoTypes)
+    : m_beams(),
+      m_torpedoes()
+{
+    init(env, numBeamTypes, numTorpedoTypes);
+}
+
+game::vcr::flak::CompiledEnvironment::CompiledEnvironment(const game::config::HostConfiguration& config, const game::spec::BeamVector_t& beams, const game::spec::TorpedoVector_t& torps)
+    : m_beams(),
+      m_torpedoes()
+{
+    init(GameEnvironment(config, beams, torps), getMaxId(beams), getMaxId(torps));
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getConfiguration(ScalarOption index) const
+{
+    return (index >= 0 && index < NUM_SCALAR_OPTIONS) ? m_scalar[index] : 0;
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getConfiguration(ArrayOption index, int player) const
+{
+    return (index >= 0 && index < NUM_ARRAY_OPTIONS) ? m_array[index][getPlayerIndex(player)] : 0;
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getExperienceConfiguration(ExperienceOption index, int level, int player) const
+{
+    if (level < 0 || level > MAX_EXPERIENCE_LEVELS) {
+        level = 0;
+    }
+    return (index >= 0 && index < NUM_EXPERIENCE_OPTIONS) ? m_experience[index][level][getPlayerIndex(player)] : 0;
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getBeamKillPower(int type) const
+{
+    return (type > 0 && size_t(type) <= m_beams.size()) ? m_beams[type-1].killPower : 0;
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getBeamDamagePower(int type) const
+{
+    return (type > 0 && size_t(type) <= m_beams.size()) ? m_beams[type-1].damagePower : 0;
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getTorpedoKillPower(int type) const
+{
+    return (type > 0 && size_t(type) <= m_torpedoes.size()) ? m_torpedoes[type-1].killPower : 0;
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getTorpedoDamagePower(int type) const
+{
+    return (type > 0 && size_t(type) <= m_torpedoes.size()) ? m_torpedoes[type-1].damagePower : 0;
+}
+
+int
+game::vcr::flak::CompiledEnvironment::getPlayerRaceNumber(int player) const
+{
+    return (player > 0 && player <= MAX_PLAYERS) ? m_playerRace[player-1] : player;
+}
+
+void
+game::vcr::flak::CompiledEnvironment::init(const Environment& env, int numBeamTypes, int numTorpedoTypes)
+{
+    for (int i = 0; i < NUM_SCALAR_OPTIONS; ++i) {
+        m_scalar[i] = env.getConfiguration(ScalarOption(i));
+    }
+    for (int pl = 1; pl <= MAX_PLAYERS; ++pl) {
+        for (int i = 0; i < NUM_ARRAY_OPTIONS; ++i) {
+            m_array[i][pl-1] = env.getConfiguration(ArrayOption(i), pl);
+        }
+        for (int i = 0; i < NUM_EXPERIENCE_OPTIONS; ++i) {
+            for (int lv = 0; lv <= MAX_EXPERIENCE_LEVELS; ++lv) {
+                m_experience[i][lv][pl-1] = env.getExperienceConfiguration(ExperienceOption(i), lv, pl);
+            }
+        }
+        m_playerRace[pl-1] = env.getPlayerRaceNumber(pl);
+    }
+
+    m_beams.resize(numBeamTypes > 0 ? size_t(numBeamTypes) : 0);
+    for (size_t i = 0; i < m_beams.size(); ++i) {
+        m_beams[i].killPower   = env.getBeamKillPower(int(i+1));
+        m_beams[i].damagePower = env.getBeamDamagePower(int(i+1));
+    }
+
+    m_torpedoes.resize(numTorpedoTypes > 0 ? size_t(numTorpedoTypes) : 0);
+    for (size_t i = 0; i < m_torpedoes.size(); ++i) {
+        m_torpedoes[i].killPower   = env.getTorpedoKillPower(int(i+1));
+        m_torpedoes[i].damagePower = env.getTorpedoDamagePower(int(i+1));
+    }
+}
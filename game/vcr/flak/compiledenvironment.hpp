@@ -0,0 +1,81 @@
+/**
+  *  \file game/vcr/flak/compiledenvironment.hpp
+  *  \brief Class game::vcr::flak::CompiledEnvironment
+  */
+#ifndef C2NG_GAME_VCR_FLAK_COMPILEDENVIRONMENT_HPP
+#define C2NG_GAME_VCR_FLAK_COMPILEDENVIRONMENT_HPP
+
+#include <vector>
+#include "afl/base/uncopyable.hpp"
+#include "game/config/hostconfiguration.hpp"
+#include "game/limits.hpp"
+#include "game/spec/componentvector.hpp"
+#include "game/vcr/flak/environment.hpp"
+
+namespace game { namespace vcr { namespace flak {
+
+    /** Precomputed environment.
+        Takes a snapshot of another Environment and stores all values in flat tables,
+        so that every lookup is a simple array access.
+
+        Building a CompiledEnvironment performs all lookups of the original environment once,
+        which is more expensive than playing a small battle.
+        It therefore makes sense when playing many battles with the same configuration,
+        e.g. in the simulator.
+
+        A CompiledEnvironment is immutable and does not refer to the original environment,
+        so it can be shared between threads.
+
+        Out-of-range parameters produce the same results as GameEnvironment:
+        - player numbers outside 1..MAX_PLAYERS produce the value for MAX_PLAYERS (last array element),
+          or the player number for getPlayerRaceNumber();
+        - experience levels outside 0..MAX_EXPERIENCE_LEVELS produce the value for level 0;
+        - unknown weapon types produce 0. */
+    class CompiledEnvironment : public Environment, private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            \param env             Environment to take a snapshot of
+            \param numBeamTypes    Number of beam types to take from env (types 1..numBeamTypes)
+            \param numTorpedoTypes Number of torpedo types to take from env (types 1..numTorpedoTypes) */
+        CompiledEnvironment(const Environment& env, int numBeamTypes, int numTorpedoTypes);
+
+        /** Constructor.
+            Takes a snapshot of a GameEnvironment created from the given parameters.
+            \param config  Host configuration
+            \param beams   Beam weapons
+            \param torps   Torpedo launchers */
+        CompiledEnvironment(const game::config::HostConfiguration& config, const game::spec::BeamVector_t& beams, const game::spec::TorpedoVector_t& torps);
+
+        // Environment:
+        virtual int getConfiguration(ScalarOption index) const;
+        virtual int getConfiguration(ArrayOption index, int player) const;
+        virtual int getExperienceConfiguration(ExperienceOption index, int level, int player) const;
+        virtual int getBeamKillPower(int type) const;
+        virtual int getBeamDamagePower(int type) const;
+        virtual int getTorpedoKillPower(int type) const;
+        virtual int getTorpedoDamagePower(int type) const;
+        virtual int getPlayerRaceNumber(int player) const;
+
+     private:
+        static const int NUM_SCALAR_OPTIONS = StandoffDistance + 1;
+        static const int NUM_ARRAY_OPTIONS = TorpFiringRange + 1;
+        static const int NUM_EXPERIENCE_OPTIONS = TubeRechargeRate + 1;
+
+        struct Weapon {
+            int killPower;
+            int damagePower;
+        };
+
+        int m_scalar[NUM_SCALAR_OPTIONS];
+        int m_array[NUM_ARRAY_OPTIONS][MAX_PLAYERS];
+        int m_experience[NUM_EXPERIENCE_OPTIONS][MAX_EXPERIENCE_LEVELS+1][MAX_PLAYERS];
+        int m_playerRace[MAX_PLAYERS];
+        std::vector<Weapon> m_beams;
+        std::vector<Weapon> m_torpedoes;
+
+        void init(const Environment& env, int numBeamTypes, int numTorpedoTypes);
+    };
+
+} } }
+
+#endif
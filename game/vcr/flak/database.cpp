@@ -100,6 +100,14 @@ game::vcr::flak::Database::save(afl::io::Stream& out, size_t first, size_t num,
     }
 }
 
+void
+game::vcr::flak::Database::prepareResults(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel, size_t /*numThreads*/)
+{
+    for (size_t i = 0, n = m_battles.size(); i < n; ++i) {
+        m_battles[i]->prepareResult(config, shipList, resultLevel);
+    }
+}
+
 game::vcr::flak::Battle*
 game::vcr::flak::Database::readOneBattle(afl::io::Stream& file, afl::charset::Charset& charset, afl::string::Translator& tx)
 {
@@ -39,6 +39,7 @@ namespace game { namespace vcr { namespace flak {
         virtual size_t getNumBattles() const;
         virtual Battle* getBattle(size_t nr);
         virtual void save(afl::io::Stream& out, size_t first, size_t num, const game::config::HostConfiguration& config, afl::charset::Charset& cs);
+        virtual void prepareResults(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel, size_t numThreads);
 
      private:
         afl::container::PtrVector<Battle> m_battles;
@@ -20,3 +20,7 @@ game::vcr::NullDatabase::getBattle(size_t /*nr*/)
 void
 game::vcr::NullDatabase::save(afl::io::Stream& /*out*/, size_t /*first*/, size_t /*num*/, const game::config::HostConfiguration& /*config*/, afl::charset::Charset& /*cs*/)
 { }
+
+void
+game::vcr::NullDatabase::prepareResults(const game::config::HostConfiguration& /*config*/, const game::spec::ShipList& /*shipList*/, int /*resultLevel*/, size_t /*numThreads*/)
+{ }
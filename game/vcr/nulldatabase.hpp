@@ -16,6 +16,7 @@ namespace game { namespace vcr {
         virtual size_t getNumBattles() const;
         virtual Battle* getBattle(size_t nr);
         virtual void save(afl::io::Stream& out, size_t first, size_t num, const game::config::HostConfiguration& config, afl::charset::Charset& cs);
+        virtual void prepareResults(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel, size_t numThreads);
     };
 
 } }
@@ -45,13 +45,15 @@ namespace {
     }
 }
 
-game::vcr::Overview::Overview(Database& battles, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList)
+game::vcr::Overview::Overview(Database& battles, const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, size_t numThreads)
     : m_battles(battles),
       m_config(config),
       m_shipList(shipList),
+      m_numThreads(numThreads),
       m_units(),
       m_groupCounter(0)
 {
+    battles.prepareResults(config, shipList, Battle::NeedQuickOutcome, numThreads);
     for (size_t i = 0, n = battles.getNumBattles(); i < n; ++i) {
         if (Battle* b = battles.getBattle(i)) {
             addBattle(*b, i);
@@ -77,6 +79,7 @@ game::vcr::Overview::buildScoreSummary(ScoreSummary& out)
     out.players.clear();
     out.scores.setAll(Score());
     out.numBattles = numBattles;
+    m_battles.prepareResults(m_config, m_shipList, Battle::NeedCompleteResult, m_numThreads);
     for (size_t battleNr = 0; battleNr < numBattles; ++battleNr) {
         if (Battle* b = m_battles.getBattle(battleNr)) {
             b->prepareResult(m_config, m_shipList, Battle::NeedCompleteResult);
@@ -37,3 +37,11 @@ game::vcr::test::Database::getBattle(size_t nr)
 void
 game::vcr::test::Database::save(afl::io::Stream& /*out*/, size_t /*first*/, size_t /*num*/, const game::config::HostConfiguration& /*config*/, afl::charset::Charset& /*cs*/)
 { }
+
+void
+game::vcr::test::Database::prepareResults(const game::config::HostConfiguration& config, const game::spec::ShipList& shipList, int resultLevel, size_t /*numThreads*/)
+{
+    for (size_t i = 0, n = m_battles.size(); i < n; ++i) {
+        m_battles[i]->prepareResult(config, shipList, resultLevel);
+    }
+}
@@ -3,6 +3,7 @@
   *  \brief Class gfx::gen::Application
   */
 
+#include <algorithm>
 #include <stdexcept>
 #include "gfx/gen/application.hpp"
 #include "afl/base/optional.hpp"
@@ -19,6 +20,7 @@
 #include "gfx/gen/texture.hpp"
 #include "util/randomnumbergenerator.hpp"
 #include "util/string.hpp"
+#include "util/systeminformation.hpp"
 #include "version.hpp"
 
 using afl::string::Format;
@@ -100,6 +102,24 @@ namespace gfx { namespace gen { namespace {
         gfx::codec::BMP().save(can, stream);
     }
 
+    /* Render an image using a configuration (PlanetConfig, SpaceViewConfig, OrbitConfig).
+       If requested, first renders the image benchmarkCount times and reports the timing.
+       The benchmark uses a copy of the RNG, so the final image is the same as without benchmark. */
+    template<typename Config>
+    afl::base::Ref<RGBAPixmap> renderImage(const Config& config, util::RandomNumberGenerator& rng, int benchmarkCount, afl::io::TextWriter& out, afl::string::Translator& tx)
+    {
+        if (benchmarkCount > 0) {
+            const uint32_t startTime = afl::sys::Time::getTickCounter();
+            for (int i = 0; i < benchmarkCount; ++i) {
+                util::RandomNumberGenerator benchRNG(rng.getSeed());
+                config.render(benchRNG);
+            }
+            const uint32_t elapsed = std::max(afl::sys::Time::getTickCounter() - startTime, uint32_t(1));
+            out.writeLine(Format(tx("%d image%!1{s%} in %d ms, %.2f images/s"), benchmarkCount, elapsed, 1000.0 * benchmarkCount / elapsed));
+        }
+        return config.render(rng);
+    }
+
 } } }
 
 
@@ -109,12 +129,16 @@ struct gfx::gen::Application::CommonOptions {
     util::RandomNumberGenerator rng;
     int w;
     int h;
+    int numThreads;
+    int benchmarkCount;
 
     CommonOptions()
         : outputFileName(),
           rng(afl::sys::Time::getTickCounter()),
           w(640),
-          h(480)
+          h(480),
+          numThreads(int(util::getSystemInformation().numProcessors)),
+          benchmarkCount(0)
         { }
 };
 
@@ -174,6 +198,8 @@ gfx::gen::Application::showHelp()
                                               "-h HEIGHT\tSet height\n"
                                               "-S SEED\tSet seed\n"
                                               "-o FILE.bmp\tSet output file (mandatory)\n"
+                                              "-j THREADS\tSet number of threads (space, planet, orbit)\n"
+                                              "--benchmark N\tRender N times and report timing (space, planet, orbit)\n"
                                               "\n"
                                               "Command \"space\": space view/starfield/nebula\n"
                                               "-s SUNS\tSet number of suns\n"
@@ -247,9 +273,10 @@ gfx::gen::Application::doSpace(afl::base::Ref<afl::sys::Environment::CommandLine
         errorExit(tx("output file name (\"-o\") not specified"));
     }
     config.setSize(Point(opts.w, opts.h));
+    config.setNumThreads(size_t(opts.numThreads));
 
     // Generate
-    afl::base::Ref<RGBAPixmap> result(config.render(opts.rng));
+    afl::base::Ref<RGBAPixmap> result(renderImage(config, opts.rng, opts.benchmarkCount, standardOutput(), tx));
 
     // Save
     saveCanvas(*result->makeCanvas(), *fileSystem().openFile(*pOutputFileName, afl::io::FileSystem::Create));
@@ -319,9 +346,10 @@ gfx::gen::Application::doPlanet(afl::base::Ref<afl::sys::Environment::CommandLin
     config.setPlanetRadius(pr);
     config.setPlanetTemperature(pt);
     config.setSunPosition(sx, sy, sz);
+    config.setNumThreads(size_t(opts.numThreads));
 
     // Generate
-    afl::base::Ref<RGBAPixmap> result(config.render(opts.rng));
+    afl::base::Ref<RGBAPixmap> result(renderImage(config, opts.rng, opts.benchmarkCount, standardOutput(), tx));
 
     // Save
     saveCanvas(*result->makeCanvas(), *fileSystem().openFile(*pOutputFileName, afl::io::FileSystem::Create));
@@ -378,9 +406,10 @@ gfx::gen::Application::doOrbit(afl::base::Ref<afl::sys::Environment::CommandLine
     config.setPlanetPosition(px, py);
     config.setPlanetRadius(pr);
     config.setNumStars(n);
+    config.setNumThreads(size_t(opts.numThreads));
 
     // Generate
-    afl::base::Ref<RGBAPixmap> result(config.render(opts.rng));
+    afl::base::Ref<RGBAPixmap> result(renderImage(config, opts.rng, opts.benchmarkCount, standardOutput(), tx));
 
     // Save
     saveCanvas(*result->makeCanvas(), *fileSystem().openFile(*pOutputFileName, afl::io::FileSystem::Create));
@@ -539,6 +568,16 @@ gfx::gen::Application::handleCommonOption(CommonOptions& opt, const String_t& te
     } else if (text == "o") {
         opt.outputFileName = parser.getRequiredParameter(text);
         return true;
+    } else if (text == "j") {
+        if (!strToInteger(parser.getRequiredParameter(text), opt.numThreads) || opt.numThreads <= 0) {
+            errorExit(Format(translator()("parameter for \"-%s\" is invalid"), text));
+        }
+        return true;
+    } else if (text == "benchmark") {
+        if (!strToInteger(parser.getRequiredParameter(text), opt.benchmarkCount) || opt.benchmarkCount <= 0) {
+            errorExit(Format(translator()("parameter for \"--%s\" is invalid"), text));
+        }
+        return true;
     } else {
         return false;
     }
@@ -14,7 +14,8 @@ gfx::gen::OrbitConfig::OrbitConfig()
       m_numStars(5),
       m_planetRelX(100),
       m_planetRelY(500),
-      m_planetRelRadius(415)
+      m_planetRelRadius(415),
+      m_numThreads(1)
 { }
 
 // Set image size.
@@ -47,6 +48,13 @@ gfx::gen::OrbitConfig::setPlanetRadius(int relRadius)
     m_planetRelRadius = relRadius;
 }
 
+// Set number of threads.
+void
+gfx::gen::OrbitConfig::setNumThreads(size_t n)
+{
+    m_numThreads = n;
+}
+
 // Render.
 afl::base::Ref<gfx::RGBAPixmap>
 gfx::gen::OrbitConfig::render(util::RandomNumberGenerator& rng) const
@@ -56,6 +64,7 @@ gfx::gen::OrbitConfig::render(util::RandomNumberGenerator& rng) const
 
     // Starfield
     SpaceView sv(*pix);
+    sv.setNumThreads(m_numThreads);
 
     // Since the number of stars may vary depending on the size,
     // use a copy of the RNG so that following steps keep seeing the same state.
@@ -90,12 +99,14 @@ gfx::gen::OrbitConfig::render(util::RandomNumberGenerator& rng) const
         COLORQUAD_FROM_RGB(r/2,  g,    b/2),
     };
 
-    Planet(*pix).renderPlanet(Planet::ValueVector_t(m_width * m_planetRelX / 100, m_height * m_planetRelY / 100, 0),
-                              std::min(m_width, m_height)*m_planetRelRadius/100,
-                              COLORS,
-                              3,
-                              Planet::ValueVector_t(0, 0, -10000),
-                              rng);
+    Planet planet(*pix);
+    planet.setNumThreads(m_numThreads);
+    planet.renderPlanet(Planet::ValueVector_t(m_width * m_planetRelX / 100, m_height * m_planetRelY / 100, 0),
+                        std::min(m_width, m_height)*m_planetRelRadius/100,
+                        COLORS,
+                        3,
+                        Planet::ValueVector_t(0, 0, -10000),
+                        rng);
 
     // Everything is opaque
     pix->setAlpha(OPAQUE_ALPHA);
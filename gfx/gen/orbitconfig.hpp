@@ -39,6 +39,11 @@ namespace gfx { namespace gen {
             \param relRadius Relative radius (100=same as minimum image dimension, i.e. completely fills frame) */
         void setPlanetRadius(int relRadius);
 
+        /** Set number of threads.
+            The result does not depend on the number of threads.
+            \param n Number of threads (default: 1) */
+        void setNumThreads(size_t n);
+
         /** Render.
             Produces an image using the given settings.
             \param rng Random number generator
@@ -52,6 +57,7 @@ namespace gfx { namespace gen {
         int m_planetRelX;
         int m_planetRelY;
         int m_planetRelRadius;
+        size_t m_numThreads;
     };
 
 } }
@@ -5,8 +5,15 @@
   *  Derived from procedural.js, see spaceview.cpp for details.
   */
 
+#include <algorithm>
 #include "gfx/gen/perlinnoise.hpp"
 
+namespace {
+    /* Number of points processed at once by the multi-point functions.
+       Intermediate values for a block are kept on the stack. */
+    const size_t BLOCK_SIZE = 16;
+}
+
 const gfx::gen::PerlinNoise::Triplet_t gfx::gen::PerlinNoise::grad3[] = {
     { 1, 1, 0 },
     { -1, 1, 0 },
@@ -110,6 +117,115 @@ gfx::gen::PerlinNoise::noise(Value_t x, Value_t y) const
     return 0.5 * nxy0 + 0.5;
 }
 
+// Compute 3-D noise values for multiple points.
+void
+gfx::gen::PerlinNoise::noise(const Value_t* px, const Value_t* py, const Value_t* pz, Value_t* out, size_t n) const
+{
+    // Same computation as single-point noise(), split into two loops:
+    // table lookups (which need gathers) and arithmetic (which the compiler can vectorize).
+    while (n > 0) {
+        const size_t k = std::min(n, BLOCK_SIZE);
+        Value_t fx[BLOCK_SIZE], fy[BLOCK_SIZE], fz[BLOCK_SIZE];
+        const Triplet_t* g[8][BLOCK_SIZE];
+        for (size_t i = 0; i < k; ++i) {
+            int32_t X = int32_t(px[i]);
+            int32_t Y = int32_t(py[i]);
+            int32_t Z = int32_t(pz[i]);
+            fx[i] = px[i] - X;
+            fy[i] = py[i] - Y;
+            fz[i] = pz[i] - Z;
+            X = X & 255;
+            Y = Y & 255;
+            Z = Z & 255;
+
+            g[0][i] = &grad3[perm12[X +     perm[Y +     perm[Z]]]    ];
+            g[1][i] = &grad3[perm12[X + 1 + perm[Y +     perm[Z]]]    ];
+            g[2][i] = &grad3[perm12[X +     perm[Y + 1 + perm[Z]]]    ];
+            g[3][i] = &grad3[perm12[X + 1 + perm[Y + 1 + perm[Z]]]    ];
+            g[4][i] = &grad3[perm12[X +     perm[Y +     perm[Z + 1]]]];
+            g[5][i] = &grad3[perm12[X + 1 + perm[Y +     perm[Z + 1]]]];
+            g[6][i] = &grad3[perm12[X +     perm[Y + 1 + perm[Z + 1]]]];
+            g[7][i] = &grad3[perm12[X + 1 + perm[Y + 1 + perm[Z + 1]]]];
+        }
+
+        for (size_t i = 0; i < k; ++i) {
+            const Value_t x = fx[i], y = fy[i], z = fz[i];
+            Value_t n000 = dot(*g[0][i], x,     y,     z);
+            Value_t n100 = dot(*g[1][i], x - 1, y,     z);
+            Value_t n010 = dot(*g[2][i], x,     y - 1, z);
+            Value_t n110 = dot(*g[3][i], x - 1, y - 1, z);
+            Value_t n001 = dot(*g[4][i], x,     y,     z - 1);
+            Value_t n101 = dot(*g[5][i], x - 1, y,     z - 1);
+            Value_t n011 = dot(*g[6][i], x,     y - 1, z - 1);
+            Value_t n111 = dot(*g[7][i], x - 1, y - 1, z - 1);
+
+            Value_t u = fade(x);
+            Value_t v = fade(y);
+            Value_t w = fade(z);
+            Value_t nx00 = mix(n000, n100, u);
+            Value_t nx01 = mix(n001, n101, u);
+            Value_t nx10 = mix(n010, n110, u);
+            Value_t nx11 = mix(n011, n111, u);
+            Value_t nxy0 = mix(nx00, nx10, v);
+            Value_t nxy1 = mix(nx01, nx11, v);
+            Value_t nxyz = mix(nxy0, nxy1, w);
+
+            out[i] = 0.5 * nxyz + 0.5;
+        }
+
+        px += k;
+        py += k;
+        pz += k;
+        out += k;
+        n -= k;
+    }
+}
+
+// Compute 2-D noise values for multiple points.
+void
+gfx::gen::PerlinNoise::noise(const Value_t* px, const Value_t* py, Value_t* out, size_t n) const
+{
+    while (n > 0) {
+        const size_t k = std::min(n, BLOCK_SIZE);
+        Value_t fx[BLOCK_SIZE], fy[BLOCK_SIZE];
+        const Triplet_t* g[4][BLOCK_SIZE];
+        for (size_t i = 0; i < k; ++i) {
+            int32_t X = int32_t(px[i]);
+            int32_t Y = int32_t(py[i]);
+            fx[i] = px[i] - X;
+            fy[i] = py[i] - Y;
+            X = X & 255;
+            Y = Y & 255;
+
+            g[0][i] = &grad3[perm12[X +     perm[Y +     perm[0]]]];
+            g[1][i] = &grad3[perm12[X + 1 + perm[Y +     perm[0]]]];
+            g[2][i] = &grad3[perm12[X +     perm[Y + 1 + perm[0]]]];
+            g[3][i] = &grad3[perm12[X + 1 + perm[Y + 1 + perm[0]]]];
+        }
+
+        for (size_t i = 0; i < k; ++i) {
+            const Value_t x = fx[i], y = fy[i];
+            Value_t n000 = dot(*g[0][i], x,     y);
+            Value_t n100 = dot(*g[1][i], x - 1, y);
+            Value_t n010 = dot(*g[2][i], x,     y - 1);
+            Value_t n110 = dot(*g[3][i], x - 1, y - 1);
+
+            Value_t u = fade(x);
+            Value_t v = fade(y);
+            Value_t nx00 = mix(n000, n100, u);
+            Value_t nx10 = mix(n010, n110, u);
+            Value_t nxy0 = mix(nx00, nx10, v);
+
+            out[i] = 0.5 * nxy0 + 0.5;
+        }
+
+        px += k;
+        py += k;
+        out += k;
+        n -= k;
+    }
+}
+
 inline gfx::gen::PerlinNoise::Value_t
 gfx::gen::PerlinNoise::dot(const Triplet_t& g, Value_t x, Value_t y, Value_t z)
 {
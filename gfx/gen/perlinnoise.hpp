@@ -32,6 +32,21 @@ namespace gfx { namespace gen {
             \return Noise value */
         Value_t noise(Value_t x, Value_t y) const;
 
+        /** Compute 3-D noise values for multiple points.
+            Produces the same values as calling noise(x[i],y[i],z[i]) for each point,
+            but processes the points in blocks that the compiler can vectorize.
+            \param [in]  x,y,z  Coordinates (n elements each)
+            \param [out] out    Noise values (n elements)
+            \param [in]  n      Number of points */
+        void noise(const Value_t* x, const Value_t* y, const Value_t* z, Value_t* out, size_t n) const;
+
+        /** Compute 2-D noise values for multiple points.
+            Produces the same values as calling noise(x[i],y[i]) for each point.
+            \param [in]  x,y    Coordinates (n elements each)
+            \param [out] out    Noise values (n elements)
+            \param [in]  n      Number of points */
+        void noise(const Value_t* x, const Value_t* y, Value_t* out, size_t n) const;
+
      private:
         uint8_t perm[512];
         uint8_t perm12[512];
@@ -5,8 +5,10 @@
 
 #include <cmath>
 #include <cassert>
+#include <vector>
 #include "gfx/gen/planet.hpp"
 #include "gfx/gen/perlinnoise.hpp"
+#include "gfx/gen/tilerenderer.hpp"
 
 namespace {
     inline double square(double d)
@@ -15,10 +17,195 @@ namespace {
     }
 }
 
+/*
+ *  Renderer
+ *
+ *  Renders tiles of a planet image.
+ *  All pixels of a row that hit the planet are collected, and their noise values are computed at once.
+ *  Each tile uses its own buffers, so tiles can be rendered in parallel.
+ */
+
+class gfx::gen::Planet::Renderer : public TileRenderer::Handler {
+ public:
+    Renderer(RGBAPixmap& pix,
+             const ValueVector_t& planetPos,
+             Value_t planetRadius,
+             afl::base::Memory<const ColorQuad_t> terrainColors,
+             Value_t clearness,
+             const ValueVector_t& lightSource,
+             int32_t minX, int32_t maxX,
+             util::RandomNumberGenerator& rng)
+        : m_pixmap(pix),
+          m_planetPos(planetPos),
+          m_planetRadius(planetRadius),
+          m_terrainColors(terrainColors),
+          m_clearness(clearness),
+          m_lightSource(lightSource),
+          m_minX(minX),
+          m_maxX(maxX),
+          m_terrainNoise(rng),
+          m_cloudNoise(rng)
+        { }
+
+    virtual void renderTile(int minY, int maxY);
+
+ private:
+    /* Per-tile buffers: one element per pixel of a row */
+    struct Buffers {
+        std::vector<int32_t> x;
+        std::vector<Value_t> light;
+        std::vector<ValueVector_t> pos;
+        std::vector<ValueVector_t> terrainPos;
+        std::vector<ValueVector_t> cloudPos;
+        std::vector<Value_t> terrain;
+        std::vector<Value_t> cloud;
+
+        // Scratch for recursiveField
+        std::vector<Value_t> px, py, pz;
+    };
+
+    static void recursiveField(const PerlinNoise& pn, const std::vector<ValueVector_t>& v, std::vector<Value_t>& out, int32_t depth, Value_t mult, Buffers& buf);
+
+    RGBAPixmap& m_pixmap;
+    const ValueVector_t m_planetPos;
+    const Value_t m_planetRadius;
+    const afl::base::Memory<const ColorQuad_t> m_terrainColors;
+    const Value_t m_clearness;
+    const ValueVector_t m_lightSource;
+    const int32_t m_minX;
+    const int32_t m_maxX;
+
+    // Noise functions
+    const PerlinNoise m_terrainNoise;
+    const PerlinNoise m_cloudNoise;
+};
+
+void
+gfx::gen::Planet::Renderer::renderTile(int minY, int maxY)
+{
+    // We must scale the noise functions. It happens that using planetRadius looks good here.
+    const Value_t terrainScale = 1.0 / m_planetRadius;
+    const Value_t cloudScale   = 1.0 / m_planetRadius;
+
+    // Offsets. Their main purpose is to get away from the origin as our noise functions are not wrap-capable.
+    const ValueVector_t terrainOffset(10, 10, 10);
+    const ValueVector_t cloudOffset(20, 20, 20);
+
+    const Value_t numTerrainColors = Value_t(m_terrainColors.size() - 1);
+    Buffers buf;
+    for (int y = minY; y < maxY; ++y) {
+        // Collect pixels that hit the planet surface
+        buf.x.clear();
+        buf.light.clear();
+        buf.pos.clear();
+        for (int x = m_minX; x < m_maxX; ++x) {
+            ValueVector_t surface;
+            Value_t c = calcLight(m_planetPos, m_planetRadius, m_lightSource, ValueVector_t(x, y, 0), surface);
+            if (c >= 0) {
+                buf.x.push_back(x);
+                buf.light.push_back(c);
+                buf.pos.push_back(surface);
+            }
+        }
+
+        // Compute terrain and cloud noise for all of them
+        buf.terrainPos.clear();
+        buf.cloudPos.clear();
+        for (size_t i = 0; i < buf.pos.size(); ++i) {
+            buf.terrainPos.push_back(terrainOffset + buf.pos[i]*terrainScale);
+            buf.cloudPos.push_back(cloudOffset + buf.pos[i]*cloudScale);
+        }
+        recursiveField(m_terrainNoise, buf.terrainPos, buf.terrain, 5, 1.5, buf);
+        recursiveField(m_cloudNoise, buf.cloudPos, buf.cloud, 5, 3, buf);
+
+        // Produce pixels
+        for (size_t i = 0; i < buf.x.size(); ++i) {
+            // Compute terrain color: noise function selects from color gradient.
+            const Value_t terrain = buf.terrain[i];
+            const Value_t tsel    = std::max(Value_t(0), std::min(numTerrainColors, terrain * numTerrainColors));
+            const ColorQuad_t c1  = *m_terrainColors.at(int(tsel));
+            const ColorQuad_t c2  = *m_terrainColors.at(int(tsel)+1);
+            const Value_t w       = tsel - int(tsel);
+            ColorQuad_t color     = mixColor(c1, c2, uint8_t(255*w));
+
+            // Add cloud color: noise function selects cloud density. Only (1/clearness) of the sky has clouds.
+            Value_t cloud = std::max(Value_t(0), buf.cloud[i]) * m_clearness;
+            if (cloud < 1) {
+                color = mixColor(color, COLORQUAD_FROM_RGBA(255, 255, 255, TRANSPARENT_ALPHA), uint8_t(255*(1-cloud)));
+            }
+
+            // Adjust according to lighting
+            color = mixColor(color, COLORQUAD_FROM_RGBA(0, 0, 0, OPAQUE_ALPHA), uint8_t(255*buf.light[i]));
+
+            // Make fully opaque
+            color |= COLORQUAD_FROM_RGBA(0, 0, 0, OPAQUE_ALPHA);
+
+            // Store pixel
+            ColorQuad_t* pPixel = m_pixmap.row(y).at(buf.x[i]);
+            assert(pPixel != 0);
+            *pPixel = color;
+        }
+    }
+}
+
+/* Compute recursive noise field for many points.
+   For each point, this computes
+      f(v, depth, mult) = noise(v*mult + f(v, depth-1, mult*2)),
+      f(v, 0, mult)     = noise(v*mult),
+   starting with the innermost level. */
+void
+gfx::gen::Planet::Renderer::recursiveField(const PerlinNoise& pn, const std::vector<ValueVector_t>& v, std::vector<Value_t>& out, int32_t depth, Value_t mult, Buffers& buf)
+{
+    const size_t n = v.size();
+    out.resize(n);
+    buf.px.resize(n);
+    buf.py.resize(n);
+    buf.pz.resize(n);
+    if (n == 0) {
+        return;
+    }
+
+    const int32_t maxLevel = std::max(depth, int32_t(0));
+    for (int32_t level = 0; level <= maxLevel; ++level) {
+        // Multiplier for this level, computed by repeated doubling like the recursive definition
+        Value_t m = mult;
+        for (int32_t i = level; i < depth; ++i) {
+            m *= 2;
+        }
+        if (level == 0) {
+            for (size_t i = 0; i < n; ++i) {
+                buf.px[i] = v[i].x * m;
+                buf.py[i] = v[i].y * m;
+                buf.pz[i] = v[i].z * m;
+            }
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                const Value_t displace = out[i];
+                buf.px[i] = v[i].x * m + displace;
+                buf.py[i] = v[i].y * m + displace;
+                buf.pz[i] = v[i].z * m + displace;
+            }
+        }
+        pn.noise(&buf.px[0], &buf.py[0], &buf.pz[0], &out[0], n);
+    }
+}
+
+
+/*
+ *  Planet
+ */
+
 gfx::gen::Planet::Planet(RGBAPixmap& pix)
-    : m_pixmap(pix)
+    : m_pixmap(pix),
+      m_numThreads(1)
 { }
 
+void
+gfx::gen::Planet::setNumThreads(size_t numThreads)
+{
+    m_numThreads = numThreads;
+}
+
 void
 gfx::gen::Planet::renderPlanet(const ValueVector_t planetPos,
                                const Value_t planetRadius,
@@ -32,71 +219,15 @@ gfx::gen::Planet::renderPlanet(const ValueVector_t planetPos,
         return;
     }
 
-    // Noise functions
-    PerlinNoise terrainNoise(rng);
-    PerlinNoise cloudNoise(rng);
-
-    // We must scale the noise functions. It happens that using planetRadius looks good here.
-    const Value_t terrainScale = 1.0 / planetRadius;
-    const Value_t cloudScale   = 1.0 / planetRadius;
-
-    // Offsets. Their main purpose is to get away from the origin as our noise functions are not wrap-capable.
-    const ValueVector_t terrainOffset(10, 10, 10);
-    const ValueVector_t cloudOffset(20, 20, 20);
-
     // Determine area of render
     const int32_t minX = std::max(int32_t(planetPos.x - planetRadius - 1), int32_t(0));
     const int32_t maxX = std::min(int32_t(planetPos.x + planetRadius + 1), int32_t(m_pixmap.getWidth()));
     const int32_t minY = std::max(int32_t(planetPos.y - planetRadius - 1), int32_t(0));
     const int32_t maxY = std::min(int32_t(planetPos.y + planetRadius + 1), int32_t(m_pixmap.getHeight()));
 
-    // Render
-    const Value_t numTerrainColors = Value_t(terrainColors.size() - 1);
-    for (int y = minY; y < maxY; ++y) {
-        for (int x = minX; x < maxX; ++x) {
-            // Planet surface
-            ValueVector_t surface;
-            Value_t c = calcLight(planetPos, planetRadius, lightSource, ValueVector_t(x, y, 0), surface);
-            if (c >= 0) {
-                // Compute terrain color: noise function selects from color gradient.
-                const Value_t terrain = recursiveField(terrainNoise, terrainOffset + surface*terrainScale, 5, 1.5);
-                const Value_t tsel    = std::max(Value_t(0), std::min(numTerrainColors, terrain * numTerrainColors));
-                const ColorQuad_t c1  = *terrainColors.at(int(tsel));
-                const ColorQuad_t c2  = *terrainColors.at(int(tsel)+1);
-                const Value_t w       = tsel - int(tsel);
-                ColorQuad_t color     = mixColor(c1, c2, uint8_t(255*w));
-
-                // Add cloud color: noise function selects cloud density. Only (1/clearness) of the sky has clouds.
-                Value_t cloud = std::max(Value_t(0), recursiveField(cloudNoise, cloudOffset + surface*cloudScale, 5, 3)) * clearness;
-                if (cloud < 1) {
-                    color = mixColor(color, COLORQUAD_FROM_RGBA(255, 255, 255, TRANSPARENT_ALPHA), uint8_t(255*(1-cloud)));
-                }
-
-                // Adjust according to lighting
-                color = mixColor(color, COLORQUAD_FROM_RGBA(0, 0, 0, OPAQUE_ALPHA), uint8_t(255*c));
-
-                // Make fully opaque
-                color |= COLORQUAD_FROM_RGBA(0, 0, 0, OPAQUE_ALPHA);
-
-                // Store pixel
-                ColorQuad_t* pPixel = m_pixmap.row(y).at(x);
-                assert(pPixel != 0);
-                *pPixel = color;
-            }
-        }
-    }
-}
-
-
-gfx::gen::Planet::Value_t
-gfx::gen::Planet::recursiveField(PerlinNoise& pn, const ValueVector_t& v, int32_t depth, Value_t mult)
-{
-    if (depth <= 0) {
-        return pn.noise(v.x * mult, v.y * mult, v.z * mult);
-    } else {
-        Value_t displace = recursiveField(pn, v, depth-1, mult * 2);
-        return pn.noise(v.x * mult + displace, v.y * mult + displace, v.z * mult + displace);
-    }
+    // Render. Renderer takes noise functions from the RNG.
+    Renderer r(m_pixmap, planetPos, planetRadius, terrainColors, clearness, lightSource, minX, maxX, rng);
+    TileRenderer(m_numThreads).render(r, minY, maxY);
 }
 
 /** Compute light.
@@ -29,6 +29,11 @@ namespace gfx { namespace gen {
             \param pix Output pixmap */
         explicit Planet(RGBAPixmap& pix);
 
+        /** Set number of threads.
+            The result does not depend on the number of threads.
+            \param numThreads Number of threads (0 or 1 to render in the calling thread only; default) */
+        void setNumThreads(size_t numThreads);
+
         /** Render a planet.
             \param planetPos     [in] Planet position, in image coordinates
             \param planetRadius  [in] Planet radius, in image coordinates
@@ -44,9 +49,12 @@ namespace gfx { namespace gen {
                           util::RandomNumberGenerator& rng);
 
      private:
+        class Renderer;
+        friend class Renderer;
+
         RGBAPixmap& m_pixmap;
+        size_t m_numThreads;
 
-        static Value_t recursiveField(PerlinNoise& pn, const ValueVector_t& v, int32_t depth, Value_t mult);
         static Value_t calcLight(const ValueVector_t& planet, Value_t planetRadius, const ValueVector_t& light, const ValueVector_t& camera, ValueVector_t& surface);
     };
 
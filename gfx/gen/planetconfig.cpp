@@ -106,7 +106,8 @@ gfx::gen::PlanetConfig::PlanetConfig()
       m_planetTemperature(50),
       m_sunRelX(100),
       m_sunRelY(100),
-      m_sunRelZ(-100)
+      m_sunRelZ(-100),
+      m_numThreads(1)
 { }
 
 // Set image size.
@@ -148,6 +149,13 @@ gfx::gen::PlanetConfig::setSunPosition(int relX, int relY, int relZ)
     m_sunRelZ = relZ;
 }
 
+// Set number of threads.
+void
+gfx::gen::PlanetConfig::setNumThreads(size_t n)
+{
+    m_numThreads = n;
+}
+
 // Render.
 afl::base::Ref<gfx::RGBAPixmap>
 gfx::gen::PlanetConfig::render(util::RandomNumberGenerator& rng) const
@@ -180,12 +188,14 @@ gfx::gen::PlanetConfig::render(util::RandomNumberGenerator& rng) const
 #endif
 
     // Render
-    Planet(*result).renderPlanet(planetPos,
-                                 planetRadius,
-                                 scheme,
-                                 clearness,
-                                 lightSource,
-                                 rng);
+    Planet planet(*result);
+    planet.setNumThreads(m_numThreads);
+    planet.renderPlanet(planetPos,
+                        planetRadius,
+                        scheme,
+                        clearness,
+                        lightSource,
+                        rng);
 
     return result;
 }
@@ -46,6 +46,11 @@ namespace gfx { namespace gen {
             \param relZ Relative Z position (positive: behind camera) */
         void setSunPosition(int relX, int relY, int relZ);
 
+        /** Set number of threads.
+            The result does not depend on the number of threads.
+            \param n Number of threads (default: 1) */
+        void setNumThreads(size_t n);
+
         /** Render.
             Produces an image using the given settings.
             \param rng Random number generator
@@ -62,6 +67,7 @@ namespace gfx { namespace gen {
         int m_sunRelX;
         int m_sunRelY;
         int m_sunRelZ;
+        size_t m_numThreads;
     };
 
 } }
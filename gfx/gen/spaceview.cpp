@@ -37,8 +37,10 @@
 
 #include <cmath>
 #include <algorithm>
+#include <vector>
 #include "gfx/gen/spaceview.hpp"
 #include "gfx/gen/perlinnoise.hpp"
+#include "gfx/gen/tilerenderer.hpp"
 #include "util/math.hpp"
 
 namespace {
@@ -57,11 +59,103 @@ namespace {
     }
 }
 
+/*
+ *  NebulaRenderer
+ *
+ *  Renders tiles of a nebula.
+ *  Noise values for a complete row are computed at once.
+ *  Each tile uses its own buffers, so tiles can be rendered in parallel.
+ */
+
+class gfx::gen::SpaceView::NebulaRenderer : public TileRenderer::Handler {
+ public:
+    NebulaRenderer(RGBAPixmap& pix, util::RandomNumberGenerator& rng, ColorQuad_t color, Value_t scale, Value_t intensity, Value_t falloff)
+        : m_pixmap(pix),
+          m_noise(rng),
+          m_color(color),
+          m_scale(1.0 / scale),
+          m_intensity(intensity),
+          m_falloff(falloff)
+        { }
+
+    virtual void renderTile(int minY, int maxY);
+
+ private:
+    RGBAPixmap& m_pixmap;
+    const PerlinNoise m_noise;
+    const ColorQuad_t m_color;
+    const Value_t m_scale;
+    const Value_t m_intensity;
+    const Value_t m_falloff;
+};
+
+void
+gfx::gen::SpaceView::NebulaRenderer::renderTile(int minY, int maxY)
+{
+    const int width = m_pixmap.getWidth();
+    if (width <= 0) {
+        return;
+    }
+    const size_t n = size_t(width);
+
+    std::vector<Value_t> x(n), y(n), px(n), py(n), value(n);
+    for (int yy = minY; yy < maxY; ++yy) {
+        for (int xx = 0; xx < width; ++xx) {
+            x[xx] = xx * m_scale;
+            y[xx] = yy * m_scale;
+        }
+
+        // Recursive noise field, starting with the innermost level:
+        //   f(x, y, depth, mult) = noise(x*mult + f(x, y, depth-1, mult*2), ...)
+        //   f(x, y, 0, mult)     = noise(x*mult, y*mult)
+        // with depth=5, mult=0.5.
+        const int32_t DEPTH = 5;
+        for (int32_t level = 0; level <= DEPTH; ++level) {
+            Value_t mult = 0.5;
+            for (int32_t i = level; i < DEPTH; ++i) {
+                mult *= 2;
+            }
+            if (level == 0) {
+                for (size_t i = 0; i < n; ++i) {
+                    px[i] = x[i] * mult;
+                    py[i] = y[i] * mult;
+                }
+            } else {
+                for (size_t i = 0; i < n; ++i) {
+                    px[i] = x[i] * mult + value[i];
+                    py[i] = y[i] * mult + value[i];
+                }
+            }
+            m_noise.noise(&px[0], &py[0], &value[0], n);
+        }
+
+        // Produce pixels
+        for (int xx = 0; xx < width; ++xx) {
+            Value_t i = std::min(Value_t(1.0), value[xx] * m_intensity);
+            i = std::pow(i, m_falloff);
+            put(m_pixmap, xx, yy, m_color + COLORQUAD_FROM_RGBA(0, 0, 0, uint8_t(i * 255)));
+        }
+    }
+}
+
+
+/*
+ *  SpaceView
+ */
+
 // Constructor.
 gfx::gen::SpaceView::SpaceView(RGBAPixmap& pix)
-    : m_pixmap(pix)
+    : m_pixmap(pix),
+      m_numThreads(1)
 { }
 
+// Set number of threads.
+void
+gfx::gen::SpaceView::setNumThreads(size_t numThreads)
+{
+    m_numThreads = numThreads;
+}
+
 // Render starfield (far stars).
 void
 gfx::gen::SpaceView::renderStarfield(util::RandomNumberGenerator& rng)
@@ -103,17 +197,8 @@ gfx::gen::SpaceView::renderStar(ColorQuad_t color, Point pos, Value_t size)
 void
 gfx::gen::SpaceView::renderNebula(util::RandomNumberGenerator& rng, ColorQuad_t color, Value_t scale, Value_t intensity, Value_t falloff)
 {
-    PerlinNoise pn(rng);
-
-    const int width = m_pixmap.getWidth();
-    const int height = m_pixmap.getHeight();
-    const Value_t nscale = 1.0 / scale;
-
-    for (int y = 0; y < height; ++y) {
-        for (int x = 0; x < width; ++x) {
-            put(m_pixmap, x, y, field(pn, color, x * nscale, y * nscale, intensity, falloff));
-        }
-    }
+    NebulaRenderer r(m_pixmap, rng, color, scale, intensity, falloff);
+    TileRenderer(m_numThreads).render(r, 0, m_pixmap.getHeight());
 }
 
 // Render sun (close star).
@@ -139,22 +224,3 @@ gfx::gen::SpaceView::renderSun(ColorQuad_t color, Point pos, int size)
         }
     }
 }
-
-gfx::gen::SpaceView::Value_t
-gfx::gen::SpaceView::recursiveField(PerlinNoise& pn, Value_t x, Value_t y, int32_t depth, Value_t mult)
-{
-    if (depth <= 0) {
-        return pn.noise(x * mult, y * mult);
-    } else {
-        Value_t displace = recursiveField(pn, x, y, depth-1, mult * 2);
-        return pn.noise(x * mult + displace, y * mult + displace);
-    }
-}
-
-inline gfx::ColorQuad_t
-gfx::gen::SpaceView::field(PerlinNoise& pn, ColorQuad_t rgb, Value_t x, Value_t y, Value_t intensity, Value_t falloff)
-{
-    Value_t i = std::min(Value_t(1.0), recursiveField(pn, x, y, 5, 0.5) * intensity);
-    i = std::pow(i, falloff);
-    return rgb + COLORQUAD_FROM_RGBA(0, 0, 0, uint8_t(i * 255));
-}
@@ -24,6 +24,11 @@ namespace gfx { namespace gen {
             \param pix Output pixmap */
         explicit SpaceView(RGBAPixmap& pix);
 
+        /** Set number of threads.
+            Used for renderNebula(); the result does not depend on the number of threads.
+            \param numThreads Number of threads (0 or 1 to render in the calling thread only; default) */
+        void setNumThreads(size_t numThreads);
+
         /** Render starfield (far stars).
             This just renders a number of single-dot stars.
             \param rng [in/out] random number generator */
@@ -50,10 +55,10 @@ namespace gfx { namespace gen {
         void renderSun(ColorQuad_t color, Point pos, int size);
 
      private:
-        RGBAPixmap& m_pixmap;
+        class NebulaRenderer;
 
-        static Value_t recursiveField(PerlinNoise& pn, Value_t x, Value_t y, int32_t depth, Value_t mult);
-        static ColorQuad_t field(PerlinNoise& pn, ColorQuad_t rgb, Value_t x, Value_t y, Value_t intensity, Value_t falloff);
+        RGBAPixmap& m_pixmap;
+        size_t m_numThreads;
     };
 
 } }
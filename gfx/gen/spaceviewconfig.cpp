@@ -12,7 +12,8 @@ gfx::gen::SpaceViewConfig::SpaceViewConfig()
     : m_width(640),
       m_height(480),
       m_numSuns(1),
-      m_starProbability(95)
+      m_starProbability(95),
+      m_numThreads(1)
 { }
 
 // Set image size.
@@ -37,6 +38,13 @@ gfx::gen::SpaceViewConfig::setStarProbability(int n)
     m_starProbability = n;
 }
 
+// Set number of threads.
+void
+gfx::gen::SpaceViewConfig::setNumThreads(size_t n)
+{
+    m_numThreads = n;
+}
+
 // Render.
 afl::base::Ref<gfx::RGBAPixmap>
 gfx::gen::SpaceViewConfig::render(util::RandomNumberGenerator& rng) const
@@ -46,6 +54,7 @@ gfx::gen::SpaceViewConfig::render(util::RandomNumberGenerator& rng) const
     // Create canvas
     afl::base::Ref<RGBAPixmap> result = RGBAPixmap::create(m_width, m_height);
     SpaceView renderer(*result);
+    renderer.setNumThreads(m_numThreads);
 
     // Scale factor to scale things
     const int scale = std::max(m_width, m_height);
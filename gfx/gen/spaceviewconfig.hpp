@@ -35,6 +35,11 @@ namespace gfx { namespace gen {
             \param n Percentage (default: 95) */
         void setStarProbability(int n);
 
+        /** Set number of threads.
+            The result does not depend on the number of threads.
+            \param n Number of threads (default: 1) */
+        void setNumThreads(size_t n);
+
         /** Render.
             Produces an image using the given settings.
             \param rng Random number generator
@@ -46,6 +51,7 @@ namespace gfx { namespace gen {
         int m_height;
         int m_numSuns;
         int m_starProbability;
+        size_t m_numThreads;
     };
 
 } }
@@ -0,0 +1,45 @@
+/**
+  *  \file gfx/gen/tilerenderer.cpp
+  *  \brief Class gfx::gen::TileRenderer
+  */
+
+#include <algorithm>
+#include "gfx/gen/tilerenderer.hpp"
+
+namespace {
+    /* Number of rows per tile.
+       Small enough to balance load between threads, large enough to keep locking overhead low. */
+    const int TILE_HEIGHT = 8;
+
+    /* Worker: renders tile number /index/, using a shared handler. */
+    class TileWorker : public util::WorkQueue::Worker {
+     public:
+        TileWorker(gfx::gen::TileRenderer::Handler& h, int minY, int maxY)
+            : m_handler(h), m_minY(minY), m_maxY(maxY)
+            { }
+        virtual void process(size_t index)
+            {
+                const int y = m_minY + int(index) * TILE_HEIGHT;
+                m_handler.renderTile(y, std::min(m_maxY, y + TILE_HEIGHT));
+            }
+     private:
+        gfx::gen::TileRenderer::Handler& m_handler;
+        int m_minY;
+        int m_maxY;
+    };
+}
+
+gfx::gen::TileRenderer::TileRenderer(size_t numThreads)
+    : m_queue(numThreads, "gfx.gen.tile")
+{ }
+
+gfx::gen::TileRenderer::~TileRenderer()
+{ }
+
+void
+gfx::gen::TileRenderer::render(Handler& h, int minY, int maxY)
+{
+    const size_t numTiles = (maxY > minY ? size_t((maxY - minY + TILE_HEIGHT - 1) / TILE_HEIGHT) : 0);
+    TileWorker w(h, minY, maxY);
+    m_queue.run(numTiles, w);
+}
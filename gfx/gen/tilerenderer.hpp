@@ -0,0 +1,53 @@
+/**
+  *  \file gfx/gen/tilerenderer.hpp
+  *  \brief Class gfx::gen::TileRenderer
+  */
+#ifndef C2NG_GFX_GEN_TILERENDERER_HPP
+#define C2NG_GFX_GEN_TILERENDERER_HPP
+
+#include "afl/base/deletable.hpp"
+#include "afl/base/types.hpp"
+#include "util/workqueue.hpp"
+
+namespace gfx { namespace gen {
+
+    /** Parallel rendering of image tiles.
+        Splits a range of rows into tiles (bands of a few rows each) and distributes them to a number of threads.
+        The calling thread acts as a worker, too.
+
+        The actual work is done by a Handler, which must be able to render different tiles in parallel.
+        If each pixel is computed only from its coordinates and shared read-only data,
+        the result does not depend on the number of threads. */
+    class TileRenderer {
+     public:
+        /** Tile handler. */
+        class Handler : public afl::base::Deletable {
+         public:
+            /** Render a tile.
+                May be called from any thread.
+                \param minY First row
+                \param maxY Last row (exclusive) */
+            virtual void renderTile(int minY, int maxY) = 0;
+        };
+
+        /** Constructor.
+            \param numThreads  Number of threads to use (0 or 1 to render all tiles in the calling thread) */
+        explicit TileRenderer(size_t numThreads);
+
+        /** Destructor. */
+        ~TileRenderer();
+
+        /** Render.
+            Returns when all tiles have been rendered.
+            \param h     Handler
+            \param minY  First row
+            \param maxY  Last row (exclusive) */
+        void render(Handler& h, int minY, int maxY);
+
+     private:
+        util::WorkQueue m_queue;
+    };
+
+} }
+
+#endif
@@ -3,6 +3,7 @@
   *  \brief Class gfx::PalettizedPixmap
   */
 
+#include <algorithm>
 #include <cstdlib>
 #include "gfx/palettizedpixmap.hpp"
 #include "gfx/primitives.hpp"
@@ -21,6 +22,9 @@ class gfx::PalettizedPixmap::TraitsImpl {
         { *ptr = val; }
     Pixel_t mix(Pixel_t a, Pixel_t b, Alpha_t balpha) const
         { return m_pix.findNearestColor(mixColor(m_pix.m_palette[a & 255], m_pix.m_palette[b & 255], balpha)); }
+    void fill(Data_t* ptr, int n, Pixel_t val) const
+        { std::fill_n(ptr, n, val); }
+    void mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const;
     inline Data_t* add(Data_t* ptr, int dx, int dy) const
         { return ptr + m_pix.getWidth()*dy + dx; }
 
@@ -32,6 +36,25 @@ class gfx::PalettizedPixmap::TraitsImpl {
     PalettizedPixmap& m_pix;
 };
 
+void
+gfx::PalettizedPixmap::TraitsImpl::mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const
+{
+    // With constant color and alpha, the result depends only on the background.
+    // Because mix() needs a palette search, compute it only once for each background color in the run.
+    uint8_t cache[256];
+    bool known[256];
+    std::fill_n(known, 256, false);
+    while (n > 0) {
+        const uint8_t bg = *ptr;
+        if (!known[bg]) {
+            cache[bg] = mix(bg, val, balpha);
+            known[bg] = true;
+        }
+        *ptr++ = cache[bg];
+        --n;
+    }
+}
+
 class gfx::PalettizedPixmap::CanvasImpl : public gfx::PixmapCanvasImpl<PalettizedPixmap, TraitsImpl> {
  public:
     CanvasImpl(afl::base::Ref<PalettizedPixmap> pix)
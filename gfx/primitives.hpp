@@ -28,7 +28,12 @@ namespace gfx {
         - <tt>Pixel_t peek(Data_t*)</tt>: read a pixel
         - <tt>void poke(Data_t*, Pixel_t)</tt>: write a pixel
         - <tt>Pixel_t mix(Pixel_t a, Pixel_b b, Alpha_t balpha)</tt>: alpha blending
-        - <tt>Data_t* add(Data_t*, int dx, int dy)</tt>: update data pointer */
+        - <tt>void fill(Data_t*, int n, Pixel_t)</tt>: write a run of n pixels (same as n times poke/add(1,0))
+        - <tt>void mixFill(Data_t*, int n, Pixel_t b, Alpha_t balpha)</tt>: alpha-blend a run of n pixels (same as n times peek/mix/poke/add(1,0))
+        - <tt>Data_t* add(Data_t*, int dx, int dy)</tt>: update data pointer
+
+        Runs are the unit of work for vectorized or cached implementations.
+        Solid lines and bars, and runs of equal bits in patterns, are passed to fill/mixFill as a whole. */
     template<class T>
     class Primitives {
      public:
@@ -92,6 +97,12 @@ namespace gfx {
         void doBlitPattern(Rectangle rect, const Point& pt, int bytesPerLine, const uint8_t* data, Color_t color, Color_t bg, Alpha_t alpha);
 
      private:
+        /* Draw horizontal line with pattern, as runs. */
+        inline void doPatternLine(int x1, int y1, int x2, Pixel_t color, LinePattern_t pat, Alpha_t alpha);
+
+        /* Draw a run of pixels. */
+        inline void doRun(Data_t* p, int n, Pixel_t color, Alpha_t alpha);
+
         /* Blit pattern for transparent patterns, solid (no background color, no alpha). */
         inline void doBlitPatternTransp(Rectangle rect, Point pt, int bytesPerLine, const uint8_t* data, Pixel_t color);
 
@@ -142,51 +153,14 @@ template<typename T>
 void
 gfx::Primitives<T>::doHLine(int x1, int y1, int x2, Color_t color, LinePattern_t pat, Alpha_t alpha)
 {
-    if (pat == 0 || alpha == TRANSPARENT_ALPHA) {
+    if (pat == 0 || alpha == TRANSPARENT_ALPHA || x1 >= x2) {
         /* nothing */
+    } else if (pat == 255) {
+        /* solid line */
+        doRun(m_traits.get(x1, y1), x2 - x1, static_cast<Pixel_t>(color), alpha);
     } else {
-        Data_t* p = m_traits.get(x1, y1);
-        if (alpha == OPAQUE_ALPHA) {
-            if (pat == 255) {
-                /* solid line */
-                while (x1 < x2) {
-                    m_traits.poke(p, static_cast<Pixel_t>(color));
-                    p = m_traits.add(p, 1, 0);
-                    ++x1;
-                }
-            } else {
-                /* pattern line */
-                uint8_t mask = afl::bits::rotateRight8(0x80, x1);
-                while (x1 < x2) {
-                    if (mask & pat) {
-                        m_traits.poke(p, static_cast<Pixel_t>(color));
-                    }
-                    p = m_traits.add(p, 1, 0);
-                    ++x1;
-                    mask = afl::bits::rotateRight8(mask, 1);
-                }
-            }
-        } else {
-            if (pat == 255) {
-                /* solid line */
-                while (x1 < x2) {
-                    m_traits.poke(p, m_traits.mix(m_traits.peek(p), static_cast<Pixel_t>(color), alpha));
-                    p = m_traits.add(p, 1, 0);
-                    ++x1;
-                }
-            } else {
-                /* pattern line */
-                uint8_t mask = afl::bits::rotateRight8(0x80, x1);
-                while (x1 < x2) {
-                    if (mask & pat) {
-                        m_traits.poke(p, m_traits.mix(m_traits.peek(p), static_cast<Pixel_t>(color), alpha));
-                    }
-                    p = m_traits.add(p, 1, 0);
-                    ++x1;
-                    mask = afl::bits::rotateRight8(mask, 1);
-                }
-            }
-        }
+        /* pattern line */
+        doPatternLine(x1, y1, x2, static_cast<Pixel_t>(color), pat, alpha);
     }
 }
 
@@ -353,25 +327,28 @@ gfx::Primitives<T>::doBlitPatternAlpha(Rectangle rect, Point pt, int bytesPerLin
     const int y = rect.getTopY() - pt.getY();                 // lines to skip in data image
     data += bytesPerLine * y + x/8;
 
-    const uint8_t zmask = uint8_t(0x80 >> (x & 7));
+    const int zbit = x & 7;
+    const int w = rect.getWidth();
     Data_t* zmem = m_traits.get(rect.getLeftX(), rect.getTopY());
     int h = rect.getHeight();
     while (h > 0) {
-        uint8_t mask = zmask;
         Data_t* mem = zmem;
-        const uint8_t* pat = data;
-        for (int k = 0; k < rect.getWidth(); ++k) {
-            if (*pat & mask) {
-                m_traits.poke(mem, m_traits.mix(m_traits.peek(mem), color, alpha));
-            } else if (bg != TRANSPARENT_COLOR) {
-                m_traits.poke(mem, m_traits.mix(m_traits.peek(mem), Pixel_t(bg), alpha));
+        int k = 0;
+        while (k < w) {
+            // Find run of equal bits
+            const uint8_t bit = uint8_t(data[(zbit + k) / 8] & (0x80 >> ((zbit + k) & 7)));
+            int end = k + 1;
+            while (end < w && (data[(zbit + end) / 8] & (0x80 >> ((zbit + end) & 7))) == bit) {
+                ++end;
             }
-            mem = m_traits.add(mem, 1, 0);
-            mask = uint8_t(mask >> 1);
-            if (!mask) {
-                mask = 0x80;
-                ++pat;
+
+            if (bit != 0) {
+                m_traits.mixFill(mem, end - k, color, alpha);
+            } else if (bg != TRANSPARENT_COLOR) {
+                m_traits.mixFill(mem, end - k, Pixel_t(bg), alpha);
             }
+            mem = m_traits.add(mem, end - k, 0);
+            k = end;
         }
         --h;
         data += bytesPerLine;
@@ -379,4 +356,40 @@ gfx::Primitives<T>::doBlitPatternAlpha(Rectangle rect, Point pt, int bytesPerLin
     }
 }
 
+// Draw horizontal line with pattern, as runs.
+template<typename T>
+inline void
+gfx::Primitives<T>::doPatternLine(int x1, int y1, int x2, Pixel_t color, LinePattern_t pat, Alpha_t alpha)
+{
+    Data_t* p = m_traits.get(x1, y1);
+    uint8_t mask = afl::bits::rotateRight8(0x80, x1);
+    while (x1 < x2) {
+        // Find run of equal bits
+        const bool set = (mask & pat) != 0;
+        int n = 0;
+        do {
+            ++n;
+            mask = afl::bits::rotateRight8(mask, 1);
+        } while (x1 + n < x2 && ((mask & pat) != 0) == set);
+
+        if (set) {
+            doRun(p, n, color, alpha);
+        }
+        p = m_traits.add(p, n, 0);
+        x1 += n;
+    }
+}
+
+// Draw a run of pixels.
+template<typename T>
+inline void
+gfx::Primitives<T>::doRun(Data_t* p, int n, Pixel_t color, Alpha_t alpha)
+{
+    if (alpha == OPAQUE_ALPHA) {
+        m_traits.fill(p, n, color);
+    } else {
+        m_traits.mixFill(p, n, color, alpha);
+    }
+}
+
 #endif
@@ -3,6 +3,7 @@
   *  \brief Class gfx::RGBAPixmap
   */
 
+#include <algorithm>
 #include "gfx/rgbapixmap.hpp"
 #include "gfx/pixmapcanvasimpl.hpp"
 
@@ -19,6 +20,10 @@ class gfx::RGBAPixmap::TraitsImpl {
         { *ptr = val; }
     Pixel_t mix(Pixel_t a, Pixel_t b, Alpha_t balpha) const
         { return mixColor(a, b, balpha); }
+    void fill(Data_t* ptr, int n, Pixel_t val) const
+        { std::fill_n(ptr, n, val); }
+    void mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const
+        { mixColors(ptr, size_t(n), val, balpha); }
     inline Data_t* add(Data_t* ptr, int dx, int dy) const
         { return ptr + m_pix.getWidth()*dy + dx; }
 
@@ -82,6 +87,12 @@ gfx::RGBAPixmap::makeCanvas()
     return *new CanvasImpl(*this);
 }
 
+bool
+gfx::RGBAPixmap::isPixmapCanvas(Canvas& can)
+{
+    return dynamic_cast<CanvasImpl*>(&can) != 0;
+}
+
 void
 gfx::RGBAPixmap::setAlpha(uint8_t alpha)
 {
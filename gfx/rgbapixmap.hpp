@@ -37,6 +37,11 @@ namespace gfx {
             \return newly-allocated canvas */
         afl::base::Ref<Canvas> makeCanvas();
 
+        /** Check for RGBAPixmap canvas.
+            \param can Canvas
+            \return true if can has been created by makeCanvas() of a RGBAPixmap */
+        static bool isPixmapCanvas(Canvas& can);
+
         /** Set pixmap alpha.
             Pixels have individual alpha channels that are used when this pixmap is blitted anywhere.
             This function sets the alpha channel for the whole pixmap (by modifying all pixels) to a single value for the whole pixmap.
@@ -7,6 +7,7 @@
 #ifndef C2NG_GFX_SDL_MODETRAITS_HPP
 #define C2NG_GFX_SDL_MODETRAITS_HPP
 
+#include <algorithm>
 #include <SDL_video.h>
 #include "afl/base/types.hpp"
 #include "gfx/types.hpp"
@@ -21,7 +22,9 @@ namespace gfx { namespace sdl {
         - T::peek(ptr)     = read video memory at specified address
         - T::poke(ptr,val) = modify video memory at specified address
         - T::add(ptr,diff) = advance ptr by diff pixels
-        - T::mix(fmt,val,val,alpha) = alpha mixing */
+        - T::mix(fmt,val,val,alpha) = alpha mixing
+        - T::fill(ptr,n,val) = write a run of pixels
+        - T::mixFill(ptr,n,val,alpha) = alpha-mix a run of pixels */
     //@{
     /// Traits for 8-bit pixel-mapped surface.
     struct ModeTraits8 {
@@ -32,6 +35,8 @@ namespace gfx { namespace sdl {
         static inline Pixel_t peek(Data_t* ptr)                       { return *ptr; }
         static inline void poke(Data_t* ptr, Pixel_t val)             { *ptr = val; }
         inline Pixel_t mix(Pixel_t a, Pixel_t b, Alpha_t balpha) const;
+        inline void fill(Data_t* ptr, int n, Pixel_t val) const;
+        inline void mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const;
         inline Data_t* add(Data_t* ptr, int dx, int dy) const         { return ptr + sfc->pitch*dy + dx; }
 
         ModeTraits8(SDL_Surface* sfc)
@@ -49,6 +54,8 @@ namespace gfx { namespace sdl {
         static inline Pixel_t peek(Data_t* ptr)                       { return *(Pixel_t*)ptr; }
         static inline void poke(Data_t* ptr, Pixel_t val)             { *(Pixel_t*)ptr = val; }
         inline Pixel_t mix(Pixel_t a, Pixel_t b, Alpha_t balpha) const;
+        inline void fill(Data_t* ptr, int n, Pixel_t val) const;
+        inline void mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const;
         inline Data_t* add(Data_t* ptr, int dx, int dy) const         { return ptr + sfc->pitch*dy + 2*dx; }
 
         ModeTraits16(SDL_Surface* sfc)
@@ -66,6 +73,8 @@ namespace gfx { namespace sdl {
         static inline Pixel_t peek(Data_t* ptr)                      { return *(Pixel_t*)ptr; }
         static inline void poke(Data_t* ptr, Pixel_t val)            { *(Pixel_t*)ptr = val; }
         inline Pixel_t mix(Pixel_t a, Pixel_t b, Alpha_t balpha) const;
+        inline void fill(Data_t* ptr, int n, Pixel_t val) const;
+        inline void mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const;
         inline Data_t* add(Data_t* ptr, int dx, int dy) const        { return ptr + sfc->pitch*dy + 4*dx; }
 
         ModeTraits32(SDL_Surface* sfc)
@@ -97,6 +106,8 @@ namespace gfx { namespace sdl {
             {
                 return ModeTraits32(sfc).mix(a, b, balpha);
             }
+        inline void fill(Data_t* ptr, int n, Pixel_t val) const;
+        inline void mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const;
         inline Data_t* add(Data_t* ptr, int dx, int dy) const
             {
                 return ptr + sfc->pitch*dy + 3*dx;
@@ -144,6 +155,87 @@ gfx::sdl::ModeTraits32::mix(Pixel_t a, Pixel_t b, Alpha_t balpha) const
     return re | gr | bl;
 }
 
+void
+gfx::sdl::ModeTraits8::fill(Data_t* ptr, int n, Pixel_t val) const
+{
+    while (n-- > 0) {
+        poke(ptr, val);
+        ptr = add(ptr, 1, 0);
+    }
+}
+
+void
+gfx::sdl::ModeTraits8::mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const
+{
+    // mix() needs a palette search; do it only once for each background color in the run.
+    uint8_t cache[256];
+    bool known[256];
+    std::fill_n(known, 256, false);
+    while (n-- > 0) {
+        Pixel_t bg = peek(ptr);
+        if (!known[bg]) {
+            cache[bg] = mix(bg, val, balpha);
+            known[bg] = true;
+        }
+        poke(ptr, cache[bg]);
+        ptr = add(ptr, 1, 0);
+    }
+}
+
+void
+gfx::sdl::ModeTraits16::fill(Data_t* ptr, int n, Pixel_t val) const
+{
+    while (n-- > 0) {
+        poke(ptr, val);
+        ptr = add(ptr, 1, 0);
+    }
+}
+
+void
+gfx::sdl::ModeTraits16::mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const
+{
+    while (n-- > 0) {
+        poke(ptr, mix(peek(ptr), val, balpha));
+        ptr = add(ptr, 1, 0);
+    }
+}
+
+void
+gfx::sdl::ModeTraits32::fill(Data_t* ptr, int n, Pixel_t val) const
+{
+    while (n-- > 0) {
+        poke(ptr, val);
+        ptr = add(ptr, 1, 0);
+    }
+}
+
+void
+gfx::sdl::ModeTraits32::mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const
+{
+    while (n-- > 0) {
+        poke(ptr, mix(peek(ptr), val, balpha));
+        ptr = add(ptr, 1, 0);
+    }
+}
+
+void
+gfx::sdl::ModeTraits24::fill(Data_t* ptr, int n, Pixel_t val) const
+{
+    while (n-- > 0) {
+        poke(ptr, val);
+        ptr = add(ptr, 1, 0);
+    }
+}
+
+void
+gfx::sdl::ModeTraits24::mixFill(Data_t* ptr, int n, Pixel_t val, Alpha_t balpha) const
+{
+    while (n-- > 0) {
+        poke(ptr, mix(peek(ptr), val, balpha));
+        ptr = add(ptr, 1, 0);
+    }
+}
+
 /** Pixel Format Switch.
     \param sfc      surface
     \param call     function call to invoke on the appropriate ModeTraits */
@@ -3,15 +3,18 @@
   *  \brief gfx::threed::ModelApplet
   */
 
+#include <algorithm>
 #include "gfx/threed/modelapplet.hpp"
 #include "afl/base/countof.hpp"
 #include "afl/string/format.hpp"
+#include "afl/sys/time.hpp"
 #include "gfx/basecontext.hpp"
 #include "gfx/complex.hpp"
 #include "gfx/defaultfont.hpp"
 #include "gfx/eventconsumer.hpp"
 #include "gfx/font.hpp"
 #include "gfx/point.hpp"
+#include "gfx/rgbapixmap.hpp"
 #include "gfx/threed/colortransformation.hpp"
 #include "gfx/threed/context.hpp"
 #include "gfx/threed/model.hpp"
@@ -21,13 +24,20 @@
 #include "gfx/types.hpp"
 #include "gfx/windowparameters.hpp"
 #include "util/math.hpp"
+#include "util/systeminformation.hpp"
 
 using afl::base::Ref;
 using afl::io::FileSystem;
 using afl::string::Format;
+using afl::sys::LogListener;
 using gfx::threed::Vec3f;
 
 namespace {
+    const char*const LOG_NAME = "gfx.threed";
+
+    /* Number of frames for benchmark */
+    const int BENCHMARK_FRAMES = 100;
+
     static const gfx::ColorQuad_t BACKGROUND_COLORS[] = {
         COLORQUAD_FROM_RGB(0,0,40),
         COLORQUAD_FROM_RGB(0,0,0),
@@ -108,9 +118,12 @@ namespace {
  */
 class gfx::threed::ModelApplet::App : public EventConsumer {
  public:
-    App(Canvas& can, Ref<Context> ctx, Model& model)
+    App(Canvas& can, Ref<SoftwareContext> ctx, Model& model, LogListener& log)
         : m_stop(false),
-          m_canvas(can),
+          m_window(can),
+          m_frame(RGBAPixmap::create(can.getSize().getX(), can.getSize().getY())),
+          m_canvas(m_frame->makeCanvas()),
+          m_log(log),
           m_model(model),
           m_projection(Mat4f::perspective(45 * util::PI / 180, double(can.getSize().getX()) / can.getSize().getY(), 0.1)),
           m_azimut(),
@@ -118,6 +131,7 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
           m_distance(6.0),
           m_backgroundColor(0),
           m_playerColor(0),
+          m_numThreads(util::getSystemInformation().numProcessors),
           m_context(ctx),
           m_showModel(!false),
           m_showOutline(!true),
@@ -129,6 +143,7 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
           m_posList(),
           m_font(createDefaultFont())
         {
+            m_context->setNumThreads(m_numThreads);
             updateModel();
             draw();
         }
@@ -164,7 +179,7 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
 
             // Draw
             clear();
-            m_context->start(getSize(), m_canvas);
+            m_context->start(getSize(), *m_canvas);
             if (m_showModel) {
                 m_modelRenderer->render(m_projection, mv);
             }
@@ -180,6 +195,27 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
             if (m_showLabels) {
                 drawLabels(m_projection, mv);
             }
+
+            // Show. Rendering into an offscreen RGBAPixmap allows SoftwareContext to use multiple threads.
+            m_frame->setAlpha(OPAQUE_ALPHA);
+            m_window.blit(Point(), *m_canvas, getSize());
+        }
+
+    void runBenchmark()
+        {
+            // Render a full turn
+            const double savedAzimut = m_azimut;
+            const uint32_t start = afl::sys::Time::getTickCounter();
+            for (int i = 0; i < BENCHMARK_FRAMES; ++i) {
+                m_azimut = savedAzimut + 2 * util::PI * i / BENCHMARK_FRAMES;
+                draw();
+            }
+            const uint32_t elapsed = std::max(afl::sys::Time::getTickCounter() - start, uint32_t(1));
+            m_azimut = savedAzimut;
+            draw();
+
+            m_log.write(LogListener::Info, LOG_NAME, Format("%d frames in %d ms, %.1f fps, %d thread%!1{s%}",
+                                                            BENCHMARK_FRAMES, elapsed, BENCHMARK_FRAMES * 1000.0 / elapsed, m_numThreads));
         }
 
     void clear()
@@ -187,17 +223,17 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
             // Clear the canvas with a predefined color
             ColorQuad_t quad[1] = {BACKGROUND_COLORS[m_backgroundColor]};
             Color_t color[1];
-            m_canvas.encodeColors(quad, color);
-            m_canvas.drawBar(getSize(), color[0], color[0], FillPattern::SOLID, OPAQUE_ALPHA);
+            m_canvas->encodeColors(quad, color);
+            m_canvas->drawBar(getSize(), color[0], color[0], FillPattern::SOLID, OPAQUE_ALPHA);
         }
 
     void drawLabels(const Mat4f& proj, const Mat4f& mv)
         {
             ColorQuad_t quad[1] = {COLORQUAD_FROM_RGB(255,255,255)};
             Color_t color[1];
-            m_canvas.encodeColors(quad, color);
+            m_canvas->encodeColors(quad, color);
 
-            BaseContext ctx(m_canvas);
+            BaseContext ctx(*m_canvas);
             ctx.setRawColor(color[0]);
             ctx.useFont(*m_font);
             ctx.setTextAlign(LeftAlign, MiddleAlign);
@@ -216,7 +252,7 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
     Rectangle getSize()
         {
             // Shortcut for getting canvas size
-            return Rectangle(Point(), m_canvas.getSize());
+            return Rectangle(Point(), m_canvas->getSize());
         }
 
     virtual bool handleKey(util::Key_t key, int /*prefix*/)
@@ -247,6 +283,16 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
                 draw();
                 return true;
 
+             case 'f':
+                runBenchmark();
+                return true;
+
+             case 'j':
+                m_numThreads = (m_numThreads > 1 ? 1 : util::getSystemInformation().numProcessors);
+                m_context->setNumThreads(m_numThreads);
+                draw();
+                return true;
+
              case 'p':
                 m_playerColor = (m_playerColor+1) % countof(PLAYER_COLORS);
                 updateMesh();
@@ -300,7 +346,10 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
 
  private:
     bool m_stop;
-    Canvas& m_canvas;
+    Canvas& m_window;
+    Ref<RGBAPixmap> m_frame;
+    Ref<Canvas> m_canvas;
+    LogListener& m_log;
     Model& m_model;
 
     Mat4f m_projection;
@@ -309,8 +358,9 @@ class gfx::threed::ModelApplet::App : public EventConsumer {
     double m_distance;
     size_t m_backgroundColor;
     size_t m_playerColor;
+    size_t m_numThreads;
 
-    Ref<Context> m_context;
+    Ref<SoftwareContext> m_context;
 
     bool m_showModel;
     bool m_showOutline;
@@ -342,10 +392,10 @@ gfx::threed::ModelApplet::run(Application& app, Engine& engine, afl::sys::Enviro
     Ref<Canvas> window = engine.createWindow(WindowParameters());
 
     // 3D context
-    Ref<Context> ctx = SoftwareContext::create();
+    Ref<SoftwareContext> ctx = SoftwareContext::create();
 
     // App main loop
-    App c(*window, ctx, *model);
+    App c(*window, ctx, *model, app.log());
     while (!c.isStopped()) {
         engine.handleEvent(c, false);
     }
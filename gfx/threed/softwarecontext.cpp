@@ -10,6 +10,10 @@
   *  - to save some memory, don't store pointers; instead, store indexes into the list of Instances, or into the list of Primitives of an instance.
   *  - when finish() is called, sort all primitives by estimated Z order and draw from back to front, front overwriting back.
   *    (on the plus side, this means that particles just work.)
+  *  - with multiple threads, finish() assigns the sorted primitives to tiles (binning), using each primitive's bounding box.
+  *    Each tile is rendered into a private RGBAPixmap, drawing its primitives in the same order, using the same absolute coordinates.
+  *    Tiles are aligned to multiples of 8 pixels, so fill and line patterns are not affected.
+  *    Drawing functions clip per pixel (not geometrically), so each pixel receives the same sequence of operations as in serial rendering.
   */
 
 #include <math.h>               // import into global namespace, isnan
@@ -19,6 +23,9 @@
 #include "afl/except/assertionfailedexception.hpp"
 #include "gfx/basecontext.hpp"
 #include "gfx/complex.hpp"
+#include "gfx/filter.hpp"
+#include "gfx/rgbapixmap.hpp"
+#include "util/workqueue.hpp"
 
 /* Fallback implementation of isnan.
    If we have a macro, assume it works.
@@ -39,6 +46,24 @@ static inline bool isnan(Wrap d, ...)
 #endif
 
 namespace {
+    /* Size of a tile for parallel rendering.
+       Must be a multiple of 8 to keep patterns aligned. */
+    const int TILE_SIZE = 64;
+
+    /* Round down to multiple of TILE_SIZE (also for negative values). */
+    int alignToTile(int v)
+    {
+        return v >= 0 ? v - v % TILE_SIZE : v - (TILE_SIZE - 1 - (-v - 1) % TILE_SIZE);
+    }
+
+    /* Get bounding rectangle of two points. */
+    gfx::Rectangle getBounds(const gfx::Point& a, const gfx::Point& b)
+    {
+        gfx::Rectangle r(a, gfx::Point(1, 1));
+        r.include(gfx::Rectangle(b, gfx::Point(1, 1)));
+        return r;
+    }
+
     gfx::Point convertCoordinates(const gfx::Rectangle& area, const gfx::threed::Vec3f& pos)
     {
         return gfx::Point(int((pos(0) + 1.0) * 0.5 * area.getWidth()  + area.getLeftX() + 0.5),
@@ -125,6 +150,10 @@ namespace {
 class gfx::threed::SoftwareContext::Instance : public afl::base::Deletable {
  public:
     virtual void renderPrimitive(const Rectangle& r, Canvas& can, Index_t index) = 0;
+
+    /* Get bounding rectangle of a primitive.
+       Must include all pixels renderPrimitive() can touch; may be larger. */
+    virtual Rectangle getPrimitiveBounds(Index_t index) = 0;
 };
 
 
@@ -144,6 +173,12 @@ class gfx::threed::SoftwareContext::LineRendererInstance : public Instance {
             drawLine(ctx, n.from, n.to);
         }
 
+    virtual Rectangle getPrimitiveBounds(Index_t index)
+        {
+            const Line& n = m_lines[index];
+            return getBounds(n.from, n.to);
+        }
+
     Index_t add(Point from, Point to, ColorQuad_t color)
         {
             Line n = {from, to, {color}};
@@ -290,6 +325,16 @@ class gfx::threed::SoftwareContext::TriangleRendererInstance : public Instance {
             drawFilledPolygon(ctx, t.pos);
         }
 
+    virtual Rectangle getPrimitiveBounds(Index_t index)
+        {
+            // Add a safety margin for rounding in drawFilledPolygon
+            const Triangle& t = m_triangles[index];
+            Rectangle r = getBounds(t.pos[0], t.pos[1]);
+            r.include(getBounds(t.pos[1], t.pos[2]));
+            r.grow(1, 1);
+            return r;
+        }
+
     Index_t add(const Point& a, const Point& b, const Point& c, ColorQuad_t color)
         {
             Triangle t = {{a,b,c}, {color}};
@@ -491,6 +536,16 @@ class gfx::threed::SoftwareContext::ParticleRendererInstance : public Instance {
             }
         }
 
+    virtual Rectangle getPrimitiveBounds(Index_t index)
+        {
+            // Largest circle has radius t.size (or 1 for small particles)
+            const Particle& t = m_particles[index];
+            Rectangle r(t.pos, Point(1, 1));
+            const int size = std::max(t.size, 1);
+            r.grow(size + 1, size + 1);
+            return r;
+        }
+
     Index_t add(const Point& a, float alpha, int size)
         {
             Particle t = {a, alpha, size};
@@ -600,6 +655,85 @@ class gfx::threed::SoftwareContext::ComparePrimitives {
 };
 
 
+/*
+ *  Parallel rendering
+ */
+
+/* A tile.
+   The tile's pixmap covers TILE_SIZE x TILE_SIZE pixels starting at origin;
+   of these, only 'area' is read from and written back to the canvas. */
+struct gfx::threed::SoftwareContext::Tile {
+    Rectangle area;
+    Point origin;
+    std::vector<size_t> primitives;       // Indexes into m_primitives, in drawing order
+    afl::base::Ptr<RGBAPixmap> pixmap;    // Pixels, null if no primitives
+    std::vector<ColorQuad_t> original;    // Original pixels, to detect changes
+
+    Tile(const Rectangle& area, const Point& origin)
+        : area(area), origin(origin), primitives(), pixmap(), original()
+        { }
+};
+
+/* Filter to draw into a tile's pixmap using absolute coordinates. */
+class gfx::threed::SoftwareContext::TileFilter : public Filter {
+ public:
+    TileFilter(Canvas& parent, Point origin)
+        : Filter(parent),
+          m_origin(origin)
+        { }
+
+    virtual void drawHLine(const Point& pt, int npix, Color_t color, LinePattern_t pat, Alpha_t alpha)
+        { parent().drawHLine(pt - m_origin, npix, color, pat, alpha); }
+    virtual void drawVLine(const Point& pt, int npix, Color_t color, LinePattern_t pat, Alpha_t alpha)
+        { parent().drawVLine(pt - m_origin, npix, color, pat, alpha); }
+    virtual void drawPixels(const Point& pt, afl::base::Memory<const Color_t> colors, Alpha_t alpha)
+        { parent().drawPixels(pt - m_origin, colors, alpha); }
+    virtual void drawBar(Rectangle rect, Color_t color, Color_t bg, const FillPattern& pat, Alpha_t alpha)
+        {
+            rect.moveBy(Point() - m_origin);
+            parent().drawBar(rect, color, bg, pat, alpha);
+        }
+    virtual void blit(const Point& pt, Canvas& src, Rectangle rect)
+        { parent().blit(pt - m_origin, src, rect); }
+    virtual void blitPattern(Rectangle rect, const Point& pt, int bytesPerLine, const uint8_t* data, Color_t color, Color_t bg, Alpha_t alpha)
+        {
+            rect.moveBy(Point() - m_origin);
+            parent().blitPattern(rect, pt - m_origin, bytesPerLine, data, color, bg, alpha);
+        }
+    virtual Rectangle computeClipRect(Rectangle r)
+        {
+            r.moveBy(Point() - m_origin);
+            r = parent().computeClipRect(r);
+            r.moveBy(m_origin);
+            return r;
+        }
+    virtual void getPixels(Point pt, afl::base::Memory<Color_t> colors)
+        { parent().getPixels(pt - m_origin, colors); }
+    virtual bool isVisible(Rectangle r)
+        { return computeClipRect(r).exists(); }
+    virtual bool isClipped(Rectangle r)
+        { return computeClipRect(r) != r; }
+
+ private:
+    Point m_origin;
+};
+
+/* Worker. Renders tile number /index/; shared by all threads. */
+class gfx::threed::SoftwareContext::TileWorker : public util::WorkQueue::Worker {
+ public:
+    TileWorker(SoftwareContext& parent, afl::container::PtrVector<Tile>& tiles)
+        : m_parent(parent), m_tiles(tiles)
+        { }
+
+    virtual void process(size_t index)
+        { m_parent.renderTile(*m_tiles[index]); }
+
+ private:
+    SoftwareContext& m_parent;
+    afl::container::PtrVector<Tile>& m_tiles;
+};
+
+
 /*
  *  SoftwareContext - Public Class
  */
@@ -608,7 +742,8 @@ gfx::threed::SoftwareContext::SoftwareContext()
     : m_instances(),
       m_primitives(),
       m_viewport(),
-      m_pCanvas()
+      m_pCanvas(),
+      m_numThreads(1)
 { }
 
 gfx::threed::SoftwareContext::~SoftwareContext()
@@ -637,9 +772,14 @@ gfx::threed::SoftwareContext::finish()
     // Depth sorting
     std::sort(m_primitives.begin(), m_primitives.end(), ComparePrimitives());
 
-    // Draw in order
-    for (std::vector<Primitive>::iterator it = m_primitives.begin(), end = m_primitives.end(); it != end; ++it) {
-        m_instances[it->instance]->renderPrimitive(m_viewport, *m_pCanvas, it->index);
+    if (m_numThreads > 1 && RGBAPixmap::isPixmapCanvas(*m_pCanvas)) {
+        // Parallel. Tiles are blended in RGBA format, so this is only pixel-identical for a RGBAPixmap target.
+        renderTiles();
+    } else {
+        // Draw in order
+        for (std::vector<Primitive>::iterator it = m_primitives.begin(), end = m_primitives.end(); it != end; ++it) {
+            m_instances[it->instance]->renderPrimitive(m_viewport, *m_pCanvas, it->index);
+        }
     }
 }
 
@@ -661,6 +801,12 @@ gfx::threed::SoftwareContext::createParticleRenderer()
     return *new ParticleRendererImpl(*this);
 }
 
+void
+gfx::threed::SoftwareContext::setNumThreads(size_t n)
+{
+    m_numThreads = n;
+}
+
 gfx::threed::SoftwareContext::Index_t
 gfx::threed::SoftwareContext::addNewInstance(Instance* p)
 {
@@ -682,3 +828,111 @@ gfx::threed::SoftwareContext::addPrimitive(float z, Index_t instance, Index_t in
     p.index = index;
     m_primitives.push_back(p);
 }
+
+void
+gfx::threed::SoftwareContext::renderTiles()
+{
+    // Bounding boxes
+    std::vector<Rectangle> bounds;
+    bounds.reserve(m_primitives.size());
+    Rectangle area;
+    for (std::vector<Primitive>::iterator it = m_primitives.begin(), end = m_primitives.end(); it != end; ++it) {
+        bounds.push_back(m_instances[it->instance]->getPrimitiveBounds(it->index));
+        area.include(bounds.back());
+    }
+    area = m_pCanvas->computeClipRect(area);
+    if (!area.exists()) {
+        return;
+    }
+
+    // Create tiles
+    const int x0 = alignToTile(area.getLeftX());
+    const int y0 = alignToTile(area.getTopY());
+    const int numX = (area.getRightX() - x0 + TILE_SIZE - 1) / TILE_SIZE;
+    const int numY = (area.getBottomY() - y0 + TILE_SIZE - 1) / TILE_SIZE;
+    afl::container::PtrVector<Tile> tiles;
+    for (int ty = 0; ty < numY; ++ty) {
+        for (int tx = 0; tx < numX; ++tx) {
+            const Point origin(x0 + tx*TILE_SIZE, y0 + ty*TILE_SIZE);
+            Rectangle r(origin, Point(TILE_SIZE, TILE_SIZE));
+            r.intersect(area);
+            tiles.pushBackNew(new Tile(r, origin));
+        }
+    }
+
+    // Binning
+    for (size_t i = 0, n = bounds.size(); i < n; ++i) {
+        Rectangle r = bounds[i];
+        r.intersect(area);
+        if (r.exists()) {
+            const int minX = (r.getLeftX()    - x0) / TILE_SIZE, maxX = (r.getRightX()  - 1 - x0) / TILE_SIZE;
+            const int minY = (r.getTopY()     - y0) / TILE_SIZE, maxY = (r.getBottomY() - 1 - y0) / TILE_SIZE;
+            for (int ty = minY; ty <= maxY; ++ty) {
+                for (int tx = minX; tx <= maxX; ++tx) {
+                    tiles[size_t(ty*numX + tx)]->primitives.push_back(i);
+                }
+            }
+        }
+    }
+
+    // Load background. This accesses the canvas and therefore happens in this thread.
+    std::vector<Color_t> buffer;
+    for (size_t i = 0, n = tiles.size(); i < n; ++i) {
+        Tile& t = *tiles[i];
+        if (!t.primitives.empty()) {
+            t.pixmap = RGBAPixmap::create(TILE_SIZE, TILE_SIZE).asPtr();
+            buffer.resize(t.area.getWidth());
+            for (int y = t.area.getTopY(); y < t.area.getBottomY(); ++y) {
+                m_pCanvas->getPixels(Point(t.area.getLeftX(), y), buffer);
+                m_pCanvas->decodeColors(buffer, t.pixmap->row(y - t.origin.getY()).subrange(t.area.getLeftX() - t.origin.getX(), t.area.getWidth()));
+            }
+            afl::base::Memory<const ColorQuad_t> pixels = t.pixmap->pixels();
+            t.original.assign(pixels.unsafeData(), pixels.unsafeData() + pixels.size());
+        }
+    }
+
+    // Render
+    TileWorker worker(*this, tiles);
+    util::WorkQueue(m_numThreads, "gfx.threed.tile").run(tiles.size(), worker);
+
+    // Write back changed pixels
+    for (size_t i = 0, n = tiles.size(); i < n; ++i) {
+        Tile& t = *tiles[i];
+        if (t.pixmap.get() != 0) {
+            for (int y = t.area.getTopY(); y < t.area.getBottomY(); ++y) {
+                const size_t rowOffset = (y - t.origin.getY()) * TILE_SIZE;
+                const ColorQuad_t* pix = t.pixmap->pixels().at(rowOffset);
+                const ColorQuad_t* orig = &t.original[rowOffset];
+                int x = t.area.getLeftX();
+                while (x < t.area.getRightX()) {
+                    const int dx = x - t.origin.getX();
+                    if (pix[dx] == orig[dx]) {
+                        ++x;
+                    } else {
+                        int end = x + 1;
+                        while (end < t.area.getRightX() && pix[end - t.origin.getX()] != orig[end - t.origin.getX()]) {
+                            ++end;
+                        }
+                        buffer.resize(end - x);
+                        m_pCanvas->encodeColors(afl::base::Memory<const ColorQuad_t>::unsafeCreate(pix + dx, end - x), buffer);
+                        m_pCanvas->drawPixels(Point(x, y), buffer, OPAQUE_ALPHA);
+                        x = end;
+                    }
+                }
+            }
+        }
+    }
+}
+
+void
+gfx::threed::SoftwareContext::renderTile(Tile& tile)
+{
+    if (tile.pixmap.get() != 0) {
+        afl::base::Ref<Canvas> can = tile.pixmap->makeCanvas();
+        TileFilter filter(*can, tile.origin);
+        for (size_t i = 0, n = tile.primitives.size(); i < n; ++i) {
+            const Primitive& p = m_primitives[tile.primitives[i]];
+            m_instances[p.instance]->renderPrimitive(m_viewport, filter, p.index);
+        }
+    }
+}
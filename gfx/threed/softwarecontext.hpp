@@ -20,7 +20,15 @@ namespace gfx { namespace threed {
 
         - no Z buffer. Intersecting primitives will look wrong.
         - no interpolation of normals or colors for triangles, i.e. flat shading.
-        - not optimized for speed. Still does a few 10000 primitives per second. */
+        - not optimized for speed. Still does a few 10000 primitives per second.
+
+        Rendering can use multiple threads (setNumThreads()).
+        In this case, finish() splits the affected area into tiles, assigns each primitive to the tiles it touches,
+        and renders the tiles in parallel into private buffers, each in the same back-to-front order as serial rendering.
+        Only the final copy into the target canvas happens in the calling thread, so the canvas need not be thread-safe.
+        Because tiles are blended in RGBA format, parallel rendering is only used if the target canvas is a RGBAPixmap,
+        making output pixel-identical to serial rendering. Other canvases are always rendered serially;
+        to render onto those in parallel, render into an offscreen RGBAPixmap and blit that. */
     class SoftwareContext : public Context {
      public:
         /** Create SoftwareContext.
@@ -35,6 +43,11 @@ namespace gfx { namespace threed {
         virtual afl::base::Ref<TriangleRenderer> createTriangleRenderer();
         virtual afl::base::Ref<ParticleRenderer> createParticleRenderer();
 
+        /** Set number of threads.
+            Has no effect unless the target canvas is a RGBAPixmap.
+            \param n Number of threads to use (0 or 1 to render everything in the calling thread) */
+        void setNumThreads(size_t n);
+
      private:
         SoftwareContext();
 
@@ -46,6 +59,10 @@ namespace gfx { namespace threed {
         class ParticleRendererInstance;
         class ParticleRendererImpl;
         class ComparePrimitives;
+        class TileFilter;
+        class TileWorker;
+        friend class TileWorker;
+        struct Tile;
 
         typedef uint16_t Index_t;
 
@@ -64,9 +81,13 @@ namespace gfx { namespace threed {
         // Status
         Rectangle m_viewport;
         Canvas* m_pCanvas;
+        size_t m_numThreads;
 
         Index_t addNewInstance(Instance* p);
         void addPrimitive(float z, Index_t instance, Index_t index);
+
+        void renderTiles();
+        void renderTile(Tile& tile);
     };
 
 } }
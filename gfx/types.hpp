@@ -78,6 +78,15 @@ namespace gfx {
         \param alpha  alpha value of color to write. */
     ColorQuad_t mixColor(ColorQuad_t a, ColorQuad_t b, Alpha_t alpha);
 
+    /** Alpha mixing for a run of ColorQuad_t.
+        Mixes the same color into a number of pixels;
+        the result is the same as calling mixColor() for each pixel, but faster.
+        \param pixels [in/out] Pixels (background)
+        \param n      Number of pixels
+        \param color  color to write
+        \param alpha  alpha value of color to write. */
+    void mixColors(ColorQuad_t* pixels, size_t n, ColorQuad_t color, Alpha_t alpha);
+
     /** Adding two ColorQuad_t.
         \param a      color 1
         \param b      color 2. */
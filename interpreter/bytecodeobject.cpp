@@ -111,7 +111,8 @@ interpreter::BytecodeObject::BytecodeObject()
       m_subroutineName(),
       m_fileName(),
       m_origin(),
-      m_lineNumbers()
+      m_lineNumbers(),
+      m_nameCache()
 {
     // ex IntBytecodeObject::IntBytecodeObject
 }
@@ -725,6 +726,20 @@ interpreter::BytecodeObject::getNameByIndex(uint16_t index) const
     }
 }
 
+// Get name lookup cache entry.
+interpreter::BytecodeObject::NameCache*
+interpreter::BytecodeObject::getNameCache(uint16_t index)
+{
+    if (index < m_names.getNumNames()) {
+        if (index >= m_nameCache.size()) {
+            m_nameCache.resize(m_names.getNumNames());
+        }
+        return &m_nameCache[index];
+    } else {
+        return 0;
+    }
+}
+
 interpreter::BCORef_t
 interpreter::mergeByteCodeObjects(const std::vector<BCOPtr_t>& bcos)
 {
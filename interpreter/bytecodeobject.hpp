@@ -9,9 +9,11 @@
 #include "afl/base/ptr.hpp"
 #include "afl/base/ref.hpp"
 #include "afl/base/refcounted.hpp"
+#include "afl/base/types.hpp"
 #include "afl/data/namemap.hpp"
 #include "afl/data/segment.hpp"
 #include "afl/data/value.hpp"
+#include "interpreter/context.hpp"
 #include "interpreter/opcode.hpp"
 
 namespace interpreter {
@@ -72,6 +74,26 @@ namespace interpreter {
         typedef std::vector<Opcode>::size_type PC_t;
         typedef uint16_t Label_t;
 
+        /** Name lookup cache entry.
+            Remembers the result of resolving an entry of the referenced-name table (sNamedVariable) in a process,
+            to avoid walking the context stack for every access.
+
+            An entry is valid if its \c version matches the process' current context version,
+            and no names have been added to the World since it was created (\c numWorldNames).
+            Versions are unique within a World; this is sufficient because a BCO is bound to its World anyway
+            (it refers to global variables by index).
+            Process manages these entries; see Process::invalidateNameCaches(). */
+        struct NameCache {
+            uint64_t version;                        ///< Context version of the process that created this entry; 0 if unused.
+            size_t numWorldNames;                    ///< World::getNumPropertyNames() when this entry was created.
+            Context::PropertyAccessor* accessor;     ///< Result of lookup.
+            Context::PropertyIndex_t index;          ///< Property index.
+
+            NameCache()
+                : version(0), numWorldNames(0), accessor(0), index(0)
+                { }
+        };
+
         /** Constructor.
             Make blank object. */
         BytecodeObject();
@@ -342,6 +364,11 @@ namespace interpreter {
             \return name if any; null if out of range */
         const String_t* getNameByIndex(uint16_t index) const;
 
+        /** Get name lookup cache entry.
+            \param index Index [0,names().getNumNames())
+            \return cache entry for the name; null if out of range */
+        NameCache* getNameCache(uint16_t index);
+
         /** Access local variable names.
             \return names */
         const afl::data::NameMap& localVariables() const;
@@ -380,6 +407,7 @@ namespace interpreter {
         String_t              m_fileName;
         String_t              m_origin;
         std::vector<uint32_t> m_lineNumbers; ///< Line numbers. Pairs of address,line.
+        std::vector<NameCache> m_nameCache;  ///< Name lookup cache, parallel to m_names. Grown on demand.
     };
 
 
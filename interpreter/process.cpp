@@ -159,6 +159,7 @@ interpreter::Process::Process(World& world, String_t name, uint32_t processId)
       m_processName(name),
       m_processPriority(50),
       m_processError(String_t()),
+      m_contextVersion(world.allocateContextVersion()),
       m_processKind(pkDefault),
       m_processGroupId(0),
       m_processId(processId),
@@ -339,6 +340,7 @@ interpreter::Process::pushNewContext(Context* ctx)
     std::auto_ptr<Context> p(ctx);
     p->onContextEntered(*this);
     m_contexts.pushBackNew(p.release());
+    invalidateNameCaches();
 }
 
 // Push new contexts from template.
@@ -384,6 +386,7 @@ interpreter::Process::popContext()
 {
     // ex IntExecutionContext::popContext()
     std::auto_ptr<Context> ctx(m_contexts.extractLast());
+    invalidateNameCaches();
 
     // Fix up contextTOS.
     // This is to avoid that an implicitly set contextTOS survives too long.
@@ -402,6 +405,13 @@ interpreter::Process::getContexts() const
     return m_contexts;
 }
 
+// Invalidate name lookup caches.
+void
+interpreter::Process::invalidateNameCaches()
+{
+    m_contextVersion = m_world.allocateContextVersion();
+}
+
 // Push new value.
 void
 interpreter::Process::pushNewValue(afl::data::Value* v)
@@ -751,18 +761,12 @@ interpreter::Process::executeInstruction()
      case Opcode::maPush:
         /* Push value */
         switch (op.minor) {
-         case Opcode::sNamedVariable:
-            if (const String_t* name = f.bco->getNameByIndex(op.arg)) {
-                Context::PropertyIndex_t index;
-                if (Context::PropertyAccessor* ctx = lookup(*name, index)) {
-                    valueStack.pushBackNew(ctx->get(index));
-                } else {
-                    throw Error::unknownIdentifier(*name);
-                }
-            } else {
-                handleInvalidOpcode();
-            }
+         case Opcode::sNamedVariable: {
+            Context::PropertyIndex_t index;
+            Context::PropertyAccessor* ctx = lookupNamedVariable(*f.bco, op.arg, index);
+            valueStack.pushBackNew(ctx->get(index));
             break;
+         }
          case Opcode::sLocal:
             valueStack.pushBack(f.localValues[op.arg]);
             break;
@@ -975,18 +979,12 @@ interpreter::Process::executeInstruction()
         /* Pop or store into variable */
         checkStack(1);
         switch (op.minor) {
-         case Opcode::sNamedVariable:
-            if (const String_t* name = f.bco->getNameByIndex(op.arg)) {
-                Context::PropertyIndex_t index;
-                if (Context::PropertyAccessor* ctx = lookup(*name, index)) {
-                    ctx->set(index, valueStack.top());
-                } else {
-                    throw Error::unknownIdentifier(*name);
-                }
-            } else {
-                handleInvalidOpcode();
-            }
+         case Opcode::sNamedVariable: {
+            Context::PropertyIndex_t index;
+            Context::PropertyAccessor* ctx = lookupNamedVariable(*f.bco, op.arg, index);
+            ctx->set(index, valueStack.top());
             break;
+         }
          case Opcode::sLocal:
             f.localValues.set(op.arg, valueStack.top());
             break;
@@ -1017,19 +1015,13 @@ interpreter::Process::executeInstruction()
         /* Pop into variable */
         checkStack(1);
         switch (op.minor) {
-         case Opcode::sNamedVariable:
-            if (const String_t* name = f.bco->getNameByIndex(op.arg)) {
-                Context::PropertyIndex_t index;
-                if (Context::PropertyAccessor* ctx = lookup(*name, index)) {
-                    ctx->set(index, valueStack.top());
-                    valueStack.popBack();
-                } else {
-                    throw Error::unknownIdentifier(*name);
-                }
-            } else {
-                handleInvalidOpcode();
-            }
+         case Opcode::sNamedVariable: {
+            Context::PropertyIndex_t index;
+            Context::PropertyAccessor* ctx = lookupNamedVariable(*f.bco, op.arg, index);
+            ctx->set(index, valueStack.top());
+            valueStack.popBack();
             break;
+         }
          case Opcode::sLocal:
             f.localValues.setNew(op.arg, valueStack.extractTop());
             break;
@@ -1197,6 +1189,8 @@ interpreter::Process::executeInstruction()
             if (m_contexts.empty()) {
                 throw Error::internalError("no context [snextindex]");
             } else if (m_contexts.back()->next()) {
+                // The context now describes another object which may answer different names
+                invalidateNameCaches();
                 valueStack.pushBackNew(makeBooleanValue(1));
             } else {
                 popContext();
@@ -1736,6 +1730,7 @@ interpreter::Process::handleDim(Segment_t& values, NameMap_t& names, uint16_t in
     if (existing == NameMap_t::nil) {
         // No, add it
         values.set(names.add(*name), m_valueStack.top());
+        invalidateNameCaches();
     }
 
     m_valueStack.popBack();
@@ -1996,6 +1991,48 @@ interpreter::Process::handleDecrement()
     }
 }
 
+/** Look up a name referenced by an instruction (sNamedVariable).
+    Uses the BCO's name cache to avoid walking the context stack.
+    \param [in]  bco        Bytecode object
+    \param [in]  nameIndex  Index into bco's name table
+    \param [out] index      On success, property index
+    \return PropertyAccessor, never null
+    \throw Error if name is not found or nameIndex is invalid */
+interpreter::Context::PropertyAccessor*
+interpreter::Process::lookupNamedVariable(BytecodeObject& bco, uint16_t nameIndex, Context::PropertyIndex_t& index)
+{
+    const String_t* name = bco.getNameByIndex(nameIndex);
+    BytecodeObject::NameCache* cache = bco.getNameCache(nameIndex);
+    if (name == 0 || cache == 0) {
+        handleInvalidOpcode();
+        return 0;
+    }
+
+    // Fast path
+    const size_t numWorldNames = m_world.getNumPropertyNames();
+    if (cache->version == m_contextVersion && cache->numWorldNames == numWorldNames) {
+        index = cache->index;
+        return cache->accessor;
+    }
+
+    // Slow path: same as lookup()
+    for (size_t i = m_contexts.size(); i > 0; --i) {
+        Context* c = m_contexts[i-1];
+        if (Context::PropertyAccessor* fc = c->lookup(*name, index)) {
+            // Only cache results that are provided by the context itself.
+            // A context that delegates to another object (e.g. ProcessObserverContext) can change its answer without us noticing.
+            if (dynamic_cast<Context::PropertyAccessor*>(c) == fc) {
+                cache->version = m_contextVersion;
+                cache->numWorldNames = numWorldNames;
+                cache->accessor = fc;
+                cache->index = index;
+            }
+            return fc;
+        }
+    }
+    throw Error::unknownIdentifier(*name);
+}
+
 /** Get value referenced by an instruction. */
 afl::data::Value*
 interpreter::Process::getReferencedValue(const Opcode& op)
@@ -260,6 +260,14 @@ namespace interpreter {
             \return Vector of contexts */
         const afl::container::PtrVector<Context>& getContexts() const;
 
+        /** Invalidate name lookup caches.
+            Name lookups performed by bytecode (sNamedVariable) are cached in the BytecodeObject.
+            Changes to the context stack (pushNewContext(), popContext(), pushFrame(), popFrame()),
+            advancing an iteration (ForEach) and names defined by the process itself (Dim) invalidate these caches automatically.
+            Call this function if you add names to an active context from outside,
+            e.g. by modifying a frame's localNames. */
+        void invalidateNameCaches();
+
 
         /*
          *  Value stack
@@ -520,6 +528,7 @@ namespace interpreter {
         void handleBind(uint16_t nargs);
         bool handleDecrement();
         afl::data::Value* getReferencedValue(const Opcode& op);
+        Context::PropertyAccessor* lookupNamedVariable(BytecodeObject& bco, uint16_t nameIndex, Context::PropertyIndex_t& index);
 
         void logProcessState(const char* why);
 
@@ -543,6 +552,10 @@ namespace interpreter {
         /** All active contexts for name lookup. */
         afl::container::PtrVector<Context> m_contexts;
 
+        /** Context version.
+            Changes whenever a name lookup may produce a different result; tags BytecodeObject::NameCache entries. */
+        uint64_t m_contextVersion;
+
         /** All active exception handling contexts. */
         afl::container::PtrVector<ExceptionHandler> m_exceptionHandlers;
 
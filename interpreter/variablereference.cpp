@@ -28,6 +28,7 @@ interpreter::VariableReference::Maker::make(const String_t& name, const afl::dat
     // however, the most-recent value must be retrievable.
     // For now, we store references by-name, so this will be a proper overwrite changing the previous reference's value.
     m_frame.localValues.set(m_frame.localNames.addMaybe(name), value);
+    m_process.invalidateNameCaches();
     return fromProcess(m_process, name);
 }
 
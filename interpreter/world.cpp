@@ -35,7 +35,8 @@ interpreter::World::World(afl::sys::LogListener& log, afl::string::Translator& t
       m_translator(tx),
       m_fileSystem(fs),
       m_systemLoadDirectory(),
-      m_localLoadDirectory()
+      m_localLoadDirectory(),
+      m_lastContextVersion(0)
 {
     init();
 }
@@ -74,6 +75,22 @@ interpreter::World::getGlobalValue(const char* name)
     return m_globalValues[m_globalPropertyNames.getIndexByName(name)];
 }
 
+// Get total number of property names.
+size_t
+interpreter::World::getNumPropertyNames() const
+{
+    return m_globalPropertyNames.getNumNames()
+        + m_shipPropertyNames.getNumNames()
+        + m_planetPropertyNames.getNumNames();
+}
+
+// Allocate a context version.
+uint64_t
+interpreter::World::allocateContextVersion()
+{
+    return ++m_lastContextVersion;
+}
+
 // Define a special command.
 void
 interpreter::World::addNewSpecialCommand(const char* name, SpecialCommand* newCmd)
@@ -115,6 +115,17 @@ namespace interpreter {
             \return planet property names */
         const afl::data::NameMap& planetPropertyNames() const;
 
+        /** Get total number of property names.
+            Returns the sum of the sizes of globalPropertyNames(), shipPropertyNames(), planetPropertyNames().
+            Names are never removed, so if this value changes, a name lookup may produce a different result.
+            \return number of names */
+        size_t getNumPropertyNames() const;
+
+        /** Allocate a context version.
+            Processes use this to tag their name lookup caches (see BytecodeObject::NameCache).
+            \return new value, nonzero and unique within this World */
+        uint64_t allocateContextVersion();
+
         /** Access global values.
             \return global values */
         afl::data::Segment& globalValues();
@@ -322,6 +333,9 @@ namespace interpreter {
         afl::base::Ptr<afl::io::Directory> m_systemLoadDirectory;
         afl::base::Ptr<afl::io::Directory> m_localLoadDirectory;
 
+        // Last value returned by allocateContextVersion()
+        uint64_t m_lastContextVersion;
+
         void init();
     };
 
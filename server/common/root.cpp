@@ -14,6 +14,7 @@ namespace {
     const char USER_ROOT[] =           "user:";
     const char DEFAULT_PROFILE[] =     "default:profile";
     const char GAME_ROOT[] =           "game:";
+    const char RANKING_ROOT[] =        "ranking:";
 }
 
 // Constructor.
@@ -36,6 +37,13 @@ server::common::Root::gameRoot()
     return afl::net::redis::Subtree(m_db, GAME_ROOT);
 }
 
+// Access root of ranking lists.
+afl::net::redis::Subtree
+server::common::Root::rankingRoot()
+{
+    return afl::net::redis::Subtree(m_db, RANKING_ROOT);
+}
+
 // Access default user profile.
 afl::net::redis::HashKey
 server::common::Root::defaultProfile()
@@ -44,6 +44,14 @@ namespace server { namespace common {
             \return database node */
         afl::net::redis::Subtree gameRoot();
 
+        /** Access root of ranking lists.
+            Contains, for each sortable ranking field, a list of active users sorted by that field,
+            and a hash "valid" marking the valid lists (see server::host::rank::Leaderboard).
+            These lists are maintained by the host service;
+            a service that modifies a user's profile field must remove the "valid" field of that name so the list is rebuilt.
+            \return database node */
+        afl::net::redis::Subtree rankingRoot();
+
         /** Access default user profile.
             \return default profile */
         afl::net::redis::HashKey defaultProfile();
@@ -116,7 +116,7 @@ server::file::ca::GarbageCollector::removeGarbageObjects()
         class Collector : public DirectoryHandler::Callback {
          public:
             Collector(const GarbageCollector& parent, uint8_t firstByte)
-                : m_parent(parent), m_firstByte(firstByte), m_filesToDelete()
+                : m_parent(parent), m_firstByte(firstByte), m_filesToDelete(), m_objectsToDelete()
                 { }
             virtual void addItem(const DirectoryHandler::Info& info)
                 {
@@ -135,6 +135,7 @@ server::file::ca::GarbageCollector::removeGarbageObjects()
                                 // Assuming around 300000 files, 20% garbage, we get <250 garbage files per directory.
                                 // (PlanetsCentral.com accumulated <2.5% garbage after running without GC for 4 years.)
                                 m_filesToDelete.push_back(info.name);
+                                m_objectsToDelete.push_back(id);
                             }
                         }
                     }
@@ -142,10 +143,11 @@ server::file::ca::GarbageCollector::removeGarbageObjects()
                         m_parent.m_log.write(LogListener::Warn, LOG_NAME, Format("%02x/%s: unrecognized file, ignoring", m_firstByte, info.name));
                     }
                 }
-            void removeGarbageFiles(DirectoryHandler& hdl)
+            void removeGarbageFiles(DirectoryHandler& hdl, ObjectStore& store)
                 {
                     for (size_t i = 0, n = m_filesToDelete.size(); i < n; ++i) {
                         hdl.removeFile(m_filesToDelete[i]);
+                        store.removeCachedObject(m_objectsToDelete[i]);
                     }
                 }
             size_t getNumObjectsRemoved() const
@@ -156,13 +158,14 @@ server::file::ca::GarbageCollector::removeGarbageObjects()
             const GarbageCollector& m_parent;
             const uint8_t m_firstByte;
             std::vector<String_t> m_filesToDelete;
+            std::vector<ObjectId> m_objectsToDelete;
         };
 
         if (DirectoryHandler* hdl = m_objectStore.getObjectDirectory(m_nextPrefixToCheck)) {
             try {
                 Collector c(*this, static_cast<uint8_t>(m_nextPrefixToCheck));
                 hdl->readContent(c);
-                c.removeGarbageFiles(*hdl);
+                c.removeGarbageFiles(*hdl, m_objectStore);
                 m_numObjectsRemoved += c.getNumObjectsRemoved();
             }
             catch (std::exception& e) {
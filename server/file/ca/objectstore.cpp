@@ -3,6 +3,8 @@
   *  \brief Class server::file::ca::ObjectStore
   */
 
+#include <algorithm>
+#include <set>
 #include <stdexcept>
 #include "server/file/ca/objectstore.hpp"
 #include "afl/checksums/sha1.hpp"
@@ -37,6 +39,15 @@ namespace {
 
     const char KEYWORDS[][8] = { "blob ", "tree ", "commit " };
 
+    /* Object header: keyword, size, terminating null byte.
+       This is hashed to compute the object Id, and stored in front of the loose object. */
+    String_t getObjectHeader(server::file::ca::ObjectStore::Type type, size_t size)
+    {
+        String_t result = afl::string::Format("%s%d", KEYWORDS[type], size);
+        result += '\0';
+        return result;
+    }
+
     int hexValue(char c)
     {
         if (c >= '0' && c <= '9') {
@@ -137,6 +148,58 @@ server::file::ca::ObjectStore::addNewPackFile(PackFile* p)
     m_packFiles.pushBackNew(p);
 }
 
+// Remove all pack files.
+void
+server::file::ca::ObjectStore::removePackFiles()
+{
+    m_packFiles.clear();
+}
+
+// Set object cache.
+void
+server::file::ca::ObjectStore::setNewObjectCache(ObjectCache* p)
+{
+    m_cache.reset(p);
+}
+
+// Remove object from cache.
+void
+server::file::ca::ObjectStore::removeCachedObject(const ObjectId& id)
+{
+    m_cache->removeObject(id);
+}
+
+// Remove cache entries of objects that no longer exist.
+size_t
+server::file::ca::ObjectStore::removeStaleCachedObjects(std::vector<ObjectId> ids)
+{
+    // Sorting groups the objects by directory, so each directory is read at most once.
+    std::sort(ids.begin(), ids.end());
+
+    size_t numRemoved = 0;
+    size_t i = 0;
+    while (i < ids.size()) {
+        const uint8_t firstChar = ids[i].m_bytes[0];
+        std::set<String_t> names;
+        bool haveNames = false;
+        while (i < ids.size() && ids[i].m_bytes[0] == firstChar) {
+            const ObjectId& id = ids[i];
+            if (!isPackedObject(id)) {
+                if (!haveNames) {
+                    readObjectNames(firstChar, names);
+                    haveNames = true;
+                }
+                if (names.find(getTailName(id)) == names.end()) {
+                    m_cache->removeObject(id);
+                    ++numRemoved;
+                }
+            }
+            ++i;
+        }
+    }
+    return numRemoved;
+}
+
 // Get object content.
 afl::base::Ref<afl::io::FileMapping>
 server::file::ca::ObjectStore::getObject(const ObjectId& id, Type expectedType)
@@ -187,16 +250,10 @@ server::file::ca::ObjectStore::addObject(Type type, afl::base::ConstBytes_t data
     // (it doesn't save much, and git does not like it).
 
     // Compute object Id
-    const String_t prefix = afl::string::Format("%s%d", KEYWORDS[type], data.size());
-    static const uint8_t ZERO[1] = {0};
-    afl::checksums::SHA1 checksummer;
-    checksummer.add(afl::string::toBytes(prefix));
-    checksummer.add(ZERO);
-    checksummer.add(data);
+    const ObjectId id = computeObjectId(type, data);
 
-    const ObjectId id = ObjectId::fromHash(checksummer);
-
-    // Verify object content
+    // Verify object content.
+    // The cache is trusted here; removeStaleCachedObjects() makes sure it does not know vanished objects.
     afl::base::Ptr<afl::io::FileMapping> existingContent;
     if (loadObject(id, type, MAX_LEVEL, 0, &existingContent) && existingContent.get() != 0) {
         // Check hash collision
@@ -225,8 +282,7 @@ server::file::ca::ObjectStore::addObject(Type type, afl::base::ConstBytes_t data
         afl::base::GrowableMemory<uint8_t> newContent;
         afl::io::DeflateTransform tx(afl::io::DeflateTransform::Zlib);
 
-        transformAdd(newContent, tx, afl::string::toBytes(prefix));
-        transformAdd(newContent, tx, ZERO);
+        transformAdd(newContent, tx, afl::string::toBytes(getObjectHeader(type, data.size())));
         transformAdd(newContent, tx, data);
         transformFinish(newContent, tx);
 
@@ -268,9 +324,10 @@ server::file::ca::ObjectStore::unlinkObject(Type type, const ObjectId& id)
                 unlinkContent(type, getObject(id, type)->get());
             }
 
-            // Remove the file
+            // Remove the file.
+            // An object that has been packed has no loose file (or a stale one); it will be dropped by the next repack.
             const uint8_t firstChar = id.m_bytes[0];
-            if (firstChar < m_subdirectories.size() && m_subdirectories[firstChar] != 0) {
+            if (!isPackedObject(id) && firstChar < m_subdirectories.size() && m_subdirectories[firstChar] != 0) {
                 m_subdirectories[firstChar]->removeFile(getTailName(id));
             }
 
@@ -291,6 +348,16 @@ server::file::ca::ObjectStore::getObjectDirectory(size_t prefix)
     }
 }
 
+// Compute object Id.
+server::file::ca::ObjectId
+server::file::ca::ObjectStore::computeObjectId(Type type, afl::base::ConstBytes_t data)
+{
+    afl::checksums::SHA1 checksummer;
+    checksummer.add(afl::string::toBytes(getObjectHeader(type, data.size())));
+    checksummer.add(data);
+    return ObjectId::fromHash(checksummer);
+}
+
 /** Load an object, internal.
     \param id Object Id
     \param expectedType Expected type
@@ -448,6 +515,47 @@ server::file::ca::ObjectStore::loadObjectFromPackFile(const ObjectId& id, Type e
     return false;
 }
 
+/** Check whether object is contained in a pack file.
+    \param id Object Id
+    \return true if object is contained in a pack file */
+bool
+server::file::ca::ObjectStore::isPackedObject(const ObjectId& id) const
+{
+    for (size_t i = 0; i < m_packFiles.size(); ++i) {
+        if (m_packFiles[i]->hasObject(id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/** Get names of loose object files in a first-byte directory.
+    \param [in]  firstChar First byte
+    \param [out] names     File names */
+void
+server::file::ca::ObjectStore::readObjectNames(uint8_t firstChar, std::set<String_t>& names)
+{
+    class Callback : public DirectoryHandler::Callback {
+     public:
+        Callback(std::set<String_t>& names)
+            : m_names(names)
+            { }
+        virtual void addItem(const DirectoryHandler::Info& info)
+            {
+                if (info.type == DirectoryHandler::IsFile) {
+                    m_names.insert(info.name);
+                }
+            }
+     private:
+        std::set<String_t>& m_names;
+    };
+
+    if (firstChar < m_subdirectories.size() && m_subdirectories[firstChar] != 0) {
+        Callback cb(names);
+        m_subdirectories[firstChar]->readContent(cb);
+    }
+}
+
 /** Read directory.
     Initially populates the m_subdirectories member. */
 void
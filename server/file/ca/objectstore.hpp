@@ -6,6 +6,8 @@
 #define C2NG_SERVER_FILE_CA_OBJECTSTORE_HPP
 
 #include <memory>
+#include <set>
+#include <vector>
 #include "afl/base/growablememory.hpp"
 #include "afl/base/memory.hpp"
 #include "afl/base/ref.hpp"
@@ -30,7 +32,7 @@ namespace server { namespace file { namespace ca {
 
         This class also aggregates optional features:
         - data and metadata caching
-        - pack files (read-only objects)
+        - pack files (read-only objects; objects in a pack file are never removed individually)
         - reference counting
 
         Reference counting enables removal of objects that become unused.
@@ -59,6 +61,31 @@ namespace server { namespace file { namespace ca {
             \param p Newly-allocated PackFile. Must not be null. Ownership is taken by ObjectStore. */
         void addNewPackFile(PackFile* p);
 
+        /** Remove all pack files.
+            Objects that are only contained in pack files will no longer be accessible.
+            Use when replacing the pack files by a new one (see Root::repack()). */
+        void removePackFiles();
+
+        /** Set object cache.
+            Replaces the default cache (InternalObjectCache).
+            \param p Newly-allocated ObjectCache. Must not be null. Ownership is taken by ObjectStore. */
+        void setNewObjectCache(ObjectCache* p);
+
+        /** Remove object from cache.
+            Call when an object's file has been removed by other means than unlinkObject() (e.g. garbage collection),
+            so that the cache does not keep reporting it.
+            \param id Object Id */
+        void removeCachedObject(const ObjectId& id);
+
+        /** Remove cache entries of objects that no longer exist.
+            Use after installing a cache that may know objects which have since been removed
+            (e.g. a persistent cache file from a previous run, followed by garbage collection).
+            The existence check reads each affected object directory once; it does not read object content.
+            Afterwards, the cache can be trusted to tell whether an object exists.
+            \param ids Object Ids known to the cache
+            \return number of entries removed */
+        size_t removeStaleCachedObjects(std::vector<ObjectId> ids);
+
         /** Get object content.
             \param id Object Id
             \param expectedType Expected type
@@ -119,9 +146,17 @@ namespace server { namespace file { namespace ca {
             \return DirectoryHandler if one exists, null if this directory does not exist (=has no objects) */
         DirectoryHandler* getObjectDirectory(size_t prefix);
 
+        /** Compute object Id.
+            \param type Object type
+            \param data Payload
+            \return Object Id that addObject() would produce for this object */
+        static ObjectId computeObjectId(Type type, afl::base::ConstBytes_t data);
+
      private:
         bool loadObject(const ObjectId& id, Type expectedType, size_t maxLevel, size_t* pSize, afl::base::Ptr<afl::io::FileMapping>* pContent);
         bool loadObjectFromPackFile(const ObjectId& id, Type expectedType, size_t maxLevel, size_t* pSize, afl::base::Ptr<afl::io::FileMapping>* pContent);
+        bool isPackedObject(const ObjectId& id) const;
+        void readObjectNames(uint8_t firstChar, std::set<String_t>& names);
         void readDirectory();
         void unlinkContent(Type type, afl::base::ConstBytes_t data);
 
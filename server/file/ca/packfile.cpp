@@ -237,6 +237,12 @@ server::file::ca::PackFile::getObject(const ObjectId& id, ObjectRequester& req,
     return loadObject(p->pos, req, maxLevel).asPtr();
 }
 
+bool
+server::file::ca::PackFile::hasObject(const ObjectId& id) const
+{
+    return m_index.findItem(id) != 0;
+}
+
 afl::base::Ref<afl::io::FileMapping>
 server::file::ca::PackFile::loadObject(afl::io::Stream::FileSize_t pos, ObjectRequester& req, size_t maxLevel)
 {
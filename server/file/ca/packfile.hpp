@@ -100,6 +100,11 @@ namespace server { namespace file { namespace ca {
             @return FileMapping if object was found; null otherwise */
         afl::base::Ptr<afl::io::FileMapping> getObject(const ObjectId& id, ObjectRequester& req, size_t maxLevel);
 
+        /** Check presence of an object.
+            @param id        Object Id
+            @return true if this pack file contains the object */
+        bool hasObject(const ObjectId& id) const;
+
         /*
          *  File Format Utilities
          */
@@ -0,0 +1,342 @@
+/**
+  *  \file server/file/ca/packwriter.cpp
+  *  \brief Class server::file::ca::PackWriter
+  */
+
+#include <algorithm>
+#include <vector>
+#include "server/file/ca/packwriter.hpp"
+#include "afl/except/fileformatexception.hpp"
+#include "afl/io/deflatetransform.hpp"
+#include "server/file/ca/packfile.hpp"
+
+using afl::base::ConstBytes_t;
+using afl::base::GrowableBytes_t;
+
+namespace {
+    /*
+     *  Parameters
+     */
+
+    /* Number of previous objects to try as delta base.
+       Same as git's default --window. */
+    const size_t WINDOW_SIZE = 10;
+
+    /* Maximum delta chain length.
+       PackFile resolves delta chains recursively on every read, so this is much smaller than git's default --depth. */
+    const int MAX_DEPTH = 10;
+
+    /* Minimum size of an object to try delta compression. */
+    const size_t MIN_DELTA_SIZE = 64;
+
+    /* Delta encoding: block size for finding matches. */
+    const size_t BLOCK_SIZE = 16;
+
+    /* Delta encoding: maximum number of candidates to check for a block. */
+    const size_t MAX_CANDIDATES = 8;
+
+    /* Delta encoding: maximum number of bytes for a single copy/add instruction. */
+    const size_t MAX_COPY = 0x10000;
+    const size_t MAX_ADD = 0x7F;
+
+
+    /*
+     *  Helpers
+     */
+
+    uint8_t getPackType(server::file::ca::ObjectStore::Type type)
+    {
+        using server::file::ca::ObjectStore;
+        using server::file::ca::PackFile;
+        switch (type) {
+         case ObjectStore::DataObject:   return PackFile::OBJ_BLOB;
+         case ObjectStore::TreeObject:   return PackFile::OBJ_TREE;
+         case ObjectStore::CommitObject: return PackFile::OBJ_COMMIT;
+        }
+        return PackFile::OBJ_BLOB;
+    }
+
+    /* CRC-32 (as used by zlib/git) */
+    uint32_t updateCRC(uint32_t crc, ConstBytes_t data)
+    {
+        crc = ~crc;
+        while (const uint8_t* p = data.eat()) {
+            crc ^= *p;
+            for (int i = 0; i < 8; ++i) {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+            }
+        }
+        return ~crc;
+    }
+
+    /* Append a "VarInt" (see PackFile::VarInt) */
+    void appendVarInt(GrowableBytes_t& out, uint64_t value)
+    {
+        while (value >= 0x80) {
+            out.append(static_cast<uint8_t>(0x80 | (value & 0x7F)));
+            value >>= 7;
+        }
+        out.append(static_cast<uint8_t>(value));
+    }
+
+    /* Append an object header (type and size) */
+    void appendTypeAndSize(GrowableBytes_t& out, uint8_t type, uint64_t size)
+    {
+        uint8_t first = static_cast<uint8_t>((type << 4) | (size & 15));
+        size >>= 4;
+        if (size != 0) {
+            first |= 0x80;
+        }
+        out.append(first);
+        if (size != 0) {
+            appendVarInt(out, size);
+        }
+    }
+
+    /* Append an "OfsInt" (see PackFile::OfsInt) */
+    void appendOfsInt(GrowableBytes_t& out, uint64_t value)
+    {
+        uint8_t buffer[10];
+        size_t pos = sizeof(buffer)-1;
+        buffer[pos] = static_cast<uint8_t>(value & 0x7F);
+        while ((value >>= 7) != 0) {
+            --value;
+            buffer[--pos] = static_cast<uint8_t>(0x80 | (value & 0x7F));
+        }
+        out.append(ConstBytes_t(buffer).subrange(pos));
+    }
+
+    /* Compress data using zlib */
+    void compress(GrowableBytes_t& out, ConstBytes_t in)
+    {
+        afl::io::DeflateTransform tx(afl::io::DeflateTransform::Zlib);
+        while (!in.empty()) {
+            uint8_t outBuffer[4096];
+            afl::base::Bytes_t outContent(outBuffer);
+            tx.transform(in, outContent);
+            out.append(outContent);
+        }
+        tx.flush();
+        while (1) {
+            uint8_t outBuffer[4096];
+            afl::base::Bytes_t outContent(outBuffer);
+            tx.transform(in, outContent);
+            out.append(outContent);
+            if (outContent.empty()) {
+                break;
+            }
+        }
+    }
+
+    /* Delta encoding: hash of a block */
+    uint32_t hashBlock(const uint8_t* p)
+    {
+        uint32_t h = 2166136261U;
+        for (size_t i = 0; i < BLOCK_SIZE; ++i) {
+            h = (h ^ p[i]) * 16777619U;
+        }
+        return h;
+    }
+
+    /* Delta encoding: block index entry */
+    struct Block {
+        uint32_t hash;
+        uint32_t pos;
+        Block(uint32_t hash, uint32_t pos)
+            : hash(hash), pos(pos)
+            { }
+        bool operator<(const Block& other) const
+            { return hash != other.hash ? hash < other.hash : pos < other.pos; }
+    };
+
+    /* Delta encoding: append "add" instructions */
+    void appendAdd(GrowableBytes_t& out, ConstBytes_t data)
+    {
+        while (!data.empty()) {
+            ConstBytes_t now = data.split(MAX_ADD);
+            out.append(static_cast<uint8_t>(now.size()));
+            out.append(now);
+        }
+    }
+
+    /* Delta encoding: append "copy" instructions */
+    void appendCopy(GrowableBytes_t& out, size_t pos, size_t len)
+    {
+        while (len > 0) {
+            const size_t now = std::min(len, MAX_COPY);
+            uint8_t buffer[8];
+            size_t n = 1;
+            buffer[0] = 0x80;
+            for (int i = 0; i < 4; ++i) {
+                if (uint8_t b = static_cast<uint8_t>(pos >> (8*i))) {
+                    buffer[0] |= static_cast<uint8_t>(1 << i);
+                    buffer[n++] = b;
+                }
+            }
+            if (now != MAX_COPY) {
+                for (int i = 0; i < 3; ++i) {
+                    if (uint8_t b = static_cast<uint8_t>(now >> (8*i))) {
+                        buffer[0] |= static_cast<uint8_t>(0x10 << i);
+                        buffer[n++] = b;
+                    }
+                }
+            }
+            out.append(ConstBytes_t(buffer).trim(n));
+            pos += now;
+            len -= now;
+        }
+    }
+}
+
+server::file::ca::PackWriter::PackWriter(afl::io::Stream& out, uint32_t numObjects)
+    : m_out(out),
+      m_hash(),
+      m_index(),
+      m_pos(0),
+      m_numObjects(numObjects),
+      m_numWritten(0),
+      m_window()
+{
+    PackFile::Header header;
+    header.magic = PackFile::MAGIC;
+    header.version = PackFile::VERSION;
+    header.numObjects = numObjects;
+    write(afl::base::fromObject(header));
+}
+
+server::file::ca::PackWriter::~PackWriter()
+{ }
+
+void
+server::file::ca::PackWriter::addObject(const ObjectId& id, ObjectStore::Type type, afl::base::Ref<afl::io::FileMapping> content)
+{
+    const ConstBytes_t data = content->get();
+
+    // Try to find a delta base
+    GrowableBytes_t delta;
+    GrowableBytes_t bestDelta;
+    const Base* bestBase = 0;
+    if (data.size() >= MIN_DELTA_SIZE) {
+        for (size_t i = 0; i < m_window.size(); ++i) {
+            const Base& b = m_window[i];
+            if (b.type == type && b.depth < MAX_DEPTH) {
+                // Require the delta to save at least half of the object, and to be better than what we have.
+                const size_t maxSize = (bestBase != 0 ? bestDelta.size() : data.size() / 2);
+                delta.clear();
+                if (encodeDelta(b.content->get(), data, delta, maxSize) && delta.size() < maxSize) {
+                    bestDelta.swap(delta);
+                    bestBase = &b;
+                }
+            }
+        }
+    }
+
+    // Build object
+    const uint64_t pos = m_pos;
+    GrowableBytes_t entry;
+    if (bestBase != 0) {
+        appendTypeAndSize(entry, PackFile::OBJ_OFS_DELTA, bestDelta.size());
+        appendOfsInt(entry, pos - bestBase->pos);
+        compress(entry, bestDelta);
+    } else {
+        appendTypeAndSize(entry, getPackType(type), data.size());
+        compress(entry, data);
+    }
+    write(entry);
+    m_index.addItem(id, updateCRC(0, entry), pos);
+    ++m_numWritten;
+
+    // Remember as potential delta base
+    Base newBase;
+    newBase.type = type;
+    newBase.pos = pos;
+    newBase.depth = (bestBase != 0 ? bestBase->depth + 1 : 0);
+    newBase.content = content.asPtr();
+    m_window.push_back(newBase);
+    if (m_window.size() > WINDOW_SIZE) {
+        m_window.pop_front();
+    }
+}
+
+server::file::ca::ObjectId
+server::file::ca::PackWriter::finish(afl::io::DataSink& indexOut)
+{
+    if (m_numWritten != m_numObjects) {
+        throw afl::except::FileFormatException(m_out, "Pack File: object count mismatch");
+    }
+
+    // Pack trailer
+    const ObjectId packId = ObjectId::fromHash(m_hash);
+    m_out.fullWrite(packId.m_bytes);
+    m_window.clear();
+
+    // Index
+    m_index.save(indexOut, packId);
+    return packId;
+}
+
+bool
+server::file::ca::PackWriter::encodeDelta(afl::base::ConstBytes_t ref, afl::base::ConstBytes_t target, afl::base::GrowableBytes_t& out, size_t maxSize)
+{
+    // Header
+    appendVarInt(out, ref.size());
+    appendVarInt(out, target.size());
+
+    // Index reference object
+    const uint8_t* const refData = ref.unsafeData();
+    const size_t refSize = ref.size();
+    std::vector<Block> blocks;
+    blocks.reserve(refSize / BLOCK_SIZE);
+    for (size_t pos = 0; pos + BLOCK_SIZE <= refSize; pos += BLOCK_SIZE) {
+        blocks.push_back(Block(hashBlock(refData + pos), static_cast<uint32_t>(pos)));
+    }
+    std::sort(blocks.begin(), blocks.end());
+
+    // Scan target
+    const uint8_t* const targetData = target.unsafeData();
+    const size_t targetSize = target.size();
+    size_t pos = 0;
+    size_t addStart = 0;
+    while (pos + BLOCK_SIZE <= targetSize && out.size() <= maxSize) {
+        // Find longest match
+        size_t bestPos = 0;
+        size_t bestLength = 0;
+        const uint32_t hash = hashBlock(targetData + pos);
+        std::vector<Block>::const_iterator it = std::lower_bound(blocks.begin(), blocks.end(), Block(hash, 0));
+        for (size_t n = 0; it != blocks.end() && it->hash == hash && n < MAX_CANDIDATES; ++it, ++n) {
+            size_t len = 0;
+            while (it->pos + len < refSize && pos + len < targetSize && refData[it->pos + len] == targetData[pos + len]) {
+                ++len;
+            }
+            if (len > bestLength) {
+                bestPos = it->pos;
+                bestLength = len;
+            }
+        }
+
+        if (bestLength >= BLOCK_SIZE) {
+            // Extend match backwards into pending literal data
+            while (pos > addStart && bestPos > 0 && refData[bestPos-1] == targetData[pos-1]) {
+                --pos;
+                --bestPos;
+                ++bestLength;
+            }
+            appendAdd(out, target.subrange(addStart, pos - addStart));
+            appendCopy(out, bestPos, bestLength);
+            pos += bestLength;
+            addStart = pos;
+        } else {
+            ++pos;
+        }
+    }
+    appendAdd(out, target.subrange(addStart));
+    return out.size() <= maxSize;
+}
+
+void
+server::file::ca::PackWriter::write(afl::base::ConstBytes_t data)
+{
+    m_out.fullWrite(data);
+    m_hash.add(data);
+    m_pos += data.size();
+}
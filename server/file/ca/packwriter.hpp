@@ -0,0 +1,91 @@
+/**
+  *  \file server/file/ca/packwriter.hpp
+  *  \brief Class server::file::ca::PackWriter
+  */
+#ifndef C2NG_SERVER_FILE_CA_PACKWRITER_HPP
+#define C2NG_SERVER_FILE_CA_PACKWRITER_HPP
+
+#include <deque>
+#include "afl/base/growablememory.hpp"
+#include "afl/base/ptr.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/io/datasink.hpp"
+#include "afl/io/filemapping.hpp"
+#include "afl/io/stream.hpp"
+#include "server/file/ca/indexfile.hpp"
+#include "server/file/ca/objectid.hpp"
+#include "server/file/ca/objectstore.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    /** Pack file writer.
+        Produces a pack file and matching index file (see PackFile) from a sequence of objects.
+
+        Objects are delta-compressed (OBJ_OFS_DELTA) against one of the previous objects of the same type,
+        if that produces a sufficiently small result.
+        To get good compression, callers should present similar objects next to each other.
+        The length of delta chains is limited to keep the cost of reading an object bounded.
+
+        Usage:
+        - construct with the number of objects to write
+        - call addObject() for each object
+        - call finish() to complete the pack file and write the index file */
+    class PackWriter : private afl::base::Uncopyable {
+     public:
+        /** Constructor.
+            Writes the pack file header.
+            @param out         Pack file output stream; must live as long as this PackWriter
+            @param numObjects  Number of objects that will be written */
+        PackWriter(afl::io::Stream& out, uint32_t numObjects);
+
+        /** Destructor. */
+        ~PackWriter();
+
+        /** Add an object.
+            @param id       Object Id
+            @param type     Object type
+            @param content  Object content (payload, without header) */
+        void addObject(const ObjectId& id, ObjectStore::Type type, afl::base::Ref<afl::io::FileMapping> content);
+
+        /** Finish.
+            Writes the pack file trailer and the index file.
+            @param indexOut  Index file output
+            @return pack Id (=SHA-1 of pack file content)
+            @throw afl::except::FileFormatException if the number of objects does not match the constructor parameter */
+        ObjectId finish(afl::io::DataSink& indexOut);
+
+        /** Encode delta.
+            Produces a delta in the format understood by PackFile::DeltaExpander.
+            @param [in]  ref      Reference object
+            @param [in]  target   Target object
+            @param [out] out      Delta is appended here
+            @param [in]  maxSize  Maximum size of the delta
+            @retval true  Delta has been produced
+            @retval false Delta would be larger than maxSize; out has indeterminate content */
+        static bool encodeDelta(afl::base::ConstBytes_t ref, afl::base::ConstBytes_t target, afl::base::GrowableBytes_t& out, size_t maxSize);
+
+     private:
+        /** Object kept as potential delta base. */
+        struct Base {
+            ObjectStore::Type type;
+            uint64_t pos;
+            int depth;
+            afl::base::Ptr<afl::io::FileMapping> content;
+        };
+
+        afl::io::Stream& m_out;
+        afl::checksums::SHA1 m_hash;
+        IndexFile m_index;
+        uint64_t m_pos;
+        uint32_t m_numObjects;
+        uint32_t m_numWritten;
+        std::deque<Base> m_window;
+
+        void write(afl::base::ConstBytes_t data);
+    };
+
+} } }
+
+#endif
@@ -0,0 +1,373 @@
+/**
+  *  \file server/file/ca/persistentobjectcache.cpp
+  *  \brief Class server::file::ca::PersistentObjectCache
+  */
+
+#include <algorithm>
+#include <vector>
+#include "server/file/ca/persistentobjectcache.hpp"
+#include "afl/bits/uint32le.hpp"
+#include "afl/bits/value.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/internalfilemapping.hpp"
+
+using afl::base::ConstBytes_t;
+using afl::base::GrowableBytes_t;
+
+namespace {
+    const char*const HASH_COLLISION = "500 Hash collision";
+
+    typedef afl::bits::Value<afl::bits::UInt32LE> UInt32_t;
+
+    /*
+     *  File format
+     */
+
+    const uint8_t MAGIC[] = {'C','2','o','b','j','c','a',26};
+    const uint32_t VERSION = 1;
+
+    struct FileHeader {
+        uint8_t magic[8];
+        UInt32_t version;
+        UInt32_t reserved;
+    };
+
+    const uint8_t HasContent = 1;         ///< Record is followed by content.
+    const uint8_t IsRemoved = 2;          ///< Record marks an object as removed.
+
+    struct RecordHeader {
+        uint8_t id[20];
+        uint8_t type;                     ///< ObjectStore::Type.
+        uint8_t flags;                    ///< Combination of HasContent, IsRemoved.
+        uint8_t reserved[2];
+        UInt32_t size;                    ///< Object size.
+        UInt32_t check;                   ///< computeCheck().
+    };
+
+    /* Check value for a record header (FNV-1a over all other fields).
+       This detects incompletely-written records; content is verified against the ObjectId. */
+    uint32_t computeCheck(const RecordHeader& h)
+    {
+        ConstBytes_t bytes = afl::base::fromObject(h).trim(sizeof(RecordHeader) - sizeof(UInt32_t));
+        uint32_t result = 2166136261U;
+        while (const uint8_t* p = bytes.eat()) {
+            result = (result ^ *p) * 16777619U;
+        }
+        return result;
+    }
+
+    /* Sort predicate for rewrite(): newest first */
+    template<typename T>
+    struct CompareNewestFirst {
+        bool operator()(const T& a, const T& b) const
+            { return a.first > b.first; }
+    };
+
+    /* Maximum size of an object we store in the cache file, in relation to file size. */
+    size_t getMaxObjectSize(size_t maxBytes)
+    {
+        return maxBytes / 4;
+    }
+}
+
+server::file::ca::PersistentObjectCache::PersistentObjectCache(afl::base::Ref<afl::io::Stream> file, size_t maxBytes)
+    : m_file(file),
+      m_maxBytes(maxBytes),
+      m_writePosition(0),
+      m_useCounter(0),
+      m_writeEnabled(true),
+      m_entries(),
+      m_memoryCache()
+{
+    load();
+}
+
+server::file::ca::PersistentObjectCache::~PersistentObjectCache()
+{ }
+
+server::file::ca::InternalObjectCache&
+server::file::ca::PersistentObjectCache::memoryCache()
+{
+    return m_memoryCache;
+}
+
+size_t
+server::file::ca::PersistentObjectCache::getNumObjects() const
+{
+    return m_entries.size();
+}
+
+void
+server::file::ca::PersistentObjectCache::getObjectIds(std::vector<ObjectId>& out) const
+{
+    for (Map_t::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it) {
+        out.push_back(it->first);
+    }
+}
+
+void
+server::file::ca::PersistentObjectCache::addObject(const ObjectId& id, ObjectStore::Type type, afl::base::Ref<afl::io::FileMapping> content)
+{
+    const size_t size = content->get().size();
+    if (type == ObjectStore::TreeObject && size <= getMaxObjectSize(m_maxBytes)) {
+        Entry& e = m_entries[id];
+        e.type = type;
+        e.size = size;
+        e.content = content.asPtr();
+        writeRecord(id, touch(e), false);
+    } else {
+        m_memoryCache.addObject(id, type, content);
+        addObjectSize(id, type, size);
+    }
+}
+
+void
+server::file::ca::PersistentObjectCache::addObjectSize(const ObjectId& id, ObjectStore::Type type, size_t size)
+{
+    Map_t::iterator it = m_entries.find(id);
+    if (it != m_entries.end()) {
+        touch(it->second);
+    } else if (uint32_t(size) != size) {
+        // Too large for the file format
+        m_memoryCache.addObjectSize(id, type, size);
+    } else {
+        Entry& e = m_entries[id];
+        e.type = type;
+        e.size = size;
+        writeRecord(id, touch(e), false);
+    }
+}
+
+void
+server::file::ca::PersistentObjectCache::removeObject(const ObjectId& id)
+{
+    m_memoryCache.removeObject(id);
+
+    Map_t::iterator it = m_entries.find(id);
+    if (it != m_entries.end()) {
+        const Entry e = it->second;
+        m_entries.erase(it);
+        writeRecord(id, e, true);
+    }
+}
+
+afl::base::Ptr<afl::io::FileMapping>
+server::file::ca::PersistentObjectCache::getObject(const ObjectId& id, ObjectStore::Type type)
+{
+    Map_t::iterator it = m_entries.find(id);
+    if (it != m_entries.end() && it->second.content.get() != 0) {
+        if (it->second.type != type) {
+            throw afl::except::FileProblemException(id.toHex(), HASH_COLLISION);
+        }
+        return touch(it->second).content;
+    } else {
+        return m_memoryCache.getObject(id, type);
+    }
+}
+
+afl::base::Optional<size_t>
+server::file::ca::PersistentObjectCache::getObjectSize(const ObjectId& id, ObjectStore::Type type)
+{
+    Map_t::iterator it = m_entries.find(id);
+    if (it != m_entries.end()) {
+        if (it->second.type != type) {
+            throw afl::except::FileProblemException(id.toHex(), HASH_COLLISION);
+        }
+        return touch(it->second).size;
+    } else {
+        return m_memoryCache.getObjectSize(id, type);
+    }
+}
+
+/** Load cache file.
+    Populates m_entries and m_writePosition; (re)initializes the file if it is not valid. */
+void
+server::file::ca::PersistentObjectCache::load()
+{
+    try {
+        // Map the file. If it is larger than permitted (limit reduced), ignore the excess.
+        m_file->setPos(0);
+        afl::base::Ref<afl::io::FileMapping> map = m_file->createVirtualMapping(m_maxBytes);
+        ConstBytes_t data = map->get();
+
+        // Header
+        FileHeader fh;
+        if (data.size() >= sizeof(fh)) {
+            afl::base::fromObject(fh).copyFrom(data.split(sizeof(fh)));
+            if (ConstBytes_t(fh.magic).equalContent(MAGIC) && fh.version == VERSION) {
+                afl::io::Stream::FileSize_t pos = sizeof(fh);
+
+                // Records
+                RecordHeader rh;
+                while (data.size() >= sizeof(rh)) {
+                    afl::base::fromObject(rh).copyFrom(data.split(sizeof(rh)));
+                    if (rh.check != computeCheck(rh)
+                        || rh.type > ObjectStore::CommitObject
+                        || (rh.flags & ~(HasContent | IsRemoved)) != 0)
+                    {
+                        break;
+                    }
+
+                    ObjectId id;
+                    afl::base::Bytes_t(id.m_bytes).copyFrom(rh.id);
+                    if ((rh.flags & IsRemoved) != 0) {
+                        m_entries.erase(id);
+                    } else {
+                        Entry e;
+                        e.type = ObjectStore::Type(rh.type);
+                        e.size = rh.size;
+                        if ((rh.flags & HasContent) != 0) {
+                            if (data.size() < e.size) {
+                                break;
+                            }
+                            ConstBytes_t content = data.split(e.size);
+                            if (ObjectStore::computeObjectId(e.type, content) != id) {
+                                break;
+                            }
+                            GrowableBytes_t copy;
+                            copy.append(content);
+                            e.content = new afl::io::InternalFileMapping(copy);
+                            pos += e.size;
+                        }
+                        touch(e);
+                        m_entries[id] = e;
+                    }
+                    pos += sizeof(rh);
+                }
+                m_writePosition = pos;
+            }
+        }
+    }
+    catch (std::exception&) {
+        // Unreadable file: start over
+        m_entries.clear();
+        m_writePosition = 0;
+    }
+
+    // If the file did not contain a valid header, start a new one.
+    if (m_writePosition == 0) {
+        m_entries.clear();
+        rewrite();
+    }
+}
+
+/** Mark entry used.
+    \param e Entry
+    \return e */
+server::file::ca::PersistentObjectCache::Entry&
+server::file::ca::PersistentObjectCache::touch(Entry& e)
+{
+    e.lastUse = ++m_useCounter;
+    return e;
+}
+
+/** Write a record to the cache file.
+    If the file would exceed its size limit, it is rewritten instead.
+    \param id       Object Id
+    \param e        Entry
+    \param removed  true to write a removal record */
+void
+server::file::ca::PersistentObjectCache::writeRecord(const ObjectId& id, const Entry& e, bool removed)
+{
+    GrowableBytes_t buffer;
+    appendRecord(buffer, id, e, removed);
+    if (m_writePosition + buffer.size() + sizeof(RecordHeader) > m_maxBytes) {
+        // Rewriting uses the current content of m_entries which already includes this change.
+        rewrite();
+    } else {
+        // Terminate with an invalid record, so that loading stops here.
+        const size_t recordSize = buffer.size();
+        buffer.appendN(0, sizeof(RecordHeader));
+        if (m_writeEnabled) {
+            try {
+                m_file->setPos(m_writePosition);
+                m_file->fullWrite(buffer);
+            }
+            catch (std::exception&) {
+                // Cache file not writable (e.g. disk full).
+                // Keep working as memory-only cache; m_writePosition continues to limit memory usage.
+                m_writeEnabled = false;
+            }
+        }
+        m_writePosition += recordSize;
+    }
+}
+
+/** Rewrite the cache file.
+    Keeps the most-recently used entries that fit into 3/4 of the size limit, drops all others. */
+void
+server::file::ca::PersistentObjectCache::rewrite()
+{
+    // Sort by age, newest first
+    std::vector<std::pair<uint32_t, Map_t::iterator> > order;
+    order.reserve(m_entries.size());
+    for (Map_t::iterator it = m_entries.begin(), e = m_entries.end(); it != e; ++it) {
+        order.push_back(std::make_pair(it->second.lastUse, it));
+    }
+    std::sort(order.begin(), order.end(), CompareNewestFirst<std::pair<uint32_t, Map_t::iterator> >());
+
+    // Determine what to keep
+    const size_t limit = m_maxBytes * 3/4;
+    size_t total = sizeof(FileHeader) + sizeof(RecordHeader);
+    size_t numKept = 0;
+    while (numKept < order.size()) {
+        const Entry& e = order[numKept].second->second;
+        const size_t recordSize = sizeof(RecordHeader) + (e.content.get() != 0 ? e.size : 0);
+        if (total + recordSize > limit) {
+            break;
+        }
+        total += recordSize;
+        ++numKept;
+    }
+    for (size_t i = numKept; i < order.size(); ++i) {
+        m_entries.erase(order[i].second);
+    }
+
+    // Build new file content, oldest first, so that the next load() reproduces the order
+    GrowableBytes_t buffer;
+    FileHeader fh;
+    afl::base::Bytes_t(fh.magic).copyFrom(MAGIC);
+    fh.version = VERSION;
+    fh.reserved = 0;
+    buffer.append(afl::base::fromObject(fh));
+    for (size_t i = numKept; i > 0; --i) {
+        appendRecord(buffer, order[i-1].second->first, order[i-1].second->second, false);
+    }
+    const size_t fileSize = buffer.size();
+    buffer.appendN(0, sizeof(RecordHeader));
+
+    if (m_writeEnabled) {
+        try {
+            m_file->setPos(0);
+            m_file->fullWrite(buffer);
+        }
+        catch (std::exception&) {
+            m_writeEnabled = false;
+        }
+    }
+    m_writePosition = fileSize;
+}
+
+/** Append a record to a buffer.
+    \param out      Buffer
+    \param id       Object Id
+    \param e        Entry
+    \param removed  true to produce a removal record */
+void
+server::file::ca::PersistentObjectCache::appendRecord(afl::base::GrowableBytes_t& out, const ObjectId& id, const Entry& e, bool removed)
+{
+    const bool withContent = !removed && e.content.get() != 0;
+
+    RecordHeader rh;
+    afl::base::Bytes_t(rh.id).copyFrom(id.m_bytes);
+    rh.type = static_cast<uint8_t>(e.type);
+    rh.flags = static_cast<uint8_t>((withContent ? HasContent : 0) | (removed ? IsRemoved : 0));
+    rh.reserved[0] = 0;
+    rh.reserved[1] = 0;
+    rh.size = static_cast<uint32_t>(e.size);
+    rh.check = computeCheck(rh);
+    out.append(afl::base::fromObject(rh));
+    if (withContent) {
+        out.append(e.content->get());
+    }
+}
@@ -0,0 +1,94 @@
+/**
+  *  \file server/file/ca/persistentobjectcache.hpp
+  *  \brief Class server::file::ca::PersistentObjectCache
+  */
+#ifndef C2NG_SERVER_FILE_CA_PERSISTENTOBJECTCACHE_HPP
+#define C2NG_SERVER_FILE_CA_PERSISTENTOBJECTCACHE_HPP
+
+#include <map>
+#include <vector>
+#include "afl/base/growablememory.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/io/stream.hpp"
+#include "server/file/ca/internalobjectcache.hpp"
+#include "server/file/ca/objectcache.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    /** Persistent object cache.
+        Stores object sizes (all types) and content of TreeObject's in a cache file,
+        so that getObjectSize() and directory walks are fast right after a restart.
+        All other content is cached in memory using an InternalObjectCache.
+
+        The cache file is a log of records, each containing an ObjectId, type, size, and optional content.
+        New information is appended to the file as it arrives.
+        The file is limited to a fixed size;
+        when that is exceeded, it is rewritten containing only the most-recently used objects.
+
+        When loading, object content is verified against the ObjectId,
+        and loading stops at the first invalid record.
+        A damaged or foreign cache file therefore only reduces the cache's effectiveness.
+
+        The file is read using a file mapping at startup.
+        Its content is copied into memory, so that the file can safely be rewritten during operation;
+        the memory used therefore is bounded by the file size limit.
+
+        Only one PersistentObjectCache may operate on a file at a time. */
+    class PersistentObjectCache : public ObjectCache {
+     public:
+        /** Constructor.
+            Loads the cache file.
+            \param file     Cache file (opened for reading and writing; can be empty)
+            \param maxBytes Maximum size of the cache file */
+        PersistentObjectCache(afl::base::Ref<afl::io::Stream> file, size_t maxBytes);
+
+        /** Destructor. */
+        ~PersistentObjectCache();
+
+        /** Access in-memory cache.
+            This cache is used for objects that are not persisted (i.e. content of non-tree objects).
+            \return InternalObjectCache */
+        InternalObjectCache& memoryCache();
+
+        /** Get number of persisted objects.
+            \return number of objects known to the cache file */
+        size_t getNumObjects() const;
+
+        /** Get Ids of persisted objects.
+            \param [out] out Object Ids are appended here */
+        void getObjectIds(std::vector<ObjectId>& out) const;
+
+        // ObjectCache:
+        virtual void addObject(const ObjectId& id, ObjectStore::Type type, afl::base::Ref<afl::io::FileMapping> content);
+        virtual void addObjectSize(const ObjectId& id, ObjectStore::Type type, size_t size);
+        virtual void removeObject(const ObjectId& id);
+        virtual afl::base::Ptr<afl::io::FileMapping> getObject(const ObjectId& id, ObjectStore::Type type);
+        virtual afl::base::Optional<size_t> getObjectSize(const ObjectId& id, ObjectStore::Type type);
+
+     private:
+        struct Entry {
+            ObjectStore::Type type;
+            size_t size;
+            afl::base::Ptr<afl::io::FileMapping> content;
+            uint32_t lastUse;
+        };
+        typedef std::map<ObjectId, Entry> Map_t;
+
+        afl::base::Ref<afl::io::Stream> m_file;
+        const size_t m_maxBytes;
+        afl::io::Stream::FileSize_t m_writePosition;
+        uint32_t m_useCounter;
+        bool m_writeEnabled;
+        Map_t m_entries;
+        InternalObjectCache m_memoryCache;
+
+        void load();
+        Entry& touch(Entry& e);
+        void writeRecord(const ObjectId& id, const Entry& e, bool removed);
+        void rewrite();
+        static void appendRecord(afl::base::GrowableBytes_t& out, const ObjectId& id, const Entry& e, bool removed);
+    };
+
+} } }
+
+#endif
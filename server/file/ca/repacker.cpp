@@ -0,0 +1,200 @@
+/**
+  *  \file server/file/ca/repacker.cpp
+  *  \brief Class server::file::ca::Repacker
+  */
+
+#include <algorithm>
+#include <vector>
+#include "server/file/ca/repacker.hpp"
+#include "afl/checksums/sha1.hpp"
+#include "afl/string/format.hpp"
+#include "server/file/ca/directoryentry.hpp"
+#include "server/file/ca/packwriter.hpp"
+
+using afl::string::Format;
+using afl::sys::LogListener;
+
+namespace {
+    const char*const LOG_NAME = "file.ca";
+
+    /* Object to be packed */
+    struct Item {
+        server::file::ca::ObjectId id;
+        server::file::ca::ObjectStore::Type type;
+        size_t size;
+
+        /* Sort by type, then by decreasing size.
+           git does the same (plus sorting by name, which we don't have), so that objects are delta-encoded against larger ones. */
+        bool operator<(const Item& other) const
+            {
+                return type != other.type ? type < other.type
+                    : size != other.size ? size > other.size
+                    : id < other.id;
+            }
+    };
+}
+
+server::file::ca::Repacker::Repacker(ObjectStore& objStore, afl::sys::LogListener& log)
+    : m_objectStore(objStore),
+      m_log(log),
+      m_objects(),
+      m_numErrors(0)
+{ }
+
+server::file::ca::Repacker::~Repacker()
+{ }
+
+void
+server::file::ca::Repacker::addCommit(const ObjectId& id)
+{
+    // Commit
+    if (!addObject(id, ObjectStore::CommitObject)) {
+        return;
+    }
+
+    std::vector<ObjectId> treesToCheck;
+    try {
+        const ObjectId treeId = m_objectStore.getCommit(id);
+        if (addObject(treeId, ObjectStore::TreeObject)) {
+            treesToCheck.push_back(treeId);
+        }
+    }
+    catch (std::exception& e) {
+        m_log.write(LogListener::Error, LOG_NAME, Format("%s: error resolving as commit", id.toHex()), e);
+        ++m_numErrors;
+    }
+
+    // Trees
+    while (!treesToCheck.empty()) {
+        const ObjectId treeId = treesToCheck.back();
+        treesToCheck.pop_back();
+        try {
+            afl::base::Ref<afl::io::FileMapping> content = m_objectStore.getObject(treeId, ObjectStore::TreeObject);
+            afl::base::ConstBytes_t contentBytes = content->get();
+            DirectoryEntry e;
+            while (e.parse(contentBytes)) {
+                switch (e.getType()) {
+                 case DirectoryHandler::IsUnknown:
+                 case DirectoryHandler::IsFile:
+                    addObject(e.getId(), ObjectStore::DataObject);
+                    break;
+
+                 case DirectoryHandler::IsDirectory:
+                    if (addObject(e.getId(), ObjectStore::TreeObject)) {
+                        treesToCheck.push_back(e.getId());
+                    }
+                    break;
+                }
+            }
+        }
+        catch (std::exception& e) {
+            m_log.write(LogListener::Error, LOG_NAME, Format("%s: error resolving as tree", treeId.toHex()), e);
+            ++m_numErrors;
+        }
+    }
+}
+
+size_t
+server::file::ca::Repacker::getNumObjects() const
+{
+    return m_objects.size();
+}
+
+size_t
+server::file::ca::Repacker::getNumErrors() const
+{
+    return m_numErrors;
+}
+
+String_t
+server::file::ca::Repacker::getPackName() const
+{
+    afl::checksums::SHA1 hash;
+    for (ObjectMap_t::const_iterator it = m_objects.begin(), e = m_objects.end(); it != e; ++it) {
+        hash.add(it->first.m_bytes);
+    }
+    return "pack-" + ObjectId::fromHash(hash).toHex();
+}
+
+void
+server::file::ca::Repacker::writePack(afl::io::Stream& packOut, afl::io::DataSink& indexOut)
+{
+    // Determine order
+    std::vector<Item> items;
+    items.reserve(m_objects.size());
+    for (ObjectMap_t::const_iterator it = m_objects.begin(), e = m_objects.end(); it != e; ++it) {
+        Item item;
+        item.id = it->first;
+        item.type = it->second;
+        item.size = m_objectStore.getObjectSize(it->first, it->second);
+        items.push_back(item);
+    }
+    std::sort(items.begin(), items.end());
+
+    // Write
+    PackWriter writer(packOut, static_cast<uint32_t>(items.size()));
+    for (size_t i = 0, n = items.size(); i < n; ++i) {
+        writer.addObject(items[i].id, items[i].type, m_objectStore.getObject(items[i].id, items[i].type));
+    }
+    writer.finish(indexOut);
+}
+
+size_t
+server::file::ca::Repacker::removeLooseObjects()
+{
+    class Collector : public DirectoryHandler::Callback {
+     public:
+        Collector(const ObjectMap_t& objects, const String_t& prefix)
+            : m_objects(objects), m_prefix(prefix), m_filesToDelete()
+            { }
+        virtual void addItem(const DirectoryHandler::Info& info)
+            {
+                if (info.type == DirectoryHandler::IsFile) {
+                    const String_t hex = m_prefix + info.name;
+                    const ObjectId id = ObjectId::fromHex(hex);
+                    if (id.toHex() == hex && m_objects.find(id) != m_objects.end()) {
+                        // Do not immediately delete, to not confuse the DirectoryHandler (see GarbageCollector).
+                        m_filesToDelete.push_back(info.name);
+                    }
+                }
+            }
+        size_t removeFiles(DirectoryHandler& hdl)
+            {
+                for (size_t i = 0, n = m_filesToDelete.size(); i < n; ++i) {
+                    hdl.removeFile(m_filesToDelete[i]);
+                }
+                return m_filesToDelete.size();
+            }
+     private:
+        const ObjectMap_t& m_objects;
+        const String_t m_prefix;
+        std::vector<String_t> m_filesToDelete;
+    };
+
+    size_t numRemoved = 0;
+    for (size_t prefix = 0; prefix < 256; ++prefix) {
+        if (DirectoryHandler* hdl = m_objectStore.getObjectDirectory(prefix)) {
+            try {
+                Collector c(m_objects, Format("%02x", prefix));
+                hdl->readContent(c);
+                numRemoved += c.removeFiles(*hdl);
+            }
+            catch (std::exception& e) {
+                m_log.write(LogListener::Warn, LOG_NAME, Format("%02x: error cleaning up", prefix), e);
+            }
+        }
+    }
+    return numRemoved;
+}
+
+/** Add an object.
+    @param id    Object Id
+    @param type  Object type
+    @return true if object was newly added; false if it was already known or is not a real object */
+bool
+server::file::ca::Repacker::addObject(const ObjectId& id, ObjectStore::Type type)
+{
+    // ObjectId::nil is a placeholder that is never stored
+    return id != ObjectId::nil
+        && m_objects.insert(std::make_pair(id, type)).second;
+}
@@ -0,0 +1,88 @@
+/**
+  *  \file server/file/ca/repacker.hpp
+  *  \brief Class server::file::ca::Repacker
+  */
+#ifndef C2NG_SERVER_FILE_CA_REPACKER_HPP
+#define C2NG_SERVER_FILE_CA_REPACKER_HPP
+
+#include <map>
+#include "afl/io/datasink.hpp"
+#include "afl/io/stream.hpp"
+#include "afl/sys/loglistener.hpp"
+#include "server/file/ca/objectid.hpp"
+#include "server/file/ca/objectstore.hpp"
+
+namespace server { namespace file { namespace ca {
+
+    /** Repacker.
+        Collects all objects reachable from a set of commits, and writes them into a single pack file.
+
+        Like GarbageCollector, this starts at root commits and builds the transitive closure.
+        A pack file written by Repacker therefore never contains garbage at the time it is written.
+        Objects that become garbage later remain in the pack until the next repack
+        (GarbageCollector only removes loose objects).
+
+        Basic operation:
+        - use addCommit() to add root commits;
+        - if getNumErrors() is nonzero, stop (the object store is damaged; writing a pack would lose objects);
+        - call writePack() to write the pack file (naming it getPackName());
+        - after the pack file has been added to the ObjectStore, call removeLooseObjects().
+
+        Root::repack() implements this sequence.
+        Parallel changes to the ObjectStore are not safe. */
+    class Repacker {
+     public:
+        /** Constructor.
+            @param objStore Object store
+            @param log      Log listener (for error messages) */
+        Repacker(ObjectStore& objStore, afl::sys::LogListener& log);
+
+        /** Destructor. */
+        ~Repacker();
+
+        /** Add a commit and all objects reachable from it.
+            @param id Object Id of a CommitObject */
+        void addCommit(const ObjectId& id);
+
+        /** Get number of objects to pack.
+            @return number */
+        size_t getNumObjects() const;
+
+        /** Get number of errors.
+            Errors are objects that could not be read.
+            @return number */
+        size_t getNumErrors() const;
+
+        /** Get pack name.
+            The name is derived from the set of objects, similar to what early versions of git did.
+            Packing the same set of objects again produces the same name.
+            @return base name (without ".pack", ".idx") */
+        String_t getPackName() const;
+
+        /** Write pack file.
+            Objects are sorted by type and size, so that similar objects end up next to each other, to improve delta compression.
+            @param packOut  Pack file
+            @param indexOut Index file; written after the pack file has been completed */
+        void writePack(afl::io::Stream& packOut, afl::io::DataSink& indexOut);
+
+        /** Remove loose objects.
+            Removes the loose copies of all objects that have been packed.
+            Call after the new pack file has been added to the ObjectStore.
+            @return number of loose objects removed */
+        size_t removeLooseObjects();
+
+     private:
+        typedef std::map<ObjectId, ObjectStore::Type> ObjectMap_t;
+
+        ObjectStore& m_objectStore;
+        afl::sys::LogListener& m_log;
+
+        ObjectMap_t m_objects;
+        size_t m_numErrors;
+
+        bool addObject(const ObjectId& id, ObjectStore::Type type);
+    };
+
+} } }
+
+#endif
@@ -5,11 +5,14 @@
 
 #include "server/file/ca/root.hpp"
 
+#include <algorithm>
 #include <map>
+#include <vector>
 
 #include "afl/except/fileproblemexception.hpp"
 #include "afl/io/constmemorystream.hpp"
 #include "afl/io/directoryentry.hpp"
+#include "afl/io/internalsink.hpp"
 #include "afl/io/textfile.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/messages.hpp"
@@ -17,6 +20,9 @@
 #include "server/file/ca/directoryhandler.hpp"
 #include "server/file/ca/objectid.hpp"
 #include "server/file/ca/objectstore.hpp"
+#include "server/file/ca/packfile.hpp"
+#include "server/file/ca/persistentobjectcache.hpp"
+#include "server/file/ca/repacker.hpp"
 #include "server/file/directoryhandler.hpp"
 
 using afl::string::Format;
@@ -28,6 +34,10 @@ using server::file::ca::ObjectStore;
 namespace {
     const char*const LOG_NAME = "file.ca";
 
+    /* Name of the persistent object cache file.
+       git ignores unknown files in the repository directory. */
+    const char*const CACHE_FILE_NAME = "c2cache";
+
     DirectoryHandler* getCreateDirectory(DirectoryHandler& parent, String_t name)
     {
         DirectoryHandler::Info info;
@@ -166,6 +176,7 @@ server::file::ca::Root::Root(server::file::DirectoryHandler& root, afl::sys::Log
       m_refsTags(),
       m_objects(),
       m_store(),
+      m_packNames(),
       m_snapshotHandler()
 {
     init(log);
@@ -275,6 +286,98 @@ server::file::ca::Root::createSnapshotHandler(ObjectId commitId)
     return new DirectoryHandler(*m_store, treeId, "(ca-snapshot)", 0, 0);
 }
 
+// Repack.
+bool
+server::file::ca::Root::repack(afl::sys::LogListener& log)
+{
+    // Pack files require an actual directory
+    if (m_objects->getDirectory().get() == 0) {
+        log.write(LogListener::Warn, LOG_NAME, "repack: object store does not support pack files");
+        return false;
+    }
+    std::auto_ptr<server::file::DirectoryHandler> packDirHandler(getCreateDirectory(*m_objects, "pack"));
+    afl::base::Ptr<afl::io::Directory> packDir = packDirHandler->getDirectory();
+    if (packDir.get() == 0) {
+        log.write(LogListener::Warn, LOG_NAME, "repack: object store does not support pack files");
+        return false;
+    }
+
+    // Collect objects
+    std::vector<ObjectId> roots;
+    listRoots(roots);
+
+    Repacker packer(*m_store, log);
+    for (size_t i = 0; i < roots.size(); ++i) {
+        packer.addCommit(roots[i]);
+    }
+    if (packer.getNumErrors() != 0) {
+        log.write(LogListener::Error, LOG_NAME, Format("repack: %d errors, aborting", packer.getNumErrors()));
+        return false;
+    }
+
+    // Write pack, unless we already have exactly this one.
+    // The index file is written last, so that a pack file interrupted midway is ignored by loadPackFiles().
+    const String_t packName = packer.getPackName();
+    if (std::find(m_packNames.begin(), m_packNames.end(), packName) == m_packNames.end()) {
+        afl::io::InternalSink indexData;
+        packer.writePack(*packDir->openFile(packName + ".pack", afl::io::FileSystem::Create), indexData);
+        packDir->openFile(packName + ".idx", afl::io::FileSystem::Create)->fullWrite(indexData.getContent());
+    }
+
+    // Replace pack files
+    m_store->removePackFiles();
+    m_store->addNewPackFile(new PackFile(*packDir, packName));
+    for (size_t i = 0; i < m_packNames.size(); ++i) {
+        if (m_packNames[i] != packName) {
+            try {
+                packDir->erase(m_packNames[i] + ".idx");
+                packDir->erase(m_packNames[i] + ".pack");
+            }
+            catch (std::exception& e) {
+                log.write(LogListener::Warn, LOG_NAME, Format("repack: failed to remove pack \"%s\"", m_packNames[i]), e);
+            }
+        }
+    }
+    m_packNames.clear();
+    m_packNames.push_back(packName);
+
+    // Remove loose objects
+    size_t numRemoved = packer.removeLooseObjects();
+    log.write(LogListener::Info, LOG_NAME, Format("repack: %d objects in pack \"%s\", %d loose objects removed", packer.getNumObjects(), packName, numRemoved));
+    return true;
+}
+
+// Enable persistent object cache.
+bool
+server::file::ca::Root::enablePersistentCache(size_t maxBytes, afl::sys::LogListener& log)
+{
+    afl::base::Ptr<afl::io::Directory> dir = m_root.getDirectory();
+    if (dir.get() == 0) {
+        log.write(LogListener::Warn, LOG_NAME, "object cache: not supported by this file space");
+        return false;
+    }
+
+    try {
+        afl::base::Ptr<afl::io::Stream> file = dir->openFileNT(CACHE_FILE_NAME, afl::io::FileSystem::OpenWrite);
+        if (file.get() == 0) {
+            file = dir->openFile(CACHE_FILE_NAME, afl::io::FileSystem::Create).asPtr();
+        }
+        PersistentObjectCache* cache = new PersistentObjectCache(*file, maxBytes);
+        m_store->setNewObjectCache(cache);
+
+        // The cache file may know objects that have been removed since it was written
+        std::vector<ObjectId> ids;
+        cache->getObjectIds(ids);
+        size_t numRemoved = m_store->removeStaleCachedObjects(ids);
+        log.write(LogListener::Info, LOG_NAME, Format("object cache: %d objects loaded, %d stale objects removed", cache->getNumObjects(), numRemoved));
+        return true;
+    }
+    catch (std::exception& e) {
+        log.write(LogListener::Warn, LOG_NAME, "object cache: unable to open cache file", e);
+        return false;
+    }
+}
+
 // Access the ObjectStore instance.
 server::file::ca::ObjectStore&
 server::file::ca::Root::objectStore()
@@ -348,6 +451,7 @@ server::file::ca::Root::loadPackFiles(afl::sys::LogListener& log)
             // Ignore failing packs (which could be originating in a pack operation crashed midway?)
             try {
                 m_store->addNewPackFile(new PackFile(*packDir, it->first));
+                m_packNames.push_back(it->first);
                 log.write(LogListener::Trace, LOG_NAME, Format("added pack \"%s\"", it->first));
             }
             catch (std::exception& e) {
@@ -78,6 +78,27 @@ namespace server { namespace file { namespace ca {
             @return newly-allocated DirectoryHandler */
         server::file::DirectoryHandler* createSnapshotHandler(ObjectId commitId);
 
+        /** Repack.
+            Writes all objects reachable from listRoots() into a new pack file,
+            replaces all existing pack files by the new one, and removes the loose copies of the packed objects.
+
+            This operation must not run in parallel to other accesses to this Root.
+            It aborts without changing anything if the object store is damaged (objects cannot be read).
+
+            @param log Logger
+            @return true on success, false if the operation was not possible */
+        bool repack(afl::sys::LogListener& log);
+
+        /** Enable persistent object cache.
+            Replaces the ObjectStore's cache by a PersistentObjectCache using a file in the root directory.
+            This should be called before using the object store, but after maintenance (garbage collection, repack)
+            which removes object files without the persistent cache noticing.
+            Cache entries of objects that no longer exist are dropped (see ObjectStore::removeStaleCachedObjects()).
+            @param maxBytes Maximum size of the cache file
+            @param log      Logger
+            @return true on success, false if the cache file cannot be used (ObjectStore keeps its previous cache) */
+        bool enablePersistentCache(size_t maxBytes, afl::sys::LogListener& log);
+
         /** Access the ObjectStore instance.
             @return ObjectStore instance */
         ObjectStore& objectStore();
@@ -120,6 +141,9 @@ namespace server { namespace file { namespace ca {
         /** ObjectStore instance. Never null during lifetime of this object. */
         std::auto_ptr<ObjectStore> m_store;
 
+        /** Names of loaded pack files (without extension). */
+        afl::data::StringList_t m_packNames;
+
         /** Snapshot Handler. */
         std::auto_ptr<SnapshotHandler> m_snapshotHandler;
     };
@@ -80,6 +80,8 @@ server::file::ClientApplication::appMain()
         doServe(commandLine);
     } else if (*pCommand == "gc") {
         doGC(commandLine);
+    } else if (*pCommand == "repack") {
+        doRepack(commandLine);
     } else if (*pCommand == "snapshot") {
         doSnapshot(commandLine);
     } else {
@@ -426,6 +428,42 @@ server::file::ClientApplication::doGC(afl::sys::CommandLineParser& cmdl)
     }
 }
 
+void
+server::file::ClientApplication::doRepack(afl::sys::CommandLineParser& cmdl)
+{
+    // Parse parameters
+    Translator& tx = translator();
+    Optional<String_t> dir;
+
+    String_t p;
+    bool opt;
+    while (cmdl.getNext(opt, p)) {
+        if (opt) {
+            errorExit(Format(tx("invalid option specified. Use '%s -h' for help."), environment().getInvocationName()));
+        } else if (!dir.isValid()) {
+            dir = p;
+        } else {
+            errorExit(Format(tx("too many parameters. Use '%s -h' for help."), environment().getInvocationName()));
+        }
+    }
+
+    const String_t* pDir = dir.get();
+    if (pDir == 0) {
+        errorExit(Format(tx("too few parameters. Use '%s -h' for help."), environment().getInvocationName()));
+    }
+
+    // Objects
+    // (Intentionally do not use DirectoryHandlerFactory; we don't want to use 'ca:DIR' here.)
+    FileSystemHandler handler(fileSystem(), *pDir);
+    server::file::ca::Root root(handler, log());
+
+    // Do it!
+    if (!root.repack(log())) {
+        errorOutput().writeLine("Repack failed");
+        exit(1);
+    }
+}
+
 void
 server::file::ClientApplication::doSnapshot(afl::sys::CommandLineParser& cmdl)
 {
@@ -531,6 +569,8 @@ server::file::ClientApplication::help()
                             "                      Serve SOURCE via HTTP for testing\n"
                             "  %$0s gc [-n] [-f] PATH\n"
                             "                      Garbage-collect a CA file system\n"
+                            "  %$0s repack PATH\n"
+                            "                      Pack objects of a CA file system into a pack file\n"
                             "  %$0s snapshot PATH ls [-l]\n"
                             "                      List snapshots (tags) on CA file system\n"
                             "  %$0s snapshot PATH add NAME...\n"
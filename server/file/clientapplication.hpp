@@ -41,6 +41,7 @@ namespace server { namespace file {
         void doClear(afl::sys::CommandLineParser& cmdl);
         void doServe(afl::sys::CommandLineParser& cmdl);
         void doGC(afl::sys::CommandLineParser& cmdl);
+        void doRepack(afl::sys::CommandLineParser& cmdl);
         void doSnapshot(afl::sys::CommandLineParser& cmdl);
         void help();
 
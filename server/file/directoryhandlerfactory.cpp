@@ -70,6 +70,14 @@ namespace {
             ;
         log.write(LogListener::Info, LOG_NAME, Format("Total objects removed: %d", gc.getNumObjectsRemoved()));
     }
+
+    void doRepack(server::file::ca::Root& root, afl::sys::LogListener& log, const String_t& name)
+    {
+        log.write(LogListener::Info, LOG_NAME, "Repack...");
+        if (!root.repack(log)) {
+            throw afl::except::FileProblemException(name, "Repack error");
+        }
+    }
 }
 
 // Constructor.
@@ -79,7 +87,9 @@ server::file::DirectoryHandlerFactory::DirectoryHandlerFactory(afl::io::FileSyst
       m_clientCache(),
       m_fs(fs),
       m_networkStack(net),
-      m_gcEnabled(false)
+      m_gcEnabled(false),
+      m_repackEnabled(false),
+      m_objectCacheSize(0)
 { }
 
 // Set garbage collection mode.
@@ -89,6 +99,20 @@ server::file::DirectoryHandlerFactory::setGarbageCollection(bool enabled)
     m_gcEnabled = enabled;
 }
 
+// Set repack mode.
+void
+server::file::DirectoryHandlerFactory::setRepack(bool enabled)
+{
+    m_repackEnabled = enabled;
+}
+
+// Set persistent object cache size.
+void
+server::file::DirectoryHandlerFactory::setObjectCacheSize(size_t maxBytes)
+{
+    m_objectCacheSize = maxBytes;
+}
+
 // Create a DirectoryHandler.
 server::file::DirectoryHandler&
 server::file::DirectoryHandlerFactory::createDirectoryHandler(const String_t& str, afl::sys::LogListener& log)
@@ -165,6 +189,13 @@ server::file::DirectoryHandlerFactory::createDirectoryHandler(const String_t& st
                 if (m_gcEnabled) {
                     doGarbageCollection(root, log, path);
                 }
+                if (m_repackEnabled) {
+                    doRepack(root, log, path);
+                }
+                if (m_objectCacheSize != 0) {
+                    // Enable after maintenance, which removes files behind the cache's back
+                    root.enablePersistentCache(m_objectCacheSize, log);
+                }
                 result = &m_deleter.addNew(root.createRootHandler());
             } else if (const char* path = util::strStartsWith(str, "snapshot:")) {
                 // Content-addressable snapshot
@@ -182,6 +213,13 @@ server::file::DirectoryHandlerFactory::createDirectoryHandler(const String_t& st
                 if (m_gcEnabled) {
                     doGarbageCollection(root, log, rootPath);
                 }
+                if (m_repackEnabled) {
+                    doRepack(root, log, rootPath);
+                }
+                if (m_objectCacheSize != 0) {
+                    // Enable after maintenance, which removes files behind the cache's back
+                    root.enablePersistentCache(m_objectCacheSize, log);
+                }
 
                 afl::base::Optional<server::file::ca::ObjectId> snapId = root.getSnapshotCommitId(snapName);
                 if (snapId.get() == 0) {
@@ -36,6 +36,18 @@ namespace server { namespace file {
                            If false (default), no garbage collection is run */
         void setGarbageCollection(bool enabled);
 
+        /** Set repack mode.
+            \param enabled Set status.
+                           If true, a CA backend is repacked (after garbage collection, if enabled) before it is used.
+                           If false (default), pack files are used as-is. */
+        void setRepack(bool enabled);
+
+        /** Set persistent object cache size.
+            \param maxBytes Maximum size of the cache file.
+                            If nonzero, a CA backend uses a persistent object cache (see server::file::ca::Root::enablePersistentCache()).
+                            If zero (default), only an in-memory cache is used. */
+        void setObjectCacheSize(size_t maxBytes);
+
         /** Create a DirectoryHandler.
             \param str Descriptor
             \param log Logger (for GC)
@@ -73,6 +85,8 @@ namespace server { namespace file {
         afl::io::FileSystem& m_fs;
         afl::net::NetworkStack& m_networkStack;
         bool m_gcEnabled;
+        bool m_repackEnabled;
+        size_t m_objectCacheSize;
     };
 
 } }
@@ -133,7 +133,9 @@ server::file::ServerApplication::ServerApplication(afl::sys::Environment& env, a
       m_rootDirectory("."),
       m_maxFileSize(10UL*1024*1024),
       m_interrupt(intr),
-      m_gcEnabled(true)
+      m_gcEnabled(true),
+      m_repackEnabled(false),
+      m_objectCacheSize(0)
 { }
 
 server::file::ServerApplication::~ServerApplication()
@@ -145,6 +147,9 @@ server::file::ServerApplication::handleCommandLineOption(const String_t& option,
     if (option == "nogc") {
         m_gcEnabled = false;
         return true;
+    } else if (option == "repack") {
+        m_repackEnabled = true;
+        return true;
     } else {
         return false;
     }
@@ -157,6 +162,8 @@ server::file::ServerApplication::serverMain()
     afl::io::FileSystem& fs = fileSystem();
     DirectoryHandlerFactory dhFactory(fs, networkStack());
     dhFactory.setGarbageCollection(m_gcEnabled);
+    dhFactory.setRepack(m_repackEnabled);
+    dhFactory.setObjectCacheSize(m_objectCacheSize);
     DirectoryItem item("(root)", 0, std::auto_ptr<DirectoryHandler>(new ProxyDirectoryHandler(dhFactory.createDirectoryHandler(m_rootDirectory, log()))));
 
     afl::base::Ref<afl::io::Directory> defaultSpecDirectory = fs.openDirectory(fs.makePathName(fs.makePathName(environment().getInstallationDirectoryName(), "share"), "specs"));
@@ -218,6 +225,16 @@ server::file::ServerApplication::handleConfiguration(const String_t& key, const
             throw afl::except::CommandLineException(afl::string::Format("Invalid number for '%s'", key));
         }
         return true;
+    } else if (isInstanceOption(key, "OBJECTCACHESIZE")) {
+        /* @q File.ObjectCacheSize:Int (Config), HostFile.ObjectCacheSize:Int (Config)
+           Size of the persistent object cache file, in bytes.
+           If nonzero, a content-addressable backend ("ca:") keeps object sizes and directory content
+           in a cache file in the repository, to speed up access after a restart.
+           Default: 0 (no persistent cache). */
+        if (!afl::string::strToInteger(value, m_objectCacheSize)) {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid number for '%s'", key));
+        }
+        return true;
     } else if (isInstanceOption(key, "THREADS")) {
         /* @q File.Threads:Int (Config), HostFile.Threads:Int (Config)
            Ignored in c2file-ng for compatibility reasons.
@@ -237,6 +254,7 @@ server::file::ServerApplication::getApplicationName() const
 String_t
 server::file::ServerApplication::getCommandLineOptionHelp() const
 {
-    return "--nogc\tDisable garbage collection\n";
+    return "--nogc\tDisable garbage collection\n"
+        "--repack\tPack objects on startup\n";
 }
 
@@ -40,6 +40,8 @@ namespace server { namespace file {
         afl::io::Stream::FileSize_t m_maxFileSize;   // ex arg_file_size_limit
         afl::async::Interrupt& m_interrupt;
         bool m_gcEnabled;
+        bool m_repackEnabled;
+        size_t m_objectCacheSize;
     };
 
 } }
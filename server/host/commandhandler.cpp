@@ -274,7 +274,8 @@ server::host::CommandHandler::getHelp(String_t topic) const
             " SPEC->\n"
             " SLOT->\n"
             " TOOL->\n"
-            " RANKLIST [SORT <field>] [REVERSE] [FIELDS <field>...]\n"
+            " RANKLIST [SORT <field>] [REVERSE] [LIMIT <start> <count>] [FIELDS <field>...]\n"
+            " RANKREBUILD\n"
             " TRN <data> [GAME <gid> [SLOT <slot>]] [MAIL <mail>]\n"
             " TRNMARKTEMP <gid> <slot> <state>\n"
             "This is c2host-ng.\n";
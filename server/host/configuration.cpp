@@ -13,6 +13,7 @@ server::host::Configuration::Configuration()
       binDirectory("."),
       specDirectory(),
       useCron(true),
+      numHostWorkers(1),
       unpackBackups(false),
       usersSeeTemporaryTurns(true),
       numMissedTurnsForKick(0),
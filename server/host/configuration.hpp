@@ -38,6 +38,10 @@ namespace server { namespace host {
         /** Cron. */
         bool useCron;
 
+        /** Number of host runs that can execute in parallel.
+            Each one uses a separate ProcessRunner and work directory. */
+        int numHostWorkers;
+
         /** Backup mode. */
         bool unpackBackups;
 
@@ -32,6 +32,19 @@ namespace {
     /** Delay from last join to game actually starting. */
     const int32_t MASTER_DELAY = 15;
 
+    /** Get name of an action for logging. */
+    const char* getActionName(HostCron::Action action)
+    {
+        switch (action) {
+         case HostCron::HostAction:           return "host";
+         case HostCron::MasterAction:         return "master";
+         case HostCron::ScheduleChangeAction: return "schedulechange";
+         case HostCron::NoAction:             return "none";
+         case HostCron::UnknownAction:        return "UNKNOWN";
+        }
+        return 0;
+    }
+
     /** Predicate to find a game in a list of ScheduleItems. */
     class IsGame {
      public:
@@ -126,6 +139,7 @@ namespace {
                 // This schedule is expired, drop it
                 scheduleList.popFront();
                 schedules.hashKey(currentScheduleId).remove();
+                gg.clearScheduleCache();
                 currentScheduleValid = false;
                 haveDroppedSchedule = true;
             } else {
@@ -231,23 +245,88 @@ namespace {
 }
 
 
+/*
+ *  Worker
+ *
+ *  A worker executes due events, using its own ProcessRunner and work directory.
+ */
+
+class server::host::CronImpl::Worker : public afl::base::Stoppable {
+ public:
+    Worker(CronImpl& parent, util::ProcessRunner& runner, size_t index)
+        : m_parent(parent), m_runner(runner), m_index(index)
+        { }
+
+    // Stoppable:
+    void run()
+        { m_parent.workerMain(*this); }
+    void stop()
+        {
+            // Workers are stopped collectively by CronImpl::stop.
+        }
+
+    util::ProcessRunner& runner()
+        { return m_runner; }
+    size_t getIndex() const
+        { return m_index; }
+
+    /* Name of work directory. First worker uses the same name as before parallelisation. */
+    String_t getWorkDirectoryName() const
+        { return m_index == 0 ? String_t("host") : afl::string::Format("host.%d", m_index); }
+
+ private:
+    CronImpl& m_parent;
+    util::ProcessRunner& m_runner;
+    const size_t m_index;
+};
+
+
+/*
+ *  CronImpl
+ */
+
 // Constructor.
 server::host::CronImpl::CronImpl(Root& root, util::ProcessRunner& runner)
     : Cron(), Uncopyable(), Stoppable(),
       m_root(root),
-      m_runner(runner),
       m_thread("host.cron", *this),
+      m_workers(),
+      m_workerThreads(),
       m_mutex(),
       m_wake(0),
+      m_workAvailable(0),
       m_stopFlag(false),
       m_changedGames(),
       m_suspendUntil(0),
       m_futureEvents(),
-      m_dueEvents()
+      m_dueEvents(),
+      m_runningGames(),
+      m_deferredGames(),
+      m_dueTicks()
 {
-    // ex Cron::Cron, Cron::start
-    m_root.setCron(this);
-    m_thread.start();
+    init(std::vector<util::ProcessRunner*>(1, &runner));
+}
+
+// Constructor for parallel operation.
+server::host::CronImpl::CronImpl(Root& root, const std::vector<util::ProcessRunner*>& runners)
+    : Cron(), Uncopyable(), Stoppable(),
+      m_root(root),
+      m_thread("host.cron", *this),
+      m_workers(),
+      m_workerThreads(),
+      m_mutex(),
+      m_wake(0),
+      m_workAvailable(0),
+      m_stopFlag(false),
+      m_changedGames(),
+      m_suspendUntil(0),
+      m_futureEvents(),
+      m_dueEvents(),
+      m_runningGames(),
+      m_deferredGames(),
+      m_dueTicks()
+{
+    init(runners);
 }
 
 // Destructor.
@@ -256,6 +335,9 @@ server::host::CronImpl::~CronImpl()
     m_root.setCron(0);
     stop();
     m_thread.join();
+    for (size_t i = 0, n = m_workerThreads.size(); i < n; ++i) {
+        m_workerThreads[i]->join();
+    }
 }
 
 // Get next action for a game. Looks only at the schedules.
@@ -274,7 +356,9 @@ server::host::CronImpl::getGameEvent(int32_t gameId)
     std::list<Event_t>::const_iterator p = std::find_if(m_dueEvents.begin(), m_dueEvents.end(), IsGame(gameId));
     if (p != m_dueEvents.end()) {
         // Return time 0 to mean now
-        return Event_t(p->gameId, p->action, 0);
+        Event_t result(p->gameId, p->action, 0);
+        result.running = (m_runningGames.find(gameId) != m_runningGames.end());
+        return result;
     }
 
     // Is it in the future?
@@ -295,7 +379,9 @@ server::host::CronImpl::listGameEvents(std::vector<Event_t>& result)
     // ex Cron::getAllSchedules
     afl::sys::MutexGuard g(m_mutex);
     for (std::list<Event_t>::const_iterator p = m_dueEvents.begin(); p != m_dueEvents.end(); ++p) {
-        result.push_back(Event_t(p->gameId, p->action, 0));
+        Event_t e(p->gameId, p->action, 0);
+        e.running = (m_runningGames.find(p->gameId) != m_runningGames.end());
+        result.push_back(e);
     }
     for (std::list<Event_t>::const_iterator p = m_futureEvents.begin(); p != m_futureEvents.end(); ++p) {
         result.push_back(*p);
@@ -352,6 +438,7 @@ server::host::CronImpl::run()
             m_changedGames.clear();
             m_futureEvents.clear();
             m_dueEvents.clear();
+            m_deferredGames.clear();
         }
     }
 }
@@ -365,6 +452,26 @@ server::host::CronImpl::stop()
         m_stopFlag = true;
     }
     m_wake.post();
+    for (size_t i = 0, n = m_workers.size(); i < n; ++i) {
+        m_workAvailable.post();
+    }
+}
+
+// Initialisation: create workers and start threads.
+void
+server::host::CronImpl::init(const std::vector<util::ProcessRunner*>& runners)
+{
+    // ex Cron::Cron, Cron::start
+    // Create all workers first; they must not change anymore once threads are running
+    for (size_t i = 0, n = runners.size(); i < n; ++i) {
+        m_workers.pushBackNew(new Worker(*this, *runners[i], i));
+    }
+
+    m_root.setCron(this);
+    for (size_t i = 0, n = m_workers.size(); i < n; ++i) {
+        m_workerThreads.pushBackNew(new afl::sys::Thread("host.worker", *m_workers[i]))->start();
+    }
+    m_thread.start();
 }
 
 // Scheduler main entry point.
@@ -382,45 +489,26 @@ server::host::CronImpl::schedulerMain()
         // Process incoming requests
         processRequests();
 
-        // Move due items to the m_dueEvents list
+        // Move due items to the m_dueEvents list, where workers will pick them up
         moveDueItems();
 
         // Figure out what to do
-        enum { Nothing, Run, Wait } what = Nothing;
+        bool haveEvent = false;
         Event_t item(0, HostCron::NoAction, 0);
         {
             afl::sys::MutexGuard g(m_mutex);
-            if (!m_dueEvents.empty()) {
-                item = m_dueEvents.front();
-                what = Run;
-            } else if (!m_futureEvents.empty()) {
+            if (!m_futureEvents.empty()) {
                 item = m_futureEvents.front();
-                what = Wait;
+                haveEvent = true;
             }
         }
 
-        // Process it
-        if (what == Wait) {
+        if (haveEvent) {
             // Wait for scheduled event
             int64_t ms = (m_root.getSystemTimeFromTime(item.time) - afl::sys::Time::getCurrentTime()).getMilliseconds();
             if (ms > 0) {
                 m_wake.wait(1 + afl::sys::Timeout_t(std::min(ms, int64_t(0x10000000))));
             }
-        } else if (what == Run) {
-            // Execute item
-            std::list<Event_t> newSchedule;
-            runDueItem(item.gameId, newSchedule);
-
-            {
-                // Update schedules
-                afl::sys::MutexGuard g1(m_root.mutex());
-                afl::sys::MutexGuard g2(m_mutex);
-                m_dueEvents.remove_if(IsGame(item.gameId));
-                m_futureEvents.merge(newSchedule, ByTime());
-
-                // Unlock the game
-                m_root.arbiter().unlock(item.gameId, GameArbiter::Host);
-            }
         } else {
             // Nothing to do, wait for request
             m_wake.wait();
@@ -428,6 +516,26 @@ server::host::CronImpl::schedulerMain()
     }
 }
 
+// Worker main entry point.
+void
+server::host::CronImpl::workerMain(Worker& w)
+{
+    Event_t item;
+    while (takeDueItem(item)) {
+        // Execute item
+        std::list<Event_t> newSchedule;
+        try {
+            runDueItem(w, item.gameId, newSchedule);
+        }
+        catch (std::exception& e) {
+            // Error accessing the environment. Game drops out of the schedule until next change.
+            m_root.log().write(afl::sys::LogListener::Error, "host.except", afl::string::Format("Exception in Scheduler, game %d", item.gameId), e);
+            newSchedule.clear();
+        }
+        finishDueItem(item.gameId, newSchedule);
+    }
+}
+
 // Check for stop request.
 bool
 server::host::CronImpl::isStopRequested()
@@ -436,6 +544,59 @@ server::host::CronImpl::isStopRequested()
     return m_stopFlag;
 }
 
+// Take a due item for execution.
+// Waits until an item is available; marks the item's game running.
+// \param item [out] Item
+// \return true if item returned, false if stop requested
+bool
+server::host::CronImpl::takeDueItem(Event_t& item)
+{
+    while (1) {
+        {
+            afl::sys::MutexGuard g(m_mutex);
+            if (m_stopFlag) {
+                return false;
+            }
+            for (std::list<Event_t>::const_iterator p = m_dueEvents.begin(); p != m_dueEvents.end(); ++p) {
+                if (m_runningGames.insert(p->gameId).second) {
+                    item = *p;
+                    return true;
+                }
+            }
+        }
+        m_workAvailable.wait();
+    }
+}
+
+// Finish a due item.
+// Takes the game out of the due list, schedules its next event, replays change notifications received meanwhile, and unlocks it.
+// \param gameId      [in]     Game
+// \param newSchedule [in/out] New schedule for next event; will be consumed
+void
+server::host::CronImpl::finishDueItem(int32_t gameId, std::list<Event_t>& newSchedule)
+{
+    {
+        // Update schedules
+        afl::sys::MutexGuard g1(m_root.mutex());
+        afl::sys::MutexGuard g2(m_mutex);
+        m_dueEvents.remove_if(IsGame(gameId));
+        m_futureEvents.merge(newSchedule, ByTime());
+        m_runningGames.erase(gameId);
+        m_dueTicks.erase(gameId);
+
+        // Replay change notifications received during the run
+        if (m_deferredGames.erase(gameId) != 0) {
+            m_changedGames.push_back(gameId);
+        }
+
+        // Unlock the game
+        m_root.arbiter().unlock(gameId, GameArbiter::Host);
+    }
+
+    // Scheduler needs to reconsider its wait time
+    m_wake.post();
+}
+
 // Log an action.
 // \param what What we'll do with this action
 // \param item The action
@@ -443,16 +604,7 @@ void
 server::host::CronImpl::logAction(const char* what, const Event_t& item)
 {
     // ex planetscentral/host/cron.cc:logAction
-    const char* action = 0;
-    switch (item.action) {
-     case HostCron::HostAction:           action = "host";           break;
-     case HostCron::MasterAction:         action = "master";         break;
-     case HostCron::ScheduleChangeAction: action = "schedulechange"; break;
-     case HostCron::NoAction:             action = "none";           break;
-     case HostCron::UnknownAction:        action = "UNKNOWN";        break;
-    }
-
-    if (action != 0) {
+    if (const char* action = getActionName(item.action)) {
         const afl::sys::Time t = m_root.getSystemTimeFromTime(item.time);
         m_root.log().write(afl::sys::LogListener::Info, LOG_NAME,
                            afl::string::Format("game %d: %s: %s, t=%d [%s, %s]")
@@ -519,8 +671,8 @@ server::host::CronImpl::processRequests()
 {
     // ex Cron::processRequests
     while (1) {
-        // Get next item to consider. Ignore items that are on the overdue list.
-        // (Those will be rescheduled anyway when they get off the overdue list.)
+        // Get next item to consider. Defer items that are on the overdue list;
+        // a worker may be hosting them right now. finishDueItem() will replay the notification.
         int32_t gameId;
         while (1) {
             afl::sys::MutexGuard g(m_mutex);
@@ -533,6 +685,7 @@ server::host::CronImpl::processRequests()
                 // It's not overdue, so process it
                 break;
             }
+            m_deferredGames.insert(gameId);
             m_changedGames.pop_front();
         }
 
@@ -577,15 +730,18 @@ server::host::CronImpl::moveDueItems()
         // FIXME: should we have to deal with lockGame() failing?
         // This would be an internal error.
         m_root.arbiter().lock(m_futureEvents.front().gameId, GameArbiter::Host);
+        m_dueTicks[m_futureEvents.front().gameId] = afl::sys::Time::getTickCounter();
         m_dueEvents.splice(m_dueEvents.end(), m_futureEvents, m_futureEvents.begin());
+        m_workAvailable.post();
     }
 }
 
 // Run due item.
+// \param w           [in]  Worker executing the item
 // \param gameId      [in]  Game to work on
 // \param newSchedule [out] New schedule for next event will be produced here
 void
-server::host::CronImpl::runDueItem(const int32_t gameId, std::list<Event_t>& newSchedule)
+server::host::CronImpl::runDueItem(Worker& w, const int32_t gameId, std::list<Event_t>& newSchedule)
 {
     // ex Cron::runDueItem
     // Check that schedule is still current (it should be because the game is locked).
@@ -617,21 +773,42 @@ server::host::CronImpl::runDueItem(const int32_t gameId, std::list<Event_t>& new
     }
 
     // Action should be performed
+    const HostCron::Action action = newSchedule.front().action;
+    const uint32_t startTicks = afl::sys::Time::getTickCounter();
+    uint32_t dueTicks;
+    {
+        afl::sys::MutexGuard g(m_mutex);
+        std::map<int32_t, uint32_t>::const_iterator it = m_dueTicks.find(gameId);
+        dueTicks = (it != m_dueTicks.end() ? it->second : startTicks);
+    }
+
+    bool ok = true;
     try {
-        Event_t& item = newSchedule.front();
         logAction("executing", newSchedule.front());
-        if (item.action == HostCron::HostAction) {
-            runHost(m_runner, m_root, gameId);
-        } else if (item.action == HostCron::MasterAction) {
-            runMaster(m_runner, m_root, gameId);
+        if (action == HostCron::HostAction) {
+            runHost(w.runner(), m_root, gameId, w.getWorkDirectoryName());
+        } else if (action == HostCron::MasterAction) {
+            runMaster(w.runner(), m_root, gameId, w.getWorkDirectoryName());
         }
     }
     catch (std::exception& e) {
+        ok = false;
         m_root.log().write(afl::sys::LogListener::Warn, LOG_NAME, "Exception", e);
         m_root.log().write(afl::sys::LogListener::Warn, LOG_NAME, afl::string::Format("Game %d is now broken", gameId));
+        afl::sys::MutexGuard g(m_root.mutex());
         Game(m_root, gameId, Game::NoExistanceCheck).markBroken(e.what(), m_root);
     }
 
+    // Timing
+    m_root.log().write(afl::sys::LogListener::Info, LOG_NAME,
+                       afl::string::Format("game %d: %s %s, %d ms (waited %d ms, worker %d)")
+                       << gameId
+                       << getActionName(action)
+                       << (ok ? "completed" : "failed")
+                       << (afl::sys::Time::getTickCounter() - startTicks)
+                       << (startTicks - dueTicks)
+                       << w.getIndex());
+
     // Schedule next event
     newSchedule.clear();
     {
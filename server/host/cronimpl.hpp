@@ -6,8 +6,12 @@
 #define C2NG_SERVER_HOST_CRONIMPL_HPP
 
 #include <list>
+#include <map>
+#include <set>
+#include <vector>
 #include "afl/base/stoppable.hpp"
 #include "afl/base/uncopyable.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/sys/mutex.hpp"
 #include "afl/sys/semaphore.hpp"
 #include "afl/sys/thread.hpp"
@@ -34,7 +38,13 @@ namespace server { namespace host {
         An important property of CronImpl is that it exports the game (under exclusive access),
         runs host, and then re-imports the game (under exclusive access).
         During the host run, the game is locked using GameArbiter (e.g. preventing modifications),
-        but otherwise, the database can be accessed by other users. */
+        but otherwise, the database can be accessed by other users.
+
+        Due events are executed by a pool of workers, each with its own ProcessRunner and work directory.
+        The scheduler thread only maintains the queues; workers take events from m_dueEvents.
+        A game is executed by at most one worker at a time (m_runningGames);
+        because a game has at most one event, and it stays in m_dueEvents until its run completes,
+        this mostly happens naturally. */
     class CronImpl : public Cron,
                      private afl::base::Uncopyable,
                      private afl::base::Stoppable
@@ -46,6 +56,12 @@ namespace server { namespace host {
             \param runner Runner to use. Should be distinct from Root's runner. */
         CronImpl(Root& root, util::ProcessRunner& runner);
 
+        /** Constructor for parallel operation.
+            This will start a separate thread to process scheduler events, and one worker thread per runner.
+            \param root    Service root
+            \param runners Runners to use, one per worker; at least one. Should be distinct from Root's runner. */
+        CronImpl(Root& root, const std::vector<util::ProcessRunner*>& runners);
+
         /** Destructor.
             This will stop the separate thread. */
         ~CronImpl();
@@ -57,14 +73,19 @@ namespace server { namespace host {
         virtual void suspendScheduler(Time_t absTime);
 
      private:
+        class Worker;
+        friend class Worker;
+
         Root& m_root;
-        util::ProcessRunner& m_runner;
         afl::sys::Thread m_thread;
+        afl::container::PtrVector<Worker> m_workers;
+        afl::container::PtrVector<afl::sys::Thread> m_workerThreads;
 
         // FIXME: we can probably get rid of this mutex and rely on Root's, to avoid nested-mutex trouble.
         // FIXME: must review the general mutex/reconnect behaviour!!!!
         afl::sys::Mutex m_mutex;       // ex mutex
         afl::sys::Semaphore m_wake;    // ex new_command_sem
+        afl::sys::Semaphore m_workAvailable;
         bool m_stopFlag;               // protected by mutex
 
         std::list<int32_t> m_changedGames;  // protected by mutex
@@ -74,19 +95,26 @@ namespace server { namespace host {
         // Note: Event_t is ex ScheduleItem
         std::list<Event_t> m_futureEvents;       ///< Future actions.
         std::list<Event_t> m_dueEvents;          ///< Due actions. Games in this list are locked if they are MasterAction or HostAction.
+        std::set<int32_t> m_runningGames;        ///< Games from m_dueEvents currently being executed by a worker.
+        std::set<int32_t> m_deferredGames;       ///< Games from m_dueEvents that were changed while due; re-added to m_changedGames when finished.
+        std::map<int32_t, uint32_t> m_dueTicks;  ///< Tick counter at which a game became due, for statistics.
 
         virtual void run();
         virtual void stop();
 
+        void init(const std::vector<util::ProcessRunner*>& runners);
         void schedulerMain();
+        void workerMain(Worker& w);
         bool isStopRequested();
+        bool takeDueItem(Event_t& item);
+        void finishDueItem(int32_t gameId, std::list<Event_t>& newSchedule);
 
         // Utilities
         void logAction(const char* what, const Event_t& item);
         void generateInitialSchedule();
         void processRequests();
         void moveDueItems();
-        void runDueItem(int32_t gameId, std::list<Event_t>& newSchedule);
+        void runDueItem(Worker& w, int32_t gameId, std::list<Event_t>& newSchedule);
         void adjustForSuspension(std::list<Event_t>& newSchedule);
     };
 
@@ -337,9 +337,6 @@ namespace {
             game.listPlayers(slot, players);
         }
 
-        // Fetch actual game directory in HostFile
-        String_t hostFileDir = game.getDirectory();
-
         // When we're here, there is no turn, but we may have some players
         for (size_t i = 0; i < players.size(); ++i) {
             afl::sys::MutexGuard g(root.mutex());
@@ -616,13 +613,13 @@ namespace {
 
 // Run host on a game.
 void
-server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
+server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId, const String_t& workDirName)
 {
     // ex planetscentral/host/exec.h:runHost
 
     // Build base directory
     afl::base::Ref<afl::io::DirectoryEntry> workdirEntry =
-        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName("host");
+        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName(workDirName);
     try {
         workdirEntry->createAsDirectory();
     }
@@ -646,7 +643,10 @@ server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
     for (int32_t i = 1; i <= Game::NUM_PLAYERS; ++i) {
         importMissingTurns(runner, root, *workdir, gameDir, gameId, i);
     }
-    BaseClient(root.hostFile()).setUserContext(String_t());
+    {
+        afl::sys::MutexGuard g(root.mutex());
+        BaseClient(root.hostFile()).setUserContext(String_t());
+    }
 
     // Run host
     doRunHost(runner, root, workdirEntry->getPathName(), gameDir, gameId, turnNr+1);
@@ -668,12 +668,12 @@ server::host::runHost(util::ProcessRunner& runner, Root& root, int32_t gameId)
 
 // Run master on a game.
 void
-server::host::runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId)
+server::host::runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId, const String_t& workDirName)
 {
     // ex planetscentral/host/exec.h:runMaster
     // Build base directory
     afl::base::Ref<afl::io::DirectoryEntry> workdirEntry =
-        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName("host");
+        root.fileSystem().openDirectory(root.config().workDirectory)->getDirectoryEntryByName(workDirName);
     try {
         workdirEntry->createAsDirectory();
     }
@@ -5,6 +5,7 @@
 #ifndef C2NG_SERVER_HOST_EXEC_HPP
 #define C2NG_SERVER_HOST_EXEC_HPP
 
+#include "afl/string/string.hpp"
 #include "util/processrunner.hpp"
 
 namespace server { namespace host {
@@ -21,10 +22,11 @@ namespace server { namespace host {
         - run host
         - import game data
 
-        \param runner ProcessRunner
-        \param root   Service root
-        \param gameId Game to run host for */
-    void runHost(util::ProcessRunner& runner, Root& root, int32_t gameId);
+        \param runner      ProcessRunner
+        \param root        Service root
+        \param gameId      Game to run host for
+        \param workDirName Name of work directory (within Configuration::workDirectory); concurrent runs need distinct directories */
+    void runHost(util::ProcessRunner& runner, Root& root, int32_t gameId, const String_t& workDirName);
 
     /** Run master on a game.
         The game must not have been mastered/hosted yet
@@ -36,10 +38,11 @@ namespace server { namespace host {
         - run host
         - import game data
 
-        \param runner ProcessRunner
-        \param root   Service root
-        \param gameId Game to run master for */
-    void runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId);
+        \param runner      ProcessRunner
+        \param root        Service root
+        \param gameId      Game to run master for
+        \param workDirName Name of work directory (within Configuration::workDirectory); concurrent runs need distinct directories */
+    void runMaster(util::ProcessRunner& runner, Root& root, int32_t gameId, const String_t& workDirName);
 
     /** Reset game to turn.
         The game must be running and in a turn after turnNr.
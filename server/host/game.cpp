@@ -3,6 +3,7 @@
   *  \brief Class server::host::Game
   */
 
+#include <algorithm>
 #include <stdexcept>
 #include "server/host/game.hpp"
 #include "afl/bits/int32le.hpp"
@@ -15,6 +16,7 @@
 #include "afl/string/parse.hpp"
 #include "server/errors.hpp"
 #include "server/host/cron.hpp"
+#include "server/host/gameprefetch.hpp"
 #include "server/host/gamerating.hpp"
 #include "server/host/installer.hpp"
 #include "server/host/root.hpp"
@@ -62,6 +64,62 @@ namespace {
             out = in;
         }
     }
+
+    /* Access user ranks, from User or from a GamePrefetch (for the requesting user) */
+    int32_t getRankLevel(server::host::User& u)
+    {
+        return u.rankLevel().get();
+    }
+    int32_t getRankLevel(server::host::GamePrefetch& prefetch)
+    {
+        return prefetch.getUserRankLevel();
+    }
+    int32_t getRankPoints(server::host::User& u)
+    {
+        return u.rankPoints().get();
+    }
+    int32_t getRankPoints(server::host::GamePrefetch& prefetch)
+    {
+        return prefetch.getUserRankPoints();
+    }
+
+    template<typename UserSource>
+    bool checkJoinRestriction(const afl::base::Optional<int32_t>& minLevel,
+                              const afl::base::Optional<int32_t>& maxLevel,
+                              const afl::base::Optional<int32_t>& minPoints,
+                              const afl::base::Optional<int32_t>& maxPoints,
+                              UserSource& u)
+    {
+        // Check minimum level
+        if (const int32_t* p = minLevel.get()) {
+            if (getRankLevel(u) < *p) {
+                return false;
+            }
+        }
+
+        // Check maximum level
+        if (const int32_t* p = maxLevel.get()) {
+            if (getRankLevel(u) > *p) {
+                return false;
+            }
+        }
+
+        // Check minimum skill
+        if (const int32_t* p = minPoints.get()) {
+            if (getRankPoints(u) < *p) {
+                return false;
+            }
+        }
+
+        // Check maximum skill
+        if (const int32_t* p = maxPoints.get()) {
+            if (getRankPoints(u) > *p) {
+                return false;
+            }
+        }
+
+        return true;
+    }
 }
 
 
@@ -230,6 +288,17 @@ server::host::Game::getState()
     return result;
 }
 
+// Get game state, using prefetched data.
+server::host::Game::State_t
+server::host::Game::getState(GamePrefetch& prefetch)
+{
+    State_t result;
+    if (!HostGame::parseState(prefetch.getKey(m_gameId, "state"), result)) {
+        throw std::runtime_error(DATABASE_ERROR);
+    }
+    return result;
+}
+
 // Set game state.
 void
 server::host::Game::setState(State_t newState, TalkListener* talk, Root& root)
@@ -301,6 +370,17 @@ server::host::Game::getType()
     return result;
 }
 
+// Get game type, using prefetched data.
+server::host::Game::Type_t
+server::host::Game::getType(GamePrefetch& prefetch)
+{
+    Type_t result;
+    if (!HostGame::parseType(prefetch.getKey(m_gameId, "type"), result)) {
+        throw std::runtime_error(DATABASE_ERROR);
+    }
+    return result;
+}
+
 // Set game type.
 void
 server::host::Game::setType(Type_t newType, TalkListener* talk, Root& root)
@@ -539,6 +619,7 @@ server::host::Game::pushPlayerSlot(int32_t slot, String_t player, Root& root)
     // ex Game::pushPlayerSlot
     // Add to database
     getSlot(slot).players().pushBack(player);
+    m_game.hashKey("cache").field(afl::string::Format("players:%d", slot)).remove();
     ++userReferenceCounters().intField(player);
     ++User(root, player).gameReferenceCount(m_gameId);
 
@@ -566,6 +647,7 @@ server::host::Game::popPlayerSlot(int32_t slot, Root& root)
 {
     // ex Game::popPlayerSlot
     String_t player = getSlot(slot).players().popBack();
+    m_game.hashKey("cache").field(afl::string::Format("players:%d", slot)).remove();
     if (!player.empty()) {
         // Remove
         --userReferenceCounters().intField(player);
@@ -643,6 +725,13 @@ server::host::Game::clearCache()
     m_game.hashKey("cache").remove();
 }
 
+// Clear cached schedule.
+void
+server::host::Game::clearScheduleCache()
+{
+    m_game.hashKey("cache").field("schedule").remove();
+}
+
 // Get difficulty.
 int32_t
 server::host::Game::getDifficulty(Root& root)
@@ -790,41 +879,11 @@ server::host::Game::isMultiJoinAllowed()
 bool
 server::host::Game::isJoinRestrictionSatisfied(User& u)
 {
-    afl::base::Optional<int32_t> level;
-
-    // Check minimum level
-    level = minRankLevelToJoin().getOptional();
-    if (int32_t* p = level.get()) {
-        if (u.rankLevel().get() < *p) {
-            return false;
-        }
-    }
-
-    // Check maximum level
-    level = maxRankLevelToJoin().getOptional();
-    if (int32_t* p = level.get()) {
-        if (u.rankLevel().get() > *p) {
-            return false;
-        }
-    }
-
-    // Check minimum skill
-    level = minRankPointsToJoin().getOptional();
-    if (int32_t* p = level.get()) {
-        if (u.rankPoints().get() < *p) {
-            return false;
-        }
-    }
-
-    // Check maximum skill
-    level = maxRankPointsToJoin().getOptional();
-    if (int32_t* p = level.get()) {
-        if (u.rankPoints().get() > *p) {
-            return false;
-        }
-    }
-
-    return true;
+    return checkJoinRestriction(minRankLevelToJoin().getOptional(),
+                                maxRankLevelToJoin().getOptional(),
+                                minRankPointsToJoin().getOptional(),
+                                maxRankPointsToJoin().getOptional(),
+                                u);
 }
 
 // Describe this game.
@@ -832,6 +891,14 @@ server::interface::HostGame::Info
 server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser, Root& root)
 {
     // ex Game::describe
+    GamePrefetch prefetch(root, verbose, forUser, otherUser);
+    return describe(prefetch, root);
+}
+
+// Describe this game, using prefetched data.
+server::interface::HostGame::Info
+server::host::Game::describe(GamePrefetch& prefetch, Root& root)
+{
     /* @type HostGameInfo
        Information about a game.
        Game information can be provided in a "normal" and "verbose" format.
@@ -871,8 +938,13 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
        @key otherRank:Int                (rank of player X in GAMELIST ... USER X) */
     HostGame::Info result;
 
-    int32_t turnNr = turnNumber().get();
-    const HostGame::State state = getState();
+    const bool verbose = prefetch.isVerbose();
+    const String_t& forUser = prefetch.getForUser();
+    const String_t& otherUser = prefetch.getOtherUser();
+
+    int32_t turnNr = prefetch.getInteger(m_gameId, "settings", "turn");
+    HostGame::State state = getState(prefetch);
+    HostGame::Type type = getType(prefetch);
 
     // Id
     result.gameId = m_gameId;
@@ -881,51 +953,61 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
     result.state = state;
 
     // Type
-    result.type = getType();
+    result.type = type;
 
     // Name
-    result.name = getName();
+    result.name = prefetch.getKey(m_gameId, "name");
 
     // Description
     if (verbose) {
-        result.description = settings().stringField("description").get();
+        result.description = prefetch.getString(m_gameId, "settings", "description");
     }
 
     // Difficulty
-    result.difficulty = getDifficulty(root);
+    afl::base::Optional<int32_t> difficulty = prefetch.getOptionalInteger(m_gameId, "cache", "difficulty");
+    if (const int32_t* p = difficulty.get()) {
+        result.difficulty = *p;
+    } else {
+        result.difficulty = getDifficulty(root);
+    }
 
     // Schedule
-    afl::net::redis::Subtree schedule = m_game.subtree("schedule");
-    String_t currentSchedule = schedule.stringListKey("list")[0];
-    if (!currentSchedule.empty()) {
-        Schedule sch;
-        sch.loadFrom(schedule.hashKey(currentSchedule));
+    Schedule sch;
+    if (getCachedSchedule(prefetch, sch)) {
         result.currentSchedule = sch.describe(root.config());
     }
 
+    // Join limits
+    if (verbose) {
+        result.minRankLevelToJoin = prefetch.getOptionalInteger(m_gameId, "settings", "minRankLevelToJoin");
+        result.maxRankLevelToJoin = prefetch.getOptionalInteger(m_gameId, "settings", "maxRankLevelToJoin");
+        result.minRankPointsToJoin = prefetch.getOptionalInteger(m_gameId, "settings", "minRankPointsToJoin");
+        result.maxRankPointsToJoin = prefetch.getOptionalInteger(m_gameId, "settings", "maxRankPointsToJoin");
+    }
+
     // Slot states
     if (verbose) {
         std::vector<HostGame::SlotState> slotStates;
         std::vector<int32_t> turnStates;
         bool onGameAsPrimary = false;
         for (int i = 1; i <= NUM_PLAYERS; ++i) {
-            Slot slot(getSlot(i));
+            const String_t slotKey = afl::string::Format("player:%d:status", i);
             int turnState;
-            if (slot.slotStatus().get() != 0) {
+            if (prefetch.getInteger(m_gameId, slotKey, "slot") != 0) {
                 afl::data::StringList_t players;
-                slot.players().getAll(players);
+                getCachedPlayers(prefetch, i, players);
                 if (players.size() == 0) {
                     slotStates.push_back(HostGame::OpenSlot);
                     turnState = 0;
                 } else if (std::find(players.begin(), players.end(), forUser) != players.end()) {
                     slotStates.push_back(HostGame::SelfSlot);
-                    turnState = slot.turnStatus().get();
+                    turnState = prefetch.getInteger(m_gameId, slotKey, "turn");
                     if (players[0] == forUser) {
                         onGameAsPrimary = true;
                     }
                 } else {
                     slotStates.push_back(HostGame::OccupiedSlot);
-                    turnState = slot.turnStatus().get();
+                    turnState = prefetch.getInteger(m_gameId, slotKey, "turn");
                     if (!forUser.empty()) {
                         bool isTemporary = (turnState & TurnIsTemporary) != 0;
                         turnState &= TurnStateMask;
@@ -950,10 +1032,11 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
 
         result.slotStates = slotStates;
         result.turnStates = turnStates;
-        result.joinable = (!onGameAsPrimary || isMultiJoinAllowed());
+        result.joinable = (!onGameAsPrimary
+                           || prefetch.getInteger(m_gameId, "settings", "joinMulti") != 0
+                           || type == HostGame::TestGame);
         if (!forUser.empty()) {
-            User u(root, forUser);
-            if (!isJoinRestrictionSatisfied(u)) {
+            if (!checkJoinRestriction(result.minRankLevelToJoin, result.maxRankLevelToJoin, result.minRankPointsToJoin, result.maxRankPointsToJoin, prefetch)) {
                 result.joinable = false;
             }
         }
@@ -961,12 +1044,12 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
 
     // Play status
     if (!forUser.empty()) {
-        result.userPlays = userReferenceCounters().intField(forUser).get() > 0;
+        result.userPlays = prefetch.getInteger(m_gameId, "users", forUser) > 0;
     }
 
     // Scores
     if (verbose && (state == HostGame::Running || state == HostGame::Finished)) {
-        String_t scoredesc = m_game.hashKey("scores").stringField("score").get();
+        String_t scoredesc = prefetch.getString(m_gameId, "scores", "score");
         String_t scorename;
         if (scoredesc.empty()) {
             scoredesc = "Classic Score";
@@ -974,7 +1057,7 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
         } else {
             scorename = "score";
         }
-        String_t scores = m_game.subtree("turn").subtree(turnNr).hashKey("scores").stringField(scorename).get();
+        String_t scores = getCachedScores(prefetch, turnNr, scorename);
         if (scores.size() == 4*NUM_PLAYERS) {
             std::vector<int32_t> packedScores(NUM_PLAYERS);
             afl::bits::unpackArray<afl::bits::Int32LE>(packedScores, afl::string::toBytes(scores));
@@ -984,41 +1067,33 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
         }
     }
 
-    // Join limits
-    if (verbose) {
-        result.minRankLevelToJoin = minRankLevelToJoin().getOptional();
-        result.maxRankLevelToJoin = maxRankLevelToJoin().getOptional();
-        result.minRankPointsToJoin = minRankPointsToJoin().getOptional();
-        result.maxRankPointsToJoin = maxRankPointsToJoin().getOptional();
-    }
-
     // Host
-    String_t host = settings().stringField("host").get();
+    String_t host = prefetch.getString(m_gameId, "settings", "host");
     result.hostName = host;
-    result.hostDescription = root.hostRoot().byName(host).stringField("description").get();
-    result.hostKind = root.hostRoot().byName(host).stringField("kind").get();
+    result.hostDescription = prefetch.getToolField(GamePrefetch::HostTool, host, "description");
+    result.hostKind = prefetch.getToolField(GamePrefetch::HostTool, host, "kind");
 
     // Ship list
-    String_t shipList = settings().stringField("shiplist").get();
+    String_t shipList = prefetch.getString(m_gameId, "settings", "shiplist");
     result.shipListName = shipList;
-    result.shipListDescription = root.shipListRoot().byName(shipList).stringField("description").get();
-    result.shipListKind = root.shipListRoot().byName(shipList).stringField("kind").get();
+    result.shipListDescription = prefetch.getToolField(GamePrefetch::ShipListTool, shipList, "description");
+    result.shipListKind = prefetch.getToolField(GamePrefetch::ShipListTool, shipList, "kind");
 
     // Master
     if (verbose) {
-        String_t master = settings().stringField("master").get();
+        String_t master = prefetch.getString(m_gameId, "settings", "master");
         result.masterName = master;
-        result.masterDescription = root.masterRoot().byName(master).stringField("description").get();
-        result.masterKind = root.masterRoot().byName(master).stringField("kind").get();
+        result.masterDescription = prefetch.getToolField(GamePrefetch::MasterTool, master, "description");
+        result.masterKind = prefetch.getToolField(GamePrefetch::MasterTool, master, "kind");
     }
 
     // Turn
     result.turnNumber = turnNr;
 
     // Host times
-    result.lastHostTime = root.config().getUserTimeFromTime(lastHostTime().get());
+    result.lastHostTime = root.config().getUserTimeFromTime(prefetch.getInteger(m_gameId, "settings", "lastHostTime"));
 
-    String_t nextHostTimeStr = getConfig("nextHostTime");
+    String_t nextHostTimeStr = prefetch.getString(m_gameId, "settings", "nextHostTime");
     int32_t nextHostTime;
     if (!nextHostTimeStr.empty() && afl::string::strToInteger(nextHostTimeStr, nextHostTime)) {
         result.nextHostTime = root.config().getUserTimeFromTime(nextHostTime);
@@ -1026,21 +1101,23 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
 
     // Forum
     if (verbose) {
-        result.forumId = forumId().get();
+        result.forumId = prefetch.getInteger(m_gameId, "settings", "forum");
     }
 
     // Ranks
     if (state == HostGame::Finished && (!forUser.empty() || !otherUser.empty())) {
         for (int i = 1; i <= NUM_PLAYERS; ++i) {
-            Slot s = getSlot(i);
-            if (s.slotStatus().get() != 0) {
-                const String_t slotUser = s.players()[0];
+            const String_t slotKey = afl::string::Format("player:%d:status", i);
+            if (prefetch.getInteger(m_gameId, slotKey, "slot") != 0) {
+                afl::data::StringList_t players;
+                getCachedPlayers(prefetch, i, players);
+                const String_t slotUser = players.empty() ? String_t() : players[0];
                 if (!slotUser.empty()) {
                     if (slotUser == forUser) {
-                        setRank(result.userRank, s.rank().get());
+                        setRank(result.userRank, prefetch.getInteger(m_gameId, slotKey, "rank"));
                     }
                     if (slotUser == otherUser) {
-                        setRank(result.otherRank, s.rank().get());
+                        setRank(result.otherRank, prefetch.getInteger(m_gameId, slotKey, "rank"));
                     }
                 }
             }
@@ -1050,6 +1127,81 @@ server::host::Game::describe(bool verbose, String_t forUser, String_t otherUser,
     return result;
 }
 
+/* Get players of a slot, using the game cache.
+   Player lists are cached as a comma-separated list; the cache is cleared by pushPlayerSlot(), popPlayerSlot(). */
+void
+server::host::Game::getCachedPlayers(GamePrefetch& prefetch, int32_t slot, afl::data::StringList_t& players)
+{
+    const String_t field = afl::string::Format("players:%d", slot);
+    if (const String_t* p = prefetch.getOptionalString(m_gameId, "cache", field).get()) {
+        size_t pos = 0;
+        while (pos < p->size()) {
+            size_t end = std::min(p->find(',', pos), p->size());
+            players.push_back(p->substr(pos, end - pos));
+            pos = end + 1;
+        }
+    } else {
+        getSlot(slot).players().getAll(players);
+
+        String_t value;
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (players[i].empty() || players[i].find(',') != String_t::npos) {
+                // Cannot be represented; do not cache
+                return;
+            }
+            if (i != 0) {
+                value += ',';
+            }
+            value += players[i];
+        }
+        m_game.hashKey("cache").stringField(field).set(value);
+    }
+}
+
+/* Get current schedule, using the game cache.
+   The schedule is cached in packed form, or as an empty string if there is none; the cache is cleared by clearScheduleCache().
+   Returns true if there is a schedule. */
+bool
+server::host::Game::getCachedSchedule(GamePrefetch& prefetch, Schedule& sch)
+{
+    if (const String_t* p = prefetch.getOptionalString(m_gameId, "cache", "schedule").get()) {
+        if (p->empty()) {
+            return false;
+        }
+        if (sch.unpack(*p)) {
+            return true;
+        }
+    }
+
+    afl::net::redis::Subtree schedule = getSchedule();
+    String_t currentSchedule = schedule.stringListKey("list")[0];
+    bool result = !currentSchedule.empty();
+    if (result) {
+        sch.loadFrom(schedule.hashKey(currentSchedule));
+    }
+    m_game.hashKey("cache").stringField("schedule").set(result ? sch.pack() : String_t());
+    return result;
+}
+
+/* Get scores of a turn, using the game cache.
+   Scores are cached as "turn,data"; the cache is cleared when a turn is hosted or imported (clearCache()).
+   The turn number guards against a stale cache entry created while a turn is being imported. */
+String_t
+server::host::Game::getCachedScores(GamePrefetch& prefetch, int32_t turnNr, const String_t& scoreName)
+{
+    const String_t field = "scores:" + scoreName;
+    const String_t prefix = afl::string::Format("%d,", turnNr);
+    if (const String_t* p = prefetch.getOptionalString(m_gameId, "cache", field).get()) {
+        if (p->compare(0, prefix.size(), prefix) == 0) {
+            return p->substr(prefix.size());
+        }
+    }
+
+    String_t result = m_game.subtree("turn").subtree(turnNr).hashKey("scores").stringField(scoreName).get();
+    m_game.hashKey("cache").stringField(field).set(prefix + result);
+    return result;
+}
+
 // Describe a slot.
 server::interface::HostPlayer::Info
 server::host::Game::describeSlot(int32_t slot, String_t forUser, Root& root, const server::common::RaceNames& raceNames)
@@ -1183,6 +1335,37 @@ server::host::Game::hasPermission(String_t user, PermissionLevel level)
     // - game:config   --> owner
 }
 
+// Check permissions, using prefetched data.
+bool
+server::host::Game::hasPermission(GamePrefetch& prefetch, String_t user, PermissionLevel level)
+{
+    // Same as hasPermission(String_t, PermissionLevel)
+    if (user.empty()) {
+        return true;
+    }
+
+    switch (level) {
+     case ReadPermission:
+        {
+            HostGame::State state = getState(prefetch);
+            if (state != HostGame::Joining && state != HostGame::Running && state != HostGame::Finished) {
+                return prefetch.getKey(m_gameId, "owner") == user;
+            }
+
+            Type_t type = getType(prefetch);
+            return type == HostGame::UnlistedGame
+                || type == HostGame::PublicGame
+                || prefetch.getKey(m_gameId, "owner") == user
+                || prefetch.getOptionalString(m_gameId, "users", user).isValid();
+        }
+
+     case ConfigPermission:
+     case AdminPermission:
+        return prefetch.getKey(m_gameId, "owner") == user;
+    }
+    return false;
+}
+
 // Load race names.
 void
 server::host::Game::loadRaceNames(server::common::RaceNames& raceNames, Root& root)
@@ -17,6 +17,8 @@
 
 namespace server { namespace host {
 
+    class GamePrefetch;
+    class Schedule;
     class TalkListener;
     class Root;
     class User;
@@ -190,6 +192,12 @@ namespace server { namespace host {
             \throw std::exception if database value cannot be interpreted */
         State_t getState();
 
+        /** Get game state, using prefetched data.
+            \param prefetch Prefetched data
+            \return state
+            \throw std::exception if database value cannot be interpreted */
+        State_t getState(GamePrefetch& prefetch);
+
         /** Set game state.
             Updates all respective lists.
             \param newState New state
@@ -202,6 +210,12 @@ namespace server { namespace host {
             \throw std::exception if database value cannot be interpreted */
         Type_t getType();
 
+        /** Get game type, using prefetched data.
+            \param prefetch Prefetched data
+            \return type
+            \throw std::exception if database value cannot be interpreted */
+        Type_t getType(GamePrefetch& prefetch);
+
         /** Set game type.
             \param newType New type
             \param talk TalkListener to notify
@@ -359,6 +373,10 @@ namespace server { namespace host {
             Removes the cache element of the game object. */
         void clearCache();
 
+        /** Clear cached schedule.
+            Must be called whenever the list of schedules changes. */
+        void clearScheduleCache();
+
         /** Get difficulty.
             If it is not yet known, it is computed and cached.
             \param root Service root
@@ -447,6 +465,14 @@ namespace server { namespace host {
             \return description */
         server::interface::HostGame::Info describe(bool verbose, String_t forUser, String_t otherUser, Root& root);
 
+        /** Describe this game, using prefetched data.
+            Produces the same result as describe(bool,String_t,String_t,Root&),
+            but takes values from the GamePrefetch object where possible.
+            \param prefetch Prefetched data; also provides the verbose, forUser, otherUser parameters
+            \param root Service root
+            \return description */
+        server::interface::HostGame::Info describe(GamePrefetch& prefetch, Root& root);
+
         /** Describe a slot.
             This function creates a user-dependant view (joinability),
             but otherwise assumes the user has read access.
@@ -468,6 +494,15 @@ namespace server { namespace host {
             \return true if permission is granted */
         bool hasPermission(String_t user, PermissionLevel level);
 
+        /** Check permissions, using prefetched data.
+            Produces the same result as hasPermission(String_t,PermissionLevel),
+            but takes values from the GamePrefetch object where possible.
+            \param prefetch Prefetched data
+            \param user User Id to check for (can be empty)
+            \param level Level to check
+            \return true if permission is granted */
+        bool hasPermission(GamePrefetch& prefetch, String_t user, PermissionLevel level);
+
         /** Load race names.
             If the game has been mastered and has its own race.nm file, loads that from the host filer.
             Otherwise, checks files provided by shiplist/master/host/defaults.
@@ -543,6 +578,10 @@ namespace server { namespace host {
      private:
         afl::net::redis::Subtree m_game;
         const int32_t m_gameId;
+
+        void getCachedPlayers(GamePrefetch& prefetch, int32_t slot, afl::data::StringList_t& players);
+        bool getCachedSchedule(GamePrefetch& prefetch, Schedule& sch);
+        String_t getCachedScores(GamePrefetch& prefetch, int32_t turnNr, const String_t& scoreName);
     };
 } }
 
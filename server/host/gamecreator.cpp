@@ -167,6 +167,7 @@ server::host::GameCreator::copyGame(int32_t srcId, int32_t dstId)
 
     // Copy schedule
     copySchedule(src, dst, pickDayTime());
+    Game(m_root, dstId, Game::NoExistanceCheck).clearScheduleCache();
 
     // Copy settings
     afl::net::redis::HashKey srcSet = src.hashKey("settings");
@@ -0,0 +1,261 @@
+/**
+  *  \file server/host/gameprefetch.cpp
+  *  \brief Class server::host::GamePrefetch
+  */
+
+#include "server/host/gameprefetch.hpp"
+#include "afl/data/access.hpp"
+#include "afl/data/segment.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/sortoperation.hpp"
+#include "afl/net/redis/stringlistkey.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/stringkey.hpp"
+#include "afl/net/redis/subtree.hpp"
+#include "afl/string/format.hpp"
+#include "server/host/game.hpp"
+#include "server/host/root.hpp"
+#include "server/host/user.hpp"
+
+server::host::GamePrefetch::GamePrefetch(Root& root, bool verbose, String_t forUser, String_t otherUser)
+    : m_root(root),
+      m_verbose(verbose),
+      m_forUser(forUser),
+      m_otherUser(otherUser),
+      m_items(),
+      m_data(),
+      m_rowByGame(),
+      m_toolCache(),
+      m_userRankLevel(),
+      m_userRankPoints()
+{
+    addItems();
+}
+
+server::host::GamePrefetch::~GamePrefetch()
+{ }
+
+void
+server::host::GamePrefetch::load(afl::net::redis::IntegerSetKey games)
+{
+    afl::net::redis::SortOperation op = games.sort();
+    loadRows(op);
+}
+
+void
+server::host::GamePrefetch::load(const afl::data::IntegerList_t& games)
+{
+    // SORT/GET needs a key, so store the list in a temporary list, using a single RPUSH.
+    // Commands are serialized by Root::mutex(), so a fixed name is sufficient.
+    if (!games.empty()) {
+        afl::net::redis::StringListKey tmp = m_root.gameRoot().stringListKey("prefetch:tmp");
+        afl::data::Segment cmd;
+        cmd.pushBackString("RPUSH");
+        cmd.pushBackString(tmp.getName());
+        for (size_t i = 0, n = games.size(); i < n; ++i) {
+            cmd.pushBackInteger(games[i]);
+        }
+        tmp.getHandler().callVoid(cmd);
+        try {
+            afl::net::redis::SortOperation op = tmp.sort();
+            loadRows(op);
+        }
+        catch (...) {
+            tmp.remove();
+            throw;
+        }
+        tmp.remove();
+    }
+}
+
+bool
+server::host::GamePrefetch::isVerbose() const
+{
+    return m_verbose;
+}
+
+const String_t&
+server::host::GamePrefetch::getForUser() const
+{
+    return m_forUser;
+}
+
+const String_t&
+server::host::GamePrefetch::getOtherUser() const
+{
+    return m_otherUser;
+}
+
+String_t
+server::host::GamePrefetch::getKey(int32_t gameId, String_t key)
+{
+    std::auto_ptr<Value_t> v(getValue(gameId, key, String_t()));
+    return toString(v.get());
+}
+
+String_t
+server::host::GamePrefetch::getString(int32_t gameId, String_t key, String_t field)
+{
+    std::auto_ptr<Value_t> v(getValue(gameId, key, field));
+    return toString(v.get());
+}
+
+int32_t
+server::host::GamePrefetch::getInteger(int32_t gameId, String_t key, String_t field)
+{
+    std::auto_ptr<Value_t> v(getValue(gameId, key, field));
+    return toInteger(v.get());
+}
+
+afl::base::Optional<int32_t>
+server::host::GamePrefetch::getOptionalInteger(int32_t gameId, String_t key, String_t field)
+{
+    std::auto_ptr<Value_t> v(getValue(gameId, key, field));
+    return toOptionalInteger(v.get());
+}
+
+afl::base::Optional<String_t>
+server::host::GamePrefetch::getOptionalString(int32_t gameId, String_t key, String_t field)
+{
+    std::auto_ptr<Value_t> v(getValue(gameId, key, field));
+    return toOptionalString(v.get());
+}
+
+String_t
+server::host::GamePrefetch::getToolField(ToolKind kind, String_t name, String_t field)
+{
+    // Cache key. Tool names cannot contain ":".
+    String_t cacheKey = afl::string::Format("%d:%s:%s", int(kind), name, field);
+    std::map<String_t, String_t>::iterator it = m_toolCache.find(cacheKey);
+    if (it != m_toolCache.end()) {
+        return it->second;
+    }
+
+    String_t result;
+    switch (kind) {
+     case HostTool:     result = m_root.hostRoot().byName(name).stringField(field).get();     break;
+     case ShipListTool: result = m_root.shipListRoot().byName(name).stringField(field).get(); break;
+     case MasterTool:   result = m_root.masterRoot().byName(name).stringField(field).get();   break;
+    }
+    m_toolCache.insert(std::make_pair(cacheKey, result));
+    return result;
+}
+
+int32_t
+server::host::GamePrefetch::getUserRankLevel()
+{
+    if (!m_userRankLevel.isValid()) {
+        m_userRankLevel = User(m_root, m_forUser).rankLevel().get();
+    }
+    return m_userRankLevel.orElse(0);
+}
+
+int32_t
+server::host::GamePrefetch::getUserRankPoints()
+{
+    if (!m_userRankPoints.isValid()) {
+        m_userRankPoints = User(m_root, m_forUser).rankPoints().get();
+    }
+    return m_userRankPoints.orElse(0);
+}
+
+/* Determine items to prefetch.
+   This must match the accesses made by Game::describe(), Game::hasPermission() and HostGame::listGames(). */
+void
+server::host::GamePrefetch::addItems()
+{
+    const bool needRanks = !m_forUser.empty() || !m_otherUser.empty();
+
+    m_items.push_back(Item("state", String_t()));
+    m_items.push_back(Item("type", String_t()));
+    m_items.push_back(Item("name", String_t()));
+    m_items.push_back(Item("cache", "difficulty"));
+    m_items.push_back(Item("cache", "schedule"));
+    m_items.push_back(Item("settings", "turn"));
+    m_items.push_back(Item("settings", "host"));
+    m_items.push_back(Item("settings", "shiplist"));
+    m_items.push_back(Item("settings", "lastHostTime"));
+    m_items.push_back(Item("settings", "nextHostTime"));
+    if (!m_forUser.empty()) {
+        m_items.push_back(Item("owner", String_t()));
+        m_items.push_back(Item("users", m_forUser));
+    }
+    if (m_verbose) {
+        m_items.push_back(Item("settings", "description"));
+        m_items.push_back(Item("settings", "master"));
+        m_items.push_back(Item("settings", "forum"));
+        m_items.push_back(Item("settings", "joinMulti"));
+        m_items.push_back(Item("settings", "minRankLevelToJoin"));
+        m_items.push_back(Item("settings", "maxRankLevelToJoin"));
+        m_items.push_back(Item("settings", "minRankPointsToJoin"));
+        m_items.push_back(Item("settings", "maxRankPointsToJoin"));
+        m_items.push_back(Item("scores", "score"));
+        m_items.push_back(Item("cache", "scores:score"));
+        m_items.push_back(Item("cache", "scores:timscore"));
+    }
+    if (m_verbose || needRanks) {
+        for (int i = 1; i <= Game::NUM_PLAYERS; ++i) {
+            String_t key = afl::string::Format("player:%d:status", i);
+            m_items.push_back(Item(key, "slot"));
+            m_items.push_back(Item("cache", afl::string::Format("players:%d", i)));
+            if (m_verbose) {
+                m_items.push_back(Item(key, "turn"));
+            }
+            if (needRanks) {
+                m_items.push_back(Item(key, "rank"));
+            }
+        }
+    }
+}
+
+/* Load rows for the game Ids produced by a SORT operation. */
+void
+server::host::GamePrefetch::loadRows(afl::net::redis::SortOperation& op)
+{
+    // Build request. Each row of the result is the game Id, followed by all items.
+    afl::net::redis::Subtree tpl = m_root.gameRoot().subtree("*");
+    op.get();
+    for (size_t i = 0, n = m_items.size(); i < n; ++i) {
+        const Item& it = m_items[i];
+        if (it.field.empty()) {
+            op.get(tpl.stringKey(it.key));
+        } else {
+            op.get(tpl.hashKey(it.key).field(it.field));
+        }
+    }
+
+    // Do it
+    m_data.reset(op.getResult());
+    m_rowByGame.clear();
+
+    // Index
+    afl::data::Access a(m_data.get());
+    const size_t rowSize = m_items.size() + 1;
+    for (size_t i = 0, n = a.getArraySize(); i + rowSize <= n; i += rowSize) {
+        m_rowByGame[a[i].toInteger()] = i;
+    }
+}
+
+/* Get a value.
+   Returns a newly-allocated value (or null) that must be deleted by the caller.
+   Uses prefetched data if available, otherwise, reads the database. */
+server::Value_t*
+server::host::GamePrefetch::getValue(int32_t gameId, const String_t& key, const String_t& field)
+{
+    std::map<int32_t, size_t>::const_iterator row = m_rowByGame.find(gameId);
+    if (row != m_rowByGame.end()) {
+        for (size_t i = 0, n = m_items.size(); i < n; ++i) {
+            if (m_items[i].key == key && m_items[i].field == field) {
+                Value_t* v = afl::data::Access(m_data.get())[row->second + 1 + i].getValue();
+                return v != 0 ? v->clone() : 0;
+            }
+        }
+    }
+
+    afl::net::redis::Subtree game = m_root.gameRoot().subtree(gameId);
+    if (field.empty()) {
+        return makeStringValue(game.stringKey(key).get());
+    } else {
+        return game.hashKey(key).field(field).getRawValue();
+    }
+}
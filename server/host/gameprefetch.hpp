@@ -0,0 +1,157 @@
+/**
+  *  \file server/host/gameprefetch.hpp
+  *  \brief Class server::host::GamePrefetch
+  */
+#ifndef C2NG_SERVER_HOST_GAMEPREFETCH_HPP
+#define C2NG_SERVER_HOST_GAMEPREFETCH_HPP
+
+#include <map>
+#include <memory>
+#include <vector>
+#include "afl/base/optional.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/data/integerlist.hpp"
+#include "afl/net/redis/integersetkey.hpp"
+#include "afl/net/redis/sortoperation.hpp"
+#include "server/types.hpp"
+
+namespace server { namespace host {
+
+    class Root;
+
+    /** Prefetched data for describing games.
+        Describing a game (Game::describe()) reads a few dozen scalar values (state, type, settings, slot status),
+        each of which requires a database round trip.
+        When describing a list of games, GamePrefetch obtains these values for all games in one go,
+        using a single SORT/GET request.
+
+        Values that are not scalars (player lists, schedules, scores) are taken from the game's cache (Game::clearCache()),
+        which Game::describe() fills when they are first needed.
+        Tool descriptions and the requesting user's rank, which are shared by all games, are read once and kept.
+
+        The set of values to prefetch depends on the viewpoint parameters of Game::describe(),
+        which are therefore given to the constructor.
+
+        If a game was not loaded, or a value was not prefetched, it is read from the database as usual;
+        thus, using a GamePrefetch without calling load() is equivalent to reading everything individually. */
+    class GamePrefetch : private afl::base::Uncopyable {
+     public:
+        /** Tool kinds. */
+        enum ToolKind {
+            HostTool,
+            ShipListTool,
+            MasterTool
+        };
+
+        /** Constructor.
+            \param root      Service root
+            \param verbose   true to produce verbose information (see Game::describe())
+            \param forUser   user who is requesting information
+            \param otherUser user whose game list we are requesting */
+        GamePrefetch(Root& root, bool verbose, String_t forUser, String_t otherUser);
+
+        /** Destructor. */
+        ~GamePrefetch();
+
+        /** Load data for a set of games.
+            Performs a single database request.
+            \param games Set of game Ids */
+        void load(afl::net::redis::IntegerSetKey games);
+
+        /** Load data for a list of games.
+            Like load(IntegerSetKey), for games that are not available as a set in the database.
+            Uses a temporary list and therefore needs a constant number of database requests.
+            \param games List of game Ids */
+        void load(const afl::data::IntegerList_t& games);
+
+        /** Check verbosity.
+            \return verbose parameter given to constructor */
+        bool isVerbose() const;
+
+        /** Get requesting user.
+            \return forUser parameter given to constructor */
+        const String_t& getForUser() const;
+
+        /** Get other user.
+            \return otherUser parameter given to constructor */
+        const String_t& getOtherUser() const;
+
+        /** Get string-key value.
+            \param gameId Game Id
+            \param key    Key name relative to game, e.g. "state"
+            \return value */
+        String_t getKey(int32_t gameId, String_t key);
+
+        /** Get hash field value as string.
+            \param gameId Game Id
+            \param key    Key name relative to game, e.g. "settings"
+            \param field  Field name
+            \return value; empty if field does not exist */
+        String_t getString(int32_t gameId, String_t key, String_t field);
+
+        /** Get hash field value as integer.
+            \param gameId Game Id
+            \param key    Key name relative to game, e.g. "settings"
+            \param field  Field name
+            \return value; 0 if field does not exist */
+        int32_t getInteger(int32_t gameId, String_t key, String_t field);
+
+        /** Get hash field value as optional integer.
+            \param gameId Game Id
+            \param key    Key name relative to game, e.g. "settings"
+            \param field  Field name
+            \return value; Nothing if field does not exist */
+        afl::base::Optional<int32_t> getOptionalInteger(int32_t gameId, String_t key, String_t field);
+
+        /** Get hash field value as optional string.
+            \param gameId Game Id
+            \param key    Key name relative to game, e.g. "cache"
+            \param field  Field name
+            \return value; Nothing if field does not exist */
+        afl::base::Optional<String_t> getOptionalString(int32_t gameId, String_t key, String_t field);
+
+        /** Get tool property.
+            \param kind   Tool kind
+            \param name   Tool name
+            \param field  Field name, e.g. "description"
+            \return value */
+        String_t getToolField(ToolKind kind, String_t name, String_t field);
+
+        /** Get requesting user's rank level.
+            \return rank level of forUser */
+        int32_t getUserRankLevel();
+
+        /** Get requesting user's rank points.
+            \return rank points (skill) of forUser */
+        int32_t getUserRankPoints();
+
+     private:
+        /** A prefetched item. */
+        struct Item {
+            String_t key;           ///< Key name relative to game.
+            String_t field;         ///< Field name; empty for a string key.
+            Item(String_t key, String_t field)
+                : key(key), field(field)
+                { }
+        };
+
+        Root& m_root;
+        const bool m_verbose;
+        const String_t m_forUser;
+        const String_t m_otherUser;
+
+        std::vector<Item> m_items;
+        std::auto_ptr<Value_t> m_data;
+        std::map<int32_t, size_t> m_rowByGame;
+        std::map<String_t, String_t> m_toolCache;
+        afl::base::Optional<int32_t> m_userRankLevel;
+        afl::base::Optional<int32_t> m_userRankPoints;
+
+        void addItems();
+        void loadRows(afl::net::redis::SortOperation& op);
+        Value_t* getValue(int32_t gameId, const String_t& key, const String_t& field);
+    };
+
+} }
+
+#endif
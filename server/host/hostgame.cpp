@@ -3,10 +3,12 @@
   *  \brief Class server::host::HostGame
   */
 
+#include <memory>
 #include <stdexcept>
 #include "server/host/hostgame.hpp"
 #include "afl/net/redis/hashkey.hpp"
 #include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/integersetkey.hpp"
 #include "afl/net/redis/stringfield.hpp"
 #include "afl/net/redis/subtree.hpp"
 #include "afl/string/format.hpp"
@@ -16,6 +18,7 @@
 #include "server/host/exec.hpp"
 #include "server/host/game.hpp"
 #include "server/host/gamecreator.hpp"
+#include "server/host/gameprefetch.hpp"
 #include "server/host/rank/victory.hpp"
 #include "server/host/root.hpp"
 #include "server/host/session.hpp"
@@ -25,6 +28,17 @@
 #include "server/interface/filebaseclient.hpp"
 #include "server/interface/hosttool.hpp"
 
+namespace {
+    /* Load list of games from a set, and prefetch their data if desired. */
+    void loadGameList(afl::net::redis::IntegerSetKey key, afl::data::IntegerList_t& games, server::host::GamePrefetch* prefetch)
+    {
+        key.getAll(games);
+        if (prefetch != 0) {
+            prefetch->load(key);
+        }
+    }
+}
+
 server::host::HostGame::HostGame(const Session& session, Root& root)
     : m_session(session),
       m_root(root)
@@ -162,10 +176,12 @@ void
 server::host::HostGame::getInfos(const Filter& filter, bool verbose, std::vector<Info>& result)
 {
     // ex planetscentral/host/cmdgame.h:doListGames
+    // Fetch the bulk of the data for all games in one go; this saves a database round trip per value and game.
+    GamePrefetch prefetch(m_root, verbose, m_session.getUser(), filter.requiredUser.orElse(String_t()));
     afl::data::IntegerList_t list;
-    listGames(filter, list);
+    listGames(filter, list, &prefetch);
     for (size_t i = 0, n = list.size(); i < n; ++i) {
-        result.push_back(Game(m_root, list[i], Game::NoExistanceCheck).describe(verbose, m_session.getUser(), filter.requiredUser.orElse(String_t()), m_root));
+        result.push_back(Game(m_root, list[i], Game::NoExistanceCheck).describe(prefetch, m_root));
     }
 }
 
@@ -173,7 +189,7 @@ void
 server::host::HostGame::getGames(const Filter& filter, afl::data::IntegerList_t& result)
 {
     // ex planetscentral/host/cmdgame.h:doListGames
-    listGames(filter, result);
+    listGames(filter, result, 0);
 }
 
 void
@@ -554,7 +570,7 @@ server::host::HostGame::resetToTurn(int32_t gameId, int turnNr)
 }
 
 void
-server::host::HostGame::listGames(const Filter& filter, afl::data::IntegerList_t& result)
+server::host::HostGame::listGames(const Filter& filter, afl::data::IntegerList_t& result, GamePrefetch* prefetch)
 {
     // ex planetscentral/host/cmdgame.h:doListGames [part]
 
@@ -600,19 +616,22 @@ server::host::HostGame::listGames(const Filter& filter, afl::data::IntegerList_t
                 games.push_back(game);
             }
         }
+        if (prefetch != 0) {
+            prefetch->load(games);
+        }
     } else if (stateLimit.empty()) {
         // No state limit given
-        m_root.gameRoot().intSetKey("all").getAll(games);
+        loadGameList(m_root.gameRoot().intSetKey("all"), games, prefetch);
         needTypeCheck = true;
         needStateCheck = false;
     } else {
         // State limit given, so use by-state lists
         needStateCheck = false;
         if (typeLimit == "public") {
-            m_root.gameRoot().subtree("pubstate").intSetKey(stateLimit).getAll(games);
+            loadGameList(m_root.gameRoot().subtree("pubstate").intSetKey(stateLimit), games, prefetch);
             needTypeCheck = false;
         } else {
-            m_root.gameRoot().subtree("state").intSetKey(stateLimit).getAll(games);
+            loadGameList(m_root.gameRoot().subtree("state").intSetKey(stateLimit), games, prefetch);
             needTypeCheck = true;
         }
     }
@@ -623,6 +642,13 @@ server::host::HostGame::listGames(const Filter& filter, afl::data::IntegerList_t
         needStateCheck = false;
     }
 
+    // Filter. Without a prefetch, use one that has not been loaded, which reads everything individually.
+    std::auto_ptr<GamePrefetch> localPrefetch;
+    if (prefetch == 0) {
+        localPrefetch.reset(new GamePrefetch(m_root, false, m_session.getUser(), String_t()));
+        prefetch = localPrefetch.get();
+    }
+
     const String_t* requiredHost     = filter.requiredHost.get();
     const String_t* requiredTool     = filter.requiredTool.get();
     const String_t* requiredShipList = filter.requiredShipList.get();
@@ -631,12 +657,12 @@ server::host::HostGame::listGames(const Filter& filter, afl::data::IntegerList_t
 
     for (size_t i = 0; i < games.size(); ++i) {
         Game game(m_root, games[i], Game::NoExistanceCheck);
-        if ((!needPermissionCheck || game.hasPermission(m_session.getUser(), Game::ReadPermission))
-            && (!needTypeCheck || formatType(game.getType()) == typeLimit)
-            && (!needStateCheck || formatState(game.getState()) == stateLimit)
-            && (!requiredHost || game.settings().stringField("host").get() == *requiredHost)
-            && (!requiredShipList || game.settings().stringField("shiplist").get() == *requiredShipList)
-            && (!requiredMaster || game.settings().stringField("master").get() == *requiredMaster)
+        if ((!needPermissionCheck || game.hasPermission(*prefetch, m_session.getUser(), Game::ReadPermission))
+            && (!needTypeCheck || formatType(game.getType(*prefetch)) == typeLimit)
+            && (!needStateCheck || formatState(game.getState(*prefetch)) == stateLimit)
+            && (!requiredHost || prefetch->getString(games[i], "settings", "host") == *requiredHost)
+            && (!requiredShipList || prefetch->getString(games[i], "settings", "shiplist") == *requiredShipList)
+            && (!requiredMaster || prefetch->getString(games[i], "settings", "master") == *requiredMaster)
             && (!requiredCopyOf || game.getConfigInt("copyOf") == *requiredCopyOf)
             && (!requiredTool || game.tools().contains(*requiredTool)))
         {
@@ -9,6 +9,7 @@
 
 namespace server { namespace host {
 
+    class GamePrefetch;
     class Root;
     class Session;
 
@@ -52,7 +53,7 @@ namespace server { namespace host {
         const Session& m_session;
         Root& m_root;
 
-        void listGames(const Filter& filter, afl::data::IntegerList_t& result);
+        void listGames(const Filter& filter, afl::data::IntegerList_t& result, GamePrefetch* prefetch);
 
         bool addRemoveTool(int32_t gameId, String_t toolId, bool add);
     };
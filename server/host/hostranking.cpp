@@ -3,6 +3,7 @@
   *  \brief Class server::host::HostRanking
   */
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include "server/host/hostranking.hpp"
@@ -12,41 +13,27 @@
 #include "afl/data/vector.hpp"
 #include "afl/data/vectorvalue.hpp"
 #include "afl/net/redis/sortoperation.hpp"
+#include "afl/net/redis/stringlistkey.hpp"
 #include "server/errors.hpp"
+#include "server/host/rank/leaderboard.hpp"
 #include "server/host/root.hpp"
+#include "server/host/session.hpp"
 
 using afl::data::Access;
 using afl::data::Hash;
 using afl::data::HashValue;
 using afl::data::Vector;
 using afl::data::VectorValue;
+using server::host::rank::Leaderboard;
 
 namespace {
-    struct Field {
-        const char* name;       ///< Name in interface (sortField, fieldsToGet).
-        const char* dbName;     ///< Name in database.
-        bool isAlphabetic;      ///< true if alphabetic.
-    };
-
-    const Field FIELDS[] = {
-        { "name",            "user:*:name",                     true },
-        { "screenname",      "user:*:profile->screenname",      true },
-        { "rank",            "user:*:profile->rank",            false },
-        { "rankpoints",      "user:*:profile->rankpoints",      false },
-        { "turnreliability", "user:*:profile->turnreliability", false },
-        { "turnsplayed",     "user:*:profile->turnsplayed",     false },
-        { "turnsmissed",     "user:*:profile->turnsmissed",     false },
-    };
-
-    const Field& findField(const String_t& name, const char* errorMessage)
+    const Leaderboard::Field& findField(const String_t& name, const char* errorMessage)
     {
-        afl::base::Memory<const Field> fs = FIELDS;
-        while (const Field* p = fs.eat()) {
-            if (p->name == name) {
-                return *p;
-            }
+        if (const Leaderboard::Field* p = Leaderboard::findField(name)) {
+            return *p;
+        } else {
+            throw std::runtime_error(errorMessage);
         }
-        throw std::runtime_error(errorMessage);
     }
 }
 
@@ -57,24 +44,40 @@ server::host::HostRanking::HostRanking(Session& session, Root& root)
 server::Value_t*
 server::host::HostRanking::getUserList(const ListRequest& req)
 {
+    // Validate
+    const Leaderboard::Field* sortField = 0;
+    if (const String_t* sortKey = req.sortField.get()) {
+        sortField = &findField(*sortKey, INVALID_SORT_KEY);
+    }
+    for (size_t i = 0, n = req.fieldsToGet.size(); i < n; ++i) {
+        findField(req.fieldsToGet[i], INVALID_KEY);
+    }
+
+    // A part of a sorted list is taken from the leaderboard
+    if (sortField != 0 && req.count.isValid()) {
+        return getUserListPart(*sortField, req);
+    }
+
     // Build a sort request
     afl::net::redis::SortOperation op = m_root.activeUsers().sort().get();
 
     // Sort
-    if (const String_t* sortKey = req.sortField.get()) {
-        const Field& sortField = findField(*sortKey, INVALID_SORT_KEY);
-        op.by(sortField.dbName);
-        if (sortField.isAlphabetic) {
+    if (sortField != 0) {
+        op.by(sortField->dbName);
+        if (sortField->isAlphabetic) {
             op.sortLexicographical();
         }
     }
     if (req.sortReverse) {
         op.sortReversed();
     }
+    if (const int32_t* count = req.count.get()) {
+        op.limit(req.start, *count);
+    }
 
     // Additional fields
     for (size_t i = 0, n = req.fieldsToGet.size(); i < n; ++i) {
-        op.get(findField(req.fieldsToGet[i], INVALID_KEY).dbName);
+        op.get(Leaderboard::findField(req.fieldsToGet[i])->dbName);
     }
 
     // Do it
@@ -109,3 +112,48 @@ server::host::HostRanking::getUserList(const ListRequest& req)
     }
     return new VectorValue(resultVector);
 }
+
+int32_t
+server::host::HostRanking::rebuildRankings()
+{
+    m_session.checkAdmin();
+    return Leaderboard(m_root).rebuild();
+}
+
+/* Get part of a sorted user list, using the leaderboard.
+   Reads the requested users and fields with a single SORT over the leaderboard, keeping its order. */
+server::Value_t*
+server::host::HostRanking::getUserListPart(const Leaderboard::Field& sortField, const ListRequest& req)
+{
+    // Determine range. The leaderboard is sorted ascending; for a reverse list, take the mirrored range.
+    int32_t size;
+    afl::net::redis::StringListKey list = Leaderboard(m_root).get(sortField, size);
+    const int32_t start = std::max(0, std::min(req.start, size));
+    const int32_t count = std::max(0, std::min(*req.count.get(), size - start));
+
+    // Produce output (same format as above)
+    Vector::Ref_t resultVector = Vector::create();
+    if (count > 0) {
+        afl::net::redis::SortOperation op = list.sort().by("nosort").get();
+        op.limit(req.sortReverse ? size - start - count : start, count);
+        for (size_t i = 0, n = req.fieldsToGet.size(); i < n; ++i) {
+            op.get(Leaderboard::findField(req.fieldsToGet[i])->dbName);
+        }
+        std::auto_ptr<Value_t> dbResult(op.getResult());
+        Access dbAccess(dbResult);
+
+        const size_t rowSize = req.fieldsToGet.size() + 1;
+        const size_t numRows = dbAccess.getArraySize() / rowSize;
+        for (size_t r = 0; r < numRows; ++r) {
+            size_t index = (req.sortReverse ? numRows - 1 - r : r) * rowSize;
+            String_t userId = dbAccess[index++].toString();
+            Vector::Ref_t userVector = Vector::create();
+            for (size_t i = 0, n = req.fieldsToGet.size(); i < n; ++i) {
+                userVector->pushBack(dbAccess[index++].getValue());
+            }
+            resultVector->pushBackNew(makeStringValue(userId));
+            resultVector->pushBackNew(new VectorValue(userVector));
+        }
+    }
+    return new VectorValue(resultVector);
+}
@@ -6,6 +6,7 @@
 #define C2NG_SERVER_HOST_HOSTRANKING_HPP
 
 #include "server/interface/hostranking.hpp"
+#include "server/host/rank/leaderboard.hpp"
 
 namespace server { namespace host {
 
@@ -22,10 +23,13 @@ namespace server { namespace host {
 
         // Interface methods:
         virtual Value_t* getUserList(const ListRequest& req);
+        virtual int32_t rebuildRankings();
 
      private:
         const Session& m_session;
         Root& m_root;
+
+        Value_t* getUserListPart(const rank::Leaderboard::Field& sortField, const ListRequest& req);
     };
 
 } }
@@ -112,6 +112,7 @@ server::host::HostSchedule::modify(int32_t gameId, const Schedule& sched)
     game.removeConfig("hostRunNow");
     parsedSchedule.saveTo(sroot.hashKey(scheduleName));
     game.lastScheduleChangeTime().set(m_root.getTime());
+    game.clearScheduleCache();
     game.scheduleChanged().set(1);
     m_root.handleGameChange(gameId);
 }
@@ -160,6 +161,7 @@ server::host::HostSchedule::drop(int32_t gameId)
     }
     game.scheduleChanged().set(1);
     game.lastScheduleChangeTime().set(m_root.getTime());
+    game.clearScheduleCache();
     m_root.handleGameChange(gameId);
 }
 
@@ -309,6 +311,7 @@ server::host::HostSchedule::doAddReplace(int32_t gameId, const Schedule& sched,
     }
     game.removeConfig("hostRunNow");
     game.lastScheduleChangeTime().set(m_root.getTime());
+    game.clearScheduleCache();
     game.scheduleChanged().set(1);
     m_root.handleGameChange(gameId);
 }
@@ -21,6 +21,7 @@
 #include "server/host/gamearbiter.hpp"
 #include "server/host/installer.hpp"
 #include "server/host/keystore.hpp"
+#include "server/host/rank/leaderboard.hpp"
 #include "server/host/root.hpp"
 #include "server/host/schedule.hpp"
 #include "server/host/session.hpp"
@@ -268,7 +269,10 @@ server::host::HostTurn::submit(const String_t& blob,
     // Mark user active
     // (Note that the player may still be unknown if a turn is submitted using the admin console.)
     if (game.getType() != HostGame::TestGame && user.size() != 0) {
-        m_root.activeUsers().add(user);
+        if (m_root.activeUsers().add(user)) {
+            // New active user: ranking lists must be rebuilt to include this user
+            rank::Leaderboard(m_root).invalidateAll();
+        }
     }
 
     // Build protocol result
@@ -0,0 +1,141 @@
+/**
+  *  \file server/host/rank/leaderboard.cpp
+  *  \brief Class server::host::rank::Leaderboard
+  */
+
+#include <memory>
+#include "server/host/rank/leaderboard.hpp"
+#include "afl/base/countof.hpp"
+#include "afl/data/segment.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/sortoperation.hpp"
+#include "afl/net/redis/stringsetkey.hpp"
+
+using server::host::rank::Leaderboard;
+
+namespace {
+    const Leaderboard::Field FIELDS[] = {
+        { "name",            "user:*:name",                     true },
+        { "screenname",      "user:*:profile->screenname",      true },
+        { "rank",            "user:*:profile->rank",            false },
+        { "rankpoints",      "user:*:profile->rankpoints",      false },
+        { "turnreliability", "user:*:profile->turnreliability", false },
+        { "turnsplayed",     "user:*:profile->turnsplayed",     false },
+        { "turnsmissed",     "user:*:profile->turnsmissed",     false },
+    };
+}
+
+server::host::rank::Leaderboard::Leaderboard(Root& root)
+    : m_root(root)
+{ }
+
+const server::host::rank::Leaderboard::Field*
+server::host::rank::Leaderboard::findField(const String_t& name)
+{
+    for (size_t i = 0; i < countof(FIELDS); ++i) {
+        if (FIELDS[i].name == name) {
+            return &FIELDS[i];
+        }
+    }
+    return 0;
+}
+
+afl::net::redis::StringListKey
+server::host::rank::Leaderboard::get(const Field& field, int32_t& size)
+{
+    // A leaderboard is valid if it has a marker, and no invalidation happened since it was built
+    const int32_t generation = generations().intField(field.name).get();
+    std::auto_ptr<afl::data::Value> marker(validity().field(field.name).getRawValue());
+    if (marker.get() != 0 && builtGenerations().intField(field.name).get() == generation) {
+        size = toInteger(marker.get());
+    } else {
+        size = rebuild(field);
+    }
+    return m_root.rankingRoot().stringListKey(field.name);
+}
+
+void
+server::host::rank::Leaderboard::invalidate(const String_t& name)
+{
+    if (findField(name) != 0) {
+        validity().field(name).remove();
+        generations().intField(name) += 1;
+    }
+}
+
+void
+server::host::rank::Leaderboard::invalidateAll()
+{
+    validity().remove();
+    for (size_t i = 0; i < countof(FIELDS); ++i) {
+        generations().intField(FIELDS[i].name) += 1;
+    }
+}
+
+int32_t
+server::host::rank::Leaderboard::rebuild()
+{
+    int32_t result = 0;
+    for (size_t i = 0; i < countof(FIELDS); ++i) {
+        result = rebuild(FIELDS[i]);
+    }
+    return result;
+}
+
+/* Access validity markers. */
+afl::net::redis::HashKey
+server::host::rank::Leaderboard::validity()
+{
+    return m_root.rankingRoot().hashKey("valid");
+}
+
+/* Access invalidation counters. */
+afl::net::redis::HashKey
+server::host::rank::Leaderboard::generations()
+{
+    return m_root.rankingRoot().hashKey("generation");
+}
+
+/* Access invalidation counters the leaderboards were built from. */
+afl::net::redis::HashKey
+server::host::rank::Leaderboard::builtGenerations()
+{
+    return m_root.rankingRoot().hashKey("built");
+}
+
+int32_t
+server::host::rank::Leaderboard::rebuild(const Field& field)
+{
+    // Remember invalidation counter before reading the data.
+    // If an invalidation arrives while we are working, the leaderboard will not count as valid.
+    const int32_t generation = generations().intField(field.name).get();
+
+    // Sort
+    afl::net::redis::SortOperation op = m_root.activeUsers().sort();
+    op.by(field.dbName);
+    if (field.isAlphabetic) {
+        op.sortLexicographical();
+    }
+    afl::data::StringList_t users;
+    op.getResult(users);
+
+    // Store, using a single RPUSH
+    afl::net::redis::StringListKey list = m_root.rankingRoot().stringListKey(field.name);
+    validity().field(field.name).remove();
+    list.remove();
+    if (!users.empty()) {
+        afl::data::Segment cmd;
+        cmd.pushBackString("RPUSH");
+        cmd.pushBackString(list.getName());
+        for (size_t i = 0, n = users.size(); i < n; ++i) {
+            cmd.pushBackString(users[i]);
+        }
+        list.getHandler().callVoid(cmd);
+    }
+
+    // Mark valid
+    const int32_t size = int32_t(users.size());
+    builtGenerations().intField(field.name).set(generation);
+    validity().intField(field.name).set(size);
+    return size;
+}
@@ -0,0 +1,78 @@
+/**
+  *  \file server/host/rank/leaderboard.hpp
+  *  \brief Class server::host::rank::Leaderboard
+  */
+#ifndef C2NG_SERVER_HOST_RANK_LEADERBOARD_HPP
+#define C2NG_SERVER_HOST_RANK_LEADERBOARD_HPP
+
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/stringlistkey.hpp"
+#include "afl/string/string.hpp"
+#include "server/host/root.hpp"
+
+namespace server { namespace host { namespace rank {
+
+    /** Ranking leaderboards.
+        For each sortable field of the ranking list (RANKLIST), the database contains a list of all active users,
+        sorted by that field in ascending order (Root::rankingRoot()).
+
+        A leaderboard is built on demand using a SORT over all active users, and stored with a single request.
+        The hash "ranking:valid" contains, for each valid leaderboard, the number of users it contains.
+        This validity marker is set after the leaderboard has been stored,
+        and removed (invalidated) whenever the underlying data changes or a new user becomes active.
+        Because invalidations come from other services (e.g. server::user::UserManagement) and can arrive while a leaderboard is being built,
+        invalidation also increments a counter in the hash "ranking:generation".
+        The hash "ranking:built" contains the counter value read before building the leaderboard.
+        A leaderboard without validity marker, or with a different counter value, is rebuilt on next use.
+        Thus, the full sort is done once per change instead of once per request,
+        and requests for a part of the ranking only need to look at that part. */
+    class Leaderboard {
+     public:
+        /** Definition of a ranking field. */
+        struct Field {
+            const char* name;       ///< Name in interface (sortField, fieldsToGet). Also name of profile field and leaderboard.
+            const char* dbName;     ///< Name in database (SORT pattern).
+            bool isAlphabetic;      ///< true if alphabetic.
+        };
+
+        /** Constructor.
+            \param root Service root */
+        explicit Leaderboard(Root& root);
+
+        /** Find field definition.
+            \param name Field name
+            \return field definition; null if name is not a ranking field */
+        static const Field* findField(const String_t& name);
+
+        /** Get leaderboard.
+            Builds the leaderboard if needed.
+            \param [in]  field Field
+            \param [out] size  Number of users in the leaderboard
+            \return list of user Ids, sorted by the field (ascending) */
+        afl::net::redis::StringListKey get(const Field& field, int32_t& size);
+
+        /** Invalidate leaderboard.
+            Call whenever a user's profile field changes.
+            \param name Field name; a name that is not a ranking field is ignored */
+        void invalidate(const String_t& name);
+
+        /** Invalidate all leaderboards.
+            Call whenever the set of active users changes. */
+        void invalidateAll();
+
+        /** Rebuild all leaderboards.
+            \return number of active users */
+        int32_t rebuild();
+
+     private:
+        Root& m_root;
+
+        afl::net::redis::HashKey validity();
+        afl::net::redis::HashKey generations();
+        afl::net::redis::HashKey builtGenerations();
+        int32_t rebuild(const Field& field);
+    };
+
+} } }
+
+#endif
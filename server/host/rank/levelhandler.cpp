@@ -10,6 +10,7 @@
 #include "afl/net/redis/stringfield.hpp"
 #include "afl/net/redis/subtree.hpp"
 #include "afl/string/format.hpp"
+#include "server/host/rank/leaderboard.hpp"
 #include "server/host/user.hpp"
 
 namespace {
@@ -115,6 +116,10 @@ server::host::rank::LevelHandler::handlePlayerTurn(String_t userId, bool submit,
     }
     u.turnReliability().set(u.turnReliability().get() * (100 - RELIABILITY_SPEED) / 100 + newPoints);
 
+    Leaderboard lb(m_root);
+    lb.invalidate(submit ? "turnsplayed" : "turnsmissed");
+    lb.invalidate("turnreliability");
+
     // Log
     m_root.log().write(afl::sys::LogListener::Info, LOG_NAME,
                        afl::string::Format("player '%s': %d points (%s, level %d)") << userId << newPoints << (submit?"submit":"miss") << level);
@@ -164,6 +169,7 @@ server::host::rank::LevelHandler::handlePlayerDrop(String_t userId, Game& game,
     int32_t oldReliability = u.turnReliability().get();
     int32_t newReliability = int32_t(oldReliability * double(maxScore*100 - playerScore*DROP_PENALTY) / (maxScore*100));
     u.turnReliability().set(newReliability);
+    Leaderboard(m_root).invalidate("turnreliability");
     m_root.log().write(afl::sys::LogListener::Info, LOG_NAME,
                        afl::string::Format("player '%s': reliability %d->%d due to dropout, score %d/%d") << userId << oldReliability << newReliability << playerScore << maxScore);
 }
@@ -174,6 +180,7 @@ server::host::rank::LevelHandler::addPlayerRankPoints(String_t userId, int32_t p
 {
     // ex planetscentral/host/ranking.h:addPlayerRankPoints
     User(m_root, userId).rankPoints() += pts;
+    Leaderboard(m_root).invalidate("rankpoints");
 }
 
 // Check possible required rank changes.
@@ -215,6 +222,7 @@ server::host::rank::LevelHandler::handlePlayerRankChanges(String_t userId)
 
     // So, did something happen?
     if (mail != 0) {
+        Leaderboard(m_root).invalidate("rank");
         m_root.log().write(afl::sys::LogListener::Info, LOG_NAME, afl::string::Format("%s for user %s, new rank: %d", mail, userId, currentRank));
 
         server::interface::MailQueue& mq = m_root.mailQueue();
@@ -8,6 +8,8 @@
 #include <stdexcept>
 #include "server/host/schedule.hpp"
 #include "afl/net/redis/integerfield.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/parse.hpp"
 #include "server/host/configuration.hpp"
 #include "server/errors.hpp"
 
@@ -247,6 +249,49 @@ server::host::Schedule::saveTo(afl::net::redis::HashKey h) const
     }
 }
 
+// Pack into a string.
+String_t
+server::host::Schedule::pack() const
+{
+    return afl::string::Format("%d,%d,%d,%d,%d,", HostSchedule::formatType(m_type), m_weekdays.toInteger(), m_interval, m_daytime, int(m_hostEarly))
+        + afl::string::Format("%d,%d,%d,%d", m_hostDelay, m_hostLimit, HostSchedule::formatCondition(m_condition), m_condTurnOrTime);
+}
+
+// Unpack from a string.
+bool
+server::host::Schedule::unpack(const String_t& str)
+{
+    // Split into integers
+    const size_t NUM_VALUES = 9;
+    int32_t values[NUM_VALUES];
+    size_t pos = 0;
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+        size_t end = (i+1 < NUM_VALUES ? str.find(',', pos) : str.size());
+        if (end == String_t::npos || !afl::string::strToInteger(str.substr(pos, end - pos), values[i])) {
+            return false;
+        }
+        pos = end + 1;
+    }
+
+    // Verify enums
+    HostSchedule::Type type;
+    HostSchedule::Condition condition;
+    if (!HostSchedule::parseType(values[0], type) || !HostSchedule::parseCondition(values[7], condition)) {
+        return false;
+    }
+
+    m_type = type;
+    m_weekdays = afl::bits::SmallSet<int8_t>::fromInteger(values[1]);
+    m_interval = values[2];
+    m_daytime = values[3];
+    m_hostEarly = (values[4] != 0);
+    m_hostDelay = values[5];
+    m_hostLimit = values[6];
+    m_condition = condition;
+    m_condTurnOrTime = values[8];
+    return true;
+}
+
 // Get next host.
 server::Time_t
 server::host::Schedule::getNextHost(int32_t now) const
@@ -125,6 +125,17 @@ namespace server { namespace host {
             \param h Key to store to */
         void saveTo(afl::net::redis::HashKey h) const;
 
+        /** Pack into a string.
+            The string contains all schedule parameters and can be restored using unpack().
+            It is used to cache a schedule in a single value.
+            \return packed schedule */
+        String_t pack() const;
+
+        /** Unpack from a string.
+            \param str String produced by pack()
+            \return true on success; false if the string is invalid (in this case, the schedule is unchanged) */
+        bool unpack(const String_t& str);
+
 
         /*
          *  Computations
@@ -3,7 +3,9 @@
   *  \brief Class server::host::ServerApplication
   */
 
+#include <vector>
 #include "server/host/serverapplication.hpp"
+#include "afl/container/ptrvector.hpp"
 #include "afl/except/commandlineexception.hpp"
 #include "afl/except/fileproblemexception.hpp"
 #include "afl/io/directory.hpp"
@@ -93,7 +95,11 @@ server::host::ServerApplication::serverMain()
     // is now feasible as all afl components properly set FD_CLOEXEC. However, this complicates matters, and having the
     // extra process around and wasting a few kilobytes of memory for a non-production usecase just isn't worth it.
     util::ProcessRunner checkturnRunner;
-    util::ProcessRunner hostRunner;
+    afl::container::PtrVector<util::ProcessRunner> hostRunners;
+    std::vector<util::ProcessRunner*> hostRunnerPointers;
+    for (int i = 0; i < m_config.numHostWorkers; ++i) {
+        hostRunnerPointers.push_back(hostRunners.pushBackNew(new util::ProcessRunner()));
+    }
 
     // Set up work directory
     setupWorkDirectory();
@@ -127,7 +133,7 @@ server::host::ServerApplication::serverMain()
     // Set up cron if desired
     std::auto_ptr<Cron> pCron;
     if (m_config.useCron) {
-        pCron.reset(new CronImpl(root, hostRunner));
+        pCron.reset(new CronImpl(root, hostRunnerPointers));
         if (m_config.initialSuspend > 0) {
             pCron->suspendScheduler(root.getTime() + m_config.initialSuspend);
         }
@@ -231,6 +237,19 @@ server::host::ServerApplication::handleConfiguration(const String_t& key, const
            Ignored in c2ng/c2host-server for compatibility reasons.
            Number of threads (=maximum number of parallel connections). */
         return true;
+    } else if (isInstanceOption(key, "WORKERS")) {
+        /* @q Host.Workers:Int (Config)
+           Number of host runs that can execute in parallel.
+           Each host run uses a separate work directory within {Host.WorkDir}.
+           A game never runs in parallel with itself.
+           @since PCC2 2.41.5 */
+        int n;
+        if (afl::string::strToInteger(value, n) && n > 0) {
+            m_config.numHostWorkers = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (isInstanceOption(key, "INITIALSUSPEND")) {
         /* @q Host.InitialSuspend:Int (Config)
            Suspend scheduler for the given relative time after startup.
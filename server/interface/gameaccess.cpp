@@ -0,0 +1,17 @@
+/**
+  *  \file server/interface/gameaccess.cpp
+  */
+
+#include "server/interface/gameaccess.hpp"
+
+server::Value_t*
+server::interface::GameAccess::getDeferred(String_t objName)
+{
+    return get(objName);
+}
+
+server::Value_t*
+server::interface::GameAccess::postDeferred(String_t objName, const Value_t* value)
+{
+    return post(objName, value);
+}
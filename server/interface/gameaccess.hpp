@@ -23,6 +23,15 @@ namespace server { namespace interface {
         // POST
         virtual Value_t* post(String_t objName, const Value_t* value) = 0;
 
+        // GET objName, for serialisation.
+        // Serializes identically to get(), but the result may build its elements only when visited,
+        // and must be serialized immediately. Default implementation calls get().
+        virtual Value_t* getDeferred(String_t objName);
+
+        // POST, for serialisation.
+        // Serializes identically to post(), see getDeferred(). Default implementation calls post().
+        virtual Value_t* postDeferred(String_t objName, const Value_t* value);
+
         // Not wrapped: HELP, QUIT
     };
 
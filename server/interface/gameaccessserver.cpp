@@ -105,8 +105,7 @@ server::interface::GameAccessServer::handleLine(const String_t& line, afl::net::
                    - query/id (dynamic data)
                    @rettype Any */
                 // ex doGet / GET: one parameter, URL
-                std::auto_ptr<Value_t> reply(m_implementation.get(arg));
-                response.handleLine("200 OK");
+                std::auto_ptr<Value_t> reply(m_implementation.getDeferred(arg));
                 sendResponse(response, reply.get());
                 return false;
             } else if (afl::string::strCaseCompare(command, "POST") == 0) {
@@ -143,8 +142,7 @@ server::interface::GameAccessServer::handleLine(const String_t& line, afl::net::
 
                 // Call user
                 try {
-                    std::auto_ptr<Value_t> reply(m_implementation.post(m_postTarget, value.get()));
-                    response.handleLine("200 OK");
+                    std::auto_ptr<Value_t> reply(m_implementation.postDeferred(m_postTarget, value.get()));
                     sendResponse(response, reply.get());
                 }
                 catch (std::exception& e) {
@@ -177,11 +175,14 @@ server::interface::GameAccessServer::handleConnectionClose()
 void
 server::interface::GameAccessServer::sendResponse(afl::net::line::LineSink& response, Value_t* value)
 {
+    // Serialize first: the value may build its elements only now (GameAccess::getDeferred()),
+    // and a failure must still produce an error reply instead of a truncated one.
     afl::io::InternalSink sink;
     afl::io::json::Writer writer(sink);
     writer.setLineLength(80);
     writer.visit(value);
 
+    response.handleLine("200 OK");
     sendMemoryResponse(response, sink.getContent());
 }
 
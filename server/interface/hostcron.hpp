@@ -31,12 +31,13 @@ namespace server { namespace interface {
             int32_t gameId;            ///< Affected game.
             Action action;             ///< Action to perform.
             Time_t time;               ///< Time.
+            bool running;              ///< true if action is currently being executed.
 
             Event(int32_t gameId, Action action, Time_t time)
-                : gameId(gameId), action(action), time(time)
+                : gameId(gameId), action(action), time(time), running(false)
                 { }
             Event()
-                : gameId(0), action(UnknownAction), time(0)
+                : gameId(0), action(UnknownAction), time(0), running(false)
                 { }
         };
 
@@ -81,9 +81,10 @@ server::interface::HostCronClient::unpackEvent(const afl::data::Value* p)
         result.action = UnknownAction;
     }
 
-    // Game, Time
+    // Game, Time, Status
     result.gameId = a("game").toInteger();
     result.time = a("time").toInteger();
+    result.running = a("running").toInteger() != 0;
 
     return result;
 }
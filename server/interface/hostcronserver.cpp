@@ -28,6 +28,7 @@ server::interface::HostCronServer::handleCommand(const String_t& upcasedCommand,
            @retkey action:Str (next action name, one of "unknown", "none", "host", "schedulechange", "master")
            @retkey game:GID (game Id)
            @retkey time:Time (action time)
+           @retkey running:Int (1 if action is currently being executed)
 
            Permissions: read-access to game.
 
@@ -44,6 +45,7 @@ server::interface::HostCronServer::handleCommand(const String_t& upcasedCommand,
            @retkey action:Str (next action name, one of "unknown", "none", "host", "schedulechange", "master")
            @retkey game:GID (game Id)
            @retkey time:Time (action time)
+           @retkey running:Int (1 if action is currently being executed)
 
            Permissions: returns only games for which user has read access.
 
@@ -140,5 +142,6 @@ server::interface::HostCronServer::packEvent(const HostCron::Event& event)
     }
     result->setNew("game", makeIntegerValue(event.gameId));
     result->setNew("time", makeIntegerValue(event.time));
+    result->setNew("running", makeIntegerValue(event.running));
     return new afl::data::HashValue(result);
 }
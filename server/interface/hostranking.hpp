@@ -20,9 +20,11 @@ namespace server { namespace interface {
             afl::base::Optional<String_t> sortField;
             bool sortReverse;
             afl::data::StringList_t fieldsToGet;
+            int32_t start;
+            afl::base::Optional<int32_t> count;
 
             ListRequest()
-                : sortField(), sortReverse(false), fieldsToGet()
+                : sortField(), sortReverse(false), fieldsToGet(), start(0), count()
                 { }
         };
 
@@ -30,6 +32,11 @@ namespace server { namespace interface {
             \param req Request
             \return raw result; a list containing alternating user Ids and list-of-fields. */
         virtual Value_t* getUserList(const ListRequest& req) = 0;
+
+        /** Rebuild ranking lists (RANKREBUILD).
+            Requires admin permissions.
+            \return number of users in ranking */
+        virtual int32_t rebuildRankings() = 0;
     };
 
 } }
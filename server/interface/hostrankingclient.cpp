@@ -22,6 +22,11 @@ server::interface::HostRankingClient::getUserList(const ListRequest& req)
     if (req.sortReverse) {
         cmd.pushBackString("REVERSE");
     }
+    if (const int32_t* count = req.count.get()) {
+        cmd.pushBackString("LIMIT");
+        cmd.pushBackInteger(req.start);
+        cmd.pushBackInteger(*count);
+    }
     if (!req.fieldsToGet.empty()) {
         cmd.pushBackString("FIELDS");
         cmd.pushBackElements(req.fieldsToGet);
@@ -29,3 +34,9 @@ server::interface::HostRankingClient::getUserList(const ListRequest& req)
 
     return m_commandHandler.call(cmd);
 }
+
+int32_t
+server::interface::HostRankingClient::rebuildRankings()
+{
+    return m_commandHandler.callInt(afl::data::Segment().pushBackString("RANKREBUILD"));
+}
@@ -21,6 +21,7 @@ namespace server { namespace interface {
 
         // HostRanking:
         virtual Value_t* getUserList(const ListRequest& req);
+        virtual int32_t rebuildRankings();
 
      private:
         afl::net::CommandHandler& m_commandHandler;
@@ -20,7 +20,7 @@ bool
 server::interface::HostRankingServer::handleCommand(const String_t& upcasedCommand, interpreter::Arguments& args, std::auto_ptr<Value_t>& result)
 {
     if (upcasedCommand == "RANKLIST") {
-        /* @q RANKLIST [SORT f:HostRankField] [REVERSE] [FIELDS fs:HostRankField ...] (Host Command)
+        /* @q RANKLIST [SORT f:HostRankField] [REVERSE] [LIMIT start:Int count:Int] [FIELDS fs:HostRankField ...] (Host Command)
            Get list of users.
 
            Returns a list of alternating user Ids (UID) and list-of-associated-fields,
@@ -29,11 +29,15 @@ server::interface::HostRankingServer::handleCommand(const String_t& upcasedComma
 
            If a field is given with SORT, the result is sorted (optionally, reverse sort).
 
+           If LIMIT is given, only the given range of the (sorted) list is returned.
+           Paging through a list sorted by a field is cheap, as it uses the precomputed ranking list;
+           see {RANKREBUILD}.
+
            If the FIELDS clause is given, it must be last.
            All following parameters are fields to return in the list-of-associated-fields.
            The list elements will have the same order as the fields in the FIELDS clause.
 
-           @since PCC2 2.40.6
+           @since PCC2 2.40.6, PCC2 2.41.5 (LIMIT)
            @rettype UID */
 
         /* @type HostRankField
@@ -59,6 +63,10 @@ server::interface::HostRankingServer::handleCommand(const String_t& upcasedComma
                 req.sortField = toString(args.getNext());
             } else if (keyword == "REVERSE") {
                 req.sortReverse = true;
+            } else if (keyword == "LIMIT") {
+                args.checkArgumentCountAtLeast(2);
+                req.start = toInteger(args.getNext());
+                req.count = toInteger(args.getNext());
             } else if (keyword == "FIELDS") {
                 while (args.getNumArgs() > 0) {
                     req.fieldsToGet.push_back(toString(args.getNext()));
@@ -71,6 +79,19 @@ server::interface::HostRankingServer::handleCommand(const String_t& upcasedComma
         // Produce result
         result.reset(m_implementation.getUserList(req));
         return true;
+    } else if (upcasedCommand == "RANKREBUILD") {
+        /* @q RANKREBUILD (Host Command)
+           Rebuild ranking lists.
+
+           The ranking lists used for sorting {RANKLIST} are maintained automatically.
+           This command rebuilds them all from scratch, for example, after changing the database by other means.
+           Needs admin permissions.
+
+           @since PCC2 2.41.5
+           @retval Int number of users in ranking */
+        args.checkArgumentCount(0);
+        result.reset(makeIntegerValue(m_implementation.rebuildRankings()));
+        return true;
     } else {
         return false;
     }
@@ -10,6 +10,27 @@
 #include "afl/data/vectorvalue.hpp"
 #include "game/interface/beamcontext.hpp"
 #include "game/spec/shiplist.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property COST_PROPERTIES[] = {
+        { "COST.D",  "D" },
+        { "COST.M",  "M" },
+        { "COST.MC", "MC" },
+        { "COST.T",  "T" },
+    };
+
+    const PackerSchema::Property BEAM_PROPERTIES[] = {
+        { "DAMAGE",     "DAMAGE" },
+        { "KILL",       "KILL" },
+        { "MASS",       "MASS" },
+        { "NAME",       "NAME" },
+        { "NAME.SHORT", "NAME.SHORT" },
+        { "TECH",       "TECH" },
+    };
+}
 
 server::play::BeamPacker::BeamPacker(game::spec::ShipList& shipList, const game::Root& root, int firstSlot)
     : m_shipList(shipList), m_root(root), m_firstSlot(firstSlot)
@@ -20,6 +41,8 @@ server::play::BeamPacker::buildValue() const
 {
     // ex ServerBeamWriter::write
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    PackerSchema costSchema(COST_PROPERTIES, 0);
+    PackerSchema schema(BEAM_PROPERTIES, 0);
     for (int i = m_firstSlot, n = m_shipList.beams().size(); i <= n; ++i) {
         if (m_shipList.beams().get(i) != 0) {
             afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
@@ -27,19 +50,11 @@ server::play::BeamPacker::buildValue() const
 
             // Cost
             afl::base::Ref<afl::data::Hash> cost(afl::data::Hash::create());
-            addValue(*cost, ctx, "COST.D", "D");
-            addValue(*cost, ctx, "COST.M", "M");
-            addValue(*cost, ctx, "COST.MC", "MC");
-            addValue(*cost, ctx, "COST.T", "T");
+            costSchema.pack(*cost, ctx);
             addValueNew(*hv, new afl::data::HashValue(cost), "COST");
 
             // Remainder
-            addValue(*hv, ctx, "DAMAGE", "DAMAGE");
-            addValue(*hv, ctx, "KILL", "KILL");
-            addValue(*hv, ctx, "MASS", "MASS");
-            addValue(*hv, ctx, "NAME", "NAME");
-            addValue(*hv, ctx, "NAME.SHORT", "NAME.SHORT");
-            addValue(*hv, ctx, "TECH", "TECH");
+            schema.pack(*hv, ctx);
 
             vv->pushBackNew(new afl::data::HashValue(hv));
         } else {
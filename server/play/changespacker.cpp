@@ -0,0 +1,125 @@
+/**
+  *  \file server/play/changespacker.cpp
+  *  \brief Class server::play::ChangesPacker
+  */
+
+#include "server/play/changespacker.hpp"
+#include "afl/data/hash.hpp"
+#include "afl/data/hashvalue.hpp"
+#include "afl/string/format.hpp"
+#include "game/actions/preconditions.hpp"
+#include "game/game.hpp"
+#include "game/map/anyplanettype.hpp"
+#include "game/map/anyshiptype.hpp"
+#include "game/map/universe.hpp"
+#include "game/turn.hpp"
+#include "server/play/changetracker.hpp"
+#include "server/play/deferredvalue.hpp"
+#include "server/play/planetpacker.hpp"
+#include "server/play/shippacker.hpp"
+
+using afl::base::Ref;
+using afl::container::PtrVector;
+using afl::data::Hash;
+using afl::data::HashValue;
+using server::play::DeferredValue;
+
+/*
+ *  Builder: produces the value for a single modified object
+ */
+
+class server::play::ChangesPacker::Builder : public DeferredValue::Builder {
+ public:
+    PtrVector<Packer>& packers()
+        { return m_packers; }
+
+    // DeferredValue::Builder:
+    virtual Value_t* build(size_t index) const
+        { return m_packers[index]->buildValue(); }
+
+ private:
+    PtrVector<Packer> m_packers;
+};
+
+server::play::ChangesPacker::ChangesPacker(game::Session& session, int32_t epoch, int32_t generation)
+    : m_session(session),
+      m_epoch(epoch),
+      m_generation(generation)
+{ }
+
+server::Value_t*
+server::play::ChangesPacker::buildValue() const
+{
+    PtrVector<Packer> packers;
+    int32_t epoch;
+    int32_t generation = collectPackers(packers, epoch);
+
+    Ref<Hash> objects = Hash::create();
+    for (size_t i = 0, n = packers.size(); i < n; ++i) {
+        objects->setNew(packers[i]->getName(), packers[i]->buildValue());
+    }
+
+    Ref<Hash> hv = Hash::create();
+    hv->setNew("EPOCH", makeIntegerValue(epoch));
+    hv->setNew("GENERATION", makeIntegerValue(generation));
+    hv->setNew("OBJ", new HashValue(objects));
+    return new HashValue(hv);
+}
+
+server::Value_t*
+server::play::ChangesPacker::buildDeferredValue() const
+{
+    Builder* b = new Builder();
+    Ref<DeferredValue::Builder> ref(*b);
+    int32_t epoch;
+    int32_t generation = collectPackers(b->packers(), epoch);
+
+    Ref<Hash> objects = Hash::create();
+    for (size_t i = 0, n = b->packers().size(); i < n; ++i) {
+        objects->setNew(b->packers()[i]->getName(), new DeferredValue(ref, i));
+    }
+
+    Ref<Hash> hv = Hash::create();
+    hv->setNew("EPOCH", makeIntegerValue(epoch));
+    hv->setNew("GENERATION", makeIntegerValue(generation));
+    hv->setNew("OBJ", new HashValue(objects));
+    return new HashValue(hv);
+}
+
+String_t
+server::play::ChangesPacker::getName() const
+{
+    if (m_epoch == 0) {
+        return afl::string::Format("changes%d", m_generation);
+    } else {
+        return afl::string::Format("changes%d.%d", m_epoch, m_generation);
+    }
+}
+
+/* Process changes and create packers for all modified objects.
+   Returns the current generation; produces the current epoch. */
+int32_t
+server::play::ChangesPacker::collectPackers(afl::container::PtrVector<Packer>& packers, int32_t& epoch) const
+{
+    game::Game& g = game::actions::mustHaveGame(m_session);
+    game::map::Universe& univ = g.currentTurn().universe();
+
+    ChangeTracker& tracker = ChangeTracker::create(m_session);
+    int32_t generation = tracker.update();
+    epoch = tracker.getEpoch();
+
+    game::map::AnyShipType& ships = univ.allShips();
+    for (game::Id_t i = ships.findNextIndex(0); i != 0; i = ships.findNextIndex(i)) {
+        if (tracker.isShipModifiedSince(i, m_epoch, m_generation)) {
+            packers.pushBackNew(new ShipPacker(m_session, i));
+        }
+    }
+
+    game::map::AnyPlanetType& planets = univ.allPlanets();
+    for (game::Id_t i = planets.findNextIndex(0); i != 0; i = planets.findNextIndex(i)) {
+        if (tracker.isPlanetModifiedSince(i, m_epoch, m_generation)) {
+            packers.pushBackNew(new PlanetPacker(m_session, i));
+        }
+    }
+    return generation;
+}
@@ -0,0 +1,48 @@
+/**
+  *  \file server/play/changespacker.hpp
+  *  \brief Class server::play::ChangesPacker
+  */
+#ifndef C2NG_SERVER_PLAY_CHANGESPACKER_HPP
+#define C2NG_SERVER_PLAY_CHANGESPACKER_HPP
+
+#include "afl/container/ptrvector.hpp"
+#include "game/session.hpp"
+#include "server/play/packer.hpp"
+
+namespace server { namespace play {
+
+    /** Packer for "query/changesE.N".
+        Publishes all ships and planets modified since generation N of epoch E, see ChangeTracker.
+        The result is a hash containing
+        - EPOCH: the epoch, to be used for the next query
+        - GENERATION: the current generation, to be used for the next query
+        - OBJ: a hash of objects, using the same names and content as "obj/shipN" and "obj/planetN"
+
+        If E does not match the current epoch (e.g. because the server process has been restarted),
+        all ships and planets are produced.
+        Without epoch ("query/changesN"), all ships and planets are produced, too. */
+    class ChangesPacker : public Packer {
+     public:
+        /** Constructor.
+            \param session Session
+            \param epoch Epoch known to the client; 0 if none
+            \param generation Generation known to the client */
+        ChangesPacker(game::Session& session, int32_t epoch, int32_t generation);
+
+        // Packer:
+        Value_t* buildValue() const;
+        Value_t* buildDeferredValue() const;
+        String_t getName() const;
+
+     private:
+        class Builder;
+        game::Session& m_session;
+        int32_t m_epoch;
+        int32_t m_generation;
+
+        int32_t collectPackers(afl::container::PtrVector<Packer>& packers, int32_t& epoch) const;
+    };
+
+} }
+
+#endif
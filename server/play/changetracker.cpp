@@ -0,0 +1,221 @@
+/**
+  *  \file server/play/changetracker.cpp
+  *  \brief Class server::play::ChangeTracker
+  */
+
+#include "server/play/changetracker.hpp"
+#include "afl/sys/time.hpp"
+#include "game/extraidentifier.hpp"
+#include "game/game.hpp"
+#include "game/map/anyplanettype.hpp"
+#include "game/map/anyshiptype.hpp"
+#include "game/map/ship.hpp"
+#include "game/map/universe.hpp"
+#include "game/turn.hpp"
+#include "util/randomnumbergenerator.hpp"
+
+using game::Id_t;
+using game::map::MovementPredictor;
+using game::map::Ship;
+using game::map::Universe;
+using server::play::ChangeTracker;
+
+namespace {
+    // Extra Identifier
+    const game::ExtraIdentifier<game::Session, ChangeTracker> CHANGE_ID = {{}};
+
+    /* Make an epoch for a ChangeTracker.
+       Random (seeded from the current time), so that a restarted process does not accept
+       generations that a client knows from a previous process. Positive, never 0. */
+    int32_t makeEpoch()
+    {
+        util::RandomNumberGenerator rng(static_cast<uint32_t>(afl::sys::Time::getCurrentTime().getUnixTime()) ^ afl::sys::Time::getTickCounter());
+        int32_t result;
+        do {
+            result = (int32_t(rng() & 0x7FFF) << 16) | int32_t(rng());
+        } while (result == 0);
+        return result;
+    }
+
+    /* Shortcut to retrieve the universe from a session */
+    Universe* getUniverse(game::Session& session)
+    {
+        if (game::Game* g = session.getGame().get()) {
+            return &g->currentTurn().universe();
+        }
+        return 0;
+    }
+
+    /* Record an object's generation */
+    void setGeneration(std::vector<int32_t>& generations, Id_t id, int32_t generation)
+    {
+        if (size_t(id) >= generations.size()) {
+            generations.resize(id+1);
+        }
+        generations[id] = generation;
+    }
+
+    /* Record dirty objects of an ObjectType with the given generation.
+       This visits the same objects as ObjectType::notifyObjectListeners().
+       Returns true if any object was dirty. */
+    bool recordChanges(game::map::ObjectType& ty, std::vector<int32_t>& generations, int32_t generation)
+    {
+        bool result = false;
+        for (Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
+            const game::map::Object* obj = ty.getObjectByIndex(i);
+            if (obj != 0 && obj->isDirty()) {
+                setGeneration(generations, i, generation);
+                result = true;
+            }
+        }
+        return result;
+    }
+}
+
+server::play::ChangeTracker::ChangeTracker(game::Session& session)
+    : m_session(session),
+      m_epoch(makeEpoch()),
+      m_generation(0),
+      m_baseGeneration(0),
+      m_shipGenerations(),
+      m_planetGenerations(),
+      m_shipLinks(),
+      conn_connectionChange(session.sig_connectionChange.add(this, &ChangeTracker::onConnectionChange)),
+      conn_preUpdate()
+{
+    onConnectionChange();
+}
+
+server::play::ChangeTracker::~ChangeTracker()
+{ }
+
+server::play::ChangeTracker&
+server::play::ChangeTracker::create(game::Session& session)
+{
+    ChangeTracker* p = session.extra().get(CHANGE_ID);
+    if (p == 0) {
+        p = session.extra().setNew(CHANGE_ID, new ChangeTracker(session));
+    }
+    return *p;
+}
+
+int32_t
+server::play::ChangeTracker::update()
+{
+    // This will call onPreUpdate()
+    m_session.notifyListeners();
+    return m_generation;
+}
+
+int32_t
+server::play::ChangeTracker::getGeneration() const
+{
+    return m_generation;
+}
+
+int32_t
+server::play::ChangeTracker::getEpoch() const
+{
+    return m_epoch;
+}
+
+bool
+server::play::ChangeTracker::isShipModifiedSince(game::Id_t id, int32_t epoch, int32_t generation) const
+{
+    return isModifiedSince(m_shipGenerations, id, epoch, generation);
+}
+
+bool
+server::play::ChangeTracker::isPlanetModifiedSince(game::Id_t id, int32_t epoch, int32_t generation) const
+{
+    return isModifiedSince(m_planetGenerations, id, epoch, generation);
+}
+
+/** Session: connection change.
+    Hook the universe and start a new base generation. */
+void
+server::play::ChangeTracker::onConnectionChange()
+{
+    if (Universe* u = getUniverse(m_session)) {
+        conn_preUpdate = u->sig_preUpdate.add(this, &ChangeTracker::onPreUpdate);
+    } else {
+        conn_preUpdate.disconnect();
+    }
+    ++m_generation;
+    m_baseGeneration = m_generation;
+    m_shipGenerations.clear();
+    m_planetGenerations.clear();
+    m_shipLinks.clear();
+    if (Universe* u = getUniverse(m_session)) {
+        // Remember tow/intercept links; every ship counts as modified relative to older generations anyway
+        recordShipChanges(*u, m_generation);
+    }
+}
+
+/** Universe: before update.
+    Collect dirty bits; they are reset afterwards.
+    All objects modified since the last update share a new generation. */
+void
+server::play::ChangeTracker::onPreUpdate()
+{
+    if (Universe* u = getUniverse(m_session)) {
+        const int32_t next = m_generation + 1;
+        bool changed = recordShipChanges(*u, next);
+        changed |= recordChanges(u->allPlanets(), m_planetGenerations, next);
+        if (changed) {
+            m_generation = next;
+        }
+    }
+}
+
+/** Record modified ships with the given generation.
+    A ship counts as modified if it is dirty, orbits a dirty planet,
+    or tows or intercepts (directly or indirectly) such a ship, or is towed or intercepted by one.
+    Also remembers the ships' tow and intercept targets for the next call.
+    \param univ Universe
+    \param generation Generation to assign
+    \return true if any ship was modified */
+bool
+server::play::ChangeTracker::recordShipChanges(game::map::Universe& univ, int32_t generation)
+{
+    // Changed ships and ships depending on them, using previous and current links
+    std::vector<Id_t> changedShips;
+    MovementPredictor::findChangedShips(univ, changedShips);
+
+    std::vector<Id_t> affectedShips;
+    MovementPredictor::collectAffectedShips(univ, m_shipLinks, changedShips, affectedShips);
+
+    // Remember links for next call
+    game::map::AnyShipType& ty = univ.allShips();
+    m_shipLinks.clear();
+    m_shipLinks.resize(univ.ships().size()+1);
+    for (Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
+        if (const Ship* sh = ty.getObjectByIndex(i)) {
+            m_shipLinks[i] = MovementPredictor::getShipLinks(*sh);
+        }
+    }
+
+    // Record ships
+    bool result = false;
+    for (size_t index = 0, n = affectedShips.size(); index < n; ++index) {
+        const Id_t i = affectedShips[index];
+        if (ty.getObjectByIndex(i) != 0) {
+            setGeneration(m_shipGenerations, i, generation);
+            result = true;
+        }
+    }
+    return result;
+}
+
+bool
+server::play::ChangeTracker::isModifiedSince(const std::vector<int32_t>& generations, game::Id_t id, int32_t epoch, int32_t generation) const
+{
+    if (epoch != m_epoch || generation < m_baseGeneration || generation > m_generation) {
+        // Generation not from this tracker, or from before the last reset
+        return true;
+    } else {
+        size_t index = static_cast<size_t>(id);
+        return index < generations.size()
+            && generations[index] > generation;
+    }
+}
@@ -0,0 +1,107 @@
+/**
+  *  \file server/play/changetracker.hpp
+  *  \brief Class server::play::ChangeTracker
+  */
+#ifndef C2NG_SERVER_PLAY_CHANGETRACKER_HPP
+#define C2NG_SERVER_PLAY_CHANGETRACKER_HPP
+
+#include <vector>
+#include "afl/base/signalconnection.hpp"
+#include "game/extra.hpp"
+#include "game/map/movementpredictor.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+
+namespace server { namespace play {
+
+    /** Change tracker.
+        This is a Session extra that assigns modification generations to ships and planets,
+        using the objects' change tracking (game::map::Object::isDirty()).
+        A client that has seen generation N can ask for the objects modified since,
+        instead of fetching everything again.
+
+        A ship's published data includes its movement prediction (MOVE.ETA, MOVE.FUEL),
+        which also depends on ships it tows or intercepts, ships towing or intercepting it,
+        and starbase missions of the planet it orbits.
+        Like game::map::MovementPredictor::updateMovement(), we therefore use MovementPredictor::collectAffectedShips()
+        to treat ships that tow or intercept each other (before or after the change) as a group,
+        and assign a new generation to the whole group if any member is modified or orbits a modified planet.
+
+        Generations are only meaningful within the ChangeTracker that produced them.
+        Because a client may keep its generation across a restart of the server process,
+        each ChangeTracker has a random epoch that the client must present together with the generation;
+        relative to a generation from a different epoch, all objects count as modified.
+        Within an epoch, a change of game starts a new base generation; all objects count as modified relative to older generations.
+        A generation that is newer than the current one cannot have been produced by this tracker;
+        relative to such a generation, all objects count as modified, too.
+
+        Use create() to obtain the instance, update() to process changes. */
+    class ChangeTracker : public game::Extra {
+     public:
+        /** Destructor. */
+        ~ChangeTracker();
+
+        /** Create ChangeTracker for a Session.
+            If the Session already has one, returns that, otherwise, creates one.
+            \param session Session
+            \return ChangeTracker */
+        static ChangeTracker& create(game::Session& session);
+
+        /** Process changes.
+            Announces pending changes (Session::notifyListeners()), which assigns a new generation to all modified objects.
+            \return current generation */
+        int32_t update();
+
+        /** Get current generation.
+            \return generation */
+        int32_t getGeneration() const;
+
+        /** Get epoch.
+            Identifies this ChangeTracker; generations are only valid together with their epoch.
+            \return epoch, never 0 */
+        int32_t getEpoch() const;
+
+        /** Check whether a ship has been modified since a generation.
+            \param id Ship Id
+            \param epoch Epoch known to the client
+            \param generation Generation known to the client
+            \return true if ship has been modified */
+        bool isShipModifiedSince(game::Id_t id, int32_t epoch, int32_t generation) const;
+
+        /** Check whether a planet has been modified since a generation.
+            \param id Planet Id
+            \param epoch Epoch known to the client
+            \param generation Generation known to the client
+            \return true if planet has been modified */
+        bool isPlanetModifiedSince(game::Id_t id, int32_t epoch, int32_t generation) const;
+
+     private:
+        /** Constructor.
+            \param session Session
+            \see create() */
+        explicit ChangeTracker(game::Session& session);
+
+        // Events
+        void onConnectionChange();
+        void onPreUpdate();
+
+        bool recordShipChanges(game::map::Universe& univ, int32_t generation);
+        bool isModifiedSince(const std::vector<int32_t>& generations, game::Id_t id, int32_t epoch, int32_t generation) const;
+
+        // Data
+        game::Session& m_session;                   ///< Session link.
+        const int32_t m_epoch;                      ///< Epoch.
+        int32_t m_generation;                       ///< Current generation.
+        int32_t m_baseGeneration;                   ///< Generation of last reset; every object is at least this new.
+        std::vector<int32_t> m_shipGenerations;     ///< Generation of last modification, indexed by ship Id.
+        std::vector<int32_t> m_planetGenerations;   ///< Generation of last modification, indexed by planet Id.
+        std::vector<game::map::MovementPredictor::Links> m_shipLinks;  ///< Tow and intercept targets as of last update, indexed by ship Id.
+
+        // Signal connections
+        afl::base::SignalConnection conn_connectionChange;
+        afl::base::SignalConnection conn_preUpdate;
+    };
+
+} }
+
+#endif
@@ -2,18 +2,26 @@
   *  \file server/play/consoleapplication.cpp
   */
 
+#include <algorithm>
 #include "server/play/consoleapplication.hpp"
+#include "afl/base/vectorenumerator.hpp"
 #include "afl/charset/charset.hpp"
 #include "afl/charset/codepage.hpp"
 #include "afl/charset/codepagecharset.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/writer.hpp"
 #include "afl/net/line/linesink.hpp"
 #include "afl/net/url.hpp"
 #include "afl/string/char.hpp"
 #include "afl/string/format.hpp"
 #include "afl/string/parse.hpp"
 #include "afl/sys/standardcommandlineparser.hpp"
+#include "afl/sys/time.hpp"
 #include "game/game.hpp"
 #include "game/limits.hpp"
+#include "game/map/anyplanettype.hpp"
+#include "game/map/anyshiptype.hpp"
+#include "game/map/universe.hpp"
 #include "game/session.hpp"
 #include "game/specificationloader.hpp"
 #include "game/turn.hpp"
@@ -32,6 +40,10 @@
 #include "util/translator.hpp"
 #include "version.hpp"
 
+#ifdef MALLOC_STATS
+# include <malloc.h>
+#endif
+
 using afl::base::Optional;
 using afl::charset::Charset;
 using afl::string::Format;
@@ -58,12 +70,15 @@ struct server::play::ConsoleApplication::Parameters {
     Optional<String_t> arg_gamedir;  // -G
     Optional<String_t> arg_rootdir;  // -R
     Optional<String_t> arg_language; // --language
+    Optional<int> arg_benchmark;     // --benchmark
     std::auto_ptr<Charset> gameCharset;
     int playerNumber;
 
     Parameters()
         : arg_gamedir(),
           arg_rootdir(),
+          arg_language(),
+          arg_benchmark(),
           gameCharset(new afl::charset::CodepageCharset(afl::charset::g_codepageLatin1)),
           playerNumber(0)
         { }
@@ -87,52 +102,25 @@ server::play::ConsoleApplication::appMain()
     Parameters params;
 
     // Parser
+    afl::base::Ref<afl::io::TextReader> reader = environment().attachTextReader(afl::sys::Environment::Input);
     afl::sys::StandardCommandLineParser commandLine(environment().getCommandLine());
-    String_t p;
-    bool opt;
-    while (commandLine.getNext(opt, p)) {
-        if (opt) {
-            if (p == "h" || p == "help") {
-                help();
-            } else if (p == "C") {
-                // character set
-                if (Charset* cs = util::CharsetFactory().createCharset(commandLine.getRequiredParameter(p))) {
-                    params.gameCharset.reset(cs);
-                } else {
-                    errorExit(tx("the specified character set is not known"));
-                }
-            } else if (p == "R" || p == "W") {
-                // session conflict management; skip those
-                commandLine.getRequiredParameter(p);
-            } else if (p == "D") {
-                // property
-                String_t key = commandLine.getRequiredParameter(p);
-                String_t value;
-                String_t::size_type eq = key.find('=');
-                if (eq != String_t::npos) {
-                    value.assign(key, eq+1, String_t::npos);
-                    key.erase(eq);
-                }
-                m_properties[key] = value;
-            } else if (p == "language") {
-                params.arg_language = commandLine.getRequiredParameter(p);
-            } else {
-                errorExit(Format(tx("invalid option '%s' specified. Use '%s -h' for help."), p, environment().getInvocationName()));
-            }
-        } else {
-            int n;
-            if (afl::string::strToInteger(p, n) && n > 0 && n <= game::MAX_PLAYERS) {
-                if (params.playerNumber != 0) {
-                    errorExit(tx("only one player number allowed"));
-                }
-                params.playerNumber = n;
-            } else if (!params.arg_gamedir.isValid()) {
-                params.arg_gamedir = p;
-            } else if (!params.arg_rootdir.isValid()) {
-                params.arg_rootdir = p;
-            } else {
-                errorExit(tx("too many arguments"));
-            }
+    if (parseParameters(commandLine, params)) {
+        // Wait mode: c2router-server pre-starts us and sends the actual parameters later,
+        // one per line, terminated by an empty line. Closing the input means we are not needed.
+        afl::base::Ref<afl::base::VectorEnumerator<String_t> > args = *new afl::base::VectorEnumerator<String_t>();
+        String_t line;
+        bool any = false;
+        while (reader->readLine(line) && !line.empty()) {
+            args->add(line);
+            any = true;
+        }
+        if (!any) {
+            exit(0);
+        }
+
+        afl::sys::StandardCommandLineParser waitCommandLine(args);
+        if (parseParameters(waitCommandLine, params)) {
+            errorExit(tx("option '--wait' cannot be nested"));
         }
     }
 
@@ -196,6 +184,12 @@ server::play::ConsoleApplication::appMain()
     // Store properties in session
     getSessionProperties(session) = m_properties;
 
+    // Benchmark mode: no interaction, nothing saved
+    if (const int* n = params.arg_benchmark.get()) {
+        runBenchmark(session, logCollector, *n);
+        return;
+    }
+
     // Interact
     class Sink : public afl::net::line::LineSink {
      public:
@@ -208,8 +202,6 @@ server::play::ConsoleApplication::appMain()
         afl::io::TextWriter& m_out;
     };
 
-    afl::base::Ref<afl::io::TextReader> reader = environment().attachTextReader(afl::sys::Environment::Input);
-
     Sink sink(standardOutput());
     GameAccess impl(session, logCollector);
     server::interface::GameAccessServer server(impl);
@@ -228,6 +220,72 @@ server::play::ConsoleApplication::appMain()
     impl.save();
 }
 
+/* Parse command line parameters.
+   Returns true if "--wait" was given. */
+bool
+server::play::ConsoleApplication::parseParameters(afl::sys::CommandLineParser& commandLine, Parameters& params)
+{
+    afl::string::Translator& tx = translator();
+    bool wait = false;
+    String_t p;
+    bool opt;
+    while (commandLine.getNext(opt, p)) {
+        if (opt) {
+            if (p == "h" || p == "help") {
+                help();
+            } else if (p == "C") {
+                // character set
+                if (Charset* cs = util::CharsetFactory().createCharset(commandLine.getRequiredParameter(p))) {
+                    params.gameCharset.reset(cs);
+                } else {
+                    errorExit(tx("the specified character set is not known"));
+                }
+            } else if (p == "R" || p == "W") {
+                // session conflict management; skip those
+                commandLine.getRequiredParameter(p);
+            } else if (p == "D") {
+                // property
+                String_t key = commandLine.getRequiredParameter(p);
+                String_t value;
+                String_t::size_type eq = key.find('=');
+                if (eq != String_t::npos) {
+                    value.assign(key, eq+1, String_t::npos);
+                    key.erase(eq);
+                }
+                m_properties[key] = value;
+            } else if (p == "language") {
+                params.arg_language = commandLine.getRequiredParameter(p);
+            } else if (p == "wait") {
+                wait = true;
+            } else if (p == "benchmark") {
+                String_t param = commandLine.getRequiredParameter(p);
+                int n = 0;
+                if (!afl::string::strToInteger(param, n) || n <= 0) {
+                    errorExit(Format(tx("invalid number of requests, '%s'"), param));
+                }
+                params.arg_benchmark = n;
+            } else {
+                errorExit(Format(tx("invalid option '%s' specified. Use '%s -h' for help."), p, environment().getInvocationName()));
+            }
+        } else {
+            int n;
+            if (afl::string::strToInteger(p, n) && n > 0 && n <= game::MAX_PLAYERS) {
+                if (params.playerNumber != 0) {
+                    errorExit(tx("only one player number allowed"));
+                }
+                params.playerNumber = n;
+            } else if (!params.arg_gamedir.isValid()) {
+                params.arg_gamedir = p;
+            } else if (!params.arg_rootdir.isValid()) {
+                params.arg_rootdir = p;
+            } else {
+                errorExit(tx("too many arguments"));
+            }
+        }
+    }
+    return wait;
+}
+
 void
 server::play::ConsoleApplication::help()
 {
@@ -237,7 +295,9 @@ server::play::ConsoleApplication::help()
                                "-Ccs\tSet game character set\n"
                                "-Rkey, -Wkey\tIgnored; used for session conflict resolution\n"
                                "-Dkey=value\tDefine a property\n"
-                               "--language=CODE\tLanguage to use for game\n"));
+                               "--language=CODE\tLanguage to use for game\n"
+                               "--benchmark=N\tRetrieve all objects N times and report the time taken\n"
+                               "--wait\tRead parameters from standard input\n"));
 
     afl::io::TextWriter& out = standardOutput();
     out.writeLine(Format(tx("PCC2 Play Server v%s - (c) 2019-2025 Stefan Reuther").c_str(), PCC2_VERSION));
@@ -283,3 +343,56 @@ server::play::ConsoleApplication::loadRoot(const String_t& gameDir, const Parame
     afl::base::Ref<const game::config::UserConfiguration> uc = game::config::UserConfiguration::create();
     return loader.load(fs.openDirectory(gameDir), *params.gameCharset, *uc, false);
 }
+
+/* Benchmark: retrieve all objects as JSON, as a client would do for a full-universe view, and report the time taken. */
+void
+server::play::ConsoleApplication::runBenchmark(game::Session& session, util::MessageCollector& console, int count)
+{
+    afl::string::Translator& tx = translator();
+    game::map::Universe& univ = session.getGame()->currentTurn().universe();
+
+    // Build request
+    String_t objName = "obj/main,player,shipxy,planetxy,zstorm,zmine,zufo,beam,torp,engine,truehull";
+    int numObjects = 11;
+    game::map::AnyShipType& ships = univ.allShips();
+    for (game::Id_t i = ships.findNextIndex(0); i != 0; i = ships.findNextIndex(i)) {
+        objName += Format(",ship%d", i);
+        ++numObjects;
+    }
+    game::map::AnyPlanetType& planets = univ.allPlanets();
+    for (game::Id_t i = planets.findNextIndex(0); i != 0; i = planets.findNextIndex(i)) {
+        objName += Format(",planet%d", i);
+        ++numObjects;
+    }
+
+    // Run it
+    GameAccess impl(session, console);
+    const uint32_t startTime = afl::sys::Time::getTickCounter();
+    for (int i = 0; i < count; ++i) {
+        std::auto_ptr<Value_t> result(impl.getDeferred(objName));
+        afl::io::InternalSink sink;
+        afl::io::json::Writer writer(sink);
+        writer.setLineLength(80);
+        writer.visit(result.get());
+    }
+    const uint32_t elapsed = std::max(afl::sys::Time::getTickCounter() - startTime, uint32_t(1));
+
+    standardOutput().writeLine(Format(tx("%d request%!1{s%} for %d objects in %d ms, %.1f ms/request"),
+                                      count, numObjects, elapsed, double(elapsed) / count));
+
+#ifdef MALLOC_STATS
+    // Heap used by the result value of one request, before serializing it:
+    // complete tree (get()) vs. deferred elements (getDeferred(), plus one object at a time while serializing).
+    int prevMem = mallinfo().uordblks;
+    std::auto_ptr<Value_t> tree(impl.get(objName));
+    int treeMem = mallinfo().uordblks - prevMem;
+    tree.reset();
+
+    prevMem = mallinfo().uordblks;
+    std::auto_ptr<Value_t> deferred(impl.getDeferred(objName));
+    int deferredMem = mallinfo().uordblks - prevMem;
+    deferred.reset();
+
+    standardOutput().writeLine(Format("malloc: tree %d [%dk], deferred %d [%dk]", treeMem, treeMem / 1024, deferredMem, deferredMem / 1024));
+#endif
+}
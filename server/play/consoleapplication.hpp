@@ -8,8 +8,11 @@
 #include "afl/base/ptr.hpp"
 #include "afl/io/nullfilesystem.hpp"
 #include "afl/net/networkstack.hpp"
+#include "afl/sys/commandlineparser.hpp"
 #include "game/root.hpp"
+#include "game/session.hpp"
 #include "util/application.hpp"
+#include "util/messagecollector.hpp"
 
 namespace server { namespace play {
 
@@ -23,12 +26,14 @@ namespace server { namespace play {
         struct Parameters;
 
         void help();
+        bool parseParameters(afl::sys::CommandLineParser& commandLine, Parameters& params);
 
         afl::net::NetworkStack& m_network;
         std::map<String_t, String_t> m_properties;
         afl::io::NullFileSystem m_nullFileSystem;
 
         afl::base::Ptr<game::Root> loadRoot(const String_t& gameDir, const Parameters& params, afl::sys::LogListener& log);
+        void runBenchmark(game::Session& session, util::MessageCollector& console, int count);
     };
 
 } }
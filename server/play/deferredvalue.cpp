@@ -0,0 +1,29 @@
+/**
+  *  \file server/play/deferredvalue.cpp
+  *  \brief Class server::play::DeferredValue
+  */
+
+#include <memory>
+#include "server/play/deferredvalue.hpp"
+#include "afl/data/visitor.hpp"
+
+server::play::DeferredValue::DeferredValue(afl::base::Ref<Builder> builder, size_t index)
+    : m_builder(builder),
+      m_index(index)
+{ }
+
+server::play::DeferredValue::~DeferredValue()
+{ }
+
+void
+server::play::DeferredValue::visit(afl::data::Visitor& visitor) const
+{
+    std::auto_ptr<Value_t> value(m_builder->build(m_index));
+    visitor.visit(value.get());
+}
+
+server::play::DeferredValue*
+server::play::DeferredValue::clone() const
+{
+    return new DeferredValue(m_builder, m_index);
+}
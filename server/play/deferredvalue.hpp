@@ -0,0 +1,58 @@
+/**
+  *  \file server/play/deferredvalue.hpp
+  *  \brief Class server::play::DeferredValue
+  */
+#ifndef C2NG_SERVER_PLAY_DEFERREDVALUE_HPP
+#define C2NG_SERVER_PLAY_DEFERREDVALUE_HPP
+
+#include "afl/base/deletable.hpp"
+#include "afl/base/ref.hpp"
+#include "afl/base/refcounted.hpp"
+#include "afl/data/value.hpp"
+#include "server/types.hpp"
+
+namespace server { namespace play {
+
+    /** Value that is built when visited.
+        Stands in for an element of a large result (e.g. one ship of "obj/shipxy").
+        When visited, it builds the actual element using a Builder, visits that, and discards it again.
+        Serializing a tree of DeferredValue elements with afl::io::json::Writer therefore produces
+        the same output as serializing the fully-built tree,
+        but only one element needs to exist at any time.
+
+        A DeferredValue can only be visited; it does not reveal its content to
+        dynamic_cast-based inspection (afl::data::Access).
+        Its Builder typically refers to game objects,
+        so it must be serialized before the game is modified. */
+    class DeferredValue : public afl::data::Value {
+     public:
+        /** Element builder.
+            Shared by all elements of a result. */
+        class Builder : public afl::base::RefCounted, public afl::base::Deletable {
+         public:
+            /** Build an element.
+                \param index Index of element, as given to DeferredValue constructor
+                \return newly-allocated value; may be null */
+            virtual Value_t* build(size_t index) const = 0;
+        };
+
+        /** Constructor.
+            \param builder Builder
+            \param index   Index of element to build */
+        DeferredValue(afl::base::Ref<Builder> builder, size_t index);
+
+        /** Destructor. */
+        ~DeferredValue();
+
+        // Value:
+        virtual void visit(afl::data::Visitor& visitor) const;
+        virtual DeferredValue* clone() const;
+
+     private:
+        afl::base::Ref<Builder> m_builder;
+        size_t m_index;
+    };
+
+} }
+
+#endif
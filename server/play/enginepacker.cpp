@@ -11,6 +11,25 @@
 #include "game/interface/enginecontext.hpp"
 #include "game/spec/shiplist.hpp"
 #include "game/spec/engine.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property COST_PROPERTIES[] = {
+        { "COST.D",  "D" },
+        { "COST.M",  "M" },
+        { "COST.MC", "MC" },
+        { "COST.T",  "T" },
+    };
+
+    const PackerSchema::Property ENGINE_PROPERTIES[] = {
+        { "NAME",       "NAME" },
+        { "NAME.SHORT", "NAME.SHORT" },
+        { "SPEED$",     "SPEED" },
+        { "TECH",       "TECH" },
+    };
+}
 
 server::play::EnginePacker::EnginePacker(game::spec::ShipList& shipList, int firstSlot)
     : m_shipList(shipList), m_firstSlot(firstSlot)
@@ -21,6 +40,8 @@ server::play::EnginePacker::buildValue() const
 {
     // ex ServerEngineWriter::write
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    PackerSchema costSchema(COST_PROPERTIES, 0);
+    PackerSchema schema(ENGINE_PROPERTIES, 0);
     for (int i = m_firstSlot, n = m_shipList.engines().size(); i <= n; ++i) {
         if (const game::spec::Engine* p = m_shipList.engines().get(i)) {
             afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
@@ -28,10 +49,7 @@ server::play::EnginePacker::buildValue() const
 
             // Cost
             afl::base::Ref<afl::data::Hash> cost(afl::data::Hash::create());
-            addValue(*cost, ctx, "COST.D", "D");
-            addValue(*cost, ctx, "COST.M", "M");
-            addValue(*cost, ctx, "COST.MC", "MC");
-            addValue(*cost, ctx, "COST.T", "T");
+            costSchema.pack(*cost, ctx);
             addValueNew(*hv, new afl::data::HashValue(cost), "COST");
 
             // Fuel
@@ -47,10 +65,7 @@ server::play::EnginePacker::buildValue() const
             addValueNew(*hv, new afl::data::VectorValue(ff), "FUELFACTOR");
 
             // Remainder
-            addValue(*hv, ctx, "NAME", "NAME");
-            addValue(*hv, ctx, "NAME.SHORT", "NAME.SHORT");
-            addValue(*hv, ctx, "SPEED$", "SPEED");
-            addValue(*hv, ctx, "TECH", "TECH");
+            schema.pack(*hv, ctx);
             vv->pushBackNew(new afl::data::HashValue(hv));
         } else {
             vv->pushBackNew(0);
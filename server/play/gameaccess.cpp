@@ -12,6 +12,7 @@
 #include "server/errors.hpp"
 #include "server/play/basichullfunctionpacker.hpp"
 #include "server/play/beampacker.hpp"
+#include "server/play/changespacker.hpp"
 #include "server/play/commandhandler.hpp"
 #include "server/play/configurationpacker.hpp"
 #include "server/play/enginepacker.hpp"
@@ -96,19 +97,51 @@ server::play::GameAccess::getStatus()
 
 server::Value_t*
 server::play::GameAccess::get(String_t objName)
+{
+    PackerList packers;
+    collectObjects(objName, packers);
+    return packers.buildValue();
+}
+
+server::Value_t*
+server::play::GameAccess::post(String_t objName, const Value_t* value)
+{
+    PackerList result;
+    processCommands(objName, value, result);
+    return result.buildValue();
+}
+
+server::Value_t*
+server::play::GameAccess::getDeferred(String_t objName)
+{
+    PackerList packers;
+    collectObjects(objName, packers);
+    return packers.buildDeferredValue();
+}
+
+server::Value_t*
+server::play::GameAccess::postDeferred(String_t objName, const Value_t* value)
+{
+    PackerList result;
+    processCommands(objName, value, result);
+    return result.buildDeferredValue();
+}
+
+void
+server::play::GameAccess::collectObjects(String_t objName, PackerList& packers)
 {
     util::StringParser p(objName);
     if (p.parseString("obj/")) {
-        return getObject(p);
+        getObject(p, packers);
     } else if (p.parseString("query/")) {
-        return getQuery(p);
+        getQuery(p, packers);
     } else {
         throw std::runtime_error(ITEM_NOT_FOUND);
     }
 }
 
-server::Value_t*
-server::play::GameAccess::post(String_t objName, const Value_t* value)
+void
+server::play::GameAccess::processCommands(String_t objName, const Value_t* value, PackerList& result)
 {
     // ex doPostObject
     // Determine command handler
@@ -127,7 +160,6 @@ server::play::GameAccess::post(String_t objName, const Value_t* value)
     const afl::data::Vector& vec = *a->getValue();
 
     // Process individual commands.
-    PackerList result;
     for (size_t i = 0, n = vec.size(); i < n; ++i) {
         // Command must be an array.
         const afl::data::VectorValue* cmdValue = dynamic_cast<const afl::data::VectorValue*>(vec[i]);
@@ -147,17 +179,13 @@ server::play::GameAccess::post(String_t objName, const Value_t* value)
         // FIXME: PCC2 wraps this in a try/catch and generates '450 Failed'
         hdl->processCommand(verb, args, result);
     }
-
-    // Generate output
-    return result.buildValue();
 }
 
-server::Value_t*
-server::play::GameAccess::getObject(util::StringParser& p)
+void
+server::play::GameAccess::getObject(util::StringParser& p, PackerList& packers)
 {
     // ex server/getobj.cc:performGetObject
     // Collect objects
-    PackerList packers;
     bool fail = false;
 
     while (1) {
@@ -178,13 +206,10 @@ server::play::GameAccess::getObject(util::StringParser& p)
     if (fail || !p.parseEnd()) {
         throw std::runtime_error(ITEM_NOT_FOUND);
     }
-
-    // Generate output
-    return packers.buildValue();
 }
 
-server::Value_t*
-server::play::GameAccess::getQuery(util::StringParser& p)
+void
+server::play::GameAccess::getQuery(util::StringParser& p, PackerList& packers)
 {
     // Build the packer
     std::auto_ptr<Packer> thisPacker(createQueryPacker(p, m_session));
@@ -192,10 +217,8 @@ server::play::GameAccess::getQuery(util::StringParser& p)
         throw std::runtime_error(ITEM_NOT_FOUND);
     }
 
-    // Container for result. We only produce one result, but PackerList conveniently formats it.
-    PackerList packers;
+    // We only produce one result, but PackerList conveniently formats it.
     packers.addNew(thisPacker.release());
-    return packers.buildValue();
 }
 
 server::play::Packer*
@@ -302,6 +325,16 @@ server::play::GameAccess::createQueryPacker(util::StringParser& p, game::Session
         } else {
             return 0;
         }
+    } else if (p.parseString("changes")) {
+        if (!p.parseInt(n)) {
+            return 0;
+        } else if (!p.parseString(".")) {
+            return new ChangesPacker(session, 0, n);
+        } else if (p.parseInt(m)) {
+            return new ChangesPacker(session, n, m);
+        } else {
+            return 0;
+        }
     } else if (p.parseString("istat")) {
         if (p.parseInt(n) && p.parseString(".") && p.parseInt(m)) {
             return new ImperialStatsPacker(session, n, m);
@@ -14,6 +14,7 @@
 namespace server { namespace play {
 
     class Packer;
+    class PackerList;
     class CommandHandler;
 
     /** Implementation of GameAccess interface.
@@ -30,14 +31,18 @@ namespace server { namespace play {
         virtual String_t getStatus();
         virtual Value_t* get(String_t objName);
         virtual Value_t* post(String_t objName, const Value_t* value);
+        virtual Value_t* getDeferred(String_t objName);
+        virtual Value_t* postDeferred(String_t objName, const Value_t* value);
 
      private:
         game::Session& m_session;
         util::MessageCollector& m_console;
         util::MessageCollector::MessageNumber_t m_lastMessage;
 
-        Value_t* getObject(util::StringParser& p);
-        Value_t* getQuery(util::StringParser& p);
+        void collectObjects(String_t objName, PackerList& packers);
+        void processCommands(String_t objName, const Value_t* value, PackerList& result);
+        void getObject(util::StringParser& p, PackerList& packers);
+        void getQuery(util::StringParser& p, PackerList& packers);
 
         Packer* createPacker(util::StringParser& p);
         static Packer* createQueryPacker(util::StringParser& p, game::Session& session);
@@ -12,6 +12,23 @@
 #include "game/interface/ionstormcontext.hpp"
 #include "game/map/ionstormtype.hpp"
 #include "game/turn.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property IONSTORM_PROPERTIES[] = {
+        { "HEADING$", "HEADING" },
+        { "ID",       "ID" },
+        { "LOC.X",    "X" },
+        { "LOC.Y",    "Y" },
+        { "NAME",     "NAME" },
+        { "RADIUS",   "RADIUS" },
+        { "SPEED$",   "SPEED" },
+        { "STATUS$",  "STATUS" },
+        { "VOLTAGE",  "VOLTAGE" },
+    };
+}
 
 server::play::IonStormPacker::IonStormPacker(game::Session& session)
     : m_session(session)
@@ -24,19 +41,12 @@ server::play::IonStormPacker::buildValue() const
     game::Game& g = game::actions::mustHaveGame(m_session);
 
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    PackerSchema& schema = getPackerSchema(m_session, IONSTORM_PROPERTIES);
     game::map::IonStormType& ty = g.currentTurn().universe().ionStormType();
     for (game::Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
         afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
         game::interface::IonStormContext ctx(i, m_session, g.currentTurn());
-        addValue(*hv, ctx, "HEADING$", "HEADING");
-        addValue(*hv, ctx, "ID", "ID");
-        addValue(*hv, ctx, "LOC.X", "X");
-        addValue(*hv, ctx, "LOC.Y", "Y");
-        addValue(*hv, ctx, "NAME", "NAME");
-        addValue(*hv, ctx, "RADIUS", "RADIUS");
-        addValue(*hv, ctx, "SPEED$", "SPEED");
-        addValue(*hv, ctx, "STATUS$", "STATUS");
-        addValue(*hv, ctx, "VOLTAGE", "VOLTAGE");
+        schema.pack(*hv, ctx);
         vv->pushBackNew(new afl::data::HashValue(hv));
     }
     return new afl::data::VectorValue(vv);
@@ -12,6 +12,23 @@
 #include "game/interface/minefieldcontext.hpp"
 #include "game/map/minefieldtype.hpp"
 #include "game/turn.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property MINEFIELD_PROPERTIES[] = {
+        { "ID",       "ID" },
+        { "LASTSCAN", "LASTSCAN" },
+        { "LOC.X",    "X" },
+        { "LOC.Y",    "Y" },
+        { "OWNER$",   "OWNER" },
+        { "RADIUS",   "RADIUS" },
+        { "SCANNED",  "SCANNED" },
+        { "TYPE$",    "TYPE" },
+        { "UNITS",    "UNITS" },
+    };
+}
 
 server::play::MinefieldPacker::MinefieldPacker(game::Session& session)
     : m_session(session)
@@ -25,19 +42,12 @@ server::play::MinefieldPacker::buildValue() const
     game::Root& r = game::actions::mustHaveRoot(m_session);
 
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    PackerSchema& schema = getPackerSchema(m_session, MINEFIELD_PROPERTIES);
     game::map::MinefieldType& ty = g.currentTurn().universe().minefields();
     for (game::Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
         afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
         game::interface::MinefieldContext ctx(i, r, g, g.currentTurn(), m_session.translator());
-        addValue(*hv, ctx, "ID", "ID");
-        addValue(*hv, ctx, "LASTSCAN", "LASTSCAN");
-        addValue(*hv, ctx, "LOC.X", "X");
-        addValue(*hv, ctx, "LOC.Y", "Y");
-        addValue(*hv, ctx, "OWNER$", "OWNER");
-        addValue(*hv, ctx, "RADIUS", "RADIUS");
-        addValue(*hv, ctx, "SCANNED", "SCANNED");
-        addValue(*hv, ctx, "TYPE$", "TYPE");
-        addValue(*hv, ctx, "UNITS", "UNITS");
+        schema.pack(*hv, ctx);
         vv->pushBackNew(new afl::data::HashValue(hv));
     }
     return new afl::data::VectorValue(vv);
@@ -40,6 +40,13 @@ namespace {
     }
 }
 
+// Build value for serialisation.
+server::Value_t*
+server::play::Packer::buildDeferredValue() const
+{
+    return buildValue();
+}
+
 // Fetch value from Context and add to Hash.
 void
 server::play::Packer::addValue(afl::data::Hash& hv, interpreter::Context& ctx, const char* scriptName, const char* jsonName)
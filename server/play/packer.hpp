@@ -23,6 +23,18 @@ namespace server { namespace play {
             \return newly-allocated value */
         virtual Value_t* buildValue() const = 0;
 
+        /** Build value for serialisation.
+            Called after all actions have been performed, as an alternative to buildValue(),
+            if the result is only going to be serialized (e.g. as JSON).
+            Must produce a value that serializes identically to the result of buildValue().
+
+            The default implementation returns buildValue().
+            Packers that produce large values should override it to return
+            DeferredValue elements, so that the complete value never needs to exist as a tree.
+
+            \return newly-allocated value */
+        virtual Value_t* buildDeferredValue() const;
+
         /** Get name.
             Used as the hash key in the result sent to the client, and also for duplicate removal.
 
@@ -49,3 +49,14 @@ server::play::PackerList::buildValue() const
     }
     return new afl::data::HashValue(hv);
 }
+
+server::Value_t*
+server::play::PackerList::buildDeferredValue() const
+{
+    afl::base::Ref<afl::data::Hash> hv = afl::data::Hash::create();
+    for (size_t i = 0, n = m_packers.size(); i < n; ++i) {
+        String_t key = m_packers[i]->getName();
+        hv->setNew(key, m_packers[i]->buildDeferredValue());
+    }
+    return new afl::data::HashValue(hv);
+}
@@ -39,6 +39,12 @@ namespace server { namespace play {
             \return newly-allocated hash; caller takes ownership */
         Value_t* buildValue() const;
 
+        /** Build result value for serialisation.
+            Produces a hash with all the Packer's buildDeferredValue()s.
+            Serializes identically to buildValue(), see Packer::buildDeferredValue().
+            \return newly-allocated hash; caller takes ownership */
+        Value_t* buildDeferredValue() const;
+
      private:
         afl::container::PtrVector<Packer> m_packers;
     };
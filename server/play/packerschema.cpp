@@ -0,0 +1,80 @@
+/**
+  *  \file server/play/packerschema.cpp
+  *  \brief Class server::play::PackerSchema
+  */
+
+#include "server/play/packerschema.hpp"
+#include "afl/container/ptrmap.hpp"
+#include "game/extraidentifier.hpp"
+#include "server/play/packer.hpp"
+
+using interpreter::Context;
+using server::play::PackerSchema;
+
+namespace {
+    struct SchemaExtra : public game::Extra {
+        afl::container::PtrMap<const PackerSchema::Property*, PackerSchema> schemas;
+    };
+    const game::ExtraIdentifier<game::Session, SchemaExtra> SCHEMA_ID = {{}};
+}
+
+server::play::PackerSchema::PackerSchema(afl::base::Memory<const Property> properties, const interpreter::World* pWorld)
+    : m_properties(properties),
+      m_pWorld(pWorld),
+      m_entries(),
+      m_contextType(0),
+      m_numWorldNames(0)
+{ }
+
+server::play::PackerSchema::~PackerSchema()
+{ }
+
+void
+server::play::PackerSchema::pack(afl::data::Hash& hv, interpreter::Context& ctx)
+{
+    // Check cache
+    const size_t numWorldNames = (m_pWorld != 0 ? m_pWorld->getNumPropertyNames() : 0);
+    if (m_contextType == 0 || *m_contextType != typeid(ctx) || m_numWorldNames != numWorldNames) {
+        resolve(ctx, numWorldNames);
+    }
+
+    // Produce values
+    Context::PropertyAccessor* accessor = dynamic_cast<Context::PropertyAccessor*>(&ctx);
+    for (size_t i = 0, n = m_entries.size(); i < n; ++i) {
+        const Property& p = *m_properties.at(i);
+        const Entry& e = m_entries[i];
+        if (e.isDirect) {
+            Packer::addValueNew(hv, accessor->get(e.index), p.jsonName);
+        } else {
+            Packer::addValue(hv, ctx, p.scriptName, p.jsonName);
+        }
+    }
+}
+
+void
+server::play::PackerSchema::resolve(interpreter::Context& ctx, size_t numWorldNames)
+{
+    Context::PropertyAccessor* self = dynamic_cast<Context::PropertyAccessor*>(&ctx);
+
+    m_entries.clear();
+    for (size_t i = 0, n = m_properties.size(); i < n; ++i) {
+        Entry e;
+        e.index = 0;
+        e.isDirect = (self != 0 && ctx.lookup(m_properties.at(i)->scriptName, e.index) == self);
+        m_entries.push_back(e);
+    }
+    m_contextType = &typeid(ctx);
+    m_numWorldNames = numWorldNames;
+}
+
+server::play::PackerSchema&
+server::play::getPackerSchema(game::Session& session, afl::base::Memory<const PackerSchema::Property> properties)
+{
+    afl::container::PtrMap<const PackerSchema::Property*, PackerSchema>& schemas = session.extra().create(SCHEMA_ID).schemas;
+    afl::container::PtrMap<const PackerSchema::Property*, PackerSchema>::iterator it = schemas.find(properties.unsafeData());
+    if (it != schemas.end() && it->second != 0) {
+        return *it->second;
+    } else {
+        return *schemas.insertNew(properties.unsafeData(), new PackerSchema(properties, &session.world()));
+    }
+}
@@ -0,0 +1,79 @@
+/**
+  *  \file server/play/packerschema.hpp
+  *  \brief Class server::play::PackerSchema
+  */
+#ifndef C2NG_SERVER_PLAY_PACKERSCHEMA_HPP
+#define C2NG_SERVER_PLAY_PACKERSCHEMA_HPP
+
+#include <typeinfo>
+#include <vector>
+#include "afl/base/memory.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/data/hash.hpp"
+#include "game/session.hpp"
+#include "interpreter/context.hpp"
+#include "interpreter/world.hpp"
+
+namespace server { namespace play {
+
+    /** Packer schema.
+        Describes a list of properties to transfer from a Context into a Hash,
+        equivalent to a sequence of Packer::addValue() calls.
+
+        Resolving a property name means a lookup in the context's name tables.
+        PackerSchema resolves the names once, and then reads the properties by index for every further object.
+        The resolved indexes are re-validated when
+        - the context type changes (a schema is normally always used with the same context type);
+        - names are added to the World (which may shadow predefined properties).
+
+        Only properties that the context provides itself are read by index.
+        If a context delegates a name to another accessor (or does not know it at all),
+        that property is handled using Packer::addValue() for every object,
+        which will also produce the appropriate error. */
+    class PackerSchema : private afl::base::Uncopyable {
+     public:
+        /** Property definition. */
+        struct Property {
+            const char* scriptName;     ///< Name of property in context.
+            const char* jsonName;       ///< Name of property in result hash.
+        };
+
+        /** Constructor.
+            \param properties Property definitions. Must out-live the PackerSchema (usually a static table).
+            \param pWorld     World used by contexts for name lookup; null if the contexts do not depend on a World. */
+        PackerSchema(afl::base::Memory<const Property> properties, const interpreter::World* pWorld);
+
+        /** Destructor. */
+        ~PackerSchema();
+
+        /** Fetch values from Context and add to Hash.
+            \param hv  [in/out] Hash to update
+            \param ctx [in] Context object */
+        void pack(afl::data::Hash& hv, interpreter::Context& ctx);
+
+     private:
+        struct Entry {
+            interpreter::Context::PropertyIndex_t index;
+            bool isDirect;
+        };
+
+        afl::base::Memory<const Property> m_properties;
+        const interpreter::World* m_pWorld;
+        std::vector<Entry> m_entries;
+        const std::type_info* m_contextType;
+        size_t m_numWorldNames;
+
+        void resolve(interpreter::Context& ctx, size_t numWorldNames);
+    };
+
+    /** Get session's packer schema.
+        Schemas are cached in the session (as a session Extra), identified by their property table,
+        so they are resolved once for all requests, not once per request.
+        \param session    Session
+        \param properties Property definitions (static table)
+        \return schema */
+    PackerSchema& getPackerSchema(game::Session& session, afl::base::Memory<const PackerSchema::Property> properties);
+
+} }
+
+#endif
@@ -16,6 +16,81 @@
 #include "game/spec/shiplist.hpp"
 #include "game/turn.hpp"
 #include "server/errors.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property PLANET_PROPERTIES[] = {
+        { "BASE.BUILDING",       "BASE.BUILDING" },
+        { "COLONISTS.HAPPY$",    "COLONISTS.HAPPY" },
+        { "COLONISTS.SUPPORTED", "COLONISTS.SUPPORTED" },
+        { "COLONISTS.TAX",       "COLONISTS.TAX" },
+        { "COMMENT",             "COMMENT" },
+        { "DAMAGE",              "DAMAGE" },
+        { "DEFENSE",             "DEFENSE" },
+        { "DEFENSE.BASE",        "DEFENSE.BASE" },
+        { "DEFENSE.BASE.SPEED",  "DEFENSE.BASE.SPEED" },
+        { "DEFENSE.BASE.WANT",   "DEFENSE.BASE.WANT" },
+        { "DEFENSE.SPEED",       "DEFENSE.SPEED" },
+        { "DEFENSE.WANT",        "DEFENSE.WANT" },
+        { "DENSITY.D",           "DENSITY.D" },
+        { "DENSITY.M",           "DENSITY.M" },
+        { "DENSITY.N",           "DENSITY.N" },
+        { "DENSITY.T",           "DENSITY.T" },
+        { "FACTORIES",           "FACTORIES" },
+        { "FACTORIES.SPEED",     "FACTORIES.SPEED" },
+        { "FACTORIES.WANT",      "FACTORIES.WANT" },
+        { "FCODE",               "FCODE" },
+        { "FIGHTERS",            "FIGHTERS" },
+        { "GROUND.D",            "GROUND.D" },
+        { "GROUND.M",            "GROUND.M" },
+        { "GROUND.N",            "GROUND.N" },
+        { "GROUND.T",            "GROUND.T" },
+        { "INDUSTRY$",           "INDUSTRY" },
+        { "LEVEL",               "LEVEL" },
+        { "MINES",               "MINES" },
+        { "MINES.SPEED",         "MINES.SPEED" },
+        { "MINES.WANT",          "MINES.WANT" },
+        { "MISSION$",            "MISSION" },
+        { "NATIVES",             "NATIVES" },
+        { "NATIVES.GOV$",        "NATIVES.GOV" },
+        { "NATIVES.HAPPY$",      "NATIVES.HAPPY" },
+        { "NATIVES.RACE$",       "NATIVES.RACE" },
+        { "NATIVES.TAX",         "NATIVES.TAX" },
+        { "SHIPYARD.ACTION",     "SHIPYARD.ACTION" },
+        { "SHIPYARD.ID",         "SHIPYARD.ID" },
+        { "TECH.BEAM",           "TECH.BEAM" },
+        { "TECH.ENGINE",         "TECH.ENGINE" },
+        { "TECH.HULL",           "TECH.HULL" },
+        { "TECH.TORPEDO",        "TECH.TORPEDO" },
+        { "TEMP$",               "TEMP" },
+        { "TURN.COLONISTS",      "TURN.COLONISTS" },
+        { "TURN.MINERALS",       "TURN.MINERALS" },
+        { "TURN.MONEY",          "TURN.MONEY" },
+        { "TURN.NATIVES",        "TURN.NATIVES" },
+    };
+
+    const PackerSchema::Property GROUND_PROPERTIES[] = {
+        { "COLONISTS", "COLONISTS" },
+        { "MINED.D",   "D" },
+        { "MINED.M",   "M" },
+        { "MINED.N",   "N" },
+        { "MINED.T",   "T" },
+        { "MONEY",     "MC" },
+        { "SUPPLIES",  "SUPPLIES" },
+    };
+
+    const PackerSchema::Property BUILD_PROPERTIES[] = {
+        { "BUILD.BEAM$",      "BEAM" },
+        { "BUILD.BEAM.COUNT", "BEAM.COUNT" },
+        { "BUILD.ENGINE$",    "ENGINE" },
+        { "BUILD.HULL$",      "HULL" },
+        { "BUILD.QPOS",       "QPOS" },
+        { "BUILD.TORP$",      "TORP" },
+        { "BUILD.TORP.COUNT", "TORP.COUNT" },
+    };
+}
 
 server::play::PlanetPacker::PlanetPacker(game::Session& session, int planetNr)
     : m_session(session),
@@ -36,75 +111,17 @@ server::play::PlanetPacker::buildValue() const
 
     afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
     game::interface::PlanetContext ctx(m_planetNr, m_session, r, g, g.currentTurn());
-    addValue(*hv, ctx, "BASE.BUILDING", "BASE.BUILDING");
-    addValue(*hv, ctx, "COLONISTS.HAPPY$", "COLONISTS.HAPPY");
-    addValue(*hv, ctx, "COLONISTS.SUPPORTED", "COLONISTS.SUPPORTED");
-    addValue(*hv, ctx, "COLONISTS.TAX", "COLONISTS.TAX");
-    addValue(*hv, ctx, "COMMENT", "COMMENT");
-    addValue(*hv, ctx, "DAMAGE", "DAMAGE");
-    addValue(*hv, ctx, "DEFENSE", "DEFENSE");
-    addValue(*hv, ctx, "DEFENSE.BASE", "DEFENSE.BASE");
-    addValue(*hv, ctx, "DEFENSE.BASE.SPEED", "DEFENSE.BASE.SPEED");
-    addValue(*hv, ctx, "DEFENSE.BASE.WANT", "DEFENSE.BASE.WANT");
-    addValue(*hv, ctx, "DEFENSE.SPEED", "DEFENSE.SPEED");
-    addValue(*hv, ctx, "DEFENSE.WANT", "DEFENSE.WANT");
-    addValue(*hv, ctx, "DENSITY.D", "DENSITY.D");
-    addValue(*hv, ctx, "DENSITY.M", "DENSITY.M");
-    addValue(*hv, ctx, "DENSITY.N", "DENSITY.N");
-    addValue(*hv, ctx, "DENSITY.T", "DENSITY.T");
-    addValue(*hv, ctx, "FACTORIES", "FACTORIES");
-    addValue(*hv, ctx, "FACTORIES.SPEED", "FACTORIES.SPEED");
-    addValue(*hv, ctx, "FACTORIES.WANT", "FACTORIES.WANT");
-    addValue(*hv, ctx, "FCODE", "FCODE");
-    addValue(*hv, ctx, "FIGHTERS", "FIGHTERS");
-    addValue(*hv, ctx, "GROUND.D", "GROUND.D");
-    addValue(*hv, ctx, "GROUND.M", "GROUND.M");
-    addValue(*hv, ctx, "GROUND.N", "GROUND.N");
-    addValue(*hv, ctx, "GROUND.T", "GROUND.T");
-    addValue(*hv, ctx, "INDUSTRY$", "INDUSTRY");
-    addValue(*hv, ctx, "LEVEL", "LEVEL");
-    addValue(*hv, ctx, "MINES", "MINES");
-    addValue(*hv, ctx, "MINES.SPEED", "MINES.SPEED");
-    addValue(*hv, ctx, "MINES.WANT", "MINES.WANT");
-    addValue(*hv, ctx, "MISSION$", "MISSION");
-    addValue(*hv, ctx, "NATIVES", "NATIVES");
-    addValue(*hv, ctx, "NATIVES.GOV$", "NATIVES.GOV");
-    addValue(*hv, ctx, "NATIVES.HAPPY$", "NATIVES.HAPPY");
-    addValue(*hv, ctx, "NATIVES.RACE$", "NATIVES.RACE");
-    addValue(*hv, ctx, "NATIVES.TAX", "NATIVES.TAX");
-    addValue(*hv, ctx, "SHIPYARD.ACTION", "SHIPYARD.ACTION");
-    addValue(*hv, ctx, "SHIPYARD.ID", "SHIPYARD.ID");
-    addValue(*hv, ctx, "TECH.BEAM", "TECH.BEAM");
-    addValue(*hv, ctx, "TECH.ENGINE", "TECH.ENGINE");
-    addValue(*hv, ctx, "TECH.HULL", "TECH.HULL");
-    addValue(*hv, ctx, "TECH.TORPEDO", "TECH.TORPEDO");
-    addValue(*hv, ctx, "TEMP$", "TEMP");
-    addValue(*hv, ctx, "TURN.COLONISTS", "TURN.COLONISTS");
-    addValue(*hv, ctx, "TURN.MINERALS", "TURN.MINERALS");
-    addValue(*hv, ctx, "TURN.MONEY", "TURN.MONEY");
-    addValue(*hv, ctx, "TURN.NATIVES", "TURN.NATIVES");
+    getPackerSchema(m_session, PLANET_PROPERTIES).pack(*hv, ctx);
 
     // Ground minerals
     afl::base::Ref<afl::data::Hash> ground(afl::data::Hash::create());
-    addValue(*ground, ctx, "COLONISTS", "COLONISTS");
-    addValue(*ground, ctx, "MINED.D", "D");
-    addValue(*ground, ctx, "MINED.M", "M");
-    addValue(*ground, ctx, "MINED.N", "N");
-    addValue(*ground, ctx, "MINED.T", "T");
-    addValue(*ground, ctx, "MONEY", "MC");
-    addValue(*ground, ctx, "SUPPLIES", "SUPPLIES");
+    getPackerSchema(m_session, GROUND_PROPERTIES).pack(*ground, ctx);
     addValueNew(*hv, new afl::data::HashValue(ground), "G");
 
     // Build order
     if (pPlanet->hasFullBaseData() && pPlanet->getBaseBuildOrderHullIndex().orElse(0) != 0) {
         afl::base::Ref<afl::data::Hash> build(afl::data::Hash::create());
-        addValue(*build, ctx, "BUILD.BEAM$", "BEAM");
-        addValue(*build, ctx, "BUILD.BEAM.COUNT", "BEAM.COUNT");
-        addValue(*build, ctx, "BUILD.ENGINE$", "ENGINE");
-        addValue(*build, ctx, "BUILD.HULL$", "HULL");
-        addValue(*build, ctx, "BUILD.QPOS", "QPOS");
-        addValue(*build, ctx, "BUILD.TORP$", "TORP");
-        addValue(*build, ctx, "BUILD.TORP.COUNT", "TORP.COUNT");
+        getPackerSchema(m_session, BUILD_PROPERTIES).pack(*build, ctx);
         addValueNew(*hv, new afl::data::HashValue(build), "BUILD");
     }
     if (pPlanet->hasFullBaseData()) {
@@ -13,6 +13,69 @@
 #include "game/interface/planetcontext.hpp"
 #include "game/map/anyplanettype.hpp"
 #include "game/turn.hpp"
+#include "server/play/deferredvalue.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::DeferredValue;
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property PLANETXY_PROPERTIES[] = {
+        { "BASE.YESNO", "BASE" },
+        { "LOC.X",      "X" },
+        { "LOC.Y",      "Y" },
+        { "NAME",       "NAME" },
+        { "OWNER$",     "OWNER" },
+        { "PLAYED",     "PLAYED" },
+    };
+}
+
+/*
+ *  Builder: produces the value for a single planet
+ */
+
+class server::play::PlanetXYPacker::Builder : public DeferredValue::Builder {
+ public:
+    Builder(game::Session& session)
+        : m_session(session),
+          m_game(game::actions::mustHaveGame(session)),
+          m_turn(m_game.currentTurn()),
+          m_root(game::actions::mustHaveRoot(session)),
+          m_schema(getPackerSchema(session, PLANETXY_PROPERTIES)),
+          m_planets(m_turn.universe().allPlanets())
+        { }
+
+    int getNumPlanets() const
+        { return m_turn.universe().planets().size(); }
+
+    bool hasPlanet(int i) const
+        { return m_planets.getObjectByIndex(i) != 0; }
+
+    /* Build value for planet; null if it does not exist. */
+    Value_t* buildPlanet(int i) const
+        {
+            if (!hasPlanet(i)) {
+                return 0;
+            }
+
+            afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
+            game::interface::PlanetContext ctx(i, m_session, m_root, m_game, m_turn);
+            m_schema.pack(*hv, ctx);
+            return new afl::data::HashValue(hv);
+        }
+
+    // DeferredValue::Builder:
+    virtual Value_t* build(size_t index) const
+        { return buildPlanet(int(index)); }
+
+ private:
+    game::Session& m_session;
+    game::Game& m_game;
+    game::Turn& m_turn;
+    game::Root& m_root;
+    PackerSchema& m_schema;
+    game::map::AnyPlanetType& m_planets;
+};
 
 server::play::PlanetXYPacker::PlanetXYPacker(game::Session& session)
     : m_session(session)
@@ -22,25 +85,25 @@ server::Value_t*
 server::play::PlanetXYPacker::buildValue() const
 {
     // ex ServerPlanetxyWriter::write
-    game::Game& g = game::actions::mustHaveGame(m_session);
-    game::Turn& t = g.currentTurn();
-    game::Root& r = game::actions::mustHaveRoot(m_session);
-
+    Builder b(m_session);
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
-    game::map::AnyPlanetType& ty(t.universe().allPlanets());
 
     // Note: iteration starts at 0 so JSON can be indexed with planet Ids
-    for (int i = 0, n = t.universe().planets().size(); i <= n; ++i) {
-        if (ty.getObjectByIndex(i) != 0) {
-            afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
-            game::interface::PlanetContext ctx(i, m_session, r, g, g.currentTurn());
-            addValue(*hv, ctx, "BASE.YESNO", "BASE");
-            addValue(*hv, ctx, "LOC.X", "X");
-            addValue(*hv, ctx, "LOC.Y", "Y");
-            addValue(*hv, ctx, "NAME", "NAME");
-            addValue(*hv, ctx, "OWNER$", "OWNER");
-            addValue(*hv, ctx, "PLAYED", "PLAYED");
-            vv->pushBackNew(new afl::data::HashValue(hv));
+    for (int i = 0, n = b.getNumPlanets(); i <= n; ++i) {
+        vv->pushBackNew(b.buildPlanet(i));
+    }
+    return new afl::data::VectorValue(vv);
+}
+
+server::Value_t*
+server::play::PlanetXYPacker::buildDeferredValue() const
+{
+    Builder* b = new Builder(m_session);
+    afl::base::Ref<DeferredValue::Builder> ref(*b);
+    afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    for (int i = 0, n = b->getNumPlanets(); i <= n; ++i) {
+        if (b->hasPlanet(i)) {
+            vv->pushBackNew(new DeferredValue(ref, size_t(i)));
         } else {
             vv->pushBackNew(0);
         }
@@ -22,9 +22,11 @@ namespace server { namespace play {
 
         // Packer:
         Value_t* buildValue() const;
+        Value_t* buildDeferredValue() const;
         String_t getName() const;
 
      private:
+        class Builder;
         game::Session& m_session;
     };
 
@@ -14,6 +14,28 @@
 #include "game/player.hpp"
 #include "game/playerlist.hpp"
 #include "game/root.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property PLAYER_PROPERTIES[] = {
+        { "BASES",            "BASES" },
+        { "PBPS",             "PBPS" },
+        { "PLANETS",          "PLANETS" },
+        { "RACE",             "RACE" },
+        { "RACE$",            "RACE$" },
+        { "RACE.ADJ",         "RACE.ADJ" },
+        { "RACE.ID",          "RACE.ID" },
+        { "RACE.MISSION",     "RACE.MISSION" },
+        { "RACE.SHORT",       "RACE.SHORT" },
+        { "SCORE",            "SCORE" },
+        { "SHIPS",            "SHIPS" },
+        { "SHIPS.CAPITAL",    "SHIPS.CAPITAL" },
+        { "SHIPS.FREIGHTERS", "SHIPS.FREIGHTERS" },
+        { "TEAM",             "TEAM" },
+    };
+}
 
 server::play::PlayerPacker::PlayerPacker(game::Session& session)
     : m_session(session)
@@ -29,25 +51,13 @@ server::play::PlayerPacker::buildValue() const
     // Start at 0, and add only real players.
     // This means the 0=none and 12=aliens slot remain empty.
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    PackerSchema& schema = getPackerSchema(m_session, PLAYER_PROPERTIES);
     for (int i = 0; i <= game::MAX_PLAYERS; ++i) {
         game::Player* pl = r.playerList().get(i);
         if (pl != 0 && pl->isReal()) {
             afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
             game::interface::PlayerContext ctx(i, g, r, m_session.translator());
-            addValue(*hv, ctx, "BASES", "BASES");
-            addValue(*hv, ctx, "PBPS", "PBPS");
-            addValue(*hv, ctx, "PLANETS", "PLANETS");
-            addValue(*hv, ctx, "RACE", "RACE");
-            addValue(*hv, ctx, "RACE$", "RACE$");
-            addValue(*hv, ctx, "RACE.ADJ", "RACE.ADJ");
-            addValue(*hv, ctx, "RACE.ID", "RACE.ID");
-            addValue(*hv, ctx, "RACE.MISSION", "RACE.MISSION");
-            addValue(*hv, ctx, "RACE.SHORT", "RACE.SHORT");
-            addValue(*hv, ctx, "SCORE", "SCORE");
-            addValue(*hv, ctx, "SHIPS", "SHIPS");
-            addValue(*hv, ctx, "SHIPS.CAPITAL", "SHIPS.CAPITAL");
-            addValue(*hv, ctx, "SHIPS.FREIGHTERS", "SHIPS.FREIGHTERS");
-            addValue(*hv, ctx, "TEAM", "TEAM");
+            schema.pack(*hv, ctx);
             vv->pushBackNew(new afl::data::HashValue(hv));
         } else {
             vv->pushBackNew(0);
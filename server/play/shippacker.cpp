@@ -15,6 +15,67 @@
 #include "game/turn.hpp"
 #include "server/errors.hpp"
 #include "server/play/hullpacker.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property SHIP_PROPERTIES[] = {
+        { "AUX$",              "AUX" },
+        { "AUX.AMMO",          "AUX.AMMO" },
+        { "AUX.COUNT",         "AUX.COUNT" },
+        { "BEAM$",             "BEAM" },
+        { "BEAM.COUNT",        "BEAM.COUNT" },
+        { "COMMENT",           "COMMENT" },
+        { "CREW",              "CREW" },
+        { "DAMAGE",            "DAMAGE" },
+        { "ENEMY$",            "ENEMY" },
+        { "ENGINE$",           "ENGINE" },
+        { "FCODE",             "FCODE" },
+        { "HEADING$",          "HEADING" },
+        { "HULL$",             "HULL" },
+        { "LEVEL",             "LEVEL" },
+        { "MISSION$",          "MISSION" },
+        { "MISSION.INTERCEPT", "MISSION.INTERCEPT" },
+        { "MISSION.TOW",       "MISSION.TOW" },
+        { "MOVE.ETA",          "MOVE.ETA" },
+        { "MOVE.FUEL",         "MOVE.FUEL" },
+        { "OWNER.REAL",        "OWNER.REAL" },
+        { "SPEED$",            "SPEED" },
+        { "WAYPOINT.DX",       "WAYPOINT.DX" },
+        { "WAYPOINT.DY",       "WAYPOINT.DY" },
+    };
+
+    const PackerSchema::Property CARGO_PROPERTIES[] = {
+        { "CARGO.COLONISTS", "COLONISTS" },
+        { "CARGO.D",         "D" },
+        { "CARGO.M",         "M" },
+        { "CARGO.MONEY",     "MC" },
+        { "CARGO.N",         "N" },
+        { "CARGO.SUPPLIES",  "SUPPLIES" },
+        { "CARGO.T",         "T" },
+    };
+
+    const PackerSchema::Property TRANSFER_PROPERTIES[] = {
+        { "TRANSFER.SHIP.COLONISTS", "COLONISTS" },
+        { "TRANSFER.SHIP.D",         "D" },
+        { "TRANSFER.SHIP.ID",        "ID" },
+        { "TRANSFER.SHIP.M",         "M" },
+        { "TRANSFER.SHIP.N",         "N" },
+        { "TRANSFER.SHIP.SUPPLIES",  "SUPPLIES" },
+        { "TRANSFER.SHIP.T",         "T" },
+    };
+
+    const PackerSchema::Property UNLOAD_PROPERTIES[] = {
+        { "TRANSFER.UNLOAD.COLONISTS", "COLONISTS" },
+        { "TRANSFER.UNLOAD.D",         "D" },
+        { "TRANSFER.UNLOAD.ID",        "ID" },
+        { "TRANSFER.UNLOAD.M",         "M" },
+        { "TRANSFER.UNLOAD.N",         "N" },
+        { "TRANSFER.UNLOAD.SUPPLIES",  "SUPPLIES" },
+        { "TRANSFER.UNLOAD.T",         "T" },
+    };
+}
 
 server::play::ShipPacker::ShipPacker(game::Session& session, int shipNr)
     : m_session(session),
@@ -38,39 +99,11 @@ server::play::ShipPacker::buildValue() const
     afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
     game::interface::ShipContext ctx(m_shipNr, m_session, r, g, g.currentTurn(), sl);
 
-    addValue(*hv, ctx, "AUX$", "AUX");
-    addValue(*hv, ctx, "AUX.AMMO", "AUX.AMMO");
-    addValue(*hv, ctx, "AUX.COUNT", "AUX.COUNT");
-    addValue(*hv, ctx, "BEAM$", "BEAM");
-    addValue(*hv, ctx, "BEAM.COUNT", "BEAM.COUNT");
-    addValue(*hv, ctx, "COMMENT", "COMMENT");
-    addValue(*hv, ctx, "CREW", "CREW");
-    addValue(*hv, ctx, "DAMAGE", "DAMAGE");
-    addValue(*hv, ctx, "ENEMY$", "ENEMY");
-    addValue(*hv, ctx, "ENGINE$", "ENGINE");
-    addValue(*hv, ctx, "FCODE", "FCODE");
-    addValue(*hv, ctx, "HEADING$", "HEADING");
-    addValue(*hv, ctx, "HULL$", "HULL");
-    addValue(*hv, ctx, "LEVEL", "LEVEL");
-    addValue(*hv, ctx, "MISSION$", "MISSION");
-    addValue(*hv, ctx, "MISSION.INTERCEPT", "MISSION.INTERCEPT");
-    addValue(*hv, ctx, "MISSION.TOW", "MISSION.TOW");
-    addValue(*hv, ctx, "MOVE.ETA", "MOVE.ETA");
-    addValue(*hv, ctx, "MOVE.FUEL", "MOVE.FUEL");
-    addValue(*hv, ctx, "OWNER.REAL", "OWNER.REAL");
-    addValue(*hv, ctx, "SPEED$", "SPEED");
-    addValue(*hv, ctx, "WAYPOINT.DX", "WAYPOINT.DX");
-    addValue(*hv, ctx, "WAYPOINT.DY", "WAYPOINT.DY");
+    getPackerSchema(m_session, SHIP_PROPERTIES).pack(*hv, ctx);
 
     // Cargo
     afl::base::Ref<afl::data::Hash> cargo(afl::data::Hash::create());
-    addValue(*cargo, ctx, "CARGO.COLONISTS", "COLONISTS");
-    addValue(*cargo, ctx, "CARGO.D", "D");
-    addValue(*cargo, ctx, "CARGO.M", "M");
-    addValue(*cargo, ctx, "CARGO.MONEY", "MC");
-    addValue(*cargo, ctx, "CARGO.N", "N");
-    addValue(*cargo, ctx, "CARGO.SUPPLIES", "SUPPLIES");
-    addValue(*cargo, ctx, "CARGO.T", "T");
+    getPackerSchema(m_session, CARGO_PROPERTIES).pack(*cargo, ctx);
     addValueNew(*hv, new afl::data::HashValue(cargo), "CARGO");
 
     // Functions
@@ -83,26 +116,14 @@ server::play::ShipPacker::buildValue() const
     // Transfer
     if (pShip->isTransporterActive(game::map::Ship::TransferTransporter)) {
         afl::base::Ref<afl::data::Hash> tx(afl::data::Hash::create());
-        addValue(*tx, ctx, "TRANSFER.SHIP.COLONISTS", "COLONISTS");
-        addValue(*tx, ctx, "TRANSFER.SHIP.D", "D");
-        addValue(*tx, ctx, "TRANSFER.SHIP.ID", "ID");
-        addValue(*tx, ctx, "TRANSFER.SHIP.M", "M");
-        addValue(*tx, ctx, "TRANSFER.SHIP.N", "N");
-        addValue(*tx, ctx, "TRANSFER.SHIP.SUPPLIES", "SUPPLIES");
-        addValue(*tx, ctx, "TRANSFER.SHIP.T", "T");
+        getPackerSchema(m_session, TRANSFER_PROPERTIES).pack(*tx, ctx);
         addValueNew(*hv, new afl::data::HashValue(tx), "TRANSFER");
     }
 
     // Unload
     if (pShip->isTransporterActive(game::map::Ship::UnloadTransporter)) {
         afl::base::Ref<afl::data::Hash> tx(afl::data::Hash::create());
-        addValue(*tx, ctx, "TRANSFER.UNLOAD.COLONISTS", "COLONISTS");
-        addValue(*tx, ctx, "TRANSFER.UNLOAD.D", "D");
-        addValue(*tx, ctx, "TRANSFER.UNLOAD.ID", "ID");
-        addValue(*tx, ctx, "TRANSFER.UNLOAD.M", "M");
-        addValue(*tx, ctx, "TRANSFER.UNLOAD.N", "N");
-        addValue(*tx, ctx, "TRANSFER.UNLOAD.SUPPLIES", "SUPPLIES");
-        addValue(*tx, ctx, "TRANSFER.UNLOAD.T", "T");
+        getPackerSchema(m_session, UNLOAD_PROPERTIES).pack(*tx, ctx);
         addValueNew(*hv, new afl::data::HashValue(tx), "UNLOAD");
     }
     return new afl::data::HashValue(hv);
@@ -14,6 +14,8 @@
 #include "game/interface/shipcontext.hpp"
 #include "game/map/anyshiptype.hpp"
 #include "game/turn.hpp"
+#include "server/play/deferredvalue.hpp"
+#include "server/play/packerschema.hpp"
 
 using afl::base::Ref;
 using afl::data::BooleanValue;
@@ -21,6 +23,72 @@ using afl::data::Hash;
 using afl::data::HashValue;
 using afl::data::Vector;
 using afl::data::VectorValue;
+using server::play::DeferredValue;
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property SHIPXY_PROPERTIES[] = {
+        { "LOC.X",  "X" },
+        { "LOC.Y",  "Y" },
+        { "MASS",   "MASS" },
+        { "NAME",   "NAME" },
+        { "OWNER$", "OWNER" },
+        { "PLAYED", "PLAYED" },
+    };
+}
+
+/*
+ *  Builder: produces the value for a single ship
+ */
+
+class server::play::ShipXYPacker::Builder : public DeferredValue::Builder {
+ public:
+    Builder(game::Session& session)
+        : m_session(session),
+          m_game(game::actions::mustHaveGame(session)),
+          m_turn(m_game.currentTurn()),
+          m_root(game::actions::mustHaveRoot(session)),
+          m_shipList(game::actions::mustHaveShipList(session)),
+          m_schema(getPackerSchema(session, SHIPXY_PROPERTIES)),
+          m_ships(m_turn.universe().allShips())
+        { }
+
+    int getNumShips() const
+        { return m_turn.universe().ships().size(); }
+
+    bool hasShip(int i) const
+        { return m_ships.getObjectByIndex(i) != 0; }
+
+    /* Build value for ship; null if it does not exist. */
+    Value_t* buildShip(int i) const
+        {
+            game::map::Ship* sh = m_ships.getObjectByIndex(i);
+            if (sh == 0) {
+                return 0;
+            }
+
+            Ref<Hash> hv = Hash::create();
+            game::interface::ShipContext ctx(i, m_session, m_root, m_game, m_turn, m_shipList);
+            m_schema.pack(*hv, ctx);
+            if (!sh->isReliablyVisible(0)) {
+                hv->setNew("GUESSED", new BooleanValue(true));
+            }
+            return new HashValue(hv);
+        }
+
+    // DeferredValue::Builder:
+    virtual Value_t* build(size_t index) const
+        { return buildShip(int(index)); }
+
+ private:
+    game::Session& m_session;
+    game::Game& m_game;
+    game::Turn& m_turn;
+    game::Root& m_root;
+    game::spec::ShipList& m_shipList;
+    PackerSchema& m_schema;
+    game::map::AnyShipType& m_ships;
+};
 
 server::play::ShipXYPacker::ShipXYPacker(game::Session& session)
     : m_session(session)
@@ -30,29 +98,23 @@ server::Value_t*
 server::play::ShipXYPacker::buildValue() const
 {
     // ex ServerShipxyWriter::write
-    game::Game& g = game::actions::mustHaveGame(m_session);
-    game::Turn& t = g.currentTurn();
-    game::Root& r = game::actions::mustHaveRoot(m_session);
-    game::spec::ShipList& sl = game::actions::mustHaveShipList(m_session);
+    Builder b(m_session);
+    Ref<Vector> vv = Vector::create();
+    for (int i = 0, n = b.getNumShips(); i <= n; ++i) {
+        vv->pushBackNew(b.buildShip(i));
+    }
+    return new VectorValue(vv);
+}
 
+server::Value_t*
+server::play::ShipXYPacker::buildDeferredValue() const
+{
+    Builder* b = new Builder(m_session);
+    Ref<DeferredValue::Builder> ref(*b);
     Ref<Vector> vv = Vector::create();
-    game::map::AnyShipType& ty = t.universe().allShips();
-    for (int i = 0, n = t.universe().ships().size(); i <= n; ++i) {
-        if (ty.getObjectByIndex(i) != 0) {
-            Ref<Hash> hv = Hash::create();
-            game::interface::ShipContext ctx(i, m_session, r, g, t, sl);
-            addValue(*hv, ctx, "LOC.X", "X");
-            addValue(*hv, ctx, "LOC.Y", "Y");
-            addValue(*hv, ctx, "MASS", "MASS");
-            addValue(*hv, ctx, "NAME", "NAME");
-            addValue(*hv, ctx, "OWNER$", "OWNER");
-            addValue(*hv, ctx, "PLAYED", "PLAYED");
-            if (game::map::Ship* sh = ty.getObjectByIndex(i)) {
-                if (!sh->isReliablyVisible(0)) {
-                    hv->setNew("GUESSED", new BooleanValue(true));
-                }
-            }
-            vv->pushBackNew(new HashValue(hv));
+    for (int i = 0, n = b->getNumShips(); i <= n; ++i) {
+        if (b->hasShip(i)) {
+            vv->pushBackNew(new DeferredValue(ref, size_t(i)));
         } else {
             vv->pushBackNew(0);
         }
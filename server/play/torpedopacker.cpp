@@ -11,6 +11,26 @@
 #include "game/interface/torpedocontext.hpp"
 #include "game/spec/shiplist.hpp"
 #include "game/spec/torpedolauncher.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property COST_PROPERTIES[] = {
+        { "COST.D",  "D" },
+        { "COST.M",  "M" },
+        { "COST.MC", "MC" },
+        { "COST.T",  "T" },
+    };
+
+    const PackerSchema::Property TORPEDO_PROPERTIES[] = {
+        { "DAMAGE",     "DAMAGE" },
+        { "KILL",       "KILL" },
+        { "NAME",       "NAME" },
+        { "NAME.SHORT", "NAME.SHORT" },
+        { "TECH",       "TECH" },
+    };
+}
 
 server::play::TorpedoPacker::TorpedoPacker(game::spec::ShipList& shipList, const game::Root& root, int firstSlot)
     : m_shipList(shipList), m_root(root), m_firstSlot(firstSlot)
@@ -21,6 +41,8 @@ server::play::TorpedoPacker::buildValue() const
 {
     // ex ServerTorpWriter::write
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    PackerSchema costSchema(COST_PROPERTIES, 0);
+    PackerSchema schema(TORPEDO_PROPERTIES, 0);
     for (int i = m_firstSlot, n = m_shipList.launchers().size(); i <= n; ++i) {
         if (const game::spec::TorpedoLauncher* p = m_shipList.launchers().get(i)) {
             afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
@@ -29,18 +51,11 @@ server::play::TorpedoPacker::buildValue() const
 
             // Torpedo costs
             afl::base::Ref<afl::data::Hash> torpCost(afl::data::Hash::create());
-            addValue(*torpCost, tctx, "COST.D", "D");
-            addValue(*torpCost, tctx, "COST.M", "M");
-            addValue(*torpCost, tctx, "COST.MC", "MC");
-            addValue(*torpCost, tctx, "COST.T", "T");
+            costSchema.pack(*torpCost, tctx);
             addValueNew(*hv, new afl::data::HashValue(torpCost), "TORPCOST");
 
             // General stuff
-            addValue(*hv, tctx, "DAMAGE", "DAMAGE");
-            addValue(*hv, tctx, "KILL", "KILL");
-            addValue(*hv, tctx, "NAME", "NAME");
-            addValue(*hv, tctx, "NAME.SHORT", "NAME.SHORT");
-            addValue(*hv, tctx, "TECH", "TECH");
+            schema.pack(*hv, tctx);
             addValue(*hv, lctx, "MASS", "MASS");
 
             // Special case: KILL and DAMAGE are possibly doubled.
@@ -50,10 +65,7 @@ server::play::TorpedoPacker::buildValue() const
 
             // Launcher costs
             afl::base::Ref<afl::data::Hash> launCost(afl::data::Hash::create());
-            addValue(*launCost, lctx, "COST.D", "D");
-            addValue(*launCost, lctx, "COST.M", "M");
-            addValue(*launCost, lctx, "COST.MC", "MC");
-            addValue(*launCost, lctx, "COST.T", "T");
+            costSchema.pack(*launCost, lctx);
             addValueNew(*hv, new afl::data::HashValue(launCost), "TUBECOST");
 
             vv->pushBackNew(new afl::data::HashValue(hv));
@@ -12,6 +12,31 @@
 #include "game/interface/ufocontext.hpp"
 #include "game/map/ufotype.hpp"
 #include "game/turn.hpp"
+#include "server/play/packerschema.hpp"
+
+using server::play::PackerSchema;
+
+namespace {
+    const PackerSchema::Property UFO_PROPERTIES[] = {
+        { "COLOR.EGA",      "COLOR" },
+        { "HEADING$",       "HEADING" },
+        { "ID",             "ID" },
+        { "INFO1",          "INFO1" },
+        { "INFO2",          "INFO2" },
+        { "KEEP",           "KEEP" },
+        { "LASTSCAN",       "LASTSCAN" },
+        { "LOC.X",          "X" },
+        { "LOC.Y",          "Y" },
+        { "MOVE.DX",        "MOVE.DX" },
+        { "MOVE.DY",        "MOVE.DY" },
+        { "NAME",           "NAME" },
+        { "RADIUS",         "RADIUS" },
+        { "SPEED$",         "SPEED" },
+        { "TYPE",           "TYPE" },
+        { "VISIBLE.PLANET", "VISIBLE.PLANET" },
+        { "VISIBLE.SHIP",   "VISIBLE.SHIP" },
+    };
+}
 
 server::play::UfoPacker::UfoPacker(game::Session& session)
     : m_session(session)
@@ -24,28 +49,13 @@ server::play::UfoPacker::buildValue() const
     game::Game& g = game::actions::mustHaveGame(m_session);
 
     afl::base::Ref<afl::data::Vector> vv(afl::data::Vector::create());
+    PackerSchema& schema = getPackerSchema(m_session, UFO_PROPERTIES);
     game::map::UfoType& ty = g.currentTurn().universe().ufos();
     for (game::Id_t i = ty.findNextIndex(0); i != 0; i = ty.findNextIndex(i)) {
         afl::base::Ref<afl::data::Hash> hv(afl::data::Hash::create());
         game::interface::UfoContext ctx(i, g.currentTurn(), m_session.translator());
 
-        addValue(*hv, ctx, "COLOR.EGA", "COLOR");
-        addValue(*hv, ctx, "HEADING$", "HEADING");
-        addValue(*hv, ctx, "ID", "ID");
-        addValue(*hv, ctx, "INFO1", "INFO1");
-        addValue(*hv, ctx, "INFO2", "INFO2");
-        addValue(*hv, ctx, "KEEP", "KEEP");
-        addValue(*hv, ctx, "LASTSCAN", "LASTSCAN");
-        addValue(*hv, ctx, "LOC.X", "X");
-        addValue(*hv, ctx, "LOC.Y", "Y");
-        addValue(*hv, ctx, "MOVE.DX", "MOVE.DX");
-        addValue(*hv, ctx, "MOVE.DY", "MOVE.DY");
-        addValue(*hv, ctx, "NAME", "NAME");
-        addValue(*hv, ctx, "RADIUS", "RADIUS");
-        addValue(*hv, ctx, "SPEED$", "SPEED");
-        addValue(*hv, ctx, "TYPE", "TYPE");
-        addValue(*hv, ctx, "VISIBLE.PLANET", "VISIBLE.PLANET");
-        addValue(*hv, ctx, "VISIBLE.SHIP", "VISIBLE.SHIP");
+        schema.pack(*hv, ctx);
 
         vv->pushBackNew(new afl::data::HashValue(hv));
     }
@@ -17,8 +17,10 @@
 #include "game/vcr/flak/battle.hpp"
 #include "game/vcr/flak/object.hpp"
 #include "interpreter/values.hpp"
+#include "server/play/deferredvalue.hpp"
 
 namespace gi = game::interface;
+using server::play::DeferredValue;
 using server::play::Packer;
 using interpreter::makeIntegerValue;
 using afl::data::Hash;
@@ -59,26 +61,33 @@ namespace {
 }
 
 
-server::play::VcrPacker::VcrPacker(game::Session& session)
-    : m_session(session)
-{ }
-
-server::Value_t*
-server::play::VcrPacker::buildValue() const
-{
-    // ex ServerVcrWriter::write
-    game::Root& r = game::actions::mustHaveRoot(m_session);
-    game::Game& g = game::actions::mustHaveGame(m_session);
-    game::Turn& t = g.currentTurn();
-    game::spec::ShipList& sl = game::actions::mustHaveShipList(m_session);
-    afl::string::Translator& tx = m_session.translator();
-    const game::config::HostConfiguration& config = r.hostConfiguration();
-    const game::PlayerList& pl = r.playerList();
+/*
+ *  Builder: produces the value for a single fight
+ */
+
+class server::play::VcrPacker::Builder : public DeferredValue::Builder {
+ public:
+    Builder(game::Session& session)
+        : m_root(game::actions::mustHaveRoot(session)),
+          m_shipList(game::actions::mustHaveShipList(session)),
+          m_translator(session.translator()),
+          m_config(m_root.hostConfiguration()),
+          m_playerList(m_root.playerList()),
+          m_db(game::actions::mustHaveGame(session).currentTurn().getBattles())
+        { }
+
+    size_t getNumBattles() const
+        { return m_db.get() != 0 ? m_db->getNumBattles() : 0; }
+
+    Value_t* buildBattle(size_t i) const
+        {
+            afl::string::Translator& tx = m_translator;
+            game::Root& r = m_root;
+            game::spec::ShipList& sl = m_shipList;
+            const game::config::HostConfiguration& config = m_config;
+            const game::PlayerList& pl = m_playerList;
+            const afl::base::Ptr<game::vcr::Database>& db = m_db;
 
-    Ref<Vector> vv(Vector::create());
-    afl::base::Ptr<game::vcr::Database> db = t.getBattles();
-    if (db.get() != 0) {
-        for (size_t i = 0, n = db->getNumBattles(); i < n; ++i) {
             Ref<Hash> hv(Hash::create());
             addValueNew(*hv, gi::getVcrProperty(i, gi::ivpMagic,     tx, r, db, sl), "MAGIC");
             addValueNew(*hv, gi::getVcrProperty(i, gi::ivpSeed,      tx, r, db, sl), "SEED");
@@ -138,8 +147,47 @@ server::play::VcrPacker::buildValue() const
                 addValueNew(*hv, packFleets(setup), "FLEET");
             }
 
-            vv->pushBackNew(new HashValue(hv));
+            return new HashValue(hv);
         }
+
+    // DeferredValue::Builder:
+    virtual Value_t* build(size_t index) const
+        { return buildBattle(index); }
+
+ private:
+    game::Root& m_root;
+    game::spec::ShipList& m_shipList;
+    afl::string::Translator& m_translator;
+    const game::config::HostConfiguration& m_config;
+    const game::PlayerList& m_playerList;
+    afl::base::Ptr<game::vcr::Database> m_db;
+};
+
+
+server::play::VcrPacker::VcrPacker(game::Session& session)
+    : m_session(session)
+{ }
+
+server::Value_t*
+server::play::VcrPacker::buildValue() const
+{
+    // ex ServerVcrWriter::write
+    Builder b(m_session);
+    Ref<Vector> vv(Vector::create());
+    for (size_t i = 0, n = b.getNumBattles(); i < n; ++i) {
+        vv->pushBackNew(b.buildBattle(i));
+    }
+    return new VectorValue(vv);
+}
+
+server::Value_t*
+server::play::VcrPacker::buildDeferredValue() const
+{
+    Builder* b = new Builder(m_session);
+    Ref<DeferredValue::Builder> ref(*b);
+    Ref<Vector> vv(Vector::create());
+    for (size_t i = 0, n = b->getNumBattles(); i < n; ++i) {
+        vv->pushBackNew(new DeferredValue(ref, i));
     }
     return new VectorValue(vv);
 }
@@ -14,9 +14,11 @@ namespace server { namespace play {
         VcrPacker(game::Session& session);
 
         Value_t* buildValue() const;
+        Value_t* buildDeferredValue() const;
         String_t getName() const;
 
      private:
+        class Builder;
         game::Session& m_session;
     };
 
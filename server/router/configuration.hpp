@@ -29,6 +29,13 @@ namespace server { namespace router {
 
         /** true if new sessions displace old ones (Router.NewSessionsWin). */
         bool newSessionsWin;               // ex arg_newsessionswin
+
+        /** Number of pre-started idle server processes (Router.PoolSize).
+            0 disables the pool. */
+        size_t poolSize;
+
+        /** Maximum idle time of a pre-started server process, in seconds (Router.PoolTimeout). */
+        int32_t poolTimeout;
     };
 
 } }
@@ -0,0 +1,123 @@
+/**
+  *  \file server/router/processpool.cpp
+  *  \brief Class server::router::ProcessPool
+  */
+
+#include "server/router/processpool.hpp"
+#include "afl/string/format.hpp"
+
+using afl::string::Format;
+using afl::sys::LogListener;
+
+namespace {
+    const char*const LOG_NAME = "router.pool";
+}
+
+server::router::ProcessPool::ProcessPool(util::process::Factory& factory, afl::sys::LogListener& log)
+    : m_factory(factory),
+      m_log(log),
+      m_items(),
+      m_numHits(0),
+      m_numMisses(0)
+{ }
+
+server::router::ProcessPool::~ProcessPool()
+{
+    clear();
+}
+
+void
+server::router::ProcessPool::fill(const String_t& serverPath, size_t size)
+{
+    static const String_t ARGS[] = { "--wait" };
+    while (m_items.size() < size) {
+        std::auto_ptr<Item> item(new Item());
+        item->process.reset(m_factory.createNewProcess());
+        item->startTime = afl::sys::Time::getCurrentTime();
+        if (!item->process->start(serverPath, ARGS)) {
+            // Do not retry; next fill() will try again.
+            m_log.write(LogListener::Warn, LOG_NAME, Format("failed to start: %s", item->process->getStatus()));
+            break;
+        }
+        m_log.write(LogListener::Trace, LOG_NAME, Format("[%d] started", item->process->getProcessId()));
+        m_items.pushBackNew(item.release());
+    }
+}
+
+void
+server::router::ProcessPool::removeExpired(int32_t timeout)
+{
+    const afl::sys::Time now = afl::sys::Time::getCurrentTime();
+    size_t out = 0;
+    for (size_t in = 0, n = m_items.size(); in < n; ++in) {
+        Item& item = *m_items[in];
+        if (!item.process->isActive()) {
+            // Drop
+        } else if ((now - item.startTime).getMilliseconds() / 1000 >= timeout) {
+            stopItem(item);
+        } else {
+            m_items.swapElements(in, out);
+            ++out;
+        }
+    }
+    m_items.resize(out);
+}
+
+std::auto_ptr<util::process::Subprocess>
+server::router::ProcessPool::take()
+{
+    // Take the newest process first; older ones will expire eventually.
+    std::auto_ptr<util::process::Subprocess> result;
+    while (result.get() == 0 && !m_items.empty()) {
+        const size_t last = m_items.size() - 1;
+        if (m_items[last]->process->isActive()) {
+            result = m_items[last]->process;
+        }
+        m_items.resize(last);
+    }
+
+    if (result.get() != 0) {
+        ++m_numHits;
+    } else {
+        ++m_numMisses;
+    }
+    return result;
+}
+
+void
+server::router::ProcessPool::clear()
+{
+    for (size_t i = 0, n = m_items.size(); i < n; ++i) {
+        stopItem(*m_items[i]);
+    }
+    m_items.clear();
+}
+
+size_t
+server::router::ProcessPool::getNumIdle() const
+{
+    return m_items.size();
+}
+
+size_t
+server::router::ProcessPool::getNumHits() const
+{
+    return m_numHits;
+}
+
+size_t
+server::router::ProcessPool::getNumMisses() const
+{
+    return m_numMisses;
+}
+
+/* Stop a pooled process. Closing its input makes it exit without doing anything. */
+void
+server::router::ProcessPool::stopItem(Item& item)
+{
+    if (item.process->isActive()) {
+        const uint32_t pid = item.process->getProcessId();
+        m_log.write(LogListener::Trace, LOG_NAME, Format("[%d] stopping", pid));
+        item.process->stop();
+    }
+}
@@ -0,0 +1,86 @@
+/**
+  *  \file server/router/processpool.hpp
+  *  \brief Class server::router::ProcessPool
+  */
+#ifndef C2NG_SERVER_ROUTER_PROCESSPOOL_HPP
+#define C2NG_SERVER_ROUTER_PROCESSPOOL_HPP
+
+#include <memory>
+#include "afl/container/ptrvector.hpp"
+#include "afl/sys/loglistener.hpp"
+#include "afl/sys/time.hpp"
+#include "util/process/factory.hpp"
+#include "util/process/subprocess.hpp"
+
+namespace server { namespace router {
+
+    /** Pool of pre-started server processes.
+        Starting a c2play-server process costs process creation and initialisation.
+        To save that time when a session is created, we keep a number of processes
+        started in wait mode ("--wait"), where they wait for their parameters on standard input.
+
+        A process taken from the pool is handed to Session::start(), which sends the parameters.
+        Processes that have been waiting for too long are stopped and replaced;
+        this makes sure that an updated server binary is eventually picked up.
+
+        ProcessPool also counts hits and misses for status reporting. */
+    class ProcessPool {
+     public:
+        /** Constructor.
+            \param factory Process factory
+            \param log     Logger */
+        ProcessPool(util::process::Factory& factory, afl::sys::LogListener& log);
+
+        /** Destructor.
+            Stops all pooled processes. */
+        ~ProcessPool();
+
+        /** Fill the pool.
+            Starts new processes until the pool contains the given number of processes.
+            \param serverPath Program name
+            \param size       Desired number of processes */
+        void fill(const String_t& serverPath, size_t size);
+
+        /** Remove expired processes.
+            Stops all processes that have been idle for the given time, and drops processes that are no longer active.
+            \param timeout Timeout in seconds */
+        void removeExpired(int32_t timeout);
+
+        /** Take a process from the pool.
+            Counts a hit or miss.
+            \return Process; null if the pool is empty */
+        std::auto_ptr<util::process::Subprocess> take();
+
+        /** Stop all pooled processes. */
+        void clear();
+
+        /** Get number of idle processes.
+            \return number of processes in pool */
+        size_t getNumIdle() const;
+
+        /** Get number of hits.
+            \return number of take() calls that returned a process */
+        size_t getNumHits() const;
+
+        /** Get number of misses.
+            \return number of take() calls that did not return a process */
+        size_t getNumMisses() const;
+
+     private:
+        struct Item {
+            std::auto_ptr<util::process::Subprocess> process;
+            afl::sys::Time startTime;
+        };
+
+        util::process::Factory& m_factory;
+        afl::sys::LogListener& m_log;
+        afl::container::PtrVector<Item> m_items;
+        size_t m_numHits;
+        size_t m_numMisses;
+
+        void stopItem(Item& item);
+    };
+
+} }
+
+#endif
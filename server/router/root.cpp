@@ -22,7 +22,8 @@ server::router::Root::Root(util::process::Factory& factory,
       m_generator(gen),
       m_pFileBase(pFileBase),
       m_config(config),
-      m_sessions()
+      m_sessions(),
+      m_pool(factory, m_log)
 { }
 
 server::router::Root::~Root()
@@ -68,7 +69,9 @@ server::router::Root::createSession(afl::base::Memory<const String_t> args)
     }
 
     // Start the session
-    if (!p->start(m_config.serverPath)) {
+    bool ok = startSession(*p);
+    fillPool();
+    if (!ok) {
         throw std::runtime_error(CANNOT_START_SESSION);
     }
     return *m_sessions.pushBackNew(p.release());
@@ -79,7 +82,9 @@ server::router::Root::restartSession(Session& s)
 {
     // ex RouterSession::restart
     s.stop();
-    if (!s.start(m_config.serverPath)) {
+    bool ok = startSession(s);
+    fillPool();
+    if (!ok) {
         throw std::runtime_error(CANNOT_START_SESSION);
     }
 }
@@ -140,6 +145,12 @@ server::router::Root::removeExpiredSessions()
             ++in;
         }
         m_sessions.resize(out);
+
+        // Pass 3: replace pooled processes that have been waiting too long
+        if (m_config.poolSize > 0) {
+            m_pool.removeExpired(m_config.poolTimeout);
+            fillPool();
+        }
     }
     catch (std::exception& e)
     {
@@ -157,4 +168,29 @@ server::router::Root::stopAllSessions()
         }
     }
     m_sessions.clear();
+    m_pool.clear();
+}
+
+void
+server::router::Root::fillPool()
+{
+    m_pool.fill(m_config.serverPath, m_config.poolSize);
+}
+
+const server::router::ProcessPool&
+server::router::Root::pool() const
+{
+    return m_pool;
+}
+
+bool
+server::router::Root::startSession(Session& s)
+{
+    if (m_config.poolSize > 0) {
+        std::auto_ptr<util::process::Subprocess> process = m_pool.take();
+        if (process.get() != 0) {
+            return s.start(process, m_config.serverPath);
+        }
+    }
+    return s.start(m_config.serverPath);
 }
@@ -9,6 +9,7 @@
 #include "server/common/idgenerator.hpp"
 #include "server/interface/filebase.hpp"
 #include "server/router/configuration.hpp"
+#include "server/router/processpool.hpp"
 #include "util/process/factory.hpp"
 
 namespace server { namespace router {
@@ -42,6 +43,10 @@ namespace server { namespace router {
 
         void stopAllSessions();
 
+        void fillPool();
+
+        const ProcessPool& pool() const;
+
      private:
         afl::sys::Log m_log;
 
@@ -54,6 +59,10 @@ namespace server { namespace router {
         Configuration m_config;
 
         Sessions_t m_sessions;
+
+        ProcessPool m_pool;
+
+        bool startSession(Session& s);
     };
 
 } }
@@ -100,6 +100,7 @@ server::router::ServerApplication::serverMain()
     // Set up root (global data)
     Root root(m_factory, *m_generator, m_config, pFileBase);
     root.log().addListener(log());
+    root.fillPool();
 
     // Protocol Handler
     SessionRouter impl(root);
@@ -178,6 +179,32 @@ server::router::ServerApplication::handleConfiguration(const String_t& key, cons
             throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
         }
         return true;
+    } else if (isInstanceOption(key, "POOLSIZE")) {
+        /* @q Router.PoolSize:Int (Config)
+           Number of %c2server processes to start in advance.
+           When a session is created, it uses one of these processes, saving the process startup time.
+           Pre-started processes do not count towards {Router.MaxSessions}.
+           0 (default) disables this feature.
+           @since PCC2 2.41.5 */
+        size_t n;
+        if (afl::string::strToInteger(value, n)) {
+            m_config.poolSize = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
+    } else if (isInstanceOption(key, "POOLTIMEOUT")) {
+        /* @q Router.PoolTimeout:Int (Config)
+           Maximum time in seconds a pre-started %c2server process waits for a session (see {Router.PoolSize}).
+           After that time, it is replaced by a new one.
+           @since PCC2 2.41.5 */
+        int32_t n;
+        if (afl::string::strToInteger(value, n) && n > 0) {
+            m_config.poolTimeout = n;
+        } else {
+            throw afl::except::CommandLineException(afl::string::Format("Invalid value for '%s'", key));
+        }
+        return true;
     } else if (isInstanceOption(key, "NEWSESSIONSWIN")) {
         /* @q Router.NewSessionsWin:Str (Config)
            Determines behaviour when two conflicting sessions are started ("-W" and "-R" flags).
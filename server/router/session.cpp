@@ -40,6 +40,21 @@ namespace {
         }
     }
 
+    /* Check whether parameters can be transmitted line-by-line.
+       An empty line terminates the list; an empty list tells the process to exit. */
+    bool isLineSafe(const afl::data::StringList_t& args)
+    {
+        if (args.empty()) {
+            return false;
+        }
+        for (size_t i = 0, n = args.size(); i < n; ++i) {
+            if (args[i].empty() || args[i].find('\n') != String_t::npos) {
+                return false;
+            }
+        }
+        return true;
+    }
+
     /** Check for conflict. Conflict resolution uses "reader/writer lock" terminology.
         Each session can be associated with a set of keywords, starting with "-R" or "-W"
         (they need not have a real-world meaning, i.e. they need not imply that someone
@@ -180,27 +195,37 @@ server::router::Session::start(const String_t& serverPath)
     logCommandLine();
     bool ok = m_process->start(serverPath, m_args);
     if (ok) {
-        // Wait for child to start up. It will write a "hello" message with a "100" code, or some error messages.
-        String_t greeting;
-        if (readLine(greeting) && greeting.compare(0, 3, "100", 3) == 0) {
-            // Looks like a success message
-            logProcess(LogListener::Info, "started");
-        } else {
-            // Looks like a failure message
-            logProcess(LogListener::Warn, "failed to start");
-            do {
-                util::removeTrailingCharacter(greeting, '\n');
-                m_log.write(LogListener::Trace, LOG_NAME, greeting);
-            } while (readLine(greeting));
-            stop();
-            ok = false;
-        }
+        ok = waitForGreeting();
     } else {
         m_log.write(LogListener::Warn, LOG_NAME, Format("[%s] failed to start: %s", m_id, m_process->getStatus()));
     }
     return ok;
 }
 
+// Start this session using a pre-started process.
+bool
+server::router::Session::start(std::auto_ptr<util::process::Subprocess> process, const String_t& serverPath)
+{
+    m_process = process;
+
+    // Send parameters, one per line, terminated by an empty line.
+    // Parameters that cannot be represented that way need a fresh process.
+    bool ok = m_process->isActive() && isLineSafe(m_args);
+    for (size_t i = 0, n = m_args.size(); ok && i < n; ++i) {
+        ok = m_process->writeLine(m_args[i] + "\n");
+    }
+    ok = ok && m_process->writeLine("\n");
+
+    if (ok) {
+        logCommandLine();
+        return waitForGreeting();
+    } else {
+        logProcess(LogListener::Info, "pre-started process not usable");
+        m_process->stop();
+        return start(serverPath);
+    }
+}
+
 // Stop this session.
 void
 server::router::Session::stop()
@@ -318,6 +343,27 @@ server::router::Session::setLastAccessTime()
     m_lastAccessTime = afl::sys::Time::getCurrentTime();
 }
 
+bool
+server::router::Session::waitForGreeting()
+{
+    // Wait for child to start up. It will write a "hello" message with a "100" code, or some error messages.
+    String_t greeting;
+    if (readLine(greeting) && greeting.compare(0, 3, "100", 3) == 0) {
+        // Looks like a success message
+        logProcess(LogListener::Info, "started");
+        return true;
+    } else {
+        // Looks like a failure message
+        logProcess(LogListener::Warn, "failed to start");
+        do {
+            util::removeTrailingCharacter(greeting, '\n');
+            m_log.write(LogListener::Trace, LOG_NAME, greeting);
+        } while (readLine(greeting));
+        stop();
+        return false;
+    }
+}
+
 bool
 server::router::Session::readLine(String_t& line)
 {
@@ -80,6 +80,16 @@ namespace server { namespace router {
             \return true if session started successfully (process started; greeting received) */
         bool start(const String_t& serverPath);
 
+        /** Start this session using a pre-started process.
+            The process must have been started in wait mode (see ProcessPool);
+            it receives the parameters on its standard input.
+            If the process does not accept the parameters (e.g. because it died while waiting),
+            falls back to starting a new process.
+            \param process    Pre-started process; ownership is taken over by the Session
+            \param serverPath Program name for fallback
+            \return true if session started successfully (greeting received) */
+        bool start(std::auto_ptr<util::process::Subprocess> process, const String_t& serverPath);
+
         /** Stop this session. */
         void stop();
 
@@ -109,6 +119,7 @@ namespace server { namespace router {
         void logProcess(afl::sys::LogListener::Level level, const String_t& msg, uint32_t pid);
 
         void setLastAccessTime();
+        bool waitForGreeting();
         bool readLine(String_t& line);
         void readResponse(String_t& header, String_t& body);
         void notifyFileServer();
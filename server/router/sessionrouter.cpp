@@ -22,7 +22,12 @@ server::router::SessionRouter::getStatus()
 
     const Root::Sessions_t& sessions = m_root.sessions();
 
-    String_t result = afl::string::Format("200 OK, %d sessions\n", sessions.size());
+    String_t result = afl::string::Format("200 OK, %d sessions", sessions.size());
+    if (m_root.config().poolSize > 0) {
+        const ProcessPool& pool = m_root.pool();
+        result += afl::string::Format(", pool: %d idle, %d hits, %d misses", pool.getNumIdle(), pool.getNumHits(), pool.getNumMisses());
+    }
+    result += "\n";
 
     afl::sys::Time now = afl::sys::Time::getCurrentTime();
     for (size_t i = 0, n = sessions.size(); i < n; ++i) {
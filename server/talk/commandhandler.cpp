@@ -5,6 +5,8 @@
 
 #include <stdexcept>
 #include "server/talk/commandhandler.hpp"
+#include "afl/data/hash.hpp"
+#include "afl/data/hashvalue.hpp"
 #include "afl/string/char.hpp"
 #include "afl/string/string.hpp"
 #include "afl/sys/mutexguard.hpp"
@@ -74,6 +76,20 @@ server::talk::CommandHandler::handleCommand(const String_t& upcasedCommand, inte
         result.reset(makeStringValue("OK"));
         ok = true;
     }
+    if (!ok && upcasedCommand == "RENDERSTAT") {
+        /* @q RENDERSTAT (Talk Command)
+           Get statistics of the rendered-text cache (see {Talk.RenderCache}).
+           Counters are reset when the service restarts.
+           @retkey hits:Int    Number of renderings answered from the cache
+           @retkey misses:Int  Number of renderings that had to be computed
+           @since PCC2 2.41.5 */
+        args.checkArgumentCount(0);
+        afl::data::Hash::Ref_t h = afl::data::Hash::create();
+        h->setNew("hits",   makeIntegerValue(m_root.renderCache().getNumHits()));
+        h->setNew("misses", makeIntegerValue(m_root.renderCache().getNumMisses()));
+        result.reset(new afl::data::HashValue(h));
+        ok = true;
+    }
     if (!ok) {
         // SYNTAX
         TalkSyntax impl(m_root.keywordTable());
@@ -161,7 +177,8 @@ server::talk::CommandHandler::getHelp(String_t topic)
         return "Render commands:\n"
             "RENDEROPTION <renderoptions>\n"
             "RENDER <text> <renderoptions>\n"
-            "RENDERCHECK <text>\n";
+            "RENDERCHECK <text>\n"
+            "RENDERSTAT\n";
     } else if (topic == "SYNTAX") {
         return "Syntax commands:\n"
             "SYNTAXGET <key>\n"
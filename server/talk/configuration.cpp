@@ -18,5 +18,6 @@ server::talk::Configuration::Configuration()
       rateCostPerMail(1),
       rateCostPerPost(5),
       getNewestLimit(200),
-      notificationDelay(6)
+      notificationDelay(6),
+      renderCacheSize(0)
 { }
@@ -51,6 +51,9 @@ namespace server { namespace talk {
 
         /// Notification delay in minutes.
         int32_t notificationDelay;
+
+        /// Rendered-text cache: maximum number of cached renderings per message. 0 to disable.
+        int32_t renderCacheSize;
     };
 
 } }
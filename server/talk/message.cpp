@@ -155,6 +155,20 @@ server::talk::Message::text()
     return m_message.stringKey("text");
 }
 
+// Access rendered-text cache.
+afl::net::redis::HashKey
+server::talk::Message::renderCache()
+{
+    return m_message.hashKey("rendered");
+}
+
+// Access rendered-text cache key list.
+afl::net::redis::StringListKey
+server::talk::Message::renderCacheKeys()
+{
+    return m_message.stringListKey("rendered:keys");
+}
+
 // Check existance.
 bool
 server::talk::Message::exists()
@@ -195,6 +209,8 @@ server::talk::Message::remove(Root& root)
     }
 
     // Remove post
+    renderCache().remove();
+    renderCacheKeys().remove();
     text().remove();
     header().remove();
 }
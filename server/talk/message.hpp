@@ -10,6 +10,7 @@
 #include "afl/net/redis/integerfield.hpp"
 #include "afl/net/redis/stringfield.hpp"
 #include "afl/net/redis/stringkey.hpp"
+#include "afl/net/redis/stringlistkey.hpp"
 #include "server/interface/talkpost.hpp"
 #include "server/talk/sorter.hpp"
 #include "afl/data/hash.hpp"
@@ -117,6 +118,16 @@ namespace server { namespace talk {
             \return text */
         afl::net::redis::StringKey text();
 
+        /** Access rendered-text cache.
+            Maps render keys to rendered text, see RenderCache.
+            \return cache */
+        afl::net::redis::HashKey renderCache();
+
+        /** Access rendered-text cache key list.
+            Lists the keys of renderCache(), most recently added first, see RenderCache.
+            \return list */
+        afl::net::redis::StringListKey renderCacheKeys();
+
         /** Check existance.
             \return true if this message exists. */
         bool exists();
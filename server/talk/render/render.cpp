@@ -135,6 +135,14 @@ namespace server { namespace talk { namespace render { namespace {
         }
     }
 
+    bool isSameFormat(const String_t& text, const String_t& format)
+    {
+        return format.find(':') == format.npos
+            && text.size() > format.size()
+            && text.compare(0, format.size(), format) == 0
+            && text[format.size()] == ':';
+    }
+
     TalkRender::Warning convertWarning(const BBParser::Warning& in)
     {
         TalkRender::Warning out;
@@ -229,21 +237,32 @@ server::talk::render::renderText(const String_t& text, const Context& ctx, const
             n = text.size();
         }
         return text.substr(0, n);
-    } else if (format.find(':') == format.npos
-               && text.size() > format.size()
-               && text.compare(0, format.size(), format) == 0
-               && text[format.size()] == ':')
-    {
+    } else if (isSameFormat(text, format)) {
         // requested same format as stored
         return text.substr(format.size()+1);
     } else {
         // transformation required
-        NullLinkParser lp;
-        std::auto_ptr<TextNode> tree(doParse(text, root.recognizer(), lp));
+        std::auto_ptr<TextNode> tree(parseText(text, root));
         return renderText(tree, ctx, opts, root);
     }
 }
 
+server::talk::TextNode*
+server::talk::render::parseText(const String_t& text, Root& root)
+{
+    NullLinkParser lp;
+    return doParse(text, root.recognizer(), lp);
+}
+
+bool
+server::talk::render::isTransformation(const String_t& text, const Options& opts)
+{
+    const String_t& format = opts.getFormat();
+    return format != "raw"
+        && format != "format"
+        && !isSameFormat(text, format);
+}
+
 String_t
 server::talk::render::renderText(std::auto_ptr<TextNode> tree, const Context& ctx, const Options& opts, Root& root)
 {
@@ -28,6 +28,13 @@ namespace server { namespace talk { namespace render {
         \return formatted text */
     String_t renderText(const String_t& text, const Context& ctx, const Options& opts, Root& root);
 
+    /** Parse text.
+        Parsing does not depend on the user; links are not checked and remain in the tree.
+        \param text Text (with type tag)
+        \param root Service root
+        \return newly-allocated tree */
+    TextNode* parseText(const String_t& text, Root& root);
+
     /** Render pre-parsed text.
         \param tree Parsed text
         \param ctx  Rendering context
@@ -36,6 +43,14 @@ namespace server { namespace talk { namespace render {
         \return formatted text */
     String_t renderText(std::auto_ptr<TextNode> tree, const Context& ctx, const Options& opts, Root& root);
 
+    /** Check whether rendering requires a transformation.
+        If this function returns false, renderText() is a simple string operation
+        that does not parse the text.
+        \param text Text (with type tag)
+        \param opts Rendering options (includes output format)
+        \return true if text needs to be parsed and re-rendered */
+    bool isTransformation(const String_t& text, const Options& opts);
+
     /** Check text and produce warnings.
         \param [in]  text Text
         \param [in]  root Root
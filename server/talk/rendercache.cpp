@@ -0,0 +1,119 @@
+/**
+  *  \file server/talk/rendercache.cpp
+  *  \brief Class server::talk::RenderCache
+  */
+
+#include <memory>
+#include "server/talk/rendercache.hpp"
+#include "afl/net/redis/field.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/stringlistkey.hpp"
+#include "afl/string/format.hpp"
+#include "server/talk/message.hpp"
+#include "server/talk/render/context.hpp"
+#include "server/talk/render/options.hpp"
+#include "server/talk/render/render.hpp"
+#include "server/talk/root.hpp"
+#include "server/talk/textnode.hpp"
+#include "server/types.hpp"
+
+namespace {
+    /* Check whether output in the given format can depend on the viewing user.
+       HTMLRenderer highlights the user's own name in user links.
+       (It also checks permissions for game links, but those are not cached at all.) */
+    bool isUserDependent(const String_t& format)
+    {
+        const size_t LEN = 4;
+        return format.size() >= LEN && format.compare(format.size() - LEN, LEN, "html", LEN) == 0;
+    }
+
+    /* Check whether the given format is cacheable. */
+    bool isCacheable(const String_t& format)
+    {
+        return format.find("force:") == String_t::npos;
+    }
+
+    /* Store a cache entry, evicting the oldest entries if the cache is full. */
+    void storeEntry(server::talk::Message& msg, const String_t& key, const String_t& value, int32_t limit)
+    {
+        afl::net::redis::HashKey cache = msg.renderCache();
+        afl::net::redis::StringListKey keys = msg.renderCacheKeys();
+        while (cache.size() >= limit) {
+            const String_t oldKey = keys.popBack();
+            if (oldKey.empty()) {
+                // Happens only on inconsistent data - start over.
+                cache.remove();
+                break;
+            }
+            cache.field(oldKey).remove();
+        }
+        cache.stringField(key).set(value);
+        keys.pushFront(key);
+    }
+}
+
+server::talk::RenderCache::RenderCache()
+    : m_numHits(0),
+      m_numMisses(0)
+{ }
+
+String_t
+server::talk::RenderCache::render(Message& msg, const render::Context& ctx, const render::Options& opts, Root& root)
+{
+    const String_t text = msg.text().get();
+    const String_t& format = opts.getFormat();
+    const int32_t limit = root.config().renderCacheSize;
+    if (limit <= 0 || !isCacheable(format) || !render::isTransformation(text, opts)) {
+        return render::renderText(text, ctx, opts, root);
+    }
+
+    // Look up.
+    // A rendering is shared by all users, unless the format is user-dependent and the message contains a user link.
+    const String_t key = afl::string::Format("%d|%s|%s", msg.sequenceNumber().get(), format, opts.getBaseUrl());
+    String_t userKey;
+    if (isUserDependent(format)) {
+        userKey = key + "|" + ctx.getUser();
+    }
+    afl::net::redis::HashKey cache = msg.renderCache();
+    std::auto_ptr<afl::data::Value> cached(cache.field(key).getRawValue());
+    if (cached.get() == 0 && !userKey.empty()) {
+        cached.reset(cache.field(userKey).getRawValue());
+    }
+    if (cached.get() != 0) {
+        ++m_numHits;
+        return toString(cached.get());
+    }
+
+    // Render
+    ++m_numMisses;
+    std::auto_ptr<TextNode> tree(render::parseText(text, root));
+    const bool hasGameLink = tree->hasLink(TextNode::miLinkGame);
+    const bool hasUserLink = tree->hasLink(TextNode::miLinkUser);
+    String_t result = render::renderText(tree, ctx, opts, root);
+
+    // Store, unless result depends on game permissions
+    if (!hasGameLink) {
+        storeEntry(msg, (hasUserLink && !userKey.empty()) ? userKey : key, result, limit);
+    }
+    return result;
+}
+
+void
+server::talk::RenderCache::invalidate(Message& msg)
+{
+    msg.renderCache().remove();
+    msg.renderCacheKeys().remove();
+}
+
+int32_t
+server::talk::RenderCache::getNumHits() const
+{
+    return m_numHits;
+}
+
+int32_t
+server::talk::RenderCache::getNumMisses() const
+{
+    return m_numMisses;
+}
@@ -0,0 +1,80 @@
+/**
+  *  \file server/talk/rendercache.hpp
+  *  \brief Class server::talk::RenderCache
+  */
+#ifndef C2NG_SERVER_TALK_RENDERCACHE_HPP
+#define C2NG_SERVER_TALK_RENDERCACHE_HPP
+
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/string/string.hpp"
+
+namespace server { namespace talk {
+
+    class Message;
+    class Root;
+
+    namespace render {
+        class Context;
+        class Options;
+    }
+
+    /** Cache for rendered forum postings.
+        Rendering a posting into a different format requires parsing and re-rendering it,
+        although postings are rarely changed.
+        This caches the rendered output next to the message in the database (Message::renderCache()).
+
+        A cache entry is identified by the message's sequence number and the render options (format, base URL).
+        If the output depends on the viewing user (HTML for a message containing a user link, which highlights the user's own name),
+        the user Id is also part of the key; all other renderings are shared by all users.
+        Rendering without transformation (e.g. "raw") is cheap and not cached;
+        a format containing "force:" bypasses the cache.
+
+        The number of entries per message is limited by Configuration::renderCacheSize;
+        when that is exceeded, the oldest entries are removed (Message::renderCacheKeys()).
+        A size of 0 disables the cache.
+
+        Editing a message must invalidate its cache (invalidate()).
+        Information pulled in from other objects (e.g. subjects of linked topics) is not tracked
+        and may therefore remain stale until the message is edited.
+        Game links are not cached at all: whether a game link is rendered, and with which name,
+        depends on the game's state and type and the user's membership (Context::parseGameLink()),
+        which can change at any time, for example making a private game's name visible to former players.
+        Messages containing game links are therefore rendered anew on every call.
+
+        RenderCache itself only tracks statistics; data is kept in the database.
+        Like all of Root, it is protected by Root::mutex(). */
+    class RenderCache : private afl::base::Uncopyable {
+     public:
+        /** Constructor. */
+        RenderCache();
+
+        /** Render a message, using the cache.
+            \param msg  Message
+            \param ctx  Rendering context (should have message Id set to msg)
+            \param opts Rendering options
+            \param root Service root
+            \return formatted text */
+        String_t render(Message& msg, const render::Context& ctx, const render::Options& opts, Root& root);
+
+        /** Invalidate a message's cache.
+            Call whenever the message text changes.
+            \param msg Message */
+        void invalidate(Message& msg);
+
+        /** Get number of cache hits.
+            \return number of render() calls answered from the cache */
+        int32_t getNumHits() const;
+
+        /** Get number of cache misses.
+            \return number of render() calls that had to render (and possibly stored the result) */
+        int32_t getNumMisses() const;
+
+     private:
+        int32_t m_numHits;
+        int32_t m_numMisses;
+    };
+
+} }
+
+#endif
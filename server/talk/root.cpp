@@ -32,6 +32,7 @@ server::talk::Root::Root(afl::net::CommandHandler& db, const Configuration& conf
       m_keywordTable(),
       m_recognizer(),
       m_linkFormatter(),
+      m_renderCache(),
       m_db(db),
       m_config(config),
       m_pNotifier()
@@ -78,6 +79,13 @@ server::talk::Root::linkFormatter()
     return m_linkFormatter;
 }
 
+// Access rendered-text cache.
+server::talk::RenderCache&
+server::talk::Root::renderCache()
+{
+    return m_renderCache;
+}
+
 // Access configuration.
 const server::talk::Configuration&
 server::talk::Root::config() const
@@ -16,6 +16,7 @@
 #include "server/talk/inlinerecognizer.hpp"
 #include "server/talk/linkformatter.hpp"
 #include "server/talk/notifier.hpp"
+#include "server/talk/rendercache.hpp"
 #include "server/types.hpp"
 #include "util/syntax/keywordtable.hpp"
 
@@ -70,6 +71,10 @@ namespace server { namespace talk {
             \return link formatter */
         LinkFormatter& linkFormatter();
 
+        /** Access rendered-text cache.
+            \return cache */
+        RenderCache& renderCache();
+
         /** Access configuration.
             \return configuration */
         const Configuration& config() const;
@@ -191,6 +196,7 @@ namespace server { namespace talk {
         util::syntax::KeywordTable m_keywordTable;
         InlineRecognizer m_recognizer;
         LinkFormatter m_linkFormatter;
+        RenderCache m_renderCache;
 
         afl::net::CommandHandler& m_db;
 
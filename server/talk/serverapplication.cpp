@@ -194,6 +194,16 @@ server::talk::ServerApplication::handleConfiguration(const String_t& key, const
            To guarantee a minimum delay of N minutes, use N+1. */
         m_config.notificationDelay = parseInt(key, value);
         return true;
+    } else if (isInstanceOption(key, "RENDERCACHE")) {
+        /* @q Talk.RenderCache:Int (Config)
+           Maximum number of cached renderings per forum posting.
+           Rendered postings are stored in the database next to the posting and reused until it is edited.
+           When the limit is exceeded, the posting's cache is discarded.
+           Statistics can be obtained using {RENDERSTAT}.
+           Default is 0, disabling the cache.
+           @since PCC2 2.41.5 */
+        m_config.renderCacheSize = parseInt(key, value);
+        return true;
     } else if (key == "REDIS.HOST") {
         m_dbAddress.setName(value);
         return true;
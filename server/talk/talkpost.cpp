@@ -11,7 +11,7 @@
 #include "server/talk/notifier.hpp"
 #include "server/talk/ratelimit.hpp"
 #include "server/talk/render/context.hpp"
-#include "server/talk/render/render.hpp"
+#include "server/talk/render/options.hpp"
 #include "server/talk/root.hpp"
 #include "server/talk/session.hpp"
 #include "server/talk/spam.hpp"
@@ -259,6 +259,7 @@ server::talk::TalkPost::edit(int32_t postId, String_t subject, String_t text)
     msg.subject().set(subject);
     msg.text().set(text);
     msg.editTime().set(time);
+    m_root.renderCache().invalidate(msg);
 
     // Update topic
     Topic topic(m_root, msg.topicId().get());
@@ -308,7 +309,7 @@ server::talk::TalkPost::render(int32_t postId, const server::interface::TalkRend
     render::Options temporaryOptions(m_session.renderOptions());
     temporaryOptions.updateFrom(options);
 
-    return render::renderText(msg.text().get(), ctx, temporaryOptions, m_root);
+    return m_root.renderCache().render(msg, ctx, temporaryOptions, m_root);
 }
 
 void
@@ -323,7 +324,7 @@ server::talk::TalkPost::render(afl::base::Memory<const int32_t> postIds, afl::da
             result.push_back("");
         } else {
             ctx.setMessageId(*p);
-            result.push_back(render::renderText(msg.text().get(), ctx, m_session.renderOptions(), m_root));
+            result.push_back(m_root.renderCache().render(msg, ctx, m_session.renderOptions(), m_root));
         }
     }
 }
@@ -71,3 +71,17 @@ server::talk::TextNode::getTextContent() const
         return result;
     }
 }
+
+bool
+server::talk::TextNode::hasLink(LinkFormat kind) const
+{
+    if (major == maLink && minor == kind) {
+        return true;
+    }
+    for (size_t i = 0, n = children.size(); i < n; ++i) {
+        if (children[i]->hasLink(kind)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -96,6 +96,11 @@ namespace server { namespace talk {
         /** Get content of this node as raw text.
             \return text */
         String_t getTextContent() const;
+
+        /** Check for link.
+            \param kind Link type
+            \return true if this node or any of its children is a link of the given type */
+        bool hasLink(LinkFormat kind) const;
     };
 
 } }
@@ -7,6 +7,8 @@
 #include "afl/base/countof.hpp"
 #include "afl/data/vector.hpp"
 #include "afl/data/vectorvalue.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerfield.hpp"
 #include "afl/net/redis/stringfield.hpp"
 #include "afl/string/format.hpp"
 #include "server/common/util.hpp"
@@ -21,6 +23,18 @@ using afl::sys::Log;
 
 const char*const LOG_NAME = "user.mgmt";
 
+namespace {
+    /* Invalidate ranking list after changing a user's field, by removing its validity marker and counting the invalidation.
+       The list is rebuilt by the host service when needed (see Root::rankingRoot(), server::host::rank::Leaderboard);
+       the counter tells it whether an invalidation arrived while it was building the list.
+       For fields that have no ranking list, this only maintains an unused counter. */
+    void invalidateRanking(server::user::Root& root, const String_t& field)
+    {
+        root.rankingRoot().hashKey("valid").field(field).remove();
+        root.rankingRoot().hashKey("generation").intField(field) += 1;
+    }
+}
+
 server::user::UserManagement::UserManagement(Root& root)
     : m_root(root)
 { }
@@ -115,10 +129,13 @@ server::user::UserManagement::remove(String_t userId)
         };
         for (size_t i = 0; i < countof(profileFields); ++i) {
             u.profile().stringField(profileFields[i]).remove();
+            invalidateRanking(m_root, profileFields[i]);
         }
 
         // - revert screen name customisation
         u.profile().stringField("screenname").set(Format("(%s)", name));
+        invalidateRanking(m_root, "screenname");
+        invalidateRanking(m_root, "name");
     }
 }
 
@@ -212,6 +229,7 @@ server::user::UserManagement::setProfile(String_t userId, afl::base::Memory<cons
             } else {
                 u.profile().stringField(*pKey).set(*pValue);
             }
+            invalidateRanking(m_root, *pKey);
         }
     }
 }
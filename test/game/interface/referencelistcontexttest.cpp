@@ -7,7 +7,9 @@
 
 #include "afl/data/segment.hpp"
 #include "afl/data/stringvalue.hpp"
+#include "afl/io/constmemorystream.hpp"
 #include "afl/io/nullfilesystem.hpp"
+#include "afl/io/textfile.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/test/testrunner.hpp"
 #include "game/game.hpp"
@@ -20,10 +22,15 @@
 #include "game/turn.hpp"
 #include "interpreter/arguments.hpp"
 #include "interpreter/callablevalue.hpp"
+#include "interpreter/defaultstatementcompilationcontext.hpp"
 #include "interpreter/error.hpp"
+#include "interpreter/filecommandsource.hpp"
 #include "interpreter/indexablevalue.hpp"
 #include "interpreter/process.hpp"
+#include "interpreter/statementcompiler.hpp"
 #include "interpreter/test/contextverifier.hpp"
+#include "interpreter/values.hpp"
+#include "interpreter/world.hpp"
 
 using game::Reference;
 using game::interface::ReferenceContext;
@@ -653,3 +660,57 @@ AFL_TEST("game.interface.ReferenceListContext:Objects", a)
     }
 }
 
+
+/** Test iteration by a script.
+    A: create a list of ships and planets. Iterate it using ForEach, accessing names provided by the elements and by a global variable, some shadowed by the elements.
+    E: script sees the same values as a direct lookup on each element (regression test for name lookup caching). */
+AFL_TEST("game.interface.ReferenceListContext:Objects:ForEach", a)
+{
+    Environment env;
+    addDefaultUniverse(a, env);
+
+    afl::base::Ref<ReferenceListContext::Data> data = *new ReferenceListContext::Data();
+    data->list.add(Reference(Reference::Ship, 1));
+    data->list.add(Reference(Reference::Planet, 10));
+    data->list.add(Reference(Reference::Ship, 2));
+    data->list.add(Reference(Reference::Planet, 10));
+
+    interpreter::World& w = env.session.world();
+    w.setNewGlobalValue("RL", new ReferenceListContext(data, env.session));
+    w.setNewGlobalValue("KIND", interpreter::makeStringValue("global"));
+    w.setNewGlobalValue("EXTRA", interpreter::makeStringValue("x"));
+    w.setNewGlobalValue("R", interpreter::makeStringValue(""));
+
+    // Expected result, using uncached lookups
+    String_t expect;
+    {
+        ReferenceListContext ctx(data, env.session);
+        std::auto_ptr<afl::data::Value> obj(interpreter::test::ContextVerifier(ctx, a("Objects")).getValue("OBJECTS"));
+        interpreter::IndexableValue* ix = dynamic_cast<interpreter::IndexableValue*>(obj.get());
+        a.checkNonNull("01. IndexableValue", ix);
+        std::auto_ptr<interpreter::Context> it(ix->makeFirstContext());
+        a.checkNonNull("02. makeFirstContext", it.get());
+        do {
+            interpreter::test::ContextVerifier verif(*it, a("element"));
+            std::auto_ptr<afl::data::Value> kind(verif.getValue("KIND"));
+            std::auto_ptr<afl::data::Value> id(verif.getValue("ID"));
+            expect += interpreter::toString(kind.get(), false);
+            expect += interpreter::toString(id.get(), false);
+            expect += "x,";
+        } while (it->next());
+    }
+    a.checkEqual("03. expect", expect, "ship1x,planet10x,ship2x,planet10x,");
+
+    // Script
+    afl::io::ConstMemoryStream ms(afl::string::toBytes("ForEach RL->Objects Do R := R & Kind & Id & Extra & ','\n"));
+    afl::io::TextFile tf(ms);
+    interpreter::FileCommandSource fcs(tf);
+    interpreter::BCORef_t bco = interpreter::BytecodeObject::create(true);
+    interpreter::StatementCompiler(fcs).compileList(*bco, interpreter::DefaultStatementCompilationContext(w));
+
+    interpreter::Process& proc = env.session.processList().create(w, "p");
+    proc.pushFrame(bco, false);
+    proc.run(0);
+    a.checkEqual("11. getState", proc.getState(), interpreter::Process::Ended);
+    a.checkEqual("12. result", interpreter::toString(w.globalValues().get(w.globalPropertyNames().getIndexByName("R")), false), expect);
+}
@@ -0,0 +1,140 @@
+/**
+  *  \file test/game/map/movementpredictorextratest.cpp
+  *  \brief Test for game::map::MovementPredictorExtra
+  */
+
+#include "game/map/movementpredictorextra.hpp"
+
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/game.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+#include "game/spec/mission.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/test/root.hpp"
+#include "game/turn.hpp"
+
+using afl::base::Ptr;
+using game::Game;
+using game::map::MovementPredictor;
+using game::map::MovementPredictorExtra;
+using game::map::Point;
+using game::map::Ship;
+using game::spec::Mission;
+
+namespace {
+    const int HullId = 12;
+    const int EngineId = 3;
+    const int Owner = 2;
+
+    Ship* addShip(Game& g, game::Id_t id, Point pos, Point waypoint, int warp)
+    {
+        Ship* pShip = g.currentTurn().universe().ships().create(id);
+        game::map::ShipData data;
+        data.owner                     = Owner;
+        data.friendlyCode              = "hi";
+        data.x                         = pos.getX();
+        data.y                         = pos.getY();
+        data.waypointDX                = waypoint.getX() - pos.getX();
+        data.waypointDY                = waypoint.getY() - pos.getY();
+        data.engineType                = EngineId;
+        data.hullType                  = HullId;
+        data.beamType                  = 0;
+        data.torpedoType               = 0;
+        data.mission                   = 0;
+        data.missionTowParameter       = 0;
+        data.missionInterceptParameter = 0;
+        data.warpFactor                = warp;
+
+        pShip->addCurrentShipData(data, game::PlayerSet_t(Owner));
+        pShip->internalCheck(game::PlayerSet_t(Owner), 15);
+        pShip->setPlayability(game::map::Object::Playable);
+        return pShip;
+    }
+
+    struct Environment {
+        afl::io::NullFileSystem fs;
+        afl::string::NullTranslator tx;
+        game::Session session;
+
+        Environment()
+            : fs(), tx(), session(tx, fs)
+            {
+                session.setRoot(game::test::makeRoot(game::HostVersion()).asPtr());
+
+                Ptr<game::spec::ShipList> shipList = new game::spec::ShipList();
+                game::spec::Hull* pHull = shipList->hulls().create(HullId);
+                pHull->setMaxFuel(200);
+                pHull->setMaxCrew(100);
+                pHull->setMass(100);
+                pHull->setNumEngines(2);
+                shipList->engines().create(EngineId)->setTechLevel(5);
+                session.setShipList(shipList);
+            }
+    };
+
+    Point getPosition(afl::test::Assert a, const MovementPredictor* p, game::Id_t id)
+    {
+        Point result;
+        a.checkNonNull("getPrediction", p);
+        a.check("getShipPosition", p->getShipPosition(id).get(result));
+        return result;
+    }
+}
+
+/** Test without game. */
+AFL_TEST("game.map.MovementPredictorExtra:empty", a)
+{
+    Environment env;
+    MovementPredictorExtra& testee = MovementPredictorExtra::create(env.session);
+    a.checkEqual("01. get", MovementPredictorExtra::get(env.session), &testee);
+    a.checkEqual("02. create", &MovementPredictorExtra::create(env.session), &testee);
+    a.checkNull("03. getPrediction", testee.getPrediction());
+}
+
+/** Test normal operation: prediction follows changes to ships. */
+AFL_TEST("game.map.MovementPredictorExtra:normal", a)
+{
+    Environment env;
+    Ptr<Game> g = new Game();
+    Ship* p1 = addShip(*g, 1, Point(1000, 1000), Point(1000, 1015), 3);
+    Ship* p2 = addShip(*g, 2, Point(1000, 1000), Point(1000, 1000), 4);
+    p2->setMission(Mission::msn_Intercept, 1, 0);
+    addShip(*g, 3, Point(1100, 1000), Point(1110, 1000), 3);
+    env.session.setGame(g);
+
+    MovementPredictorExtra& testee = MovementPredictorExtra::create(env.session);
+    a.checkEqual("01. ship 1", getPosition(a, testee.getPrediction(), 1), Point(1000, 1009));
+    a.checkEqual("02. ship 2", getPosition(a, testee.getPrediction(), 2), Point(1000, 1009));
+    a.checkEqual("03. ship 3", getPosition(a, testee.getPrediction(), 3), Point(1109, 1000));
+
+    // Change ship 1; intercepting ship follows
+    p1->setWaypoint(Point(1000, 990));
+    env.session.notifyListeners();
+    a.checkEqual("11. ship 1", getPosition(a, testee.getPrediction(), 1), Point(1000, 991));
+    a.checkEqual("12. ship 2", getPosition(a, testee.getPrediction(), 2), Point(1000, 991));
+    a.checkEqual("13. ship 3", getPosition(a, testee.getPrediction(), 3), Point(1109, 1000));
+
+    // Change without notification is also picked up
+    p2->setMission(0, 0, 0);
+    a.checkEqual("21. ship 2", getPosition(a, testee.getPrediction(), 2), Point(1000, 1000));
+}
+
+/** Test game change: prediction is recomputed. */
+AFL_TEST("game.map.MovementPredictorExtra:game-change", a)
+{
+    Environment env;
+    Ptr<Game> g1 = new Game();
+    addShip(*g1, 1, Point(1000, 1000), Point(1000, 1015), 3);
+    env.session.setGame(g1);
+
+    MovementPredictorExtra& testee = MovementPredictorExtra::create(env.session);
+    a.checkEqual("01. ship 1", getPosition(a, testee.getPrediction(), 1), Point(1000, 1009));
+
+    Ptr<Game> g2 = new Game();
+    addShip(*g2, 1, Point(2000, 2000), Point(2010, 2000), 3);
+    env.session.setGame(g2);
+    a.checkEqual("11. ship 1", getPosition(a, testee.getPrediction(), 1), Point(2009, 2000));
+}
@@ -10,6 +10,7 @@
 #include "afl/io/internaldirectory.hpp"
 #include "afl/string/format.hpp"
 #include "afl/test/testrunner.hpp"
+#include "game/map/planet.hpp"
 #include "game/root.hpp"
 #include "game/spec/mission.hpp"
 #include "game/test/registrationkey.hpp"
@@ -17,6 +18,7 @@
 #include "game/test/stringverifier.hpp"
 #include "game/turn.hpp"
 
+using game::map::MovementPredictor;
 using game::map::Point;
 using game::map::Ship;
 using game::spec::Mission;
@@ -64,6 +66,38 @@ namespace {
         pShip->setPlayability(game::map::Object::Playable);
         return pShip;
     }
+
+    /* Set mission from a selector: 0=none, 1..n=tow, n+1..2n=intercept */
+    String_t setMissionFromSelector(Ship& sh, int selector, int numShips)
+    {
+        const int id = sh.getId();
+        if (selector == 0) {
+            sh.setMission(0, 0, 0);
+            return afl::string::Format(", %d passive", id);
+        } else if (selector <= numShips) {
+            sh.setMission(Mission::msn_Tow, 0, selector);
+            return afl::string::Format(", %d tows %d", id, selector);
+        } else {
+            sh.setMission(Mission::msn_Intercept, selector - numShips, id);
+            return afl::string::Format(", %d intercepts %d", id, selector - numShips);
+        }
+    }
+
+    /* Verify that two predictions are identical */
+    void checkSamePrediction(afl::test::Assert a, const MovementPredictor& actual, const MovementPredictor& expected, int numShips)
+    {
+        for (int i = 1; i <= numShips; ++i) {
+            Point actualPos, expectedPos;
+            bool actualOK = actual.getShipPosition(i).get(actualPos);
+            bool expectedOK = expected.getShipPosition(i).get(expectedPos);
+            a.checkEqual("getShipPosition", actualOK, expectedOK);
+            a.checkEqual("position", actualPos, expectedPos);
+
+            MovementPredictor::Cargo_t actualCargo, expectedCargo;
+            a.checkEqual("getShipCargo", actual.getShipCargo(i, actualCargo), expected.getShipCargo(i, expectedCargo));
+            a.check("cargo", actualCargo == expectedCargo);
+        }
+    }
 }
 
 
@@ -238,3 +272,247 @@ AFL_TEST("game.map.MovementPredictor:computeMovement:intercept-loop", a)
     a.check("15. getShipPosition", testee.getShipPosition(3).get(pt));
     a.checkEqual("16. position", pt, Point(1009, 1000));
 }
+
+/** Test incremental update.
+    Changing a ship must update the ships intercepting it, but not the others. */
+AFL_TEST("game.map.MovementPredictor:updateMovement", a)
+{
+    // Root
+    game::Root root(afl::io::InternalDirectory::create("<game>"),
+                    *new game::test::SpecificationLoader(),
+                    game::HostVersion(),
+                    std::auto_ptr<game::RegistrationKey>(new game::test::RegistrationKey(game::test::RegistrationKey::Unregistered, 6)),
+                    std::auto_ptr<game::StringVerifier>(new game::test::StringVerifier()),
+                    std::auto_ptr<afl::charset::Charset>(new afl::charset::Utf8Charset()),
+                    game::Root::Actions_t());
+
+    // Ship list
+    game::spec::ShipList shipList;
+    addSpec(shipList);
+
+    // Same setup as computeMovement:regular
+    game::Game game;
+    game::map::Universe& univ = game.currentTurn().universe();
+    Ship* p1 = addShip(univ, 1);
+    p1->setWaypoint(Point(1000, 1015));
+    p1->setWarpFactor(3);
+    Ship* p2 = addShip(univ, 2);
+    p2->setWaypoint(Point(1010, 1000));
+    p2->setWarpFactor(4);
+    Ship* p3 = addShip(univ, 3);
+    p3->setWaypoint(Point(1000, 1000));
+    p3->setMission(Mission::msn_Intercept, 2, 0);
+    p3->setWarpFactor(3);
+    Ship* p4 = addShip(univ, 4);
+    p4->setWaypoint(Point(1000, 1000));
+    p4->setMission(Mission::msn_Intercept, 2, 0);
+    p4->setWarpFactor(4);
+
+    MovementPredictor testee;
+    AFL_CHECK_SUCCEEDS(a("01. computeMovement"), testee.computeMovement(univ, game, shipList, root));
+
+    // Change ship 2's waypoint
+    p2->setWaypoint(Point(1000, 990));
+    std::vector<game::Id_t> changed;
+    changed.push_back(2);
+    AFL_CHECK_SUCCEEDS(a("11. updateMovement"), testee.updateMovement(univ, game, shipList, root, changed));
+
+    Point pt;
+    a.check("21. getShipPosition", testee.getShipPosition(1).get(pt));
+    a.checkEqual("22. position", pt, Point(1000, 1009));
+    a.check("23. getShipPosition", testee.getShipPosition(2).get(pt));
+    a.checkEqual("24. position", pt, Point(1000, 990));
+    a.check("25. getShipPosition", testee.getShipPosition(3).get(pt));
+    a.checkEqual("26. position", pt, Point(1000, 991));
+    a.check("27. getShipPosition", testee.getShipPosition(4).get(pt));
+    a.checkEqual("28. position", pt, Point(1000, 990));
+
+    // Ship 4 stops intercepting
+    p4->setMission(0, 0, 0);
+    changed[0] = 4;
+    AFL_CHECK_SUCCEEDS(a("31. updateMovement"), testee.updateMovement(univ, game, shipList, root, changed));
+    a.check("32. getShipPosition", testee.getShipPosition(4).get(pt));
+    a.checkEqual("33. position", pt, Point(1000, 1000));
+
+    // Compare to full computation
+    MovementPredictor ref;
+    ref.computeMovement(univ, game, shipList, root);
+    checkSamePrediction(a("41. full"), testee, ref, 4);
+}
+
+/** Test incremental update without previous computation.
+    This performs a full computation. */
+AFL_TEST("game.map.MovementPredictor:updateMovement:initial", a)
+{
+    // Root
+    game::Root root(afl::io::InternalDirectory::create("<game>"),
+                    *new game::test::SpecificationLoader(),
+                    game::HostVersion(),
+                    std::auto_ptr<game::RegistrationKey>(new game::test::RegistrationKey(game::test::RegistrationKey::Unregistered, 6)),
+                    std::auto_ptr<game::StringVerifier>(new game::test::StringVerifier()),
+                    std::auto_ptr<afl::charset::Charset>(new afl::charset::Utf8Charset()),
+                    game::Root::Actions_t());
+
+    // Ship list
+    game::spec::ShipList shipList;
+    addSpec(shipList);
+
+    // Two independant ships
+    game::Game game;
+    game::map::Universe& univ = game.currentTurn().universe();
+    addShip(univ, 1)->setWaypoint(Point(1000, 1015));
+    addShip(univ, 2)->setWaypoint(Point(1010, 1000));
+
+    MovementPredictor testee;
+    AFL_CHECK_SUCCEEDS(a("01. updateMovement"), testee.updateMovement(univ, game, shipList, root, std::vector<game::Id_t>()));
+
+    Point pt;
+    a.check("11. getShipPosition", testee.getShipPosition(1).get(pt));
+    a.checkEqual("12. position", pt, Point(1000, 1009));
+    a.check("13. getShipPosition", testee.getShipPosition(2).get(pt));
+    a.checkEqual("14. position", pt, Point(1009, 1000));
+}
+
+/** Brute force combination test for incremental update.
+    For all combinations of 4 ships intercepting or towing each other,
+    change one ship's mission, and verify that updateMovement() produces the same result as computeMovement(). */
+AFL_TEST("game.map.MovementPredictor:updateMovement:combinations", a)
+{
+    const int NumShips = 4;
+
+    // Root
+    game::Root root(afl::io::InternalDirectory::create("<game>"),
+                    *new game::test::SpecificationLoader(),
+                    game::HostVersion(),
+                    std::auto_ptr<game::RegistrationKey>(new game::test::RegistrationKey(game::test::RegistrationKey::Unregistered, 6)),
+                    std::auto_ptr<game::StringVerifier>(new game::test::StringVerifier()),
+                    std::auto_ptr<afl::charset::Charset>(new afl::charset::Utf8Charset()),
+                    game::Root::Actions_t());
+
+    // Ship list
+    game::spec::ShipList shipList;
+    addSpec(shipList);
+
+    // All combinations: Nothing vs. Tow each ship vs. Intercept each ship
+    const int32_t Radix = NumShips*2 + 1;
+    const int32_t Limit = Radix*Radix*Radix*Radix;         // Radix**NumShips
+    static_assert(NumShips == 4, "Limit assumes NumShips=4");
+
+    for (int32_t iteration = 0; iteration < Limit; ++iteration) {
+        // Game: set up the ships at different places
+        game::Game game;
+        game::map::Universe& univ = game.currentTurn().universe();
+        String_t iterationName = afl::string::Format("#%d", iteration);
+        int32_t selector = iteration;
+        for (int i = 1; i <= NumShips; ++i) {
+            Ship* pShip = addShip(univ, i);
+            pShip->setPosition(Point(1000 + 10*i, 1000));
+            pShip->setWaypoint(Point(1000 + 10*i, 1000 + 7*i));
+            pShip->setWarpFactor(i+1);
+            iterationName += setMissionFromSelector(*pShip, selector % Radix, NumShips);
+            selector /= Radix;
+        }
+
+        MovementPredictor testee;
+        AFL_CHECK_SUCCEEDS(a(iterationName), testee.computeMovement(univ, game, shipList, root));
+
+        // Change one ship
+        const int changedId = iteration % NumShips + 1;
+        iterationName += ", then" + setMissionFromSelector(*univ.ships().get(changedId), (iteration / NumShips) % Radix, NumShips);
+        std::vector<game::Id_t> changed;
+        changed.push_back(changedId);
+        AFL_CHECK_SUCCEEDS(a(iterationName), testee.updateMovement(univ, game, shipList, root, changed));
+
+        // Compare
+        MovementPredictor ref;
+        ref.computeMovement(univ, game, shipList, root);
+        checkSamePrediction(a(iterationName), testee, ref, NumShips);
+    }
+}
+
+/** Test collectAffectedShips(), getShipLinks().
+    A: create ships with current and previous tow/intercept links.
+    E: changed ships produce their groups, using current and previous links. */
+AFL_TEST("game.map.MovementPredictor:collectAffectedShips", a)
+{
+    game::map::Universe univ;
+    for (int i = 1; i <= 5; ++i) {
+        addShip(univ, i);
+    }
+    univ.ships().get(2)->setMission(Mission::msn_Tow, 0, 3);
+    univ.ships().get(5)->setMission(Mission::msn_Intercept, 5, 0);
+
+    // Links
+    a.checkEqual("01. tow",       MovementPredictor::getShipLinks(*univ.ships().get(2)).towId, 3);
+    a.checkEqual("02. intercept", MovementPredictor::getShipLinks(*univ.ships().get(2)).interceptId, 0);
+    a.checkEqual("03. tow",       MovementPredictor::getShipLinks(*univ.ships().get(5)).towId, 0);
+    a.checkEqual("04. intercept", MovementPredictor::getShipLinks(*univ.ships().get(5)).interceptId, 0);   // intercepting itself is ignored
+
+    // Previously, ship 4 intercepted ship 1, and nonexistant ship 7 intercepted ship 5
+    std::vector<MovementPredictor::Links> previousLinks(8);
+    previousLinks[4].interceptId = 1;
+    previousLinks[7].interceptId = 5;
+
+    // Ship 1 changed: affects 4 through previous link
+    {
+        std::vector<game::Id_t> changed(1, 1), result;
+        MovementPredictor::collectAffectedShips(univ, previousLinks, changed, result);
+        a.checkEqual("11. size", result.size(), 2U);
+        a.checkEqual("12. ship", result[0], 1);
+        a.checkEqual("13. ship", result[1], 4);
+    }
+
+    // Ship 3 changed: affects 2 through current link
+    {
+        std::vector<game::Id_t> changed(1, 3), result;
+        MovementPredictor::collectAffectedShips(univ, previousLinks, changed, result);
+        a.checkEqual("21. size", result.size(), 2U);
+        a.checkEqual("22. ship", result[0], 2);
+        a.checkEqual("23. ship", result[1], 3);
+    }
+
+    // Ship 5 changed: reports nonexistant ship 7
+    {
+        std::vector<game::Id_t> changed(1, 5), result;
+        MovementPredictor::collectAffectedShips(univ, previousLinks, changed, result);
+        a.checkEqual("31. size", result.size(), 2U);
+        a.checkEqual("32. ship", result[0], 5);
+        a.checkEqual("33. ship", result[1], 7);
+    }
+}
+
+/** Test findChangedShips().
+    A: create ships, one at a planet. Mark a ship and the planet dirty.
+    E: dirty ship and ship orbiting the dirty planet reported. */
+AFL_TEST("game.map.MovementPredictor:findChangedShips", a)
+{
+    game::map::Universe univ;
+    for (int i = 1; i <= 3; ++i) {
+        addShip(univ, i);
+    }
+    univ.ships().get(2)->setPosition(Point(1200, 1300));
+    game::map::Planet* pl = univ.planets().create(7);
+    pl->setPosition(Point(1200, 1300));
+
+    // Nothing dirty
+    {
+        std::vector<game::Id_t> result;
+        for (int i = 1; i <= 3; ++i) {
+            univ.ships().get(i)->markClean();
+        }
+        pl->markClean();
+        MovementPredictor::findChangedShips(univ, result);
+        a.checkEqual("01. size", result.size(), 0U);
+    }
+
+    // Ship 3 and planet dirty
+    {
+        std::vector<game::Id_t> result;
+        univ.ships().get(3)->markDirty();
+        pl->markDirty();
+        MovementPredictor::findChangedShips(univ, result);
+        a.checkEqual("11. size", result.size(), 2U);
+        a.checkEqual("12. ship", result[0], 2);
+        a.checkEqual("13. ship", result[1], 3);
+    }
+}
@@ -0,0 +1,133 @@
+/**
+  *  \file test/game/map/spatialindextest.cpp
+  *  \brief Test for game::map::SpatialIndex
+  */
+
+#include "game/map/spatialindex.hpp"
+
+#include "afl/test/testrunner.hpp"
+#include "game/map/configuration.hpp"
+
+using game::Id_t;
+using game::map::Configuration;
+using game::map::Point;
+using game::map::SpatialIndex;
+
+/** Test basic operations: add, move, remove, point query. */
+AFL_TEST("game.map.SpatialIndex:basics", a)
+{
+    SpatialIndex testee;
+    a.checkEqual("01. getNumObjects", testee.getNumObjects(), 0U);
+
+    testee.setPosition(7, Point(1000, 1000));
+    testee.setPosition(3, Point(1000, 1000));
+    testee.setPosition(5, Point(1000, 1001));
+    a.checkEqual("11. getNumObjects", testee.getNumObjects(), 3U);
+
+    // Point query returns Ids in order
+    std::vector<Id_t> result;
+    testee.findAt(Point(1000, 1000), result);
+    a.checkEqual("21. size", result.size(), 2U);
+    a.checkEqual("22. result", result[0], 3);
+    a.checkEqual("23. result", result[1], 7);
+
+    // Move
+    testee.setPosition(3, Point(1000, 1001));
+    result.clear();
+    testee.findAt(Point(1000, 1000), result);
+    a.checkEqual("31. size", result.size(), 1U);
+    a.checkEqual("32. result", result[0], 7);
+    a.checkEqual("33. getNumObjects", testee.getNumObjects(), 3U);
+    a.checkEqual("34. getPosition", testee.getPosition(3).orElse(Point()), Point(1000, 1001));
+
+    // Remove
+    testee.setPosition(7, afl::base::Nothing);
+    result.clear();
+    testee.findAt(Point(1000, 1000), result);
+    a.checkEqual("41. size", result.size(), 0U);
+    a.checkEqual("42. getNumObjects", testee.getNumObjects(), 2U);
+    a.check("43. getPosition", !testee.getPosition(7).isValid());
+
+    // Invalid Ids are ignored
+    testee.setPosition(0, Point(1, 1));
+    testee.setPosition(-1, Point(1, 1));
+    a.checkEqual("51. getNumObjects", testee.getNumObjects(), 2U);
+
+    // Clear
+    testee.clear();
+    a.checkEqual("61. getNumObjects", testee.getNumObjects(), 0U);
+    a.check("62. getPosition", !testee.getPosition(3).isValid());
+}
+
+/** Test range query on flat map. */
+AFL_TEST("game.map.SpatialIndex:findInRange:flat", a)
+{
+    Configuration config;
+    SpatialIndex testee;
+    testee.setPosition(1, Point(1000, 1000));
+    testee.setPosition(2, Point(1003, 1000));
+    testee.setPosition(3, Point(1000, 1004));
+    testee.setPosition(4, Point(997, 997));
+    testee.setPosition(5, Point(1100, 1000));
+
+    std::vector<Id_t> result;
+    testee.findInRange(Point(1000, 1000), 3, config, result);
+    a.checkEqual("01. size", result.size(), 3U);
+    a.checkEqual("02. result", result[0], 1);
+    a.checkEqual("03. result", result[1], 2);
+    a.checkEqual("04. result", result[2], 4);
+}
+
+/** Test range query on wrapped map.
+    Objects near the opposite edge must be found. */
+AFL_TEST("game.map.SpatialIndex:findInRange:wrap", a)
+{
+    Configuration config;
+    config.setConfiguration(Configuration::Wrapped, Point(2000, 2000), Point(2000, 2000));
+
+    SpatialIndex testee;
+    testee.setPosition(1, Point(1001, 2000));
+    testee.setPosition(2, Point(2998, 2000));
+    testee.setPosition(3, Point(1500, 2000));
+
+    std::vector<Id_t> result;
+    testee.findInRange(Point(2999, 2000), 3, config, result);
+    a.checkEqual("01. size", result.size(), 2U);
+    a.checkEqual("02. result", result[0], 1);
+    a.checkEqual("03. result", result[1], 2);
+}
+
+/** Test bulk loading with setPositions(). */
+AFL_TEST("game.map.SpatialIndex:setPositions", a)
+{
+    SpatialIndex testee;
+    testee.setPosition(2, Point(500, 500));
+
+    std::vector<afl::base::Optional<Point> > positions(10);
+    positions[0] = Point(1000, 1000);           // ignored
+    positions[9] = Point(1000, 1000);
+    positions[4] = Point(1000, 1000);
+    positions[6] = Point(1000, 1001);
+    testee.setPositions(positions);
+
+    // Previous content replaced
+    a.checkEqual("01. getNumObjects", testee.getNumObjects(), 3U);
+    a.check("02. getPosition", !testee.getPosition(2).isValid());
+    a.check("03. getPosition", !testee.getPosition(0).isValid());
+    a.checkEqual("04. getPosition", testee.getPosition(6).orElse(Point()), Point(1000, 1001));
+
+    // Point query returns Ids in order
+    std::vector<Id_t> result;
+    testee.findAt(Point(1000, 1000), result);
+    a.checkEqual("11. size", result.size(), 2U);
+    a.checkEqual("12. result", result[0], 4);
+    a.checkEqual("13. result", result[1], 9);
+
+    // Index remains updatable
+    testee.setPosition(4, Point(1000, 1001));
+    result.clear();
+    testee.findAt(Point(1000, 1001), result);
+    a.checkEqual("21. size", result.size(), 2U);
+    a.checkEqual("22. result", result[0], 4);
+    a.checkEqual("23. result", result[1], 6);
+}
@@ -255,3 +255,80 @@ AFL_TEST("game.map.Universe:find", a)
     a.checkEqual("161. findLocationUnitNames", u.findLocationUnitNames(Point(1020, 1000), 5, pl, mapConfig, tx, iface), "Planet #40: Fourty\n1 fourish ship");
     a.checkEqual("162. findLocationUnitNames", u.findLocationUnitNames(Point(1020, 1000), 4, pl, mapConfig, tx, iface), "Planet #40: Fourty\nShip #8: Eight");
 }
+
+/** Test location accessors with spatial index on wrapped map.
+    A: create wrapped map with planets near the seam; postprocess (builds index).
+    E: gravity wells and point lookups work across the seam */
+AFL_TEST("game.map.Universe:find:wrap", a)
+{
+    game::map::Configuration mapConfig;
+    mapConfig.setConfiguration(game::map::Configuration::Wrapped, Point(2000, 2000), Point(2000, 2000));
+    game::HostVersion tim(game::HostVersion::Host, MKVERSION(3,22,0));
+    game::HostVersion andrew(game::HostVersion::PHost, MKVERSION(3,2,5));
+    Ref<HostConfiguration> rconfig = HostConfiguration::create();
+    HostConfiguration& config = *rconfig;
+    config[HostConfiguration::AllowGravityWells].set(1);
+    config[HostConfiguration::RoundGravityWells].set(1);
+    game::spec::ShipList sl;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+
+    Universe u;
+    u.planets().create(10)->setPosition(Point(1001, 2000));
+    u.planets().create(20)->setPosition(Point(2500, 2500));
+    u.postprocess(game::PlayerSet_t(5), game::PlayerSet_t(5), game::map::Object::Playable, mapConfig, tim, config, 7, sl, tx, log);
+
+    a.checkEqual("01. findPlanetAt",        u.findPlanetAt(Point(1001, 2000)), 10);
+    a.checkEqual("02. findPlanetAt",        u.findPlanetAt(Point(1002, 2000)), 0);
+    a.checkEqual("03. findPlanetAt",        u.findPlanetAt(Point(3001, 2000), false, mapConfig, config, andrew), 10);
+    a.checkEqual("04. findGravityPlanetAt", u.findGravityPlanetAt(Point(2999, 2000), mapConfig, config, andrew), 10);
+    a.checkEqual("05. findGravityPlanetAt", u.findGravityPlanetAt(Point(2999, 2000), mapConfig, config, tim), 10);
+    a.checkEqual("06. findGravityPlanetAt", u.findGravityPlanetAt(Point(2995, 2000), mapConfig, config, andrew), 0);
+}
+
+/** Test that location accessors track moved objects.
+    A: postprocess universe (builds index); move a planet and a ship, with and without notifyListeners().
+    E: accessors report new positions */
+AFL_TEST("game.map.Universe:find:moved", a)
+{
+    const game::map::Configuration mapConfig;
+    game::HostVersion tim(game::HostVersion::Host, MKVERSION(3,22,0));
+    Ref<HostConfiguration> rconfig = HostConfiguration::create();
+    game::spec::ShipList sl;
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+
+    Universe u;
+    game::map::Planet* p = u.planets().create(10);
+    p->setPosition(Point(1000, 1000));
+    game::map::Ship* s = u.ships().create(5);
+    s->addShipXYData(Point(1200, 1200), 4, 100, game::PlayerSet_t(5));
+    u.postprocess(game::PlayerSet_t(5), game::PlayerSet_t(5), game::map::Object::Playable, mapConfig, tim, *rconfig, 7, sl, tx, log);
+    u.notifyListeners();
+
+    a.checkEqual("01. findPlanetAt",    u.findPlanetAt(Point(1000, 1000)), 10);
+    a.checkEqual("02. findFirstShipAt", u.findFirstShipAt(Point(1200, 1200)), 5);
+
+    p->setPosition(Point(1100, 1100));
+    s->setPosition(Point(1300, 1300));
+    u.notifyListeners();
+
+    a.checkEqual("11. findPlanetAt",    u.findPlanetAt(Point(1000, 1000)), 0);
+    a.checkEqual("12. findPlanetAt",    u.findPlanetAt(Point(1100, 1100)), 10);
+    a.checkEqual("13. findFirstShipAt", u.findFirstShipAt(Point(1200, 1200)), 0);
+    a.checkEqual("14. findFirstShipAt", u.findFirstShipAt(Point(1300, 1300)), 5);
+
+    // Moves are visible before notifyListeners()
+    p->setPosition(Point(1110, 1110));
+    s->setPosition(Point(1310, 1310));
+    a.checkEqual("15. findPlanetAt",    u.findPlanetAt(Point(1100, 1100)), 0);
+    a.checkEqual("16. findPlanetAt",    u.findPlanetAt(Point(1110, 1110)), 10);
+    a.checkEqual("17. findFirstShipAt", u.findFirstShipAt(Point(1300, 1300)), 0);
+    a.checkEqual("18. findFirstShipAt", u.findFirstShipAt(Point(1310, 1310)), 5);
+    u.notifyListeners();
+
+    // Objects added later are found as well
+    u.planets().create(20)->setPosition(Point(1500, 1500));
+    u.postprocess(game::PlayerSet_t(5), game::PlayerSet_t(5), game::map::Object::Playable, mapConfig, tim, *rconfig, 7, sl, tx, log);
+    a.checkEqual("21. findPlanetAt",    u.findPlanetAt(Point(1500, 1500)), 20);
+}
@@ -0,0 +1,130 @@
+/**
+  *  \file test/game/parser/batchparsertest.cpp
+  *  \brief Test for game::parser::BatchParser
+  */
+
+#include "game/parser/batchparser.hpp"
+
+#include "afl/io/constmemorystream.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/sys/log.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/parser/datainterface.hpp"
+#include "game/parser/messageparser.hpp"
+#include "game/parser/messagevalue.hpp"
+
+using game::parser::BatchParser;
+using game::parser::MessageInformation;
+using game::parser::MessageParser;
+
+namespace {
+    class NullDataInterface : public game::parser::DataInterface {
+     public:
+        virtual int getPlayerNumber() const
+            { return 3; }
+        virtual int parseName(Name /*which*/, const String_t& /*name*/) const
+            { return 0; }
+        virtual String_t expandRaceNames(String_t name) const
+            { return name; }
+    };
+
+    const char*const DEFINITIONS =
+        "config,ScanRange\n"
+        "  kind     = g\n"
+        "  parse    = Ships are visible at $\n"
+        "  assign   = ScanRange\n"
+        "  continue = y\n"
+        "\n"
+        "config,Hiss\n"
+        "  kind     = g\n"
+        "  parse    = hiss mission $\n"
+        "  assign   = AllowHiss\n";
+
+    /* Get a configuration value, or "-" if none */
+    String_t getConfig(const MessageInformation& info, const char* key)
+    {
+        for (MessageInformation::Iterator_t i = info.begin(), e = info.end(); i != e; ++i) {
+            if (const game::parser::MessageConfigurationValue_t* p = dynamic_cast<const game::parser::MessageConfigurationValue_t*>(*i)) {
+                if (p->getIndex() == key) {
+                    return p->getValue();
+                }
+            }
+        }
+        return "-";
+    }
+
+    /* Parse messages using BatchParser and compare to regular parsing */
+    void testParse(afl::test::Assert a, size_t numThreads)
+    {
+        const int NUM = 50;
+        afl::string::NullTranslator tx;
+        afl::sys::Log log;
+        NullDataInterface iface;
+
+        MessageParser parser;
+        afl::io::ConstMemoryStream ms(afl::string::toBytes(DEFINITIONS));
+        parser.load(ms, tx, log);
+
+        std::vector<String_t> texts;
+        for (int i = 0; i < NUM; ++i) {
+            String_t text = afl::string::Format("(-%c0000)<<< Message %d >>>\n", (i % 3 == 0 ? 'h' : 'g'), i);
+            if (i % 2 == 0) {
+                text += afl::string::Format("Ships are visible at  %d\n", 100 + i);
+            }
+            if (i % 5 == 0) {
+                text += "hiss mission  YES\n";
+            }
+            texts.push_back(text);
+        }
+
+        afl::container::PtrVector<BatchParser::Infos_t> results;
+        BatchParser(parser, iface, tx, log, numThreads).parse(texts, 40, results);
+
+        a.checkEqual("01. size", results.size(), size_t(NUM));
+        for (int i = 0; i < NUM; ++i) {
+            afl::test::Assert aa(a(afl::string::Format("message %d", i)));
+            BatchParser::Infos_t ref;
+            parser.parseMessage(texts[i], iface, 40, ref, tx, log);
+
+            const BatchParser::Infos_t& result = *results[i];
+            aa.checkEqual("11. size", result.size(), ref.size());
+            for (size_t j = 0; j < result.size() && j < ref.size(); ++j) {
+                aa.checkEqual("12. SCANRANGE", getConfig(*result[j], "SCANRANGE"), getConfig(*ref[j], "SCANRANGE"));
+                aa.checkEqual("13. ALLOWHISS", getConfig(*result[j], "ALLOWHISS"), getConfig(*ref[j], "ALLOWHISS"));
+            }
+        }
+
+        // Spot check
+        a.checkEqual("21. size", results[2]->size(), 1U);
+        a.checkEqual("22. SCANRANGE", getConfig(*(*results[2])[0], "SCANRANGE"), "102");
+        a.checkEqual("23. size", results[3]->size(), 0U);
+    }
+}
+
+/** Parse in calling thread. */
+AFL_TEST("game.parser.BatchParser:parse:single", a)
+{
+    testParse(a, 0);
+}
+
+/** Parse with multiple threads. */
+AFL_TEST("game.parser.BatchParser:parse:multi", a)
+{
+    testParse(a, 4);
+}
+
+/** Parse empty list. */
+AFL_TEST("game.parser.BatchParser:parse:empty", a)
+{
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    NullDataInterface iface;
+    MessageParser parser;
+
+    std::vector<String_t> texts;
+    afl::container::PtrVector<BatchParser::Infos_t> results;
+    results.pushBackNew(new BatchParser::Infos_t());
+    BatchParser(parser, iface, tx, log, 4).parse(texts, 40, results);
+    a.checkEqual("01. size", results.size(), 0U);
+}
@@ -451,6 +451,79 @@ AFL_TEST("game.parser.MessageParser:multiple", a)
     }
 }
 
+/** Test template order and continue flag with templates of different kinds. */
+AFL_TEST("game.parser.MessageParser:order", a)
+{
+    const char* FILE =
+        "config,First\n"
+        "  check    = Marker\n"
+        "  value    = 1\n"
+        "  assign   = First\n"
+        "  continue = y\n"
+        "\n"
+        "config,Second\n"
+        "  kind     = h\n"
+        "  check    = Marker\n"
+        "  value    = 2\n"
+        "  assign   = Second\n"
+        "\n"
+        "config,Third\n"
+        "  check    = Marker\n"
+        "  value    = 3\n"
+        "  assign   = Third\n"
+        "\n"
+        "config,Fourth\n"
+        "  kind     = g\n"
+        "  check    = Other\n"
+        "  value    = 4\n"
+        "  assign   = Fourth\n";
+    afl::string::NullTranslator tx;
+    afl::sys::Log log;
+    afl::io::ConstMemoryStream ms(afl::string::toBytes(FILE));
+
+    // Load
+    game::parser::MessageParser testee;
+    AFL_CHECK_SUCCEEDS(a("01. load"), testee.load(ms, tx, log));
+    a.checkEqual("02. getNumTemplates", testee.getNumTemplates(), 4U);
+    MockDataInterface ifc;
+
+    // Kind h: First, Second (stops)
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("(-h0000)<<< Test >>>\nthe marker\n", ifc, 30, info, tx, log);
+        a.checkEqual("11. size", info.size(), 1U);
+        a.checkEqual("12. FIRST",  getValue<game::parser::MessageConfigurationValue_t>(*info[0], "FIRST", "First"), "1");
+        a.checkEqual("13. SECOND", getValue<game::parser::MessageConfigurationValue_t>(*info[0], "SECOND", "Second"), "2");
+        AFL_CHECK_THROWS(a("14. THIRD"), getValue<game::parser::MessageConfigurationValue_t>(*info[0], "THIRD", "Third"), std::exception);
+    }
+
+    // Kind g: First, Third (stops)
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("(-g0000)<<< Test >>>\nother MARKER\n", ifc, 30, info, tx, log);
+        a.checkEqual("21. size", info.size(), 1U);
+        a.checkEqual("22. FIRST",  getValue<game::parser::MessageConfigurationValue_t>(*info[0], "FIRST", "First"), "1");
+        a.checkEqual("23. THIRD",  getValue<game::parser::MessageConfigurationValue_t>(*info[0], "THIRD", "Third"), "3");
+        AFL_CHECK_THROWS(a("24. FOURTH"), getValue<game::parser::MessageConfigurationValue_t>(*info[0], "FOURTH", "Fourth"), std::exception);
+    }
+
+    // Kind g without marker: Fourth
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("(-g0000)<<< Test >>>\nother\n", ifc, 30, info, tx, log);
+        a.checkEqual("31. size", info.size(), 1U);
+        a.checkEqual("32. FOURTH", getValue<game::parser::MessageConfigurationValue_t>(*info[0], "FOURTH", "Fourth"), "4");
+    }
+
+    // Malformed header: First, Third
+    {
+        afl::container::PtrVector<game::parser::MessageInformation> info;
+        testee.parseMessage("marker", ifc, 30, info, tx, log);
+        a.checkEqual("41. size", info.size(), 1U);
+        a.checkEqual("42. THIRD",  getValue<game::parser::MessageConfigurationValue_t>(*info[0], "THIRD", "Third"), "3");
+    }
+}
+
 /** Test score parsing. */
 AFL_TEST("game.parser.MessageParser:score", a)
 {
@@ -552,6 +552,26 @@ AFL_TEST("game.parser.MessageTemplate:match:iMatchKind", a)
     }
 }
 
+/** Test getRequiredKind(), getRequiredText(). */
+AFL_TEST("game.parser.MessageTemplate:getRequiredKind+getRequiredText", a)
+{
+    // Blank template
+    game::parser::MessageTemplate t1(game::parser::MessageInformation::Planet, "t1");
+    a.checkEqual("01. getRequiredKind", t1.getRequiredKind(), 0);
+    a.checkEqual("02. getRequiredText", t1.getRequiredText(), "");
+
+    // Template with kind and checks; longest literal check is reported in upper case
+    game::parser::MessageTemplate t2(game::parser::MessageInformation::Planet, "t2");
+    t2.addMatchInstruction(game::parser::MessageTemplate::iMatchSubId, 'x');
+    t2.addMatchInstruction(game::parser::MessageTemplate::iMatchKind, 'p');
+    t2.addCheckInstruction(game::parser::MessageTemplate::iCheck, 0, "Short");
+    t2.addCheckInstruction(game::parser::MessageTemplate::iCheck + game::parser::MessageTemplate::sFixed, 2, "Longer text");
+    t2.addCheckInstruction(game::parser::MessageTemplate::iCheck, 0, "Longest, but with %1 placeholder");
+    t2.addCheckInstruction(game::parser::MessageTemplate::iFail, 0, "Longest negative text is not required");
+    a.checkEqual("11. getRequiredKind", t2.getRequiredKind(), 'p');
+    a.checkEqual("12. getRequiredText", t2.getRequiredText(), "LONGER TEXT");
+}
+
 /** Test match() with metadata information: SubId.
     Also test extraction of player. */
 AFL_TEST("game.parser.MessageTemplate:match:iMatchSubId", a)
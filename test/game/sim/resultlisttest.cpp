@@ -286,6 +286,64 @@ AFL_TEST("game.sim.ResultList:multiple-classes", a)
     a.checkEqual("48. getClassResult",          testee.getClassResult(2)->getClass().get(2), 0);
 }
 
+/** Test merge(): merging partial results must produce the same result as adding sequentially. */
+AFL_TEST("game.sim.ResultList:merge", a)
+{
+    // Setups
+    Setup before; addShip(a, before, 1, 0, 10);    addShip(a, before, 1, 0, 10);    addShip(a, before, 2, 0, 10);
+    Setup after1; addShip(a, after1, 1, 30, 10);   addShip(a, after1, 0, 100, 10);  addShip(a, after1, 0, 100, 10);
+    Setup after2; addShip(a, after2, 1, 20, 10);   addShip(a, after2, 1, 40, 10);   addShip(a, after2, 0, 100, 10);
+    Setup after3; addShip(a, after3, 0, 100, 10);  addShip(a, after3, 0, 100, 10);  addShip(a, after3, 2, 80, 10);
+    Statistic stats[] = { makeStatistic(8), makeStatistic(18) };
+
+    // Main list: one result
+    game::sim::ResultList testee;
+    testee.addResult(before, after1, stats, makeResult(0));
+
+    // Partial list: starts with a nonzero battle index
+    game::sim::ResultList partial;
+    game::sim::Result r2 = makeResult(2);
+    partial.addResult(before, after2, stats, r2);
+    partial.addResult(before, after3, stats, makeResult(3));
+    partial.addResult(before, after3, stats, makeResult(4));
+    a.checkEqual("01. getNumBattles", partial.getNumBattles(), 3U);
+    a.checkEqual("02. min", partial.getUnitResult(0)->getDamage().min, 20);
+    a.checkEqual("03. max", partial.getUnitResult(0)->getDamage().max, 100);
+
+    // Merge
+    testee.merge(partial);
+    a.checkEqual("11. getNumBattles",           partial.getNumBattles(), 0U);
+    a.checkEqual("12. getNumClassResults",      partial.getNumClassResults(), 0U);
+
+    // Verify
+    //        Fed Liz
+    //   2x    0   1
+    //   1x    1   0
+    //   1x    2   0
+    a.checkEqual("21. getNumBattles",           testee.getNumBattles(), 4U);
+    a.checkEqual("22. getCumulativeWeight",     testee.getCumulativeWeight(), 4);
+    a.checkEqual("23. getNumClassResults",      testee.getNumClassResults(), 3U);
+    a.checkEqual("24. getClassResult",          testee.getClassResult(0)->getClass().get(2), 1);
+    a.checkEqual("25. getWeight",               testee.getClassResult(0)->getWeight(), 2);
+    a.checkEqual("26. getClassResult",          testee.getClassResult(1)->getClass().get(1), 1);
+    a.checkEqual("27. getClassResult",          testee.getClassResult(2)->getClass().get(1), 2);
+    a.checkEqual("28. getLastClassResultIndex", testee.getLastClassResultIndex(), 0U);
+
+    a.checkEqual("31. min",         testee.getUnitResult(0)->getDamage().min, 20);
+    a.checkEqual("32. minSpecimen", testee.getUnitResult(0)->getDamage().minSpecimen.get(), r2.battles.get());
+    a.checkEqual("33. max",         testee.getUnitResult(0)->getDamage().max, 100);
+    a.checkEqual("34. totalScaled", testee.getUnitResult(0)->getDamage().totalScaled, 250);
+    a.checkEqual("35. won",         testee.getUnitResult(1)->getNumFightsWon(), 1);
+
+    // Merging into an empty list
+    game::sim::ResultList empty;
+    empty.merge(testee);
+    a.checkEqual("41. getNumBattles",      empty.getNumBattles(), 4U);
+    a.checkEqual("42. getNumClassResults", empty.getNumClassResults(), 3U);
+    a.checkEqual("43. totalScaled",        empty.getUnitResult(0)->getDamage().totalScaled, 250);
+    a.checkEqual("44. getNumBattles",      testee.getNumBattles(), 0U);
+}
+
 AFL_TEST("game.sim.ResultList:describeUnitResult", a)
 {
     // Setups
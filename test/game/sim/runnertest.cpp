@@ -4,7 +4,7 @@
   *
   *  Runner is abstract.
   *  Instead of mocking its run() (which would look mostly like SimpleRunner::run),
-  *  test the actual implementations (SimpleRunner, ParallelRunner) against each other.
+  *  test the actual implementations (SimpleRunner, ParallelRunner, BatchRunner) against each other.
   *  Both must produce the same results and external behaviour.
   */
 
@@ -13,6 +13,7 @@
 #include "afl/base/signalconnection.hpp"
 #include "afl/sys/log.hpp"
 #include "afl/test/testrunner.hpp"
+#include "game/sim/batchrunner.hpp"
 #include "game/sim/parallelrunner.hpp"
 #include "game/sim/setup.hpp"
 #include "game/sim/ship.hpp"
@@ -206,6 +207,23 @@ AFL_TEST("game.sim.Runner:regression1", a)
     checkRegression1(a("ParallelRunner"), parallelRunner);
 
     a.checkEqual("21. getSeed", parallelRNG.getSeed(), simpleRNG.getSeed());
+
+    // BatchRunner
+    util::RandomNumberGenerator batchRNG(42);
+    game::sim::BatchRunner batchRunner(setup, opts, shipList, *config, flakConfiguration, log, batchRNG, 3, 7);
+    batchRunner.init();
+    a.checkEqual("31. getNumBattles", batchRunner.resultList().getNumBattles(), 1U);
+
+    batchRunner.run(batchRunner.makeSeriesLimit(), sig);
+    checkRegression1(a("BatchRunner"), batchRunner);
+
+    a.checkEqual("41. getSeed", batchRNG.getSeed(), simpleRNG.getSeed());
+
+    // Jobs are reused: allocation count depends on parallelism, not on number of simulations.
+    // A BatchRunner worker can hold a finished and a queued batch.
+    a.checkEqual("51. getNumAllocatedJobs", simpleRunner.getNumAllocatedJobs(), 1U);
+    a.checkEqual("52. getNumAllocatedJobs", parallelRunner.getNumAllocatedJobs(), 1U);
+    a.checkLessEqual("53. getNumAllocatedJobs", batchRunner.getNumAllocatedJobs(), 2*3*7U);
 }
 
 /** Regression test 2: 3 vs 3 outriders. */
@@ -261,6 +279,17 @@ AFL_TEST("game.sim.Runner:regression2", a)
     checkRegression2(a("ParallelRunner"), parallelRunner);
 
     a.checkEqual("21. getSeed", parallelRNG.getSeed(), simpleRNG.getSeed());
+
+    // BatchRunner
+    util::RandomNumberGenerator batchRNG(77);
+    game::sim::BatchRunner batchRunner(setup, opts, shipList, *config, flakConfiguration, log, batchRNG, 5);
+    batchRunner.init();
+    a.checkEqual("31. getNumBattles", batchRunner.resultList().getNumBattles(), 1U);
+
+    batchRunner.run(batchRunner.makeFiniteLimit(999), sig);
+    checkRegression2(a("BatchRunner"), batchRunner);
+
+    a.checkEqual("41. getSeed", batchRNG.getSeed(), simpleRNG.getSeed());
 }
 
 /** Test interruptability. This test will not terminate on error.
@@ -302,4 +331,48 @@ AFL_TEST("game.sim.Runner:interrupt", a)
     game::sim::ParallelRunner parallelRunner(setup, opts, shipList, *config, flakConfiguration, log, parallelRNG, 5);
     parallelRunner.init();
     checkInterrupt(a("ParallelRunner"), parallelRunner);
+
+    // BatchRunner
+    util::RandomNumberGenerator batchRNG(77);
+    game::sim::BatchRunner batchRunner(setup, opts, shipList, *config, flakConfiguration, log, batchRNG, 5);
+    batchRunner.init();
+    checkInterrupt(a("BatchRunner"), batchRunner);
+}
+
+/** Test BatchRunner with more threads than jobs.
+    A: create BatchRunner with large batch size and many threads; run fewer simulations than that.
+    E: exactly the requested number of simulations is run (work-stealing does not lose or duplicate jobs) */
+AFL_TEST("game.sim.Runner:batch:small", a)
+{
+    // Ship list
+    game::spec::ShipList shipList;
+    game::test::initStandardBeams(shipList);
+    game::test::initStandardTorpedoes(shipList);
+    game::test::addOutrider(shipList);
+    game::test::addTranswarp(shipList);
+
+    // Setup
+    game::sim::Setup setup;
+    addOutrider(a, setup, 1, 4, shipList);
+    addOutrider(a, setup, 2, 6, shipList);
+
+    // Host configuration
+    afl::base::Ref<game::config::HostConfiguration> config = game::config::HostConfiguration::create();
+    game::vcr::flak::Configuration flakConfiguration;
+
+    // Configuration
+    game::sim::Configuration opts;
+    opts.setMode(game::sim::Configuration::VcrHost, 0, *config);
+
+    util::StopSignal sig;
+    afl::sys::Log log;
+
+    util::RandomNumberGenerator rng(12);
+    game::sim::BatchRunner testee(setup, opts, shipList, *config, flakConfiguration, log, rng, 8, 100);
+    testee.init();
+    testee.run(testee.makeFiniteLimit(10), sig);
+    a.checkEqual("01. getNumBattles", testee.resultList().getNumBattles(), 11U);
+
+    testee.run(testee.makeFiniteLimit(3), sig);
+    a.checkEqual("02. getNumBattles", testee.resultList().getNumBattles(), 14U);
 }
@@ -106,6 +106,44 @@ AFL_TEST("game.sim.Setup:object-management", a)
     a.checkEqual("81. getNumObjects", copy.getNumObjects(), 3U);
 }
 
+/** Test assignment: existing objects are reused. */
+AFL_TEST("game.sim.Setup:assign", a)
+{
+    Setup orig;
+    orig.addShip()->setId(10);
+    orig.addShip()->setId(20);
+    orig.addPlanet()->setId(30);
+
+    // Same structure: objects are reused
+    Setup testee(orig);
+    Ship* s1 = testee.getShip(0);
+    Planet* p = testee.getPlanet();
+    s1->setId(11);
+    p->setId(31);
+    testee = orig;
+    a.checkEqual("01. getShip", testee.getShip(0), s1);
+    a.checkEqual("02. getPlanet", testee.getPlanet(), p);
+    a.checkEqual("03. getId", s1->getId(), 10);
+    a.checkEqual("04. getId", p->getId(), 30);
+
+    // Fewer ships, no planet
+    Setup small;
+    small.addShip()->setId(40);
+    testee = small;
+    a.checkEqual("11. getNumShips", testee.getNumShips(), 1U);
+    a.checkEqual("12. getShip", testee.getShip(0), s1);
+    a.checkEqual("13. getId", s1->getId(), 40);
+    a.check("14. hasPlanet", !testee.hasPlanet());
+
+    // More ships, planet
+    testee = orig;
+    a.checkEqual("21. getNumShips", testee.getNumShips(), 2U);
+    a.checkEqual("22. getShip", testee.getShip(0), s1);
+    a.checkEqual("23. getId", testee.getShip(1)->getId(), 20);
+    a.check("24. hasPlanet", testee.hasPlanet());
+    a.checkEqual("25. getId", testee.getPlanet()->getId(), 30);
+}
+
 /** Test ship operations. */
 AFL_TEST("game.sim.Setup:ship-operations", a)
 {
@@ -21,6 +21,8 @@ AFL_TEST("game.Turn:basics", a)
             { return 0; }
         virtual void save(afl::io::Stream& /*out*/, size_t /*first*/, size_t /*num*/, const game::config::HostConfiguration& /*config*/, afl::charset::Charset& /*cs*/)
             { }
+        virtual void prepareResults(const game::config::HostConfiguration& /*config*/, const game::spec::ShipList& /*shipList*/, int /*resultLevel*/, size_t /*numThreads*/)
+            { }
     };
 
     // Test initial values
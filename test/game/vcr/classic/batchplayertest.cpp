@@ -0,0 +1,154 @@
+/**
+  *  \file test/game/vcr/classic/batchplayertest.cpp
+  *  \brief Test for game::vcr::classic::BatchPlayer
+  */
+
+#include "game/vcr/classic/batchplayer.hpp"
+
+#include "afl/container/ptrvector.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/test/shiplist.hpp"
+#include "game/vcr/classic/battle.hpp"
+#include "game/vcr/classic/database.hpp"
+
+using afl::base::Ref;
+using game::config::HostConfiguration;
+using game::vcr::classic::Battle;
+using game::vcr::classic::BatchPlayer;
+
+namespace {
+    game::vcr::Object makeLeftShip()
+    {
+        game::vcr::Object left;
+        left.setMass(150);
+        left.setCrew(2);
+        left.setId(14);
+        left.setOwner(2);
+        left.setBeamType(0);
+        left.setNumBeams(0);
+        left.setNumBays(0);
+        left.setTorpedoType(0);
+        left.setNumLaunchers(0);
+        left.setNumTorpedoes(0);
+        left.setNumFighters(0);
+        left.setShield(100);
+        return left;
+    }
+
+    game::vcr::Object makeRightShip()
+    {
+        game::vcr::Object right;
+        right.setMass(233);
+        right.setCrew(240);
+        right.setId(434);
+        right.setOwner(3);
+        right.setBeamType(5);
+        right.setNumBeams(6);
+        right.setNumBays(0);
+        right.setTorpedoType(7);
+        right.setNumLaunchers(4);
+        right.setNumTorpedoes(20);
+        right.setNumFighters(0);
+        right.setShield(100);
+        return right;
+    }
+
+    struct Environment {
+        game::spec::ShipList shipList;
+        Ref<HostConfiguration> config;
+
+        Environment()
+            : shipList(), config(HostConfiguration::create())
+            {
+                game::test::initStandardBeams(shipList);
+                game::test::initStandardTorpedoes(shipList);
+            }
+    };
+
+    /* Make a battle. Every 7th battle has unknown type and cannot be played. */
+    Battle* makeBattle(int i)
+    {
+        Battle* b = new Battle(makeLeftShip(), makeRightShip(), uint16_t(1 + i), 0);
+        if (i % 7 == 6) {
+            b->setType(game::vcr::classic::Unknown, 0);
+        } else if (i % 2 == 0) {
+            b->setType(game::vcr::classic::Host, 0);
+        } else {
+            b->setType(game::vcr::classic::PHost4, 0);
+        }
+        return b;
+    }
+
+    /* Play battles using BatchPlayer and compare to regular playback */
+    void testPlay(afl::test::Assert a, size_t numThreads)
+    {
+        const int NUM = 30;
+        Environment env;
+
+        afl::container::PtrVector<Battle> testBattles;
+        afl::container::PtrVector<Battle> refBattles;
+        std::vector<Battle*> battles;
+        for (int i = 0; i < NUM; ++i) {
+            battles.push_back(testBattles.pushBackNew(makeBattle(i)));
+            refBattles.pushBackNew(makeBattle(i))->prepareResult(*env.config, env.shipList, game::vcr::Battle::NeedCompleteResult);
+        }
+
+        std::vector<BatchPlayer::Result> results;
+        BatchPlayer(*env.config, env.shipList, numThreads).play(battles, results);
+
+        a.checkEqual("01. size", results.size(), size_t(NUM));
+        for (int i = 0; i < NUM; ++i) {
+            afl::test::Assert aa(a(afl::string::Format("battle %d", i)));
+            aa.check("11. result", results[i].result == refBattles[i]->getResult());
+            aa.check("12. battle result", testBattles[i]->getResult() == refBattles[i]->getResult());
+            aa.checkEqual("13. Invalid", results[i].result.contains(game::vcr::classic::Invalid), (i % 7 == 6));
+            aa.checkEqual("14. left crew", testBattles[i]->getObject(0, true)->getCrew(), refBattles[i]->getObject(0, true)->getCrew());
+            aa.checkEqual("15. right damage", testBattles[i]->getObject(1, true)->getDamage(), refBattles[i]->getObject(1, true)->getDamage());
+            aa.checkEqual("16. right torps", testBattles[i]->getObject(1, true)->getNumTorpedoes(), refBattles[i]->getObject(1, true)->getNumTorpedoes());
+            if (i % 7 != 6) {
+                aa.checkEqual("17. num fights", results[i].statistic[game::vcr::classic::LeftSide].getNumFights(), 1);
+            }
+        }
+    }
+}
+
+/** Play in calling thread. */
+AFL_TEST("game.vcr.classic.BatchPlayer:play:single", a)
+{
+    testPlay(a, 0);
+}
+
+/** Play with multiple threads. */
+AFL_TEST("game.vcr.classic.BatchPlayer:play:multi", a)
+{
+    testPlay(a, 4);
+}
+
+/** Play empty list. */
+AFL_TEST("game.vcr.classic.BatchPlayer:play:empty", a)
+{
+    Environment env;
+    std::vector<Battle*> battles;
+    std::vector<BatchPlayer::Result> results(3);
+    BatchPlayer(*env.config, env.shipList, 4).play(battles, results);
+    a.checkEqual("01. size", results.size(), 0U);
+}
+
+/** Test Database::prepareResults(). */
+AFL_TEST("game.vcr.classic.BatchPlayer:Database:prepareResults", a)
+{
+    Environment env;
+    game::vcr::classic::Database db;
+    for (int i = 0; i < 10; ++i) {
+        db.addNewBattle(makeBattle(i));
+    }
+    db.prepareResults(*env.config, env.shipList, game::vcr::Battle::NeedQuickOutcome, 3);
+
+    for (int i = 0; i < 10; ++i) {
+        std::auto_ptr<Battle> ref(makeBattle(i));
+        ref->prepareResult(*env.config, env.shipList, game::vcr::Battle::NeedQuickOutcome);
+        a.check("01. result", !db.getBattle(i)->getResult().empty());
+        a.check("02. result", db.getBattle(i)->getResult() == ref->getResult());
+    }
+}
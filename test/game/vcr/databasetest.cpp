@@ -17,6 +17,8 @@ AFL_TEST_NOARG("game.vcr.Database")
             { return 0; }
         virtual void save(afl::io::Stream& /*out*/, size_t /*first*/, size_t /*num*/, const game::config::HostConfiguration& /*config*/, afl::charset::Charset& /*cs*/)
             { }
+        virtual void prepareResults(const game::config::HostConfiguration& /*config*/, const game::spec::ShipList& /*shipList*/, int /*resultLevel*/, size_t /*numThreads*/)
+            { }
     };
     Tester t;
 }
@@ -0,0 +1,95 @@
+/**
+  *  \file test/game/vcr/flak/compiledenvironmenttest.cpp
+  *  \brief Test for game::vcr::flak::CompiledEnvironment
+  */
+
+#include "game/vcr/flak/compiledenvironment.hpp"
+
+#include "afl/base/countof.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/config/hostconfiguration.hpp"
+#include "game/spec/beam.hpp"
+#include "game/spec/torpedolauncher.hpp"
+#include "game/vcr/flak/gameenvironment.hpp"
+
+using afl::base::Ref;
+using game::config::HostConfiguration;
+using game::vcr::flak::Environment;
+
+/** Compare CompiledEnvironment against GameEnvironment, including out-of-range parameters. */
+AFL_TEST("game.vcr.flak.CompiledEnvironment:config", a)
+{
+    // Configuration
+    Ref<HostConfiguration> config = HostConfiguration::create();
+    static const char*const OPTIONS[][2] = {
+        { "AllowAlternativeCombat", "1" },
+        { "StandoffDistance", "32000" },
+        { "BayLaunchInterval", "40" },
+        { "FighterKillOdds", "80,90,70" },
+        { "BayRechargeBonus", "3" },
+        { "EModBayRechargeBonus", "1,2,3,4" },
+        { "BeamHitFighterCharge", "900,800" },
+        { "EModBeamHitFighterCharge", "-30,-70,-90,-150" },
+        { "PlayerRace", "1,1,1,4,5,5,5,5,5" },
+    };
+    for (size_t i = 0; i < countof(OPTIONS); ++i) {
+        config->setOption(OPTIONS[i][0], OPTIONS[i][1], game::config::ConfigurationOption::Game);
+    }
+
+    game::spec::BeamVector_t beams;
+    game::spec::TorpedoVector_t torps;
+
+    game::vcr::flak::GameEnvironment ref(*config, beams, torps);
+    game::vcr::flak::CompiledEnvironment testee(*config, beams, torps);
+
+    // Scalars
+    a.checkEqual("01. AllowAlternativeCombat", testee.getConfiguration(Environment::AllowAlternativeCombat), 1);
+    a.checkEqual("02. StandoffDistance",       testee.getConfiguration(Environment::StandoffDistance), 32000);
+
+    // Arrays, experience, races: must match for all players, including out-of-range ones
+    for (int pl = -1; pl <= game::MAX_PLAYERS+2; ++pl) {
+        a.checkEqual("11. BayLaunchInterval", testee.getConfiguration(Environment::BayLaunchInterval, pl), ref.getConfiguration(Environment::BayLaunchInterval, pl));
+        a.checkEqual("12. FighterKillOdds",   testee.getConfiguration(Environment::FighterKillOdds, pl),   ref.getConfiguration(Environment::FighterKillOdds, pl));
+        a.checkEqual("13. getPlayerRaceNumber", testee.getPlayerRaceNumber(pl), ref.getPlayerRaceNumber(pl));
+        for (int lv = -1; lv <= game::MAX_EXPERIENCE_LEVELS+1; ++lv) {
+            a.checkEqual("14. BayRechargeBonus",     testee.getExperienceConfiguration(Environment::BayRechargeBonus, lv, pl),     ref.getExperienceConfiguration(Environment::BayRechargeBonus, lv, pl));
+            a.checkEqual("15. BeamHitFighterCharge", testee.getExperienceConfiguration(Environment::BeamHitFighterCharge, lv, pl), ref.getExperienceConfiguration(Environment::BeamHitFighterCharge, lv, pl));
+        }
+    }
+
+    // Spot checks
+    a.checkEqual("21. FighterKillOdds",      testee.getConfiguration(Environment::FighterKillOdds, 2), 90);
+    a.checkEqual("22. BeamHitFighterCharge", testee.getExperienceConfiguration(Environment::BeamHitFighterCharge, 4, 2), 650);
+    a.checkEqual("23. getPlayerRaceNumber",  testee.getPlayerRaceNumber(game::MAX_PLAYERS), 5);
+}
+
+/** Test weapon lookups. */
+AFL_TEST("game.vcr.flak.CompiledEnvironment:spec", a)
+{
+    Ref<HostConfiguration> config = HostConfiguration::create();
+
+    game::spec::BeamVector_t beams;
+    game::spec::Beam* b3 = beams.create(3);
+    b3->setKillPower(333);
+    b3->setDamagePower(777);
+
+    game::spec::TorpedoVector_t torps;
+    game::spec::TorpedoLauncher* tl2 = torps.create(2);
+    tl2->setKillPower(22);
+    tl2->setDamagePower(123);
+
+    game::vcr::flak::CompiledEnvironment testee(*config, beams, torps);
+
+    // Valid indexes
+    a.checkEqual("01. getBeamKillPower",      testee.getBeamKillPower(3), 333);
+    a.checkEqual("02. getBeamDamagePower",    testee.getBeamDamagePower(3), 777);
+    a.checkEqual("03. getTorpedoKillPower",   testee.getTorpedoKillPower(2), 22);
+    a.checkEqual("04. getTorpedoDamagePower", testee.getTorpedoDamagePower(2), 123);
+
+    // Gaps and out-of-range
+    a.checkEqual("11. getBeamKillPower",      testee.getBeamKillPower(1), 0);
+    a.checkEqual("12. getBeamKillPower",      testee.getBeamKillPower(0), 0);
+    a.checkEqual("13. getBeamDamagePower",    testee.getBeamDamagePower(4), 0);
+    a.checkEqual("14. getTorpedoKillPower",   testee.getTorpedoKillPower(-1), 0);
+    a.checkEqual("15. getTorpedoDamagePower", testee.getTorpedoDamagePower(3), 0);
+}
@@ -33,3 +33,29 @@ AFL_TEST("gfx.gen.PerlinNoise", a)
     a.checkEqual("13", testee.noise(1.5, 0, 0), 0.375);
     a.checkEqual("14", testee.noise(1.5, 0),    0.375);
 }
+
+/** Test multi-point functions: must produce same values as single-point functions. */
+AFL_TEST("gfx.gen.PerlinNoise:multi", a)
+{
+    util::RandomNumberGenerator rng(0);
+    gfx::gen::PerlinNoise testee(rng);
+
+    // More points than one internal block, and not a multiple of it
+    const size_t N = 37;
+    double x[N], y[N], z[N], out[N];
+    for (size_t i = 0; i < N; ++i) {
+        x[i] = 10 + 0.37*double(i);
+        y[i] = 20 + 0.11*double(i);
+        z[i] = 30 - 0.23*double(i);
+    }
+
+    testee.noise(x, y, z, out, N);
+    for (size_t i = 0; i < N; ++i) {
+        a.checkEqual("01. noise3", out[i], testee.noise(x[i], y[i], z[i]));
+    }
+
+    testee.noise(x, y, out, N);
+    for (size_t i = 0; i < N; ++i) {
+        a.checkEqual("11. noise2", out[i], testee.noise(x[i], y[i]));
+    }
+}
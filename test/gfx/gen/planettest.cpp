@@ -67,3 +67,20 @@ AFL_TEST("gfx.gen.Planet:large", a)
     };
     a.checkEqualContent<gfx::ColorQuad_t>("", pix->pixels(), EXPECTED);
 }
+
+/** Test rendering with multiple threads: result must be identical. */
+AFL_TEST("gfx.gen.Planet:threads", a)
+{
+    afl::base::Ref<gfx::RGBAPixmap> ref = gfx::RGBAPixmap::create(60, 45);
+    util::RandomNumberGenerator refRNG(3);
+    Planet(*ref).renderPlanet(Planet::ValueVector_t(30, 20, 0), 25, COLORS, 2, Planet::ValueVector_t(-10, -10, 0), refRNG);
+
+    afl::base::Ref<gfx::RGBAPixmap> pix = gfx::RGBAPixmap::create(60, 45);
+    util::RandomNumberGenerator rng(3);
+    Planet testee(*pix);
+    testee.setNumThreads(3);
+    testee.renderPlanet(Planet::ValueVector_t(30, 20, 0), 25, COLORS, 2, Planet::ValueVector_t(-10, -10, 0), rng);
+
+    a.checkEqualContent<gfx::ColorQuad_t>("content", pix->pixels(), ref->pixels());
+    a.checkEqual("rng", rng.getSeed(), refRNG.getSeed());
+}
@@ -252,3 +252,20 @@ AFL_TEST("gfx.gen.SpaceView:renderSun", a)
     };
     verify(a, *pix, EXPECT);
 }
+
+/** Test renderNebula() with multiple threads: result must be identical. */
+AFL_TEST("gfx.gen.SpaceView:renderNebula:threads", a)
+{
+    afl::base::Ref<gfx::RGBAPixmap> ref = gfx::RGBAPixmap::create(50, 37);
+    util::RandomNumberGenerator refRNG(7);
+    gfx::gen::SpaceView(*ref).renderNebula(refRNG, COLORQUAD_FROM_RGBA(90, 60, 90, 0), 8, 1.1, 4);
+
+    afl::base::Ref<gfx::RGBAPixmap> pix = gfx::RGBAPixmap::create(50, 37);
+    util::RandomNumberGenerator rng(7);
+    gfx::gen::SpaceView sv(*pix);
+    sv.setNumThreads(4);
+    sv.renderNebula(rng, COLORQUAD_FROM_RGBA(90, 60, 90, 0), 8, 1.1, 4);
+
+    a.checkEqualContent<uint32_t>("content", pix->pixels(), ref->pixels());
+    a.checkEqual("rng", rng.getSeed(), refRNG.getSeed());
+}
@@ -0,0 +1,63 @@
+/**
+  *  \file test/gfx/gen/tilerenderertest.cpp
+  *  \brief Test for gfx::gen::TileRenderer
+  */
+
+#include "gfx/gen/tilerenderer.hpp"
+
+#include <vector>
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+
+namespace {
+    /* Handler that counts how often each row has been rendered.
+       Tiles do not overlap, so no locking is needed. */
+    class CountingHandler : public gfx::gen::TileRenderer::Handler {
+     public:
+        CountingHandler(int size)
+            : m_counts(size)
+            { }
+        virtual void renderTile(int minY, int maxY)
+            {
+                for (int y = minY; y < maxY; ++y) {
+                    ++m_counts.at(y);
+                }
+            }
+        int get(int y) const
+            { return m_counts[y]; }
+     private:
+        std::vector<int> m_counts;
+    };
+
+    void testRender(afl::test::Assert a, size_t numThreads)
+    {
+        CountingHandler h(100);
+        gfx::gen::TileRenderer(numThreads).render(h, 3, 97);
+        for (int y = 0; y < 100; ++y) {
+            a(afl::string::Format("row %d", y)).checkEqual("count", h.get(y), (y >= 3 && y < 97) ? 1 : 0);
+        }
+    }
+}
+
+/** Render in calling thread. */
+AFL_TEST("gfx.gen.TileRenderer:single", a)
+{
+    testRender(a, 0);
+}
+
+/** Render with multiple threads. */
+AFL_TEST("gfx.gen.TileRenderer:multi", a)
+{
+    testRender(a, 5);
+}
+
+/** Render empty range. */
+AFL_TEST("gfx.gen.TileRenderer:empty", a)
+{
+    CountingHandler h(10);
+    gfx::gen::TileRenderer(4).render(h, 5, 5);
+    gfx::gen::TileRenderer(4).render(h, 7, 2);
+    for (int y = 0; y < 10; ++y) {
+        a.checkEqual("count", h.get(y), 0);
+    }
+}
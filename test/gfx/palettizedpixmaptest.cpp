@@ -4,7 +4,10 @@
   */
 
 #include "gfx/palettizedpixmap.hpp"
+
+#include <vector>
 #include "afl/test/testrunner.hpp"
+#include "gfx/fillpattern.hpp"
 
 /** Simple test. */
 AFL_TEST("gfx.PalettizedPixmap", a)
@@ -148,3 +151,49 @@ AFL_TEST("gfx.PalettizedPixmap:copyPalette", a)
     a.checkEqual("02. getPalette", resultColors[1], COLORS[1]);
     a.checkEqual("03. getPalette", resultColors[2], COLORS[2]);
 }
+
+/** Alpha operations.
+    Compare drawBar() and blitPattern() with alpha to a pixel-by-pixel computation. */
+AFL_TEST("gfx.PalettizedPixmap:alpha", a)
+{
+    const int W = 29, H = 9;
+    afl::base::Ref<gfx::PalettizedPixmap> testee = gfx::PalettizedPixmap::create(W, H);
+
+    // Pseudo-random palette and content; content uses only a few colors, like real images
+    uint32_t seed = 1;
+    for (int i = 0; i < 256; ++i) {
+        seed = seed * 1103515245 + 12345;
+        testee->setPalette(uint8_t(i), seed >> 8);
+    }
+    afl::base::Memory<uint8_t> pixels = testee->pixels();
+    while (uint8_t* p = pixels.eat()) {
+        seed = seed * 1103515245 + 12345;
+        *p = uint8_t((seed >> 16) % 7);
+    }
+    std::vector<uint8_t> expect(testee->pixels().at(0), testee->pixels().at(0) + W*H);
+    gfx::ColorQuad_t palette[256];
+    testee->getPalette(0, palette);
+
+    const gfx::Color_t FG = 17, BG = 200;
+    static const uint8_t DATA[] = { 0x0F, 0xF0, 0x3C, 0xAA, 0x81, 0x7E };
+    afl::base::Ref<gfx::Canvas> can(testee->makeCanvas());
+
+    // Solid bar
+    can->drawBar(gfx::Rectangle(1, 1, 27, 6), FG, gfx::TRANSPARENT_COLOR, gfx::FillPattern::SOLID, 100);
+    for (int y = 1; y < 7; ++y) {
+        for (int x = 1; x < 28; ++x) {
+            expect[y*W + x] = testee->findNearestColor(gfx::mixColor(palette[expect[y*W + x]], palette[FG], 100));
+        }
+    }
+
+    // Pattern blit with background
+    can->blitPattern(gfx::Rectangle(2, 4, 22, 2), gfx::Point(0, 4), 3, DATA, FG, BG, 180);
+    for (int y = 4; y < 6; ++y) {
+        for (int x = 2; x < 24; ++x) {
+            bool set = (DATA[(y-4)*3 + x/8] & (0x80 >> (x & 7))) != 0;
+            expect[y*W + x] = testee->findNearestColor(gfx::mixColor(palette[expect[y*W + x]], palette[set ? FG : BG], 180));
+        }
+    }
+
+    a.checkEqualContent<uint8_t>("01. content", testee->pixels(), expect);
+}
@@ -48,6 +48,10 @@ namespace {
             { *ptr = val; }
         Pixel_t mix(Pixel_t a, Pixel_t b, gfx::Alpha_t balpha) const
             { return gfx::mixColorComponent(a, b, balpha); }
+        void fill(Data_t* ptr, int n, Pixel_t val) const
+            { while (n-- > 0) { *ptr++ = val; } }
+        void mixFill(Data_t* ptr, int n, Pixel_t val, gfx::Alpha_t balpha) const
+            { while (n-- > 0) { *ptr = mix(*ptr, val, balpha); ++ptr; } }
         inline Data_t* add(Data_t* ptr, int dx, int dy) const
             { return ptr + m_pix.getWidth()*dy + dx; }
 
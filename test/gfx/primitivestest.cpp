@@ -27,6 +27,10 @@ namespace {
             { *ptr = val; }
         Pixel_t mix(Pixel_t a, Pixel_t b, gfx::Alpha_t balpha) const
             { return gfx::mixColorComponent(a, b, balpha); }
+        void fill(Data_t* ptr, int n, Pixel_t val) const
+            { while (n-- > 0) { *ptr++ = val; } }
+        void mixFill(Data_t* ptr, int n, Pixel_t val, gfx::Alpha_t balpha) const
+            { while (n-- > 0) { *ptr = mix(*ptr, val, balpha); ++ptr; } }
         inline Data_t* add(Data_t* ptr, int dx, int dy) const
             { return ptr + m_width*dy + dx; }
 
@@ -377,6 +381,17 @@ AFL_TEST("gfx.Primitives:doBar:color-alpha", a)
     a.checkEqualContent<uint8_t>("", impl.data(), EXPECTED);
 }
 
+// Horizontal, pattern, alpha; runs crossing the pattern boundary
+AFL_TEST("gfx.Primitives:doHLine:pattern-alpha", a)
+{
+    TraitsImpl impl(20, 1);
+    Primitives_t(impl).doHLine(1, 0, 19, 30, 0xC3, 85);
+    static const uint8_t EXPECTED[] = {
+        0,10,0,0,0, 0,10,10,10,10, 0,0,0,0,10, 10,10,10,0,0,
+    };
+    a.checkEqualContent<uint8_t>("", impl.data(), EXPECTED);
+}
+
 /*
  *  doBlitPattern
  */
@@ -460,6 +475,18 @@ AFL_TEST("gfx.Primitives:doBlitPattern:pattern-color-alpha-background", a)
     a.checkEqualContent<uint8_t>("", impl.data(), EXPECTED);
 }
 
+// Pattern + color + background + alpha, runs crossing bytes
+AFL_TEST("gfx.Primitives:doBlitPattern:pattern-color-alpha-background:wide", a)
+{
+    static const uint8_t WIDE_PATTERN[] = { 0x0F, 0xF0, 0x3C };
+    TraitsImpl impl(20, 1);
+    Primitives_t(impl).doBlitPattern(gfx::Rectangle(1, 0, 18, 1), gfx::Point(-1, 0), 3, WIDE_PATTERN, 12, 6, 85);
+    static const uint8_t EXPECTED[] = {
+        0,2,2,4,4, 4,4,4,4,4, 4,2,2,2,2, 2,2,4,4,0,
+    };
+    a.checkEqualContent<uint8_t>("", impl.data(), EXPECTED);
+}
+
 // Pattern + color + background + alpha
 AFL_TEST("gfx.Primitives:doBlitPattern:pattern-color-alpha-background:offset", a)
 {
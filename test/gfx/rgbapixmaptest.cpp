@@ -4,7 +4,12 @@
   */
 
 #include "gfx/rgbapixmap.hpp"
+
+#include <vector>
+#include "afl/bits/rotate.hpp"
 #include "afl/test/testrunner.hpp"
+#include "gfx/fillpattern.hpp"
+#include "gfx/palettizedpixmap.hpp"
 
 /** Simple tests. */
 AFL_TEST("gfx.RGBAPixmap", a)
@@ -105,3 +110,64 @@ AFL_TEST("gfx.RGBAPixmap", a)
     a.checkEqual("73. getPixels", quads[2], COLORQUAD_FROM_RGBA(0,0,0,0));
     a.checkEqual("74. getPixels", quads[3], COLORQUAD_FROM_RGBA(0,0,0,0));
 }
+
+/** Alpha operations.
+    Compare drawBar() and blitPattern() with alpha to a pixel-by-pixel computation using mixColor(). */
+AFL_TEST("gfx.RGBAPixmap:alpha", a)
+{
+    const int W = 37, H = 11;
+    afl::base::Ref<gfx::RGBAPixmap> testee = gfx::RGBAPixmap::create(W, H);
+
+    // Pseudo-random content
+    uint32_t seed = 1;
+    afl::base::Memory<gfx::ColorQuad_t> pixels = testee->pixels();
+    while (gfx::ColorQuad_t* p = pixels.eat()) {
+        seed = seed * 1103515245 + 12345;
+        *p = seed;
+    }
+    std::vector<gfx::ColorQuad_t> expect(testee->pixels().at(0), testee->pixels().at(0) + W*H);
+
+    const gfx::ColorQuad_t FG = COLORQUAD_FROM_RGBA(200, 30, 90, 255);
+    const gfx::ColorQuad_t BG = COLORQUAD_FROM_RGBA(10, 240, 128, 40);
+    static const uint8_t DATA[] = { 0x0F, 0xF0, 0x3C, 0xAA, 0x81, 0x7E, 0x00, 0xFF, 0xFF, 0x00, 0xC3, 0x18 };
+    afl::base::Ref<gfx::Canvas> can(testee->makeCanvas());
+
+    // Solid bar
+    can->drawBar(gfx::Rectangle(5, 3, 29, 5), FG, gfx::TRANSPARENT_COLOR, gfx::FillPattern::SOLID, 200);
+    for (int y = 3; y < 8; ++y) {
+        for (int x = 5; x < 34; ++x) {
+            expect[y*W + x] = gfx::mixColor(expect[y*W + x], FG, 200);
+        }
+    }
+
+    // Pattern bar with background
+    can->drawBar(gfx::Rectangle(2, 1, 30, 8), FG, BG, gfx::FillPattern::LTSLASH, 77);
+    for (int y = 1; y < 9; ++y) {
+        for (int x = 2; x < 32; ++x) {
+            bool set = (gfx::FillPattern::LTSLASH[y] & afl::bits::rotateRight8(0x80, x)) != 0;
+            expect[y*W + x] = gfx::mixColor(expect[y*W + x], set ? FG : BG, 77);
+        }
+    }
+
+    // Pattern blit with background
+    can->blitPattern(gfx::Rectangle(3, 7, 29, 3), gfx::Point(1, 7), 4, DATA, BG, FG, 150);
+    for (int y = 7; y < 10; ++y) {
+        for (int x = 3; x < 32; ++x) {
+            int col = x - 1;
+            bool set = (DATA[(y-7)*4 + col/8] & (0x80 >> (col & 7))) != 0;
+            expect[y*W + x] = gfx::mixColor(expect[y*W + x], set ? BG : FG, 150);
+        }
+    }
+
+    a.checkEqualContent<gfx::ColorQuad_t>("01. content", testee->pixels(), expect);
+}
+
+/** Test isPixmapCanvas(). */
+AFL_TEST("gfx.RGBAPixmap:isPixmapCanvas", a)
+{
+    afl::base::Ref<gfx::Canvas> rgba = gfx::RGBAPixmap::create(3, 5)->makeCanvas();
+    a.check("01. rgba", gfx::RGBAPixmap::isPixmapCanvas(*rgba));
+
+    afl::base::Ref<gfx::Canvas> pal = gfx::PalettizedPixmap::create(3, 5)->makeCanvas();
+    a.check("11. palettized", !gfx::RGBAPixmap::isPixmapCanvas(*pal));
+}
@@ -0,0 +1,137 @@
+/**
+  *  \file test/gfx/threed/softwarecontexttest.cpp
+  *  \brief Test for gfx::threed::SoftwareContext
+  */
+
+#include "gfx/threed/softwarecontext.hpp"
+
+#include "afl/test/testrunner.hpp"
+#include "gfx/rgbapixmap.hpp"
+#include "gfx/threed/linerenderer.hpp"
+#include "gfx/threed/particlerenderer.hpp"
+#include "gfx/threed/trianglerenderer.hpp"
+
+using afl::base::Ref;
+using gfx::ColorQuad_t;
+using gfx::RGBAPixmap;
+using gfx::Rectangle;
+using gfx::threed::Mat4f;
+using gfx::threed::SoftwareContext;
+using gfx::threed::Vec3f;
+
+namespace {
+    /* Simple pseudo-random generator, to get a reproducible scene */
+    class Random {
+     public:
+        Random()
+            : m_state(12345)
+            { }
+        float get()
+            {
+                m_state = m_state * 1103515245 + 12345;
+                return float((m_state >> 8) & 0xFFFF) / 32768.0f - 1.0f;
+            }
+        ColorQuad_t getColor()
+            {
+                m_state = m_state * 1103515245 + 12345;
+                return COLORQUAD_FROM_RGB((m_state >> 24) & 255, (m_state >> 16) & 255, (m_state >> 8) & 255);
+            }
+     private:
+        uint32_t m_state;
+    };
+
+    /* Create background with a gradient, so we can see which pixels are modified */
+    Ref<RGBAPixmap> createBackground()
+    {
+        const int W = 300, H = 200;
+        Ref<RGBAPixmap> pix = RGBAPixmap::create(W, H);
+        afl::base::Memory<ColorQuad_t> pixels = pix->pixels();
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < W; ++x) {
+                *pixels.at(y*W + x) = COLORQUAD_FROM_RGB(x & 255, y & 255, (x+y) & 255);
+            }
+        }
+        return pix;
+    }
+
+    /* Render a scene consisting of triangles, lines and particles, and return the pixmap. */
+    Ref<RGBAPixmap> renderScene(size_t numThreads, const Rectangle& viewport)
+    {
+        Ref<RGBAPixmap> pix = createBackground();
+        Ref<gfx::Canvas> can = pix->makeCanvas();
+
+        // Scene
+        Ref<SoftwareContext> ctx = SoftwareContext::create();
+        ctx->setNumThreads(numThreads);
+        Ref<gfx::threed::TriangleRenderer> tr = ctx->createTriangleRenderer();
+        Ref<gfx::threed::LineRenderer> lr = ctx->createLineRenderer();
+        Ref<gfx::threed::ParticleRenderer> pr = ctx->createParticleRenderer();
+
+        Random rng;
+        for (int i = 0; i < 200; ++i) {
+            Vec3f a(rng.get(), rng.get(), rng.get());
+            Vec3f b = a + Vec3f(rng.get(), rng.get(), rng.get()) * 0.5f;
+            Vec3f c = a + Vec3f(rng.get(), rng.get(), rng.get()) * 0.5f;
+            tr->addTriangle(a, b, c, rng.getColor());
+        }
+        for (int i = 0; i < 100; ++i) {
+            Vec3f a(rng.get(), rng.get(), rng.get());
+            Vec3f b(rng.get(), rng.get(), rng.get());
+            lr->add(a, b, rng.getColor());
+        }
+        static const ColorQuad_t COLORS[] = {
+            COLORQUAD_FROM_RGBA(255, 255, 255, 255),
+            COLORQUAD_FROM_RGBA(255, 255, 0, 200),
+            COLORQUAD_FROM_RGBA(255, 128, 0, 150),
+            COLORQUAD_FROM_RGBA(255, 0, 0, 100),
+            COLORQUAD_FROM_RGBA(128, 0, 0, 50),
+        };
+        pr->setColors(COLORS);
+        pr->setAxes(Vec3f(0.2f, 0, 0), Vec3f(0, 0.2f, 0));
+        for (int i = 0; i < 100; ++i) {
+            pr->add(Vec3f(rng.get(), rng.get(), rng.get()), float(rng.get() * 0.5 + 0.5));
+        }
+
+        // Render
+        const Mat4f proj = Mat4f::perspective(1.0, double(viewport.getWidth()) / viewport.getHeight(), 0.1);
+        const Mat4f modelView = Mat4f::identity().translate(Vec3f(0, 0, -3));
+        ctx->start(viewport, *can);
+        tr->render(proj, modelView);
+        lr->render(proj, modelView);
+        pr->render(proj, modelView);
+        ctx->finish();
+
+        return pix;
+    }
+
+    /* Render a scene serially and in parallel, and compare */
+    void testRender(afl::test::Assert a, const Rectangle& viewport)
+    {
+        Ref<RGBAPixmap> serial = renderScene(1, viewport);
+        Ref<RGBAPixmap> parallel = renderScene(4, viewport);
+        a.checkEqualContent<ColorQuad_t>("01. pixels", parallel->pixels(), serial->pixels());
+
+        // Verify that something was actually drawn
+        a.check("11. modified", !serial->pixels().equalContent(createBackground()->pixels()));
+    }
+}
+
+/** Parallel rendering of a scene in the middle of the canvas.
+    Result must be identical to serial rendering. */
+AFL_TEST("gfx.threed.SoftwareContext:render:center", a)
+{
+    testRender(a, Rectangle(20, 10, 250, 170));
+}
+
+/** Parallel rendering of a scene that exceeds the canvas on all sides,
+    so that only part of the scene is visible. */
+AFL_TEST("gfx.threed.SoftwareContext:render:large", a)
+{
+    testRender(a, Rectangle(-250, -170, 800, 540));
+}
+
+/** Parallel rendering with an unaligned viewport. */
+AFL_TEST("gfx.threed.SoftwareContext:render:unaligned", a)
+{
+    testRender(a, Rectangle(-33, 17, 301, 177));
+}
@@ -47,6 +47,32 @@ AFL_TEST("gfx.Types:mixColor", a)
     a.checkEqual("32", gfx::mixColor(COLORQUAD_FROM_RGBA(100, 100, 100, 255), COLORQUAD_FROM_RGBA( 50, 150,   0, 255),  64), COLORQUAD_FROM_RGBA( 88, 112,  75, 255));
 }
 
+/** Test mixColors.
+    Result must be identical to mixColor() for each pixel.
+    Test all combinations of background and color component values, and run lengths that are not multiples of a vector size. */
+AFL_TEST("gfx.Types:mixColors", a)
+{
+    static const gfx::Alpha_t ALPHAS[] = { 0, 1, 2, 64, 127, 128, 129, 200, 254, 255 };
+    gfx::ColorQuad_t pixels[256];
+    for (size_t ai = 0; ai < sizeof(ALPHAS)/sizeof(ALPHAS[0]); ++ai) {
+        for (uint32_t b = 0; b < 256; ++b) {
+            const gfx::ColorQuad_t color = COLORQUAD_FROM_RGBA(b, 255 - b, (b * 7) & 255, b ^ 0x55);
+            for (uint32_t i = 0; i < 256; ++i) {
+                pixels[i] = COLORQUAD_FROM_RGBA(i, i, 255 - i, (i * 13) & 255);
+            }
+            const size_t n = 256 - (b % 4);
+            gfx::mixColors(pixels, n, color, ALPHAS[ai]);
+            for (uint32_t i = 0; i < 256; ++i) {
+                const gfx::ColorQuad_t orig = COLORQUAD_FROM_RGBA(i, i, 255 - i, (i * 13) & 255);
+                const gfx::ColorQuad_t expect = (i < n ? gfx::mixColor(orig, color, ALPHAS[ai]) : orig);
+                if (pixels[i] != expect) {
+                    a.checkEqual("01. mixColors", pixels[i], expect);
+                }
+            }
+        }
+    }
+}
+
 /** Test addColor. */
 AFL_TEST("gfx.Types:addColor", a)
 {
@@ -189,6 +189,47 @@ namespace {
         int32_t  m_value;
     };
 
+    /* Alternating context.
+       Exposes a single variable only on every other iteration step, like a context iterating objects of different types. */
+    class AlternatingContext : public interpreter::SimpleContext, public interpreter::Context::PropertyAccessor {
+     public:
+        AlternatingContext(afl::test::Assert a, String_t name)
+            : m_assert(a), m_name(name), m_step(0)
+            { }
+        virtual interpreter::Context::PropertyAccessor* lookup(const afl::data::NameQuery& name, PropertyIndex_t& result)
+            {
+                if (m_step % 2 != 0 && name.match(m_name)) {
+                    result = 55;
+                    return this;
+                } else {
+                    return 0;
+                }
+            }
+        virtual void set(PropertyIndex_t /*index*/, const afl::data::Value* /*value*/)
+            { m_assert.fail("AlternatingContext::set unexpected"); }
+        virtual afl::data::Value* get(PropertyIndex_t index)
+            {
+                m_assert.checkEqual("get() index", index, PropertyIndex_t(55));
+                return interpreter::makeIntegerValue(m_step);
+            }
+        virtual bool next()
+            { ++m_step; return true; }
+        virtual Context* clone() const
+            { return new AlternatingContext(*this); }
+        virtual afl::base::Deletable* getObject()
+            { m_assert.fail("AlternatingContext::getObject unexpected"); return 0; }
+        virtual void enumProperties(interpreter::PropertyAcceptor& /*acceptor*/) const
+            { m_assert.fail("AlternatingContext::enumProperties unexpected"); }
+        virtual String_t toString(bool /*readable*/) const
+            { m_assert.fail("AlternatingContext::toString unexpected"); return String_t(); }
+        virtual void store(interpreter::TagNode& /*out*/, afl::io::DataSink& /*aux*/, interpreter::SaveContext& /*ctx*/) const
+            { m_assert.fail("AlternatingContext::store unexpected"); }
+     private:
+        afl::test::Assert m_assert;
+        String_t m_name;
+        int32_t m_step;
+    };
+
     /* Null object.
        Just a dummy object, we do not look into it. */
     class NullObject : public afl::base::Deletable {
@@ -684,6 +725,75 @@ AFL_TEST("interpreter.Process:run:pushvar", a)
     a.checkEqual("02. result", toString(env), "theValue");
 }
 
+/** Test instruction: pushvar, name cache.
+    A 'dimloc' creating a variable that shadows an already-resolved name must be honored. */
+AFL_TEST("interpreter.Process:run:pushvar:cache:dim", a)
+{
+    Environment env;
+    String_t value("theValue");
+    env.proc.pushNewContext(new SingularVariableContext(a("value"), "VALUE", value));
+
+    BCORef_t bco = makeBCO();
+    uint16_t name = bco->addName("VALUE");
+    bco->addInstruction(Opcode::maPush, Opcode::sNamedVariable, name);
+    bco->addInstruction(Opcode::maPush, Opcode::sInteger, 5);
+    bco->addInstruction(Opcode::maDim,  Opcode::sLocal, name);
+    bco->addInstruction(Opcode::maPush, Opcode::sNamedVariable, name);
+    runBCO(env, bco);
+
+    a.checkEqual("01. getState", env.proc.getState(), Process::Ended);
+    a.checkEqual("02. getStackSize", env.proc.getStackSize(), 2U);
+    a.checkEqual("03. result", toInteger(env), 5);
+}
+
+/** Test instruction: pushvar, name cache.
+    Two processes executing the same BCO must each see their own contexts. */
+AFL_TEST("interpreter.Process:run:pushvar:cache:process", a)
+{
+    Environment env;
+    String_t value1("first");
+    String_t value2("second");
+    env.proc.pushNewContext(new SingularVariableContext(a("value1"), "VALUE", value1));
+    Process proc2(env.world, "other", 100);
+    proc2.pushNewContext(new SingularVariableContext(a("value2"), "VALUE", value2));
+
+    BCORef_t bco = makeBCO();
+    bco->addInstruction(Opcode::maPush, Opcode::sNamedVariable, bco->addName("VALUE"));
+
+    runBCO(env, bco);
+    proc2.pushFrame(bco, true);
+    proc2.run(0);
+
+    a.checkEqual("01. getState", env.proc.getState(), Process::Ended);
+    a.checkEqual("02. result", toString(env), "first");
+    a.checkEqual("03. getState", proc2.getState(), Process::Ended);
+    const StringValue* sv = dynamic_cast<const StringValue*>(proc2.getResult());
+    a.checkNonNull("04. result", sv);
+    a.checkEqual("05. result", sv->getValue(), "second");
+}
+
+/** Test instruction: pushvar, name cache.
+    A name resolved by a lower context must be looked up again after the iteration context advanced,
+    because the new object may provide that name. */
+AFL_TEST("interpreter.Process:run:pushvar:cache:next", a)
+{
+    Environment env;
+    String_t value("global");
+    env.proc.pushNewContext(new SingularVariableContext(a("value"), "VALUE", value));
+    env.proc.pushNewContext(new AlternatingContext(a("alt"), "VALUE"));
+
+    BCORef_t bco = makeBCO();
+    uint16_t name = bco->addName("VALUE");
+    bco->addInstruction(Opcode::maPush,    Opcode::sNamedVariable, name);
+    bco->addInstruction(Opcode::maSpecial, Opcode::miSpecialNextIndex, 0);
+    bco->addInstruction(Opcode::maPush,    Opcode::sNamedVariable, name);
+    runBCO(env, bco);
+
+    a.checkEqual("01. getState", env.proc.getState(), Process::Ended);
+    a.checkEqual("02. getStackSize", env.proc.getStackSize(), 3U);
+    a.checkEqual("03. result", toInteger(env), 1);
+}
+
 /** Test instruction: pushloc. */
 AFL_TEST("interpreter.Process:run:pushloc", a)
 {
@@ -11,6 +11,7 @@
 #include "server/file/internaldirectoryhandler.hpp"
 #include <memory>
 #include <stdexcept>
+#include <vector>
 #include "afl/io/internaldirectory.hpp"
 #include "afl/io/constmemorystream.hpp"
 
@@ -314,6 +315,41 @@ AFL_TEST("server.file.ca.ObjectStore:cache:size", a)
     a.check("12. count", count < 10);
 }
 
+/** Test addObject() for existing objects, and removeStaleCachedObjects().
+    Adding an existing object is answered from the cache, without reading files.
+    An object whose file vanished behind the cache's back is re-created after removeStaleCachedObjects(). */
+AFL_TEST("server.file.ca.ObjectStore:removeStaleCachedObjects", a)
+{
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    size_t count = 0;
+    CountingDirectoryHandler rootCounter(count, std::auto_ptr<DirectoryHandler>(new server::file::InternalDirectoryHandler("root", rootDir)));
+    ObjectStore testee(rootCounter);
+
+    ObjectId aa = testee.addObject(ObjectStore::DataObject, afl::string::toBytes("alpha"));
+    ObjectId bb = testee.addObject(ObjectStore::DataObject, afl::string::toBytes("bravo"));
+
+    // Adding again does not read the file
+    count = 0;
+    a.checkEqual("01. addObject", testee.addObject(ObjectStore::DataObject, afl::string::toBytes("alpha")), aa);
+    a.checkEqual("02. count", count, 0U);
+
+    // Remove file behind the store's back
+    DirectoryHandler* dir = testee.getObjectDirectory(aa.m_bytes[0]);
+    a.checkNonNull("11. getObjectDirectory", dir);
+    dir->removeFile(aa.toHex().substr(2));
+
+    // Clean up cache
+    std::vector<ObjectId> ids;
+    ids.push_back(aa);
+    ids.push_back(bb);
+    a.checkEqual("21. removeStaleCachedObjects", testee.removeStaleCachedObjects(ids), 1U);
+
+    // Adding re-creates the object
+    a.checkEqual("31. addObject", testee.addObject(ObjectStore::DataObject, afl::string::toBytes("alpha")), aa);
+    AFL_CHECK_SUCCEEDS(a("32. getFileByName"), dir->getFileByName(aa.toHex().substr(2)));
+    AFL_CHECK_SUCCEEDS(a("33. getObject"), testee.getObject(bb, ObjectStore::DataObject));
+}
+
 /** Test packfile handling. */
 AFL_TEST("server.file.ca.ObjectStore:packfile", a)
 {
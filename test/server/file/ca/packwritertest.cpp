@@ -0,0 +1,170 @@
+/**
+  *  \file test/server/file/ca/packwritertest.cpp
+  *  \brief Test for server::file::ca::PackWriter
+  */
+
+#include "server/file/ca/packwriter.hpp"
+
+#include "afl/except/fileformatexception.hpp"
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/constmemorystream.hpp"
+#include "afl/io/internaldirectory.hpp"
+#include "afl/io/internalfilemapping.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/file/ca/packfile.hpp"
+
+using afl::base::GrowableBytes_t;
+using afl::base::Ptr;
+using afl::base::Ref;
+using afl::io::FileMapping;
+using afl::io::InternalDirectory;
+using server::file::ca::ObjectId;
+using server::file::ca::ObjectStore;
+using server::file::ca::PackFile;
+using server::file::ca::PackWriter;
+
+namespace {
+    Ref<FileMapping> makeMapping(const String_t& content)
+    {
+        GrowableBytes_t bytes;
+        bytes.append(afl::string::toBytes(content));
+        return *new afl::io::InternalFileMapping(bytes);
+    }
+
+    String_t makeText(int n)
+    {
+        String_t result;
+        for (int i = 0; i < n; ++i) {
+            result += afl::string::Format("line %d of a longer text\n", i);
+        }
+        return result;
+    }
+
+    /* Encode a delta, expand it, and return the result */
+    String_t roundtripDelta(afl::test::Assert a, const String_t& ref, const String_t& target)
+    {
+        GrowableBytes_t delta;
+        a.check("encodeDelta", PackWriter::encodeDelta(afl::string::toBytes(ref), afl::string::toBytes(target), delta, target.size() + 100));
+
+        GrowableBytes_t result;
+        PackFile::DeltaExpander exp("<test>", makeMapping(ref), result);
+        a.check("acceptBytes", exp.acceptBytes(delta));
+        return afl::string::fromBytes(result);
+    }
+
+    class NullRequester : public PackFile::ObjectRequester {
+     public:
+        Ref<FileMapping> getObject(const ObjectId& /*id*/, size_t /*level*/)
+            { throw afl::except::FileProblemException("<NullRequester>", "Bad reference"); }
+    };
+}
+
+/** Test encodeDelta(), similar objects. */
+AFL_TEST("server.file.ca.PackWriter:encodeDelta:similar", a)
+{
+    const String_t ref = makeText(100);
+    String_t target = ref;
+    target.insert(500, "inserted text");
+    target.erase(1200, 30);
+    target += "appended";
+
+    a.checkEqual("result", roundtripDelta(a, ref, target), target);
+
+    // Delta must be much smaller than target
+    GrowableBytes_t delta;
+    a.check("encodeDelta", PackWriter::encodeDelta(afl::string::toBytes(ref), afl::string::toBytes(target), delta, target.size()));
+    a.check("delta size", delta.size() < target.size() / 10);
+}
+
+/** Test encodeDelta(), corner cases. */
+AFL_TEST("server.file.ca.PackWriter:encodeDelta:corner-cases", a)
+{
+    // Empty
+    a.checkEqual("01", roundtripDelta(a("01"), "", ""), "");
+    a.checkEqual("02", roundtripDelta(a("02"), "abc", ""), "");
+    a.checkEqual("03", roundtripDelta(a("03"), "", "abc"), "abc");
+
+    // Long add
+    const String_t longText(1000, 'x');
+    a.checkEqual("11", roundtripDelta(a("11"), "", longText), longText);
+
+    // Long copy (exceeds a single copy instruction)
+    const String_t hugeText = makeText(5000);
+    a.checkEqual("21", roundtripDelta(a("21"), hugeText, hugeText), hugeText);
+    a.checkEqual("22", roundtripDelta(a("22"), hugeText, "x" + hugeText + "y"), "x" + hugeText + "y");
+}
+
+/** Test encodeDelta(), size limit. */
+AFL_TEST("server.file.ca.PackWriter:encodeDelta:limit", a)
+{
+    const String_t ref = makeText(100);
+    const String_t target(1000, 'x');
+    GrowableBytes_t delta;
+    a.check("encodeDelta", !PackWriter::encodeDelta(afl::string::toBytes(ref), afl::string::toBytes(target), delta, 500));
+}
+
+/** Test writing a pack file and reading it back. */
+AFL_TEST("server.file.ca.PackWriter:roundtrip", a)
+{
+    static const ObjectId ID1 = {{1}};
+    static const ObjectId ID2 = {{2}};
+    static const ObjectId ID3 = {{3}};
+    static const ObjectId ID4 = {{4}};
+
+    const String_t text1 = makeText(200);
+    const String_t text2 = text1 + "more";
+    const String_t text3 = "short";
+    const String_t text4 = "tree";
+
+    // Write
+    Ref<afl::io::InternalStream> packStream = *new afl::io::InternalStream();
+    afl::io::InternalSink indexSink;
+    {
+        PackWriter testee(*packStream, 4);
+        testee.addObject(ID1, ObjectStore::DataObject, makeMapping(text1));
+        testee.addObject(ID2, ObjectStore::DataObject, makeMapping(text2));
+        testee.addObject(ID3, ObjectStore::DataObject, makeMapping(text3));
+        testee.addObject(ID4, ObjectStore::TreeObject, makeMapping(text4));
+        testee.finish(indexSink);
+    }
+
+    // Pack must be smaller than a single uncompressed copy of the text
+    a.check("pack size", packStream->getSize() < text1.size());
+
+    // Read
+    Ref<InternalDirectory> dir = InternalDirectory::create("dir");
+    packStream->setPos(0);
+    dir->addStream("xy.pack", *packStream);
+    dir->addStream("xy.idx", *new afl::io::ConstMemoryStream(indexSink.getContent()));
+
+    PackFile pack(*dir, "xy");
+    NullRequester req;
+    Ptr<FileMapping> p1 = pack.getObject(ID1, req, 20);
+    Ptr<FileMapping> p2 = pack.getObject(ID2, req, 20);
+    Ptr<FileMapping> p3 = pack.getObject(ID3, req, 20);
+    Ptr<FileMapping> p4 = pack.getObject(ID4, req, 20);
+    a.checkNonNull("p1", p1.get());
+    a.checkNonNull("p2", p2.get());
+    a.checkNonNull("p3", p3.get());
+    a.checkNonNull("p4", p4.get());
+    a.checkEqual("content 1", afl::string::fromBytes(p1->get()), text1);
+    a.checkEqual("content 2", afl::string::fromBytes(p2->get()), text2);
+    a.checkEqual("content 3", afl::string::fromBytes(p3->get()), text3);
+    a.checkEqual("content 4", afl::string::fromBytes(p4->get()), text4);
+
+    a.check("hasObject 1", pack.hasObject(ID1));
+    a.check("hasObject nil", !pack.hasObject(ObjectId::nil));
+}
+
+/** Test object count mismatch. */
+AFL_TEST("server.file.ca.PackWriter:error:count", a)
+{
+    Ref<afl::io::InternalStream> packStream = *new afl::io::InternalStream();
+    afl::io::InternalSink indexSink;
+    PackWriter testee(*packStream, 2);
+    testee.addObject(ObjectId::nil, ObjectStore::DataObject, makeMapping("x"));
+    AFL_CHECK_THROWS(a, testee.finish(indexSink), afl::except::FileFormatException);
+}
@@ -0,0 +1,177 @@
+/**
+  *  \file test/server/file/ca/persistentobjectcachetest.cpp
+  *  \brief Test for server::file::ca::PersistentObjectCache
+  */
+
+#include "server/file/ca/persistentobjectcache.hpp"
+
+#include "afl/except/fileproblemexception.hpp"
+#include "afl/io/internalfilemapping.hpp"
+#include "afl/io/internalstream.hpp"
+#include "afl/test/testrunner.hpp"
+
+using afl::base::Ref;
+using afl::io::InternalStream;
+using server::file::ca::ObjectId;
+using server::file::ca::ObjectStore;
+using server::file::ca::PersistentObjectCache;
+
+namespace {
+    Ref<afl::io::FileMapping> makeMapping(const String_t& content)
+    {
+        afl::base::GrowableMemory<uint8_t> mem;
+        mem.append(afl::string::toBytes(content));
+        return *new afl::io::InternalFileMapping(mem);
+    }
+
+    ObjectId makeId(ObjectStore::Type type, const String_t& content)
+    {
+        return ObjectStore::computeObjectId(type, afl::string::toBytes(content));
+    }
+
+    ObjectId makeSizeId(int i)
+    {
+        ObjectId id = ObjectId::nil;
+        id.m_bytes[0] = static_cast<uint8_t>(i);
+        id.m_bytes[1] = static_cast<uint8_t>(i >> 8);
+        return id;
+    }
+}
+
+/** Simple test. This plays just a simple add/get/remove cycle. */
+AFL_TEST("server.file.ca.PersistentObjectCache:basics", a)
+{
+    const ObjectId treeId = makeId(ObjectStore::TreeObject, "abcde");
+    const ObjectId dataId = makeId(ObjectStore::DataObject, "xyz");
+    size_t tmp = 0;
+
+    Ref<InternalStream> file = *new InternalStream();
+    PersistentObjectCache testee(*file, 10000);
+
+    // Cache is empty and answers with negative response
+    a.checkNull("01. getObject",      testee.getObject(treeId, ObjectStore::TreeObject).get());
+    a.check    ("02. getObjectSize", !testee.getObjectSize(treeId, ObjectStore::TreeObject).isValid());
+    a.checkEqual("03. getNumObjects", testee.getNumObjects(), 0U);
+
+    // Add tree
+    testee.addObject(treeId, ObjectStore::TreeObject, makeMapping("abcde"));
+    a.checkNonNull("11. getObject",   testee.getObject(treeId, ObjectStore::TreeObject).get());
+    a.check       ("12. getObject",   testee.getObject(treeId, ObjectStore::TreeObject)->get().equalContent(afl::string::toBytes("abcde")));
+    a.check       ("13. getObjectSize", testee.getObjectSize(treeId, ObjectStore::TreeObject).get(tmp));
+    a.checkEqual  ("14. result", tmp, 5U);
+
+    // Add data (content cached in memory only)
+    testee.addObject(dataId, ObjectStore::DataObject, makeMapping("xyz"));
+    a.checkNonNull("21. getObject",   testee.getObject(dataId, ObjectStore::DataObject).get());
+    a.check       ("22. getObjectSize", testee.getObjectSize(dataId, ObjectStore::DataObject).get(tmp));
+    a.checkEqual  ("23. result", tmp, 3U);
+    a.checkEqual  ("24. getNumObjects", testee.getNumObjects(), 2U);
+
+    // Type mismatch
+    AFL_CHECK_THROWS(a("31. getObject"), testee.getObject(treeId, ObjectStore::DataObject), afl::except::FileProblemException);
+
+    // Remove
+    testee.removeObject(treeId);
+    testee.removeObject(dataId);
+    a.checkNull("41. getObject",      testee.getObject(treeId, ObjectStore::TreeObject).get());
+    a.check    ("42. getObjectSize", !testee.getObjectSize(treeId, ObjectStore::TreeObject).isValid());
+    a.checkNull("43. getObject",      testee.getObject(dataId, ObjectStore::DataObject).get());
+    a.check    ("44. getObjectSize", !testee.getObjectSize(dataId, ObjectStore::DataObject).isValid());
+}
+
+/** Test persistence. */
+AFL_TEST("server.file.ca.PersistentObjectCache:persist", a)
+{
+    const ObjectId treeId = makeId(ObjectStore::TreeObject, "abcde");
+    const ObjectId dataId = makeId(ObjectStore::DataObject, "xyz");
+    const ObjectId sizeId = makeSizeId(1);
+    const ObjectId removedId = makeSizeId(2);
+    size_t tmp = 0;
+
+    Ref<InternalStream> file = *new InternalStream();
+    {
+        PersistentObjectCache testee(*file, 10000);
+        testee.addObject(treeId, ObjectStore::TreeObject, makeMapping("abcde"));
+        testee.addObject(dataId, ObjectStore::DataObject, makeMapping("xyz"));
+        testee.addObjectSize(sizeId, ObjectStore::DataObject, 12345);
+        testee.addObjectSize(removedId, ObjectStore::DataObject, 77);
+        testee.removeObject(removedId);
+    }
+
+    PersistentObjectCache testee(*file, 10000);
+    a.checkEqual("01. getNumObjects", testee.getNumObjects(), 3U);
+
+    // Tree: content and size
+    a.checkNonNull("11. getObject", testee.getObject(treeId, ObjectStore::TreeObject).get());
+    a.check       ("12. getObject", testee.getObject(treeId, ObjectStore::TreeObject)->get().equalContent(afl::string::toBytes("abcde")));
+
+    // Data: size only
+    a.checkNull ("21. getObject", testee.getObject(dataId, ObjectStore::DataObject).get());
+    a.check     ("22. getObjectSize", testee.getObjectSize(dataId, ObjectStore::DataObject).get(tmp));
+    a.checkEqual("23. result", tmp, 3U);
+
+    a.check     ("31. getObjectSize", testee.getObjectSize(sizeId, ObjectStore::DataObject).get(tmp));
+    a.checkEqual("32. result", tmp, 12345U);
+
+    // Removed
+    a.check     ("41. getObjectSize", !testee.getObjectSize(removedId, ObjectStore::DataObject).isValid());
+}
+
+/** Test validation: content not matching the object Id is rejected. */
+AFL_TEST("server.file.ca.PersistentObjectCache:validate", a)
+{
+    const ObjectId goodId = makeId(ObjectStore::TreeObject, "abcde");
+    const ObjectId badId = makeId(ObjectStore::TreeObject, "other");
+
+    Ref<InternalStream> file = *new InternalStream();
+    {
+        PersistentObjectCache testee(*file, 10000);
+        testee.addObject(goodId, ObjectStore::TreeObject, makeMapping("abcde"));
+        testee.addObject(badId, ObjectStore::TreeObject, makeMapping("abcde"));
+    }
+
+    PersistentObjectCache testee(*file, 10000);
+    a.checkNonNull("01. good", testee.getObject(goodId, ObjectStore::TreeObject).get());
+    a.checkNull   ("02. bad",  testee.getObject(badId, ObjectStore::TreeObject).get());
+    a.checkEqual  ("03. getNumObjects", testee.getNumObjects(), 1U);
+}
+
+/** Test size limit. */
+AFL_TEST("server.file.ca.PersistentObjectCache:limit", a)
+{
+    const size_t LIMIT = 1000;
+    Ref<InternalStream> file = *new InternalStream();
+    {
+        PersistentObjectCache testee(*file, LIMIT);
+        for (int i = 0; i < 100; ++i) {
+            testee.addObjectSize(makeSizeId(i), ObjectStore::DataObject, i);
+        }
+        a.check("01. file size", file->getSize() <= LIMIT);
+        a.check("02. getNumObjects", testee.getNumObjects() < 100);
+
+        // Most recent object must be kept
+        size_t tmp = 0;
+        a.check     ("11. getObjectSize", testee.getObjectSize(makeSizeId(99), ObjectStore::DataObject).get(tmp));
+        a.checkEqual("12. result", tmp, 99U);
+    }
+
+    // Reload
+    PersistentObjectCache testee(*file, LIMIT);
+    a.check("21. getNumObjects", testee.getNumObjects() > 0);
+    a.check("22. getObjectSize", testee.getObjectSize(makeSizeId(99), ObjectStore::DataObject).isValid());
+}
+
+/** Test loading a file that is not a cache file. */
+AFL_TEST("server.file.ca.PersistentObjectCache:bad-file", a)
+{
+    Ref<InternalStream> file = *new InternalStream();
+    file->fullWrite(afl::string::toBytes("this is not a cache file, but it is long enough to contain a header"));
+    file->setPos(0);
+
+    PersistentObjectCache testee(*file, 10000);
+    a.checkEqual("01. getNumObjects", testee.getNumObjects(), 0U);
+
+    // Cache is usable
+    testee.addObjectSize(makeSizeId(1), ObjectStore::DataObject, 10);
+    a.check("11. getObjectSize", testee.getObjectSize(makeSizeId(1), ObjectStore::DataObject).isValid());
+}
@@ -6,6 +6,7 @@
 #include "server/file/ca/root.hpp"
 
 #include "afl/except/fileproblemexception.hpp"
+#include "afl/io/directoryentry.hpp"
 #include "afl/io/internaldirectory.hpp"
 #include "afl/io/internalfilesystem.hpp"
 #include "afl/sys/log.hpp"
@@ -123,6 +124,23 @@ namespace {
         }
         return count;
     }
+
+    size_t countFiles(afl::io::FileSystem& fs, const String_t& dirName, const String_t& exclude)
+    {
+        size_t count = 0;
+        afl::base::Ref<afl::base::Enumerator<afl::base::Ptr<afl::io::DirectoryEntry> > > iter = fs.openDirectory(dirName)->getDirectoryEntries();
+        afl::base::Ptr<afl::io::DirectoryEntry> entry;
+        while (iter->getNextElement(entry)) {
+            if (entry.get() != 0 && entry->getTitle() != exclude) {
+                if (entry->getFileType() == afl::io::DirectoryEntry::tDirectory) {
+                    count += countFiles(fs, fs.makePathName(dirName, entry->getTitle()), exclude);
+                } else {
+                    ++count;
+                }
+            }
+        }
+        return count;
+    }
 }
 
 
@@ -583,3 +601,73 @@ AFL_TEST("server.file.ca.Root:packed:errors", a)
     // Check that packed-refs file is gone
     AFL_CHECK_THROWS(a("must have removed packed-refs"), fs.openFile("/repo/packed-refs", FileSystem::OpenRead), afl::except::FileProblemException);
 }
+
+/** Test repack. */
+AFL_TEST("server.file.ca.Root:repack", a)
+{
+    // Populate file system
+    afl::io::InternalFileSystem fs;
+    fs.createDirectory("/repo");
+    server::file::FileSystemHandler root(fs, "/repo");
+    afl::sys::Log log;
+    const String_t longText(1000, 'x');
+    {
+        server::file::ca::Root testee(root, log);
+        std::auto_ptr<DirectoryHandler> hdl(testee.createRootHandler());
+        hdl->createFile("a", afl::string::toBytes(longText + "a"));
+        hdl->createFile("b", afl::string::toBytes(longText + "b"));
+        std::auto_ptr<DirectoryHandler> sub(hdl->getDirectory(hdl->createDirectory("sub")));
+        sub->createFile("c", afl::string::toBytes("c"));
+        a.check("01. loose objects", countFiles(fs, "/repo/objects", "pack") > 0);
+
+        // Repack
+        a.check("11. repack", testee.repack(log));
+        a.checkEqual("12. loose objects", countFiles(fs, "/repo/objects", "pack"), 0U);
+        a.checkEqual("13. pack files", countFiles(fs, "/repo/objects/pack", ""), 2U);
+    }
+
+    // Reload
+    {
+        server::file::ca::Root testee(root, log);
+        std::auto_ptr<DirectoryHandler> hdl(testee.createRootHandler());
+        a.checkEqual("21. content", afl::string::fromBytes(hdl->getFileByName("a")->get()), longText + "a");
+        a.checkEqual("22. content", afl::string::fromBytes(hdl->getFileByName("b")->get()), longText + "b");
+
+        // Repack again: no change
+        a.check("31. repack", testee.repack(log));
+        a.checkEqual("32. pack files", countFiles(fs, "/repo/objects/pack", ""), 2U);
+
+        // Modify and repack: old pack is replaced
+        hdl->createFile("d", afl::string::toBytes("d"));
+        a.check("41. loose objects", countFiles(fs, "/repo/objects", "pack") > 0);
+        a.check("42. repack", testee.repack(log));
+        a.checkEqual("43. loose objects", countFiles(fs, "/repo/objects", "pack"), 0U);
+        a.checkEqual("44. pack files", countFiles(fs, "/repo/objects/pack", ""), 2U);
+    }
+
+    // Reload
+    {
+        server::file::ca::Root testee(root, log);
+        std::auto_ptr<DirectoryHandler> hdl(testee.createRootHandler());
+        DirectoryHandler::Info info;
+        a.check("50. findItem", hdl->findItem("sub", info));
+        std::auto_ptr<DirectoryHandler> sub(hdl->getDirectory(info));
+        a.checkEqual("51. content", afl::string::fromBytes(hdl->getFileByName("a")->get()), longText + "a");
+        a.checkEqual("52. content", afl::string::fromBytes(hdl->getFileByName("d")->get()), "d");
+        a.checkEqual("53. content", afl::string::fromBytes(sub->getFileByName("c")->get()), "c");
+    }
+}
+
+/** Test repack on a backend that does not support pack files. */
+AFL_TEST("server.file.ca.Root:repack:unsupported", a)
+{
+    server::file::InternalDirectoryHandler::Directory rootDir("");
+    server::file::InternalDirectoryHandler rootHandler("root", rootDir);
+    afl::sys::Log log;
+    server::file::ca::Root testee(rootHandler, log);
+    std::auto_ptr<DirectoryHandler> hdl(testee.createRootHandler());
+    hdl->createFile("a", afl::string::toBytes("content"));
+
+    a.check("01. repack", !testee.repack(log));
+    a.checkEqual("02. countObjects", countObjects(rootHandler), 3U);
+}
@@ -9,6 +9,7 @@
 #include "afl/net/nullcommandhandler.hpp"
 #include "afl/net/redis/hashkey.hpp"
 #include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/integersetkey.hpp"
 #include "afl/net/redis/integerlistkey.hpp"
 #include "afl/net/redis/internaldatabase.hpp"
 #include "afl/net/redis/stringfield.hpp"
@@ -1038,3 +1039,89 @@ AFL_TEST("server.host.CronImpl:suspendScheduler:startup", a)
     a.checkEqual("01. action", e.action, HostCron::HostAction);
     a.checkEqual("02. time", e.time, t0 + 3*MINUTES_PER_DAY);
 }
+
+/** Test parallel operation.
+    Two games are due immediately. Host cannot run in the test environment (NullFileSystem).
+    Both games must be executed (and fail), each exactly once.
+    A third game is not due; its schedule must be computed normally.
+    Change notifications received while games are due must not get lost. */
+AFL_TEST("server.host.CronImpl:parallel", a)
+{
+    const int GAME_A = 4711;
+    const int GAME_B = 4712;
+    const int GAME_C = 4713;
+
+    // Set up
+    TestHarness h;
+    server::Time_t t0 = h.root().getTime();
+    const int games[] = { GAME_A, GAME_B };
+    for (size_t i = 0; i < 2; ++i) {
+        h.createGame(games[i], HostGame::Running);
+        h.setGameConfig(games[i], "turn", 3);
+        h.setGameConfig(games[i], "lastScheduleChange", t0 - 10000);   // lastHostTime not set: host runs immediately
+    }
+
+    // Game C: host just ran, next host tomorrow
+    h.createGame(GAME_C, HostGame::Running);
+    h.setGameConfig(GAME_C, "turn", 3);
+    h.setGameConfig(GAME_C, "lastHostTime", t0 - 1);
+    h.setGameConfig(GAME_C, "lastScheduleChange", t0 - 10000);
+    h.setSchedule(GAME_C, 1, "type", 2);              // daily
+    h.setSchedule(GAME_C, 1, "interval", 1);
+    h.setSchedule(GAME_C, 1, "daytime", 0);
+    h.addSchedule(GAME_C, 1);
+
+    // Start the timer with two workers
+    {
+        util::ProcessRunner r1, r2;
+        std::vector<util::ProcessRunner*> runners;
+        runners.push_back(&r1);
+        runners.push_back(&r2);
+        server::host::CronImpl cron(h.root(), runners);
+
+        // Notify changes while games are (probably) due
+        cron.handleGameChange(GAME_A);
+        cron.handleGameChange(GAME_C);
+
+        // Wait for A and B to drop out of the schedule
+        for (int i = 0; i < 100; ++i) {
+            if (cron.getGameEvent(GAME_A).action == HostCron::NoAction && cron.getGameEvent(GAME_B).action == HostCron::NoAction) {
+                break;
+            }
+            afl::sys::Thread::sleep(50);
+        }
+        a.checkEqual("01. getGameEvent", cron.getGameEvent(GAME_A).action, HostCron::NoAction);
+        a.checkEqual("02. getGameEvent", cron.getGameEvent(GAME_B).action, HostCron::NoAction);
+
+        // Game C has a normal schedule
+        HostCron::Event e = waitForEvent(cron, GAME_C);
+        a.checkEqual("03. action", e.action, HostCron::HostAction);
+        a.checkGreaterThan("04. time", e.time, t0);
+        a.checkLessThan("05. time", e.time, t0 + 2*MINUTES_PER_DAY);
+        a.check("06. running", !e.running);
+
+        // Complete list: only game C remains
+        std::vector<HostCron::Event> events;
+        cron.listGameEvents(events);
+        a.checkEqual("07. listGameEvents", events.size(), 1U);
+        a.checkEqual("08. listGameEvents", events[0].gameId, GAME_C);
+
+        // Repair game A, giving it the same schedule as C; change notification must produce a new schedule
+        afl::net::redis::IntegerSetKey(h.db(), "game:broken").remove(GAME_A);
+        h.setGameConfig(GAME_A, "lastHostTime", t0 - 1);
+        h.setSchedule(GAME_A, 1, "type", 2);
+        h.setSchedule(GAME_A, 1, "interval", 1);
+        h.setSchedule(GAME_A, 1, "daytime", 0);
+        h.addSchedule(GAME_A, 1);
+        cron.handleGameChange(GAME_A);
+        e = waitForEvent(cron, GAME_A);
+        a.checkEqual("09. action", e.action, HostCron::HostAction);
+        a.checkEqual("10. time", e.time, cron.getGameEvent(GAME_C).time);
+    }
+
+    // Both games have been attempted, and are now broken (game A has been repaired by us)
+    afl::net::redis::IntegerSetKey broken(h.db(), "game:broken");
+    a.check("11. broken", !broken.contains(GAME_A));
+    a.check("12. broken", broken.contains(GAME_B));
+    a.check("13. broken", !broken.contains(GAME_C));
+}
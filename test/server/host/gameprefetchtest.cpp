@@ -0,0 +1,154 @@
+/**
+  *  \file test/server/host/gameprefetchtest.cpp
+  *  \brief Test for server::host::GamePrefetch
+  */
+
+#include "server/host/gameprefetch.hpp"
+
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/integersetkey.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/stringkey.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/file/internalfileserver.hpp"
+#include "server/host/configuration.hpp"
+#include "server/host/root.hpp"
+#include "server/interface/mailqueueclient.hpp"
+#include "util/processrunner.hpp"
+
+using afl::net::redis::HashKey;
+using afl::net::redis::IntegerSetKey;
+using afl::net::redis::StringKey;
+using server::host::GamePrefetch;
+
+namespace {
+    /* CommandHandler that counts the commands passed through */
+    class CountingCommandHandler : public afl::net::CommandHandler {
+     public:
+        CountingCommandHandler(afl::net::CommandHandler& other)
+            : m_other(other), m_count(0)
+            { }
+        virtual Value_t* call(const Segment_t& command)
+            { ++m_count; return m_other.call(command); }
+        virtual void callVoid(const Segment_t& command)
+            { ++m_count; m_other.callVoid(command); }
+        int getCount() const
+            { return m_count; }
+     private:
+        afl::net::CommandHandler& m_other;
+        int m_count;
+    };
+
+    struct TestHarness {
+        afl::net::redis::InternalDatabase db;
+        CountingCommandHandler counter;
+        server::file::InternalFileServer hostFile;
+        server::file::InternalFileServer userFile;
+        afl::net::NullCommandHandler null;
+        server::interface::MailQueueClient mail;
+        util::ProcessRunner runner;
+        afl::io::NullFileSystem fs;
+        server::host::Root root;
+
+        TestHarness()
+            : db(), counter(db), hostFile(), userFile(), null(), mail(null), runner(), fs(),
+              root(counter, hostFile, userFile, mail, runner, fs, server::host::Configuration())
+            { }
+
+        void addGame(int32_t gameId, String_t name, String_t host)
+            {
+                IntegerSetKey(db, "game:all").add(gameId);
+                StringKey(db, afl::string::Format("game:%d:name", gameId)).set(name);
+                HashKey(db, afl::string::Format("game:%d:settings", gameId)).stringField("host").set(host);
+                HashKey(db, afl::string::Format("game:%d:settings", gameId)).intField("turn").set(gameId * 10);
+            }
+    };
+}
+
+/** Test normal operation: values are prefetched with one request. */
+AFL_TEST("server.host.GamePrefetch:load", a)
+{
+    TestHarness h;
+    h.addGame(1, "One", "H");
+    h.addGame(2, "Two", "H");
+    h.addGame(3, "Three", "P");
+    HashKey(h.db, "prog:host:prog:H").stringField("description").set("Host H");
+    HashKey(h.db, "prog:host:prog:P").stringField("description").set("Host P");
+
+    GamePrefetch testee(h.root, false, String_t(), String_t());
+    a.checkEqual("01. isVerbose", testee.isVerbose(), false);
+    a.checkEqual("02. getForUser", testee.getForUser(), "");
+
+    // Load
+    int n = h.counter.getCount();
+    testee.load(IntegerSetKey(h.counter, "game:all"));
+    a.checkEqual("11. load", h.counter.getCount(), n+1);
+
+    // Values do not need a database access
+    n = h.counter.getCount();
+    a.checkEqual("21. getKey",     testee.getKey(1, "name"), "One");
+    a.checkEqual("22. getKey",     testee.getKey(3, "name"), "Three");
+    a.checkEqual("23. getString",  testee.getString(2, "settings", "host"), "H");
+    a.checkEqual("24. getInteger", testee.getInteger(2, "settings", "turn"), 20);
+    a.checkEqual("25. getOptionalInteger", testee.getOptionalInteger(1, "settings", "turn").orElse(-1), 10);
+    a.checkEqual("26. getOptionalInteger", testee.getOptionalInteger(1, "settings", "lastHostTime").isValid(), false);
+    a.checkEqual("27. count", h.counter.getCount(), n);
+
+    // Tool descriptions are cached
+    a.checkEqual("31. getToolField", testee.getToolField(GamePrefetch::HostTool, "H", "description"), "Host H");
+    a.checkEqual("32. getToolField", testee.getToolField(GamePrefetch::HostTool, "P", "description"), "Host P");
+    a.checkEqual("33. getToolField", testee.getToolField(GamePrefetch::HostTool, "H", "description"), "Host H");
+    a.checkEqual("34. count", h.counter.getCount(), n+2);
+}
+
+/** Test fallback: values not prefetched are read from the database. */
+AFL_TEST("server.host.GamePrefetch:fallback", a)
+{
+    TestHarness h;
+    h.addGame(1, "One", "H");
+    HashKey(h.db, "game:1:settings").stringField("master").set("M");
+
+    GamePrefetch testee(h.root, false, String_t(), String_t());
+
+    // Not loaded at all
+    a.checkEqual("01. getKey",    testee.getKey(1, "name"), "One");
+    a.checkEqual("02. getString", testee.getString(1, "settings", "host"), "H");
+
+    // Loaded, but game/value not included
+    testee.load(IntegerSetKey(h.counter, "game:all"));
+    h.addGame(2, "Two", "P");
+    a.checkEqual("11. getKey",    testee.getKey(2, "name"), "Two");
+    a.checkEqual("12. getString", testee.getString(1, "settings", "master"), "M");
+}
+
+/** Test getOptionalString(), user ranks. */
+AFL_TEST("server.host.GamePrefetch:cache", a)
+{
+    TestHarness h;
+    h.addGame(1, "One", "H");
+    h.addGame(2, "Two", "H");
+    HashKey(h.db, "game:1:cache").stringField("schedule").set("");
+    HashKey(h.db, "user:u:profile").intField("rank").set(3);
+    HashKey(h.db, "user:u:profile").intField("rankpoints").set(700);
+
+    GamePrefetch testee(h.root, false, "u", String_t());
+    testee.load(IntegerSetKey(h.counter, "game:all"));
+
+    // Cached schedule is prefetched
+    int n = h.counter.getCount();
+    a.checkEqual("01. getOptionalString", testee.getOptionalString(1, "cache", "schedule").isValid(), true);
+    a.checkEqual("02. getOptionalString", testee.getOptionalString(2, "cache", "schedule").isValid(), false);
+    a.checkEqual("03. count", h.counter.getCount(), n);
+
+    // User ranks are read once
+    a.checkEqual("11. getUserRankLevel",  testee.getUserRankLevel(), 3);
+    a.checkEqual("12. getUserRankPoints", testee.getUserRankPoints(), 700);
+    a.checkEqual("13. getUserRankLevel",  testee.getUserRankLevel(), 3);
+    a.checkEqual("14. getUserRankPoints", testee.getUserRankPoints(), 700);
+    a.checkEqual("15. count", h.counter.getCount(), n+2);
+}
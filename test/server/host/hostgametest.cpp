@@ -13,10 +13,12 @@
 #include "afl/net/redis/stringfield.hpp"
 #include "afl/net/redis/stringkey.hpp"
 #include "afl/net/redis/stringsetkey.hpp"
+#include "afl/string/format.hpp"
 #include "afl/test/testrunner.hpp"
 #include "server/file/internalfileserver.hpp"
 #include "server/host/game.hpp"
 #include "server/host/gamearbiter.hpp"
+#include "server/host/hostschedule.hpp"
 #include "server/host/root.hpp"
 #include "server/host/session.hpp"
 #include "server/interface/mailqueueclient.hpp"
@@ -29,11 +31,28 @@ using server::interface::HostGame;
 using server::interface::HostTool;
 
 namespace {
+    /* CommandHandler that counts database round trips */
+    class CountingCommandHandler : public afl::net::CommandHandler {
+     public:
+        CountingCommandHandler(afl::net::CommandHandler& other)
+            : m_other(other), m_count(0)
+            { }
+        virtual Value_t* call(const Segment_t& command)
+            { ++m_count; return m_other.call(command); }
+        virtual void callVoid(const Segment_t& command)
+            { ++m_count; m_other.callVoid(command); }
+        int getCount() const
+            { return m_count; }
+     private:
+        afl::net::CommandHandler& m_other;
+        int m_count;
+    };
+
     class TestHarness {
      public:
         TestHarness()
-            : m_db(), m_hostFile(), m_userFile(), m_null(), m_mail(m_null), m_runner(), m_fs(),
-              m_root(m_db, m_hostFile, m_userFile, m_mail, m_runner, m_fs, server::host::Configuration())
+            : m_db(), m_counter(m_db), m_hostFile(), m_userFile(), m_null(), m_mail(m_null), m_runner(), m_fs(),
+              m_root(m_counter, m_hostFile, m_userFile, m_mail, m_runner, m_fs, server::host::Configuration())
             { }
 
         server::host::Root& root()
@@ -42,11 +61,15 @@ namespace {
         afl::net::CommandHandler& db()
             { return m_db; }
 
+        int getNumRoundTrips() const
+            { return m_counter.getCount(); }
+
         void addDefaultTools();
         int32_t addGame(HostGame& testee);
 
      private:
         afl::net::redis::InternalDatabase m_db;
+        CountingCommandHandler m_counter;
         server::file::InternalFileServer m_hostFile;
         server::file::InternalFileServer m_userFile;
         afl::net::NullCommandHandler m_null;
@@ -409,6 +432,179 @@ AFL_TEST("server.host.HostGame:getInfo", a)
     }
 }
 
+namespace {
+    /* Check getInfos() round trips for a user and filter.
+       Describing a list of games must produce the same result as describing them individually,
+       using a number of database requests that does not depend on the number of games. */
+    void checkInfoRoundTrips(afl::test::Assert a, String_t user, const HostGame::Filter& filter)
+    {
+        const size_t NUM_GAMES = 10;
+        TestHarness h;
+        h.addDefaultTools();
+        server::host::Session session;
+        server::host::HostGame testee(session, h.root());
+        server::host::HostSchedule sched(session, h.root());
+
+        int listTrips[2][2];
+        for (size_t round = 0; round < 2; ++round) {
+            // Add games, with a schedule each (as admin)
+            session.setUser(String_t());
+            for (size_t i = 0; i < NUM_GAMES; ++i) {
+                int32_t gid = h.addGame(testee);
+                server::interface::HostSchedule::Schedule sch;
+                sch.type = server::interface::HostSchedule::Weekly;
+                sch.weekdays = 5;
+                sched.add(gid, sch);
+            }
+            const size_t numGames = (round+1) * NUM_GAMES;
+            session.setUser(user);
+
+            // Warm up (first describe computes game difficulty and fills caches)
+            {
+                std::vector<HostGame::Info> result;
+                testee.getInfos(filter, true, result);
+            }
+
+            for (int verbose = 0; verbose < 2; ++verbose) {
+                afl::test::Assert va(a(afl::string::Format("%s, %d games", verbose ? "verbose" : "brief", numGames)));
+
+                // As list
+                int n = h.getNumRoundTrips();
+                std::vector<HostGame::Info> list;
+                testee.getInfos(filter, verbose != 0, list);
+                listTrips[round][verbose] = h.getNumRoundTrips() - n;
+
+                // Individually
+                std::vector<HostGame::Info> single;
+                for (size_t i = 0; i < list.size(); ++i) {
+                    single.push_back(server::host::Game(h.root(), list[i].gameId).describe(verbose != 0, session.getUser(), filter.requiredUser.orElse(String_t()), h.root()));
+                }
+
+                // Compare
+                va.checkEqual("01. size", list.size(), numGames);
+                for (size_t i = 0; i < numGames; ++i) {
+                    va.checkEqual("11. gameId",          list[i].gameId,          single[i].gameId);
+                    va.checkEqual("12. state",           list[i].state,           single[i].state);
+                    va.checkEqual("13. type",            list[i].type,            single[i].type);
+                    va.checkEqual("14. name",            list[i].name,            single[i].name);
+                    va.checkEqual("15. difficulty",      list[i].difficulty,      single[i].difficulty);
+                    va.checkEqual("16. hostName",        list[i].hostName,        single[i].hostName);
+                    va.checkEqual("17. hostKind",        list[i].hostKind,        single[i].hostKind);
+                    va.checkEqual("18. shipListName",    list[i].shipListName,    single[i].shipListName);
+                    va.checkEqual("19. masterName",      list[i].masterName.isValid(), verbose != 0);
+                    va.checkEqual("20. masterName",      list[i].masterName.orElse(""), single[i].masterName.orElse(""));
+                    va.checkEqual("21. turnNumber",      list[i].turnNumber,      single[i].turnNumber);
+                    va.checkEqual("22. slotStates",      list[i].slotStates.isValid(), single[i].slotStates.isValid());
+                    va.checkEqual("23. currentSchedule", list[i].currentSchedule.isValid(), true);
+                    va.checkEqual("24. currentSchedule", list[i].currentSchedule.get()->weekdays.orElse(0), 5);
+                    va.checkEqual("25. userPlays",       list[i].userPlays.orElse(false), single[i].userPlays.orElse(false));
+                    va.checkEqual("26. otherRank",       list[i].otherRank.orElse(-1), single[i].otherRank.orElse(-1));
+                    if (verbose) {
+                        va.checkEqual("27. slotStates", list[i].slotStates.get()->size(), single[i].slotStates.get()->size());
+                        va.check("28. slotStates", *list[i].slotStates.get() == *single[i].slotStates.get());
+                        va.check("29. turnStates", *list[i].turnStates.get() == *single[i].turnStates.get());
+                        va.checkEqual("30. joinable", list[i].joinable.orElse(false), single[i].joinable.orElse(false));
+                    }
+                }
+            }
+        }
+
+        // Round trips must not depend on number of games
+        a.checkEqual("31. brief round trips",   listTrips[1][0], listTrips[0][0]);
+        a.checkEqual("32. verbose round trips", listTrips[1][1], listTrips[0][1]);
+    }
+}
+
+/** Test getInfos(), database round trips, admin. */
+AFL_TEST("server.host.HostGame:getInfos:round-trips", a)
+{
+    HostGame::Filter filter;
+    filter.requiredState = HostGame::Joining;
+    filter.requiredType = HostGame::PublicGame;
+    checkInfoRoundTrips(a, String_t(), filter);
+}
+
+/** Test getInfos(), database round trips, regular user.
+    The permission check must use prefetched data. */
+AFL_TEST("server.host.HostGame:getInfos:round-trips:user", a)
+{
+    HostGame::Filter filter;
+    filter.requiredState = HostGame::Joining;
+    filter.requiredType = HostGame::PublicGame;
+    checkInfoRoundTrips(a, "u", filter);
+}
+
+/** Test getInfos(), database round trips, regular user, all games.
+    The permission and type checks must use prefetched data. */
+AFL_TEST("server.host.HostGame:getInfos:round-trips:user:all", a)
+{
+    HostGame::Filter filter;
+    filter.requiredType = HostGame::PublicGame;
+    checkInfoRoundTrips(a, "u", filter);
+}
+
+/** Test getInfos(), database round trips, user's game list.
+    The list of a user's games must be prefetched, too. */
+AFL_TEST("server.host.HostGame:getInfos:round-trips:requiredUser", a)
+{
+    HostGame::Filter filter;
+    filter.requiredUser = String_t("a");
+    filter.requiredState = HostGame::Joining;
+    checkInfoRoundTrips(a, "a", filter);
+}
+
+/** Test getInfos(), cached data.
+    Player lists and schedules are cached; changes must be visible in the next listing. */
+AFL_TEST("server.host.HostGame:getInfos:cache", a)
+{
+    TestHarness h;
+    h.addDefaultTools();
+    server::host::Session session;
+    server::host::HostGame testee(session, h.root());
+    server::host::HostSchedule sched(session, h.root());
+    int32_t gid = h.addGame(testee);
+
+    HostGame::Filter filter;
+
+    // Initial state
+    {
+        std::vector<HostGame::Info> result;
+        testee.getInfos(filter, true, result);
+        a.checkEqual("01. size", result.size(), 1U);
+        a.checkEqual("02. slot 4", result[0].slotStates.get()->at(3), HostGame::OpenSlot);
+        a.check("03. currentSchedule", !result[0].currentSchedule.isValid());
+    }
+
+    // Modify
+    server::host::Game(h.root(), gid).pushPlayerSlot(4, "g", h.root());
+    server::interface::HostSchedule::Schedule sch;
+    sch.type = server::interface::HostSchedule::Daily;
+    sch.interval = 2;
+    sched.add(gid, sch);
+
+    // Changed state
+    {
+        std::vector<HostGame::Info> result;
+        testee.getInfos(filter, true, result);
+        a.checkEqual("11. size", result.size(), 1U);
+        a.checkEqual("12. slot 4", result[0].slotStates.get()->at(3), HostGame::OccupiedSlot);
+        a.check("13. currentSchedule", result[0].currentSchedule.isValid());
+        a.checkEqual("14. type", result[0].currentSchedule.get()->type.orElse(server::interface::HostSchedule::Stopped), server::interface::HostSchedule::Daily);
+        a.checkEqual("15. interval", result[0].currentSchedule.get()->interval.orElse(0), 2);
+    }
+
+    // Modify again
+    server::host::Game(h.root(), gid).popPlayerSlot(4, h.root());
+    sched.drop(gid);
+    {
+        std::vector<HostGame::Info> result;
+        testee.getInfos(filter, true, result);
+        a.checkEqual("21. size", result.size(), 1U);
+        a.checkEqual("22. slot 4", result[0].slotStates.get()->at(3), HostGame::OpenSlot);
+        a.check("23. currentSchedule", !result[0].currentSchedule.isValid());
+    }
+}
+
 /** Test setConfig, simple. */
 AFL_TEST("server.host.HostGame:setConfig", a)
 {
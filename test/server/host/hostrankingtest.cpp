@@ -0,0 +1,204 @@
+/**
+  *  \file test/server/host/hostrankingtest.cpp
+  *  \brief Test for server::host::HostRanking
+  */
+
+#include "server/host/hostranking.hpp"
+
+#include "afl/data/access.hpp"
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/redis/stringkey.hpp"
+#include "afl/net/redis/stringsetkey.hpp"
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/host/configuration.hpp"
+#include "server/host/root.hpp"
+#include "server/host/session.hpp"
+#include "server/interface/mailqueueclient.hpp"
+#include "util/processrunner.hpp"
+#include <stdexcept>
+
+using afl::data::Access;
+using afl::net::redis::HashKey;
+using afl::net::redis::StringKey;
+using afl::net::redis::StringSetKey;
+using server::host::HostRanking;
+
+namespace {
+    /* CommandHandler that counts database round trips */
+    class CountingCommandHandler : public afl::net::CommandHandler {
+     public:
+        CountingCommandHandler(afl::net::CommandHandler& other)
+            : m_other(other), m_count(0)
+            { }
+        virtual Value_t* call(const Segment_t& command)
+            { ++m_count; return m_other.call(command); }
+        virtual void callVoid(const Segment_t& command)
+            { ++m_count; m_other.callVoid(command); }
+        int getCount() const
+            { return m_count; }
+     private:
+        afl::net::CommandHandler& m_other;
+        int m_count;
+    };
+
+    struct TestHarness {
+        afl::net::redis::InternalDatabase db;
+        CountingCommandHandler counter;
+        afl::net::NullCommandHandler null;
+        server::interface::MailQueueClient mail;
+        util::ProcessRunner runner;
+        afl::io::NullFileSystem fs;
+        server::host::Root root;
+        server::host::Session session;
+
+        TestHarness()
+            : db(), counter(db), null(), mail(null), runner(), fs(), root(counter, null, null, mail, runner, fs, server::host::Configuration()), session()
+            {
+                // Five users with rank points 10, 20, ..., 50; names in reverse order
+                static const char*const NAMES[] = { "e", "d", "c", "b", "a" };
+                for (int i = 1; i <= 5; ++i) {
+                    String_t userId = afl::string::Format("u%d", i);
+                    StringSetKey(db, "user:active").add(userId);
+                    StringKey(db, "user:" + userId + ":name").set(NAMES[i-1]);
+                    HashKey(db, "user:" + userId + ":profile").intField("rankpoints").set(10*i);
+                }
+            }
+    };
+
+    String_t describe(server::Value_t* p)
+    {
+        std::auto_ptr<server::Value_t> pp(p);
+        Access a(pp.get());
+        String_t result;
+        for (size_t i = 0; i+1 < a.getArraySize(); i += 2) {
+            result += a[i].toString();
+            for (size_t j = 0; j < a[i+1].getArraySize(); ++j) {
+                result += ":";
+                result += a[i+1][j].toString();
+            }
+            result += ",";
+        }
+        return result;
+    }
+}
+
+/** Test getUserList(), full list. */
+AFL_TEST("server.host.HostRanking:getUserList:full", a)
+{
+    TestHarness h;
+    HostRanking testee(h.session, h.root);
+
+    HostRanking::ListRequest req;
+    req.sortField = "rankpoints";
+    req.sortReverse = true;
+    req.fieldsToGet.push_back("name");
+    req.fieldsToGet.push_back("rankpoints");
+    a.checkEqual("01. result", describe(testee.getUserList(req)), "u5:a:50,u4:b:40,u3:c:30,u2:d:20,u1:e:10,");
+
+    req.sortField = "name";
+    req.sortReverse = false;
+    req.fieldsToGet.clear();
+    a.checkEqual("11. result", describe(testee.getUserList(req)), "u5,u4,u3,u2,u1,");
+}
+
+/** Test getUserList(), paged list. */
+AFL_TEST("server.host.HostRanking:getUserList:limit", a)
+{
+    TestHarness h;
+    HostRanking testee(h.session, h.root);
+
+    HostRanking::ListRequest req;
+    req.sortField = "rankpoints";
+    req.fieldsToGet.push_back("name");
+    req.fieldsToGet.push_back("rankpoints");
+
+    // Forward
+    req.start = 1;
+    req.count = 2;
+    a.checkEqual("01. forward", describe(testee.getUserList(req)), "u2:d:20,u3:c:30,");
+
+    // Reverse
+    req.sortReverse = true;
+    a.checkEqual("11. reverse", describe(testee.getUserList(req)), "u4:b:40,u3:c:30,");
+
+    // Clipped at end
+    req.start = 3;
+    req.count = 10;
+    a.checkEqual("21. clipped", describe(testee.getUserList(req)), "u2:d:20,u1:e:10,");
+
+    // Out of range
+    req.start = 7;
+    a.checkEqual("31. out of range", describe(testee.getUserList(req)), "");
+
+    // Data change is reflected after invalidation
+    HashKey(h.db, "user:u1:profile").intField("rankpoints").set(100);
+    HashKey(h.db, "ranking:valid").field("rankpoints").remove();
+    req.start = 0;
+    req.count = 1;
+    a.checkEqual("41. changed", describe(testee.getUserList(req)), "u1:e:100,");
+
+    // Unsorted list with limit
+    HostRanking::ListRequest req2;
+    req2.count = 3;
+    std::auto_ptr<server::Value_t> p(testee.getUserList(req2));
+    a.checkEqual("51. unsorted", Access(p.get()).getArraySize(), 6U);
+}
+
+/** Test getUserList(), paged list: round trips.
+    Once the leaderboard has been built, a page takes a fixed number of requests, independent of its size. */
+AFL_TEST("server.host.HostRanking:getUserList:round-trips", a)
+{
+    TestHarness h;
+    HostRanking testee(h.session, h.root);
+
+    HostRanking::ListRequest req;
+    req.sortField = "rankpoints";
+    req.fieldsToGet.push_back("name");
+    req.fieldsToGet.push_back("rankpoints");
+    req.start = 0;
+    req.count = 1;
+
+    // Build
+    a.checkEqual("01. build", describe(testee.getUserList(req)), "u1:e:10,");
+    a.checkEqual("02. valid", HashKey(h.db, "ranking:valid").intField("rankpoints").get(), 5);
+
+    // Small page
+    int n = h.counter.getCount();
+    a.checkEqual("11. small", describe(testee.getUserList(req)), "u1:e:10,");
+    int smallTrips = h.counter.getCount() - n;
+
+    // Large page
+    req.count = 5;
+    req.sortReverse = true;
+    n = h.counter.getCount();
+    a.checkEqual("21. large", describe(testee.getUserList(req)), "u5:a:50,u4:b:40,u3:c:30,u2:d:20,u1:e:10,");
+    int largeTrips = h.counter.getCount() - n;
+
+    a.checkEqual("31. trips", largeTrips, smallTrips);
+    a.checkLessEqual("32. trips", largeTrips, 2);
+}
+
+/** Test errors. */
+AFL_TEST("server.host.HostRanking:errors", a)
+{
+    TestHarness h;
+    HostRanking testee(h.session, h.root);
+
+    HostRanking::ListRequest req;
+    req.sortField = "email";
+    AFL_CHECK_THROWS(a("01. bad sort"), std::auto_ptr<server::Value_t>(testee.getUserList(req)), std::runtime_error);
+
+    HostRanking::ListRequest req2;
+    req2.fieldsToGet.push_back("email");
+    AFL_CHECK_THROWS(a("11. bad field"), std::auto_ptr<server::Value_t>(testee.getUserList(req2)), std::runtime_error);
+
+    // Rebuild requires admin
+    a.checkEqual("21. rebuildRankings", testee.rebuildRankings(), 5);
+    h.session.setUser("u1");
+    AFL_CHECK_THROWS(a("22. rebuildRankings"), testee.rebuildRankings(), std::runtime_error);
+}
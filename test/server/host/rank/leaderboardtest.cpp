@@ -0,0 +1,191 @@
+/**
+  *  \file test/server/host/rank/leaderboardtest.cpp
+  *  \brief Test for server::host::rank::Leaderboard
+  */
+
+#include "server/host/rank/leaderboard.hpp"
+
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/net/nullcommandhandler.hpp"
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/redis/stringfield.hpp"
+#include "afl/net/redis/stringkey.hpp"
+#include "afl/net/redis/stringlistkey.hpp"
+#include "afl/net/redis/stringsetkey.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/host/configuration.hpp"
+#include "server/host/rank/levelhandler.hpp"
+#include "server/interface/mailqueueclient.hpp"
+#include "util/processrunner.hpp"
+
+using afl::net::redis::HashKey;
+using afl::net::redis::StringKey;
+using afl::net::redis::StringListKey;
+using afl::net::redis::StringSetKey;
+using server::host::rank::Leaderboard;
+
+namespace {
+    struct TestHarness {
+        afl::net::redis::InternalDatabase db;
+        afl::net::NullCommandHandler null;
+        server::interface::MailQueueClient mail;
+        util::ProcessRunner runner;
+        afl::io::NullFileSystem fs;
+        server::host::Root root;
+
+        TestHarness()
+            : db(), null(), mail(null), runner(), fs(), root(db, null, null, mail, runner, fs, server::host::Configuration())
+            { }
+
+        void addUser(String_t userId, String_t name, int32_t rankPoints)
+            {
+                StringSetKey(db, "user:active").add(userId);
+                StringKey(db, "user:" + userId + ":name").set(name);
+                HashKey(db, "user:" + userId + ":profile").stringField("screenname").set(name);
+                HashKey(db, "user:" + userId + ":profile").intField("rankpoints").set(rankPoints);
+            }
+
+        String_t getList(String_t name)
+            {
+                afl::data::StringList_t list;
+                StringListKey(db, "ranking:" + name).getAll(list);
+                String_t result;
+                for (size_t i = 0; i < list.size(); ++i) {
+                    if (i != 0) {
+                        result += ",";
+                    }
+                    result += list[i];
+                }
+                return result;
+            }
+    };
+}
+
+/** Test findField(). */
+AFL_TEST("server.host.rank.Leaderboard:findField", a)
+{
+    const Leaderboard::Field* p = Leaderboard::findField("name");
+    a.checkNonNull("01. name", p);
+    a.checkEqual("02. dbName", String_t(p->dbName), "user:*:name");
+    a.checkEqual("03. isAlphabetic", p->isAlphabetic, true);
+
+    p = Leaderboard::findField("rankpoints");
+    a.checkNonNull("11. rankpoints", p);
+    a.checkEqual("12. isAlphabetic", p->isAlphabetic, false);
+
+    a.checkNull("21. email", Leaderboard::findField("email"));
+    a.checkNull("22. empty", Leaderboard::findField(""));
+}
+
+/** Test get(): list is built on first use, and rebuilt after invalidation. */
+AFL_TEST("server.host.rank.Leaderboard:get", a)
+{
+    TestHarness h;
+    h.addUser("u1", "carol", 30);
+    h.addUser("u2", "alice", 10);
+    h.addUser("u3", "bob",   20);
+
+    Leaderboard testee(h.root);
+    const Leaderboard::Field& name = *Leaderboard::findField("name");
+    const Leaderboard::Field& points = *Leaderboard::findField("rankpoints");
+
+    // Initial build
+    int32_t size = 0;
+    a.checkEqual("01. size", testee.get(name, size).size(), 3);
+    a.checkEqual("02. size", size, 3);
+    a.checkEqual("03. name", h.getList("name"), "u2,u3,u1");
+    testee.get(points, size);
+    a.checkEqual("04. points", h.getList("rankpoints"), "u2,u3,u1");
+    a.checkEqual("05. valid", HashKey(h.db, "ranking:valid").intField("rankpoints").get(), 3);
+
+    // Change without invalidation: list remains unchanged
+    HashKey(h.db, "user:u1:profile").intField("rankpoints").set(5);
+    testee.get(points, size);
+    a.checkEqual("11. points", h.getList("rankpoints"), "u2,u3,u1");
+
+    // Invalidate: list is rebuilt
+    testee.invalidate("rankpoints");
+    testee.invalidate("email");
+    a.check("21. valid", !HashKey(h.db, "ranking:valid").field("rankpoints").exists());
+    a.check("22. valid", HashKey(h.db, "ranking:valid").field("name").exists());
+    testee.get(points, size);
+    a.checkEqual("23. points", h.getList("rankpoints"), "u1,u2,u3");
+
+    // New user: list is rebuilt after invalidateAll()
+    h.addUser("u4", "dave", 0);
+    testee.get(name, size);
+    a.checkEqual("31. size", size, 3);
+    testee.invalidateAll();
+    testee.get(name, size);
+    a.checkEqual("32. size", size, 4);
+    a.checkEqual("33. name", h.getList("name"), "u2,u3,u1,u4");
+
+    // List without validity marker (e.g. interrupted rebuild) is rebuilt
+    StringListKey(h.db, "ranking:screenname").pushBack("u9");
+    testee.get(*Leaderboard::findField("screenname"), size);
+    a.checkEqual("41. size", size, 4);
+    a.checkEqual("42. screenname", h.getList("screenname"), "u2,u3,u1,u4");
+}
+
+/** Test invalidation that races with a rebuild.
+    A: build leaderboard. Change data and count an invalidation, but keep the validity marker
+       (as if the invalidation had arrived between SORT and storing the marker).
+    E: leaderboard is rebuilt on next use. */
+AFL_TEST("server.host.rank.Leaderboard:get:race", a)
+{
+    TestHarness h;
+    h.addUser("u1", "carol", 30);
+    h.addUser("u2", "alice", 10);
+
+    Leaderboard testee(h.root);
+    const Leaderboard::Field& points = *Leaderboard::findField("rankpoints");
+    int32_t size = 0;
+    testee.get(points, size);
+    a.checkEqual("01. points", h.getList("rankpoints"), "u2,u1");
+
+    HashKey(h.db, "user:u1:profile").intField("rankpoints").set(5);
+    HashKey(h.db, "ranking:generation").intField("rankpoints") += 1;
+    a.check("11. valid", HashKey(h.db, "ranking:valid").field("rankpoints").exists());
+
+    testee.get(points, size);
+    a.checkEqual("21. points", h.getList("rankpoints"), "u1,u2");
+
+    // Subsequent access uses the new list
+    HashKey(h.db, "user:u1:profile").intField("rankpoints").set(50);
+    testee.get(points, size);
+    a.checkEqual("31. points", h.getList("rankpoints"), "u1,u2");
+}
+
+/** Test rebuild(). */
+AFL_TEST("server.host.rank.Leaderboard:rebuild", a)
+{
+    TestHarness h;
+    h.addUser("u1", "carol", 30);
+    h.addUser("u2", "alice", 10);
+
+    a.checkEqual("01. rebuild", Leaderboard(h.root).rebuild(), 2);
+    a.checkEqual("02. name", h.getList("name"), "u2,u1");
+    a.checkEqual("03. screenname", h.getList("screenname"), "u2,u1");
+    a.checkEqual("04. rankpoints", h.getList("rankpoints"), "u2,u1");
+}
+
+/** Test that LevelHandler invalidates the affected lists. */
+AFL_TEST("server.host.rank.Leaderboard:LevelHandler", a)
+{
+    TestHarness h;
+    h.addUser("u1", "carol", 30);
+    h.addUser("u2", "alice", 10);
+    Leaderboard(h.root).rebuild();
+
+    HashKey valid(h.db, "ranking:valid");
+    server::host::rank::LevelHandler(h.root).addPlayerRankPoints("u2", 100);
+    a.check("01. rankpoints", !valid.field("rankpoints").exists());
+    a.check("02. name", valid.field("name").exists());
+
+    server::host::rank::LevelHandler(h.root).handlePlayerTurn("u1", true, 1);
+    a.check("11. turnsplayed", !valid.field("turnsplayed").exists());
+    a.check("12. turnreliability", !valid.field("turnreliability").exists());
+    a.check("13. turnsmissed", valid.field("turnsmissed").exists());
+}
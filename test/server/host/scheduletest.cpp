@@ -226,3 +226,39 @@ AFL_TEST("server.host.Schedule:describe:2", a)
     a.check("09", !r.conditionTime.isValid());
     a.check("10",  r.conditionTurn.isSame(80));
 }
+
+/** Test pack(), unpack(). */
+AFL_TEST("server.host.Schedule:pack", a)
+{
+    // Create schedule
+    server::host::Schedule sch;
+    sch.setType(server::interface::HostSchedule::Weekly);
+    sch.setWeekDays(afl::bits::SmallSet<int8_t>::fromInteger(17));
+    sch.setInterval(4);
+    sch.setDaytime(1400);
+    sch.setHostEarly(false);
+    sch.setHostDelay(15);
+    sch.setHostLimit(720);
+    sch.setCondition(server::interface::HostSchedule::Time, 999999);
+
+    // Round trip
+    server::host::Schedule copy;
+    a.check("01. unpack", copy.unpack(sch.pack()));
+    a.checkEqual("02. type",      copy.getType(), server::interface::HostSchedule::Weekly);
+    a.checkEqual("03. weekdays",  copy.getWeekDays().toInteger(), 17);
+    a.checkEqual("04. interval",  copy.getInterval(), 4);
+    a.checkEqual("05. daytime",   copy.getDaytime(), 1400);
+    a.checkEqual("06. hostEarly", copy.getHostEarly(), false);
+    a.checkEqual("07. hostDelay", copy.getHostDelay(), 15);
+    a.checkEqual("08. hostLimit", copy.getHostLimit(), 720);
+    a.checkEqual("09. condition", copy.getCondition(), server::interface::HostSchedule::Time);
+    a.checkEqual("10. condArg",   copy.getConditionArg(), 999999);
+    a.checkEqual("11. pack",      copy.pack(), sch.pack());
+
+    // Invalid
+    a.check("21. empty",     !copy.unpack(""));
+    a.check("22. short",     !copy.unpack("1,2,3"));
+    a.check("23. long",      !copy.unpack(sch.pack() + ",1"));
+    a.check("24. bad type",  !copy.unpack("99,0,0,0,0,0,0,0,0"));
+    a.checkEqual("25. unchanged", copy.getDaytime(), 1400);
+}
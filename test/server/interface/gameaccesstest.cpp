@@ -4,7 +4,9 @@
   */
 
 #include "server/interface/gameaccess.hpp"
+#include "afl/data/access.hpp"
 #include "afl/test/testrunner.hpp"
+#include <memory>
 
 /** Interface test. */
 AFL_TEST_NOARG("server.interface.GameAccess")
@@ -22,3 +24,26 @@ AFL_TEST_NOARG("server.interface.GameAccess")
     };
     Tester t;
 }
+
+/** Test default implementation of getDeferred(), postDeferred(). */
+AFL_TEST("server.interface.GameAccess:deferred", a)
+{
+    class Tester : public server::interface::GameAccess {
+     public:
+        virtual void save()
+            { }
+        virtual String_t getStatus()
+            { return String_t(); }
+        virtual server::Value_t* get(String_t objName)
+            { return server::makeStringValue(objName); }
+        virtual server::Value_t* post(String_t /*objName*/, const server::Value_t* /*value*/)
+            { return server::makeIntegerValue(42); }
+    };
+    Tester t;
+
+    std::auto_ptr<server::Value_t> getResult(t.getDeferred("obj/main"));
+    a.checkEqual("01. getDeferred", afl::data::Access(getResult.get()).toString(), "obj/main");
+
+    std::auto_ptr<server::Value_t> postResult(t.postDeferred("obj/main", 0));
+    a.checkEqual("11. postDeferred", afl::data::Access(postResult.get()).toInteger(), 42);
+}
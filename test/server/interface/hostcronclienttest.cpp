@@ -125,6 +125,7 @@ AFL_TEST("server.interface.HostCronClient", a)
         h2->setNew("action", server::makeStringValue("host"));
         h2->setNew("game", server::makeIntegerValue(9));
         h2->setNew("time", server::makeIntegerValue(11223355));
+        h2->setNew("running", server::makeIntegerValue(1));
 
         Vector::Ref_t vec = Vector::create();
         vec->pushBackNew(new HashValue(h1));
@@ -143,6 +144,8 @@ AFL_TEST("server.interface.HostCronClient", a)
         a.checkEqual("75. action", es[1].action, HostCron::HostAction);
         a.checkEqual("76. time",   es[1].time, 11223355);
         a.checkEqual("77. gameId", es[1].gameId, 9);
+        a.checkEqual("78. running", es[0].running, false);
+        a.checkEqual("79. running", es[1].running, true);
     }
 
     // kickstartGame
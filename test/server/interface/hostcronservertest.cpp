@@ -201,7 +201,9 @@ AFL_TEST("server.interface.HostCronServer:roundtrip", a)
         mock.expectCall("list(-1)");
         mock.provideReturnValue(2);
         mock.provideReturnValue(HostCron::Event(1, HostCron::UnknownAction, 1010));
-        mock.provideReturnValue(HostCron::Event(2, HostCron::MasterAction, 2020));
+        HostCron::Event running(2, HostCron::MasterAction, 2020);
+        running.running = true;
+        mock.provideReturnValue(running);
 
         std::vector<HostCron::Event> result;
         level4.listGameEvents(afl::base::Nothing, result);
@@ -213,6 +215,8 @@ AFL_TEST("server.interface.HostCronServer:roundtrip", a)
         a.checkEqual("15. gameId", result[1].gameId, 2);
         a.checkEqual("16. action", result[1].action, HostCron::MasterAction);
         a.checkEqual("17. time",   result[1].time, 2020);
+        a.checkEqual("18. running", result[0].running, false);
+        a.checkEqual("19. running", result[1].running, true);
     }
 
     // list
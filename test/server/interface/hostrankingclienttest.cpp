@@ -54,5 +54,23 @@ AFL_TEST("server.interface.HostRankingClient", a)
         a.checkEqual("22. result", Access(p).toInteger(), 42);
     }
 
+    // - limit
+    {
+        HostRanking::ListRequest req;
+        req.sortField = "a";
+        req.start = 5;
+        req.count = 10;
+
+        mock.expectCall("RANKLIST, SORT, a, LIMIT, 5, 10");
+        mock.provideNewResult(0);
+
+        AFL_CHECK_SUCCEEDS(a("31. getUserList"), p.reset(testee.getUserList(req)));
+    }
+
+    // rebuildRankings
+    mock.expectCall("RANKREBUILD");
+    mock.provideNewResult(server::makeIntegerValue(12));
+    a.checkEqual("41. rebuildRankings", testee.rebuildRankings(), 12);
+
     mock.checkFinish();
 }
@@ -33,12 +33,21 @@ namespace {
                 if (req.sortReverse) {
                     cmd += " reverse";
                 }
+                if (const int32_t* p = req.count.get()) {
+                    cmd += Format(" limit=%d,%d", req.start, *p);
+                }
                 for (size_t i = 0; i < req.fieldsToGet.size(); ++i) {
                     cmd += Format(" get=%s", req.fieldsToGet[i]);
                 }
                 checkCall(cmd);
                 return consumeReturnValue<Value_t*>();
             }
+
+        virtual int32_t rebuildRankings()
+            {
+                checkCall("rebuildRankings()");
+                return consumeReturnValue<int32_t>();
+            }
     };
 }
 
@@ -72,6 +81,14 @@ AFL_TEST("server.interface.HostRankingServer:commands", a)
     mock.provideReturnValue((Value_t*) 0);
     testee.callVoid(Segment().pushBackString("RANKLIST").pushBackString("REVERSE").pushBackString("FIELDS").pushBackString("b").pushBackString("c").pushBackString("SORT").pushBackString("a"));
 
+    mock.expectCall("getUserList() sort=a limit=10,5 get=b");
+    mock.provideReturnValue((Value_t*) 0);
+    testee.callVoid(Segment().pushBackString("RANKLIST").pushBackString("SORT").pushBackString("a").pushBackString("LIMIT").pushBackInteger(10).pushBackInteger(5).pushBackString("FIELDS").pushBackString("b"));
+
+    mock.expectCall("rebuildRankings()");
+    mock.provideReturnValue(int32_t(12));
+    a.checkEqual("02. rankrebuild", testee.callInt(Segment().pushBackString("RANKREBUILD")), 12);
+
     // Return value
     mock.expectCall("getUserList()");
     mock.provideReturnValue(server::makeIntegerValue(42));
@@ -89,6 +106,8 @@ AFL_TEST("server.interface.HostRankingServer:errors", a)
     AFL_CHECK_THROWS(a("01. empty"), testee.callVoid(empty), std::exception);
     AFL_CHECK_THROWS(a("02. bad verb"), testee.callVoid(Segment().pushBackString("")), std::exception);
     AFL_CHECK_THROWS(a("03. missing option"), testee.callVoid(Segment().pushBackString("RANKLIST").pushBackString("SORT")), std::exception);
+    AFL_CHECK_THROWS(a("04. missing option"), testee.callVoid(Segment().pushBackString("RANKLIST").pushBackString("LIMIT").pushBackInteger(1)), std::exception);
+    AFL_CHECK_THROWS(a("05. too many args"), testee.callVoid(Segment().pushBackString("RANKREBUILD").pushBackInteger(1)), std::exception);
 }
 
 AFL_TEST("server.interface.HostRankingServer:roundtrip", a)
@@ -104,12 +123,18 @@ AFL_TEST("server.interface.HostRankingServer:roundtrip", a)
     req.sortReverse = true;
     req.fieldsToGet.push_back("b");
     req.fieldsToGet.push_back("c");
+    req.start = 20;
+    req.count = 10;
 
-    mock.expectCall("getUserList() sort=a reverse get=b get=c");
+    mock.expectCall("getUserList() sort=a reverse limit=20,10 get=b get=c");
     mock.provideReturnValue(server::makeStringValue("the result"));
 
     std::auto_ptr<Value_t> p(level4.getUserList(req));
 
     a.checkEqual("01. result", server::toString(p.get()), "the result");
+
+    mock.expectCall("rebuildRankings()");
+    mock.provideReturnValue(int32_t(7));
+    a.checkEqual("02. rebuildRankings", level4.rebuildRankings(), 7);
     mock.checkFinish();
 }
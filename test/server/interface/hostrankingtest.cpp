@@ -13,6 +13,8 @@ AFL_TEST_NOARG("server.interface.HostRanking")
      public:
         virtual server::Value_t* getUserList(const ListRequest& /*req*/)
             { return 0; }
+        virtual int32_t rebuildRankings()
+            { return 0; }
     };
     Tester t;
 }
@@ -0,0 +1,108 @@
+/**
+  *  \file test/server/play/changespackertest.cpp
+  *  \brief Test for server::play::ChangesPacker
+  */
+
+#include "server/play/changespacker.hpp"
+
+#include "afl/data/access.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/writer.hpp"
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/format.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/game.hpp"
+#include "game/map/planet.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+#include "game/spec/shiplist.hpp"
+#include "game/test/root.hpp"
+#include "game/turn.hpp"
+
+using afl::data::Access;
+using game::Game;
+using game::map::Planet;
+using server::play::ChangesPacker;
+
+namespace {
+    /* Serialize a value the same way as GameAccessServer does */
+    String_t toJson(const server::Value_t* value)
+    {
+        afl::io::InternalSink sink;
+        afl::io::json::Writer writer(sink);
+        writer.setLineLength(80);
+        writer.visit(value);
+        return afl::string::fromBytes(sink.getContent());
+    }
+
+    Planet& addPlanet(Game& g, game::Session& session, int id, String_t name)
+    {
+        Planet& pl = *g.currentTurn().universe().planets().create(id);
+        pl.setPosition(game::map::Point(2000, 1000+id));
+        pl.setName(name);
+        pl.internalCheck(g.mapConfiguration(), game::PlayerSet_t(1), 10, session.translator(), session.log());
+        return pl;
+    }
+}
+
+AFL_TEST("server.play.ChangesPacker", a)
+{
+    // Environment
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    session.setRoot(game::test::makeRoot(game::HostVersion()).asPtr());
+    session.setShipList(new game::spec::ShipList());
+
+    afl::base::Ptr<Game> g = new Game();
+    addPlanet(*g, session, 42, "Meatball");
+    Planet& pl = addPlanet(*g, session, 69, "Baseball");
+    session.setGame(g);
+
+    // Initial request: everything
+    ChangesPacker t1(session, 0, 0);
+    a.checkEqual("01. getName", t1.getName(), "changes0");
+    std::auto_ptr<server::Value_t> v1(t1.buildValue());
+    Access a1(v1.get());
+    const int32_t epoch = a1("EPOCH").toInteger();
+    const int32_t gen1 = a1("GENERATION").toInteger();
+    a.check("02. generation", gen1 > 0);
+    a.checkEqual("03. planet42", a1("OBJ")("planet42")("NAME").toString(), "Meatball");
+    a.checkEqual("04. planet69", a1("OBJ")("planet69")("NAME").toString(), "Baseball");
+    a.checkDifferent("05. epoch", epoch, 0);
+
+    // No change
+    ChangesPacker t2(session, epoch, gen1);
+    a.checkEqual("11. getName", t2.getName(), String_t(afl::string::Format("changes%d.%d", epoch, gen1)));
+    std::auto_ptr<server::Value_t> v2(t2.buildValue());
+    Access a2(v2.get());
+    afl::data::StringList_t keys;
+    a2("OBJ").getHashKeys(keys);
+    a.checkEqual("12. generation", a2("GENERATION").toInteger(), gen1);
+    a.checkEqual("13. epoch", a2("EPOCH").toInteger(), epoch);
+    a.checkEqual("14. objects", keys.size(), 0U);
+
+    // Change one planet
+    pl.setName("Football");
+    pl.markDirty();
+    ChangesPacker t3(session, epoch, gen1);
+    std::auto_ptr<server::Value_t> v3(t3.buildValue());
+    Access a3(v3.get());
+    keys.clear();
+    a3("OBJ").getHashKeys(keys);
+    a.check("21. generation", a3("GENERATION").toInteger() > gen1);
+    a.checkEqual("22. objects", keys.size(), 1U);
+    a.checkEqual("23. planet69", a3("OBJ")("planet69")("NAME").toString(), "Football");
+
+    // Same generation, different epoch (e.g. server restart): everything
+    std::auto_ptr<server::Value_t> v5(ChangesPacker(session, epoch + 1, a3("GENERATION").toInteger()).buildValue());
+    keys.clear();
+    Access(v5.get())("OBJ").getHashKeys(keys);
+    a.checkEqual("24. objects", keys.size(), 2U);
+
+    // Deferred value serializes identically
+    std::auto_ptr<server::Value_t> v4(ChangesPacker(session, 0, 0).buildValue());
+    std::auto_ptr<server::Value_t> d4(ChangesPacker(session, 0, 0).buildDeferredValue());
+    a.checkEqual("31. buildDeferredValue", toJson(d4.get()), toJson(v4.get()));
+}
@@ -0,0 +1,274 @@
+/**
+  *  \file test/server/play/changetrackertest.cpp
+  *  \brief Test for server::play::ChangeTracker
+  */
+
+#include "server/play/changetracker.hpp"
+
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+#include "game/game.hpp"
+#include "game/map/planet.hpp"
+#include "game/map/ship.hpp"
+#include "game/map/universe.hpp"
+#include "game/session.hpp"
+#include "game/spec/mission.hpp"
+#include "game/turn.hpp"
+
+using game::Game;
+using game::map::Planet;
+using game::map::Point;
+using game::map::Ship;
+using game::spec::Mission;
+using server::play::ChangeTracker;
+
+namespace {
+    const int TURN_NR = 10;
+    const int PLAYER = 1;
+
+    /* Add a visible ship */
+    Ship& addShip(afl::base::Ptr<Game> g, int id)
+    {
+        Ship& sh = *g->currentTurn().universe().ships().create(id);
+        sh.addShipXYData(game::map::Point(1000, 1000+id), PLAYER+1, 100, game::PlayerSet_t(PLAYER));
+        sh.internalCheck(game::PlayerSet_t(PLAYER), TURN_NR);
+        return sh;
+    }
+
+    /* Add a played ship */
+    Ship& addPlayedShip(afl::base::Ptr<Game> g, int id, Point pos)
+    {
+        Ship& sh = *g->currentTurn().universe().ships().create(id);
+        game::map::ShipData data;
+        data.owner                     = PLAYER;
+        data.x                         = pos.getX();
+        data.y                         = pos.getY();
+        data.waypointDX                = 0;
+        data.waypointDY                = 0;
+        data.mission                   = 0;
+        data.missionTowParameter       = 0;
+        data.missionInterceptParameter = 0;
+        data.warpFactor                = 5;
+        sh.addCurrentShipData(data, game::PlayerSet_t(PLAYER));
+        sh.internalCheck(game::PlayerSet_t(PLAYER), TURN_NR);
+        sh.setPlayability(game::map::Object::Playable);
+        return sh;
+    }
+
+    /* Add a visible planet */
+    Planet& addPlanet(afl::base::Ptr<Game> g, game::Session& session, int id)
+    {
+        Planet& pl = *g->currentTurn().universe().planets().create(id);
+        pl.setPosition(game::map::Point(2000, 1000+id));
+        pl.internalCheck(g->mapConfiguration(), game::PlayerSet_t(PLAYER), TURN_NR, session.translator(), session.log());
+        return pl;
+    }
+}
+
+/** Test normal operation. */
+AFL_TEST("server.play.ChangeTracker:basics", a)
+{
+    const int SHIP_ID = 7;
+    const int PLANET_ID1 = 42;
+    const int PLANET_ID2 = 69;
+
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    afl::base::Ptr<Game> g = new Game();
+    session.setGame(g);
+
+    Ship& sh = addShip(g, SHIP_ID);
+    Planet& pl1 = addPlanet(g, session, PLANET_ID1);
+    Planet& pl2 = addPlanet(g, session, PLANET_ID2);
+
+    // Initial state: everything is modified relative to generation 0
+    ChangeTracker& testee = ChangeTracker::create(session);
+    a.checkEqual("01. create", &ChangeTracker::create(session), &testee);
+    const int32_t g1 = testee.update();
+    a.checkEqual("02. getGeneration", testee.getGeneration(), g1);
+    a.check("03. ship", testee.isShipModifiedSince(SHIP_ID, testee.getEpoch(), 0));
+    a.check("04. planet", testee.isPlanetModifiedSince(PLANET_ID1, testee.getEpoch(), 0));
+    a.check("05. planet", !testee.isPlanetModifiedSince(PLANET_ID1, testee.getEpoch(), g1));
+    a.check("06. planet", !testee.isPlanetModifiedSince(PLANET_ID2, testee.getEpoch(), g1));
+
+    // No change: same generation
+    a.checkEqual("11. update", testee.update(), g1);
+
+    // Modify one planet
+    pl1.markDirty();
+    const int32_t g2 = testee.update();
+    a.checkEqual("21. update", g2, g1+1);
+    a.check("22. planet", testee.isPlanetModifiedSince(PLANET_ID1, testee.getEpoch(), g1));
+    a.check("23. planet", !testee.isPlanetModifiedSince(PLANET_ID2, testee.getEpoch(), g1));
+    a.check("24. ship", !testee.isShipModifiedSince(SHIP_ID, testee.getEpoch(), g1));
+    a.check("25. planet", !testee.isPlanetModifiedSince(PLANET_ID1, testee.getEpoch(), g2));
+    a.check("26. dirty", !pl1.isDirty());
+
+    // Modify ship and other planet
+    sh.markDirty();
+    pl2.markDirty();
+    const int32_t g3 = testee.update();
+    a.checkEqual("31. update", g3, g2+1);
+    a.check("32. planet", !testee.isPlanetModifiedSince(PLANET_ID1, testee.getEpoch(), g2));
+    a.check("33. planet", testee.isPlanetModifiedSince(PLANET_ID2, testee.getEpoch(), g2));
+    a.check("34. ship", testee.isShipModifiedSince(SHIP_ID, testee.getEpoch(), g2));
+    a.check("35. planet", testee.isPlanetModifiedSince(PLANET_ID2, testee.getEpoch(), g1));
+
+    // Unknown objects
+    a.check("41. ship", !testee.isShipModifiedSince(999, testee.getEpoch(), g1));
+    a.check("42. ship", !testee.isShipModifiedSince(0, testee.getEpoch(), g1));
+    a.check("43. ship", !testee.isShipModifiedSince(-1, testee.getEpoch(), g1));
+
+    // Generation not produced by this tracker
+    a.check("51. future", testee.isPlanetModifiedSince(PLANET_ID1, testee.getEpoch(), g3+1));
+}
+
+/** Test that a change of game starts a new base generation. */
+AFL_TEST("server.play.ChangeTracker:reset", a)
+{
+    const int PLANET_ID = 42;
+
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    afl::base::Ptr<Game> g = new Game();
+    addPlanet(g, session, PLANET_ID);
+    session.setGame(g);
+
+    ChangeTracker& testee = ChangeTracker::create(session);
+    const int32_t g1 = testee.update();
+    a.check("01. planet", !testee.isPlanetModifiedSince(PLANET_ID, testee.getEpoch(), g1));
+
+    // New game
+    afl::base::Ptr<Game> g2 = new Game();
+    Planet& pl = addPlanet(g2, session, PLANET_ID);
+    session.setGame(g2);
+    const int32_t g3 = testee.update();
+    a.check("11. generation", g3 > g1);
+    a.check("12. planet", testee.isPlanetModifiedSince(PLANET_ID, testee.getEpoch(), g1));
+    a.check("13. planet", !testee.isPlanetModifiedSince(PLANET_ID, testee.getEpoch(), g3));
+
+    // New game's universe is tracked
+    pl.markDirty();
+    const int32_t g4 = testee.update();
+    a.checkEqual("21. update", g4, g3+1);
+    a.check("22. planet", testee.isPlanetModifiedSince(PLANET_ID, testee.getEpoch(), g3));
+}
+
+/** Test that generations from an earlier process are not mistaken for current ones.
+    A: create a ChangeTracker. Query with a different epoch, as an earlier process would have produced.
+    E: planet reported as modified. */
+AFL_TEST("server.play.ChangeTracker:epoch", a)
+{
+    const int PLANET_ID = 42;
+
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    afl::base::Ptr<Game> g = new Game();
+    addPlanet(g, session, PLANET_ID);
+    session.setGame(g);
+
+    ChangeTracker& testee = ChangeTracker::create(session);
+    const int32_t g1 = testee.update();
+    const int32_t e1 = testee.getEpoch();
+    a.checkDifferent("01. epoch", e1, 0);
+    a.check("02. planet", !testee.isPlanetModifiedSince(PLANET_ID, e1, g1));
+    a.check("03. planet", testee.isPlanetModifiedSince(PLANET_ID, e1 + 1, g1));
+    a.check("04. planet", testee.isPlanetModifiedSince(PLANET_ID, 0, g1));
+}
+
+/** Test that ships depending on a modified ship are reported.
+    A: ship B intercepts ship A. Change A's waypoint.
+    E: A and B are modified, unrelated ship C is not. */
+AFL_TEST("server.play.ChangeTracker:intercept", a)
+{
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    afl::base::Ptr<Game> g = new Game();
+    session.setGame(g);
+
+    Ship& shA = addPlayedShip(g, 1, Point(1000, 1000));
+    Ship& shB = addPlayedShip(g, 2, Point(1100, 1000));
+    addPlayedShip(g, 3, Point(1200, 1000));
+    shB.setMission(Mission::msn_Intercept, 1, 0);
+
+    ChangeTracker& testee = ChangeTracker::create(session);
+    const int32_t g1 = testee.update();
+
+    // Change A's waypoint
+    shA.setWaypoint(Point(1000, 900));
+    const int32_t g2 = testee.update();
+    a.check("01. generation", g2 > g1);
+    a.check("02. ship A", testee.isShipModifiedSince(1, testee.getEpoch(), g1));
+    a.check("03. ship B", testee.isShipModifiedSince(2, testee.getEpoch(), g1));
+    a.check("04. ship C", !testee.isShipModifiedSince(3, testee.getEpoch(), g1));
+
+    // B stops intercepting; change A again: B no longer affected
+    shB.setMission(0, 0, 0);
+    const int32_t g3 = testee.update();
+    a.check("11. ship B", testee.isShipModifiedSince(2, testee.getEpoch(), g2));
+    a.check("12. ship A", testee.isShipModifiedSince(1, testee.getEpoch(), g2));
+    shA.setWaypoint(Point(1000, 800));
+    const int32_t g4 = testee.update();
+    a.check("13. ship A", testee.isShipModifiedSince(1, testee.getEpoch(), g3));
+    a.check("14. ship B", !testee.isShipModifiedSince(2, testee.getEpoch(), g3));
+    a.check("15. generation", g4 > g3);
+}
+
+/** Test towing.
+    A: ship B tows ship A. Modify A, then let B stop towing.
+    E: both changes report both ships (the second one through the previous link). */
+AFL_TEST("server.play.ChangeTracker:tow", a)
+{
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    afl::base::Ptr<Game> g = new Game();
+    session.setGame(g);
+
+    Ship& shA = addPlayedShip(g, 1, Point(1000, 1000));
+    Ship& shB = addPlayedShip(g, 2, Point(1000, 1000));
+    shB.setMission(Mission::msn_Tow, 0, 1);
+
+    ChangeTracker& testee = ChangeTracker::create(session);
+    const int32_t g1 = testee.update();
+
+    shA.markDirty();
+    const int32_t g2 = testee.update();
+    a.check("01. ship A", testee.isShipModifiedSince(1, testee.getEpoch(), g1));
+    a.check("02. ship B", testee.isShipModifiedSince(2, testee.getEpoch(), g1));
+
+    shB.setMission(0, 0, 0);
+    testee.update();
+    a.check("11. ship A", testee.isShipModifiedSince(1, testee.getEpoch(), g2));
+    a.check("12. ship B", testee.isShipModifiedSince(2, testee.getEpoch(), g2));
+}
+
+/** Test that ships orbiting a modified planet are reported. */
+AFL_TEST("server.play.ChangeTracker:orbit", a)
+{
+    const int PLANET_ID = 42;
+
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+    afl::base::Ptr<Game> g = new Game();
+    session.setGame(g);
+
+    Planet& pl = addPlanet(g, session, PLANET_ID);
+    addPlayedShip(g, 1, Point(2000, 1000+PLANET_ID));
+    addPlayedShip(g, 2, Point(2100, 1000+PLANET_ID));
+
+    ChangeTracker& testee = ChangeTracker::create(session);
+    const int32_t g1 = testee.update();
+
+    pl.markDirty();
+    testee.update();
+    a.check("01. planet", testee.isPlanetModifiedSince(PLANET_ID, testee.getEpoch(), g1));
+    a.check("02. orbiting ship", testee.isShipModifiedSince(1, testee.getEpoch(), g1));
+    a.check("03. other ship", !testee.isShipModifiedSince(2, testee.getEpoch(), g1));
+}
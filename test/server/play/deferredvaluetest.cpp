@@ -0,0 +1,125 @@
+/**
+  *  \file test/server/play/deferredvaluetest.cpp
+  *  \brief Test for server::play::DeferredValue
+  */
+
+#include "server/play/deferredvalue.hpp"
+
+#include "afl/data/vector.hpp"
+#include "afl/data/vectorvalue.hpp"
+#include "afl/data/visitor.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/writer.hpp"
+#include "afl/test/testrunner.hpp"
+#include <memory>
+
+using afl::base::Ref;
+using afl::data::Vector;
+using afl::data::VectorValue;
+using server::play::DeferredValue;
+
+namespace {
+    /* Number of live CountedValue instances */
+    struct Counter {
+        int live;
+        int peak;
+
+        Counter()
+            : live(0), peak(0)
+            { }
+    };
+
+    /* Integer value that counts its instances */
+    class CountedValue : public afl::data::Value {
+     public:
+        CountedValue(Counter& counter, int32_t value)
+            : m_counter(counter), m_value(value)
+            {
+                if (++m_counter.live > m_counter.peak) {
+                    m_counter.peak = m_counter.live;
+                }
+            }
+        ~CountedValue()
+            { --m_counter.live; }
+        virtual void visit(afl::data::Visitor& visitor) const
+            { visitor.visitInteger(m_value); }
+        virtual CountedValue* clone() const
+            { return new CountedValue(m_counter, m_value); }
+     private:
+        Counter& m_counter;
+        int32_t m_value;
+    };
+
+    /* Builder producing CountedValue; element 2 is null */
+    class TestBuilder : public DeferredValue::Builder {
+     public:
+        TestBuilder(Counter& counter)
+            : m_counter(counter)
+            { }
+        virtual server::Value_t* build(size_t index) const
+            { return index == 2 ? 0 : new CountedValue(m_counter, int32_t(10*index)); }
+     private:
+        Counter& m_counter;
+    };
+
+    String_t toJson(const server::Value_t* value)
+    {
+        afl::io::InternalSink sink;
+        afl::io::json::Writer writer(sink);
+        writer.setLineLength(80);
+        writer.visit(value);
+        return afl::string::fromBytes(sink.getContent());
+    }
+}
+
+/** Test serialisation.
+    A: build a vector of DeferredValue, and the equivalent complete vector. Serialize both.
+    E: same output; DeferredValue builds only one element at a time. */
+AFL_TEST("server.play.DeferredValue", a)
+{
+    const size_t N = 5;
+
+    // Complete tree
+    Counter treeCounter;
+    TestBuilder treeBuilder(treeCounter);
+    String_t treeJson;
+    {
+        Ref<Vector> vv = Vector::create();
+        for (size_t i = 0; i < N; ++i) {
+            vv->pushBackNew(treeBuilder.build(i));
+        }
+        VectorValue tree(vv);
+        treeJson = toJson(&tree);
+    }
+    a.checkEqual("01. json", treeJson, "[0,10,null,30,40]");
+    a.checkEqual("02. peak", treeCounter.peak, 4);
+    a.checkEqual("03. live", treeCounter.live, 0);
+
+    // Deferred
+    Counter deferredCounter;
+    Ref<DeferredValue::Builder> builder(*new TestBuilder(deferredCounter));
+    Ref<Vector> vv = Vector::create();
+    for (size_t i = 0; i < N; ++i) {
+        vv->pushBackNew(new DeferredValue(builder, i));
+    }
+    VectorValue deferred(vv);
+    a.checkEqual("11. peak", deferredCounter.peak, 0);
+
+    a.checkEqual("21. json", toJson(&deferred), treeJson);
+    a.checkEqual("22. peak", deferredCounter.peak, 1);
+    a.checkEqual("23. live", deferredCounter.live, 0);
+}
+
+/** Test clone().
+    A: clone a DeferredValue.
+    E: clone produces the same element */
+AFL_TEST("server.play.DeferredValue:clone", a)
+{
+    Counter counter;
+    Ref<DeferredValue::Builder> builder(*new TestBuilder(counter));
+    DeferredValue testee(builder, 3);
+    std::auto_ptr<server::Value_t> copy(testee.clone());
+    a.checkNonNull("01. clone", copy.get());
+    a.checkEqual("02. json", toJson(copy.get()), "30");
+    a.checkEqual("03. live", counter.live, 0);
+}
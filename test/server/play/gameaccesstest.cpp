@@ -6,14 +6,19 @@
 #include "server/play/gameaccess.hpp"
 
 #include "afl/data/access.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/writer.hpp"
 #include "afl/io/nullfilesystem.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/test/testrunner.hpp"
 #include "game/game.hpp"
+#include "game/map/planet.hpp"
+#include "game/map/universe.hpp"
 #include "game/session.hpp"
 #include "game/spec/shiplist.hpp"
 #include "game/test/root.hpp"
 #include "game/test/shiplist.hpp"
+#include "game/turn.hpp"
 #include "util/messagecollector.hpp"
 
 using afl::data::Access;
@@ -50,6 +55,24 @@ namespace {
                 session.setRoot(r.asPtr());
             }
     };
+
+    void addPlanet(game::Game& g, game::Session& session, int id, String_t name)
+    {
+        game::map::Planet& pl = *g.currentTurn().universe().planets().create(id);
+        pl.setPosition(game::map::Point(2000, 1000+id));
+        pl.setName(name);
+        pl.internalCheck(g.mapConfiguration(), game::PlayerSet_t(1), 10, session.translator(), session.log());
+    }
+
+    /* Serialize a value the same way as GameAccessServer does */
+    String_t toJson(const server::Value_t* value)
+    {
+        afl::io::InternalSink sink;
+        afl::io::json::Writer writer(sink);
+        writer.setLineLength(80);
+        writer.visit(value);
+        return afl::string::fromBytes(sink.getContent());
+    }
 }
 
 /** Test getStatus().
@@ -194,3 +217,24 @@ AFL_TEST("server.play.GameAccess:get:error", a)
     AFL_CHECK_THROWS(a("q2"), env.testee.get("query/shipmsnistat1.1"),  std::exception);
     AFL_CHECK_THROWS(a("q3"), env.testee.get("query/planetfcistat1.1"), std::exception);
 }
+
+/** Test getDeferred().
+    A: request a set of objects using get() and getDeferred().
+    E: both results serialize to the same bytes */
+AFL_TEST("server.play.GameAccess:getDeferred", a)
+{
+    Environment env;
+    afl::base::Ptr<game::Game> g = new game::Game();
+    addPlanet(*g, env.session, 42, "Meatball");
+    addPlanet(*g, env.session, 69, "Baseball");
+    addPlanet(*g, env.session, 77, "A planet with a name long enough to need folding in the JSON output");
+    env.session.setGame(g);
+
+    const char*const REQUEST = "obj/main,beam,torp,engine,planetxy,planet42,zvcr";
+    std::auto_ptr<server::Value_t> tree(env.testee.get(REQUEST));
+    std::auto_ptr<server::Value_t> deferred(env.testee.getDeferred(REQUEST));
+
+    String_t treeJson = toJson(tree.get());
+    a.check("01. content", treeJson.find("Meatball") != String_t::npos);
+    a.checkEqual("02. getDeferred", toJson(deferred.get()), treeJson);
+}
@@ -54,4 +54,11 @@ AFL_TEST("server.play.PackerList", a)
     a.checkEqual("01", ap("v1").toInteger(), 1);
     a.checkEqual("02", ap("v2").toInteger(), 2);
     a.checkEqual("03", ap("v3").toInteger(), 3);
+
+    // Deferred value uses default implementation
+    std::auto_ptr<server::Value_t> deferred(testee.buildDeferredValue());
+    afl::data::Access dp(deferred.get());
+    a.checkEqual("11", dp("v1").toInteger(), 1);
+    a.checkEqual("12", dp("v2").toInteger(), 2);
+    a.checkEqual("13", dp("v3").toInteger(), 3);
 }
@@ -0,0 +1,155 @@
+/**
+  *  \file test/server/play/packerschematest.cpp
+  *  \brief Test for server::play::PackerSchema
+  */
+
+#include "server/play/packerschema.hpp"
+
+#include <stdexcept>
+#include "afl/data/access.hpp"
+#include "afl/data/hashvalue.hpp"
+#include "afl/data/integervalue.hpp"
+#include "afl/io/nullfilesystem.hpp"
+#include "afl/string/nulltranslator.hpp"
+#include "afl/test/testrunner.hpp"
+#include "interpreter/propertyacceptor.hpp"
+#include "interpreter/simplecontext.hpp"
+
+using afl::data::Access;
+using server::play::PackerSchema;
+
+namespace {
+    /* Test context.
+       Provides properties "A" and "B" with values (value+index).
+       Property "C" is provided by a separate accessor (delegation).
+       Counts lookups. */
+    class TestContext : public interpreter::SimpleContext, public interpreter::Context::PropertyAccessor {
+     public:
+        class Other : public interpreter::Context::ReadOnlyAccessor {
+         public:
+            virtual afl::data::Value* get(PropertyIndex_t index)
+                { return new afl::data::IntegerValue(int32_t(100 + index)); }
+        };
+
+        TestContext(int value, int& numLookups, Other& other)
+            : m_value(value), m_numLookups(numLookups), m_other(other)
+            { }
+
+        virtual interpreter::Context::PropertyAccessor* lookup(const afl::data::NameQuery& name, PropertyIndex_t& result)
+            {
+                ++m_numLookups;
+                if (name.match("A")) {
+                    result = 1;
+                    return this;
+                } else if (name.match("B")) {
+                    result = 2;
+                    return this;
+                } else if (name.match("C")) {
+                    result = 3;
+                    return &m_other;
+                } else {
+                    return 0;
+                }
+            }
+        virtual void set(PropertyIndex_t /*index*/, const afl::data::Value* /*value*/)
+            { }
+        virtual afl::data::Value* get(PropertyIndex_t index)
+            { return new afl::data::IntegerValue(int32_t(m_value + index)); }
+        virtual bool next()
+            { return false; }
+        virtual TestContext* clone() const
+            { return new TestContext(m_value, m_numLookups, m_other); }
+        virtual afl::base::Deletable* getObject()
+            { return 0; }
+        virtual void enumProperties(interpreter::PropertyAcceptor& /*acceptor*/) const
+            { }
+        virtual String_t toString(bool /*readable*/) const
+            { return "#<test>"; }
+
+     private:
+        int m_value;
+        int& m_numLookups;
+        Other& m_other;
+    };
+
+    const PackerSchema::Property PROPERTIES[] = {
+        { "A", "a" },
+        { "B", "b" },
+        { "C", "c" },
+    };
+}
+
+/** Test normal operation: names are resolved once. */
+AFL_TEST("server.play.PackerSchema:pack", a)
+{
+    int numLookups = 0;
+    TestContext::Other other;
+    PackerSchema testee(PROPERTIES, 0);
+
+    // First object
+    afl::base::Ref<afl::data::Hash> h1(afl::data::Hash::create());
+    TestContext c1(10, numLookups, other);
+    testee.pack(*h1, c1);
+    afl::data::HashValue hv1(h1);
+    a.checkEqual("01. a", Access(&hv1)("a").toInteger(), 11);
+    a.checkEqual("02. b", Access(&hv1)("b").toInteger(), 12);
+    a.checkEqual("03. c", Access(&hv1)("c").toInteger(), 103);
+
+    // Second object: only the delegated property is looked up again
+    int n = numLookups;
+    afl::base::Ref<afl::data::Hash> h2(afl::data::Hash::create());
+    TestContext c2(20, numLookups, other);
+    testee.pack(*h2, c2);
+    afl::data::HashValue hv2(h2);
+    a.checkEqual("11. a", Access(&hv2)("a").toInteger(), 21);
+    a.checkEqual("12. b", Access(&hv2)("b").toInteger(), 22);
+    a.checkEqual("13. c", Access(&hv2)("c").toInteger(), 103);
+    a.checkEqual("14. lookups", numLookups, n+1);
+}
+
+/** Test error: unknown name. */
+AFL_TEST("server.play.PackerSchema:error", a)
+{
+    static const PackerSchema::Property BAD_PROPERTIES[] = {
+        { "A", "a" },
+        { "X", "x" },
+    };
+    int numLookups = 0;
+    TestContext::Other other;
+    PackerSchema testee(BAD_PROPERTIES, 0);
+    TestContext ctx(10, numLookups, other);
+
+    afl::base::Ref<afl::data::Hash> h(afl::data::Hash::create());
+    AFL_CHECK_THROWS(a("01. pack"), testee.pack(*h, ctx), std::runtime_error);
+    AFL_CHECK_THROWS(a("02. pack"), testee.pack(*h, ctx), std::runtime_error);
+}
+
+/** Test getPackerSchema(). */
+AFL_TEST("server.play.PackerSchema:getPackerSchema", a)
+{
+    static const PackerSchema::Property OTHER_PROPERTIES[] = {
+        { "A", "a" },
+    };
+    afl::string::NullTranslator tx;
+    afl::io::NullFileSystem fs;
+    game::Session session(tx, fs);
+
+    PackerSchema& s1 = server::play::getPackerSchema(session, PROPERTIES);
+    PackerSchema& s2 = server::play::getPackerSchema(session, OTHER_PROPERTIES);
+    PackerSchema& s3 = server::play::getPackerSchema(session, PROPERTIES);
+    a.checkEqual("01. same", &s1, &s3);
+    a.checkDifferent("02. different", &s1, &s2);
+
+    // World names are observed
+    int numLookups = 0;
+    TestContext::Other other;
+    TestContext ctx(10, numLookups, other);
+    afl::base::Ref<afl::data::Hash> h(afl::data::Hash::create());
+    s2.pack(*h, ctx);
+    s2.pack(*h, ctx);
+    a.checkEqual("11. lookups", numLookups, 1);
+
+    session.world().shipPropertyNames().add("NEW");
+    s2.pack(*h, ctx);
+    a.checkEqual("12. lookups", numLookups, 2);
+}
@@ -7,6 +7,8 @@
 #include "server/play/planetxypacker.hpp"
 
 #include "afl/data/access.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/writer.hpp"
 #include "afl/io/nullfilesystem.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/test/testrunner.hpp"
@@ -20,6 +22,18 @@
 using game::Game;
 using game::map::Planet;
 
+namespace {
+    /* Serialize a value the same way as GameAccessServer does */
+    String_t toJson(const server::Value_t* value)
+    {
+        afl::io::InternalSink sink;
+        afl::io::json::Writer writer(sink);
+        writer.setLineLength(80);
+        writer.visit(value);
+        return afl::string::fromBytes(sink.getContent());
+    }
+}
+
 AFL_TEST("server.play.PlanetXYPacker", a)
 {
     const int ID1 = 42;
@@ -77,6 +91,10 @@ AFL_TEST("server.play.PlanetXYPacker", a)
     a.checkEqual("24", ap[ID2]("OWNER").toInteger(), 0);
     a.checkEqual("25", ap[ID2]("PLAYED").toInteger(), 0);
     a.checkEqual("26", ap[ID2]("BASE").toInteger(), 0);
+
+    // Deferred value serializes identically
+    std::auto_ptr<server::Value_t> deferred(testee.buildDeferredValue());
+    a.checkEqual("31. buildDeferredValue", toJson(deferred.get()), toJson(value.get()));
 }
 
 AFL_TEST("server.play.PlanetXYPacker:error:empty", a)
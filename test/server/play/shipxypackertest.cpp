@@ -6,6 +6,8 @@
 #include "server/play/shipxypacker.hpp"
 
 #include "afl/data/access.hpp"
+#include "afl/io/internalsink.hpp"
+#include "afl/io/json/writer.hpp"
 #include "afl/io/nullfilesystem.hpp"
 #include "afl/string/nulltranslator.hpp"
 #include "afl/test/testrunner.hpp"
@@ -23,6 +25,16 @@ using game::map::ShipData;
 using game::parser::MessageInformation;
 
 namespace {
+    /* Serialize a value the same way as GameAccessServer does */
+    String_t toJson(const server::Value_t* value)
+    {
+        afl::io::InternalSink sink;
+        afl::io::json::Writer writer(sink);
+        writer.setLineLength(80);
+        writer.visit(value);
+        return afl::string::fromBytes(sink.getContent());
+    }
+
     const int TURN_NR = 10;
     const int VIEWPOINT_PLAYER = 1;
 
@@ -114,4 +126,8 @@ AFL_TEST("server.play.ShipXYPacker", a)
     a.checkEqual("35. name",    ap[5]("NAME").toString(),     "Guess");
     a.checkEqual("36. played",  ap[5]("PLAYED").toInteger(),  0);
     a.checkEqual("37. guessed", ap[5]("GUESSED").toInteger(), 1);
+
+    // Deferred value serializes identically
+    std::auto_ptr<server::Value_t> deferred(testee.buildDeferredValue());
+    a.checkEqual("41. buildDeferredValue", toJson(deferred.get()), toJson(value.get()));
 }
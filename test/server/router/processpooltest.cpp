@@ -0,0 +1,136 @@
+/**
+  *  \file test/server/router/processpooltest.cpp
+  *  \brief Test for server::router::ProcessPool
+  */
+
+#include "server/router/processpool.hpp"
+
+#include "afl/sys/log.hpp"
+#include "afl/test/testrunner.hpp"
+
+using server::router::ProcessPool;
+
+namespace {
+    class SubprocessMock : public util::process::Subprocess {
+     public:
+        SubprocessMock(int& numActive)
+            : m_numActive(numActive), m_isActive(false)
+            { }
+        virtual bool isActive() const
+            { return m_isActive; }
+        virtual uint32_t getProcessId() const
+            { return 1; }
+        virtual bool start(const String_t& /*path*/, afl::base::Memory<const String_t> args)
+            {
+                const String_t* p = args.at(0);
+                if (args.size() != 1 || p == 0 || *p != "--wait") {
+                    return false;
+                }
+                m_isActive = true;
+                ++m_numActive;
+                return true;
+            }
+        virtual bool stop()
+            {
+                if (m_isActive) {
+                    m_isActive = false;
+                    --m_numActive;
+                }
+                return true;
+            }
+        virtual bool writeLine(const String_t& /*line*/)
+            { return false; }
+        virtual bool readLine(String_t& /*result*/)
+            { return false; }
+        virtual String_t getStatus() const
+            { return String_t(); }
+     private:
+        int& m_numActive;
+        bool m_isActive;
+    };
+
+    class FactoryMock : public util::process::Factory {
+     public:
+        FactoryMock()
+            : numActive(0)
+            { }
+        virtual util::process::Subprocess* createNewProcess()
+            { return new SubprocessMock(numActive); }
+
+        int numActive;
+    };
+}
+
+/** Test basic operation.
+    A: fill pool, take processes.
+    E: correct processes returned, hits and misses counted */
+AFL_TEST("server.router.ProcessPool:basics", a)
+{
+    FactoryMock factory;
+    afl::sys::Log log;
+    ProcessPool testee(factory, log);
+    a.checkEqual("01. getNumIdle", testee.getNumIdle(), 0U);
+
+    // Fill
+    testee.fill("prog", 2);
+    a.checkEqual("11. getNumIdle", testee.getNumIdle(), 2U);
+    a.checkEqual("12. numActive", factory.numActive, 2);
+
+    // Take
+    std::auto_ptr<util::process::Subprocess> p1 = testee.take();
+    a.checkNonNull("21. take", p1.get());
+    a.check("22. isActive", p1->isActive());
+    std::auto_ptr<util::process::Subprocess> p2 = testee.take();
+    a.checkNonNull("23. take", p2.get());
+    std::auto_ptr<util::process::Subprocess> p3 = testee.take();
+    a.checkNull("24. take", p3.get());
+
+    a.checkEqual("31. getNumHits", testee.getNumHits(), 2U);
+    a.checkEqual("32. getNumMisses", testee.getNumMisses(), 1U);
+    a.checkEqual("33. getNumIdle", testee.getNumIdle(), 0U);
+
+    // Refill
+    testee.fill("prog", 2);
+    a.checkEqual("41. getNumIdle", testee.getNumIdle(), 2U);
+    a.checkEqual("42. numActive", factory.numActive, 4);
+}
+
+/** Test expiry.
+    A: fill pool. Stop one process from outside. Call removeExpired().
+    E: dead process removed; with timeout 0, all processes stopped */
+AFL_TEST("server.router.ProcessPool:removeExpired", a)
+{
+    FactoryMock factory;
+    afl::sys::Log log;
+    ProcessPool testee(factory, log);
+    testee.fill("prog", 3);
+
+    // Take one process out of the pool
+    std::auto_ptr<util::process::Subprocess> p = testee.take();
+    p->stop();
+
+    // Long timeout: nothing expires
+    testee.removeExpired(1000);
+    a.checkEqual("01. getNumIdle", testee.getNumIdle(), 2U);
+    a.checkEqual("02. numActive", factory.numActive, 2);
+
+    // Zero timeout: everything expires
+    testee.removeExpired(0);
+    a.checkEqual("11. getNumIdle", testee.getNumIdle(), 0U);
+    a.checkEqual("12. numActive", factory.numActive, 0);
+}
+
+/** Test destruction.
+    A: fill pool. Destroy it.
+    E: all processes stopped */
+AFL_TEST("server.router.ProcessPool:destroy", a)
+{
+    FactoryMock factory;
+    afl::sys::Log log;
+    {
+        ProcessPool testee(factory, log);
+        testee.fill("prog", 5);
+        a.checkEqual("01. numActive", factory.numActive, 5);
+    }
+    a.checkEqual("11. numActive", factory.numActive, 0);
+}
@@ -24,15 +24,20 @@ namespace {
     class SubprocessMock : public util::process::Subprocess {
      public:
         SubprocessMock()
-            : Subprocess(), m_isActive(false), m_processId(0)
+            : Subprocess(), m_isActive(false), m_isWaiting(false), m_processId(0)
             { }
         virtual bool isActive() const
             { return m_isActive; }
         virtual uint32_t getProcessId() const
             { return m_processId; }
-        virtual bool start(const String_t& /*path*/, afl::base::Memory<const String_t> /*args*/)
+        virtual bool start(const String_t& /*path*/, afl::base::Memory<const String_t> args)
             {
-                m_replies.push("100 hi there\n");
+                // In wait mode, greeting is sent after parameters have been received
+                const String_t* p = args.at(0);
+                m_isWaiting = (p != 0 && *p == "--wait");
+                if (!m_isWaiting) {
+                    m_replies.push("100 hi there\n");
+                }
                 m_processId = ++globalCounter;
                 m_isActive = true;
                 return true;
@@ -42,8 +47,18 @@ namespace {
                 m_isActive = false;
                 return true;
             }
-        virtual bool writeLine(const String_t& /*line*/)
-            { return false; }
+        virtual bool writeLine(const String_t& line)
+            {
+                if (m_isActive && m_isWaiting) {
+                    if (line == "\n") {
+                        m_replies.push("100 hi there\n");
+                        m_isWaiting = false;
+                    }
+                    return true;
+                } else {
+                    return false;
+                }
+            }
         virtual bool readLine(String_t& result)
             {
                 if (m_replies.empty()) {
@@ -58,6 +73,7 @@ namespace {
             { return m_isActive ? "started " : "stopped"; }
      private:
         bool m_isActive;
+        bool m_isWaiting;
         uint32_t m_processId;
         std::queue<String_t> m_replies;
     };
@@ -231,3 +247,65 @@ AFL_TEST("server.router.Root:restart", a)
 
     a.checkDifferent("21. pid", pid1, pid2);
 }
+
+/** Test session creation with process pool.
+    A: create root with poolSize=2. Create sessions.
+    E: sessions use pre-started processes; pool is refilled; hits and misses counted */
+AFL_TEST("server.router.Root:pool", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.poolSize = 2;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    testee.fillPool();
+    a.checkEqual("01. getNumIdle", testee.pool().getNumIdle(), 2U);
+
+    // Create session; this uses a pooled process, which is replaced
+    String_t args1[] = {"1", "dir"};
+    server::router::Session& s1 = testee.createSession(args1);
+    a.check("11. isActive", s1.isActive());
+    a.checkEqual("12. getNumIdle", testee.pool().getNumIdle(), 2U);
+    a.checkEqual("13. getNumHits", testee.pool().getNumHits(), 1U);
+    a.checkEqual("14. getNumMisses", testee.pool().getNumMisses(), 0U);
+
+    // Restart also uses pooled process
+    uint32_t pid1 = s1.getProcessId();
+    testee.restartSession(s1);
+    a.check("21. isActive", s1.isActive());
+    a.checkDifferent("22. pid", s1.getProcessId(), pid1);
+    a.checkEqual("23. getNumHits", testee.pool().getNumHits(), 2U);
+
+    // Stop everything
+    testee.stopAllSessions();
+    a.checkEqual("31. getNumIdle", testee.pool().getNumIdle(), 0U);
+}
+
+/** Test conflict handling with process pool.
+    A: create root with poolSize=1, newSessionsWin=false. Create two conflicting sessions.
+    E: creating the second session fails, and does not consume a pooled process */
+AFL_TEST("server.router.Root:pool:conflict", a)
+{
+    // Environment
+    FactoryMock factory;
+    server::common::NumericalIdGenerator gen;
+    server::router::Configuration config;
+    config.poolSize = 1;
+    config.newSessionsWin = false;
+
+    // Testee
+    server::router::Root testee(factory, gen, config, 0);
+    testee.fillPool();
+
+    String_t args[] = {"-Wfoo"};
+    testee.createSession(args);
+    a.checkEqual("01. getNumHits", testee.pool().getNumHits(), 1U);
+
+    AFL_CHECK_THROWS(a("11. createSession conflict"), testee.createSession(args), std::exception);
+    a.checkEqual("12. sessions", testee.sessions().size(), 1U);
+    a.checkEqual("13. getNumHits", testee.pool().getNumHits(), 1U);
+    a.checkEqual("14. getNumIdle", testee.pool().getNumIdle(), 1U);
+}
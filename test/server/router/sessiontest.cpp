@@ -342,3 +342,91 @@ AFL_TEST("server.router.Session:error:startup", a)
     a.check("01. start", !ok);
     a.check("02. isActive", !testee.isActive());
 }
+
+/** Test startup using a pre-started process.
+    A: create a session. Start it using a pre-started process.
+    E: parameters are sent to the process; no new process started */
+AFL_TEST("server.router.Session:start:pooled", a)
+{
+    // Session's own process will be replaced
+    FactoryMock factory;
+    factory.pushBackNew(new SubprocessMock(a));
+
+    String_t args[] = { "a", "b" };
+    afl::sys::Log log;
+    Session testee(factory, args, "session_id", log, 0);
+
+    // Pre-started process
+    SubprocessMock* proc = new SubprocessMock(a);
+    proc->expectCall("start(prog,1)");
+    proc->provideStatus(true, 77, "started");
+    proc->provideReturnValue(true);
+    String_t waitArgs[] = { "--wait" };
+    proc->start("prog", waitArgs);
+
+    // Startup sequence
+    proc->expectCall("writeLine(a\n)");
+    proc->provideReturnValue(true);
+    proc->expectCall("writeLine(b\n)");
+    proc->provideReturnValue(true);
+    proc->expectCall("writeLine(\n)");
+    proc->provideReturnValue(true);
+    proc->expectCall("readLine()");
+    proc->provideReturnValue(true);
+    proc->provideReturnValue(String_t("100 hi there\n"));
+
+    bool ok = testee.start(std::auto_ptr<util::process::Subprocess>(proc), "prog");
+    a.check("01. start", ok);
+    a.checkEqual("02. getProcessId", testee.getProcessId(), 77U);
+    a.checkEqual("03. isActive", testee.isActive(), true);
+
+    // Stop
+    proc->expectCall("stop()");
+    proc->provideStatus(false, 0, "stopped");
+    proc->provideReturnValue(true);
+    testee.stop();
+}
+
+/** Test startup using a pre-started process that has died.
+    A: create a session. Start it using a pre-started process that refuses input.
+    E: process is restarted normally */
+AFL_TEST("server.router.Session:start:pooled:fallback", a)
+{
+    FactoryMock factory;
+    factory.pushBackNew(new SubprocessMock(a));
+
+    String_t args[] = { "a" };
+    afl::sys::Log log;
+    Session testee(factory, args, "session_id", log, 0);
+
+    // Pre-started process
+    SubprocessMock* proc = new SubprocessMock(a);
+    proc->expectCall("start(prog,1)");
+    proc->provideStatus(true, 77, "started");
+    proc->provideReturnValue(true);
+    String_t waitArgs[] = { "--wait" };
+    proc->start("prog", waitArgs);
+
+    // Startup sequence: write fails, causing restart
+    proc->expectCall("writeLine(a\n)");
+    proc->provideReturnValue(false);
+    proc->expectCall("stop()");
+    proc->provideStatus(false, 0, "stopped");
+    proc->provideReturnValue(true);
+    proc->expectCall("start(prog,1)");
+    proc->provideStatus(true, 78, "started");
+    proc->provideReturnValue(true);
+    proc->expectCall("readLine()");
+    proc->provideReturnValue(true);
+    proc->provideReturnValue(String_t("100 hi there\n"));
+
+    bool ok = testee.start(std::auto_ptr<util::process::Subprocess>(proc), "prog");
+    a.check("01. start", ok);
+    a.checkEqual("02. getProcessId", testee.getProcessId(), 78U);
+
+    // Stop
+    proc->expectCall("stop()");
+    proc->provideStatus(false, 0, "stopped");
+    proc->provideReturnValue(true);
+    testee.stop();
+}
@@ -43,6 +43,11 @@ AFL_TEST("server.talk.CommandHandler", a)
     // - Render
     a.checkEqual("21. render", testee.callString(Segment().pushBackString("RENDER").pushBackString("text:x").pushBackString("FORMAT").pushBackString("html")), "<p>x</p>\n");
     a.checkEqual("22. render", testee.callString(Segment().pushBackString("render").pushBackString("text:x").pushBackString("format").pushBackString("html")), "<p>x</p>\n");
+    {
+        std::auto_ptr<afl::data::Value> p(testee.call(Segment().pushBackString("RENDERSTAT")));
+        a.checkEqual("23. hits",   Access(p)("hits").toInteger(), 0);
+        a.checkEqual("24. misses", Access(p)("misses").toInteger(), 0);
+    }
 
     // - Group
     a.checkEqual("31. groupget", testee.callString(Segment().pushBackString("GROUPGET").pushBackString("g").pushBackString("name")), "gn");
@@ -24,4 +24,5 @@ AFL_TEST("server.talk.Configuration", a)
     a.check("11", testee.rateCostPerPost >= 0);
     a.check("12", testee.getNewestLimit > 0);
     a.check("13", testee.notificationDelay >= 0);
+    a.check("14", testee.renderCacheSize >= 0);
 }
@@ -0,0 +1,243 @@
+/**
+  *  \file test/server/talk/rendercachetest.cpp
+  *  \brief Test for server::talk::RenderCache
+  */
+
+#include "server/talk/rendercache.hpp"
+
+#include "afl/net/redis/hashkey.hpp"
+#include "afl/net/redis/integerfield.hpp"
+#include "afl/net/redis/integersetkey.hpp"
+#include "afl/net/redis/internaldatabase.hpp"
+#include "afl/net/redis/stringkey.hpp"
+#include "afl/net/redis/stringlistkey.hpp"
+#include "afl/test/testrunner.hpp"
+#include "server/talk/configuration.hpp"
+#include "server/talk/message.hpp"
+#include "server/talk/render/context.hpp"
+#include "server/talk/render/options.hpp"
+#include "server/talk/root.hpp"
+
+using afl::net::redis::IntegerSetKey;
+using afl::net::redis::InternalDatabase;
+using afl::net::redis::StringKey;
+using server::talk::Configuration;
+using server::talk::Message;
+using server::talk::RenderCache;
+using server::talk::Root;
+
+namespace {
+    Configuration makeConfig(int32_t size)
+    {
+        Configuration config;
+        config.renderCacheSize = size;
+        return config;
+    }
+
+    void createMessage(Root& root, int32_t id, String_t text)
+    {
+        Message m(root, id);
+        m.sequenceNumber().set(7);
+        m.author().set("a");
+        m.text().set(text);
+    }
+}
+
+/** Basic cycle: miss, hit, invalidate. */
+AFL_TEST("server.talk.RenderCache:basics", a)
+{
+    InternalDatabase db;
+    Root root(db, makeConfig(10));
+    createMessage(root, 1, "forum:[b]one[/b]");
+
+    server::talk::render::Context ctx(root, "u");
+    ctx.setMessageId(1);
+    server::talk::render::Options opts;
+    opts.setFormat("text");
+
+    RenderCache& testee = root.renderCache();
+    Message m(root, 1);
+
+    // First call renders
+    a.checkEqual("01. render", testee.render(m, ctx, opts, root), "one");
+    a.checkEqual("02. hits",   testee.getNumHits(), 0);
+    a.checkEqual("03. misses", testee.getNumMisses(), 1);
+    a.checkEqual("04. size",   m.renderCache().size(), 1);
+
+    // Change text behind the cache's back: cached result is returned
+    m.text().set("forum:[b]two[/b]");
+    a.checkEqual("11. render", testee.render(m, ctx, opts, root), "one");
+    a.checkEqual("12. hits",   testee.getNumHits(), 1);
+    a.checkEqual("13. misses", testee.getNumMisses(), 1);
+
+    // Invalidate: new text is rendered
+    testee.invalidate(m);
+    a.checkEqual("21. size",   m.renderCache().size(), 0);
+    a.checkEqual("22. keys",   m.renderCacheKeys().size(), 0);
+    a.checkEqual("23. render", testee.render(m, ctx, opts, root), "two");
+    a.checkEqual("24. hits",   testee.getNumHits(), 1);
+    a.checkEqual("25. misses", testee.getNumMisses(), 2);
+}
+
+/** Cache keys: different formats and base URLs are cached separately. */
+AFL_TEST("server.talk.RenderCache:keys", a)
+{
+    InternalDatabase db;
+    Root root(db, makeConfig(10));
+    createMessage(root, 1, "forum:hi");
+    Message m(root, 1);
+    RenderCache& testee = root.renderCache();
+
+    server::talk::render::Context ctxU(root, "u");
+    server::talk::render::Context ctxV(root, "v");
+    server::talk::render::Options opts;
+
+    // text: does not depend on user
+    opts.setFormat("text");
+    testee.render(m, ctxU, opts, root);
+    testee.render(m, ctxV, opts, root);
+    a.checkEqual("01. size", m.renderCache().size(), 1);
+
+    // html: does not depend on user because message has no user link
+    opts.setFormat("html");
+    testee.render(m, ctxU, opts, root);
+    testee.render(m, ctxV, opts, root);
+    testee.render(m, ctxV, opts, root);
+    a.checkEqual("11. size", m.renderCache().size(), 2);
+
+    // html with different base URL
+    opts.setBaseUrl("http://x/");
+    testee.render(m, ctxU, opts, root);
+    a.checkEqual("21. size", m.renderCache().size(), 3);
+
+    a.checkEqual("31. hits",   testee.getNumHits(), 3);
+    a.checkEqual("32. misses", testee.getNumMisses(), 3);
+    a.checkEqual("33. keys",   m.renderCacheKeys().size(), 3);
+}
+
+/** Cache keys: HTML for a message with user link is cached per user. */
+AFL_TEST("server.talk.RenderCache:keys:user-link", a)
+{
+    InternalDatabase db;
+    Root root(db, makeConfig(10));
+    createMessage(root, 1, "forum:hi [user]someone[/user]");
+    Message m(root, 1);
+    RenderCache& testee = root.renderCache();
+
+    server::talk::render::Context ctxU(root, "u");
+    server::talk::render::Context ctxV(root, "v");
+    server::talk::render::Options opts;
+
+    // text: does not depend on user
+    opts.setFormat("text");
+    testee.render(m, ctxU, opts, root);
+    testee.render(m, ctxV, opts, root);
+    a.checkEqual("01. size", m.renderCache().size(), 1);
+
+    // html: depends on user
+    opts.setFormat("html");
+    testee.render(m, ctxU, opts, root);
+    testee.render(m, ctxV, opts, root);
+    testee.render(m, ctxV, opts, root);
+    a.checkEqual("11. size", m.renderCache().size(), 3);
+
+    a.checkEqual("21. hits",   testee.getNumHits(), 2);
+    a.checkEqual("22. misses", testee.getNumMisses(), 3);
+}
+
+/** Renderings that need no transformation, or that request re-rendering, are not cached. */
+AFL_TEST("server.talk.RenderCache:uncached", a)
+{
+    InternalDatabase db;
+    Root root(db, makeConfig(10));
+    createMessage(root, 1, "forum:hi");
+    Message m(root, 1);
+    RenderCache& testee = root.renderCache();
+
+    server::talk::render::Context ctx(root, "u");
+    server::talk::render::Options opts;
+
+    opts.setFormat("raw");
+    a.checkEqual("01. raw", testee.render(m, ctx, opts, root), "forum:hi");
+    opts.setFormat("forum");
+    a.checkEqual("02. forum", testee.render(m, ctx, opts, root), "hi");
+    opts.setFormat("force:text");
+    a.checkEqual("03. force", testee.render(m, ctx, opts, root), "hi");
+
+    a.checkEqual("11. size",   m.renderCache().size(), 0);
+    a.checkEqual("12. hits",   testee.getNumHits(), 0);
+    a.checkEqual("13. misses", testee.getNumMisses(), 0);
+}
+
+/** Size limit and disabled cache. */
+AFL_TEST("server.talk.RenderCache:limit", a)
+{
+    InternalDatabase db;
+    Root root(db, makeConfig(2));
+    createMessage(root, 1, "forum:hi");
+    Message m(root, 1);
+    RenderCache& testee = root.renderCache();
+
+    server::talk::render::Context ctx(root, "u");
+    server::talk::render::Options opts;
+
+    opts.setFormat("text");
+    testee.render(m, ctx, opts, root);
+    opts.setFormat("html");
+    testee.render(m, ctx, opts, root);
+    a.checkEqual("01. size", m.renderCache().size(), 2);
+
+    // Exceeding the limit discards the oldest entry ("text")
+    opts.setFormat("abstract:text");
+    a.checkEqual("11. render", testee.render(m, ctx, opts, root), "hi");
+    a.checkEqual("12. size", m.renderCache().size(), 2);
+    a.checkEqual("13. keys", m.renderCacheKeys().size(), 2);
+
+    const int32_t hits = testee.getNumHits();
+    opts.setFormat("html");
+    testee.render(m, ctx, opts, root);
+    a.checkEqual("14. hits", testee.getNumHits(), hits + 1);
+    opts.setFormat("text");
+    testee.render(m, ctx, opts, root);
+    a.checkEqual("15. hits", testee.getNumHits(), hits + 1);
+    a.checkEqual("16. size", m.renderCache().size(), 2);
+
+    // Disabled cache
+    InternalDatabase db2;
+    Root root2(db2, makeConfig(0));
+    createMessage(root2, 1, "forum:hi");
+    Message m2(root2, 1);
+    server::talk::render::Context ctx2(root2, "u");
+    opts.setFormat("text");
+    a.checkEqual("21. render", root2.renderCache().render(m2, ctx2, opts, root2), "hi");
+    a.checkEqual("22. size", m2.renderCache().size(), 0);
+    a.checkEqual("23. misses", root2.renderCache().getNumMisses(), 0);
+}
+
+/** Messages with game links are not cached, because game permissions can change. */
+AFL_TEST("server.talk.RenderCache:game-link", a)
+{
+    InternalDatabase db;
+    Root root(db, makeConfig(10));
+    IntegerSetKey(db, "game:all").add(7);
+    StringKey(db, "game:7:state").set("running");
+    StringKey(db, "game:7:type").set("public");
+    StringKey(db, "game:7:name").set("Seven");
+    createMessage(root, 1, "forum:[game]7[/game]");
+    Message m(root, 1);
+    RenderCache& testee = root.renderCache();
+
+    server::talk::render::Context ctx(root, "u");
+    server::talk::render::Options opts;
+    opts.setFormat("text");
+
+    // Public game: name is shown
+    a.checkEqual("01. render", testee.render(m, ctx, opts, root), "Seven");
+    a.checkEqual("02. size", m.renderCache().size(), 0);
+
+    // Game becomes private: name is no longer shown
+    StringKey(db, "game:7:type").set("private");
+    a.checkEqual("11. render", testee.render(m, ctx, opts, root), "7");
+    a.checkEqual("12. size", m.renderCache().size(), 0);
+    a.checkEqual("13. hits", testee.getNumHits(), 0);
+}
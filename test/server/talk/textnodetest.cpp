@@ -148,3 +148,24 @@ AFL_TEST("server.talk.TextNode:getTextContent:overflow", a)
     // getTextContent limits to (roughly) 10000.
     a.checkLessThan("", t.getTextContent().size(), 12000U);
 }
+
+/*
+ *  Test hasLink.
+ */
+
+AFL_TEST("server.talk.TextNode:hasLink", a)
+{
+    TextNode t(TextNode::maGroup, TextNode::miGroupRoot);
+    t.children.pushBackNew(new TextNode(TextNode::maParagraph, TextNode::miParNormal));
+    t.children[0]->children.pushBackNew(new TextNode(TextNode::maPlain, 0, "see "));
+    t.children[0]->children.pushBackNew(new TextNode(TextNode::maInline, TextNode::miInBold));
+    t.children[0]->children[1]->children.pushBackNew(new TextNode(TextNode::maLink, TextNode::miLinkGame, "7"));
+
+    a.check("01. game",   t.hasLink(TextNode::miLinkGame));
+    a.check("02. forum", !t.hasLink(TextNode::miLinkForum));
+
+    // Same minor number, different major type
+    TextNode t2(TextNode::maParagraph, TextNode::miParNormal);
+    t2.children.pushBackNew(new TextNode(TextNode::maGroup, TextNode::miLinkGame));
+    a.check("11. game",  !t2.hasLink(TextNode::miLinkGame));
+}
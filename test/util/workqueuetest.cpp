@@ -0,0 +1,129 @@
+/**
+  *  \file test/util/workqueuetest.cpp
+  *  \brief Test for util::WorkQueue
+  */
+
+#include "util/workqueue.hpp"
+
+#include <vector>
+#include "afl/string/format.hpp"
+#include "afl/test/testrunner.hpp"
+
+namespace {
+    /* Worker that counts how often each item has been processed.
+       Items are distinct, so no locking is needed. */
+    class CountingWorker : public util::WorkQueue::Worker {
+     public:
+        CountingWorker(size_t size)
+            : m_counts(size)
+            { }
+        virtual void process(size_t index)
+            { ++m_counts.at(index); }
+        int get(size_t index) const
+            { return m_counts[index]; }
+     private:
+        std::vector<int> m_counts;
+    };
+
+    /* Factory producing workers that record their items into a shared per-item owner list. */
+    class RecordingFactory : public util::WorkQueue::WorkerFactory {
+     public:
+        class Worker : public util::WorkQueue::Worker {
+         public:
+            Worker(std::vector<int>& owners, int id)
+                : m_owners(owners), m_id(id)
+                { }
+            virtual void process(size_t index)
+                { m_owners.at(index) = m_id; }
+         private:
+            std::vector<int>& m_owners;
+            int m_id;
+        };
+
+        RecordingFactory(size_t size)
+            : m_owners(size), m_numWorkers(0)
+            { }
+        virtual Worker* createWorker()
+            { return new Worker(m_owners, ++m_numWorkers); }
+
+        int getOwner(size_t index) const
+            { return m_owners[index]; }
+        int getNumWorkers() const
+            { return m_numWorkers; }
+     private:
+        std::vector<int> m_owners;
+        int m_numWorkers;
+    };
+
+    void testShared(afl::test::Assert a, size_t numThreads)
+    {
+        util::WorkQueue testee(numThreads, "test.workqueue");
+        CountingWorker w(100);
+        testee.run(100, w);
+        for (size_t i = 0; i < 100; ++i) {
+            a(afl::string::Format("item %d", i)).checkEqual("count", w.get(i), 1);
+        }
+    }
+}
+
+/** Shared worker, calling thread only. */
+AFL_TEST("util.WorkQueue:shared:single", a)
+{
+    testShared(a, 0);
+    testShared(a, 1);
+}
+
+/** Shared worker, multiple threads. */
+AFL_TEST("util.WorkQueue:shared:multi", a)
+{
+    testShared(a, 5);
+}
+
+/** Worker factory: one worker per thread, capped by number of items. */
+AFL_TEST("util.WorkQueue:factory", a)
+{
+    util::WorkQueue testee(8, "test.workqueue");
+    a.checkEqual("01. getNumThreads", testee.getNumThreads(), 8U);
+
+    // More threads than items
+    RecordingFactory f(3);
+    testee.run(3, f);
+    a.checkEqual("11. getNumWorkers", f.getNumWorkers(), 3);
+    for (size_t i = 0; i < 3; ++i) {
+        a.check("12. owner", f.getOwner(i) >= 1 && f.getOwner(i) <= 3);
+    }
+
+    // Queue is reusable
+    RecordingFactory f2(50);
+    testee.run(50, f2);
+    a.checkEqual("21. getNumWorkers", f2.getNumWorkers(), 8);
+    for (size_t i = 0; i < 50; ++i) {
+        a.check("22. owner", f2.getOwner(i) >= 1 && f2.getOwner(i) <= 8);
+    }
+}
+
+/** Single thread processes all items in order, in the calling thread's worker. */
+AFL_TEST("util.WorkQueue:factory:single", a)
+{
+    util::WorkQueue testee(1, "test.workqueue");
+    RecordingFactory f(10);
+    testee.run(10, f);
+    a.checkEqual("01. getNumWorkers", f.getNumWorkers(), 1);
+    for (size_t i = 0; i < 10; ++i) {
+        a.checkEqual("02. owner", f.getOwner(i), 1);
+    }
+}
+
+/** No items. */
+AFL_TEST("util.WorkQueue:empty", a)
+{
+    util::WorkQueue testee(4, "test.workqueue");
+    CountingWorker w(1);
+    testee.run(0, w);
+    a.checkEqual("01. count", w.get(0), 0);
+
+    RecordingFactory f(1);
+    testee.run(0, f);
+    a.checkEqual("11. getNumWorkers", f.getNumWorkers(), 1);
+    a.checkEqual("12. owner", f.getOwner(0), 0);
+}
@@ -0,0 +1,128 @@
+/**
+  *  \file util/workqueue.cpp
+  *  \brief Class util::WorkQueue
+  */
+
+#include <algorithm>
+#include "util/workqueue.hpp"
+#include "afl/base/stoppable.hpp"
+#include "afl/container/ptrvector.hpp"
+#include "afl/sys/mutexguard.hpp"
+#include "afl/sys/thread.hpp"
+
+/*
+ *  Runner
+ *
+ *  Feeds items from the queue to a worker until the queue runs empty.
+ */
+
+class util::WorkQueue::Runner : public afl::base::Stoppable {
+ public:
+    Runner(WorkQueue& parent, Worker& worker)
+        : m_parent(parent), m_worker(worker)
+        { }
+
+    // Stoppable:
+    void run()
+        {
+            size_t index;
+            while (m_parent.getNextItem(index)) {
+                m_worker.process(index);
+            }
+        }
+    void stop()
+        {
+            // Runner stops by itself when the queue is empty.
+        }
+
+ private:
+    WorkQueue& m_parent;
+    Worker& m_worker;
+};
+
+
+/*
+ *  WorkQueue
+ */
+
+util::WorkQueue::WorkQueue(size_t numThreads, String_t threadName)
+    : m_numThreads(numThreads),
+      m_threadName(threadName),
+      m_mutex(),
+      m_nextItem(0),
+      m_numItems(0)
+{ }
+
+util::WorkQueue::~WorkQueue()
+{ }
+
+void
+util::WorkQueue::run(size_t numItems, WorkerFactory& factory)
+{
+    afl::container::PtrVector<Worker> ownedWorkers;
+    std::vector<Worker*> workers;
+    for (size_t i = 0, n = getNumWorkers(numItems); i < n; ++i) {
+        workers.push_back(ownedWorkers.pushBackNew(factory.createWorker()));
+    }
+    runWorkers(numItems, workers);
+}
+
+void
+util::WorkQueue::run(size_t numItems, Worker& worker)
+{
+    runWorkers(numItems, std::vector<Worker*>(getNumWorkers(numItems), &worker));
+}
+
+size_t
+util::WorkQueue::getNumThreads() const
+{
+    return m_numThreads;
+}
+
+/* Get number of workers to use: do not start more threads than we have items. */
+size_t
+util::WorkQueue::getNumWorkers(size_t numItems) const
+{
+    return std::max(size_t(1), std::min(m_numThreads, numItems));
+}
+
+/* Process numItems items using the given workers.
+   workers[0] runs in the calling thread, the others in new threads. */
+void
+util::WorkQueue::runWorkers(size_t numItems, const std::vector<Worker*>& workers)
+{
+    // Prepare queue
+    m_nextItem = 0;
+    m_numItems = numItems;
+
+    // Start threads. Threads are declared last, so they are destroyed first.
+    afl::container::PtrVector<Runner> runners;
+    afl::container::PtrVector<afl::sys::Thread> threads;
+    for (size_t i = 1, n = workers.size(); i < n; ++i) {
+        Runner* r = runners.pushBackNew(new Runner(*this, *workers[i]));
+        threads.pushBackNew(new afl::sys::Thread(m_threadName, *r))->start();
+    }
+
+    // Work in this thread
+    Runner self(*this, *workers[0]);
+    self.run();
+
+    // Wait for other threads
+    for (size_t i = 0, n = threads.size(); i < n; ++i) {
+        threads[i]->join();
+    }
+
+    m_numItems = 0;
+}
+
+bool
+util::WorkQueue::getNextItem(size_t& index)
+{
+    afl::sys::MutexGuard g(m_mutex);
+    if (m_nextItem < m_numItems) {
+        index = m_nextItem++;
+        return true;
+    } else {
+        return false;
+    }
+}
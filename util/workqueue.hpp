@@ -0,0 +1,87 @@
+/**
+  *  \file util/workqueue.hpp
+  *  \brief Class util::WorkQueue
+  */
+#ifndef C2NG_UTIL_WORKQUEUE_HPP
+#define C2NG_UTIL_WORKQUEUE_HPP
+
+#include <vector>
+#include "afl/base/deletable.hpp"
+#include "afl/base/types.hpp"
+#include "afl/base/uncopyable.hpp"
+#include "afl/string/string.hpp"
+#include "afl/sys/mutex.hpp"
+
+namespace util {
+
+    /** Parallel processing of indexed work items.
+        Processes a number of work items, identified by index, using a number of threads.
+
+        Items are handed out one at a time in increasing index order.
+        The calling thread acts as a worker, too, and no more threads are started than there are items;
+        run() returns when all items have been processed.
+        If the number of threads is 0 or 1, all items are processed in the calling thread, in order.
+
+        Threads are started for each run() call and stop by themselves when all items have been handed out. */
+    class WorkQueue : private afl::base::Uncopyable {
+     public:
+        /** Worker.
+            Processes work items. */
+        class Worker : public afl::base::Deletable {
+         public:
+            /** Process an item.
+                \param index Item index, [0, numItems) */
+            virtual void process(size_t index) = 0;
+        };
+
+        /** Worker factory.
+            Use to give each thread its own Worker, for example to keep thread-local state. */
+        class WorkerFactory : public afl::base::Deletable {
+         public:
+            /** Create a worker.
+                Called in the thread that called run().
+                \return newly-allocated worker */
+            virtual Worker* createWorker() = 0;
+        };
+
+        /** Constructor.
+            \param numThreads Number of threads to use (0 or 1 to process everything in the calling thread)
+            \param threadName Name for threads */
+        WorkQueue(size_t numThreads, String_t threadName);
+
+        /** Destructor. */
+        ~WorkQueue();
+
+        /** Process items, using one Worker per thread.
+            \param numItems Number of items
+            \param factory  Worker factory; called once per thread */
+        void run(size_t numItems, WorkerFactory& factory);
+
+        /** Process items, using a shared Worker.
+            \param numItems Number of items
+            \param worker   Worker. Its process() will be called from multiple threads in parallel. */
+        void run(size_t numItems, Worker& worker);
+
+        /** Get number of threads.
+            \return number of threads as given to constructor */
+        size_t getNumThreads() const;
+
+     private:
+        class Runner;
+        friend class Runner;
+
+        const size_t m_numThreads;
+        const String_t m_threadName;
+
+        afl::sys::Mutex m_mutex;
+        size_t m_nextItem;
+        size_t m_numItems;
+
+        size_t getNumWorkers(size_t numItems) const;
+        void runWorkers(size_t numItems, const std::vector<Worker*>& workers);
+        bool getNextItem(size_t& index);
+    };
+
+}
+
+#endif